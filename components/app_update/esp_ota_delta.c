@@ -0,0 +1,371 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Applies delta patches generated by gen_ota_delta.py.
+ *
+ * A patch starts with a header (all the fields are little endian):
+ *
+ *      uint32_t magic              ESP_OTA_DELTA_MAGIC
+ *      uint8_t  version            ESP_OTA_DELTA_VERSION
+ *      uint8_t  reserved[3]
+ *      uint32_t src_size           Size of the image the patch was generated against
+ *      uint32_t dst_size           Size of the image produced by the patch
+ *      uint8_t  src_sha256[32]     SHA-256 of the first src_size bytes of the source partition
+ *
+ * It is followed by commands, until dst_size bytes are produced. Each command is made of three
+ * varints (LEB128): diff_len, extra_len and seek (zigzag encoded). As in bsdiff, a command
+ * produces diff_len bytes by adding the diff data to the source bytes at the current source
+ * position, then extra_len bytes copied from the patch, and finally moves the source position
+ * by seek bytes. The diff data is mostly zeros, so it is made of runs of a varint count of
+ * source bytes copied unchanged, followed by a varint count of bytes and these bytes to add.
+ *
+ * The image is produced in a single window of esp_ota_delta_cfg_t::buffer_size bytes, and the
+ * patch itself is never stored, so a patch is applied while it is downloaded in constant memory.
+ */
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/param.h>
+#include "esp_log.h"
+#include "esp_ota_delta.h"
+#include "mbedtls/sha256.h"
+
+#define DELTA_SHA256_LEN        32
+#define DELTA_VARINT_MAX_SHIFT  28
+
+static const char *TAG = "esp_ota_delta";
+
+typedef enum {
+    DELTA_STATE_HEADER,         /* Receiving the header */
+    DELTA_STATE_DIFF_LEN,       /* Receiving the diff_len varint of a command */
+    DELTA_STATE_EXTRA_LEN,      /* Receiving the extra_len varint of a command */
+    DELTA_STATE_SEEK,           /* Receiving the seek varint of a command */
+    DELTA_STATE_COPY_LEN,       /* Receiving the count of source bytes copied unchanged in the diff data */
+    DELTA_STATE_ADD_LEN,        /* Receiving the count of bytes added to the source in the diff data */
+    DELTA_STATE_ADD,            /* Receiving the bytes added to the source */
+    DELTA_STATE_EXTRA,          /* Receiving the bytes copied from the patch */
+    DELTA_STATE_DONE,           /* The whole image was produced */
+} delta_state_t;
+
+struct esp_ota_delta {
+    esp_ota_delta_cfg_t cfg;
+    delta_state_t state;
+    esp_err_t err;                              /* First error returned, which is sticky */
+    uint8_t header[ESP_OTA_DELTA_HEADER_SIZE];
+    size_t header_len;
+    uint32_t src_size;
+    uint32_t dst_size;
+    uint32_t src_pos;                           /* Current position in the source partition */
+    uint32_t dst_pos;                           /* Bytes produced so far, including those still in the window */
+    uint32_t varint;                            /* Varint being received */
+    unsigned varint_shift;
+    uint32_t diff_left;                         /* Bytes of the diff data of the current command not yet produced */
+    uint32_t extra_left;                        /* Bytes of the extra data of the current command not yet produced */
+    uint32_t run_left;                          /* Bytes of the current run of added bytes not yet produced */
+    int32_t seek;
+    size_t buf_len;                             /* Bytes in the window */
+    uint8_t buf[];                              /* Window of cfg.buffer_size bytes */
+};
+
+static inline uint32_t get_u32_le(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool esp_ota_delta_is_patch(const void *data, size_t size)
+{
+    return data != NULL && size >= sizeof(uint32_t) && get_u32_le(data) == ESP_OTA_DELTA_MAGIC;
+}
+
+esp_err_t esp_ota_delta_begin(const esp_ota_delta_cfg_t *cfg, esp_ota_delta_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL || cfg->src_partition == NULL || cfg->write_cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const size_t buffer_size = cfg->buffer_size ? cfg->buffer_size : ESP_OTA_DELTA_DEFAULT_BUFFER_SIZE;
+    struct esp_ota_delta *delta = calloc(1, sizeof(struct esp_ota_delta) + buffer_size);
+    if (delta == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    delta->cfg = *cfg;
+    delta->cfg.buffer_size = buffer_size;
+    delta->state = DELTA_STATE_HEADER;
+    *handle = delta;
+    return ESP_OK;
+}
+
+static esp_err_t delta_flush(struct esp_ota_delta *delta)
+{
+    if (delta->buf_len == 0) {
+        return ESP_OK;
+    }
+    esp_err_t err = delta->cfg.write_cb(delta->buf, delta->buf_len, delta->cfg.user_ctx);
+    delta->buf_len = 0;
+    return err;
+}
+
+/* Reads the next bytes of the source into the window, the caller makes sure that they fit */
+static esp_err_t delta_read_source(struct esp_ota_delta *delta, size_t size)
+{
+    esp_err_t err = esp_partition_read(delta->cfg.src_partition, delta->src_pos, delta->buf + delta->buf_len, size);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot read the source partition (0x%x)", err);
+        return err;
+    }
+    delta->src_pos += size;
+    delta->dst_pos += size;
+    delta->buf_len += size;
+    return ESP_OK;
+}
+
+static esp_err_t delta_copy_source(struct esp_ota_delta *delta, uint32_t size)
+{
+    while (size > 0) {
+        const size_t chunk = MIN(size, delta->cfg.buffer_size - delta->buf_len);
+        esp_err_t err = delta_read_source(delta, chunk);
+        if (err == ESP_OK && delta->buf_len == delta->cfg.buffer_size) {
+            err = delta_flush(delta);
+        }
+        if (err != ESP_OK) {
+            return err;
+        }
+        size -= chunk;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t delta_check_source(struct esp_ota_delta *delta, const uint8_t *expected_sha256)
+{
+    if (delta->src_size > delta->cfg.src_partition->size) {
+        ESP_LOGE(TAG, "The patch needs a source of %" PRIu32 " bytes, larger than the source partition", delta->src_size);
+        return ESP_ERR_INVALID_CRC;
+    }
+    uint8_t sha256[DELTA_SHA256_LEN];
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+    esp_err_t err = ESP_OK;
+    for (uint32_t offset = 0; offset < delta->src_size && err == ESP_OK; offset += delta->cfg.buffer_size) {
+        const size_t chunk = MIN(delta->src_size - offset, delta->cfg.buffer_size);
+        err = esp_partition_read(delta->cfg.src_partition, offset, delta->buf, chunk);
+        mbedtls_sha256_update(&ctx, delta->buf, chunk);
+    }
+    mbedtls_sha256_finish(&ctx, sha256);
+    mbedtls_sha256_free(&ctx);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot read the source partition (0x%x)", err);
+        return err;
+    }
+    if (memcmp(sha256, expected_sha256, DELTA_SHA256_LEN) != 0) {
+        ESP_LOGE(TAG, "The source partition does not hold the image the patch was generated against");
+        return ESP_ERR_INVALID_CRC;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t delta_process_header(struct esp_ota_delta *delta)
+{
+    const uint8_t *header = delta->header;
+    if (get_u32_le(header) != ESP_OTA_DELTA_MAGIC) {
+        ESP_LOGE(TAG, "Not a delta patch");
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (header[4] != ESP_OTA_DELTA_VERSION) {
+        ESP_LOGE(TAG, "Unsupported delta patch version %d", header[4]);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    delta->src_size = get_u32_le(header + 8);
+    delta->dst_size = get_u32_le(header + 12);
+    ESP_LOGD(TAG, "Patch from %" PRIu32 " to %" PRIu32 " bytes", delta->src_size, delta->dst_size);
+    esp_err_t err = delta_check_source(delta, header + 16);
+    if (err != ESP_OK) {
+        return err;
+    }
+    delta->state = (delta->dst_size == 0) ? DELTA_STATE_DONE : DELTA_STATE_DIFF_LEN;
+    return ESP_OK;
+}
+
+/* Moves to the next part of the current command, or to the next command */
+static esp_err_t delta_next_state(struct esp_ota_delta *delta)
+{
+    if (delta->diff_left > 0) {
+        delta->state = DELTA_STATE_COPY_LEN;
+    } else if (delta->extra_left > 0) {
+        delta->state = DELTA_STATE_EXTRA;
+    } else {
+        const int64_t src_pos = (int64_t)delta->src_pos + delta->seek;
+        if (src_pos < 0 || src_pos > delta->src_size) {
+            ESP_LOGE(TAG, "Invalid seek in the source");
+            return ESP_ERR_INVALID_SIZE;
+        }
+        delta->src_pos = src_pos;
+        delta->state = (delta->dst_pos == delta->dst_size) ? DELTA_STATE_DONE : DELTA_STATE_DIFF_LEN;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t delta_process_varint(struct esp_ota_delta *delta, uint32_t value)
+{
+    switch (delta->state) {
+    case DELTA_STATE_DIFF_LEN:
+        if ((uint64_t)delta->src_pos + value > delta->src_size || (uint64_t)delta->dst_pos + value > delta->dst_size) {
+            break;
+        }
+        delta->diff_left = value;
+        delta->state = DELTA_STATE_EXTRA_LEN;
+        return ESP_OK;
+    case DELTA_STATE_EXTRA_LEN:
+        if ((uint64_t)delta->dst_pos + delta->diff_left + value > delta->dst_size) {
+            break;
+        }
+        delta->extra_left = value;
+        delta->state = DELTA_STATE_SEEK;
+        return ESP_OK;
+    case DELTA_STATE_SEEK:
+        delta->seek = (int32_t)((value >> 1) ^ -(value & 1));
+        return delta_next_state(delta);
+    case DELTA_STATE_COPY_LEN:
+        if (value > delta->diff_left) {
+            break;
+        }
+        delta->diff_left -= value;
+        esp_err_t err = delta_copy_source(delta, value);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (delta->diff_left == 0) {
+            return delta_next_state(delta);
+        }
+        delta->state = DELTA_STATE_ADD_LEN;
+        return ESP_OK;
+    case DELTA_STATE_ADD_LEN:
+        if (value > delta->diff_left) {
+            break;
+        }
+        delta->diff_left -= value;
+        delta->run_left = value;
+        if (value > 0) {
+            delta->state = DELTA_STATE_ADD;
+            return ESP_OK;
+        }
+        return delta_next_state(delta);
+    default:
+        abort();
+    }
+    ESP_LOGE(TAG, "Invalid command in the patch");
+    return ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t esp_ota_delta_write(esp_ota_delta_handle_t handle, const void *data, size_t size)
+{
+    if (handle == NULL || (data == NULL && size > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct esp_ota_delta *delta = handle;
+    const uint8_t *p = data;
+    const uint8_t *const end = p + size;
+    esp_err_t err = delta->err;
+
+    while (err == ESP_OK && p < end) {
+        size_t n;
+        switch (delta->state) {
+        case DELTA_STATE_HEADER:
+            n = MIN(end - p, ESP_OTA_DELTA_HEADER_SIZE - delta->header_len);
+            memcpy(delta->header + delta->header_len, p, n);
+            delta->header_len += n;
+            p += n;
+            if (delta->header_len == ESP_OTA_DELTA_HEADER_SIZE) {
+                err = delta_process_header(delta);
+            }
+            break;
+        case DELTA_STATE_DIFF_LEN:
+        case DELTA_STATE_EXTRA_LEN:
+        case DELTA_STATE_SEEK:
+        case DELTA_STATE_COPY_LEN:
+        case DELTA_STATE_ADD_LEN: {
+            const uint8_t byte = *p++;
+            if (delta->varint_shift > DELTA_VARINT_MAX_SHIFT || (delta->varint_shift == DELTA_VARINT_MAX_SHIFT && byte > 0x0f)) {
+                ESP_LOGE(TAG, "Invalid varint in the patch");
+                err = ESP_ERR_INVALID_SIZE;
+                break;
+            }
+            delta->varint |= (uint32_t)(byte & 0x7f) << delta->varint_shift;
+            delta->varint_shift += 7;
+            if ((byte & 0x80) == 0) {
+                const uint32_t value = delta->varint;
+                delta->varint = 0;
+                delta->varint_shift = 0;
+                err = delta_process_varint(delta, value);
+            }
+            break;
+        }
+        case DELTA_STATE_ADD: {
+            n = MIN(MIN(end - p, delta->run_left), delta->cfg.buffer_size - delta->buf_len);
+            uint8_t *out = delta->buf + delta->buf_len;
+            err = delta_read_source(delta, n);
+            if (err != ESP_OK) {
+                break;
+            }
+            for (size_t i = 0; i < n; i++) {
+                out[i] += p[i];
+            }
+            p += n;
+            delta->run_left -= n;
+            if (delta->buf_len == delta->cfg.buffer_size) {
+                err = delta_flush(delta);
+            }
+            if (err == ESP_OK && delta->run_left == 0) {
+                err = delta_next_state(delta);
+            }
+            break;
+        }
+        case DELTA_STATE_EXTRA:
+            n = MIN(MIN(end - p, delta->extra_left), delta->cfg.buffer_size - delta->buf_len);
+            memcpy(delta->buf + delta->buf_len, p, n);
+            p += n;
+            delta->buf_len += n;
+            delta->dst_pos += n;
+            delta->extra_left -= n;
+            if (delta->buf_len == delta->cfg.buffer_size) {
+                err = delta_flush(delta);
+            }
+            if (err == ESP_OK && delta->extra_left == 0) {
+                err = delta_next_state(delta);
+            }
+            break;
+        case DELTA_STATE_DONE:
+            ESP_LOGE(TAG, "Data after the end of the patch");
+            err = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+    }
+    delta->err = err;
+    return err;
+}
+
+esp_err_t esp_ota_delta_end(esp_ota_delta_handle_t handle)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = handle->err;
+    if (err == ESP_OK && handle->state != DELTA_STATE_DONE) {
+        ESP_LOGE(TAG, "The patch is truncated");
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    if (err == ESP_OK) {
+        err = delta_flush(handle);
+    }
+    free(handle);
+    return err;
+}
+
+void esp_ota_delta_abort(esp_ota_delta_handle_t handle)
+{
+    free(handle);
+}
@@ -48,6 +48,9 @@ typedef struct ota_ops_entry_ {
     uint32_t wrote_size;
     uint8_t partial_bytes;
     bool ota_resumption;
+#if CONFIG_APP_UPDATE_VERIFY_WHILE_WRITING
+    esp_image_stream_verify_handle_t stream_verify; /*!< Verification of the image written with esp_ota_write(), NULL if it is verified from flash */
+#endif
     WORD_ALIGNED_ATTR uint8_t partial_data[16];
     LIST_ENTRY(ota_ops_entry_) entries;
 } ota_ops_entry_t;
@@ -61,6 +64,15 @@ const static char *TAG = "esp_ota_ops";
 
 static ota_ops_entry_t *get_ota_ops_entry(esp_ota_handle_t handle);
 
+static void ota_stream_verify_abort(ota_ops_entry_t *it)
+{
+#if CONFIG_APP_UPDATE_VERIFY_WHILE_WRITING
+    // The image will be verified from flash in esp_ota_end()
+    esp_image_stream_verify_abort(it->stream_verify);
+    it->stream_verify = NULL;
+#endif
+}
+
 /* Return true if this is an OTA app partition */
 static bool is_ota_partition(const esp_partition_t *p)
 {
@@ -282,6 +294,7 @@ esp_err_t esp_ota_set_final_partition(esp_ota_handle_t handle, const esp_partiti
         ESP_LOGI(TAG,"Staging partition - <%s>. Final partition - <%s>.", it->partition.staging->label, final_partition->label);
         it->partition.final = final_partition;
         it->partition.finalize_with_copy = finalize_with_copy;
+        ota_stream_verify_abort(it);
         if (final_partition->type == ESP_PARTITION_TYPE_BOOTLOADER) {
             esp_image_bootloader_offset_set(it->partition.staging->address);
         }
@@ -333,7 +346,19 @@ esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
                         ESP_LOGE(TAG, "OTA image has invalid magic byte (expected 0xE9, saw 0x%02x)", data_bytes[0]);
                         return ESP_ERR_OTA_VALIDATE_FAILED;
                     }
-
+#if CONFIG_APP_UPDATE_VERIFY_WHILE_WRITING
+                    // (Re)start the verification, a previous attempt to write the start of the image may have failed
+                    ota_stream_verify_abort(it);
+                    if (it->partition.final->type == ESP_PARTITION_TYPE_APP) {
+                        const esp_partition_pos_t part_pos = {
+                            .offset = it->partition.staging->address,
+                            .size = it->partition.staging->size,
+                        };
+                        if (esp_image_stream_verify_begin(&part_pos, &it->stream_verify) != ESP_OK) {
+                            it->stream_verify = NULL;
+                        }
+                    }
+#endif
                 } else if (it->partition.final->type == ESP_PARTITION_TYPE_PARTITION_TABLE) {
                     if (*(uint16_t*)data_bytes != (uint16_t)ESP_PARTITION_MAGIC) {
                         ESP_LOGE(TAG, "Partition table image has invalid magic word (expected 0x50AA, saw 0x%04x)", *(uint16_t*)data_bytes);
@@ -342,6 +367,15 @@ esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
                 }
             }
 
+#if CONFIG_APP_UPDATE_VERIFY_WHILE_WRITING
+            if (it->stream_verify != NULL) {
+                ret = esp_image_stream_verify_feed(it->stream_verify, data_bytes, size);
+                if (ret != ESP_OK && ret != ESP_ERR_IMAGE_INVALID) {
+                    ota_stream_verify_abort(it);
+                }
+            }
+#endif
+
             if (esp_flash_encryption_enabled()) {
                 /* Can only write 16 byte blocks to flash, so need to cache anything else */
                 size_t copy_len;
@@ -357,6 +391,8 @@ esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
                     /* write 16 byte to partition */
                     ret = esp_partition_write(it->partition.staging, it->wrote_size, it->partial_data, 16);
                     if (ret != ESP_OK) {
+                        // The data may be passed again, it is verified from flash instead
+                        ota_stream_verify_abort(it);
                         return ret;
                     }
                     it->partial_bytes = 0;
@@ -377,6 +413,8 @@ esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
             ret = esp_partition_write(it->partition.staging, it->wrote_size, data_bytes, size);
             if(ret == ESP_OK){
                 it->wrote_size += size;
+            } else {
+                ota_stream_verify_abort(it);
             }
             return ret;
         }
@@ -411,6 +449,8 @@ esp_err_t esp_ota_write_with_offset(esp_ota_handle_t handle, const void *data, s
                 ESP_LOGE(TAG, "Size should be 16byte aligned for flash encryption case");
                 return ESP_ERR_INVALID_ARG;
             }
+            // The data may not be written in order
+            ota_stream_verify_abort(it);
             ret = esp_partition_write(it->partition.staging, offset, data_bytes, size);
             if (ret == ESP_OK) {
                 it->wrote_size += size;
@@ -442,6 +482,7 @@ esp_err_t esp_ota_abort(esp_ota_handle_t handle)
     if (it == NULL) {
         return ESP_ERR_NOT_FOUND;
     }
+    ota_stream_verify_abort(it);
     LIST_REMOVE(it, entries);
     free(it);
     return ESP_OK;
@@ -456,6 +497,19 @@ static esp_err_t ota_verify_partition(ota_ops_entry_t *ota_ops)
             .offset = ota_ops->partition.staging->address,
             .size = ota_ops->partition.staging->size,
         };
+#if CONFIG_APP_UPDATE_VERIFY_WHILE_WRITING
+        if (ota_ops->stream_verify != NULL) {
+            ret = esp_image_stream_verify_finish(ota_ops->stream_verify, &data);
+            ota_ops->stream_verify = NULL;
+            if (ret == ESP_OK) {
+                return ESP_OK;
+            } else if (ret == ESP_ERR_IMAGE_INVALID) {
+                return ESP_ERR_OTA_VALIDATE_FAILED;
+            }
+            // The verification could not be completed, verify the image from flash
+            ret = ESP_OK;
+        }
+#endif
         if (esp_image_verify(ESP_IMAGE_VERIFY, &part_pos, &data) != ESP_OK) {
             return ESP_ERR_OTA_VALIDATE_FAILED;
         }
@@ -514,6 +568,7 @@ esp_err_t esp_ota_end(esp_ota_handle_t handle)
     }
 
  cleanup:
+    ota_stream_verify_abort(it);
     if (it->partition.final->type == ESP_PARTITION_TYPE_BOOTLOADER) {
         // In esp_ota_begin, bootloader offset was updated, here we return it to default.
         esp_image_bootloader_offset_set(ESP_PRIMARY_BOOTLOADER_OFFSET);
@@ -0,0 +1,249 @@
+#!/usr/bin/env python
+#
+# gen_ota_delta.py generates delta patches which turn the app image running on a device into a new one,
+# to be applied with esp_ota_delta_write() (for example by esp_https_ota), see esp_ota_delta.c for the format.
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+import argparse
+import hashlib
+import struct
+import sys
+from typing import Dict
+from typing import List
+from typing import Tuple
+
+__version__ = '1.0'
+
+DELTA_MAGIC = 0x544C4445  # "EDLT"
+DELTA_VERSION = 1
+HEADER_FORMAT = '<IB3xII32s'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+# Exact matches are searched for with blocks of BLOCK_SIZE bytes of the new image, looked up in an index
+# of the blocks of the base image starting every BLOCK_STEP bytes. So all the matches of at least
+# BLOCK_SIZE + BLOCK_STEP - 1 bytes are found.
+BLOCK_SIZE = 32
+BLOCK_STEP = 8
+
+# Runs of unchanged bytes shorter than this are encoded along with the bytes added around them
+MIN_COPY_RUN = 3
+
+
+def encode_varint(value: int) -> bytes:
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def encode_zigzag(value: int) -> bytes:
+    return encode_varint(((value << 1) ^ (value >> 31)) & 0xFFFFFFFF)
+
+
+def match_length(a: bytes, a_pos: int, b: bytes, b_pos: int) -> int:
+    """ Returns the length of the common prefix of a[a_pos:] and b[b_pos:] """
+    length = 0
+    limit = min(len(a) - a_pos, len(b) - b_pos)
+    step = 256
+    while step:
+        while length + step <= limit and a[a_pos + length:a_pos + length + step] == b[b_pos + length:b_pos + length + step]:
+            length += step
+        step //= 2
+    return length
+
+
+def find_matches(base: bytes, new: bytes) -> List[Tuple[int, int, int]]:
+    """ Returns the exact matches (new_pos, base_pos, length) found in order in the new image """
+    index = {}  # type: Dict[bytes, int]
+    for pos in range(0, len(base) - BLOCK_SIZE + 1, BLOCK_STEP):
+        index.setdefault(base[pos:pos + BLOCK_SIZE], pos)
+
+    matches = []  # type: List[Tuple[int, int, int]]
+    offset = 0
+    end = 0
+    pos = 0
+    while pos + BLOCK_SIZE <= len(new):
+        block = new[pos:pos + BLOCK_SIZE]
+        # Prefer continuing with the offset of the previous match, as most of the code is unchanged or only moved
+        base_pos = pos + offset
+        if not (0 <= base_pos <= len(base) - BLOCK_SIZE and base[base_pos:base_pos + BLOCK_SIZE] == block):
+            base_pos = index.get(block, -1)
+            if base_pos < 0:
+                pos += 1
+                continue
+        start = pos
+        while start > end and base_pos > 0 and new[start - 1] == base[base_pos - 1]:
+            start -= 1
+            base_pos -= 1
+        length = match_length(new, start, base, base_pos)
+        matches.append((start, base_pos, length))
+        offset = base_pos - start
+        end = pos = start + length
+    return matches
+
+
+def extend_forward(base: bytes, base_pos: int, new: bytes, new_pos: int, limit: int) -> int:
+    """ Returns how many bytes after a match are better produced from the base image than copied from the patch """
+    best = score = length = 0
+    limit = min(limit, len(base) - base_pos)
+    for i in range(limit):
+        score += 1 if new[new_pos + i] == base[base_pos + i] else -1
+        if score > best:
+            best = score
+            length = i + 1
+    return length
+
+
+def extend_backward(base: bytes, base_pos: int, new: bytes, new_pos: int, limit: int) -> int:
+    """ Returns how many bytes before a match are better produced from the base image than copied from the patch """
+    best = score = length = 0
+    limit = min(limit, base_pos)
+    for i in range(1, limit + 1):
+        score += 1 if new[new_pos - i] == base[base_pos - i] else -1
+        if score > best:
+            best = score
+            length = i
+    return length
+
+
+def encode_diff(base: bytes, base_pos: int, new: bytes, new_pos: int, length: int) -> bytes:
+    diff = bytes((new[new_pos + i] - base[base_pos + i]) & 0xFF for i in range(length))
+    out = bytearray()
+    pos = 0
+    while pos < length:
+        # Run of unchanged bytes, then run of bytes to add until the next long enough run of unchanged bytes
+        copy = pos
+        while copy < length and diff[copy] == 0:
+            copy += 1
+        add = copy
+        while add < length:
+            zeros = add
+            while zeros < length and diff[zeros] == 0:
+                zeros += 1
+            if zeros == length or zeros - add >= MIN_COPY_RUN:
+                break
+            add = zeros + 1
+        out += encode_varint(copy - pos)
+        if copy < length:
+            out += encode_varint(add - copy) + diff[copy:add]
+        pos = add
+    return bytes(out)
+
+
+def create_patch(base: bytes, new: bytes) -> bytes:
+    patch = bytearray(struct.pack(HEADER_FORMAT, DELTA_MAGIC, DELTA_VERSION, len(base), len(new),
+                                  hashlib.sha256(base).digest()))
+    # Each region is (new_pos, base_pos, diff_len): diff_len bytes are produced from the base image at new_pos
+    regions = []  # type: List[Tuple[int, int, int]]
+    prev_end = 0
+    for new_pos, base_pos, length in find_matches(base, new):
+        if regions:
+            r_new, r_base, r_len = regions[-1]
+            gap = new_pos - (r_new + r_len)
+            forward = extend_forward(base, r_base + r_len, new, r_new + r_len, gap)
+            regions[-1] = (r_new, r_base, r_len + forward)
+            prev_end = r_new + r_len + forward
+        backward = extend_backward(base, base_pos, new, new_pos, new_pos - prev_end)
+        regions.append((new_pos - backward, base_pos - backward, length + backward))
+    if regions:
+        r_new, r_base, r_len = regions[-1]
+        forward = extend_forward(base, r_base + r_len, new, r_new + r_len, len(new) - r_new - r_len)
+        regions[-1] = (r_new, r_base, r_len + forward)
+
+    if not new:
+        return bytes(patch)
+    # The first command only copies the start of the new image before the first region from the patch
+    new_pos, base_pos, length = 0, 0, 0
+    for next_new, next_base, next_length in regions + [(len(new), -1, 0)]:
+        if next_base < 0:
+            next_base = base_pos + length  # no seek after the last command
+        patch += encode_varint(length) + encode_varint(next_new - new_pos - length)
+        patch += encode_zigzag(next_base - base_pos - length)
+        patch += encode_diff(base, base_pos, new, new_pos, length)
+        patch += new[new_pos + length:next_new]
+        new_pos, base_pos, length = next_new, next_base, next_length
+    return bytes(patch)
+
+
+def decode_varint(patch: bytes, pos: int) -> Tuple[int, int]:
+    value = shift = 0
+    while True:
+        byte = patch[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def apply_patch(base: bytes, patch: bytes) -> bytes:
+    magic, version, base_size, new_size, base_sha256 = struct.unpack_from(HEADER_FORMAT, patch)
+    if magic != DELTA_MAGIC or version != DELTA_VERSION:
+        raise ValueError('Not a delta patch of version {}'.format(DELTA_VERSION))
+    if len(base) < base_size or hashlib.sha256(base[:base_size]).digest() != base_sha256:
+        raise ValueError('The base image is not the one the patch was generated against')
+    new = bytearray()
+    pos = HEADER_SIZE
+    base_pos = 0
+    while len(new) < new_size:
+        diff_len, pos = decode_varint(patch, pos)
+        extra_len, pos = decode_varint(patch, pos)
+        seek, pos = decode_varint(patch, pos)
+        diff_end = len(new) + diff_len
+        while len(new) < diff_end:
+            copy, pos = decode_varint(patch, pos)
+            new += base[base_pos:base_pos + copy]
+            base_pos += copy
+            if len(new) < diff_end:
+                add, pos = decode_varint(patch, pos)
+                new += bytes((a + b) & 0xFF for a, b in zip(base[base_pos:base_pos + add], patch[pos:pos + add]))
+                base_pos += add
+                pos += add
+        new += patch[pos:pos + extra_len]
+        pos += extra_len
+        base_pos += (seek >> 1) ^ -(seek & 1)
+    if len(new) != new_size or pos != len(patch):
+        raise ValueError('Corrupted patch')
+    return bytes(new)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser('ESP-IDF OTA delta patch generator')
+    subparsers = parser.add_subparsers(dest='operation', help='Run gen_ota_delta.py {command} -h for additional help')
+    subparsers.required = True
+
+    create_parser = subparsers.add_parser('create', help='Generate a patch turning the base image into the new one')
+    create_parser.add_argument('base', help='App image running on the devices to update', type=argparse.FileType('rb'))
+    create_parser.add_argument('new', help='New app image', type=argparse.FileType('rb'))
+    create_parser.add_argument('output', help='Patch to generate', type=argparse.FileType('wb'))
+
+    apply_parser = subparsers.add_parser('apply', help='Apply a patch to the base image, as done by the devices')
+    apply_parser.add_argument('base', help='App image the patch was generated against', type=argparse.FileType('rb'))
+    apply_parser.add_argument('patch', help='Patch to apply', type=argparse.FileType('rb'))
+    apply_parser.add_argument('output', help='New app image to write', type=argparse.FileType('wb'))
+
+    args = parser.parse_args()
+    base = args.base.read()
+    if args.operation == 'create':
+        new = args.new.read()
+        patch = create_patch(base, new)
+        if apply_patch(base, patch) != new:
+            raise RuntimeError('The generated patch does not produce the new image')
+        args.output.write(patch)
+        print('Patch of {} bytes written ({:.1f}% of the new image)'.format(len(patch), 100.0 * len(patch) / max(len(new), 1)))
+    else:
+        try:
+            args.output.write(apply_patch(base, args.patch.read()))
+        except ValueError as e:
+            print(e, file=sys.stderr)
+            sys.exit(2)
+
+
+if __name__ == '__main__':
+    main()
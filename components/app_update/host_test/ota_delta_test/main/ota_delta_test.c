@@ -0,0 +1,307 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Linux host delta patch applier test
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "esp_ota_delta.h"
+#include "mbedtls/sha256.h"
+#include "unity.h"
+#include "unity_fixture.h"
+
+#define BASE_SIZE       (200 * 1024)
+#define PATCH_MAX_SIZE  (BASE_SIZE * 2)
+#define NEW_MAX_SIZE    (BASE_SIZE * 2)
+
+/* One command of a patch, see esp_ota_delta.c for the format */
+typedef struct {
+    uint32_t diff_len;
+    uint32_t extra_len;
+    int32_t seek;
+} test_command_t;
+
+static const esp_partition_t *s_base_part;
+static const esp_partition_t *s_new_part;
+static uint8_t *s_base;
+static uint8_t *s_new;
+static size_t s_new_len;
+static uint8_t *s_patch;
+static size_t s_patch_len;
+static size_t s_written;
+static size_t s_max_chunk;
+
+static void put_varint(uint32_t value)
+{
+    do {
+        s_patch[s_patch_len++] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+        value >>= 7;
+    } while (value);
+}
+
+static void put_u32(uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        s_patch[s_patch_len++] = value >> (8 * i);
+    }
+}
+
+/* Commands out of the source are also built, to check that they are rejected */
+static uint8_t base_at(int64_t pos)
+{
+    return (pos >= 0 && pos < BASE_SIZE) ? s_base[pos] : 0;
+}
+
+/*
+ * Builds a patch from commands, along with the image it produces: the diff data modifies a few bytes
+ * of the base image, so that it is made of runs of unchanged bytes and of added bytes.
+ */
+static void build_patch(const test_command_t *commands, size_t count)
+{
+    s_patch_len = 0;
+    s_new_len = 0;
+    put_u32(ESP_OTA_DELTA_MAGIC);
+    put_u32(ESP_OTA_DELTA_VERSION);
+    put_u32(BASE_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        s_new_len += commands[i].diff_len + commands[i].extra_len;
+    }
+    put_u32(s_new_len);
+    TEST_ASSERT_EQUAL(0, mbedtls_sha256(s_base, BASE_SIZE, s_patch + s_patch_len, 0));
+    s_patch_len += 32;
+    TEST_ASSERT_EQUAL(ESP_OTA_DELTA_HEADER_SIZE, s_patch_len);
+
+    int64_t base_pos = 0;
+    uint8_t *new = s_new;
+    for (size_t i = 0; i < count; i++) {
+        const test_command_t *cmd = &commands[i];
+        put_varint(cmd->diff_len);
+        put_varint(cmd->extra_len);
+        put_varint(((uint32_t)cmd->seek << 1) ^ (uint32_t)(cmd->seek >> 31));
+        for (uint32_t done = 0; done < cmd->diff_len;) {
+            const uint32_t run = rand() % 2000;
+            const uint32_t copy = MIN(run, cmd->diff_len - done);
+            put_varint(copy);
+            for (uint32_t j = 0; j < copy; j++) {
+                *new++ = base_at(base_pos++);
+            }
+            done += copy;
+            if (done == cmd->diff_len) {
+                break;
+            }
+            const uint32_t add = MIN(run % 16 + 1, cmd->diff_len - done);
+            put_varint(add);
+            for (uint32_t j = 0; j < add; j++) {
+                const uint8_t diff = 1 + rand() % 255;
+                s_patch[s_patch_len++] = diff;
+                *new++ = base_at(base_pos++) + diff;
+            }
+            done += add;
+        }
+        for (uint32_t j = 0; j < cmd->extra_len; j++) {
+            s_patch[s_patch_len++] = *new++ = rand();
+        }
+        base_pos += cmd->seek;
+    }
+    TEST_ASSERT_EQUAL(s_new_len, new - s_new);
+}
+
+static esp_err_t write_to_partition(const void *data, size_t size, void *user_ctx)
+{
+    TEST_ASSERT_EQUAL_PTR(s_new_part, user_ctx);
+    TEST_ASSERT_LESS_OR_EQUAL(s_max_chunk, size);
+    esp_err_t err = esp_partition_write(s_new_part, s_written, data, size);
+    s_written += size;
+    return err;
+}
+
+/* Applies the patch in chunks of random sizes, returns the first error */
+static esp_err_t apply_patch(size_t buffer_size)
+{
+    esp_ota_delta_cfg_t cfg = {
+        .src_partition = s_base_part,
+        .write_cb = write_to_partition,
+        .user_ctx = (void *)s_new_part,
+        .buffer_size = buffer_size,
+    };
+    s_max_chunk = buffer_size ? buffer_size : ESP_OTA_DELTA_DEFAULT_BUFFER_SIZE;
+    s_written = 0;
+    TEST_ESP_OK(esp_partition_erase_range(s_new_part, 0, s_new_part->size));
+
+    esp_ota_delta_handle_t handle;
+    TEST_ESP_OK(esp_ota_delta_begin(&cfg, &handle));
+    for (size_t offset = 0, chunk; offset < s_patch_len; offset += chunk) {
+        chunk = rand() % 3000 + 1;
+        chunk = MIN(chunk, s_patch_len - offset);
+        esp_err_t err = esp_ota_delta_write(handle, s_patch + offset, chunk);
+        if (err != ESP_OK) {
+            TEST_ASSERT_EQUAL(err, esp_ota_delta_write(handle, s_patch + offset, chunk));
+            esp_ota_delta_abort(handle);
+            return err;
+        }
+    }
+    return esp_ota_delta_end(handle);
+}
+
+static void check_new_partition(void)
+{
+    TEST_ASSERT_EQUAL(s_new_len, s_written);
+    uint8_t *data = malloc(s_new_len);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ESP_OK(esp_partition_read(s_new_part, 0, data, s_new_len));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(s_new, data, s_new_len);
+    free(data);
+}
+
+static const test_command_t s_commands[] = {
+    { .diff_len = 30000, .extra_len = 100, .seek = 5000 },      // Bytes modified, then inserted
+    { .diff_len = 50000, .extra_len = 0, .seek = -70000 },      // Move back
+    { .diff_len = 0, .extra_len = 5000, .seek = 60000 },        // New data only
+    { .diff_len = 90000, .extra_len = 1, .seek = 0 },
+    { .diff_len = BASE_SIZE - 165000, .extra_len = 4096, .seek = 0 },
+};
+
+TEST_GROUP(ota_delta);
+
+TEST_SETUP(ota_delta)
+{
+    srand(1);
+    s_base_part = esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_FACTORY, NULL);
+    s_new_part = esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, NULL);
+    TEST_ASSERT_NOT_NULL(s_base_part);
+    TEST_ASSERT_NOT_NULL(s_new_part);
+
+    s_base = malloc(BASE_SIZE);
+    s_new = malloc(NEW_MAX_SIZE);
+    s_patch = malloc(PATCH_MAX_SIZE);
+    TEST_ASSERT_NOT_NULL(s_base);
+    TEST_ASSERT_NOT_NULL(s_new);
+    TEST_ASSERT_NOT_NULL(s_patch);
+    for (size_t i = 0; i < BASE_SIZE; i++) {
+        s_base[i] = rand();
+    }
+    TEST_ESP_OK(esp_partition_erase_range(s_base_part, 0, s_base_part->size));
+    TEST_ESP_OK(esp_partition_write(s_base_part, 0, s_base, BASE_SIZE));
+}
+
+TEST_TEAR_DOWN(ota_delta)
+{
+    free(s_base);
+    free(s_new);
+    free(s_patch);
+}
+
+TEST(ota_delta, test_is_patch)
+{
+    build_patch(s_commands, sizeof(s_commands) / sizeof(s_commands[0]));
+    TEST_ASSERT_TRUE(esp_ota_delta_is_patch(s_patch, s_patch_len));
+    TEST_ASSERT_TRUE(esp_ota_delta_is_patch(s_patch, 4));
+    TEST_ASSERT_FALSE(esp_ota_delta_is_patch(s_patch, 3));
+    TEST_ASSERT_FALSE(esp_ota_delta_is_patch(NULL, 4));
+    TEST_ASSERT_FALSE(esp_ota_delta_is_patch(s_base, BASE_SIZE));
+}
+
+TEST(ota_delta, test_apply)
+{
+    const size_t buffer_sizes[] = { 0, 1, 100, 4096, 65536 };
+    for (size_t i = 0; i < sizeof(buffer_sizes) / sizeof(buffer_sizes[0]); i++) {
+        build_patch(s_commands, sizeof(s_commands) / sizeof(s_commands[0]));
+        TEST_ESP_OK(apply_patch(buffer_sizes[i]));
+        check_new_partition();
+    }
+}
+
+TEST(ota_delta, test_apply_single_command)
+{
+    const test_command_t commands[] = {
+        { .diff_len = BASE_SIZE, .extra_len = 0, .seek = 0 },
+    };
+    build_patch(commands, 1);
+    TEST_ESP_OK(apply_patch(0));
+    check_new_partition();
+}
+
+TEST(ota_delta, test_wrong_source)
+{
+    build_patch(s_commands, sizeof(s_commands) / sizeof(s_commands[0]));
+    const uint8_t byte = ~s_base[BASE_SIZE - 1];
+    TEST_ESP_OK(esp_partition_write(s_base_part, BASE_SIZE - 1, &byte, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, apply_patch(0));
+    TEST_ASSERT_EQUAL(0, s_written);
+}
+
+TEST(ota_delta, test_wrong_version)
+{
+    build_patch(s_commands, sizeof(s_commands) / sizeof(s_commands[0]));
+    s_patch[4] = ESP_OTA_DELTA_VERSION + 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_VERSION, apply_patch(0));
+    s_patch[4] = ESP_OTA_DELTA_VERSION;
+    s_patch[0] = 0xe9;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_VERSION, apply_patch(0));
+}
+
+TEST(ota_delta, test_truncated_patch)
+{
+    build_patch(s_commands, sizeof(s_commands) / sizeof(s_commands[0]));
+    const size_t patch_len = s_patch_len;
+    const size_t lengths[] = { 0, 10, ESP_OTA_DELTA_HEADER_SIZE, ESP_OTA_DELTA_HEADER_SIZE + 1, patch_len / 2, patch_len - 1 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        s_patch_len = lengths[i];
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, apply_patch(0));
+    }
+}
+
+TEST(ota_delta, test_data_after_patch)
+{
+    build_patch(s_commands, sizeof(s_commands) / sizeof(s_commands[0]));
+    s_patch[s_patch_len++] = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, apply_patch(0));
+}
+
+TEST(ota_delta, test_out_of_range_commands)
+{
+    // Diff data after the end of the source
+    const test_command_t past_source[] = {
+        { .diff_len = 0, .extra_len = 10, .seek = BASE_SIZE - 10 },
+        { .diff_len = 11, .extra_len = 0, .seek = 0 },
+    };
+    // Seek before the start of the source
+    const test_command_t before_source[] = {
+        { .diff_len = 10, .extra_len = 10, .seek = -11 },
+        { .diff_len = 10, .extra_len = 0, .seek = 0 },
+    };
+    // The diff data is checked against the size of the source, not of the partition
+    build_patch(past_source, 2);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, apply_patch(0));
+    build_patch(before_source, 2);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, apply_patch(0));
+}
+
+TEST_GROUP_RUNNER(ota_delta)
+{
+    RUN_TEST_CASE(ota_delta, test_is_patch);
+    RUN_TEST_CASE(ota_delta, test_apply);
+    RUN_TEST_CASE(ota_delta, test_apply_single_command);
+    RUN_TEST_CASE(ota_delta, test_wrong_source);
+    RUN_TEST_CASE(ota_delta, test_wrong_version);
+    RUN_TEST_CASE(ota_delta, test_truncated_patch);
+    RUN_TEST_CASE(ota_delta, test_data_after_patch);
+    RUN_TEST_CASE(ota_delta, test_out_of_range_commands);
+}
+
+static void run_all_tests(void)
+{
+    RUN_TEST_GROUP(ota_delta);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_MAIN_FUNC(run_all_tests);
+    return 0;
+}
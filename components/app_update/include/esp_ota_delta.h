@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define ESP_OTA_DELTA_MAGIC         0x544c4445  /*!< Magic word at the start of a delta patch ("EDLT") */
+#define ESP_OTA_DELTA_VERSION       1           /*!< Version of the delta patch format handled by this component */
+#define ESP_OTA_DELTA_HEADER_SIZE   48          /*!< Size of the header at the start of a delta patch */
+#define ESP_OTA_DELTA_DEFAULT_BUFFER_SIZE 4096  /*!< Size of the output window used if esp_ota_delta_cfg_t::buffer_size is 0 */
+
+/**
+ * @brief Opaque handle for a delta patch being applied
+ */
+typedef struct esp_ota_delta *esp_ota_delta_handle_t;
+
+/**
+ * @brief Callback receiving the image reconstructed from a delta patch
+ *
+ * The data is passed in order, in chunks of at most esp_ota_delta_cfg_t::buffer_size bytes.
+ * Typically, this callback passes the data to esp_ota_write().
+ *
+ * @param data      Reconstructed image data
+ * @param size      Size of the data
+ * @param user_ctx  esp_ota_delta_cfg_t::user_ctx
+ *
+ * @return ESP_OK to continue applying the patch, any other value stops it and is returned to the caller.
+ */
+typedef esp_err_t (*esp_ota_delta_write_cb_t)(const void *data, size_t size, void *user_ctx);
+
+/**
+ * @brief Configuration for applying a delta patch
+ */
+typedef struct {
+    const esp_partition_t *src_partition;   /*!< Partition holding the image the patch was generated against, usually the running partition */
+    esp_ota_delta_write_cb_t write_cb;      /*!< Callback receiving the reconstructed image */
+    void *user_ctx;                         /*!< User context passed to write_cb */
+    size_t buffer_size;                     /*!< Size of the output window, which is the only buffer allocated. 0 for ESP_OTA_DELTA_DEFAULT_BUFFER_SIZE */
+} esp_ota_delta_cfg_t;
+
+/**
+ * @brief Check if some data is the start of a delta patch
+ *
+ * @param data  Start of the data, as received from the update server
+ * @param size  Size of the data, at least 4 bytes are needed to recognize a patch
+ *
+ * @return true if the data starts with the magic word of a delta patch
+ */
+bool esp_ota_delta_is_patch(const void *data, size_t size);
+
+/**
+ * @brief Start applying a delta patch
+ *
+ * The patch is then passed to esp_ota_delta_write() as it is received. The image it produces is passed to
+ * the write callback in order, so a patch can be applied while it is downloaded, without storing it.
+ *
+ * @param cfg     Configuration, copied into the handle
+ * @param handle  On success, returns a handle which should be passed to the other esp_ota_delta_* functions
+ *
+ * @return
+ *    - ESP_OK: Success
+ *    - ESP_ERR_INVALID_ARG: cfg, handle, the source partition or the write callback is NULL
+ *    - ESP_ERR_NO_MEM: Cannot allocate memory for the handle
+ */
+esp_err_t esp_ota_delta_begin(const esp_ota_delta_cfg_t *cfg, esp_ota_delta_handle_t *handle);
+
+/**
+ * @brief Pass the next bytes of a delta patch
+ *
+ * The data may be split at any position. The source partition is checked against the patch
+ * once its header has been received.
+ *
+ * Once an error was returned, the same error is returned by further calls and the handle should be
+ * released with esp_ota_delta_abort().
+ *
+ * @param handle  Handle obtained from esp_ota_delta_begin()
+ * @param data    Next bytes of the patch
+ * @param size    Size of the data
+ *
+ * @return
+ *    - ESP_OK: Success
+ *    - ESP_ERR_INVALID_ARG: handle is NULL, or data is NULL while size is not 0
+ *    - ESP_ERR_INVALID_VERSION: The data is not a delta patch, or it uses an unsupported version of the format
+ *    - ESP_ERR_INVALID_CRC: The source partition does not hold the image the patch was generated against
+ *    - ESP_ERR_INVALID_SIZE: The patch is corrupted or longer than expected
+ *    - Errors from esp_partition_read() or from the write callback
+ */
+esp_err_t esp_ota_delta_write(esp_ota_delta_handle_t handle, const void *data, size_t size);
+
+/**
+ * @brief Finish applying a delta patch
+ *
+ * Passes the end of the image to the write callback and releases the handle, which must not be used afterwards.
+ * The image is not verified here, this is done by esp_ota_end() once the image is written.
+ *
+ * @param handle  Handle obtained from esp_ota_delta_begin()
+ *
+ * @return
+ *    - ESP_OK: The whole image was produced
+ *    - ESP_ERR_INVALID_ARG: handle is NULL
+ *    - ESP_ERR_INVALID_SIZE: The patch is truncated
+ *    - Errors previously returned by esp_ota_delta_write(), or from the write callback
+ */
+esp_err_t esp_ota_delta_end(esp_ota_delta_handle_t handle);
+
+/**
+ * @brief Stop applying a delta patch and release the handle
+ *
+ * @param handle  Handle obtained from esp_ota_delta_begin(), the function does nothing if it is NULL
+ */
+void esp_ota_delta_abort(esp_ota_delta_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
+#include <sys/param.h>
 #include "esp_log.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
@@ -14,6 +16,7 @@
 #include <unity.h>
 #include <test_utils.h>
 #include <esp_ota_ops.h>
+#include <esp_image_format.h>
 
 /* These OTA tests currently don't assume an OTA partition exists
    on the device, so they're a bit limited
@@ -122,3 +125,51 @@ TEST_CASE("esp_ota_get_running_partition points to correct address", "[spi_flash
     ESP_LOGI("running bin", "0x%p", (void*)part->address);
     TEST_ASSERT_EQUAL_HEX32(factory->address, part->address);
 }
+
+/* Copy the running app to the next OTA partition in unaligned chunks, with one byte of segment data flipped if corrupt is set */
+static esp_err_t write_running_app_in_chunks(bool corrupt)
+{
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    const esp_partition_t *update = esp_ota_get_next_update_partition(NULL);
+    TEST_ASSERT_NOT_NULL(running);
+    TEST_ASSERT_NOT_NULL(update);
+
+    esp_image_metadata_t metadata;
+    const esp_partition_pos_t running_pos = {
+        .offset = running->address,
+        .size = running->size,
+    };
+    TEST_ESP_OK(esp_image_get_metadata(&running_pos, &metadata));
+    TEST_ASSERT_GREATER_THAN(1, metadata.image.segment_count);
+    uint32_t corrupt_offset = metadata.segment_data[1] - running->address + metadata.segments[1].data_len / 2;
+
+    const uint8_t *image;
+    esp_partition_mmap_handle_t image_map;
+    TEST_ESP_OK(esp_partition_mmap(running, 0, metadata.image_len, ESP_PARTITION_MMAP_DATA, (const void **)&image, &image_map));
+    uint8_t *chunk = malloc(4096);
+    TEST_ASSERT_NOT_NULL(chunk);
+
+    esp_ota_handle_t handle;
+    TEST_ESP_OK(esp_ota_begin(update, OTA_SIZE_UNKNOWN, &handle));
+    for (uint32_t offset = 0, len; offset < metadata.image_len; offset += len) {
+        len = MIN(1000 + offset % 3001, metadata.image_len - offset);
+        memcpy(chunk, image + offset, len);
+        if (corrupt && corrupt_offset >= offset && corrupt_offset < offset + len) {
+            chunk[corrupt_offset - offset] ^= 0x01;
+        }
+        TEST_ESP_OK(esp_ota_write(handle, chunk, len));
+    }
+    free(chunk);
+    esp_partition_munmap(image_map);
+
+    TickType_t start = xTaskGetTickCount();
+    esp_err_t err = esp_ota_end(handle);
+    ESP_LOGI("ota_test", "esp_ota_end() of a %"PRIu32" bytes image took %"PRIu32" ms", metadata.image_len, (uint32_t)pdTICKS_TO_MS(xTaskGetTickCount() - start));
+    return err;
+}
+
+TEST_CASE("esp_ota_end() verifies the image written in chunks", "[ota]")
+{
+    TEST_ESP_OK(write_running_app_in_chunks(false));
+    TEST_ESP_ERR(ESP_ERR_OTA_VALIDATE_FAILED, write_running_app_in_chunks(true));
+}
@@ -127,6 +127,69 @@ esp_err_t esp_image_verify(esp_image_load_mode_t mode, const esp_partition_pos_t
  */
 esp_err_t esp_image_get_metadata(const esp_partition_pos_t *part, esp_image_metadata_t *metadata);
 
+#ifndef BOOTLOADER_BUILD
+/* Handle of an image verification done while the image is written */
+typedef struct esp_image_stream_verify *esp_image_stream_verify_handle_t;
+
+/**
+ * @brief Start to verify an app image from its data, as it is written to a partition.
+ *
+ * The image is parsed and hashed from the data passed to esp_image_stream_verify_feed(), so that
+ * esp_image_stream_verify_finish() does not need to read the image back from flash. The same checks
+ * as esp_image_verify() are done, except that the data is checked as it was passed rather than as
+ * it was stored in flash.
+ *
+ * @param part Partition the app image is written to.
+ * @param[out] out_handle Handle of the verification.
+ *
+ * @return
+ * - ESP_OK on success
+ * - ESP_ERR_NOT_SUPPORTED if the image must be verified with esp_image_verify(): when signed images
+ *   are verified, or when the partition is the bootloader
+ * - ESP_ERR_INVALID_ARG if the arguments are invalid
+ * - ESP_ERR_NO_MEM if the verification context cannot be allocated
+ */
+esp_err_t esp_image_stream_verify_begin(const esp_partition_pos_t *part, esp_image_stream_verify_handle_t *out_handle);
+
+/**
+ * @brief Pass the next bytes of the image to the verification.
+ *
+ * The data must be passed in order, starting at the beginning of the image. Data after the end
+ * of the image is ignored.
+ *
+ * @param handle Handle of the verification.
+ * @param data Next bytes of the image.
+ * @param len Length of data, in bytes.
+ *
+ * @return
+ * - ESP_OK on success
+ * - ESP_ERR_IMAGE_INVALID if the image is invalid. The following calls return the same error.
+ * - ESP_ERR_NO_MEM if the SHA-256 calculation cannot be started
+ */
+esp_err_t esp_image_stream_verify_feed(esp_image_stream_verify_handle_t handle, const void *data, size_t len);
+
+/**
+ * @brief Finish the verification of the image and free the handle.
+ *
+ * @param handle Handle of the verification.
+ * @param[out] data Pointer to the image metadata structure which is filled in by this function,
+ *                  as by esp_image_verify(). Can be NULL.
+ *
+ * @return
+ * - ESP_OK if the image is valid
+ * - ESP_ERR_IMAGE_INVALID if the image is invalid or incomplete
+ * - ESP_ERR_NO_MEM if the SHA-256 calculation could not be started
+ */
+esp_err_t esp_image_stream_verify_finish(esp_image_stream_verify_handle_t handle, esp_image_metadata_t *data);
+
+/**
+ * @brief Abort the verification of the image and free the handle.
+ *
+ * @param handle Handle of the verification. Can be NULL.
+ */
+void esp_image_stream_verify_abort(esp_image_stream_verify_handle_t handle);
+#endif // !BOOTLOADER_BUILD
+
 /**
  * @brief Verify and load an app image (available only in space of bootloader).
  *
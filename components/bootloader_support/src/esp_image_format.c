@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <string.h>
+#include <stdlib.h>
 #include <sys/param.h>
 #include <esp_cpu.h>
 #include <bootloader_utility.h>
@@ -83,8 +84,8 @@ static esp_err_t process_segment_data(int segment, intptr_t load_addr, uint32_t
 /* Verify the main image header */
 static esp_err_t verify_image_header(uint32_t src_addr, const esp_image_header_t *image, bool silent);
 
-/* Verify a segment header */
-static esp_err_t verify_segment_header(int index, const esp_image_segment_header_t *segment, uint32_t segment_data_offs, esp_image_metadata_t *metadata, bool silent);
+/* Verify a segment header. app_desc is an in-memory copy of the start of segment #0, or NULL to read it from flash */
+static esp_err_t verify_segment_header(int index, const esp_image_segment_header_t *segment, uint32_t segment_data_offs, const esp_app_desc_t *app_desc, esp_image_metadata_t *metadata, bool silent);
 
 /* Log-and-fail macro for use in esp_image_load */
 #define FAIL_LOAD(...) do {                         \
@@ -604,7 +605,7 @@ static esp_err_t process_segment(int index, uint32_t flash_addr, esp_image_segme
 
     ESP_LOGV(TAG, "segment data length 0x%"PRIx32" data starts 0x%"PRIx32, data_len, data_addr);
 
-    CHECK_ERR(verify_segment_header(index, header, data_addr, metadata, silent));
+    CHECK_ERR(verify_segment_header(index, header, data_addr, NULL, metadata, silent));
 
     if (data_len % 4 != 0) {
         FAIL_LOAD("unaligned segment length 0x%"PRIx32, data_len);
@@ -802,7 +803,7 @@ static esp_err_t process_segment_data(int segment, intptr_t load_addr, uint32_t
     return ESP_OK;
 }
 
-static esp_err_t verify_segment_header(int index, const esp_image_segment_header_t *segment, uint32_t segment_data_offs, esp_image_metadata_t *metadata, bool silent)
+static esp_err_t verify_segment_header(int index, const esp_image_segment_header_t *segment, uint32_t segment_data_offs, const esp_app_desc_t *app_desc, esp_image_metadata_t *metadata, bool silent)
 {
     if ((segment->data_len & 3) != 0
             || segment->data_len >= ESP_IMAGE_MAX_FLASH_ADDR_SIZE) {
@@ -821,9 +822,14 @@ static esp_err_t verify_segment_header(int index, const esp_image_segment_header
     /* ESP APP descriptor is present in the DROM segment #0 */
     if (index == 0 && !is_bootloader(metadata->start_addr)) {
         uint32_t mmu_page_size = 0, magic_word = 0;
-        const uint32_t mmu_page_size_offset = segment_data_offs + offsetof(esp_app_desc_t, mmu_page_size);
-        CHECK_ERR(bootloader_flash_read(segment_data_offs, &magic_word, sizeof(uint32_t), true));
-        CHECK_ERR(bootloader_flash_read(mmu_page_size_offset, &mmu_page_size, sizeof(uint32_t), true));
+        if (app_desc != NULL) {
+            magic_word = app_desc->magic_word;
+            mmu_page_size = app_desc->mmu_page_size;
+        } else {
+            const uint32_t mmu_page_size_offset = segment_data_offs + offsetof(esp_app_desc_t, mmu_page_size);
+            CHECK_ERR(bootloader_flash_read(segment_data_offs, &magic_word, sizeof(uint32_t), true));
+            CHECK_ERR(bootloader_flash_read(mmu_page_size_offset, &mmu_page_size, sizeof(uint32_t), true));
+        }
         // Extract only the lowest byte from mmu_page_size (as per image format)
         mmu_page_size &= 0xFF;
 
@@ -1179,3 +1185,290 @@ int esp_image_get_flash_size(esp_image_flash_size_t app_flash_size)
         return 0;
     }
 }
+
+#ifndef BOOTLOADER_BUILD
+/* Verification of an image from its data as it is written, see esp_image_stream_verify_begin()
+
+   The image is split in fields which are received one after the other: the image header, then for each
+   segment its header, the app descriptor (only at the start of segment #0) and the rest of the segment data,
+   then the padding ending with the checksum byte and the appended SHA-256 digest.
+*/
+typedef enum {
+    STREAM_IMAGE_HEADER,
+    STREAM_SEGMENT_HEADER,
+    STREAM_APP_DESC,
+    STREAM_SEGMENT_DATA,
+    STREAM_CHECKSUM,
+    STREAM_HASH,
+    STREAM_DONE,
+} stream_field_t;
+
+struct esp_image_stream_verify {
+    esp_image_metadata_t metadata;
+    uint32_t part_size;
+    stream_field_t field;                   /* Field being received */
+    uint8_t *field_buf;                     /* Where the field is copied, NULL for the segment data */
+    uint32_t field_len;                     /* Length of the field */
+    uint32_t field_pos;                     /* Number of bytes of the field received */
+    int segment;                            /* Index of the segment being received */
+    uint32_t checksum_word;
+    bootloader_sha256_handle_t sha_handle;
+    esp_err_t err;                          /* First error, returned by all the following calls */
+    esp_app_desc_t app_desc;
+    WORD_ALIGNED_ATTR uint8_t checksum_buf[16];
+};
+
+static void stream_set_field(esp_image_stream_verify_handle_t handle, stream_field_t field, void *buf, uint32_t len)
+{
+    handle->field = field;
+    handle->field_buf = buf;
+    handle->field_len = len;
+    handle->field_pos = 0;
+}
+
+static void stream_process_data(esp_image_stream_verify_handle_t handle, const uint8_t *data, size_t len)
+{
+    // The checksum byte is the XOR of all the bytes of the segments data, so
+    // the words do not need to be aligned with the start of the segments.
+    uint32_t checksum_word = handle->checksum_word;
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        uint32_t w;
+        memcpy(&w, data + i, sizeof(w));
+        checksum_word ^= w;
+    }
+    for (; i < len; i++) {
+        checksum_word ^= data[i];
+    }
+    handle->checksum_word = checksum_word;
+    if (handle->sha_handle != NULL) {
+        bootloader_sha256_data(handle->sha_handle, data, len);
+    }
+}
+
+static void stream_start_segment_or_checksum(esp_image_stream_verify_handle_t handle)
+{
+    if (handle->segment < handle->metadata.image.segment_count) {
+        stream_set_field(handle, STREAM_SEGMENT_HEADER, &handle->metadata.segments[handle->segment], sizeof(esp_image_segment_header_t));
+    } else {
+        uint32_t unpadded_length = handle->metadata.image_len;
+        uint32_t length = ((unpadded_length + 1 + 15) & ~15) - unpadded_length; // Padding up to the checksum byte at the end of a 16 byte block
+        stream_set_field(handle, STREAM_CHECKSUM, handle->checksum_buf, length);
+    }
+}
+
+static esp_err_t stream_end_image_header(esp_image_stream_verify_handle_t handle)
+{
+    esp_image_metadata_t *data = &handle->metadata;
+    if (data->image.hash_appended) {
+        handle->sha_handle = bootloader_sha256_start();
+        if (handle->sha_handle == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        bootloader_sha256_data(handle->sha_handle, &data->image, sizeof(esp_image_header_t));
+    }
+    if (verify_image_header(data->start_addr, &data->image, false) != ESP_OK) {
+        return ESP_ERR_IMAGE_INVALID;
+    }
+    data->image_len = sizeof(esp_image_header_t);
+    stream_start_segment_or_checksum(handle);
+    return ESP_OK;
+}
+
+static esp_err_t stream_end_segment_header(esp_image_stream_verify_handle_t handle)
+{
+    esp_image_metadata_t *data = &handle->metadata;
+    int index = handle->segment;
+    esp_image_segment_header_t *header = &data->segments[index];
+    if (handle->sha_handle != NULL) {
+        bootloader_sha256_data(handle->sha_handle, header, sizeof(esp_image_segment_header_t));
+    }
+    uint32_t data_addr = data->start_addr + data->image_len + sizeof(esp_image_segment_header_t);
+    data->segment_data[index] = data_addr;
+    data->image_len += sizeof(esp_image_segment_header_t);
+
+    if (index == 0) {
+        // The app descriptor is at the start of segment #0, the header is verified once it is received
+        stream_set_field(handle, STREAM_APP_DESC, &handle->app_desc, MIN(header->data_len, sizeof(esp_app_desc_t)));
+        return ESP_OK;
+    }
+    if (verify_segment_header(index, header, data_addr, NULL, data, false) != ESP_OK) {
+        return ESP_ERR_IMAGE_INVALID;
+    }
+    ESP_LOGI(TAG, "segment %d: paddr=%08"PRIx32" vaddr=%08"PRIx32" size=%05"PRIx32"h (%6"PRIu32") %s",
+             index, data_addr, header->load_addr, header->data_len, header->data_len, should_map(header->load_addr) ? "map" : "");
+    stream_set_field(handle, STREAM_SEGMENT_DATA, NULL, header->data_len);
+    return ESP_OK;
+}
+
+static esp_err_t stream_end_app_desc(esp_image_stream_verify_handle_t handle)
+{
+    esp_image_metadata_t *data = &handle->metadata;
+    esp_image_segment_header_t *header = &data->segments[0];
+    const esp_app_desc_t *app_desc = &handle->app_desc;
+    if (verify_segment_header(0, header, data->segment_data[0], app_desc, data, false) != ESP_OK) {
+        return ESP_ERR_IMAGE_INVALID;
+    }
+    ESP_LOGI(TAG, "segment 0: paddr=%08"PRIx32" vaddr=%08"PRIx32" size=%05"PRIx32"h (%6"PRIu32") %s",
+             data->segment_data[0], header->load_addr, header->data_len, header->data_len, should_map(header->load_addr) ? "map" : "");
+/* ESP32 doesn't have more memory and more efuse bits for block major version. */
+#if !CONFIG_IDF_TARGET_ESP32
+    if (bootloader_common_check_efuse_blk_validity(app_desc->min_efuse_blk_rev_full, app_desc->max_efuse_blk_rev_full) != ESP_OK) {
+        return ESP_ERR_IMAGE_INVALID;
+    }
+#endif  // !CONFIG_IDF_TARGET_ESP32
+#if CONFIG_BOOTLOADER_APP_ANTI_ROLLBACK
+    if (app_desc->magic_word != ESP_APP_DESC_MAGIC_WORD) {
+        ESP_LOGE(TAG, "Failed to fetch app description header!");
+        return ESP_ERR_IMAGE_INVALID;
+    }
+    data->secure_version = app_desc->secure_version;
+#endif // CONFIG_BOOTLOADER_APP_ANTI_ROLLBACK
+    stream_process_data(handle, handle->field_buf, handle->field_len);
+    stream_set_field(handle, STREAM_SEGMENT_DATA, NULL, header->data_len - handle->field_len);
+    return ESP_OK;
+}
+
+static esp_err_t stream_end_segment_data(esp_image_stream_verify_handle_t handle)
+{
+    handle->metadata.image_len += handle->metadata.segments[handle->segment].data_len;
+    handle->segment++;
+    stream_start_segment_or_checksum(handle);
+    return ESP_OK;
+}
+
+static esp_err_t stream_end_checksum(esp_image_stream_verify_handle_t handle)
+{
+    esp_image_metadata_t *data = &handle->metadata;
+    uint32_t checksum_word = handle->checksum_word;
+    uint8_t read_checksum = handle->checksum_buf[handle->field_len - 1];
+    uint8_t calc_checksum = (checksum_word >> 24) ^ (checksum_word >> 16) ^ (checksum_word >> 8) ^ (checksum_word >> 0);
+    if (!esp_cpu_dbgr_is_attached() && calc_checksum != read_checksum) {
+        ESP_LOGE(TAG, "Checksum failed. Calculated 0x%x read 0x%x", calc_checksum, read_checksum);
+        return ESP_ERR_IMAGE_INVALID;
+    }
+    if (handle->sha_handle != NULL) {
+        bootloader_sha256_data(handle->sha_handle, handle->checksum_buf, handle->field_len);
+    }
+    data->image_len += handle->field_len;
+    if (data->image.hash_appended) {
+        stream_set_field(handle, STREAM_HASH, data->image_digest, HASH_LEN);
+    } else {
+        stream_set_field(handle, STREAM_DONE, NULL, 0);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stream_end_field(esp_image_stream_verify_handle_t handle)
+{
+    switch (handle->field) {
+    case STREAM_IMAGE_HEADER:
+        return stream_end_image_header(handle);
+    case STREAM_SEGMENT_HEADER:
+        return stream_end_segment_header(handle);
+    case STREAM_APP_DESC:
+        return stream_end_app_desc(handle);
+    case STREAM_SEGMENT_DATA:
+        return stream_end_segment_data(handle);
+    case STREAM_CHECKSUM:
+        return stream_end_checksum(handle);
+    case STREAM_HASH:
+        handle->metadata.image_len += HASH_LEN;
+        stream_set_field(handle, STREAM_DONE, NULL, 0);
+        return ESP_OK;
+    default:
+        return ESP_OK;
+    }
+}
+
+esp_err_t esp_image_stream_verify_begin(const esp_partition_pos_t *part, esp_image_stream_verify_handle_t *out_handle)
+{
+    if (part == NULL || out_handle == NULL || part->size > ESP_IMAGE_MAX_FLASH_ADDR_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#if (SECURE_BOOT_CHECK_SIGNATURE == 1) || CONFIG_SECURE_BOOT || CONFIG_SECURE_SIGNED_APPS_NO_SECURE_BOOT || CONFIG_APP_BUILD_TYPE_RAM
+    // The signature block is verified from flash, and the SHA-256 implementation of RAM apps needs word aligned data
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    if (is_bootloader(part->offset)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_image_stream_verify_handle_t handle = calloc(1, sizeof(struct esp_image_stream_verify));
+    if (handle == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    handle->metadata.start_addr = part->offset;
+    handle->part_size = part->size;
+    handle->checksum_word = ESP_ROM_CHECKSUM_INITIAL;
+    stream_set_field(handle, STREAM_IMAGE_HEADER, &handle->metadata.image, sizeof(esp_image_header_t));
+    *out_handle = handle;
+    return ESP_OK;
+#endif
+}
+
+esp_err_t esp_image_stream_verify_feed(esp_image_stream_verify_handle_t handle, const void *data, size_t len)
+{
+    if (handle == NULL || (data == NULL && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint8_t *src = (const uint8_t *)data;
+    // Zero length fields (e.g. empty segments) are ended without waiting for more data
+    while (handle->err == ESP_OK && handle->field != STREAM_DONE && (len > 0 || handle->field_pos == handle->field_len)) {
+        size_t copy_len = MIN(len, handle->field_len - handle->field_pos);
+        if (handle->field_buf != NULL) {
+            memcpy(handle->field_buf + handle->field_pos, src, copy_len);
+        } else {
+            stream_process_data(handle, src, copy_len);
+        }
+        handle->field_pos += copy_len;
+        src += copy_len;
+        len -= copy_len;
+        if (handle->field_pos == handle->field_len) {
+            handle->err = stream_end_field(handle);
+        }
+    }
+    return handle->err;
+}
+
+esp_err_t esp_image_stream_verify_finish(esp_image_stream_verify_handle_t handle, esp_image_metadata_t *data)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = esp_image_stream_verify_feed(handle, NULL, 0);
+    esp_image_metadata_t *metadata = &handle->metadata;
+    if (err == ESP_OK && handle->field != STREAM_DONE) {
+        ESP_LOGE(TAG, "image at 0x%"PRIx32" is incomplete", metadata->start_addr);
+        err = ESP_ERR_IMAGE_INVALID;
+    }
+    if (err == ESP_OK && metadata->image_len > handle->part_size) {
+        ESP_LOGE(TAG, "Image length %"PRIu32" doesn't fit in partition length %"PRIu32, metadata->image_len, handle->part_size);
+        err = ESP_ERR_IMAGE_INVALID;
+    }
+    if (err == ESP_OK && handle->sha_handle != NULL && !esp_cpu_dbgr_is_attached()) {
+        err = verify_simple_hash(handle->sha_handle, metadata);
+        handle->sha_handle = NULL; // calling verify_simple_hash finishes sha_handle
+    }
+    if (data != NULL) {
+        if (err == ESP_OK) {
+            memcpy(data, metadata, sizeof(esp_image_metadata_t));
+        } else {
+            // Prevent invalid/incomplete data leaking out
+            bzero(data, sizeof(esp_image_metadata_t));
+        }
+    }
+    esp_image_stream_verify_abort(handle);
+    return err;
+}
+
+void esp_image_stream_verify_abort(esp_image_stream_verify_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    if (handle->sha_handle != NULL) {
+        bootloader_sha256_finish(handle->sha_handle, NULL);
+    }
+    free(handle);
+}
+#endif // !BOOTLOADER_BUILD
@@ -10,6 +10,7 @@
 #include <esp_types.h>
 #include <stdio.h>
 #include "string.h"
+#include <sys/param.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -54,6 +55,40 @@ TEST_CASE("Verify unit test app image", "[bootloader_support]")
     TEST_ASSERT_TRUE(data.image_len <= running->size);
 }
 
+TEST_CASE("Verify unit test app image from its data", "[bootloader_support]")
+{
+    esp_image_metadata_t data = { 0 };
+    esp_image_metadata_t stream_data = { 0 };
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    TEST_ASSERT_NOT_EQUAL(NULL, running);
+    const esp_partition_pos_t running_pos  = {
+        .offset = running->address,
+        .size = running->size,
+    };
+    TEST_ASSERT_EQUAL_HEX(ESP_OK, esp_image_verify(ESP_IMAGE_VERIFY, &running_pos, &data));
+
+    esp_image_stream_verify_handle_t handle;
+    esp_err_t err = esp_image_stream_verify_begin(&running_pos, &handle);
+    if (err == ESP_ERR_NOT_SUPPORTED) {
+        TEST_IGNORE_MESSAGE("Image verification from its data is not supported in this configuration");
+    }
+    TEST_ASSERT_EQUAL_HEX(ESP_OK, err);
+
+    // Pass the image in chunks which are not aligned with its fields, with some data after its end
+    const uint8_t *image;
+    esp_partition_mmap_handle_t image_map;
+    const uint32_t len = MIN(data.image_len + 100, running->size);
+    TEST_ASSERT_EQUAL_HEX(ESP_OK, esp_partition_mmap(running, 0, len, ESP_PARTITION_MMAP_DATA, (const void **)&image, &image_map));
+    for (uint32_t offset = 0, chunk; offset < len; offset += chunk) {
+        chunk = MIN(1 + offset % 997, len - offset);
+        TEST_ASSERT_EQUAL_HEX(ESP_OK, esp_image_stream_verify_feed(handle, image + offset, chunk));
+    }
+    esp_partition_munmap(image_map);
+
+    TEST_ASSERT_EQUAL_HEX(ESP_OK, esp_image_stream_verify_finish(handle, &stream_data));
+    TEST_ASSERT_EQUAL_MEMORY(&data, &stream_data, sizeof(data));
+}
+
 void check_label_search (int num_test, const char *list, const char *t_label, bool result)
 {
     // gen_esp32part.py trims up to 16 characters
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "spi_flash_mmap.h"
+
+/* The flash is a buffer of the test, see test_image_stream.c */
+#define FLASH_SECTOR_SIZE   0x1000
+#define MMAP_ALIGNED_MASK   (SPI_FLASH_MMU_PAGE_SIZE - 1)
+
+esp_err_t bootloader_flash_read(size_t src_addr, void *dest, size_t size, bool allow_decrypt);
+
+const void *bootloader_mmap(uint32_t src_addr, uint32_t size);
+
+void bootloader_munmap(const void *mapping);
+
+uint32_t bootloader_mmap_get_free_pages(void);
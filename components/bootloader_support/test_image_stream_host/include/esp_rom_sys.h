@@ -0,0 +1,14 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define RESET_REASON_CHIP_POWER_ON      0x01
+#define RESET_REASON_CORE_DEEP_SLEEP    0x05
+#define RESET_REASON_CORE_EFUSE_CRC     0x14
+
+uint32_t esp_rom_get_reset_reason(int cpu_no);
@@ -0,0 +1,15 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#define ESP_SECURE_BOOT_DIGEST_LEN 32
+
+static inline bool esp_secure_boot_enabled(void)
+{
+    return false;
+}
@@ -0,0 +1,8 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* The SHA-256 of bootloader_sha.c is built on mbedTLS, which does not use the ROM */
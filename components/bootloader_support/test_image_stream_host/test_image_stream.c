@@ -0,0 +1,283 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Host test of the verification of an app image as it is written (esp_image_stream_verify_*), against
+ * esp_image_verify() of the same image in flash.
+ *
+ * Random images, valid or with a flipped bit, a truncation or a debugger attached, are verified by both
+ * and must give the same result and metadata. Run with "benchmark" as argument to time both instead. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <mbedtls/sha256.h>
+#include "esp_image_format.h"
+#include "esp_app_desc.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "bootloader_common.h"
+#include "bootloader_flash_priv.h"
+#include "bootloader_utility.h"
+#include "soc/soc.h"
+
+#define FLASH_SIZE          0x400000
+#define PART_OFFSET         0x10000
+#define PART_SIZE           0x300000
+#define TEST_SEEDS          5000
+#define BENCHMARK_RUNS      50
+#define BENCHMARK_CHUNK     4096
+
+/* ESP_CHIP_ID_ESP32C3, the target the test is built for */
+#define TEST_CHIP_ID        5
+
+static uint8_t *s_flash;
+static bool s_dbgr_attached;
+static int s_failures;
+
+esp_err_t bootloader_flash_read(size_t src_addr, void *dest, size_t size, bool allow_decrypt)
+{
+    if (src_addr + size > FLASH_SIZE) {
+        return ESP_FAIL;
+    }
+    memcpy(dest, s_flash + src_addr, size);
+    return ESP_OK;
+}
+
+const void *bootloader_mmap(uint32_t src_addr, uint32_t size)
+{
+    return src_addr + size > FLASH_SIZE ? NULL : s_flash + src_addr;
+}
+
+void bootloader_munmap(const void *mapping)
+{
+}
+
+uint32_t bootloader_mmap_get_free_pages(void)
+{
+    return 50;
+}
+
+bool esp_cpu_dbgr_is_attached(void)
+{
+    return s_dbgr_attached;
+}
+
+uint32_t esp_rom_get_reset_reason(int cpu_no)
+{
+    return RESET_REASON_CHIP_POWER_ON;
+}
+
+void bootloader_debug_buffer(const void *buffer, size_t length, const char *label)
+{
+}
+
+esp_err_t bootloader_common_check_chip_validity(const esp_image_header_t *img_hdr, esp_image_type type)
+{
+    return img_hdr->chip_id == TEST_CHIP_ID ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t bootloader_common_check_efuse_blk_validity(uint32_t min_rev_full, uint32_t max_rev_full)
+{
+    return min_rev_full <= 100 ? ESP_OK : ESP_FAIL;
+}
+
+static uint32_t rand32(void)
+{
+    return (uint32_t)random();
+}
+
+/* Build an image of random segments in img, with the app descriptor in the first one. Return its length. */
+static size_t build_image(uint8_t *img)
+{
+    esp_image_header_t *hdr = (esp_image_header_t *)img;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = ESP_IMAGE_HEADER_MAGIC;
+    hdr->segment_count = rand32() % 7;
+    hdr->chip_id = TEST_CHIP_ID;
+    hdr->hash_appended = rand32() % 4 != 0;
+    size_t pos = sizeof(*hdr);
+    uint8_t checksum = 0xEF;
+    for (int i = 0; i < hdr->segment_count; i++) {
+        esp_image_segment_header_t *seg = (esp_image_segment_header_t *)(img + pos);
+        pos += sizeof(*seg);
+        /* Mapped segments must have the same offset in the MMU page as in flash */
+        uint32_t page_offset = (PART_OFFSET + pos) & 0xffff;
+        int kind = i == 0 ? 0 : rand32() % 3;
+        seg->data_len = (i == 0 ? 256 : 0) + 4 * (rand32() % (rand32() % 8 == 0 ? 3 : 8000));
+        if (kind == 0) {
+            seg->load_addr = SOC_DROM_LOW + 0x100000 + page_offset;
+        } else if (kind == 1) {
+            seg->load_addr = SOC_IROM_LOW + 0x100000 + page_offset;
+        } else {
+            seg->load_addr = SOC_DIRAM_IRAM_LOW + 4 * (rand32() % 1000);
+        }
+        for (uint32_t j = 0; j < seg->data_len; j++) {
+            img[pos + j] = rand32();
+        }
+        if (i == 0) {
+            esp_app_desc_t *desc = (esp_app_desc_t *)(img + pos);
+            desc->magic_word = ESP_APP_DESC_MAGIC_WORD;
+            desc->min_efuse_blk_rev_full = rand32() % 20 == 0 ? 200 : 0;
+            desc->mmu_page_size = rand32() % 2 ? 16 : 0;
+        }
+        for (uint32_t j = 0; j < seg->data_len; j++) {
+            checksum ^= img[pos + j];
+        }
+        pos += seg->data_len;
+    }
+    size_t padded = (pos + 1 + 15) & ~15;
+    memset(img + pos, 0, padded - pos);
+    img[padded - 1] = checksum;
+    pos = padded;
+    if (hdr->hash_appended) {
+        mbedtls_sha256(img, pos, img + pos, 0);
+        pos += ESP_IMAGE_HASH_LEN;
+    }
+    return pos;
+}
+
+/* Verify len bytes of img, passed all at once (mode 0), in chunks of up to 64 bytes (1) or of up to 8 kB (2) */
+static esp_err_t stream_verify(const uint8_t *img, size_t len, esp_image_metadata_t *md, int mode)
+{
+    const esp_partition_pos_t part = { .offset = PART_OFFSET, .size = PART_SIZE };
+    esp_image_stream_verify_handle_t handle;
+    esp_err_t err = esp_image_stream_verify_begin(&part, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    for (size_t pos = 0; pos < len;) {
+        size_t n = mode == 0 ? len : mode == 1 ? 1 + rand32() % 64 : 1 + rand32() % 8192;
+        n = n < len - pos ? n : len - pos;
+        esp_image_stream_verify_feed(handle, img + pos, n);
+        pos += n;
+    }
+    return esp_image_stream_verify_finish(handle, md);
+}
+
+static void test_seed(int seed, uint8_t *img)
+{
+    srandom(seed);
+    size_t len = build_image(img);
+    size_t written = len;
+    int mutation = rand32() % 3;
+    if (mutation == 1) {
+        size_t at = rand32() % len;
+        /* The page size is a shift count, values past the width of the type are not checked by either verifier */
+        if (at == sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + offsetof(esp_app_desc_t, mmu_page_size)) {
+            at++;
+        }
+        img[at] ^= 1 << (rand32() % 8);
+    } else if (mutation == 2) {
+        /* Keep the app descriptor, for the same reason */
+        size_t keep = len > 300 ? 300 : 0;
+        written = keep + rand32() % (len - keep);
+    }
+    s_dbgr_attached = rand32() % 10 == 0;
+
+    memset(s_flash, 0xff, FLASH_SIZE);
+    memcpy(s_flash + PART_OFFSET, img, written);
+    const esp_partition_pos_t part = { .offset = PART_OFFSET, .size = PART_SIZE };
+    esp_image_metadata_t flash_md;
+    esp_image_metadata_t stream_md;
+    esp_err_t flash_err = esp_image_verify(ESP_IMAGE_VERIFY, &part, &flash_md);
+    bool flash_read_erased = flash_err == ESP_OK && flash_md.image_len > written;
+    /* Data written after the image must be ignored */
+    if (mutation != 2 && rand32() % 2) {
+        memset(img + len, 0x5a, 100);
+        written += rand32() % 100;
+    }
+    esp_err_t stream_err = stream_verify(img, written, &stream_md, seed % 3);
+
+    if (flash_read_erased) {
+        /* esp_image_verify() accepted the erased flash after the written data as the end of the image, which
+         * happens when a debugger is attached, as the checksum and hash are skipped, or when the missing bytes
+         * are all 0xFF. The stream verification has no data there and must reject the incomplete image. */
+        if (stream_err == ESP_OK) {
+            printf("FAIL seed %d: incomplete image accepted\n", seed);
+            s_failures++;
+        }
+        return;
+    }
+    if ((flash_err == ESP_OK) != (stream_err == ESP_OK)
+            || (flash_err == ESP_OK && memcmp(&flash_md, &stream_md, sizeof(flash_md)) != 0)) {
+        printf("FAIL seed %d: mutation %d, debugger %d, hash %d: esp_image_verify 0x%x, stream 0x%x\n", seed,
+               mutation, s_dbgr_attached, ((esp_image_header_t *)img)->hash_appended, flash_err, stream_err);
+        s_failures++;
+    }
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* Time per verification of a valid image of at least 100 kB, read back from flash or passed in chunks */
+static void benchmark(uint8_t *img)
+{
+    size_t len;
+    srandom(1);
+    do {
+        len = build_image(img);
+    } while (len < 100000 || !((esp_image_header_t *)img)->hash_appended);
+    memset(s_flash, 0xff, FLASH_SIZE);
+    memcpy(s_flash + PART_OFFSET, img, len);
+    s_dbgr_attached = false;
+    const esp_partition_pos_t part = { .offset = PART_OFFSET, .size = PART_SIZE };
+    esp_image_metadata_t md;
+
+    double start = now_us();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) {
+        if (esp_image_verify(ESP_IMAGE_VERIFY, &part, &md) != ESP_OK) {
+            abort();
+        }
+    }
+    double verify_us = (now_us() - start) / BENCHMARK_RUNS;
+
+    start = now_us();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) {
+        esp_image_stream_verify_handle_t handle;
+        if (esp_image_stream_verify_begin(&part, &handle) != ESP_OK) {
+            abort();
+        }
+        for (size_t pos = 0; pos < len; pos += BENCHMARK_CHUNK) {
+            esp_image_stream_verify_feed(handle, img + pos, len - pos < BENCHMARK_CHUNK ? len - pos : BENCHMARK_CHUNK);
+        }
+        if (esp_image_stream_verify_finish(handle, &md) != ESP_OK) {
+            abort();
+        }
+    }
+    double stream_us = (now_us() - start) / BENCHMARK_RUNS;
+    printf("Image of %zu bytes: esp_image_verify %.1f us, stream verification %.1f us\n", len, verify_us, stream_us);
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t img[PART_SIZE];
+    s_flash = malloc(FLASH_SIZE);
+    if (s_flash == NULL) {
+        return 1;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "benchmark") == 0) {
+        benchmark(img);
+        free(s_flash);
+        return 0;
+    }
+
+    printf("Testing the stream verification of %d random images\n", TEST_SEEDS);
+    for (int seed = 0; seed < TEST_SEEDS; seed++) {
+        test_seed(seed, img);
+    }
+    free(s_flash);
+
+    if (s_failures) {
+        printf("%d failures\n", s_failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
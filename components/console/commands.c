@@ -37,6 +37,8 @@ typedef struct cmd_item_ {
     void *argtable;                                     //!< optional pointer to arg table
     void *context;                                      //!< optional pointer to user context
     SLIST_ENTRY(cmd_item_) next;                        //!< next command in the list
+    struct cmd_item_ *index_next;                       //!< next command in the same bucket of s_cmd_index
+    uint32_t hash;                                      //!< hash of the command name
 } cmd_item_t;
 
 typedef void (*const fn_print_arg_t)(cmd_item_t*);
@@ -44,6 +46,18 @@ typedef void (*const fn_print_arg_t)(cmd_item_t*);
 /** linked list of command structures */
 static SLIST_HEAD(cmd_list_, cmd_item_) s_cmd_list;
 
+/** number of commands in s_cmd_list */
+static size_t s_cmd_count;
+
+/** hash table of the commands in s_cmd_list, by name. The number of buckets is a power of 2. */
+static cmd_item_t **s_cmd_index;
+static size_t s_cmd_index_size;
+
+#define CMD_INDEX_MIN_SIZE      16
+
+/** commands in s_cmd_list sorted by name, for completion. Built on first use after the list changes. */
+static const cmd_item_t **s_cmd_sorted;
+
 /** run-time configuration options */
 static esp_console_config_t s_config = {
     .heap_alloc_caps = MALLOC_CAP_DEFAULT
@@ -52,6 +66,12 @@ static esp_console_config_t s_config = {
 /** temporary buffer used for command line parsing */
 static char *s_tmp_line_buf;
 
+/** argv array of the command being run, max_cmdline_args entries */
+static char **s_argv;
+
+/** number of commands being run; commands run from another command's handler need their own argv */
+static int s_run_depth;
+
 static const cmd_item_t *find_command_by_name(const char *name);
 
 static esp_console_help_verbose_level_e s_verbose_level = ESP_CONSOLE_HELP_VERBOSE_LEVEL_1;
@@ -75,6 +95,14 @@ esp_err_t esp_console_init(const esp_console_config_t *config)
     if (s_tmp_line_buf == NULL) {
         return ESP_ERR_NO_MEM;
     }
+    if (s_config.max_cmdline_args > 0) {
+        s_argv = heap_caps_calloc(s_config.max_cmdline_args, sizeof(char *), s_config.heap_alloc_caps);
+        if (s_argv == NULL) {
+            free(s_tmp_line_buf);
+            s_tmp_line_buf = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+    }
     return ESP_OK;
 }
 
@@ -85,15 +113,67 @@ esp_err_t esp_console_deinit(void)
     }
     free(s_tmp_line_buf);
     s_tmp_line_buf = NULL;
+    free(s_argv);
+    s_argv = NULL;
     cmd_item_t *it, *tmp;
     SLIST_FOREACH_SAFE(it, &s_cmd_list, next, tmp) {
         SLIST_REMOVE(&s_cmd_list, it, cmd_item_, next);
         free(it->hint);
         free(it);
     }
+    s_cmd_count = 0;
+    free(s_cmd_index);
+    s_cmd_index = NULL;
+    s_cmd_index_size = 0;
+    free(s_cmd_sorted);
+    s_cmd_sorted = NULL;
     return ESP_OK;
 }
 
+/* FNV-1a */
+static uint32_t cmd_name_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;
+    while (*name) {
+        hash = (hash ^ (unsigned char) * name++) * 16777619U;
+    }
+    return hash;
+}
+
+/* Rebuild the name index with the given number of buckets, from s_cmd_list */
+static esp_err_t cmd_index_resize(size_t size)
+{
+    cmd_item_t **index = heap_caps_calloc(size, sizeof(cmd_item_t *), s_config.heap_alloc_caps);
+    if (index == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    cmd_item_t *it;
+    SLIST_FOREACH(it, &s_cmd_list, next) {
+        cmd_item_t **bucket = &index[it->hash & (size - 1)];
+        it->index_next = *bucket;
+        *bucket = it;
+    }
+    free(s_cmd_index);
+    s_cmd_index = index;
+    s_cmd_index_size = size;
+    return ESP_OK;
+}
+
+static void cmd_index_remove(cmd_item_t *item)
+{
+    cmd_item_t **it = &s_cmd_index[item->hash & (s_cmd_index_size - 1)];
+    while (*it != item) {
+        it = &(*it)->index_next;
+    }
+    *it = item->index_next;
+}
+
+static void cmd_sorted_invalidate(void)
+{
+    free(s_cmd_sorted);
+    s_cmd_sorted = NULL;
+}
+
 void esp_console_rm_item_free_hint(cmd_item_t *item)
 {
     SLIST_REMOVE(&s_cmd_list, item, cmd_item_, next);
@@ -106,7 +186,10 @@ esp_err_t esp_console_cmd_deregister(const char *cmd_name)
     if (item == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
+    cmd_index_remove(item);
     esp_console_rm_item_free_hint(item);
+    s_cmd_count--;
+    cmd_sorted_invalidate();
     heap_caps_free(item);
     return ESP_OK;
 }
@@ -126,11 +209,23 @@ esp_err_t esp_console_cmd_register(const esp_console_cmd_t *cmd)
     }
     item = (cmd_item_t *)find_command_by_name(cmd->command);
     if (!item) {
-        // not registered before
+        // not registered before, make room in the index first
+        if (s_cmd_count >= s_cmd_index_size) {
+            esp_err_t err = cmd_index_resize(MAX(CMD_INDEX_MIN_SIZE, 2 * s_cmd_index_size));
+            if (err != ESP_OK && s_cmd_index == NULL) {
+                return err;
+            }
+            // if growing failed, the old index can still be used with longer chains
+        }
         item = heap_caps_calloc(1, sizeof(*item), s_config.heap_alloc_caps);
         if (item == NULL) {
             return ESP_ERR_NO_MEM;
         }
+        item->hash = cmd_name_hash(cmd->command);
+        cmd_item_t **bucket = &s_cmd_index[item->hash & (s_cmd_index_size - 1)];
+        item->index_next = *bucket;
+        *bucket = item;
+        s_cmd_count++;
     } else {
         // remove from list and free the old hint, because we will alloc new hint for the command
         esp_console_rm_item_free_hint(item);
@@ -183,52 +278,110 @@ esp_err_t esp_console_cmd_register(const esp_console_cmd_t *cmd)
 #endif
         SLIST_INSERT_AFTER(last, item, next);
     }
+    cmd_sorted_invalidate();
     return ESP_OK;
 }
 
+static int cmd_sorted_compare(const void *a, const void *b)
+{
+    return strcmp((*(const cmd_item_t **)a)->command, (*(const cmd_item_t **)b)->command);
+}
+
 void esp_console_get_completion(const char *buf, linenoiseCompletions *lc)
 {
     size_t len = strlen(buf);
-    if (len == 0) {
+    if (len == 0 || s_cmd_count == 0) {
         return;
     }
-    cmd_item_t *it;
-    SLIST_FOREACH(it, &s_cmd_list, next) {
-        /* Check if command starts with buf */
-        if (strncmp(buf, it->command, len) == 0) {
-            linenoiseAddCompletion(lc, it->command);
+    if (s_cmd_sorted == NULL) {
+        s_cmd_sorted = heap_caps_malloc(s_cmd_count * sizeof(cmd_item_t *), s_config.heap_alloc_caps);
+        if (s_cmd_sorted == NULL) {
+            return;
+        }
+        size_t i = 0;
+        cmd_item_t *it;
+        SLIST_FOREACH(it, &s_cmd_list, next) {
+            s_cmd_sorted[i++] = it;
+        }
+        qsort(s_cmd_sorted, s_cmd_count, sizeof(cmd_item_t *), cmd_sorted_compare);
+    }
+    /* Find the first command not sorted before buf, the commands starting with buf follow it */
+    size_t lo = 0;
+    size_t hi = s_cmd_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcmp(s_cmd_sorted[mid]->command, buf) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+    for (size_t i = lo; i < s_cmd_count && strncmp(buf, s_cmd_sorted[i]->command, len) == 0; i++) {
+        linenoiseAddCompletion(lc, s_cmd_sorted[i]->command);
+    }
 }
 
 const char *esp_console_get_hint(const char *buf, int *color, int *bold)
 {
-    size_t len = strlen(buf);
-    cmd_item_t *it;
-    SLIST_FOREACH(it, &s_cmd_list, next) {
-        if (strlen(it->command) == len &&
-                strncmp(buf, it->command, len) == 0) {
-            *color = s_config.hint_color;
-            *bold = s_config.hint_bold;
-            return it->hint;
-        }
+    const cmd_item_t *it = find_command_by_name(buf);
+    if (it == NULL) {
+        return NULL;
     }
-    return NULL;
+    *color = s_config.hint_color;
+    *bold = s_config.hint_bold;
+    return it->hint;
 }
 
 static const cmd_item_t *find_command_by_name(const char *name)
 {
-    const cmd_item_t *cmd = NULL;
-    cmd_item_t *it;
-    size_t len = strlen(name);
-    SLIST_FOREACH(it, &s_cmd_list, next) {
-        if (strlen(it->command) == len &&
-                strcmp(name, it->command) == 0) {
-            cmd = it;
+    if (s_cmd_index == NULL) {
+        return NULL;
+    }
+    uint32_t hash = cmd_name_hash(name);
+    const cmd_item_t *it;
+    for (it = s_cmd_index[hash & (s_cmd_index_size - 1)]; it != NULL; it = it->index_next) {
+        if (it->hash == hash && strcmp(name, it->command) == 0) {
             break;
         }
     }
-    return cmd;
+    return it;
+}
+
+/* Split the line in place and run the command. The caller checks that the console is initialized. */
+static esp_err_t run_line(char *line, int *cmd_ret)
+{
+    if (s_config.max_cmdline_args == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    char **argv = s_argv;
+    if (s_run_depth > 0) {
+        // run from a command handler, s_argv is in use
+        argv = (char **) heap_caps_calloc(s_config.max_cmdline_args, sizeof(char *), s_config.heap_alloc_caps);
+        if (argv == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    esp_err_t ret = ESP_OK;
+    size_t argc = esp_console_split_argv(line, argv, s_config.max_cmdline_args);
+    const cmd_item_t *cmd = (argc == 0) ? NULL : find_command_by_name(argv[0]);
+    if (argc == 0) {
+        ret = ESP_ERR_INVALID_ARG;
+    } else if (cmd == NULL) {
+        ret = ESP_ERR_NOT_FOUND;
+    } else {
+        s_run_depth++;
+        if (cmd->func) {
+            *cmd_ret = (*cmd->func)(argc, argv);
+        }
+        if (cmd->func_w_context) {
+            *cmd_ret = (*cmd->func_w_context)(cmd->context, argc, argv);
+        }
+        s_run_depth--;
+    }
+    if (argv != s_argv) {
+        free(argv);
+    }
+    return ret;
 }
 
 esp_err_t esp_console_run(const char *cmdline, int *cmd_ret)
@@ -236,31 +389,66 @@ esp_err_t esp_console_run(const char *cmdline, int *cmd_ret)
     if (s_tmp_line_buf == NULL) {
         return ESP_ERR_INVALID_STATE;
     }
-    char **argv = (char **) heap_caps_calloc(s_config.max_cmdline_args, sizeof(char *), s_config.heap_alloc_caps);
-    if (argv == NULL) {
-        return ESP_ERR_NO_MEM;
-    }
     strlcpy(s_tmp_line_buf, cmdline, s_config.max_cmdline_length);
+    return run_line(s_tmp_line_buf, cmd_ret);
+}
 
-    size_t argc = esp_console_split_argv(s_tmp_line_buf, argv,
-                                         s_config.max_cmdline_args);
-    if (argc == 0) {
-        free(argv);
-        return ESP_ERR_INVALID_ARG;
+esp_err_t esp_console_run_in_place(char *cmdline, int *cmd_ret)
+{
+    if (s_tmp_line_buf == NULL) {
+        return ESP_ERR_INVALID_STATE;
     }
-    const cmd_item_t *cmd = find_command_by_name(argv[0]);
-    if (cmd == NULL) {
-        free(argv);
-        return ESP_ERR_NOT_FOUND;
+    return run_line(cmdline, cmd_ret);
+}
+
+esp_err_t esp_console_run_script(const char *script, int *cmd_ret, size_t *line_num)
+{
+    if (s_tmp_line_buf == NULL) {
+        return ESP_ERR_INVALID_STATE;
     }
-    if (cmd->func) {
-        *cmd_ret = (*cmd->func)(argc, argv);
+    if (script == NULL || cmd_ret == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = ESP_OK;
+    size_t num = 0;
+    *cmd_ret = 0;
+    while (*script != '\0') {
+        const char *end = strchr(script, '\n');
+        size_t len = (end != NULL) ? (size_t)(end - script) : strlen(script);
+        const char *next = (end != NULL) ? end + 1 : script + len;
+        if (len > 0 && script[len - 1] == '\r') {
+            len--;
+        }
+        num++;
+        if (len >= s_config.max_cmdline_length) {
+            ret = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+        memcpy(s_tmp_line_buf, script, len);
+        s_tmp_line_buf[len] = '\0';
+        script = next;
+
+        const char *first = s_tmp_line_buf + strspn(s_tmp_line_buf, " ");
+        if (*first == '#') {
+            continue;
+        }
+        ret = run_line(s_tmp_line_buf, cmd_ret);
+        if (ret == ESP_ERR_INVALID_ARG) {
+            // empty line
+            ret = ESP_OK;
+            continue;
+        }
+        if (ret == ESP_OK && *cmd_ret != 0) {
+            ret = ESP_FAIL;
+        }
+        if (ret != ESP_OK) {
+            break;
+        }
     }
-    if (cmd->func_w_context) {
-        *cmd_ret = (*cmd->func_w_context)(cmd->context, argc, argv);
+    if (line_num) {
+        *line_num = num;
     }
-    free(argv);
-    return ESP_OK;
+    return ret;
 }
 
 static struct {
@@ -338,21 +526,12 @@ static int help_command(int argc, char **argv)
         ret_value = 0;
     } else {
         /* Print summary of given command, verbose option will be ignored */
-        bool found_command = false;
-        SLIST_FOREACH(it, &s_cmd_list, next) {
-            if (it->help == NULL) {
-                continue;
-            }
-            if (strcmp(help_args.help_cmd->sval[0], it->command) == 0) {
-                print_arg_help(it);
-                found_command = true;
-                ret_value = 0;
-                break;
-            }
-        }
-
-        /* If given command has not been found, print error message*/
-        if (!found_command) {
+        it = (cmd_item_t *)find_command_by_name(help_args.help_cmd->sval[0]);
+        if (it != NULL && it->help != NULL) {
+            print_arg_help(it);
+            ret_value = 0;
+        } else {
+            /* If given command has not been found, print error message*/
             printf("help: Unrecognized option '%s'. Please use correct command as argument "
                    "or type 'help' only to print help for all commands\n", help_args.help_cmd->sval[0]);
         }
@@ -259,6 +259,48 @@ esp_err_t esp_console_cmd_deregister(const char *cmd_name);
  */
 esp_err_t esp_console_run(const char *cmdline, int *cmd_ret);
 
+/**
+ * @brief Run command line, splitting it into arguments in place
+ *
+ * Same as esp_console_run, but cmdline is split into arguments in the buffer
+ * given by the caller instead of a copy, so it is modified. Use it when the
+ * caller owns the line buffer anyway, e.g. the line returned by linenoise.
+ * The length of the line is not limited by max_cmdline_length.
+ *
+ * @param cmdline command line (command name followed by a number of arguments), modified in place
+ * @param[out] cmd_ret return code from the command (set if command was run)
+ * @return
+ *      - ESP_OK, if command was run
+ *      - ESP_ERR_INVALID_ARG, if the command line is empty, or only contained
+ *        whitespace
+ *      - ESP_ERR_NOT_FOUND, if command with given name wasn't registered
+ *      - ESP_ERR_INVALID_STATE, if esp_console_init wasn't called
+ */
+esp_err_t esp_console_run_in_place(char *cmdline, int *cmd_ret);
+
+/**
+ * @brief Run a sequence of command lines
+ *
+ * Runs the lines of the script one after another, as esp_console_run does,
+ * without going through linenoise or the REPL. Lines are separated by '\n'
+ * ("\r\n" is accepted as well). Empty lines and lines starting with '#' are
+ * skipped. Execution stops at the first line which can not be run, or whose
+ * command returns non-zero.
+ *
+ * @param script zero-terminated command lines
+ * @param[out] cmd_ret return code from the last command which was run, 0 if no command was run
+ * @param[out] line_num number of the last line processed, counting from 1
+ *                      (e.g. the line which failed), may be NULL
+ * @return
+ *      - ESP_OK, if all the lines were run and their commands returned 0
+ *      - ESP_FAIL, if a command returned non-zero, see cmd_ret
+ *      - ESP_ERR_NOT_FOUND, if command with given name wasn't registered
+ *      - ESP_ERR_INVALID_SIZE, if a line is longer than max_cmdline_length - 1
+ *      - ESP_ERR_INVALID_ARG, if script or cmd_ret is NULL
+ *      - ESP_ERR_INVALID_STATE, if esp_console_init wasn't called
+ */
+esp_err_t esp_console_run_script(const char *script, int *cmd_ret, size_t *line_num);
+
 /**
  * @brief Split command line into arguments in place
  * @verbatim
@@ -293,6 +335,8 @@ size_t esp_console_split_argv(char *line, char **argv, size_t argv_size);
  *
  *   linenoiseSetCompletionCallback(&esp_console_get_completion);
  *
+ * The commands starting with buf are offered in alphabetical order.
+ *
  * @param buf the string typed by the user
  * @param lc linenoiseCompletions to be filled in
  */
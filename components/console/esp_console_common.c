@@ -216,9 +216,9 @@ void esp_console_repl_task(void *args)
             linenoiseHistorySave(repl_com->history_save_path);
         }
 
-        /* Try to run the command */
+        /* Try to run the command. The line is ours, so split it in place. */
         int ret;
-        esp_err_t err = esp_console_run(line, &ret);
+        esp_err_t err = esp_console_run_in_place(line, &ret);
         if (err == ESP_ERR_NOT_FOUND) {
             printf("Unrecognized command\n");
         } else if (err == ESP_ERR_INVALID_ARG) {
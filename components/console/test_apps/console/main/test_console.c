@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 #include "sdkconfig.h"
 #include "unity.h"
 #include "esp_console.h"
@@ -404,3 +406,127 @@ TEST_CASE("esp console re-register commands", "[console][ignore]")
     TEST_ESP_OK(esp_console_start_repl(s_repl));
     vTaskDelay(pdMS_TO_TICKS(5000));
 }
+
+static int do_count_cmd(void *context, int argc, char **argv)
+{
+    int *count = (int *)context;
+    (*count)++;
+    return (argc > 1 && strcmp(argv[1], "fail") == 0) ? 1 : 0;
+}
+
+#define TEST_NUM_COMMANDS 64
+
+static char s_test_cmd_names[TEST_NUM_COMMANDS][16];
+
+static void register_test_commands(int *count)
+{
+    for (int i = 0; i < TEST_NUM_COMMANDS; i++) {
+        snprintf(s_test_cmd_names[i], sizeof(s_test_cmd_names[i]), "cmd%02d", i);
+        const esp_console_cmd_t cmd = {
+            .command = s_test_cmd_names[i],
+            .help = "Count calls",
+            .func_w_context = do_count_cmd,
+            .context = count,
+        };
+        TEST_ESP_OK(esp_console_cmd_register(&cmd));
+    }
+}
+
+static void free_completions(linenoiseCompletions *lc)
+{
+    for (size_t i = 0; i < lc->len; i++) {
+        free(lc->cvec[i]);
+    }
+    free(lc->cvec);
+    *lc = (linenoiseCompletions) { 0 };
+}
+
+TEST_CASE("esp console lookup and completion with many commands", "[console]")
+{
+    esp_console_config_t console_config = ESP_CONSOLE_CONFIG_DEFAULT();
+    TEST_ESP_OK(esp_console_init(&console_config));
+    int count = 0;
+    register_test_commands(&count);
+
+    int ret;
+    for (int i = 0; i < TEST_NUM_COMMANDS; i++) {
+        TEST_ESP_OK(esp_console_run(s_test_cmd_names[i], &ret));
+    }
+    TEST_ASSERT_EQUAL(TEST_NUM_COMMANDS, count);
+    TEST_ESP_ERR(ESP_ERR_NOT_FOUND, esp_console_run("cmd", &ret));
+
+    linenoiseCompletions lc = { 0 };
+    esp_console_get_completion("cmd1", &lc);
+    TEST_ASSERT_EQUAL(10, lc.len);
+    for (size_t i = 0; i < lc.len; i++) {
+        TEST_ASSERT_EQUAL_STRING(s_test_cmd_names[10 + i], lc.cvec[i]);
+    }
+
+    /* Deregistered commands are neither found nor completed */
+    TEST_ESP_OK(esp_console_cmd_deregister("cmd10"));
+    TEST_ESP_ERR(ESP_ERR_NOT_FOUND, esp_console_run("cmd10", &ret));
+    free_completions(&lc);
+    esp_console_get_completion("cmd1", &lc);
+    TEST_ASSERT_EQUAL(9, lc.len);
+    TEST_ASSERT_EQUAL_STRING("cmd11", lc.cvec[0]);
+    free_completions(&lc);
+
+    TEST_ESP_OK(esp_console_deinit());
+}
+
+TEST_CASE("esp console run in place and run script", "[console]")
+{
+    esp_console_config_t console_config = ESP_CONSOLE_CONFIG_DEFAULT();
+    TEST_ESP_OK(esp_console_init(&console_config));
+    int count = 0;
+    register_test_commands(&count);
+
+    int ret;
+    char line[] = "cmd01 \"a b\" c";
+    TEST_ESP_OK(esp_console_run_in_place(line, &ret));
+    TEST_ASSERT_EQUAL(1, count);
+
+    size_t line_num;
+    count = 0;
+    TEST_ESP_OK(esp_console_run_script("cmd01\r\n\n# comment\n  cmd02 a\ncmd03", &ret, &line_num));
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(5, line_num);
+    TEST_ASSERT_EQUAL(0, ret);
+
+    count = 0;
+    TEST_ESP_ERR(ESP_FAIL, esp_console_run_script("cmd01\ncmd02 fail\ncmd03\n", &ret, &line_num));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(2, line_num);
+    TEST_ASSERT_EQUAL(1, ret);
+
+    TEST_ESP_ERR(ESP_ERR_NOT_FOUND, esp_console_run_script("cmd01\nnot_a_command\n", &ret, &line_num));
+    TEST_ASSERT_EQUAL(2, line_num);
+
+    TEST_ESP_OK(esp_console_deinit());
+}
+
+TEST_CASE("esp console command dispatch throughput", "[console]")
+{
+    esp_console_config_t console_config = ESP_CONSOLE_CONFIG_DEFAULT();
+    TEST_ESP_OK(esp_console_init(&console_config));
+    int count = 0;
+    register_test_commands(&count);
+
+    const int iterations = 10000;
+    char line[32];
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < iterations; i++) {
+        int ret;
+        snprintf(line, sizeof(line), "cmd%02d --arg \"x y\"", i % TEST_NUM_COMMANDS);
+        TEST_ESP_OK(esp_console_run(line, &ret));
+    }
+    gettimeofday(&end, NULL);
+    TEST_ASSERT_EQUAL(iterations, count);
+
+    int64_t elapsed_us = (end.tv_sec - start.tv_sec) * 1000000LL + (end.tv_usec - start.tv_usec);
+    printf("%d commands registered, %d lines run in %lld us (%lld lines/s)\n", TEST_NUM_COMMANDS, iterations,
+           (long long)elapsed_us, (long long)(iterations * 1000000LL / (elapsed_us ? elapsed_us : 1)));
+
+    TEST_ESP_OK(esp_console_deinit());
+}
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Host benchmark of commands.c: time per command line with many registered commands, run with
+ * esp_console_run, esp_console_run_in_place and esp_console_run_script, and time per completion.
+ * Use the throughput test in test_apps/console to measure on a chip. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_console.h"
+#include "linenoise/linenoise.h"
+
+#define NUM_COMMANDS    200
+#define LINE_LEN        48
+#define ITERATIONS      2000000
+
+static char s_names[NUM_COMMANDS][16];
+static char s_lines[NUM_COMMANDS][LINE_LEN];
+
+static int nop_cmd(int argc, char **argv)
+{
+    return 0;
+}
+
+static void free_completions(linenoiseCompletions *lc)
+{
+    for (size_t i = 0; i < lc->len; i++) {
+        free(lc->cvec[i]);
+    }
+    free(lc->cvec);
+    *lc = (linenoiseCompletions) { 0 };
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    esp_console_config_t config = ESP_CONSOLE_CONFIG_DEFAULT();
+    if (esp_console_init(&config) != ESP_OK) {
+        return 1;
+    }
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        snprintf(s_names[i], sizeof(s_names[i]), "cmd%03d", (i * 37) % NUM_COMMANDS);
+        const esp_console_cmd_t cmd = { .command = s_names[i], .help = "Do nothing", .func = nop_cmd };
+        if (esp_console_cmd_register(&cmd) != ESP_OK) {
+            return 1;
+        }
+        snprintf(s_lines[i], LINE_LEN, "cmd%03d --flag value \"quoted arg\"", i);
+    }
+    int ret;
+
+    double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        esp_console_run(s_lines[i % NUM_COMMANDS], &ret);
+    }
+    printf("%d commands, esp_console_run: %.0f ns/line\n", NUM_COMMANDS, (now_ns() - start) / ITERATIONS);
+
+    /* Includes the copy of the line, which is split in place */
+    char buf[LINE_LEN];
+    start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        memcpy(buf, s_lines[i % NUM_COMMANDS], LINE_LEN);
+        esp_console_run_in_place(buf, &ret);
+    }
+    printf("esp_console_run_in_place: %.0f ns/line\n", (now_ns() - start) / ITERATIONS);
+
+    const size_t script_size = NUM_COMMANDS * (LINE_LEN + 1);
+    size_t script_len = 0;
+    char *script = malloc(script_size);
+    if (script == NULL) {
+        return 1;
+    }
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        script_len += snprintf(script + script_len, script_size - script_len, "%s\n", s_lines[i]);
+    }
+    start = now_ns();
+    for (int i = 0; i < ITERATIONS / NUM_COMMANDS; i++) {
+        esp_console_run_script(script, &ret, NULL);
+    }
+    printf("esp_console_run_script: %.0f ns/line\n", (now_ns() - start) / ITERATIONS);
+    free(script);
+
+    linenoiseCompletions lc = { 0 };
+    start = now_ns();
+    for (int i = 0; i < ITERATIONS / 10; i++) {
+        esp_console_get_completion("cmd19", &lc);
+        free_completions(&lc);
+    }
+    printf("completion of \"cmd19\": %.0f ns\n", (now_ns() - start) / (ITERATIONS / 10));
+
+    esp_console_deinit();
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Host test of the command registry and dispatch of commands.c, with enough commands to grow the hashed
+ * index: lookup, completion and hints, deregistration, in-place and nested runs, and scripts */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_console.h"
+#include "linenoise/linenoise.h"
+
+#define TEST_NUM_COMMANDS   200
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __func__, __LINE__, #cond); \
+            s_failures++; \
+        } \
+    } while (0)
+
+static int s_failures;
+static int s_calls;
+static char s_names[TEST_NUM_COMMANDS][16];
+
+static int count_cmd(int argc, char **argv)
+{
+    s_calls++;
+    return (argc > 1 && strcmp(argv[1], "fail") == 0) ? 5 : 0;
+}
+
+/* Run a command from the handler of another one, each must keep its own arguments */
+static int nested_cmd(int argc, char **argv)
+{
+    int ret;
+    char line[] = "cmd001 x";
+    CHECK(esp_console_run_in_place(line, &ret) == ESP_OK);
+    CHECK(argc == 2 && strcmp(argv[0], "nested") == 0 && strcmp(argv[1], "a") == 0);
+    return 0;
+}
+
+static void free_completions(linenoiseCompletions *lc)
+{
+    for (size_t i = 0; i < lc->len; i++) {
+        free(lc->cvec[i]);
+    }
+    free(lc->cvec);
+    *lc = (linenoiseCompletions) { 0 };
+}
+
+static size_t count_completions(const char *buf)
+{
+    linenoiseCompletions lc = { 0 };
+    esp_console_get_completion(buf, &lc);
+    size_t len = lc.len;
+    free_completions(&lc);
+    return len;
+}
+
+/* Commands are registered out of order, as cmd000 to cmd199 */
+static void register_commands(void)
+{
+    for (int i = 0; i < TEST_NUM_COMMANDS; i++) {
+        snprintf(s_names[i], sizeof(s_names[i]), "cmd%03d", (i * 37) % TEST_NUM_COMMANDS);
+        const esp_console_cmd_t cmd = { .command = s_names[i], .help = "Count calls", .hint = "<a>", .func = count_cmd };
+        CHECK(esp_console_cmd_register(&cmd) == ESP_OK);
+    }
+}
+
+static void test_lookup(void)
+{
+    int ret;
+    for (int i = 0; i < TEST_NUM_COMMANDS; i++) {
+        char line[32];
+        snprintf(line, sizeof(line), "cmd%03d a b", i);
+        ret = -1;
+        CHECK(esp_console_run(line, &ret) == ESP_OK && ret == 0);
+    }
+    CHECK(esp_console_run("nope", &ret) == ESP_ERR_NOT_FOUND);
+    CHECK(esp_console_run("cmd00", &ret) == ESP_ERR_NOT_FOUND);
+    CHECK(esp_console_run("   ", &ret) == ESP_ERR_INVALID_ARG);
+}
+
+static void test_completion_and_hint(void)
+{
+    linenoiseCompletions lc = { 0 };
+    esp_console_get_completion("cmd1", &lc);
+    CHECK(lc.len == 100);
+    for (size_t i = 1; i < lc.len; i++) {
+        CHECK(strcmp(lc.cvec[i - 1], lc.cvec[i]) < 0);
+    }
+    free_completions(&lc);
+    CHECK(count_completions("cmd19") == 10);
+    CHECK(count_completions("zz") == 0);
+    esp_console_get_completion("h", &lc);
+    CHECK(lc.len == 1 && strcmp(lc.cvec[0], "help") == 0);
+    free_completions(&lc);
+
+    int color;
+    int bold;
+    const char *hint = esp_console_get_hint("cmd005", &color, &bold);
+    CHECK(hint != NULL && strcmp(hint, " <a>") == 0);
+    CHECK(esp_console_get_hint("cmd00", &color, &bold) == NULL);
+}
+
+static void test_deregister(void)
+{
+    int ret;
+    for (int i = 0; i < TEST_NUM_COMMANDS; i += 2) {
+        CHECK(esp_console_cmd_deregister(s_names[i]) == ESP_OK);
+    }
+    CHECK(esp_console_cmd_deregister(s_names[0]) == ESP_ERR_INVALID_ARG);
+    CHECK(count_completions("cmd") == TEST_NUM_COMMANDS / 2);
+    for (int i = 0; i < TEST_NUM_COMMANDS; i++) {
+        CHECK((esp_console_run(s_names[i], &ret) == ESP_OK) == (i % 2 == 1));
+    }
+    /* Registering a command twice replaces it */
+    for (int i = 0; i < TEST_NUM_COMMANDS; i += 2) {
+        const esp_console_cmd_t cmd = { .command = s_names[i], .help = "Count calls", .func = count_cmd };
+        CHECK(esp_console_cmd_register(&cmd) == ESP_OK);
+        CHECK(esp_console_cmd_register(&cmd) == ESP_OK);
+    }
+    CHECK(count_completions("cmd") == TEST_NUM_COMMANDS);
+}
+
+static void test_run_in_place(void)
+{
+    int ret;
+    char line[] = "cmd010   \"q r\"";
+    s_calls = 0;
+    CHECK(esp_console_run_in_place(line, &ret) == ESP_OK && ret == 0 && s_calls == 1);
+
+    const esp_console_cmd_t nested = { .command = "nested", .func = nested_cmd };
+    CHECK(esp_console_cmd_register(&nested) == ESP_OK);
+    CHECK(esp_console_run("nested a", &ret) == ESP_OK && ret == 0);
+
+    /* The length of a line run in place is not limited by max_cmdline_length */
+    char *long_line = malloc(600);
+    memset(long_line, 'a', 599);
+    long_line[599] = '\0';
+    memcpy(long_line, "cmd001 ", 7);
+    CHECK(esp_console_run_script(long_line, &ret, NULL) == ESP_ERR_INVALID_SIZE);
+    CHECK(esp_console_run_in_place(long_line, &ret) == ESP_OK);
+    free(long_line);
+}
+
+static void test_run_script(void)
+{
+    int ret;
+    size_t line_num;
+    s_calls = 0;
+    CHECK(esp_console_run_script("cmd001\r\n\n  # comment\ncmd002 a\n   \ncmd003", &ret, &line_num) == ESP_OK);
+    CHECK(line_num == 6 && ret == 0 && s_calls == 3);
+    CHECK(esp_console_run_script("cmd001\ncmd002 fail\ncmd003\n", &ret, &line_num) == ESP_FAIL);
+    CHECK(line_num == 2 && ret == 5);
+    CHECK(esp_console_run_script("cmd001\nbad\ncmd003\n", &ret, &line_num) == ESP_ERR_NOT_FOUND && line_num == 2);
+    CHECK(esp_console_run_script("", &ret, &line_num) == ESP_OK && line_num == 0 && ret == 0);
+}
+
+int main(void)
+{
+    esp_console_config_t config = ESP_CONSOLE_CONFIG_DEFAULT();
+    if (esp_console_init(&config) != ESP_OK || esp_console_register_help_command() != ESP_OK) {
+        printf("FAIL: console initialization\n");
+        return 1;
+    }
+    register_commands();
+
+    test_lookup();
+    test_completion_and_hint();
+    test_deregister();
+    test_run_in_place();
+    test_run_script();
+    CHECK(esp_console_deinit() == ESP_OK);
+
+    if (s_failures) {
+        printf("%d failures\n", s_failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
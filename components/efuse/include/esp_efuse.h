@@ -36,6 +36,15 @@ typedef struct {
     uint16_t            bit_count;      /**< Length of bit field [1..-]*/
 } esp_efuse_desc_t;
 
+/**
+ * @brief Type definition for one field read by esp_efuse_read_fields()
+ */
+typedef struct {
+    const esp_efuse_desc_t **field; /**< A pointer to the structure describing the fields of efuse */
+    void *dst;                      /**< A pointer to array that will contain the result of reading */
+    size_t dst_size_bits;           /**< The number of bits required to read, limited to the field size */
+} esp_efuse_read_desc_t;
+
 /**
  * @brief Type definition for ROM log scheme
  */
@@ -96,6 +105,24 @@ esp_err_t esp_efuse_read_field_blob(const esp_efuse_desc_t* field[], void* dst,
  */
 bool esp_efuse_read_field_bit(const esp_efuse_desc_t *field[]);
 
+/**
+ * @brief   Reads several EFUSE fields at once.
+ *
+ * Reads each field like esp_efuse_read_field_blob() does, but all the values are taken
+ * from the same state of eFuses: if eFuses are burned while reading, all the fields are read again.
+ * With CONFIG_EFUSE_READ_CACHE enabled, each eFuse block is read from the registers at most once.
+ *
+ * @note Please note that reading in the batch mode does not show uncommitted changes.
+ *
+ * @param[in] reads   Array of fields to read and buffers for their values.
+ * @param[in] count   Number of elements in reads.
+ *
+ * @return
+ *    - ESP_OK: The operation was successfully completed.
+ *    - ESP_ERR_INVALID_ARG: Error in the passed arguments.
+ */
+esp_err_t esp_efuse_read_fields(const esp_efuse_read_desc_t reads[], size_t count);
+
 /**
  * @brief   Reads bits from EFUSE field and returns number of bits programmed as "1".
  *
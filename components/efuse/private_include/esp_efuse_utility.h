@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2017-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2017-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -64,6 +64,19 @@ typedef esp_err_t (*efuse_func_proc_t) (unsigned int num_reg, esp_efuse_block_t
  */
 esp_err_t esp_efuse_utility_process(const esp_efuse_desc_t* field[], void* ptr, size_t ptr_size_bits, efuse_func_proc_t func_proc);
 
+/**
+ * @brief Reads several fields, see esp_efuse_read_fields().
+ *
+ * @param[in] reads   Array of fields to read and buffers for their values.
+ * @param[in] count   Number of elements in reads.
+ *
+ * @return
+ *      - ESP_OK: The operation was successfully completed.
+ *      - ESP_ERR_DAMAGED_READING: A burn operation happened while reading the fields, repeat the reading.
+ *      - other efuse component errors.
+ */
+esp_err_t esp_efuse_utility_read_fields(const esp_efuse_read_desc_t reads[], size_t count);
+
 /**
  * @brief Write register with the required number of "1" bits.
  * @param[in/out] cnt      The number of bits you need to set in the field.
@@ -141,6 +154,13 @@ int esp_efuse_utility_get_number_of_items(int bits, int size_of_base);
  */
 uint32_t esp_efuse_utility_read_reg(esp_efuse_block_t blk, unsigned int num_reg);
 
+/**
+ * @brief Returns the number of reads from the efuse read registers (from the virt_blocks array in virtual mode).
+ *
+ * Reads served from the copy of efuse blocks kept with CONFIG_EFUSE_READ_CACHE are not counted.
+ */
+unsigned esp_efuse_utility_get_read_reg_count(void);
+
 /**
  * @brief Writing efuse register with checking of repeated programming of programmed bits.
  */
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2017-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2017-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -49,6 +49,29 @@ esp_err_t esp_efuse_read_field_blob(const esp_efuse_desc_t* field[], void* dst,
     return err;
 }
 
+// read several values from EFUSE, all of them from the same state of eFuses
+esp_err_t esp_efuse_read_fields(const esp_efuse_read_desc_t reads[], size_t count)
+{
+    if (reads == NULL || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (reads[i].field == NULL || reads[i].dst == NULL || reads[i].dst_size_bits == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    esp_err_t err;
+    do {
+        err = esp_efuse_utility_read_fields(reads, count);
+#ifndef NON_OS_BUILD
+        if (err == ESP_ERR_DAMAGED_READING) {
+            vTaskDelay(1);
+        }
+#endif // NON_OS_BUILD
+    } while (err == ESP_ERR_DAMAGED_READING);
+    return err;
+}
+
 bool esp_efuse_read_field_bit(const esp_efuse_desc_t *field[])
 {
     uint8_t value = 0;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2017-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2017-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -20,6 +20,20 @@ static const char *TAG = "efuse";
 // If it is not so, we must repeat the read to make sure that the burn operation does not affect the read data.
 static volatile unsigned s_burn_counter = 0;
 
+// Number of reads from the efuse read registers (virt_blocks in virtual mode), for tests.
+static unsigned s_read_reg_count = 0;
+
+#if CONFIG_EFUSE_READ_CACHE && !defined(NON_OS_BUILD)
+#define EFUSE_READ_CACHE 1
+#include "freertos/FreeRTOS.h"
+
+// Copy of the efuse read registers. A block is valid while s_burn_counter still has the value
+// it had when the block was read, s_read_cache_tag keeps this value + 1 (0 - block not cached).
+static uint32_t s_read_cache[EFUSE_BLK_MAX][COUNT_EFUSE_REG_PER_BLOCK];
+static unsigned s_read_cache_tag[EFUSE_BLK_MAX];
+static portMUX_TYPE s_read_cache_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif // CONFIG_EFUSE_READ_CACHE && !NON_OS_BUILD
+
 // Array for emulate efuse registers.
 #ifdef CONFIG_EFUSE_VIRTUAL
 uint32_t virt_blocks[EFUSE_BLK_MAX][COUNT_EFUSE_REG_PER_BLOCK];
@@ -33,9 +47,10 @@ static void write_reg(esp_efuse_block_t blk, unsigned int num_reg, uint32_t valu
 static uint32_t fill_reg(int bit_start_in_reg, int bit_count_in_reg, uint8_t* blob, int* filled_bits_blob);
 static uint32_t set_cnt_in_reg(int bit_start_in_reg, int bit_count_used_in_reg, uint32_t reg_masked, size_t* cnt);
 static bool check_range_of_bits(esp_efuse_block_t blk, int offset_in_bits, int size_bits);
+static uint32_t read_reg(esp_efuse_block_t blk, unsigned int num_reg);
 
-// This function processes the field by calling the passed function.
-esp_err_t esp_efuse_utility_process(const esp_efuse_desc_t* field[], void* ptr, size_t ptr_size_bits, efuse_func_proc_t func_proc)
+// Processes the field by calling the passed function, without checking s_burn_counter.
+static esp_err_t process_field(const esp_efuse_desc_t* field[], void* ptr, size_t ptr_size_bits, efuse_func_proc_t func_proc)
 {
     esp_err_t err = ESP_OK;
     int bits_counter = 0;
@@ -44,7 +59,6 @@ esp_err_t esp_efuse_utility_process(const esp_efuse_desc_t* field[], void* ptr,
     int field_len = esp_efuse_get_field_size(field);
     int req_size = (ptr_size_bits == 0) ? field_len : MIN(ptr_size_bits, field_len);
 
-    unsigned count_before = s_burn_counter;
     for (const esp_efuse_desc_t* f = field[0]; (err == ESP_OK && req_size > bits_counter && f != NULL); ++f) {
         if (check_range_of_bits(f->efuse_block, f->bit_start, f->bit_count) == false) {
             ESP_EARLY_LOGE(TAG, "Range of data does not match the coding scheme");
@@ -75,13 +89,37 @@ esp_err_t esp_efuse_utility_process(const esp_efuse_desc_t* field[], void* ptr,
             }
         }
     }
+    assert(bits_counter <= req_size);
+    return err;
+}
+
+// This function processes the field by calling the passed function.
+esp_err_t esp_efuse_utility_process(const esp_efuse_desc_t* field[], void* ptr, size_t ptr_size_bits, efuse_func_proc_t func_proc)
+{
+    unsigned count_before = s_burn_counter;
+    esp_err_t err = process_field(field, ptr, ptr_size_bits, func_proc);
     unsigned count_after = s_burn_counter;
     if (err == ESP_OK &&
         (func_proc == esp_efuse_utility_fill_buff || func_proc == esp_efuse_utility_count_once) && // these functions are used for read APIs: read_field_blob and read_field_cnt
         (count_before != count_after || (count_after & 1) == 1)) {
         err = ESP_ERR_DAMAGED_READING;
     }
-    assert(bits_counter <= req_size);
+    return err;
+}
+
+// Reads several fields, checking once that no burn operation happened while reading them.
+esp_err_t esp_efuse_utility_read_fields(const esp_efuse_read_desc_t reads[], size_t count)
+{
+    esp_err_t err = ESP_OK;
+    unsigned count_before = s_burn_counter;
+    for (size_t i = 0; err == ESP_OK && i < count; i++) {
+        memset(reads[i].dst, 0, esp_efuse_utility_get_number_of_items(reads[i].dst_size_bits, 8));
+        err = process_field(reads[i].field, reads[i].dst, reads[i].dst_size_bits, esp_efuse_utility_fill_buff);
+    }
+    unsigned count_after = s_burn_counter;
+    if (err == ESP_OK && (count_before != count_after || (count_after & 1) == 1)) {
+        err = ESP_ERR_DAMAGED_READING;
+    }
     return err;
 }
 
@@ -188,7 +226,9 @@ esp_err_t esp_efuse_utility_burn_efuses(void)
 void esp_efuse_utility_erase_virt_blocks(void)
 {
 #ifdef CONFIG_EFUSE_VIRTUAL
+    ++s_burn_counter;
     memset(virt_blocks, 0, sizeof(virt_blocks));
+    ++s_burn_counter;
 #ifdef CONFIG_EFUSE_VIRTUAL_KEEP_IN_FLASH
     esp_efuse_utility_write_efuses_to_flash();
 #endif
@@ -199,6 +239,7 @@ void esp_efuse_utility_erase_virt_blocks(void)
 void esp_efuse_utility_update_virt_blocks(void)
 {
 #ifdef CONFIG_EFUSE_VIRTUAL
+    ++s_burn_counter;
 #ifdef CONFIG_EFUSE_VIRTUAL_KEEP_IN_FLASH
     if (!esp_efuse_utility_load_efuses_from_flash()) {
 #else
@@ -216,6 +257,7 @@ void esp_efuse_utility_update_virt_blocks(void)
         esp_efuse_utility_write_efuses_to_flash();
 #endif
     }
+    ++s_burn_counter;
 #else
     ESP_EARLY_LOGI(TAG, "Emulate efuse is disabled");
 #endif
@@ -278,7 +320,42 @@ uint32_t esp_efuse_utility_read_reg(esp_efuse_block_t blk, unsigned int num_reg)
 {
     assert(blk >= 0 && blk < EFUSE_BLK_MAX);
     assert(num_reg <= (range_read_addr_blocks[blk].end - range_read_addr_blocks[blk].start) / sizeof(uint32_t));
+#ifdef EFUSE_READ_CACHE
+    unsigned counter = s_burn_counter;
+    if ((counter & 1) == 0) {
+        if (__atomic_load_n(&s_read_cache_tag[blk], __ATOMIC_ACQUIRE) != counter + 1) {
+            uint32_t block[COUNT_EFUSE_REG_PER_BLOCK];
+            unsigned num_regs = (range_read_addr_blocks[blk].end - range_read_addr_blocks[blk].start) / sizeof(uint32_t) + 1;
+            for (unsigned i = 0; i < num_regs; i++) {
+                block[i] = read_reg(blk, i);
+            }
+            // Only cache the block if no burn operation has started since reading it
+            portENTER_CRITICAL(&s_read_cache_lock);
+            if (s_burn_counter == counter) {
+                memcpy(s_read_cache[blk], block, num_regs * sizeof(uint32_t));
+                __atomic_store_n(&s_read_cache_tag[blk], counter + 1, __ATOMIC_RELEASE);
+            }
+            portEXIT_CRITICAL(&s_read_cache_lock);
+            return block[num_reg];
+        }
+        return s_read_cache[blk][num_reg];
+    }
+#endif // EFUSE_READ_CACHE
+    return read_reg(blk, num_reg);
+}
+
+unsigned esp_efuse_utility_get_read_reg_count(void)
+{
+    return s_read_reg_count;
+}
+
+// Private functions
+
+// reading efuse register, bypassing the cache.
+static uint32_t read_reg(esp_efuse_block_t blk, unsigned int num_reg)
+{
     uint32_t value;
+    ++s_read_reg_count;
 #ifdef CONFIG_EFUSE_VIRTUAL
     value = virt_blocks[blk][num_reg];
 #else
@@ -287,8 +364,6 @@ uint32_t esp_efuse_utility_read_reg(esp_efuse_block_t blk, unsigned int num_reg)
     return value;
 }
 
-// Private functions
-
 // writing efuse register.
 static void write_reg(esp_efuse_block_t blk, unsigned int num_reg, uint32_t value)
 {
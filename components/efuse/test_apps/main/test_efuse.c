@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2021-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2021-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -102,6 +102,53 @@ TEST_CASE("efuse test read_field_cnt", "[efuse]")
     test_read_cnt();
 }
 
+TEST_CASE("efuse test read_fields", "[efuse]")
+{
+    esp_efuse_utility_update_virt_blocks();
+
+    uint8_t mac[6];
+    uint8_t test1_len_8;
+    uint16_t test2_len_16;
+    TEST_ESP_OK(esp_efuse_read_field_blob(ESP_EFUSE_MAC_FACTORY, &mac, sizeof(mac) * 8));
+    TEST_ESP_OK(esp_efuse_read_field_blob(ESP_EFUSE_TEST1_LEN_8, &test1_len_8, 8));
+    TEST_ESP_OK(esp_efuse_read_field_blob(ESP_EFUSE_TEST2_LEN_16, &test2_len_16, 16));
+
+    ESP_LOGI(TAG, "1. Test check args");
+    uint8_t batch_mac[7] = {0x59, 0x59, 0x59, 0x59, 0x59, 0x59, 0x59};
+    uint8_t batch_test1_len_8 = 0x59;
+    uint16_t batch_test2_len_16 = 0x5959;
+    esp_efuse_read_desc_t reads[] = {
+        { ESP_EFUSE_MAC_FACTORY, &batch_mac, sizeof(batch_mac) * 8 },
+        { ESP_EFUSE_TEST1_LEN_8, &batch_test1_len_8, 8 },
+        { ESP_EFUSE_TEST2_LEN_16, &batch_test2_len_16, 16 },
+    };
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, esp_efuse_read_fields(NULL, 1));
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, esp_efuse_read_fields(reads, 0));
+    esp_efuse_read_desc_t bad_read = { ESP_EFUSE_MAC_FACTORY, NULL, 8 };
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, esp_efuse_read_fields(&bad_read, 1));
+    bad_read.dst = &batch_test1_len_8;
+    bad_read.dst_size_bits = 0;
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, esp_efuse_read_fields(&bad_read, 1));
+
+    ESP_LOGI(TAG, "2. Read several fields at once");
+    TEST_ESP_OK(esp_efuse_read_fields(reads, sizeof(reads) / sizeof(reads[0])));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mac, batch_mac, sizeof(mac));
+    TEST_ASSERT_EQUAL_HEX8(0, batch_mac[6]);
+    TEST_ASSERT_EQUAL_HEX8(test1_len_8, batch_test1_len_8);
+    TEST_ASSERT_EQUAL_HEX16(test2_len_16, batch_test2_len_16);
+
+#ifdef CONFIG_EFUSE_READ_CACHE
+    ESP_LOGI(TAG, "3. Repeated reads are served from the cache");
+    unsigned read_reg_count = esp_efuse_utility_get_read_reg_count();
+    for (int i = 0; i < 10; ++i) {
+        TEST_ESP_OK(esp_efuse_read_fields(reads, sizeof(reads) / sizeof(reads[0])));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(mac, batch_mac, sizeof(mac));
+        TEST_ESP_OK(esp_efuse_read_field_blob(ESP_EFUSE_MAC_FACTORY, &mac, sizeof(mac) * 8));
+    }
+    TEST_ASSERT_EQUAL_UINT(read_reg_count, esp_efuse_utility_get_read_reg_count());
+#endif // CONFIG_EFUSE_READ_CACHE
+}
+
 // If using efuse is real, then turn off writing tests.
 #ifdef CONFIG_EFUSE_VIRTUAL
 static void test_write_blob(void)
@@ -178,6 +225,43 @@ TEST_CASE("efuse test write_field_blob", "[efuse]")
     test_write_blob();
 }
 
+TEST_CASE("efuse test read_fields returns burned values", "[efuse]")
+{
+    esp_efuse_utility_erase_virt_blocks();
+
+    uint8_t test1_len_8 = 0x59;
+    uint16_t test2_len_16 = 0x5959;
+    esp_efuse_read_desc_t reads[] = {
+        { ESP_EFUSE_TEST1_LEN_8, &test1_len_8, 8 },
+        { ESP_EFUSE_TEST2_LEN_16, &test2_len_16, 16 },
+    };
+    TEST_ESP_OK(esp_efuse_read_fields(reads, sizeof(reads) / sizeof(reads[0])));
+    TEST_ASSERT_EQUAL_HEX8(0, test1_len_8);
+    TEST_ASSERT_EQUAL_HEX16(0, test2_len_16);
+    unsigned read_reg_count = esp_efuse_utility_get_read_reg_count();
+
+    ESP_LOGI(TAG, "1. Burned fields are read again after commit");
+    TEST_ESP_OK(esp_efuse_batch_write_begin());
+    uint8_t new_test1_len_8 = 0x5A;
+    uint16_t new_test2_len_16 = 0xAA55;
+    TEST_ESP_OK(esp_efuse_write_field_blob(ESP_EFUSE_TEST1_LEN_8, &new_test1_len_8, 8));
+    TEST_ESP_OK(esp_efuse_write_field_blob(ESP_EFUSE_TEST2_LEN_16, &new_test2_len_16, 16));
+    TEST_ESP_OK(esp_efuse_read_fields(reads, sizeof(reads) / sizeof(reads[0])));
+    TEST_ASSERT_EQUAL_HEX8(0, test1_len_8);
+    TEST_ASSERT_EQUAL_HEX16(0, test2_len_16);
+    TEST_ESP_OK(esp_efuse_batch_write_commit());
+    TEST_ESP_OK(esp_efuse_read_fields(reads, sizeof(reads) / sizeof(reads[0])));
+    TEST_ASSERT_EQUAL_HEX8(new_test1_len_8, test1_len_8);
+    TEST_ASSERT_EQUAL_HEX16(new_test2_len_16, test2_len_16);
+    TEST_ASSERT_GREATER_THAN_UINT(read_reg_count, esp_efuse_utility_get_read_reg_count());
+
+    ESP_LOGI(TAG, "2. Erased virtual eFuses are read again");
+    esp_efuse_utility_erase_virt_blocks();
+    TEST_ESP_OK(esp_efuse_read_fields(reads, sizeof(reads) / sizeof(reads[0])));
+    TEST_ASSERT_EQUAL_HEX8(0, test1_len_8);
+    TEST_ASSERT_EQUAL_HEX16(0, test2_len_16);
+}
+
 static void test_write_cnt(void)
 {
     esp_efuse_coding_scheme_t scheme = esp_efuse_get_coding_scheme(EFUSE_BLK1);
@@ -51,6 +51,9 @@ static const char *TAG = "esp-tls";
 
 #ifdef CONFIG_ESP_TLS_USING_MBEDTLS
 #include "esp_tls_mbedtls.h"
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+#include "esp_tls_session_cache.h"
+#endif
 #elif CONFIG_ESP_TLS_USING_WOLFSSL
 #include "esp_tls_wolfssl.h"
 #endif
@@ -165,6 +168,9 @@ int esp_tls_conn_destroy(esp_tls_t *tls)
             free(tls->client_session);
         }
 #endif // CONFIG_MBEDTLS_SSL_PROTO_TLS1_3 && CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+        free(tls->session_cache_key);
+#endif
         free(tls);
         tls = NULL;
         return ret;
@@ -516,6 +522,10 @@ static int esp_tls_low_level_conn(const char *hostname, int hostlen, int port, c
             }
         }
         /* By now, the connection has been established */
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+        free(tls->session_cache_key);
+        tls->session_cache_key = esp_tls_session_cache_make_key(hostname, hostlen, port, cfg);
+#endif
         esp_ret = create_ssl_handle(hostname, hostlen, cfg, tls);
         if (esp_ret != ESP_OK) {
             ESP_LOGE(TAG, "create_ssl_handle failed");
@@ -62,6 +62,20 @@ typedef struct esp_tls_client_session {
 } esp_tls_client_session_t;
 #endif /* CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS */
 
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+/**
+ * @brief Statistics of the client session cache
+ */
+typedef struct esp_tls_session_cache_stats {
+    uint32_t hits;                          /*!< Connections which offered a cached session to the server */
+    uint32_t misses;                        /*!< Connections without a usable cached session */
+    uint32_t stored;                        /*!< Sessions stored (or refreshed) after a handshake */
+    uint32_t expired;                       /*!< Sessions dropped because they were older than the cache timeout */
+    uint32_t evicted;                       /*!< Sessions dropped to make room for another server */
+    size_t entries;                         /*!< Sessions currently cached */
+} esp_tls_session_cache_stats_t;
+#endif /* CONFIG_ESP_TLS_CLIENT_SESSION_CACHE */
+
 /**
 *  @brief Keep alive parameters structure
 */
@@ -814,6 +828,65 @@ esp_tls_client_session_t *esp_tls_get_client_session(esp_tls_t *tls);
  */
 void esp_tls_free_client_session(esp_tls_client_session_t *client_session);
 #endif /* CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS */
+
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+/**
+ * @brief Get the statistics of the client session cache
+ *
+ * The cache stores the session of every client connection (TLS 1.2 session ID or ticket, TLS 1.3 ticket)
+ * and offers it again on the next connection to the same host, port and ALPN protocols, so that the
+ * handshake can be abbreviated.
+ *
+ * @param[out] stats  Statistics
+ *
+ * @return
+ *             - ESP_OK
+ *             - ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t esp_tls_session_cache_get_stats(esp_tls_session_cache_stats_t *stats);
+
+/**
+ * @brief Drop all sessions from the client session cache
+ *
+ * @return ESP_OK
+ */
+esp_err_t esp_tls_session_cache_clear(void);
+
+/**
+ * @brief Serialize the client session cache, e.g. to keep it in NVS across reboots
+ *
+ * The blob contains session secrets and must be stored accordingly (e.g. in encrypted NVS).
+ * It records the age of each session and the wall clock time of the export.
+ *
+ * @param[out]   buf  Buffer for the blob, or NULL to query the needed size
+ * @param[inout] len  Size of buf; set to the size of the blob
+ *
+ * @return
+ *             - ESP_OK
+ *             - ESP_ERR_INVALID_SIZE if buf is too small, len is set to the needed size
+ *             - ESP_ERR_INVALID_ARG if len is NULL
+ */
+esp_err_t esp_tls_session_cache_export(void *buf, size_t *len);
+
+/**
+ * @brief Add the sessions of a blob produced by esp_tls_session_cache_export() to the client session cache
+ *
+ * Sessions keep the age they had when exported, so they expire after
+ * CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_TIMEOUT counted from their handshake. If the wall clock was set
+ * both at the export and now (e.g. by SNTP), the time elapsed in between is added as well. Sessions which
+ * are then older than the timeout are not imported.
+ *
+ * @param[in] buf  The blob
+ * @param[in] len  Size of the blob
+ *
+ * @return
+ *             - ESP_OK
+ *             - ESP_ERR_INVALID_ARG if the blob is not a session cache export
+ *             - ESP_ERR_INVALID_SIZE if the blob is truncated
+ *             - ESP_ERR_NO_MEM
+ */
+esp_err_t esp_tls_session_cache_import(const void *buf, size_t len);
+#endif /* CONFIG_ESP_TLS_CLIENT_SESSION_CACHE */
 #ifdef __cplusplus
 }
 #endif
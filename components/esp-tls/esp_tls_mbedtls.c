@@ -21,6 +21,9 @@
 #include "esp_log.h"
 #include "esp_check.h"
 #include "mbedtls/esp_mbedtls_dynamic.h"
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+#include "esp_tls_session_cache.h"
+#endif
 #ifdef CONFIG_MBEDTLS_HARDWARE_ECDSA_SIGN
 #include "mbedtls/ecp.h"
 #include "ecdsa/ecdsa_alt.h"
@@ -194,6 +197,21 @@ esp_err_t esp_create_mbedtls_handle(const char *hostname, size_t hostlen, const
     }
     mbedtls_ssl_set_bio(&tls->ssl, &tls->server_fd, mbedtls_net_send, mbedtls_net_recv, NULL);
 
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+    /* A session passed explicitly in the configuration takes precedence over the cache */
+    if (tls->role == ESP_TLS_CLIENT && tls->session_cache_key && ((esp_tls_cfg_t *)cfg)->client_session == NULL) {
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        if (esp_tls_session_cache_get(tls->session_cache_key, &session) == ESP_OK) {
+            ESP_LOGD(TAG, "Resuming cached session for %s", tls->session_cache_key);
+            if ((ret = mbedtls_ssl_set_session(&tls->ssl, &session)) != 0) {
+                /* Not fatal, the handshake just won't be abbreviated */
+                ESP_LOGW(TAG, "mbedtls_ssl_set_session returned -0x%04X", -ret);
+            }
+        }
+        mbedtls_ssl_session_free(&session);
+    }
+#endif
     return ESP_OK;
 
 exit:
@@ -250,6 +268,12 @@ esp_tls_client_session_t *esp_mbedtls_get_client_session(esp_tls_t *tls)
         return NULL;
     }
 
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+    /* The session has already been exported into the cache after the handshake */
+    if (tls->session_cache_key && esp_tls_session_cache_get(tls->session_cache_key, &client_session->saved_session) == ESP_OK) {
+        return client_session;
+    }
+#endif
     /* Get the session ticket from the mbedtls context and load it into the client session */
     int ret = mbedtls_ssl_get_session(&tls->ssl, &(client_session->saved_session));
     if (ret != 0) {
@@ -296,6 +320,17 @@ int esp_mbedtls_handshake(esp_tls_t *tls, const esp_tls_cfg_t *cfg)
 #endif
         tls->conn_state = ESP_TLS_DONE;
 
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+        /* TLS 1.3 tickets arrive after the handshake and are stored by esp_mbedtls_read() */
+        if (tls->session_cache_key && mbedtls_ssl_get_version_number(&tls->ssl) != MBEDTLS_SSL_VERSION_TLS1_3) {
+            mbedtls_ssl_session session;
+            mbedtls_ssl_session_init(&session);
+            if (mbedtls_ssl_get_session(&tls->ssl, &session) == 0) {
+                esp_tls_session_cache_put(tls->session_cache_key, &session);
+            }
+            mbedtls_ssl_session_free(&session);
+        }
+#endif
 #ifdef CONFIG_ESP_TLS_USE_DS_PERIPHERAL
         esp_ds_release_ds_lock();
 #endif
@@ -387,6 +422,11 @@ ssize_t esp_mbedtls_read(esp_tls_t *tls, char *data, size_t datalen)
 
                 ESP_LOGD(TAG, "Session ticket saved in the client session context");
                 tls->client_session_len = session_ticket_len;
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+                if (tls->session_cache_key) {
+                    esp_tls_session_cache_put_serialized(tls->session_cache_key, tls->client_session, tls->client_session_len, 0);
+                }
+#endif
                 mbedtls_ssl_session_free(&tls13_saved_client_session->saved_session);
                 free(tls13_saved_client_session);
                 tls13_saved_client_session = NULL;
@@ -0,0 +1,365 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_tls.h"
+#include "mbedtls/platform_util.h"
+#include "esp_tls_platform_port.h"
+#include "esp_tls_session_cache.h"
+
+static const char *TAG = "esp-tls-session-cache";
+
+#define SESSION_CACHE_EXPORT_MAGIC      (0x43535445)    /* "ETSC" */
+#define SESSION_CACHE_TIMEOUT_US        ((uint64_t)CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_TIMEOUT * 1000000)
+/* Wall clock times before 2024-01-01 mean that the clock has not been set (e.g. by SNTP) */
+#define SESSION_CACHE_MIN_VALID_TIME    ((int64_t)1704067200)
+
+typedef struct {
+    char *key;
+    unsigned char *data;                /*!< Serialized mbedtls_ssl_session */
+    size_t len;
+    uint64_t stored_us;
+    uint32_t last_use;                  /*!< For LRU eviction */
+} session_cache_entry_t;
+
+static session_cache_entry_t s_cache[CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_SIZE];
+static esp_tls_session_cache_stats_t s_stats;
+static uint32_t s_use_counter;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void entry_free(session_cache_entry_t *entry)
+{
+    free(entry->key);
+    if (entry->data) {
+        /* The blob holds the master secret of the session */
+        mbedtls_platform_zeroize(entry->data, entry->len);
+        free(entry->data);
+    }
+    memset(entry, 0, sizeof(*entry));
+}
+
+static uint64_t fingerprint_update(uint64_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static uint64_t fingerprint_str(uint64_t hash, const char *str)
+{
+    /* Include the terminator so that NULL and "" differ from adjacent fields */
+    return str ? fingerprint_update(hash, str, strlen(str) + 1) : fingerprint_update(hash, "\xff", 1);
+}
+
+char *esp_tls_session_cache_make_key(const char *hostname, size_t hostlen, int port, const esp_tls_cfg_t *cfg)
+{
+    /* Settings deciding which servers are trusted and how the client authenticates. A session established
+     * under one set of them must not be resumed under another one. */
+    uint64_t fp = 0xcbf29ce484222325ULL;
+    if (cfg->cacert_buf) {
+        fp = fingerprint_update(fp, cfg->cacert_buf, cfg->cacert_bytes);
+    }
+    if (cfg->clientcert_buf) {
+        fp = fingerprint_update(fp, cfg->clientcert_buf, cfg->clientcert_bytes);
+    }
+    uint8_t flags[] = {
+        cfg->crt_bundle_attach != NULL,
+        cfg->use_global_ca_store,
+        cfg->skip_common_name,
+        cfg->use_secure_element,
+        cfg->use_ecdsa_peripheral,
+        cfg->ds_data != NULL,
+        (uint8_t)cfg->tls_version,
+    };
+    fp = fingerprint_update(fp, flags, sizeof(flags));
+    fp = fingerprint_str(fp, cfg->common_name);
+
+    size_t alpn_len = 0;
+    for (const char **proto = cfg->alpn_protos; proto && *proto; proto++) {
+        alpn_len += strlen(*proto) + 1;
+    }
+    size_t len = hostlen + alpn_len + 32;
+    char *key = malloc(len);
+    ESP_RETURN_ON_FALSE(key, NULL, TAG, "Memory exhausted");
+    int pos = snprintf(key, len, "%.*s:%d/", (int)hostlen, hostname, port);
+    for (const char **proto = cfg->alpn_protos; proto && *proto; proto++) {
+        pos += snprintf(key + pos, len - pos, "%s%s", proto == cfg->alpn_protos ? "" : ",", *proto);
+    }
+    snprintf(key + pos, len - pos, "/%016" PRIx64, fp);
+    return key;
+}
+
+static session_cache_entry_t *cache_find(const char *key)
+{
+    for (int i = 0; i < CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_SIZE; i++) {
+        if (s_cache[i].key && strcmp(s_cache[i].key, key) == 0) {
+            return &s_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/* Takes ownership of data; called with s_lock held. stored_us may lie before boot, the expiry checks
+ * compute the age with unsigned arithmetic. */
+static esp_err_t cache_store(const char *key, unsigned char *data, size_t len, uint64_t stored_us)
+{
+    session_cache_entry_t *entry = cache_find(key);
+    if (entry == NULL) {
+        /* Use a free slot, or evict the least recently used entry */
+        entry = &s_cache[0];
+        for (int i = 0; i < CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_SIZE; i++) {
+            if (s_cache[i].key == NULL) {
+                entry = &s_cache[i];
+                break;
+            }
+            if ((int32_t)(s_cache[i].last_use - entry->last_use) < 0) {
+                entry = &s_cache[i];
+            }
+        }
+        if (entry->key) {
+            ESP_LOGD(TAG, "Evicting session for %s", entry->key);
+            s_stats.evicted++;
+            entry_free(entry);
+        }
+        entry->key = strdup(key);
+        if (entry->key == NULL) {
+            mbedtls_platform_zeroize(data, len);
+            free(data);
+            return ESP_ERR_NO_MEM;
+        }
+    } else {
+        mbedtls_platform_zeroize(entry->data, entry->len);
+        free(entry->data);
+    }
+    entry->data = data;
+    entry->len = len;
+    entry->stored_us = stored_us;
+    entry->last_use = ++s_use_counter;
+    s_stats.stored++;
+    return ESP_OK;
+}
+
+esp_err_t esp_tls_session_cache_get(const char *key, mbedtls_ssl_session *session)
+{
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    uint64_t now = esp_tls_get_platform_time();
+
+    pthread_mutex_lock(&s_lock);
+    session_cache_entry_t *entry = cache_find(key);
+    if (entry && now - entry->stored_us > SESSION_CACHE_TIMEOUT_US) {
+        ESP_LOGD(TAG, "Session for %s expired", key);
+        s_stats.expired++;
+        entry_free(entry);
+        entry = NULL;
+    }
+    if (entry) {
+        int err = mbedtls_ssl_session_load(session, entry->data, entry->len);
+        if (err == 0) {
+            entry->last_use = ++s_use_counter;
+            s_stats.hits++;
+            ret = ESP_OK;
+        } else {
+            /* E.g. saved by a build with a different mbedTLS configuration */
+            ESP_LOGW(TAG, "Dropping unusable session for %s (-0x%04X)", key, -err);
+            entry_free(entry);
+            s_stats.misses++;
+            ret = ESP_FAIL;
+        }
+    } else {
+        s_stats.misses++;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t esp_tls_session_cache_put_serialized(const char *key, const unsigned char *buf, size_t len, uint64_t age_us)
+{
+    unsigned char *data = malloc(len);
+    ESP_RETURN_ON_FALSE(data, ESP_ERR_NO_MEM, TAG, "Memory exhausted");
+    memcpy(data, buf, len);
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = cache_store(key, data, len, esp_tls_get_platform_time() - age_us);
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t esp_tls_session_cache_put(const char *key, const mbedtls_ssl_session *session)
+{
+    size_t len = 0;
+    int err = mbedtls_ssl_session_save(session, NULL, 0, &len);
+    ESP_RETURN_ON_FALSE(err == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL, ESP_FAIL, TAG, "Failed to get session length (-0x%04X)", -err);
+    unsigned char *data = malloc(len);
+    ESP_RETURN_ON_FALSE(data, ESP_ERR_NO_MEM, TAG, "Memory exhausted");
+    err = mbedtls_ssl_session_save(session, data, len, &len);
+    if (err != 0) {
+        ESP_LOGE(TAG, "Failed to save session (-0x%04X)", -err);
+        free(data);
+        return ESP_FAIL;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = cache_store(key, data, len, esp_tls_get_platform_time());
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t esp_tls_session_cache_get_stats(esp_tls_session_cache_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "stats must not be NULL");
+    pthread_mutex_lock(&s_lock);
+    *stats = s_stats;
+    stats->entries = 0;
+    for (int i = 0; i < CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_SIZE; i++) {
+        if (s_cache[i].key) {
+            stats->entries++;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_tls_session_cache_clear(void)
+{
+    pthread_mutex_lock(&s_lock);
+    for (int i = 0; i < CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_SIZE; i++) {
+        if (s_cache[i].key) {
+            entry_free(&s_cache[i]);
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+/*
+ * Export format, in host byte order:
+ *   uint32_t magic, uint32_t count, int64_t export_time (seconds since the epoch),
+ *   count * { uint16_t key_len, key, uint32_t age (seconds), uint32_t data_len, data }
+ */
+esp_err_t esp_tls_session_cache_export(void *buf, size_t *len)
+{
+    ESP_RETURN_ON_FALSE(len, ESP_ERR_INVALID_ARG, TAG, "len must not be NULL");
+    esp_err_t ret = ESP_OK;
+    uint64_t now = esp_tls_get_platform_time();
+
+    pthread_mutex_lock(&s_lock);
+    uint32_t count = 0;
+    size_t needed = 2 * sizeof(uint32_t) + sizeof(int64_t);
+    for (int i = 0; i < CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_SIZE; i++) {
+        session_cache_entry_t *entry = &s_cache[i];
+        if (entry->key && now - entry->stored_us <= SESSION_CACHE_TIMEOUT_US) {
+            needed += sizeof(uint16_t) + strlen(entry->key) + 2 * sizeof(uint32_t) + entry->len;
+            count++;
+        }
+    }
+    if (buf == NULL) {
+        *len = needed;
+        goto exit;
+    }
+    if (*len < needed) {
+        *len = needed;
+        ret = ESP_ERR_INVALID_SIZE;
+        goto exit;
+    }
+
+    uint8_t *p = buf;
+    uint32_t header[2] = { SESSION_CACHE_EXPORT_MAGIC, count };
+    int64_t export_time = time(NULL);
+    memcpy(p, header, sizeof(header));
+    p += sizeof(header);
+    memcpy(p, &export_time, sizeof(export_time));
+    p += sizeof(export_time);
+    for (int i = 0; i < CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_SIZE; i++) {
+        session_cache_entry_t *entry = &s_cache[i];
+        if (entry->key == NULL || now - entry->stored_us > SESSION_CACHE_TIMEOUT_US) {
+            continue;
+        }
+        uint16_t key_len = strlen(entry->key);
+        uint32_t age = (now - entry->stored_us) / 1000000;
+        uint32_t data_len = entry->len;
+        memcpy(p, &key_len, sizeof(key_len));
+        p += sizeof(key_len);
+        memcpy(p, entry->key, key_len);
+        p += key_len;
+        memcpy(p, &age, sizeof(age));
+        p += sizeof(age);
+        memcpy(p, &data_len, sizeof(data_len));
+        p += sizeof(data_len);
+        memcpy(p, entry->data, data_len);
+        p += data_len;
+    }
+    *len = needed;
+exit:
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t esp_tls_session_cache_import(const void *buf, size_t len)
+{
+    ESP_RETURN_ON_FALSE(buf, ESP_ERR_INVALID_ARG, TAG, "buf must not be NULL");
+    const uint8_t *p = buf;
+    size_t left = len;
+    uint32_t header[2];
+    int64_t export_time;
+    ESP_RETURN_ON_FALSE(left >= sizeof(header) + sizeof(export_time), ESP_ERR_INVALID_SIZE, TAG, "Truncated session cache");
+    memcpy(header, p, sizeof(header));
+    memcpy(&export_time, p + sizeof(header), sizeof(export_time));
+    p += sizeof(header) + sizeof(export_time);
+    left -= sizeof(header) + sizeof(export_time);
+    ESP_RETURN_ON_FALSE(header[0] == SESSION_CACHE_EXPORT_MAGIC, ESP_ERR_INVALID_ARG, TAG, "Not a session cache export");
+
+    /* The time spent between the export and the import (e.g. powered off) is only known if the wall clock
+     * was set at both points. Otherwise the sessions keep the age they had when exported. */
+    int64_t now_time = time(NULL);
+    uint64_t elapsed = 0;
+    if (export_time >= SESSION_CACHE_MIN_VALID_TIME && now_time >= export_time) {
+        elapsed = now_time - export_time;
+    }
+
+    for (uint32_t i = 0; i < header[1]; i++) {
+        uint16_t key_len;
+        uint32_t age;
+        uint32_t data_len;
+        ESP_RETURN_ON_FALSE(left >= sizeof(key_len), ESP_ERR_INVALID_SIZE, TAG, "Truncated session cache");
+        memcpy(&key_len, p, sizeof(key_len));
+        p += sizeof(key_len);
+        left -= sizeof(key_len);
+        ESP_RETURN_ON_FALSE(left >= key_len + sizeof(age) + sizeof(data_len), ESP_ERR_INVALID_SIZE, TAG, "Truncated session cache");
+        const char *key = (const char *)p;
+        memcpy(&age, p + key_len, sizeof(age));
+        memcpy(&data_len, p + key_len + sizeof(age), sizeof(data_len));
+        p += key_len + sizeof(age) + sizeof(data_len);
+        left -= key_len + sizeof(age) + sizeof(data_len);
+        ESP_RETURN_ON_FALSE(left >= data_len, ESP_ERR_INVALID_SIZE, TAG, "Truncated session cache");
+
+        uint64_t age_us = (age + elapsed) * 1000000;
+        if (age_us > SESSION_CACHE_TIMEOUT_US) {
+            ESP_LOGD(TAG, "Not importing expired session for %.*s", key_len, key);
+            pthread_mutex_lock(&s_lock);
+            s_stats.expired++;
+            pthread_mutex_unlock(&s_lock);
+        } else {
+            char *key_str = strndup(key, key_len);
+            ESP_RETURN_ON_FALSE(key_str, ESP_ERR_NO_MEM, TAG, "Memory exhausted");
+            esp_err_t ret = esp_tls_session_cache_put_serialized(key_str, p, data_len, age_us);
+            free(key_str);
+            ESP_RETURN_ON_ERROR(ret, TAG, "Failed to import session");
+        }
+        p += data_len;
+        left -= data_len;
+    }
+    return ESP_OK;
+}
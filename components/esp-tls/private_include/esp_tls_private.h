@@ -73,6 +73,9 @@ struct esp_tls {
     unsigned char *client_session;                                              /*!< Pointer for the serialized client session ticket context. */
     size_t client_session_len;                                                  /*!< Length of the serialized client session ticket context. */
 #endif /* CONFIG_MBEDTLS_SSL_PROTO_TLS1_3 && CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS */
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_CACHE
+    char *session_cache_key;                                                    /*!< Key of this connection in the client session cache */
+#endif
 #elif CONFIG_ESP_TLS_USING_WOLFSSL
     void *priv_ctx;
     void *priv_ssl;
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include "esp_tls.h"
+#include "mbedtls/ssl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Internal API of the client session cache.
+ *
+ * Sessions are stored serialized (mbedtls_ssl_session_save) under a key made of the host name, the port,
+ * the ALPN list and a fingerprint of the verification related configuration, so that a session is only
+ * offered to the server it was established with, under the same trust settings.
+ */
+
+/**
+ * @brief Build the cache key of a connection
+ *
+ * @return Allocated key string, to be freed by the caller; NULL if out of memory
+ */
+char *esp_tls_session_cache_make_key(const char *hostname, size_t hostlen, int port, const esp_tls_cfg_t *cfg);
+
+/**
+ * @brief Load the cached session for a key
+ *
+ * @param[in]  key      Cache key
+ * @param[out] session  Initialized session to load into
+ *
+ * @return
+ *      - ESP_OK
+ *      - ESP_ERR_NOT_FOUND if there is no valid session for the key
+ *      - ESP_FAIL if the cached session could not be loaded
+ */
+esp_err_t esp_tls_session_cache_get(const char *key, mbedtls_ssl_session *session);
+
+/**
+ * @brief Store a session under a key, replacing the previous one
+ */
+esp_err_t esp_tls_session_cache_put(const char *key, const mbedtls_ssl_session *session);
+
+/**
+ * @brief Store an already serialized session under a key, replacing the previous one.
+ *        age_us is the time elapsed since the session was established, it counts towards the timeout.
+ */
+esp_err_t esp_tls_session_cache_put_serialized(const char *key, const unsigned char *buf, size_t len, uint64_t age_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,6 +11,17 @@
 #include "esp_log.h"
 #include "esp_mac.h"
 #include "sys/socket.h"
+#if CONFIG_ESP_TLS_CLIENT_SESSION_CACHE && CONFIG_ESP_TLS_SERVER_SESSION_TICKETS
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "lwip/sockets.h"
+#include "esp_timer.h"
+#include "test_utils.h"
+#endif
 
 const char *test_cert_pem =   "-----BEGIN CERTIFICATE-----\n"\
                               "MIICrDCCAZQCCQD88gCs5AFs/jANBgkqhkiG9w0BAQsFADAYMRYwFAYDVQQDDA1F\n"\
@@ -94,3 +105,143 @@ TEST_CASE("esp_tls_server session create delete", "[esp-tls]")
     esp_tls_server_session_delete(tls);
 
 }
+
+#if CONFIG_ESP_TLS_CLIENT_SESSION_CACHE && CONFIG_ESP_TLS_SERVER_SESSION_TICKETS
+#define SESSION_CACHE_TEST_PORT     (8443)
+
+typedef struct {
+    int listen_sock;
+    int handshakes;
+    SemaphoreHandle_t done;
+} session_cache_test_server_t;
+
+/* Accepts two TLS connections, issuing session tickets */
+static void session_cache_test_server_task(void *arg)
+{
+    session_cache_test_server_t *server = arg;
+    esp_tls_cfg_server_t cfg = {
+        .servercert_buf = (const unsigned char *)test_cert_pem,
+        .servercert_bytes = strlen(test_cert_pem) + 1,
+        .serverkey_buf = (const unsigned char *)test_key_pem,
+        .serverkey_bytes = strlen(test_key_pem) + 1,
+    };
+    if (esp_tls_cfg_server_session_tickets_init(&cfg) == ESP_OK) {
+        for (int i = 0; i < 2; i++) {
+            int sock = accept(server->listen_sock, NULL, NULL);
+            if (sock < 0) {
+                break;
+            }
+            esp_tls_t *tls = esp_tls_init();
+            if (tls && esp_tls_server_session_create(&cfg, sock, tls) == 0) {
+                server->handshakes++;
+            }
+            esp_tls_server_session_delete(tls);
+            close(sock);
+        }
+        esp_tls_cfg_server_session_tickets_free(&cfg);
+    }
+    xSemaphoreGive(server->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("esp-tls client session cache resumes the session of a previous connection", "[esp-tls]")
+{
+    test_case_uses_tcpip();
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_clear());
+
+    session_cache_test_server_t server = { 0 };
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(SESSION_CACHE_TEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    server.listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, server.listen_sock);
+    TEST_ASSERT_EQUAL(0, bind(server.listen_sock, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(server.listen_sock, 1));
+    server.done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(server.done);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(session_cache_test_server_task, "tls_srv", 8192, &server, 5, NULL));
+
+    esp_tls_cfg_t cfg = {
+        .cacert_buf = (const unsigned char *)test_cert_pem,
+        .cacert_bytes = strlen(test_cert_pem) + 1,
+        .skip_common_name = true,
+        .timeout_ms = 10000,
+        .tls_version = ESP_TLS_VER_TLS_1_2,
+    };
+    uint64_t handshake_us[2];
+    for (int i = 0; i < 2; i++) {
+        esp_tls_t *tls = esp_tls_init();
+        TEST_ASSERT_NOT_NULL(tls);
+        uint64_t start = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(1, esp_tls_conn_new_sync("127.0.0.1", strlen("127.0.0.1"), SESSION_CACHE_TEST_PORT, &cfg, tls));
+        handshake_us[i] = esp_timer_get_time() - start;
+        esp_tls_conn_destroy(tls);
+    }
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(server.done, pdMS_TO_TICKS(10000)));
+    TEST_ASSERT_EQUAL(2, server.handshakes);
+
+    esp_tls_session_cache_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_get_stats(&stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.misses);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.hits);
+    TEST_ASSERT_EQUAL(1, stats.entries);
+    /* The resumed handshake skips the certificate verification and the RSA key exchange */
+    printf("full handshake %" PRIu64 " us, resumed %" PRIu64 " us\n", handshake_us[0], handshake_us[1]);
+    TEST_ASSERT_LESS_THAN(handshake_us[0], handshake_us[1]);
+
+    /* The session survives an export and import, as after a reboot */
+    size_t blob_len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_export(NULL, &blob_len));
+    void *blob = malloc(blob_len);
+    TEST_ASSERT_NOT_NULL(blob);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_export(blob, &blob_len));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_clear());
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_import(blob, blob_len));
+    free(blob);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_get_stats(&stats));
+    TEST_ASSERT_EQUAL(1, stats.entries);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_clear());
+    close(server.listen_sock);
+    vSemaphoreDelete(server.done);
+}
+
+/* Appends one session to an export blob, see the format in esp_tls_session_cache.c */
+static size_t session_cache_test_add_entry(uint8_t *p, const char *key, uint32_t age)
+{
+    uint16_t key_len = strlen(key);
+    uint32_t data_len = 4;
+    memcpy(p, &key_len, sizeof(key_len));
+    memcpy(p + sizeof(key_len), key, key_len);
+    memcpy(p + sizeof(key_len) + key_len, &age, sizeof(age));
+    memcpy(p + sizeof(key_len) + key_len + sizeof(age), &data_len, sizeof(data_len));
+    memcpy(p + sizeof(key_len) + key_len + sizeof(age) + sizeof(data_len), "data", data_len);
+    return sizeof(key_len) + key_len + sizeof(age) + sizeof(data_len) + data_len;
+}
+
+TEST_CASE("esp-tls client session cache does not import expired sessions", "[esp-tls]")
+{
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_clear());
+    esp_tls_session_cache_stats_t before, after;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_get_stats(&before));
+
+    uint8_t blob[128];
+    uint32_t header[2] = { 0x43535445, 2 };
+    int64_t export_time = 0;
+    size_t len = 0;
+    memcpy(blob, header, sizeof(header));
+    len += sizeof(header);
+    memcpy(blob + len, &export_time, sizeof(export_time));
+    len += sizeof(export_time);
+    len += session_cache_test_add_entry(blob + len, "fresh:443/", CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_TIMEOUT - 1);
+    len += session_cache_test_add_entry(blob + len, "stale:443/", CONFIG_ESP_TLS_CLIENT_SESSION_CACHE_TIMEOUT + 1);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_import(blob, len));
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_get_stats(&after));
+    TEST_ASSERT_EQUAL(1, after.entries);
+    TEST_ASSERT_EQUAL_UINT32(1, after.expired - before.expired);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_tls_session_cache_clear());
+}
+#endif // CONFIG_ESP_TLS_CLIENT_SESSION_CACHE && CONFIG_ESP_TLS_SERVER_SESSION_TICKETS
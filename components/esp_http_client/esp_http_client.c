@@ -13,6 +13,7 @@
 #include "esp_check.h"
 #include "http_parser.h"
 #include "http_header.h"
+#include "http_header_arena.h"
 #include "esp_transport.h"
 #include "esp_transport_tcp.h"
 #include "esp_transport_ssl.h"
@@ -27,6 +28,9 @@
 #ifdef CONFIG_ESP_HTTP_CLIENT_ENABLE_HTTPS
 #include "esp_transport_ssl.h"
 #endif
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+#include "http_conn_pool.h"
+#endif
 
 ESP_EVENT_DEFINE_BASE(ESP_HTTP_CLIENT_EVENT);
 
@@ -91,6 +95,23 @@ typedef struct {
 
 
 
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+/**
+ * Pipelined request, serialized at enqueue time
+ */
+typedef struct http_pipeline_req {
+    esp_http_client_method_t        method;         /*!< HTTP method, needed to parse the response of HEAD requests */
+    char                            *raw;           /*!< Request line, headers and body */
+    int                             raw_len;        /*!< Length of the serialized request */
+    int                             raw_written;    /*!< Bytes already written to the connection */
+    esp_http_client_pipeline_cb_t   on_complete;    /*!< Completion callback */
+    void                            *user_ctx;      /*!< User context of the callback */
+    STAILQ_ENTRY(http_pipeline_req) next;
+} http_pipeline_req_t;
+
+STAILQ_HEAD(http_pipeline_list, http_pipeline_req);
+#endif
+
 typedef enum {
     SESSION_TICKET_UNUSED = 0,
     SESSION_TICKET_NOT_SAVED,
@@ -116,8 +137,9 @@ struct esp_http_client {
     char                        *post_data;
     char                        *location;
     char                        *auth_header;
-    char                        *current_header_key;
-    char                        *current_header_value;
+    http_header_arena_handle_t  response_headers;       /*!< Headers of the current response */
+    esp_http_client_body_cb_t   body_cb;                /*!< Receives the body in place of esp_http_client_read() */
+    void                        *body_cb_ctx;
     int                         post_len;
     connection_info_t           connection_info;
     bool                        is_chunk_complete;
@@ -139,11 +161,27 @@ struct esp_http_client {
 #ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
     session_ticket_state_t      session_ticket_state;
 #endif
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+    bool                        use_connection_pool;
+    uint64_t                    pool_cfg_id;
+#endif
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+    struct http_pipeline_list   pipeline_pending;       /*!< Queued requests, not (fully) written yet */
+    struct http_pipeline_list   pipeline_inflight;      /*!< Written requests waiting for their response */
+    int                         pipeline_inflight_count;
+    bool                        pipeline_inflight_unsafe; /*!< A non-idempotent request is in flight */
+    bool                        pipeline_active;        /*!< Parser callbacks are processing pipelined responses */
+    bool                        pipeline_conn_closing;  /*!< Server asked to close the connection */
+#endif
 };
 
 typedef struct esp_http_client esp_http_client_t;
 
 static esp_err_t _clear_connection_info(esp_http_client_handle_t client);
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+static void http_pipeline_on_response_complete(esp_http_client_handle_t client);
+static void http_pipeline_fail_all(esp_http_client_handle_t client, struct http_pipeline_list *list, esp_err_t err);
+#endif
 /**
  * Default settings
  */
@@ -188,6 +226,9 @@ static const char *HTTP_METHOD_MAPPING[] = {
 static esp_err_t esp_http_client_request_send(esp_http_client_handle_t client, int write_len);
 static esp_err_t esp_http_client_connect(esp_http_client_handle_t client);
 static esp_err_t esp_http_client_send_post_data(esp_http_client_handle_t client);
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+static void http_client_pool_checkin(esp_http_client_handle_t client);
+#endif
 
 static esp_err_t http_dispatch_event(esp_http_client_t *client, esp_http_client_event_id_t event_id, void *data, int len)
 {
@@ -211,6 +252,17 @@ static void http_dispatch_event_to_event_loop(int32_t event_id, const void* even
     }
 }
 
+/* Method of the request whose response is being parsed */
+static esp_http_client_method_t http_client_response_method(esp_http_client_handle_t client)
+{
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+    if (client->pipeline_active && !STAILQ_EMPTY(&client->pipeline_inflight)) {
+        return STAILQ_FIRST(&client->pipeline_inflight)->method;
+    }
+#endif
+    return client->connection_info.method;
+}
+
 static int http_on_message_begin(http_parser *parser)
 {
     esp_http_client_t *client = parser->data;
@@ -218,6 +270,7 @@ static int http_on_message_begin(http_parser *parser)
 
     client->response->is_chunked = false;
     client->is_chunk_complete = false;
+    http_header_arena_reset(client->response_headers);
     return 0;
 }
 
@@ -243,16 +296,15 @@ static int http_on_status(http_parser *parser, const char *at, size_t length)
 
 static int http_on_header_event(esp_http_client_handle_t client)
 {
-    if (client->current_header_key != NULL && client->current_header_value != NULL) {
-        ESP_LOGD(TAG, "HEADER=%s:%s", client->current_header_key, client->current_header_value);
-        client->event.header_key = client->current_header_key;
-        client->event.header_value = client->current_header_value;
+    const char *key, *value;
+    if (http_header_arena_commit(client->response_headers, &key, &value) == ESP_OK) {
+        ESP_LOGD(TAG, "HEADER=%s:%s", key, value);
+        /* Both point into the header arena, which may be reallocated when the next header is stored,
+           so they are only valid during the event */
+        client->event.header_key = (char *)key;
+        client->event.header_value = (char *)value;
         http_dispatch_event(client, HTTP_EVENT_ON_HEADER, NULL, 0);
         http_dispatch_event_to_event_loop(HTTP_EVENT_ON_HEADER, &client, sizeof(esp_http_client_handle_t));
-        free(client->current_header_key);
-        free(client->current_header_value);
-        client->current_header_key = NULL;
-        client->current_header_value = NULL;
     }
     return 0;
 }
@@ -261,7 +313,7 @@ static int http_on_header_field(http_parser *parser, const char *at, size_t leng
 {
     esp_http_client_t *client = parser->data;
     http_on_header_event(client);
-    HTTP_RET_ON_FALSE_DBG(http_utils_append_string(&client->current_header_key, at, length), -1, TAG, "Failed to append string");
+    HTTP_RET_ON_FALSE_DBG(http_header_arena_append_key(client->response_headers, at, length) == ESP_OK, -1, TAG, "Failed to append string");
 
     return 0;
 }
@@ -269,16 +321,16 @@ static int http_on_header_field(http_parser *parser, const char *at, size_t leng
 static int http_on_header_value(http_parser *parser, const char *at, size_t length)
 {
     esp_http_client_handle_t client = parser->data;
-    if (client->current_header_key == NULL) {
+    const char *header_key = http_header_arena_current_key(client->response_headers);
+    if (header_key == NULL) {
         return 0;
     }
+    HTTP_RET_ON_FALSE_DBG(http_header_arena_append_value(client->response_headers, at, length) == ESP_OK, -1, TAG, "Failed to append string");
 #if CONFIG_ESP_HTTP_CLIENT_ENABLE_GET_CONTENT_RANGE
-    if (strcasecmp(client->current_header_key, "Content-Range") == 0) {
-        HTTP_RET_ON_FALSE_DBG(http_utils_append_string(&client->current_header_value, at, length), -1, TAG, "Failed to append string");
-
+    if (strcasecmp(header_key, "Content-Range") == 0) {
         int64_t total_size = -1;
         client->response->content_range = -1;
-        char *slash_pos = strchr(client->current_header_value, '/');
+        const char *slash_pos = strchr(http_header_arena_current_value(client->response_headers), '/');
 
         if (slash_pos) {
             if (slash_pos[1] == '*') {
@@ -297,15 +349,14 @@ static int http_on_header_value(http_parser *parser, const char *at, size_t leng
         }
     } else
 #endif
-    if (strcasecmp(client->current_header_key, "Location") == 0) {
+    if (strcasecmp(header_key, "Location") == 0) {
         HTTP_RET_ON_FALSE_DBG(http_utils_append_string(&client->location, at, length), -1, TAG, "Failed to append string");
-    } else if (strcasecmp(client->current_header_key, "Transfer-Encoding") == 0
+    } else if (strcasecmp(header_key, "Transfer-Encoding") == 0
                && memcmp(at, "chunked", length) == 0) {
         client->response->is_chunked = true;
-    } else if (strcasecmp(client->current_header_key, "WWW-Authenticate") == 0) {
+    } else if (strcasecmp(header_key, "WWW-Authenticate") == 0) {
         HTTP_RET_ON_FALSE_DBG(http_utils_append_string(&client->auth_header, at, length), -1, TAG, "Failed to append string");
     }
-    HTTP_RET_ON_FALSE_DBG(http_utils_append_string(&client->current_header_value, at, length), -1, TAG, "Failed to append string");
     return 0;
 }
 
@@ -321,7 +372,7 @@ static int http_on_headers_complete(http_parser *parser)
     client->state = HTTP_STATE_RES_COMPLETE_HEADER;
     http_dispatch_event(client, HTTP_EVENT_ON_HEADERS_COMPLETE, NULL, 0);
     http_dispatch_event_to_event_loop(HTTP_EVENT_ON_HEADERS_COMPLETE, &client, sizeof(esp_http_client_handle_t));
-    if (client->connection_info.method == HTTP_METHOD_HEAD) {
+    if (http_client_response_method(client) == HTTP_METHOD_HEAD) {
         /* In a HTTP_RESPONSE parser returning '1' from on_headers_complete will tell the
            parser that it should not expect a body. This is used when receiving a response
            to a HEAD request which may contain 'Content-Length' or 'Transfer-Encoding: chunked'
@@ -336,7 +387,13 @@ static int http_on_body(http_parser *parser, const char *at, size_t length)
     esp_http_client_t *client = parser->data;
     ESP_LOGD(TAG, "http_on_body %zu", length);
 
-    if (client->response->buffer->output_ptr) {
+    if (client->body_cb) {
+        /* Zero-copy delivery, `at` points into the receive buffer of the client */
+        if (client->body_cb(client, at, length, client->body_cb_ctx) != ESP_OK) {
+            ESP_LOGD(TAG, "Body callback aborted the response");
+            return -1;
+        }
+    } else if (client->response->buffer->output_ptr) {
         memcpy(client->response->buffer->output_ptr, (char *)at, length);
         client->response->buffer->output_ptr += length;
     } else {
@@ -360,7 +417,9 @@ static int http_on_body(http_parser *parser, const char *at, size_t length)
     }
 
     client->response->data_process += length;
-    client->response->buffer->raw_len += length;
+    if (!client->body_cb) {
+        client->response->buffer->raw_len += length;
+    }
     http_dispatch_event(client, HTTP_EVENT_ON_DATA, (void *)at, length);
     esp_http_client_on_data_t evt_data = {};
     evt_data.data_process = client->response->data_process;
@@ -374,6 +433,11 @@ static int http_on_message_complete(http_parser *parser)
     ESP_LOGD(TAG, "http_on_message_complete, parser=%p", parser);
     esp_http_client_handle_t client = parser->data;
     client->is_chunk_complete = true;
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+    if (client->pipeline_active) {
+        http_pipeline_on_response_complete(client);
+    }
+#endif
     return 0;
 }
 
@@ -427,6 +491,26 @@ esp_err_t esp_http_client_delete_all_headers(esp_http_client_handle_t client)
     return http_header_clean(client->request->headers);
 }
 
+esp_err_t esp_http_client_get_response_header(esp_http_client_handle_t client, const char *key, const char **value)
+{
+    if (client == NULL || key == NULL || value == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *value = http_header_arena_get(client->response_headers, key);
+    return *value ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t esp_http_client_set_body_callback(esp_http_client_handle_t client, esp_http_client_body_cb_t cb, void *user_ctx)
+{
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->body_cb = cb;
+    client->body_cb_ctx = user_ctx;
+    return ESP_OK;
+}
+
 esp_err_t esp_http_client_get_username(esp_http_client_handle_t client, char **value)
 {
     if (client == NULL || value == NULL) {
@@ -813,7 +897,7 @@ esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *co
                    (client->request->headers       = http_header_init())                             &&
                    (client->request->buffer        = calloc(1, sizeof(esp_http_buffer_t)))           &&
                    (client->response               = calloc(1, sizeof(esp_http_data_t)))             &&
-                   (client->response->headers      = http_header_init())                             &&
+                   (client->response_headers       = http_header_arena_init(CONFIG_ESP_HTTP_CLIENT_RESPONSE_HEADER_ARENA_SIZE)) &&
                    (client->response->buffer       = calloc(1, sizeof(esp_http_buffer_t)))
                );
 
@@ -945,6 +1029,24 @@ esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *co
         ESP_LOGE(TAG, "Error set configurations");
         goto error;
     }
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+    if (config->use_connection_pool) {
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CUSTOM_TRANSPORT
+        if (config->transport) {
+            ESP_LOGW(TAG, "Connection pool is not supported with custom transport");
+        } else
+#endif
+#if CONFIG_ESP_TLS_USE_DS_PERIPHERAL
+        if (config->ds_data) {
+            ESP_LOGW(TAG, "Connection pool is not supported with the DS peripheral");
+        } else
+#endif
+        {
+            client->use_connection_pool = true;
+            client->pool_cfg_id = http_conn_pool_config_id(config);
+        }
+    }
+#endif
     _success = (
                    (client->request->buffer->data  = malloc(client->buffer_size_tx))  &&
                    (client->response->buffer->data = malloc(client->buffer_size_rx))
@@ -1023,6 +1125,10 @@ esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *co
     client->parser_settings->on_chunk_header = http_on_chunk_header;
     client->parser->data = client;
     client->event.client = client;
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+    STAILQ_INIT(&client->pipeline_pending);
+    STAILQ_INIT(&client->pipeline_inflight);
+#endif
 
     client->state = HTTP_STATE_INIT;
 
@@ -1052,6 +1158,10 @@ esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
         return ESP_FAIL;
     }
     esp_http_client_close(client);
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+    http_pipeline_fail_all(client, &client->pipeline_inflight, ESP_ERR_INVALID_STATE);
+    http_pipeline_fail_all(client, &client->pipeline_pending, ESP_ERR_INVALID_STATE);
+#endif
     if (client->transport_list) {
         esp_transport_list_destroy(client->transport_list);
     }
@@ -1064,7 +1174,6 @@ esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
         free(client->request);
     }
     if (client->response) {
-        http_header_destroy(client->response->headers);
         if (client->response->buffer) {
             free(client->response->buffer->data);
             esp_http_client_cached_buf_cleanup(client->response->buffer);
@@ -1080,8 +1189,7 @@ esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
     _clear_connection_info(client);
     _clear_auth_data(client);
     free(client->auth_data);
-    free(client->current_header_key);
-    free(client->current_header_value);
+    http_header_arena_destroy(client->response_headers);
     free(client->location);
     free(client->auth_header);
     free(client);
@@ -1288,6 +1396,18 @@ esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client, int ti
     return ESP_OK;
 }
 
+/* Passes received data to the parser. Returns false if the parser stopped on an error, which includes
+ * a callback returning an error, e.g. the body callback aborting the response. */
+static bool http_client_parse(esp_http_client_handle_t client, const char *data, size_t len)
+{
+    http_parser_execute(client->parser, client->parser_settings, data, len);
+    if (unlikely(HTTP_PARSER_ERRNO(client->parser) != HPE_OK)) {
+        ESP_LOGE(TAG, "Error parsing response: %s", http_errno_description(HTTP_PARSER_ERRNO(client->parser)));
+        return false;
+    }
+    return true;
+}
+
 static int esp_http_client_get_data(esp_http_client_handle_t client)
 {
     if (client->state < HTTP_STATE_RES_ON_DATA_START) {
@@ -1307,8 +1427,8 @@ static int esp_http_client_get_data(esp_http_client_handle_t client)
         // When tls error is ESP_TLS_ERR_SSL_WANT_READ (-0x6900), esp_trasnport_read returns ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT (0x0).
         // We should not execute http_parser_execute() on this condition as it sets the internal state machine in an
         // invalid state.
-        if (!(client->is_async && rlen == 0)) {
-            http_parser_execute(client->parser, client->parser_settings, res_buffer->data, rlen);
+        if (!(client->is_async && rlen == 0) && !http_client_parse(client, res_buffer->data, rlen)) {
+            return ESP_FAIL;
         }
     }
     return rlen;
@@ -1372,7 +1492,8 @@ int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len)
             esp_log_level_t sev = ESP_LOG_WARN;
             /* Check for cleanly closed connection */
             if (rlen == ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN && client->response->is_chunked) {
-                /* Explicit call to parser for invoking `message_complete` callback */
+                /* Explicit call to parser for invoking `message_complete` callback. A parser error here means
+                   the last chunk is missing, which is reported by the completeness check below */
                 http_parser_execute(client->parser, client->parser_settings, res_buffer->data, 0);
                 /* ...and lowering the message severity, as closed connection from server side is expected in chunked transport */
                 sev = ESP_LOG_DEBUG;
@@ -1403,7 +1524,13 @@ int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len)
             return ridx;
         }
         res_buffer->output_ptr = buffer + ridx;
-        http_parser_execute(client->parser, client->parser_settings, res_buffer->data, rlen);
+        if (!http_client_parse(client, res_buffer->data, rlen)) {
+            res_buffer->raw_len = 0;
+            res_buffer->output_ptr = NULL;
+            http_dispatch_event(client, HTTP_EVENT_ERROR, esp_transport_get_error_handle(client->transport), 0);
+            http_dispatch_event_to_event_loop(HTTP_EVENT_ERROR, &client, sizeof(esp_http_client_handle_t));
+            return ESP_FAIL;
+        }
         ridx += res_buffer->raw_len;
         need_read -= res_buffer->raw_len;
 
@@ -1494,6 +1621,10 @@ esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
                 }
                 while (client->response->is_chunked && !client->is_chunk_complete) {
                     int ret = esp_http_client_get_data(client);
+                    if (HTTP_PARSER_ERRNO(client->parser) != HPE_OK) {
+                        err = ESP_ERR_HTTP_INCOMPLETE_DATA;
+                        break;
+                    }
                     if (ret <= 0) {
                         if (client->is_async && errno == EAGAIN) {
                             return ESP_ERR_HTTP_EAGAIN;
@@ -1515,6 +1646,10 @@ esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
                 }
                 while (client->response->data_process < client->response->content_length) {
                     int ret = esp_http_client_get_data(client);
+                    if (HTTP_PARSER_ERRNO(client->parser) != HPE_OK) {
+                        err = ESP_ERR_HTTP_INCOMPLETE_DATA;
+                        break;
+                    }
                     if (ret <= 0) {
                         if (client->is_async && errno == EAGAIN) {
                             return ESP_ERR_HTTP_EAGAIN;
@@ -1548,6 +1683,16 @@ esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
                     ESP_LOGD(TAG, "Close connection");
                     esp_http_client_close(client);
                 } else {
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+                    if (client->use_connection_pool) {
+                        /* Only a fully consumed response leaves the connection in a reusable state */
+                        if (err == ESP_OK && client->is_chunk_complete) {
+                            http_client_pool_checkin(client);
+                        } else {
+                            esp_http_client_close(client);
+                        }
+                    } else
+#endif
                     if (client->state > HTTP_STATE_CONNECTED) {
                         client->state = HTTP_STATE_CONNECTED;
                         client->first_line_prepared = false;
@@ -1582,7 +1727,9 @@ int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client)
             }
             return ESP_FAIL;
         }
-        http_parser_execute(client->parser, client->parser_settings, buffer->data, buffer->len);
+        if (!http_client_parse(client, buffer->data, buffer->len)) {
+            return ESP_FAIL;
+        }
     }
     client->state = HTTP_STATE_RES_ON_DATA_START;
     ESP_LOGD(TAG, "content_length = %"PRId64, client->response->content_length);
@@ -1593,6 +1740,44 @@ int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client)
     return client->response->content_length;
 }
 
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+static bool http_client_pool_checkout(esp_http_client_handle_t client)
+{
+    char key[HTTP_CONN_POOL_KEY_LEN];
+    esp_transport_ssl_conn_t conn;
+
+    if (!http_conn_pool_make_key(key, sizeof(key), client->connection_info.scheme, client->connection_info.host,
+                                 client->connection_info.port, client->pool_cfg_id)) {
+        return false;
+    }
+    if (!http_conn_pool_acquire(key, &conn)) {
+        return false;
+    }
+    if (esp_transport_ssl_attach_connection(client->transport, &conn) != ESP_OK) {
+        esp_transport_ssl_conn_close(&conn);
+        return false;
+    }
+    ESP_LOGD(TAG, "Reusing pooled connection to %s", key);
+    return true;
+}
+
+static void http_client_pool_checkin(esp_http_client_handle_t client)
+{
+    char key[HTTP_CONN_POOL_KEY_LEN];
+    esp_transport_ssl_conn_t conn;
+
+    if (!http_conn_pool_make_key(key, sizeof(key), client->connection_info.scheme, client->connection_info.host,
+                                 client->connection_info.port, client->pool_cfg_id) ||
+            esp_transport_ssl_detach_connection(client->transport, &conn) != ESP_OK) {
+        esp_http_client_close(client);
+        return;
+    }
+    http_conn_pool_release(key, &conn);
+    /* The connection now belongs to the pool, the next request of this client checks it out again */
+    client->state = HTTP_STATE_INIT;
+}
+#endif // CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+
 static esp_err_t esp_http_client_connect(esp_http_client_handle_t client)
 {
     esp_err_t err;
@@ -1634,7 +1819,13 @@ static esp_err_t esp_http_client_connect(esp_http_client_handle_t client)
 #endif
             return ESP_ERR_HTTP_INVALID_TRANSPORT;
         }
-        if (!client->is_async) {
+        bool reused = false;
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+        reused = client->use_connection_pool && http_client_pool_checkout(client);
+#endif
+        if (reused) {
+            ESP_LOGD(TAG, "Connected using pooled connection");
+        } else if (!client->is_async) {
             if (esp_transport_connect(client->transport, client->connection_info.host, client->connection_info.port, client->timeout_ms) < 0) {
                 ESP_LOGE(TAG, "Connection failed, sock < 0");
                 return ESP_ERR_HTTP_CONNECT;
@@ -1653,6 +1844,11 @@ static esp_err_t esp_http_client_connect(esp_http_client_handle_t client)
                 return ESP_ERR_HTTP_CONNECTING;
             }
         }
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+        if (client->use_connection_pool && !reused) {
+            http_conn_pool_count_handshake();
+        }
+#endif
         client->state = HTTP_STATE_CONNECTED;
         http_dispatch_event(client, HTTP_EVENT_ON_CONNECTED, NULL, 0);
         http_dispatch_event_to_event_loop(HTTP_EVENT_ON_CONNECTED, &client, sizeof(esp_http_client_handle_t));
@@ -2065,3 +2261,316 @@ esp_http_state_t esp_http_client_get_state(esp_http_client_handle_t client)
     }
     return client->state;
 }
+
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+static void http_pipeline_complete(esp_http_client_handle_t client, http_pipeline_req_t *req, esp_err_t result)
+{
+    if (req->on_complete) {
+        req->on_complete(client, result, req->user_ctx);
+    }
+    free(req->raw);
+    free(req);
+}
+
+static void http_pipeline_fail_all(esp_http_client_handle_t client, struct http_pipeline_list *list, esp_err_t err)
+{
+    http_pipeline_req_t *req;
+    while ((req = STAILQ_FIRST(list)) != NULL) {
+        STAILQ_REMOVE_HEAD(list, next);
+        http_pipeline_complete(client, req, err);
+    }
+    if (list == &client->pipeline_inflight) {
+        client->pipeline_inflight_count = 0;
+        client->pipeline_inflight_unsafe = false;
+    }
+}
+
+/* Methods whose request can be sent again if the connection is lost before the response (RFC 7231 4.2.2) */
+static bool http_pipeline_method_is_idempotent(esp_http_client_method_t method)
+{
+    switch (method) {
+    case HTTP_METHOD_GET:
+    case HTTP_METHOD_HEAD:
+    case HTTP_METHOD_OPTIONS:
+    case HTTP_METHOD_PUT:
+    case HTTP_METHOD_DELETE:
+    case HTTP_METHOD_PROPFIND:
+    case HTTP_METHOD_REPORT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void http_pipeline_on_response_complete(esp_http_client_handle_t client)
+{
+    http_pipeline_req_t *req = STAILQ_FIRST(&client->pipeline_inflight);
+    if (req == NULL) {
+        return;
+    }
+    client->state = HTTP_STATE_CONNECTED;
+    if (!http_should_keep_alive(client->parser)) {
+        /* The server will not answer the requests which follow this one */
+        client->pipeline_conn_closing = true;
+    }
+    /* Dispatch before dequeuing, so that esp_http_client_pipeline_get_user_ctx() still refers to this request */
+    http_dispatch_event(client, HTTP_EVENT_ON_FINISH, NULL, 0);
+    http_dispatch_event_to_event_loop(HTTP_EVENT_ON_FINISH, &client, sizeof(esp_http_client_handle_t));
+    STAILQ_REMOVE_HEAD(&client->pipeline_inflight, next);
+    client->pipeline_inflight_count--;
+    if (!http_pipeline_method_is_idempotent(req->method)) {
+        client->pipeline_inflight_unsafe = false;
+    }
+    http_pipeline_complete(client, req, ESP_OK);
+}
+
+/* Put the unanswered idempotent requests back in front of the queue, so that they are sent again on a new
+ * connection. The server may have processed the others, they fail instead (RFC 7230 6.3.1). */
+static void http_pipeline_requeue_inflight(esp_http_client_handle_t client)
+{
+    struct http_pipeline_list retry = STAILQ_HEAD_INITIALIZER(retry);
+    http_pipeline_req_t *req;
+    while ((req = STAILQ_FIRST(&client->pipeline_inflight)) != NULL) {
+        STAILQ_REMOVE_HEAD(&client->pipeline_inflight, next);
+        if (http_pipeline_method_is_idempotent(req->method)) {
+            STAILQ_INSERT_TAIL(&retry, req, next);
+        } else {
+            http_pipeline_complete(client, req, ESP_ERR_HTTP_CONNECTION_CLOSED);
+        }
+    }
+    STAILQ_CONCAT(&retry, &client->pipeline_pending);
+    STAILQ_CONCAT(&client->pipeline_pending, &retry);
+    client->pipeline_inflight_count = 0;
+    client->pipeline_inflight_unsafe = false;
+    STAILQ_FOREACH(req, &client->pipeline_pending, next) {
+        req->raw_written = 0;
+    }
+}
+
+esp_err_t esp_http_client_pipeline_enqueue(esp_http_client_handle_t client, const esp_http_client_pipeline_req_t *req)
+{
+    if (client == NULL || req == NULL || req->method < 0 || req->method >= HTTP_METHOD_MAX || req->data_len < 0 ||
+            (req->data_len > 0 && req->data == NULL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* The Content-Length of the queued request is only set while it is serialized,
+     * the header of the client is restored afterwards for esp_http_client_perform() */
+    char *value = NULL;
+    char *client_length = NULL;
+    http_header_get(client->request->headers, "Content-Length", &value);
+    if (value) {
+        client_length = strdup(value);
+        ESP_RETURN_ON_FALSE(client_length, ESP_ERR_NO_MEM, TAG, "Memory exhausted");
+    }
+
+    const bool length_required = (req->method != HTTP_METHOD_GET &&
+                                  req->method != HTTP_METHOD_HEAD &&
+                                  req->method != HTTP_METHOD_DELETE);
+    esp_err_t ret = ESP_OK;
+    http_pipeline_req_t *entry = NULL;
+    if (req->data_len != 0 || length_required) {
+        ESP_GOTO_ON_FALSE(http_header_set_format(client->request->headers, "Content-Length", "%d", req->data_len) > 0,
+                          ESP_ERR_NO_MEM, restore, TAG, "Failed to set Content-Length");
+    } else {
+        http_header_delete(client->request->headers, "Content-Length");
+    }
+
+    const char *path = req->path ? req->path : client->connection_info.path;
+    const char *query = req->path ? NULL : client->connection_info.query;
+    const char *method = HTTP_METHOD_MAPPING[req->method];
+    int first_line_len = snprintf(NULL, 0, "%s %s%s%s %s\r\n", method, path,
+                                  query ? "?" : "", query ? query : "", DEFAULT_HTTP_PROTOCOL);
+    int headers_len = http_header_get_string_len(client->request->headers);
+
+    entry = calloc(1, sizeof(http_pipeline_req_t));
+    ESP_GOTO_ON_FALSE(entry, ESP_ERR_NO_MEM, restore, TAG, "Memory exhausted");
+    /* +1 for the null terminator written by snprintf() */
+    entry->raw = malloc(first_line_len + headers_len + req->data_len + 1);
+    ESP_GOTO_ON_FALSE(entry->raw, ESP_ERR_NO_MEM, restore, TAG, "Memory exhausted");
+    snprintf(entry->raw, first_line_len + 1, "%s %s%s%s %s\r\n", method, path,
+             query ? "?" : "", query ? query : "", DEFAULT_HTTP_PROTOCOL);
+    int wlen = headers_len + 1;
+    if (http_header_generate_string(client->request->headers, 0, entry->raw + first_line_len, &wlen) == 0) {
+        /* No headers at all, only terminate the header section */
+        memcpy(entry->raw + first_line_len, "\r\n", 2);
+        wlen = 2;
+    }
+    if (req->data_len > 0) {
+        memcpy(entry->raw + first_line_len + wlen, req->data, req->data_len);
+    }
+    entry->raw_len = first_line_len + wlen + req->data_len;
+    entry->method = req->method;
+    entry->on_complete = req->on_complete;
+    entry->user_ctx = req->user_ctx;
+    STAILQ_INSERT_TAIL(&client->pipeline_pending, entry, next);
+
+restore:
+    if (ret != ESP_OK) {
+        free(entry);
+    }
+    if (client_length) {
+        if (http_header_set(client->request->headers, "Content-Length", client_length) != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to restore Content-Length");
+        }
+        free(client_length);
+    } else {
+        http_header_delete(client->request->headers, "Content-Length");
+    }
+    return ret;
+}
+
+static esp_err_t http_pipeline_send(esp_http_client_handle_t client)
+{
+    http_pipeline_req_t *req;
+    while ((req = STAILQ_FIRST(&client->pipeline_pending)) != NULL &&
+            client->pipeline_inflight_count < CONFIG_ESP_HTTP_CLIENT_PIPELINE_DEPTH) {
+        /* A non-idempotent request is never pipelined: it waits for the requests in flight,
+         * and the next requests wait for its response (RFC 7230 6.3.2) */
+        const bool idempotent = http_pipeline_method_is_idempotent(req->method);
+        if (client->pipeline_inflight_count > 0 && (client->pipeline_inflight_unsafe || !idempotent)) {
+            break;
+        }
+        int wret = esp_transport_write(client->transport, req->raw + req->raw_written, req->raw_len - req->raw_written,
+                                       client->is_async ? 0 : client->timeout_ms);
+        if (wret < 0 || (wret == 0 && !client->is_async)) {
+            ESP_LOGE(TAG, "Error write pipelined request");
+            return ESP_ERR_HTTP_WRITE_DATA;
+        }
+        if (wret == 0) {
+            /* Socket buffer full, retry on the next poll */
+            break;
+        }
+        req->raw_written += wret;
+        if (req->raw_written == req->raw_len) {
+            STAILQ_REMOVE_HEAD(&client->pipeline_pending, next);
+            STAILQ_INSERT_TAIL(&client->pipeline_inflight, req, next);
+            client->pipeline_inflight_count++;
+            client->pipeline_inflight_unsafe = !idempotent;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t http_pipeline_receive(esp_http_client_handle_t client, int timeout_ms, bool *received)
+{
+    esp_http_buffer_t *buffer = client->response->buffer;
+
+    *received = false;
+    if (STAILQ_EMPTY(&client->pipeline_inflight)) {
+        return ESP_OK;
+    }
+    int rlen = esp_transport_read(client->transport, buffer->data, client->buffer_size_rx, timeout_ms);
+    if (rlen == ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT) {
+        return ESP_OK;
+    }
+    if (rlen < 0) {
+        ESP_LOGE(TAG, "Connection lost with %d pipelined requests in flight", client->pipeline_inflight_count);
+        return rlen == ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN ? ESP_ERR_HTTP_CONNECTION_CLOSED : ESP_ERR_HTTP_FETCH_HEADER;
+    }
+    *received = true;
+    client->pipeline_active = true;
+    http_parser_execute(client->parser, client->parser_settings, buffer->data, rlen);
+    client->pipeline_active = false;
+    client->response->buffer->raw_len = 0;
+    if (client->pipeline_conn_closing) {
+        /* Remaining data after the last response is meaningless, requests in flight were not processed */
+        return ESP_OK;
+    }
+    if (HTTP_PARSER_ERRNO(client->parser) != HPE_OK) {
+        ESP_LOGE(TAG, "Error parsing pipelined response: %s", http_errno_description(HTTP_PARSER_ERRNO(client->parser)));
+        return ESP_ERR_HTTP_FETCH_HEADER;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t http_pipeline_step(esp_http_client_handle_t client, int timeout_ms, bool *received)
+{
+    esp_err_t err;
+
+    *received = false;
+    if (STAILQ_EMPTY(&client->pipeline_pending) && STAILQ_EMPTY(&client->pipeline_inflight)) {
+        return ESP_OK;
+    }
+    if (client->state < HTTP_STATE_CONNECTED) {
+        /* Requests in flight on a connection which has been closed will never be answered */
+        http_pipeline_fail_all(client, &client->pipeline_inflight, ESP_ERR_HTTP_CONNECTION_CLOSED);
+        if ((err = esp_http_client_connect(client)) != ESP_OK) {
+            if (client->is_async && err == ESP_ERR_HTTP_CONNECTING) {
+                return ESP_ERR_HTTP_EAGAIN;
+            }
+            http_dispatch_event(client, HTTP_EVENT_ERROR, esp_transport_get_error_handle(client->transport), 0);
+            http_dispatch_event_to_event_loop(HTTP_EVENT_ERROR, &client, sizeof(esp_http_client_handle_t));
+            return err;
+        }
+        client->pipeline_conn_closing = false;
+    }
+
+    /* Response bodies are delivered through HTTP_EVENT_ON_DATA only */
+    client->cache_data_in_fetch_hdr = 0;
+    err = http_pipeline_send(client);
+    if (err == ESP_OK) {
+        err = http_pipeline_receive(client, timeout_ms, received);
+    }
+    client->cache_data_in_fetch_hdr = 1;
+
+    if (err != ESP_OK) {
+        http_dispatch_event(client, HTTP_EVENT_ERROR, esp_transport_get_error_handle(client->transport), 0);
+        http_dispatch_event_to_event_loop(HTTP_EVENT_ERROR, &client, sizeof(esp_http_client_handle_t));
+        http_pipeline_fail_all(client, &client->pipeline_inflight, err);
+        esp_http_client_close(client);
+        return err;
+    }
+    if (client->pipeline_conn_closing) {
+        ESP_LOGD(TAG, "Server closes the connection, %d pipelined requests are not answered", client->pipeline_inflight_count);
+        http_pipeline_requeue_inflight(client);
+        esp_http_client_close(client);
+    }
+    if (STAILQ_EMPTY(&client->pipeline_pending) && STAILQ_EMPTY(&client->pipeline_inflight)) {
+        return ESP_OK;
+    }
+    return ESP_ERR_HTTP_EAGAIN;
+}
+
+esp_err_t esp_http_client_pipeline_poll(esp_http_client_handle_t client, int timeout_ms)
+{
+    bool received;
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return http_pipeline_step(client, timeout_ms, &received);
+}
+
+esp_err_t esp_http_client_pipeline_perform(esp_http_client_handle_t client)
+{
+    esp_err_t err;
+    bool received;
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    do {
+        int inflight = client->pipeline_inflight_count;
+        err = http_pipeline_step(client, client->timeout_ms, &received);
+        if (err == ESP_ERR_HTTP_EAGAIN && client->is_async && client->state < HTTP_STATE_CONNECTED) {
+            return err;
+        }
+        if (err == ESP_ERR_HTTP_EAGAIN && inflight > 0 && !received) {
+            ESP_LOGE(TAG, "Timed out waiting for pipelined responses");
+            http_dispatch_event(client, HTTP_EVENT_ERROR, esp_transport_get_error_handle(client->transport), 0);
+            http_dispatch_event_to_event_loop(HTTP_EVENT_ERROR, &client, sizeof(esp_http_client_handle_t));
+            http_pipeline_fail_all(client, &client->pipeline_inflight, ESP_ERR_HTTP_READ_TIMEOUT);
+            esp_http_client_close(client);
+            return ESP_ERR_HTTP_READ_TIMEOUT;
+        }
+    } while (err == ESP_ERR_HTTP_EAGAIN);
+    return err;
+}
+
+void *esp_http_client_pipeline_get_user_ctx(esp_http_client_handle_t client)
+{
+    if (client == NULL || !client->pipeline_active || STAILQ_EMPTY(&client->pipeline_inflight)) {
+        return NULL;
+    }
+    return STAILQ_FIRST(&client->pipeline_inflight)->user_ctx;
+}
+#endif // CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
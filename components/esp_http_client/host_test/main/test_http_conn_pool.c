@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "sdkconfig.h"
+#include "esp_http_client.h"
+#include "unity.h"
+
+#define POOL_TEST_REQUESTS  (4)
+
+typedef struct {
+    int listen_sock;
+    int max_connections;        /*!< The server exits once it has served this number of connections */
+    bool close_after_response;  /*!< Close each connection after its first response, once `close_now` is posted */
+    sem_t close_now;
+    sem_t closed;
+    int accepted;
+    int served;
+    pthread_t thread;
+} pool_test_server_t;
+
+/* Minimal keep-alive HTTP/1.1 server on loopback, runs outside of the FreeRTOS scheduler */
+static void *pool_test_server_thread(void *arg)
+{
+    pool_test_server_t *server = arg;
+    static const char response[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+    char buf[512];
+
+    while (server->accepted < server->max_connections) {
+        int sock = accept(server->listen_sock, NULL, NULL);
+        if (sock < 0) {
+            break;
+        }
+        server->accepted++;
+        int len = 0;
+        while (true) {
+            int ret = recv(sock, buf + len, sizeof(buf) - len - 1, 0);
+            if (ret <= 0) {
+                break;
+            }
+            len += ret;
+            buf[len] = 0;
+            if (strstr(buf, "\r\n\r\n") == NULL) {
+                continue;
+            }
+            send(sock, response, sizeof(response) - 1, 0);
+            server->served++;
+            len = 0;
+            if (server->close_after_response) {
+                sem_wait(&server->close_now);
+                break;
+            }
+        }
+        close(sock);
+        if (server->close_after_response) {
+            sem_post(&server->closed);
+        }
+    }
+    return NULL;
+}
+
+static void pool_test_server_start(pool_test_server_t *server, char *url, size_t url_len)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    socklen_t addr_len = sizeof(addr);
+    server->listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, server->listen_sock);
+    TEST_ASSERT_EQUAL(0, bind(server->listen_sock, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(server->listen_sock, 1));
+    TEST_ASSERT_EQUAL(0, getsockname(server->listen_sock, (struct sockaddr *)&addr, &addr_len));
+    snprintf(url, url_len, "http://127.0.0.1:%d/get", ntohs(addr.sin_port));
+    TEST_ASSERT_EQUAL(0, sem_init(&server->close_now, 0, 0));
+    TEST_ASSERT_EQUAL(0, sem_init(&server->closed, 0, 0));
+    TEST_ASSERT_EQUAL(0, pthread_create(&server->thread, NULL, pool_test_server_thread, server));
+}
+
+static void pool_test_server_stop(pool_test_server_t *server)
+{
+    TEST_ASSERT_EQUAL(0, pthread_join(server->thread, NULL));
+    close(server->listen_sock);
+    sem_destroy(&server->close_now);
+    sem_destroy(&server->closed);
+}
+
+TEST_CASE("Keep-alive connections are shared between clients through the connection pool", "[esp_http_client]")
+{
+    pool_test_server_t server = { .max_connections = 1 };
+    char url[64];
+    pool_test_server_start(&server, url, sizeof(url));
+
+    esp_http_client_pool_stats_t before, after;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_flush());
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_get_stats(&before));
+
+    esp_http_client_config_t config = {
+        .url = url,
+        .use_connection_pool = true,
+    };
+    esp_http_client_handle_t clients[2];
+    for (int i = 0; i < 2; i++) {
+        clients[i] = esp_http_client_init(&config);
+        TEST_ASSERT_NOT_NULL(clients[i]);
+    }
+    /* Alternate the handles, all requests have to go over the single pooled connection */
+    for (int i = 0; i < POOL_TEST_REQUESTS; i++) {
+        esp_http_client_handle_t client = clients[i % 2];
+        TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+        TEST_ASSERT_EQUAL(200, esp_http_client_get_status_code(client));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_get_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(1, after.handshakes - before.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(POOL_TEST_REQUESTS - 1, after.hits - before.hits);
+    TEST_ASSERT_EQUAL_UINT32(0, after.expired - before.expired);
+    TEST_ASSERT_EQUAL_UINT32(1, after.idle);
+
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(clients[i]));
+    }
+    /* Closing the pooled connection lets the server exit */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_flush());
+    pool_test_server_stop(&server);
+    TEST_ASSERT_EQUAL(1, server.accepted);
+    TEST_ASSERT_EQUAL(POOL_TEST_REQUESTS, server.served);
+}
+
+TEST_CASE("Pooled connections closed by the server are counted as expired, not as hits", "[esp_http_client]")
+{
+    pool_test_server_t server = { .max_connections = 2, .close_after_response = true };
+    char url[64];
+    pool_test_server_start(&server, url, sizeof(url));
+
+    esp_http_client_pool_stats_t before, after;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_flush());
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_get_stats(&before));
+
+    esp_http_client_config_t config = {
+        .url = url,
+        .use_connection_pool = true,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+
+    /* The connection is parked, then closed by the server while it is idle */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_get_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(1, after.idle);
+    sem_post(&server.close_now);
+    sem_wait(&server.closed);
+
+    /* The stale connection is dropped when taken out of the pool, and a new one is made */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+    TEST_ASSERT_EQUAL(200, esp_http_client_get_status_code(client));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_get_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(2, after.handshakes - before.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(0, after.hits - before.hits);
+    TEST_ASSERT_EQUAL_UINT32(1, after.expired - before.expired);
+    TEST_ASSERT_EQUAL_UINT32(2, after.misses - before.misses);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+    sem_post(&server.close_now);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_flush());
+    pool_test_server_stop(&server);
+    TEST_ASSERT_EQUAL(2, server.accepted);
+}
+
+TEST_CASE("Pooled connections are not shared when a certificate buffer is reused with other contents", "[esp_http_client]")
+{
+    pool_test_server_t server = { .max_connections = 2, .close_after_response = true };
+    char url[64];
+    pool_test_server_start(&server, url, sizeof(url));
+
+    esp_http_client_pool_stats_t before, after;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_flush());
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_get_stats(&before));
+
+    /* The same buffer, so the same address, holds the trust settings of both clients */
+    char cert_pem[] = "-----BEGIN CERTIFICATE-----\nfirst\n-----END CERTIFICATE-----\n";
+    esp_http_client_config_t config = {
+        .url = url,
+        .use_connection_pool = true,
+        .cert_pem = cert_pem,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+    /* Let the server take the next connection, the parked one is then found closed if it is looked at */
+    sem_post(&server.close_now);
+    sem_wait(&server.closed);
+
+    memcpy(strstr(cert_pem, "first"), "other", strlen("other"));
+    client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_get_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(2, after.handshakes - before.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(2, after.misses - before.misses);
+    TEST_ASSERT_EQUAL_UINT32(0, after.hits - before.hits);
+    TEST_ASSERT_EQUAL_UINT32(0, after.expired - before.expired);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+
+    sem_post(&server.close_now);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pool_flush());
+    pool_test_server_stop(&server);
+    TEST_ASSERT_EQUAL(2, server.accepted);
+}
+
+void app_main(void)
+{
+    unity_run_menu();
+}
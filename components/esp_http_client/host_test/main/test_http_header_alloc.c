@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "sdkconfig.h"
+#include "esp_http_client.h"
+#include "unity.h"
+
+#define ALLOC_TEST_REQUESTS     (4)
+#define ALLOC_TEST_HEADERS      (12)
+
+/* Allocations are counted with -Wl,--wrap (see CMakeLists.txt), only on the thread which enabled counting */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static __thread bool s_counting;
+static __thread int s_alloc_count;
+
+void *__wrap_malloc(size_t size)
+{
+    s_alloc_count += s_counting;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    s_alloc_count += s_counting;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    s_alloc_count += s_counting;
+    return __real_realloc(ptr, size);
+}
+
+typedef struct {
+    int listen_sock;
+    int served;
+    pthread_t thread;
+} alloc_test_server_t;
+
+/* Keep-alive server, every other response carries ALLOC_TEST_HEADERS extra headers */
+static void *alloc_test_server_thread(void *arg)
+{
+    alloc_test_server_t *server = arg;
+    char buf[512];
+    char response[1024];
+
+    int sock = accept(server->listen_sock, NULL, NULL);
+    if (sock < 0) {
+        return NULL;
+    }
+    int len = 0;
+    while (server->served < ALLOC_TEST_REQUESTS) {
+        int ret = recv(sock, buf + len, sizeof(buf) - len - 1, 0);
+        if (ret <= 0) {
+            break;
+        }
+        len += ret;
+        buf[len] = 0;
+        char *end = strstr(buf, "\r\n\r\n");
+        /* The request body is "ok", it follows the headers */
+        if (end == NULL || strlen(end + 4) < 2) {
+            continue;
+        }
+        int n = snprintf(response, sizeof(response), "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n");
+        for (int i = 0; server->served % 2 && i < ALLOC_TEST_HEADERS; i++) {
+            n += snprintf(response + n, sizeof(response) - n, "X-Test-Header-%02d: value-of-header-%02d\r\n", i, i);
+        }
+        n += snprintf(response + n, sizeof(response) - n, "\r\nok");
+        send(sock, response, n, 0);
+        server->served++;
+        len = 0;
+    }
+    close(sock);
+    return NULL;
+}
+
+static int alloc_test_count_perform(esp_http_client_handle_t client)
+{
+    s_alloc_count = 0;
+    s_counting = true;
+    esp_err_t err = esp_http_client_perform(client);
+    s_counting = false;
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(200, esp_http_client_get_status_code(client));
+    return s_alloc_count;
+}
+
+TEST_CASE("Response headers do not allocate once the header buffer has grown", "[esp_http_client]")
+{
+    alloc_test_server_t server = { 0 };
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    socklen_t addr_len = sizeof(addr);
+    char url[64];
+    server.listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, server.listen_sock);
+    TEST_ASSERT_EQUAL(0, bind(server.listen_sock, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(server.listen_sock, 1));
+    TEST_ASSERT_EQUAL(0, getsockname(server.listen_sock, (struct sockaddr *)&addr, &addr_len));
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d/post", ntohs(addr.sin_port));
+    TEST_ASSERT_EQUAL(0, pthread_create(&server.thread, NULL, alloc_test_server_thread, &server));
+
+    esp_http_client_config_t config = {
+        .url = url,
+        .method = HTTP_METHOD_POST,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_set_post_field(client, "ok", 2));
+
+    /* The first two requests open the connection and grow the header buffer */
+    alloc_test_count_perform(client);
+    int grow = alloc_test_count_perform(client);
+    int few = alloc_test_count_perform(client);
+    int many = alloc_test_count_perform(client);
+    printf("Allocations per request: %d with %d more headers, then %d without and %d with them\n",
+           grow, ALLOC_TEST_HEADERS, few, many);
+    /* Both the parsed response headers and the Content-Length request header are stored without allocating */
+    TEST_ASSERT_EQUAL(few, many);
+    TEST_ASSERT_LESS_THAN(grow, many);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+    TEST_ASSERT_EQUAL(0, pthread_join(server.thread, NULL));
+    close(server.listen_sock);
+    TEST_ASSERT_EQUAL(ALLOC_TEST_REQUESTS, server.served);
+}
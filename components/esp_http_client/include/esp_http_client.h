@@ -56,8 +56,8 @@ typedef struct esp_http_client_event {
     void *data;                             /*!< data of the event */
     int data_len;                           /*!< data length of data */
     void *user_data;                        /*!< user_data context, from esp_http_client_config_t user_data */
-    char *header_key;                       /*!< For HTTP_EVENT_ON_HEADER event_id, it's store current http header key */
-    char *header_value;                     /*!< For HTTP_EVENT_ON_HEADER event_id, it's store current http header value */
+    char *header_key;                       /*!< For HTTP_EVENT_ON_HEADER event_id, it's store current http header key, valid during the event only */
+    char *header_value;                     /*!< For HTTP_EVENT_ON_HEADER event_id, it's store current http header value, valid during the event only */
 } esp_http_client_event_t;
 
 /**
@@ -250,6 +250,10 @@ typedef struct {
     struct esp_transport_item_t *transport;
 #endif
     esp_http_client_addr_type_t addr_type;  /*!< Address type used in http client configurations */
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+    bool use_connection_pool;               /*!< Share keep-alive connections with other clients through the connection pool,
+                                                 see CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL */
+#endif
 
 #if CONFIG_MBEDTLS_DYNAMIC_BUFFER
     esp_http_client_tls_dyn_buf_strategy_t tls_dyn_buf_strategy; /*!< TLS dynamic buffer strategy */
@@ -592,6 +596,53 @@ esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const c
  */
 esp_err_t esp_http_client_delete_all_headers(esp_http_client_handle_t client);
 
+/**
+ * @brief      Get a header of the last received response.
+ *             Response headers are kept in a buffer owned by the client; the returned pointer stays valid
+ *             until the next response starts to be received or the client is cleaned up.
+ *
+ * @param[in]  client  The esp_http_client handle
+ * @param[in]  key     The header name, compared case-insensitively
+ * @param[out] value   The header value, NULL if the response has no such header
+ *
+ * @return
+ *  - ESP_OK
+ *  - ESP_ERR_NOT_FOUND if the response has no such header
+ *  - ESP_ERR_INVALID_ARG
+ */
+esp_err_t esp_http_client_get_response_header(esp_http_client_handle_t client, const char *key, const char **value);
+
+/**
+ * @brief   Response body callback
+ *
+ * @param[in]  client    The esp_http_client handle
+ * @param[in]  data      Body data, pointing directly into the receive buffer of the client (chunk framing removed)
+ * @param[in]  len       Length of data
+ * @param[in]  user_ctx  User context passed to esp_http_client_set_body_callback
+ *
+ * @return  ESP_OK to continue; any other value aborts the response, the call receiving it
+ *          (esp_http_client_perform, esp_http_client_fetch_headers, ...) then fails immediately
+ */
+typedef esp_err_t (*esp_http_client_body_cb_t)(esp_http_client_handle_t client, const char *data, size_t len, void *user_ctx);
+
+/**
+ * @brief      Deliver the response body to a callback without copying it.
+ *             While a callback is set, body data is passed to it as soon as it is parsed, straight from the
+ *             receive buffer, and is neither cached nor copied to the buffer of `esp_http_client_read`
+ *             (which then returns 0). Drive the transfer with `esp_http_client_perform`, or with
+ *             `esp_http_client_fetch_headers` followed by `esp_http_client_flush_response`.
+ *             The data is only valid during the callback.
+ *
+ * @param[in]  client    The esp_http_client handle
+ * @param[in]  cb        The callback, NULL to restore the default behavior
+ * @param[in]  user_ctx  User context passed to the callback
+ *
+ * @return
+ *  - ESP_OK
+ *  - ESP_ERR_INVALID_ARG
+ */
+esp_err_t esp_http_client_set_body_callback(esp_http_client_handle_t client, esp_http_client_body_cb_t cb, void *user_ctx);
+
 /**
  * @brief      This function will be open the connection, write all header strings and return
  *
@@ -865,6 +916,136 @@ esp_err_t esp_http_client_get_chunk_length(esp_http_client_handle_t client, int
  */
 esp_http_state_t esp_http_client_get_state(esp_http_client_handle_t client);
 
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+/**
+ * @brief      Completion callback of a pipelined request
+ *
+ *             Called once the response of the request has been fully received, or when the request fails.
+ *             The status code and headers of the response can be read with the usual getters from this callback.
+ *
+ * @param[in]  client    The esp_http_client handle
+ * @param[in]  result    ESP_OK if the response has been received, error code otherwise
+ * @param[in]  user_ctx  User context of the request
+ */
+typedef void (*esp_http_client_pipeline_cb_t)(esp_http_client_handle_t client, esp_err_t result, void *user_ctx);
+
+/**
+ * @brief      Pipelined request description
+ */
+typedef struct {
+    esp_http_client_method_t        method;         /*!< HTTP method */
+    const char                      *path;          /*!< Path, including the query string if any. NULL to use the path and query of the client */
+    const char                      *data;          /*!< Request body, copied when the request is queued. May be NULL */
+    int                             data_len;       /*!< Length of the request body */
+    esp_http_client_pipeline_cb_t   on_complete;    /*!< Completion callback, may be NULL */
+    void                            *user_ctx;      /*!< User context passed to the callback */
+} esp_http_client_pipeline_req_t;
+
+/**
+ * @brief      Queue a request for pipelined execution
+ *
+ *             The request line and the current request headers of the client are serialized at this point, so the
+ *             headers can be modified for the next request right after this call. The Content-Length header is
+ *             generated for this request only, the one of the client is left unchanged. The request is sent by
+ *             esp_http_client_pipeline_perform() or esp_http_client_pipeline_poll().
+ *
+ * @note       Responses are delivered through the event handler as for esp_http_client_perform(), followed by
+ *             HTTP_EVENT_ON_FINISH and the completion callback of the request.
+ *
+ * @note       Only idempotent requests (GET, HEAD, OPTIONS, PUT, DELETE, PROPFIND and REPORT) are pipelined. Other
+ *             requests are sent once the responses in flight have been received, and the next requests wait for
+ *             their response (RFC 7230 6.3.2). When the server announces that it closes the connection, the
+ *             idempotent requests it did not answer are sent again on a new connection, and the others complete
+ *             with ESP_ERR_HTTP_CONNECTION_CLOSED. Requests in flight when the connection is lost complete with
+ *             the error.
+ *
+ * @param[in]  client  The esp_http_client handle
+ * @param[in]  req     Request description
+ *
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if the arguments are invalid
+ *     - ESP_ERR_NO_MEM if the request could not be stored
+ */
+esp_err_t esp_http_client_pipeline_enqueue(esp_http_client_handle_t client, const esp_http_client_pipeline_req_t *req);
+
+/**
+ * @brief      Make progress on the queued requests without blocking for longer than timeout_ms
+ *
+ *             Connects if needed, sends as many queued requests as the pipeline depth allows and processes
+ *             the response data which is available. Meant to be called repeatedly, e.g. from an event loop.
+ *             With `is_async` set in the client configuration, connecting and sending do not block either.
+ *
+ * @param[in]  client      The esp_http_client handle
+ * @param[in]  timeout_ms  Maximum time to wait for response data, 0 to only process data already received
+ *
+ * @return
+ *     - ESP_OK if all queued requests have completed
+ *     - ESP_ERR_HTTP_EAGAIN if requests are still pending
+ *     - ESP_ERR_INVALID_ARG if the client is NULL
+ *     - other errors if the connection failed, requests in flight have been completed with this error
+ */
+esp_err_t esp_http_client_pipeline_poll(esp_http_client_handle_t client, int timeout_ms);
+
+/**
+ * @brief      Execute all queued requests, blocking until they have completed
+ *
+ * @param[in]  client  The esp_http_client handle
+ *
+ * @return
+ *     - ESP_OK if all queued requests have completed
+ *     - ESP_ERR_HTTP_READ_TIMEOUT if no response data arrived within the network timeout of the client
+ *     - ESP_ERR_HTTP_EAGAIN in `is_async` mode, if the connection is not established yet
+ *     - other errors as returned by esp_http_client_pipeline_poll()
+ */
+esp_err_t esp_http_client_pipeline_perform(esp_http_client_handle_t client);
+
+/**
+ * @brief      Get the user context of the pipelined request whose response is being received
+ *
+ *             Can be used from the event handler to attribute HTTP_EVENT_ON_HEADER, HTTP_EVENT_ON_DATA and
+ *             HTTP_EVENT_ON_FINISH events to a request.
+ *
+ * @param[in]  client  The esp_http_client handle
+ *
+ * @return     User context, or NULL if no pipelined response is being received
+ */
+void *esp_http_client_pipeline_get_user_ctx(esp_http_client_handle_t client);
+#endif // CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+/**
+ * @brief      Connection pool statistics
+ */
+typedef struct {
+    uint32_t hits;          /*!< Connections served from the pool */
+    uint32_t misses;        /*!< Connection attempts which found no usable idle connection */
+    uint32_t handshakes;    /*!< New connections (TCP connect and TLS handshake) made by pooled clients */
+    uint32_t expired;       /*!< Idle connections closed on idle timeout or found closed by the server */
+    uint32_t evicted;       /*!< Idle connections closed to make room in a full pool */
+    uint32_t idle;          /*!< Connections currently parked in the pool */
+} esp_http_client_pool_stats_t;
+
+/**
+ * @brief      Get the connection pool statistics
+ *
+ * @param[out] stats  Statistics
+ *
+ * @return
+ *     - ESP_OK
+ *     - ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t esp_http_client_pool_get_stats(esp_http_client_pool_stats_t *stats);
+
+/**
+ * @brief      Close all idle connections held by the connection pool
+ *
+ * @return
+ *     - ESP_OK
+ */
+esp_err_t esp_http_client_pool_flush(void);
+#endif // CONFIG_ESP_HTTP_CLIENT_ENABLE_CONN_POOL
+
 #ifdef __cplusplus
 }
 #endif
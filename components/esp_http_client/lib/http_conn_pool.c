@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <net/if.h>
+#include <sys/select.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "http_conn_pool.h"
+
+static const char *TAG = "HTTP_CONN_POOL";
+
+#define POOL_SIZE           CONFIG_ESP_HTTP_CLIENT_CONN_POOL_SIZE
+#define POOL_IDLE_TICKS     pdMS_TO_TICKS(CONFIG_ESP_HTTP_CLIENT_CONN_POOL_IDLE_TIMEOUT_MS)
+
+#define FNV64_OFFSET_BASIS  (0xcbf29ce484222325ULL)
+#define FNV64_PRIME         (0x100000001b3ULL)
+
+/**
+ * Idle connection parked in the pool
+ */
+typedef struct {
+    char                        *key;           /*!< scheme://host:port/config-id, NULL if the slot is free */
+    esp_transport_ssl_conn_t    conn;           /*!< Detached connection */
+    TickType_t                  parked_at;      /*!< Tick count when the connection was returned to the pool */
+} http_conn_pool_entry_t;
+
+static http_conn_pool_entry_t s_pool[POOL_SIZE];
+static esp_http_client_pool_stats_t s_stats;
+static portMUX_TYPE s_pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Must be called with s_pool_lock held. Moves timed out entries to `out`, returns their number */
+static int pool_collect_expired(TickType_t now, http_conn_pool_entry_t *out)
+{
+    int n = 0;
+    for (int i = 0; i < POOL_SIZE; i++) {
+        if (s_pool[i].key && (now - s_pool[i].parked_at) >= POOL_IDLE_TICKS) {
+            out[n++] = s_pool[i];
+            memset(&s_pool[i], 0, sizeof(http_conn_pool_entry_t));
+            s_stats.idle--;
+            s_stats.expired++;
+        }
+    }
+    return n;
+}
+
+static void pool_close_entries(http_conn_pool_entry_t *entries, int n)
+{
+    for (int i = 0; i < n; i++) {
+        ESP_LOGD(TAG, "Closing idle connection %s", entries[i].key);
+        esp_transport_ssl_conn_close(&entries[i].conn);
+        free(entries[i].key);
+    }
+}
+
+/* Nothing is expected on an idle connection, readable means closed by the server (or garbage) */
+static bool pool_conn_is_stale(const esp_transport_ssl_conn_t *conn)
+{
+    if (conn->tls && esp_tls_get_bytes_avail(conn->tls) > 0) {
+        return true;
+    }
+    fd_set readset;
+    struct timeval timeout = { 0 };
+    FD_ZERO(&readset);
+    FD_SET(conn->sockfd, &readset);
+    return select(conn->sockfd + 1, &readset, NULL, NULL, &timeout) != 0;
+}
+
+bool http_conn_pool_acquire(const char *key, esp_transport_ssl_conn_t *conn)
+{
+    http_conn_pool_entry_t expired[POOL_SIZE];
+
+    while (true) {
+        int found = -1;
+        portENTER_CRITICAL(&s_pool_lock);
+        int n_expired = pool_collect_expired(xTaskGetTickCount(), expired);
+        for (int i = 0; i < POOL_SIZE; i++) {
+            /* Prefer the most recently parked connection, it is the least likely to be closed by the server */
+            if (s_pool[i].key && strcmp(s_pool[i].key, key) == 0 &&
+                    (found < 0 || (s_pool[i].parked_at - s_pool[found].parked_at) < POOL_IDLE_TICKS)) {
+                found = i;
+            }
+        }
+        char *found_key = NULL;
+        if (found >= 0) {
+            *conn = s_pool[found].conn;
+            found_key = s_pool[found].key;
+            memset(&s_pool[found], 0, sizeof(http_conn_pool_entry_t));
+            s_stats.idle--;
+        } else {
+            s_stats.misses++;
+        }
+        portEXIT_CRITICAL(&s_pool_lock);
+
+        free(found_key);
+        pool_close_entries(expired, n_expired);
+        if (found < 0) {
+            return false;
+        }
+
+        /* The connection is checked out of the lock, it is not in the pool any more */
+        bool stale = pool_conn_is_stale(conn);
+        if (stale) {
+            ESP_LOGD(TAG, "Pooled connection to %s was closed by the server", key);
+            esp_transport_ssl_conn_close(conn);
+        }
+        portENTER_CRITICAL(&s_pool_lock);
+        if (stale) {
+            s_stats.expired++;
+        } else {
+            s_stats.hits++;
+        }
+        portEXIT_CRITICAL(&s_pool_lock);
+        if (!stale) {
+            return true;
+        }
+    }
+}
+
+void http_conn_pool_release(const char *key, esp_transport_ssl_conn_t *conn)
+{
+    http_conn_pool_entry_t expired[POOL_SIZE];
+    http_conn_pool_entry_t evicted = { 0 };
+    char *entry_key = strdup(key);
+    if (entry_key == NULL) {
+        ESP_LOGE(TAG, "Memory exhausted");
+        esp_transport_ssl_conn_close(conn);
+        return;
+    }
+
+    portENTER_CRITICAL(&s_pool_lock);
+    TickType_t now = xTaskGetTickCount();
+    int n_expired = pool_collect_expired(now, expired);
+    int slot = -1;
+    for (int i = 0; i < POOL_SIZE; i++) {
+        if (s_pool[i].key == NULL) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 || (now - s_pool[i].parked_at) > (now - s_pool[slot].parked_at)) {
+            slot = i;
+        }
+    }
+    if (s_pool[slot].key) {
+        evicted = s_pool[slot];
+        s_stats.evicted++;
+    } else {
+        s_stats.idle++;
+    }
+    s_pool[slot].key = entry_key;
+    s_pool[slot].conn = *conn;
+    s_pool[slot].parked_at = now;
+    portEXIT_CRITICAL(&s_pool_lock);
+
+    conn->tls = NULL;
+    conn->sockfd = -1;
+    pool_close_entries(expired, n_expired);
+    if (evicted.key) {
+        pool_close_entries(&evicted, 1);
+    }
+}
+
+bool http_conn_pool_make_key(char *buf, size_t len, const char *scheme, const char *host, int port, uint64_t cfg_id)
+{
+    int ret = snprintf(buf, len, "%s://%s:%d/%016" PRIx64, scheme, host, port, cfg_id);
+    return ret > 0 && ret < len;
+}
+
+void http_conn_pool_count_handshake(void)
+{
+    portENTER_CRITICAL(&s_pool_lock);
+    s_stats.handshakes++;
+    portEXIT_CRITICAL(&s_pool_lock);
+}
+
+static uint64_t fnv1a_update(uint64_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= FNV64_PRIME;
+    }
+    return hash;
+}
+
+#define FNV1A_FIELD(hash, field) fnv1a_update(hash, &(field), sizeof(field))
+
+/* A length of 0 means a NUL terminated PEM buffer, as in esp_http_client_config_t */
+static uint64_t fnv1a_buf(uint64_t hash, const char *buf, size_t len)
+{
+    if (buf == NULL) {
+        return fnv1a_update(hash, "\xff", 1);
+    }
+    if (len == 0) {
+        len = strlen(buf) + 1;
+    }
+    hash = FNV1A_FIELD(hash, len);
+    return fnv1a_update(hash, buf, len);
+}
+
+uint64_t http_conn_pool_config_id(const esp_http_client_config_t *config)
+{
+    uint64_t hash = FNV64_OFFSET_BASIS;
+    /* The certificates and keys are hashed by content: a buffer freed by a previous client may be reused
+     * at the same address with other trust settings. crt_bundle_attach points to code, never freed. */
+    hash = fnv1a_buf(hash, config->cert_pem, config->cert_len);
+    hash = fnv1a_buf(hash, config->client_cert_pem, config->client_cert_len);
+    hash = fnv1a_buf(hash, config->client_key_pem, config->client_key_len);
+    hash = FNV1A_FIELD(hash, config->tls_version);
+    hash = FNV1A_FIELD(hash, config->use_global_ca_store);
+    hash = FNV1A_FIELD(hash, config->skip_cert_common_name_check);
+    hash = FNV1A_FIELD(hash, config->crt_bundle_attach);
+    hash = FNV1A_FIELD(hash, config->addr_type);
+    if (config->common_name) {
+        hash = fnv1a_update(hash, config->common_name, strlen(config->common_name));
+    }
+    if (config->if_name) {
+        hash = fnv1a_update(hash, config->if_name->ifr_name, strnlen(config->if_name->ifr_name, sizeof(config->if_name->ifr_name)));
+    }
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_HTTPS
+    for (const char **proto = config->alpn_protos; proto && *proto; proto++) {
+        hash = fnv1a_update(hash, *proto, strlen(*proto) + 1);
+    }
+#endif
+#ifdef CONFIG_MBEDTLS_HARDWARE_ECDSA_SIGN
+    hash = FNV1A_FIELD(hash, config->use_ecdsa_peripheral);
+    hash = FNV1A_FIELD(hash, config->ecdsa_key_efuse_blk);
+    hash = FNV1A_FIELD(hash, config->ecdsa_key_efuse_blk_high);
+#endif
+#if CONFIG_ESP_TLS_USE_SECURE_ELEMENT
+    hash = FNV1A_FIELD(hash, config->use_secure_element);
+#endif
+    return hash;
+}
+
+esp_err_t esp_http_client_pool_get_stats(esp_http_client_pool_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&s_pool_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_pool_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_pool_flush(void)
+{
+    http_conn_pool_entry_t entries[POOL_SIZE];
+    int n = 0;
+
+    portENTER_CRITICAL(&s_pool_lock);
+    for (int i = 0; i < POOL_SIZE; i++) {
+        if (s_pool[i].key) {
+            entries[n++] = s_pool[i];
+            memset(&s_pool[i], 0, sizeof(http_conn_pool_entry_t));
+        }
+    }
+    s_stats.idle = 0;
+    portEXIT_CRITICAL(&s_pool_lock);
+
+    pool_close_entries(entries, n);
+    return ESP_OK;
+}
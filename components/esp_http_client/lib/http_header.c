@@ -18,6 +18,7 @@
 
 static const char *TAG = "HTTP_HEADER";
 #define HEADER_BUFFER (1024)
+#define HEADER_SHORT_VALUE_LEN (64)     /* Values formatted on the stack, longer ones are allocated */
 
 /**
  * dictionary item struct, with key-value pair
@@ -109,8 +110,16 @@ esp_err_t http_header_set(http_header_handle_t header, const char *key, const ch
     item = http_header_get_item(header, key);
 
     if (item) {
-        free(item->value);
-        item->value = strdup(value);
+        size_t len = strlen(value);
+        if (len <= strlen(item->value)) {
+            /* Headers like Content-Length are updated on every request, reuse the old allocation */
+            memmove(item->value, value, len + 1);
+        } else {
+            char *new_value = strdup(value);
+            ESP_RETURN_ON_FALSE(new_value, ESP_ERR_NO_MEM, TAG, "Memory exhausted");
+            free(item->value);
+            item->value = new_value;
+        }
         http_utils_trim_whitespace(&item->value);
         return ESP_OK;
     }
@@ -157,12 +166,21 @@ int http_header_set_format(http_header_handle_t header, const char *key, const c
     va_list argptr = {0};
     int len = 0;
     char *buf = NULL;
+    char short_buf[HEADER_SHORT_VALUE_LEN];
+    va_start(argptr, format);
+    len = vsnprintf(short_buf, sizeof(short_buf), format, argptr);
+    va_end(argptr);
+    if (len >= 0 && len < (int)sizeof(short_buf)) {
+        ESP_RETURN_ON_FALSE(http_header_set(header, key, short_buf) == ESP_OK, 0, TAG, "Memory exhausted");
+        return len;
+    }
     va_start(argptr, format);
     len = vasprintf(&buf, format, argptr);
     va_end(argptr);
     ESP_RETURN_ON_FALSE(buf, 0, TAG, "Memory exhausted");
-    http_header_set(header, key, buf);
+    esp_err_t ret = http_header_set(header, key, buf);
     free(buf);
+    ESP_RETURN_ON_FALSE(ret == ESP_OK, 0, TAG, "Memory exhausted");
     return len;
 }
 
@@ -217,6 +235,18 @@ int http_header_generate_string(http_header_handle_t header, int index, char *bu
     return ret_idx;
 }
 
+int http_header_get_string_len(http_header_handle_t header)
+{
+    http_header_item_handle_t item;
+    int size = 2; // terminating '\r\n'
+    STAILQ_FOREACH(item, header, next) {
+        if (item->value) {
+            size += strlen(item->key) + strlen(item->value) + 4; //': ' and '\r\n'
+        }
+    }
+    return size;
+}
+
 esp_err_t http_header_clean(http_header_handle_t header)
 {
     http_header_item_handle_t item = STAILQ_FIRST(header), tmp;
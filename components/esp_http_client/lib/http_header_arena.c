@@ -0,0 +1,206 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <ctype.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "http_header_arena.h"
+
+static const char *TAG = "HTTP_HEADER_ARENA";
+
+/* Number of headers which can be looked up through the hash index, must be a power of 2.
+ * Headers beyond that are still stored and found by a linear scan. */
+#define HTTP_HEADER_ARENA_INDEX_SIZE    (32)
+#define HTTP_HEADER_ARENA_INDEX_MAX     (HTTP_HEADER_ARENA_INDEX_SIZE * 3 / 4)
+
+typedef enum {
+    ARENA_STATE_IDLE = 0,
+    ARENA_STATE_KEY,
+    ARENA_STATE_VALUE,
+} arena_state_t;
+
+typedef struct {
+    uint32_t hash;
+    uint32_t key_off;                   /*!< Offset of the name in the buffer, plus one (0 means empty slot) */
+} arena_index_entry_t;
+
+struct http_header_arena {
+    char                *buf;
+    size_t              cap;
+    size_t              len;            /*!< Bytes used, buf[len] is always '\0' */
+    size_t              key_off;        /*!< Name of the header being parsed */
+    size_t              val_off;        /*!< Value of the header being parsed */
+    arena_state_t       state;
+    int                 committed;      /*!< Number of finished headers */
+    arena_index_entry_t index[HTTP_HEADER_ARENA_INDEX_SIZE];
+};
+
+static uint32_t arena_hash(const char *key)
+{
+    uint32_t hash = 2166136261u;
+    while (*key) {
+        hash ^= (uint8_t)tolower((unsigned char)*key++);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static esp_err_t arena_reserve(http_header_arena_handle_t arena, size_t extra)
+{
+    size_t need = arena->len + extra + 1;
+    if (need <= arena->cap) {
+        return ESP_OK;
+    }
+    size_t new_cap = arena->cap;
+    while (new_cap < need) {
+        new_cap *= 2;
+    }
+    char *buf = realloc(arena->buf, new_cap);
+    ESP_RETURN_ON_FALSE(buf, ESP_ERR_NO_MEM, TAG, "Memory exhausted");
+    ESP_LOGD(TAG, "grow %zu -> %zu", arena->cap, new_cap);
+    arena->buf = buf;
+    arena->cap = new_cap;
+    return ESP_OK;
+}
+
+static esp_err_t arena_append(http_header_arena_handle_t arena, const char *at, size_t len)
+{
+    ESP_RETURN_ON_ERROR(arena_reserve(arena, len), TAG, "append failed");
+    memcpy(arena->buf + arena->len, at, len);
+    arena->len += len;
+    arena->buf[arena->len] = '\0';
+    return ESP_OK;
+}
+
+http_header_arena_handle_t http_header_arena_init(size_t initial_size)
+{
+    http_header_arena_handle_t arena = calloc(1, sizeof(struct http_header_arena));
+    ESP_RETURN_ON_FALSE(arena, NULL, TAG, "Memory exhausted");
+    arena->cap = initial_size > 0 ? initial_size : 1;
+    arena->buf = malloc(arena->cap);
+    if (arena->buf == NULL) {
+        ESP_LOGE(TAG, "Memory exhausted");
+        free(arena);
+        return NULL;
+    }
+    http_header_arena_reset(arena);
+    return arena;
+}
+
+void http_header_arena_destroy(http_header_arena_handle_t arena)
+{
+    if (arena) {
+        free(arena->buf);
+        free(arena);
+    }
+}
+
+void http_header_arena_reset(http_header_arena_handle_t arena)
+{
+    arena->len = 0;
+    arena->buf[0] = '\0';
+    arena->state = ARENA_STATE_IDLE;
+    arena->committed = 0;
+    memset(arena->index, 0, sizeof(arena->index));
+}
+
+esp_err_t http_header_arena_append_key(http_header_arena_handle_t arena, const char *at, size_t len)
+{
+    if (arena->state == ARENA_STATE_VALUE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (arena->state == ARENA_STATE_IDLE) {
+        arena->key_off = arena->len;
+        arena->state = ARENA_STATE_KEY;
+    }
+    return arena_append(arena, at, len);
+}
+
+esp_err_t http_header_arena_append_value(http_header_arena_handle_t arena, const char *at, size_t len)
+{
+    if (arena->state == ARENA_STATE_IDLE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (arena->state == ARENA_STATE_KEY) {
+        /* The terminator of the name is already in place, keep it */
+        ESP_RETURN_ON_ERROR(arena_reserve(arena, 1), TAG, "append failed");
+        arena->len++;
+        arena->buf[arena->len] = '\0';
+        arena->val_off = arena->len;
+        arena->state = ARENA_STATE_VALUE;
+    }
+    return arena_append(arena, at, len);
+}
+
+const char *http_header_arena_current_key(http_header_arena_handle_t arena)
+{
+    return arena->state == ARENA_STATE_IDLE ? NULL : arena->buf + arena->key_off;
+}
+
+const char *http_header_arena_current_value(http_header_arena_handle_t arena)
+{
+    return arena->state == ARENA_STATE_VALUE ? arena->buf + arena->val_off : NULL;
+}
+
+esp_err_t http_header_arena_commit(http_header_arena_handle_t arena, const char **key, const char **value)
+{
+    if (arena->state != ARENA_STATE_VALUE) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    /* Step over the terminator of the value; the next header starts behind it */
+    ESP_RETURN_ON_ERROR(arena_reserve(arena, 1), TAG, "commit failed");
+    arena->len++;
+    arena->buf[arena->len] = '\0';
+    arena->state = ARENA_STATE_IDLE;
+
+    const char *k = arena->buf + arena->key_off;
+    if (arena->committed < HTTP_HEADER_ARENA_INDEX_MAX) {
+        uint32_t hash = arena_hash(k);
+        uint32_t slot = hash & (HTTP_HEADER_ARENA_INDEX_SIZE - 1);
+        while (arena->index[slot].key_off != 0) {
+            slot = (slot + 1) & (HTTP_HEADER_ARENA_INDEX_SIZE - 1);
+        }
+        arena->index[slot].hash = hash;
+        arena->index[slot].key_off = arena->key_off + 1;
+    }
+    arena->committed++;
+    *key = k;
+    *value = arena->buf + arena->val_off;
+    return ESP_OK;
+}
+
+const char *http_header_arena_get(http_header_arena_handle_t arena, const char *key)
+{
+    if (arena == NULL || key == NULL) {
+        return NULL;
+    }
+    uint32_t hash = arena_hash(key);
+    uint32_t slot = hash & (HTTP_HEADER_ARENA_INDEX_SIZE - 1);
+    while (arena->index[slot].key_off != 0) {
+        const char *k = arena->buf + arena->index[slot].key_off - 1;
+        if (arena->index[slot].hash == hash && strcasecmp(k, key) == 0) {
+            return k + strlen(k) + 1;
+        }
+        slot = (slot + 1) & (HTTP_HEADER_ARENA_INDEX_SIZE - 1);
+    }
+    if (arena->committed <= HTTP_HEADER_ARENA_INDEX_MAX) {
+        return NULL;
+    }
+    /* Not in the index, scan the headers which did not fit into it */
+    const char *p = arena->buf;
+    for (int i = 0; i < arena->committed; i++) {
+        const char *v = p + strlen(p) + 1;
+        if (i >= HTTP_HEADER_ARENA_INDEX_MAX && strcasecmp(p, key) == 0) {
+            return v;
+        }
+        p = v + strlen(v) + 1;
+    }
+    return NULL;
+}
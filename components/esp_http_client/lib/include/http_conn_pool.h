@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _HTTP_CONN_POOL_H_
+#define _HTTP_CONN_POOL_H_
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_transport_ssl.h"
+#include "esp_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_CONN_POOL_KEY_LEN  (320)   /*!< Enough for a 253 character host name, scheme, port and configuration id */
+
+/**
+ * @brief      Take an idle connection matching the key out of the pool
+ *
+ *             Idle connections which exceeded the idle timeout, or which are found closed by the server,
+ *             are closed on the way and counted as expired.
+ *
+ * @param[in]  key   Connection key, as built by http_conn_pool_make_key()
+ * @param[out] conn  Connection state, owned by the caller on success
+ *
+ * @return
+ *     - true if a connection was found
+ *     - false otherwise (counted as a pool miss)
+ */
+bool http_conn_pool_acquire(const char *key, esp_transport_ssl_conn_t *conn);
+
+/**
+ * @brief      Park an idle keep-alive connection in the pool
+ *
+ *             If the pool is full, the least recently parked connection is closed to make room.
+ *             The connection is closed if it cannot be stored.
+ *
+ * @param[in]  key   Connection key, as built by http_conn_pool_make_key()
+ * @param[in]  conn  Connection state, the ownership is passed to the pool
+ */
+void http_conn_pool_release(const char *key, esp_transport_ssl_conn_t *conn);
+
+/**
+ * @brief      Build the pool key for a connection
+ *
+ * @param[out] buf     Output buffer
+ * @param[in]  len     Size of the output buffer
+ * @param[in]  scheme  URL scheme
+ * @param[in]  host    Host name
+ * @param[in]  port    Port
+ * @param[in]  cfg_id  Fingerprint of the transport (TLS) configuration
+ *
+ * @return
+ *     - true if the key fits in the buffer
+ *     - false otherwise, the connection must not be pooled
+ */
+bool http_conn_pool_make_key(char *buf, size_t len, const char *scheme, const char *host, int port, uint64_t cfg_id);
+
+/**
+ * @brief      Account a connection established from scratch by a pooled client
+ */
+void http_conn_pool_count_handshake(void);
+
+/**
+ * @brief      Compute a fingerprint of the transport related part of the client configuration
+ *
+ *             Connections are only shared between clients whose fingerprints match. Certificates and keys
+ *             are hashed by content. The DS peripheral context is opaque, so clients using it are not pooled.
+ *
+ * @param[in]  config  Client configuration
+ *
+ * @return     64-bit fingerprint
+ */
+uint64_t http_conn_pool_config_id(const esp_http_client_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HTTP_CONN_POOL_H_ */
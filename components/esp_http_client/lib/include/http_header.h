@@ -70,7 +70,9 @@ esp_err_t http_header_set(http_header_handle_t header, const char *key, const ch
  * @param[in]  format     The format
  * @param[in]  ...        format parameters
  *
- * @return     Total length of value
+ * @return
+ *     - Total length of value
+ *     - 0 if the header could not be set
  */
 int http_header_set_format(http_header_handle_t header, const char *key, const char *format, ...);
 
@@ -101,6 +103,16 @@ esp_err_t http_header_get(http_header_handle_t header, const char *key, char **v
  */
 int http_header_generate_string(http_header_handle_t header, int index, char *buffer, int *buffer_len);
 
+/**
+ * @brief      Get the length of the string generated by http_header_generate_string() for all headers,
+ *             including the terminating empty line
+ *
+ * @param[in]  header  The header
+ *
+ * @return     Length of the header string, without the null terminator
+ */
+int http_header_get_string_len(http_header_handle_t header);
+
 /**
  * @brief      Remove the header with key from the headers list
  *
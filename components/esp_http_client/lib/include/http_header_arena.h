@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _HTTP_HEADER_ARENA_H_
+#define _HTTP_HEADER_ARENA_H_
+
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Response header storage.
+ *
+ * All header names and values of one response are stored back-to-back as NUL-terminated strings in a
+ * single buffer owned by the client. The buffer is only grown, never shrunk, so once it has reached the
+ * size needed by the responses of an application, parsing headers does not allocate memory anymore.
+ * Pointers returned by this module stay valid until the next call to http_header_arena_reset() or
+ * until the buffer has to grow.
+ */
+typedef struct http_header_arena *http_header_arena_handle_t;
+
+/**
+ * @brief      Allocate a header arena
+ *
+ * @param[in]  initial_size  Initial size of the string buffer in bytes
+ *
+ * @return
+ *     - http_header_arena_handle_t
+ *     - NULL if any errors
+ */
+http_header_arena_handle_t http_header_arena_init(size_t initial_size);
+
+/**
+ * @brief      Free the arena and its buffer
+ *
+ * @param[in]  arena  The arena
+ */
+void http_header_arena_destroy(http_header_arena_handle_t arena);
+
+/**
+ * @brief      Drop all stored headers, keeping the buffer for the next response
+ *
+ * @param[in]  arena  The arena
+ */
+void http_header_arena_reset(http_header_arena_handle_t arena);
+
+/**
+ * @brief      Append a fragment of a header name.
+ *             If the previous header has a value, it must have been committed before.
+ *
+ * @param[in]  arena  The arena
+ * @param[in]  at     The fragment
+ * @param[in]  len    The fragment length
+ *
+ * @return
+ *     - ESP_OK
+ *     - ESP_ERR_NO_MEM
+ */
+esp_err_t http_header_arena_append_key(http_header_arena_handle_t arena, const char *at, size_t len);
+
+/**
+ * @brief      Append a fragment of the value of the header whose name was appended last
+ *
+ * @param[in]  arena  The arena
+ * @param[in]  at     The fragment
+ * @param[in]  len    The fragment length
+ *
+ * @return
+ *     - ESP_OK
+ *     - ESP_ERR_INVALID_STATE if no header name was appended before
+ *     - ESP_ERR_NO_MEM
+ */
+esp_err_t http_header_arena_append_value(http_header_arena_handle_t arena, const char *at, size_t len);
+
+/**
+ * @brief      Name of the header being parsed, NULL if there is none
+ */
+const char *http_header_arena_current_key(http_header_arena_handle_t arena);
+
+/**
+ * @brief      Value (received so far) of the header being parsed, NULL if no value was appended yet
+ */
+const char *http_header_arena_current_value(http_header_arena_handle_t arena);
+
+/**
+ * @brief      Finish the header being parsed and add it to the lookup index
+ *
+ * @param[in]  arena  The arena
+ * @param[out] key    Name of the finished header
+ * @param[out] value  Value of the finished header
+ *
+ * @return
+ *     - ESP_OK
+ *     - ESP_ERR_NOT_FOUND if there was no complete header pending
+ */
+esp_err_t http_header_arena_commit(http_header_arena_handle_t arena, const char **key, const char **value);
+
+/**
+ * @brief      Find a committed header by name (case-insensitive). Returns the first one if repeated.
+ *
+ * @param[in]  arena  The arena
+ * @param[in]  key    The header name
+ *
+ * @return
+ *     - Pointer to the value
+ *     - NULL if the header was not received
+ */
+const char *http_header_arena_get(http_header_arena_handle_t arena, const char *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,11 +6,17 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include <esp_system.h>
 #include <esp_http_client.h>
 
 #include "unity.h"
 #include "test_utils.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "lwip/sockets.h"
 
 #define HOST  "httpbin.org"
 #define USERNAME  "user"
@@ -221,6 +227,326 @@ TEST_CASE("esp_http_client_close() and cleanup() should not dispatch duplicate d
     TEST_ASSERT_LESS_OR_EQUAL(1, disconnect_event_count);
 }
 
+#define BODY_CB_TEST_PORT   (8072)
+
+typedef struct {
+    int listen_sock;
+    SemaphoreHandle_t done;
+} body_cb_test_server_t;
+
+/* Serves a single request with a response whose body is split over several TCP segments */
+static void body_cb_test_server_task(void *arg)
+{
+    body_cb_test_server_t *server = arg;
+    static const char *const segments[] = {
+        "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nX-Long-Header-",
+        "Name: abc\r\nContent-Length: 11\r\nConnection: close\r\n\r\nhello",
+        " world",
+    };
+    char buf[512];
+    int len = 0;
+
+    int sock = accept(server->listen_sock, NULL, NULL);
+    while (sock >= 0) {
+        int ret = recv(sock, buf + len, sizeof(buf) - len - 1, 0);
+        if (ret <= 0) {
+            break;
+        }
+        len += ret;
+        buf[len] = 0;
+        if (strstr(buf, "\r\n\r\n")) {
+            for (size_t i = 0; i < sizeof(segments) / sizeof(segments[0]); i++) {
+                send(sock, segments[i], strlen(segments[i]), 0);
+                vTaskDelay(pdMS_TO_TICKS(20));
+            }
+            break;
+        }
+    }
+    if (sock >= 0) {
+        close(sock);
+    }
+    xSemaphoreGive(server->done);
+    vTaskDelete(NULL);
+}
+
+static void body_cb_test_server_start(body_cb_test_server_t *server)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(BODY_CB_TEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    server->listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, server->listen_sock);
+    TEST_ASSERT_EQUAL(0, bind(server->listen_sock, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(server->listen_sock, 1));
+    server->done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(server->done);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(body_cb_test_server_task, "body_cb_srv", 4096, server, 5, NULL));
+}
+
+static void body_cb_test_server_stop(body_cb_test_server_t *server)
+{
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(server->done, pdMS_TO_TICKS(5000)));
+    close(server->listen_sock);
+    vSemaphoreDelete(server->done);
+}
+
+typedef struct {
+    char data[32];
+    int len;
+    int calls;
+    bool abort;
+} body_cb_test_ctx_t;
+
+static esp_err_t body_cb_test_cb(esp_http_client_handle_t client, const char *data, size_t len, void *user_ctx)
+{
+    body_cb_test_ctx_t *ctx = user_ctx;
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(ctx->data) - 1, ctx->len + len);
+    memcpy(ctx->data + ctx->len, data, len);
+    ctx->len += len;
+    ctx->calls++;
+    return ctx->abort ? ESP_FAIL : ESP_OK;
+}
+
+TEST_CASE("Response headers can be looked up and the body is passed to the body callback", "[esp_http_client]")
+{
+    test_case_uses_tcpip();
+
+    body_cb_test_server_t server = { 0 };
+    body_cb_test_server_start(&server);
+
+    esp_http_client_config_t config = {
+        .url = "http://127.0.0.1:8072/get",
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+    body_cb_test_ctx_t ctx = { 0 };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_set_body_callback(client, body_cb_test_cb, &ctx));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+    TEST_ASSERT_EQUAL(200, esp_http_client_get_status_code(client));
+
+    TEST_ASSERT_EQUAL(11, ctx.len);
+    TEST_ASSERT_EQUAL_STRING("hello world", ctx.data);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, ctx.calls);
+
+    const char *value = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_get_response_header(client, "x-long-header-name", &value));
+    TEST_ASSERT_EQUAL_STRING("abc", value);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_get_response_header(client, "Content-Type", &value));
+    TEST_ASSERT_EQUAL_STRING("text/plain", value);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, esp_http_client_get_response_header(client, "Location", &value));
+    TEST_ASSERT_NULL(value);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+    body_cb_test_server_stop(&server);
+}
+
+TEST_CASE("Body callback returning an error aborts the response", "[esp_http_client]")
+{
+    test_case_uses_tcpip();
+
+    body_cb_test_server_t server = { 0 };
+    body_cb_test_server_start(&server);
+
+    esp_http_client_config_t config = {
+        .url = "http://127.0.0.1:8072/get",
+        .timeout_ms = 5000,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+    body_cb_test_ctx_t ctx = { .abort = true };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_set_body_callback(client, body_cb_test_cb, &ctx));
+    /* Fails as soon as the callback returns an error: the body may arrive with the headers, so the error
+       is either ESP_ERR_HTTP_FETCH_HEADER or ESP_ERR_HTTP_INCOMPLETE_DATA */
+    esp_err_t err = esp_http_client_perform(client);
+    TEST_ASSERT_TRUE(err == ESP_ERR_HTTP_FETCH_HEADER || err == ESP_ERR_HTTP_INCOMPLETE_DATA);
+    TEST_ASSERT_EQUAL(1, ctx.calls);
+    TEST_ASSERT_EQUAL_STRING("hello", ctx.data);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+    body_cb_test_server_stop(&server);
+}
+
+#if CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+#define PIPELINE_TEST_PORT          (8071)
+#define PIPELINE_TEST_REQUESTS      (7)
+#define PIPELINE_TEST_POST_INDEX    (3)
+#define PIPELINE_TEST_LATENCY_MS    (50)
+
+typedef struct {
+    int listen_sock;
+    int total;
+    int served;
+    int accepted;
+    bool post_pipelined;    /*!< A POST request was received together with another request */
+    SemaphoreHandle_t done;
+} latency_test_server_t;
+
+/* Keep-alive server which delays every batch of received data by PIPELINE_TEST_LATENCY_MS, emulating a slow link.
+   The body of each response is the path of its request. */
+static void latency_test_server_task(void *arg)
+{
+    latency_test_server_t *server = arg;
+    char buf[1024];
+    char response[96];
+
+    while (server->served < server->total) {
+        int sock = accept(server->listen_sock, NULL, NULL);
+        if (sock < 0) {
+            break;
+        }
+        server->accepted++;
+        int len = 0;
+        while (server->served < server->total) {
+            int ret = recv(sock, buf + len, sizeof(buf) - len - 1, 0);
+            if (ret <= 0) {
+                break;
+            }
+            len += ret;
+            buf[len] = 0;
+            vTaskDelay(pdMS_TO_TICKS(PIPELINE_TEST_LATENCY_MS));
+            char *start = buf;
+            char *end;
+            int batch = 0;
+            bool post = false;
+            while ((end = strstr(start, "\r\n\r\n")) != NULL) {
+                char method[8] = "";
+                char path[32] = "";
+                sscanf(start, "%7s %31s", method, path);
+                post |= strcmp(method, "POST") == 0;
+                int n = snprintf(response, sizeof(response), "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n%s",
+                                 (int)strlen(path), path);
+                send(sock, response, n, 0);
+                server->served++;
+                batch++;
+                start = end + 4;
+            }
+            server->post_pipelined |= post && batch > 1;
+            len -= start - buf;
+            memmove(buf, start, len);
+        }
+        close(sock);
+    }
+    xSemaphoreGive(server->done);
+    vTaskDelete(NULL);
+}
+
+typedef struct {
+    int index;
+    char path[16];
+    char body[16];
+    int body_len;
+    int *completed;
+    bool ok;                /*!< Completed in order, with the response to this request */
+} pipeline_test_req_t;
+
+static esp_err_t pipeline_test_event_handler(esp_http_client_event_t *evt)
+{
+    pipeline_test_req_t *req = esp_http_client_pipeline_get_user_ctx(evt->client);
+    if (evt->event_id == HTTP_EVENT_ON_DATA && req && req->body_len + evt->data_len < sizeof(req->body)) {
+        memcpy(req->body + req->body_len, evt->data, evt->data_len);
+        req->body_len += evt->data_len;
+    }
+    return ESP_OK;
+}
+
+static void pipeline_test_on_complete(esp_http_client_handle_t client, esp_err_t result, void *user_ctx)
+{
+    pipeline_test_req_t *req = user_ctx;
+    req->ok = result == ESP_OK && esp_http_client_get_status_code(client) == 200 &&
+              *req->completed == req->index && strcmp(req->body, req->path) == 0;
+    (*req->completed)++;
+}
+
+TEST_CASE("Pipelined requests complete in order on one connection, POST is not pipelined", "[esp_http_client]")
+{
+    test_case_uses_tcpip();
+
+    latency_test_server_t server = { .total = PIPELINE_TEST_REQUESTS };
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(PIPELINE_TEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    server.listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, server.listen_sock);
+    TEST_ASSERT_EQUAL(0, bind(server.listen_sock, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(server.listen_sock, 1));
+    server.done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(server.done);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(latency_test_server_task, "latency_srv", 4096, &server, 5, NULL));
+
+    esp_http_client_config_t config = {
+        .url = "http://127.0.0.1:8071/telemetry",
+        .event_handler = pipeline_test_event_handler,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+
+    /* GET requests, with a POST in the middle which has to wait for the GET requests before it */
+    pipeline_test_req_t reqs[PIPELINE_TEST_REQUESTS] = { 0 };
+    int completed = 0;
+    for (int i = 0; i < PIPELINE_TEST_REQUESTS; i++) {
+        reqs[i].index = i;
+        reqs[i].completed = &completed;
+        snprintf(reqs[i].path, sizeof(reqs[i].path), "/r%d", i);
+        esp_http_client_pipeline_req_t req = {
+            .method = i == PIPELINE_TEST_POST_INDEX ? HTTP_METHOD_POST : HTTP_METHOD_GET,
+            .path = reqs[i].path,
+            .on_complete = pipeline_test_on_complete,
+            .user_ctx = &reqs[i],
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pipeline_enqueue(client, &req));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pipeline_perform(client));
+    TEST_ASSERT_EQUAL(PIPELINE_TEST_REQUESTS, completed);
+    for (int i = 0; i < PIPELINE_TEST_REQUESTS; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(reqs[i].ok, reqs[i].path);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(server.done, pdMS_TO_TICKS(5000)));
+    TEST_ASSERT_EQUAL(1, server.accepted);
+    TEST_ASSERT_FALSE(server.post_pipelined);
+    close(server.listen_sock);
+    vSemaphoreDelete(server.done);
+}
+
+TEST_CASE("Pipeline enqueue keeps the Content-Length header of the client", "[esp_http_client]")
+{
+    esp_http_client_config_t config = {
+        .url = "http://127.0.0.1:8071/telemetry",
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+    char *value = NULL;
+
+    /* A request with a body does not leave its length in the client */
+    static const char body[] = "{\"t\":1}";
+    esp_http_client_pipeline_req_t req = {
+        .method = HTTP_METHOD_POST,
+        .data = body,
+        .data_len = sizeof(body) - 1,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pipeline_enqueue(client, &req));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_get_header(client, "Content-Length", &value));
+    TEST_ASSERT_NULL(value);
+
+    /* A request without a body does not drop the length set for the client */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_set_header(client, "Content-Length", "42"));
+    req = (esp_http_client_pipeline_req_t) {
+        .method = HTTP_METHOD_GET,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_pipeline_enqueue(client, &req));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_get_header(client, "Content-Length", &value));
+    TEST_ASSERT_EQUAL_STRING("42", value);
+
+    /* The queued requests are failed by the cleanup */
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+}
+#endif // CONFIG_ESP_HTTP_CLIENT_ENABLE_PIPELINING
+
 void app_main(void)
 {
     unity_run_menu();
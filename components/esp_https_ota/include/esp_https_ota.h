@@ -65,6 +65,9 @@ typedef struct {
 #if CONFIG_ESP_HTTPS_OTA_ENABLE_PARTIAL_DOWNLOAD || __DOXYGEN__
     bool partial_http_download;                    /*!< Enable Firmware image to be downloaded over multiple HTTP requests */
     int max_http_request_size;                     /*!< Maximum request size for partial HTTP download */
+#endif
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD || __DOXYGEN__
+    uint8_t parallel_connections;                  /*!< Number of connections (2 to 4) downloading chunks of max_http_request_size bytes of the image in parallel, if partial_http_download is set. 0 or 1 for a sequential download. If ota_resumption is set, the chunks written are saved to NVS, and ota_image_bytes_written is not used */
 #endif
     uint32_t buffer_caps;                          /*!< The memory capability to use when allocating the buffer for OTA update. Default capability is MALLOC_CAP_DEFAULT */
     bool ota_resumption;                           /*!< Enable resumption in downloading of OTA image between reboots */
@@ -160,6 +163,7 @@ esp_err_t esp_https_ota_begin(const esp_https_ota_config_t *ota_config, esp_http
  *    - ESP_ERR_OTA_VALIDATE_FAILED: Invalid app image
  *    - ESP_ERR_NO_MEM: Cannot allocate memory for OTA operation.
  *    - ESP_ERR_FLASH_OP_TIMEOUT or ESP_ERR_FLASH_OP_FAIL: Flash write failed.
+ *    - ESP_ERR_NOT_SUPPORTED: The image is a delta patch and ota_resumption is enabled
  *    - For other return codes, refer OTA documentation in esp-idf's app_update component.
  */
 esp_err_t esp_https_ota_perform(esp_https_ota_handle_t https_ota_handle);
@@ -15,6 +15,19 @@
 #include <inttypes.h>
 #include "esp_check.h"
 #include "hal/efuse_hal.h"
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+#include "esp_ota_delta.h"
+#endif
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "nvs.h"
+#include "esp_bit_defs.h"
+#include "esp_rom_crc.h"
+#endif
 
 ESP_EVENT_DEFINE_BASE(ESP_HTTPS_OTA_EVENT);
 
@@ -30,6 +43,18 @@ _Static_assert(DEFAULT_OTA_BUF_SIZE > (sizeof(esp_image_header_t) + sizeof(esp_i
 
 static const int DEFAULT_MAX_AUTH_RETRIES = 10;
 
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+#define PARALLEL_MAX_CONNECTIONS        4
+#define PARALLEL_CHUNK_MAX_RETRIES      5
+#define PARALLEL_RETRY_DELAY_MS         500
+#define PARALLEL_PERFORM_WAIT_MS        1000
+#define PARALLEL_SAVE_INTERVAL_MS       2000
+#define PARALLEL_PROGRESS_BIT           BIT0
+#define PARALLEL_WORKER_EXIT_BIT(i)     BIT((i) + 1)
+#define PARALLEL_NVS_NAMESPACE          "esp_https_ota"
+#define PARALLEL_NVS_KEY                "parallel_state"
+#endif
+
 static const char *TAG = "esp_https_ota";
 
 typedef enum {
@@ -64,10 +89,57 @@ struct esp_https_ota_handle {
     void *decrypt_user_ctx;
     uint16_t enc_img_header_size;
 #endif
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+    esp_ota_delta_handle_t delta;             /*!< Set if the data received is a delta patch to apply to the running app */
+    bool delta_image_checked;
+    bool ota_resumption;                      /*!< A delta patch is rejected, its download cannot be resumed */
+#endif
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+    struct {                                  /*!< Image downloaded in chunks over several connections, see esp_https_ota_parallel_begin() */
+        int connections;                      /*!< Number of workers, 0 for a sequential download */
+        struct esp_https_ota_worker *workers;
+        int started;                          /*!< Number of worker tasks started */
+        bool active;                          /*!< Set once the image is written by the workers */
+        SemaphoreHandle_t lock;               /*!< Protects the fields below and serializes the flash accesses */
+        EventGroupHandle_t events;
+        int chunk_count;
+        int next_chunk;                       /*!< Chunks before it are either done or fetched by a worker */
+        int done_bytes;
+        bool erase_chunks;                    /*!< Set when resuming, the chunks still to fetch were not erased by esp_ota_begin() */
+        bool stop;
+        esp_err_t err;                        /*!< First fatal error, which stops the download */
+        uint32_t url_crc;
+        bool persist;                         /*!< Save the state to NVS, set by esp_https_ota_config_t::ota_resumption */
+        nvs_handle_t nvs;
+        struct esp_https_ota_parallel_state *state;
+        size_t state_size;
+        bool state_changed;                   /*!< Chunks were done since the state was last saved */
+        struct esp_https_ota_parallel_state *saved_state; /*!< Copy of the state written to NVS, outside of the lock */
+        TickType_t save_tick;
+    } parallel;
+#endif
 };
 
 typedef struct esp_https_ota_handle esp_https_ota_t;
 
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+typedef struct esp_https_ota_worker {
+    esp_https_ota_t *ota;
+    esp_http_client_handle_t http_client;
+    int index;
+} esp_https_ota_worker_t;
+
+/* Persisted in NVS to resume a parallel download after a reboot.
+ * The download is only resumed if the first fields match the current one. */
+typedef struct esp_https_ota_parallel_state {
+    uint32_t url_crc;
+    uint32_t staging_address;
+    uint32_t image_length;
+    uint32_t chunk_size;
+    uint8_t done[];                           /*!< Bitmap of the chunks written to the staging partition */
+} esp_https_ota_parallel_state_t;
+#endif
+
 static bool redirection_required(int status_code)
 {
     switch (status_code) {
@@ -99,11 +171,11 @@ static bool process_again(int status_code)
     return false;
 }
 
-static esp_err_t _http_handle_response_code(esp_https_ota_t *https_ota_handle, int status_code)
+static esp_err_t _http_handle_response_code(esp_https_ota_t *https_ota_handle, esp_http_client_handle_t client, int status_code)
 {
     esp_err_t err = ESP_FAIL;
     if (redirection_required(status_code)) {
-        err = esp_http_client_set_redirection(https_ota_handle->http_client);
+        err = esp_http_client_set_redirection(client);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "URL redirection Failed");
             return err;
@@ -120,7 +192,7 @@ static esp_err_t _http_handle_response_code(esp_https_ota_t *https_ota_handle, i
             return ESP_FAIL;
         }
         https_ota_handle->max_authorization_retries--;
-        err = esp_http_client_add_auth(https_ota_handle->http_client);
+        err = esp_http_client_add_auth(client);
         if (err!= ESP_OK) {
             ESP_LOGE(TAG, "Authorization Failed");
             return err;
@@ -144,7 +216,7 @@ static esp_err_t _http_handle_response_code(esp_https_ota_t *https_ota_handle, i
              *  In case of redirection, esp_http_client_read() is called
              *  to clear the response buffer of http_client.
              */
-            int data_read = esp_http_client_read(https_ota_handle->http_client, upgrade_data_buf, sizeof(upgrade_data_buf));
+            int data_read = esp_http_client_read(client, upgrade_data_buf, sizeof(upgrade_data_buf));
             if (data_read <= 0) {
                 return ESP_OK;
             }
@@ -153,7 +225,7 @@ static esp_err_t _http_handle_response_code(esp_https_ota_t *https_ota_handle, i
     return ESP_OK;
 }
 
-static esp_err_t _http_connect(esp_https_ota_t *https_ota_handle)
+static esp_err_t _http_connect(esp_https_ota_t *https_ota_handle, esp_http_client_handle_t client)
 {
     esp_err_t err = ESP_FAIL;
     int status_code, header_ret;
@@ -163,8 +235,8 @@ static esp_err_t _http_connect(esp_https_ota_t *https_ota_handle)
          * Note: Sending POST request is not supported if partial_http_download
          * is enabled
          */
-        int post_len = esp_http_client_get_post_field(https_ota_handle->http_client, &post_data);
-        err = esp_http_client_open(https_ota_handle->http_client, post_len);
+        int post_len = esp_http_client_get_post_field(client, &post_data);
+        err = esp_http_client_open(client, post_len);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Failed to open HTTP connection: %s", esp_err_to_name(err));
             return err;
@@ -172,7 +244,7 @@ static esp_err_t _http_connect(esp_https_ota_t *https_ota_handle)
         if (post_len) {
             int write_len = 0;
             while (post_len > 0) {
-                write_len = esp_http_client_write(https_ota_handle->http_client, post_data, post_len);
+                write_len = esp_http_client_write(client, post_data, post_len);
                 if (write_len < 0) {
                     ESP_LOGE(TAG, "Write failed");
                     return ESP_FAIL;
@@ -181,12 +253,12 @@ static esp_err_t _http_connect(esp_https_ota_t *https_ota_handle)
                 post_data += write_len;
             }
         }
-        header_ret = esp_http_client_fetch_headers(https_ota_handle->http_client);
+        header_ret = esp_http_client_fetch_headers(client);
         if (header_ret < 0) {
             return header_ret;
         }
-        status_code = esp_http_client_get_status_code(https_ota_handle->http_client);
-        err = _http_handle_response_code(https_ota_handle, status_code);
+        status_code = esp_http_client_get_status_code(client);
+        err = _http_handle_response_code(https_ota_handle, client, status_code);
         if (err != ESP_OK) {
             return err;
         }
@@ -255,7 +327,15 @@ static esp_err_t _ota_write(esp_https_ota_t *https_ota_handle, const void *buffe
     if (buffer == NULL || https_ota_handle == NULL) {
         return ESP_FAIL;
     }
-    esp_err_t err = esp_ota_write(https_ota_handle->update_handle, buffer, buf_len);
+    esp_err_t err;
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+    if (https_ota_handle->delta) {
+        err = esp_ota_delta_write(https_ota_handle->delta, buffer, buf_len);
+    } else
+#endif
+    {
+        err = esp_ota_write(https_ota_handle->update_handle, buffer, buf_len);
+    }
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error: esp_ota_write failed! err=0x%x", err);
     } else {
@@ -277,6 +357,81 @@ static bool is_server_verification_enabled(const esp_https_ota_config_t *ota_con
             || ota_config->http_config->crt_bundle_attach != NULL);
 }
 
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+static esp_err_t esp_https_ota_parallel_init(esp_https_ota_t *handle, const esp_https_ota_config_t *ota_config)
+{
+    int connections = ota_config->parallel_connections;
+    if (connections > PARALLEL_MAX_CONNECTIONS) {
+        ESP_LOGW(TAG, "Limiting the parallel download to %d connections", PARALLEL_MAX_CONNECTIONS);
+        connections = PARALLEL_MAX_CONNECTIONS;
+    }
+    handle->parallel.workers = calloc(connections, sizeof(esp_https_ota_worker_t));
+    handle->parallel.lock = xSemaphoreCreateMutex();
+    handle->parallel.events = xEventGroupCreate();
+    if (handle->parallel.workers == NULL || handle->parallel.lock == NULL || handle->parallel.events == NULL) {
+        ESP_LOGE(TAG, "Couldn't allocate memory for the parallel download");
+        return ESP_ERR_NO_MEM;
+    }
+    handle->parallel.connections = connections;
+
+    for (int i = 0; i < connections; i++) {
+        esp_https_ota_worker_t *worker = &handle->parallel.workers[i];
+        worker->ota = handle;
+        worker->index = i;
+        worker->http_client = esp_http_client_init(ota_config->http_config);
+        if (worker->http_client == NULL) {
+            ESP_LOGE(TAG, "Failed to initialise HTTP connection");
+            return ESP_FAIL;
+        }
+        if (ota_config->http_client_init_cb) {
+            esp_err_t err = ota_config->http_client_init_cb(worker->http_client);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "http_client_init_cb returned 0x%x", err);
+                return err;
+            }
+        }
+    }
+
+    // Identifies the image in the state saved to NVS
+    const esp_http_client_config_t *http_config = ota_config->http_config;
+    if (http_config->url) {
+        handle->parallel.url_crc = esp_rom_crc32_le(0, (const uint8_t *)http_config->url, strlen(http_config->url));
+    } else {
+        if (http_config->host) {
+            handle->parallel.url_crc = esp_rom_crc32_le(0, (const uint8_t *)http_config->host, strlen(http_config->host));
+        }
+        if (http_config->path) {
+            handle->parallel.url_crc = esp_rom_crc32_le(handle->parallel.url_crc, (const uint8_t *)http_config->path, strlen(http_config->path));
+        }
+    }
+    handle->parallel.persist = ota_config->ota_resumption;
+    return ESP_OK;
+}
+
+static void esp_https_ota_parallel_cleanup(esp_https_ota_t *handle)
+{
+    if (handle->parallel.workers) {
+        for (int i = 0; i < handle->parallel.connections; i++) {
+            if (handle->parallel.workers[i].http_client) {
+                _http_cleanup(handle->parallel.workers[i].http_client);
+            }
+        }
+        free(handle->parallel.workers);
+    }
+    if (handle->parallel.lock) {
+        vSemaphoreDelete(handle->parallel.lock);
+    }
+    if (handle->parallel.events) {
+        vEventGroupDelete(handle->parallel.events);
+    }
+    if (handle->parallel.nvs) {
+        nvs_close(handle->parallel.nvs);
+    }
+    free(handle->parallel.state);
+    free(handle->parallel.saved_state);
+}
+#endif // CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+
 esp_err_t esp_https_ota_begin(const esp_https_ota_config_t *ota_config, esp_https_ota_handle_t *handle)
 {
     esp_https_ota_dispatch_event(ESP_HTTPS_OTA_START, NULL, 0);
@@ -330,7 +485,12 @@ esp_err_t esp_https_ota_begin(const esp_https_ota_config_t *ota_config, esp_http
         https_ota_handle->max_authorization_retries = 0;
     }
 
-    if (ota_config->ota_resumption) {
+    if (ota_config->ota_resumption
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+        // A parallel download is resumed from the state it saves to NVS
+        && !(https_ota_handle->partial_http_download && ota_config->parallel_connections > 1)
+#endif
+    ) {
         // We allow resumption only if we have minimum buffer size already written to flash
         if (ota_config->ota_image_bytes_written >= DEFAULT_OTA_BUF_SIZE) {
             ESP_LOGI(TAG, "Valid OTA resumption case, offset %d", ota_config->ota_image_bytes_written);
@@ -354,6 +514,15 @@ esp_err_t esp_https_ota_begin(const esp_https_ota_config_t *ota_config, esp_http
         }
     }
 
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+    if (https_ota_handle->partial_http_download && ota_config->parallel_connections > 1) {
+        err = esp_https_ota_parallel_init(https_ota_handle, ota_config);
+        if (err != ESP_OK) {
+            goto http_cleanup;
+        }
+    }
+#endif
+
     /*
      * If OTA resumption is enabled, set the "Range" header to resume downloading the OTA image
      * from the last written byte. For non-partial cases, the range pattern is 'from-'.
@@ -451,7 +620,7 @@ esp_err_t esp_https_ota_begin(const esp_https_ota_config_t *ota_config, esp_http
     }
 #endif
 
-    err = _http_connect(https_ota_handle);
+    err = _http_connect(https_ota_handle, https_ota_handle->http_client);
     if (err == ESP_ERR_HTTP_RANGE_NOT_SATISFIABLE && https_ota_handle->binary_file_len > 0) {
         ESP_LOGE(TAG, "OTA resumption failed with err: %d", err);
         ESP_LOGI(TAG, "Restarting download from beginning");
@@ -473,7 +642,7 @@ esp_err_t esp_https_ota_begin(const esp_https_ota_config_t *ota_config, esp_http
             free(header_val);
         }
 #endif
-        err = _http_connect(https_ota_handle);
+        err = _http_connect(https_ota_handle, https_ota_handle->http_client);
     }
 
     if (err != ESP_OK) {
@@ -545,12 +714,18 @@ esp_err_t esp_https_ota_begin(const esp_https_ota_config_t *ota_config, esp_http
 #endif
     https_ota_handle->ota_upgrade_buf_size = alloc_size;
     https_ota_handle->bulk_flash_erase = ota_config->bulk_flash_erase;
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+    https_ota_handle->ota_resumption = ota_config->ota_resumption;
+#endif
     *handle = (esp_https_ota_handle_t)https_ota_handle;
     https_ota_handle->state = https_ota_handle->binary_file_len ? ESP_HTTPS_OTA_RESUME : ESP_HTTPS_OTA_BEGIN;
     return ESP_OK;
 
 http_cleanup:
     _http_cleanup(https_ota_handle->http_client);
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+    esp_https_ota_parallel_cleanup(https_ota_handle);
+#endif
 failure:
     free(https_ota_handle);
     *handle = NULL;
@@ -611,6 +786,13 @@ static esp_err_t get_description_from_image(esp_https_ota_handle_t https_ota_han
         ESP_LOGE(TAG, "esp_https_ota_get_img_desc: Invalid state");
         return ESP_ERR_INVALID_STATE;
     }
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+    // The new image is only known once the patch is applied
+    if (handle->delta) {
+        ESP_LOGE(TAG, "The image description cannot be read from a delta patch");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
 
     unsigned img_info_len = 0;
     if (handle->partition.final->type == ESP_PARTITION_TYPE_APP) {
@@ -633,6 +815,12 @@ static esp_err_t get_description_from_image(esp_https_ota_handle_t https_ota_han
         if (read_header(handle) != ESP_OK) {
             return ESP_FAIL;
         }
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+        if (esp_ota_delta_is_patch(handle->ota_upgrade_buf, handle->binary_file_len)) {
+            ESP_LOGE(TAG, "The image description cannot be read from a delta patch");
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+#endif
         img_info = (void *)&handle->ota_upgrade_buf[offset];
     }
 
@@ -687,6 +875,396 @@ static esp_err_t esp_ota_verify_chip_revision(const void *arg)
     return ESP_OK;
 }
 
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+static esp_err_t esp_https_ota_delta_write_cb(const void *data, size_t size, void *user_ctx)
+{
+    esp_https_ota_t *handle = (esp_https_ota_t *)user_ctx;
+    if (!handle->delta_image_checked) {
+        // The header of the new image is only available once the patch starts producing it
+        if (size < sizeof(esp_image_header_t)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        esp_err_t err = esp_ota_verify_chip_id(data);
+        if (err != ESP_OK) {
+            return err;
+        }
+        err = esp_ota_verify_chip_revision(data);
+        if (err != ESP_OK) {
+            return err;
+        }
+        handle->delta_image_checked = true;
+    }
+    return esp_ota_write(handle->update_handle, data, size);
+}
+
+static esp_err_t esp_https_ota_delta_begin(esp_https_ota_t *handle)
+{
+    const esp_ota_delta_cfg_t cfg = {
+        .src_partition = esp_ota_get_running_partition(),
+        .write_cb = esp_https_ota_delta_write_cb,
+        .user_ctx = handle,
+    };
+    ESP_LOGI(TAG, "Applying a delta patch to the running app");
+    esp_err_t err = esp_ota_delta_begin(&cfg, &handle->delta);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_delta_begin failed (%s)", esp_err_to_name(err));
+    }
+    return err;
+}
+#endif // CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+static int esp_https_ota_chunk_len(esp_https_ota_t *handle, int chunk)
+{
+    const int chunk_size = handle->parallel.state->chunk_size;
+    return MIN(chunk_size, handle->image_length - chunk * chunk_size);
+}
+
+static bool esp_https_ota_chunk_is_done(esp_https_ota_t *handle, int chunk)
+{
+    return handle->parallel.state->done[chunk / 8] & BIT(chunk % 8);
+}
+
+static void esp_https_ota_parallel_fail(esp_https_ota_t *handle, esp_err_t err)
+{
+    xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+    if (handle->parallel.err == ESP_OK) {
+        handle->parallel.err = err;
+    }
+    handle->parallel.stop = true;
+    xSemaphoreGive(handle->parallel.lock);
+    xEventGroupSetBits(handle->parallel.events, PARALLEL_PROGRESS_BIT);
+}
+
+/* Returns the next chunk to fetch, or -1 if there is none left */
+static int esp_https_ota_parallel_next_chunk(esp_https_ota_t *handle)
+{
+    int chunk = -1;
+    xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+    if (!handle->parallel.stop) {
+        while (handle->parallel.next_chunk < handle->parallel.chunk_count && esp_https_ota_chunk_is_done(handle, handle->parallel.next_chunk)) {
+            handle->parallel.next_chunk++;
+        }
+        if (handle->parallel.next_chunk < handle->parallel.chunk_count) {
+            chunk = handle->parallel.next_chunk++;
+        }
+    }
+    xSemaphoreGive(handle->parallel.lock);
+    return chunk;
+}
+
+static void esp_https_ota_parallel_chunk_done(esp_https_ota_t *handle, int chunk)
+{
+    xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+    handle->parallel.state->done[chunk / 8] |= BIT(chunk % 8);
+    handle->parallel.done_bytes += esp_https_ota_chunk_len(handle, chunk);
+    handle->parallel.state_changed = true;
+    xSemaphoreGive(handle->parallel.lock);
+    xEventGroupSetBits(handle->parallel.events, PARALLEL_PROGRESS_BIT);
+}
+
+/* Saves the chunks done to NVS, at most every PARALLEL_SAVE_INTERVAL_MS unless forced.
+ * The state is copied under the lock and written without holding it, so that the workers are not stalled. */
+static void esp_https_ota_parallel_save_state(esp_https_ota_t *handle, bool force)
+{
+    if (!handle->parallel.persist) {
+        return;
+    }
+    const TickType_t now = xTaskGetTickCount();
+    if (!force && now - handle->parallel.save_tick < pdMS_TO_TICKS(PARALLEL_SAVE_INTERVAL_MS)) {
+        return;
+    }
+    xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+    const bool changed = handle->parallel.state_changed;
+    if (changed) {
+        memcpy(handle->parallel.saved_state, handle->parallel.state, handle->parallel.state_size);
+        handle->parallel.state_changed = false;
+    }
+    xSemaphoreGive(handle->parallel.lock);
+    if (!changed) {
+        return;
+    }
+    esp_err_t err = nvs_set_blob(handle->parallel.nvs, PARALLEL_NVS_KEY, handle->parallel.saved_state, handle->parallel.state_size);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle->parallel.nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save the download state to NVS (%s)", esp_err_to_name(err));
+    }
+    handle->parallel.save_tick = now;
+}
+
+static esp_err_t esp_https_ota_fetch_chunk(esp_https_ota_worker_t *worker, char *buf, int buf_size, int chunk, bool erase)
+{
+    esp_https_ota_t *handle = worker->ota;
+    esp_http_client_handle_t client = worker->http_client;
+    const esp_partition_t *staging = handle->partition.staging;
+    const int start = chunk * handle->parallel.state->chunk_size;
+    const int len = esp_https_ota_chunk_len(handle, chunk);
+    esp_err_t err;
+
+    if (erase) {
+        // The chunk may have been partly written by a previous attempt, possibly before a reboot
+        const int erase_len = (len + staging->erase_size - 1) / staging->erase_size * staging->erase_size;
+        xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+        err = esp_partition_erase_range(staging, start, erase_len);
+        xSemaphoreGive(handle->parallel.lock);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to erase chunk %d (%s)", chunk, esp_err_to_name(err));
+            esp_https_ota_parallel_fail(handle, err);
+            return err;
+        }
+    }
+
+    char *header_val = NULL;
+    asprintf(&header_val, "bytes=%d-%d", start, start + len - 1);
+    if (header_val == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate memory for HTTP header");
+        return ESP_ERR_NO_MEM;
+    }
+    esp_http_client_set_header(client, "Range", header_val);
+    free(header_val);
+
+    err = _http_connect(handle, client);
+    if (err == ESP_OK && esp_http_client_get_content_length(client) != len) {
+        ESP_LOGE(TAG, "Server did not return the requested range of chunk %d", chunk);
+        err = ESP_FAIL;
+    }
+    int received = 0, buffered = 0;
+    while (err == ESP_OK && received < len) {
+        if (handle->parallel.stop) {
+            err = ESP_ERR_INVALID_STATE;
+            break;
+        }
+        int data_read = esp_http_client_read(client, buf + buffered, MIN(buf_size - buffered, len - received));
+        if (data_read <= 0) {
+            // A stalled connection (ESP_ERR_HTTP_EAGAIN) is retried like a dropped one
+            ESP_LOGW(TAG, "Connection closed or stalled after %d of %d bytes of chunk %d", received, len, chunk);
+            err = ESP_FAIL;
+            break;
+        }
+        received += data_read;
+        buffered += data_read;
+        if (buffered == buf_size || received == len) {
+            xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+            err = esp_ota_write_with_offset(handle->update_handle, buf, buffered, start + received - buffered);
+            xSemaphoreGive(handle->parallel.lock);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Error: esp_ota_write_with_offset failed! err=0x%x", err);
+                esp_https_ota_parallel_fail(handle, err);
+            }
+            buffered = 0;
+        }
+    }
+    esp_http_client_close(client);
+    return err;
+}
+
+static void esp_https_ota_worker_task(void *arg)
+{
+    esp_https_ota_worker_t *worker = (esp_https_ota_worker_t *)arg;
+    esp_https_ota_t *handle = worker->ota;
+    // Chunks are written in blocks of 16 bytes multiples, as required with flash encryption
+    const int buf_size = handle->ota_upgrade_buf_size & ~15;
+    char *buf = malloc(buf_size);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "Couldn't allocate memory to upgrade data buffer");
+        esp_https_ota_parallel_fail(handle, ESP_ERR_NO_MEM);
+    }
+
+    int chunk;
+    while (buf && (chunk = esp_https_ota_parallel_next_chunk(handle)) >= 0) {
+        esp_err_t err;
+        for (int attempt = 0; ; attempt++) {
+            err = esp_https_ota_fetch_chunk(worker, buf, buf_size, chunk, handle->parallel.erase_chunks || attempt > 0);
+            if (err == ESP_OK || handle->parallel.stop || attempt == PARALLEL_CHUNK_MAX_RETRIES) {
+                break;
+            }
+            ESP_LOGW(TAG, "Fetching chunk %d failed, retrying (%d/%d)", chunk, attempt + 1, PARALLEL_CHUNK_MAX_RETRIES);
+            vTaskDelay(pdMS_TO_TICKS(PARALLEL_RETRY_DELAY_MS));
+        }
+        if (err != ESP_OK) {
+            esp_https_ota_parallel_fail(handle, err);
+            break;
+        }
+        esp_https_ota_parallel_chunk_done(handle, chunk);
+    }
+
+    free(buf);
+    xEventGroupSetBits(handle->parallel.events, PARALLEL_WORKER_EXIT_BIT(worker->index) | PARALLEL_PROGRESS_BIT);
+    vTaskDelete(NULL);
+}
+
+/* Loads the chunks already written from NVS if they belong to the same download */
+static void esp_https_ota_parallel_load_state(esp_https_ota_t *handle)
+{
+    if (!handle->parallel.persist) {
+        return;
+    }
+    esp_err_t err = nvs_open(PARALLEL_NVS_NAMESPACE, NVS_READWRITE, &handle->parallel.nvs);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS (%s), the download cannot be resumed", esp_err_to_name(err));
+        handle->parallel.persist = false;
+        return;
+    }
+    esp_https_ota_parallel_state_t *state = handle->parallel.state;
+    esp_https_ota_parallel_state_t *saved = malloc(handle->parallel.state_size);
+    size_t size = handle->parallel.state_size;
+    if (saved && nvs_get_blob(handle->parallel.nvs, PARALLEL_NVS_KEY, saved, &size) == ESP_OK && size == handle->parallel.state_size
+            && memcmp(saved, state, offsetof(esp_https_ota_parallel_state_t, done)) == 0) {
+        memcpy(state->done, saved->done, size - sizeof(esp_https_ota_parallel_state_t));
+        for (int chunk = 0; chunk < handle->parallel.chunk_count; chunk++) {
+            if (esp_https_ota_chunk_is_done(handle, chunk)) {
+                handle->parallel.done_bytes += esp_https_ota_chunk_len(handle, chunk);
+            }
+        }
+    }
+    free(saved);
+}
+
+/* Starts writing the image with the workers.
+ * Returns ESP_ERR_NOT_SUPPORTED if the image should be downloaded sequentially instead. */
+static esp_err_t esp_https_ota_parallel_begin(esp_https_ota_t *handle)
+{
+    esp_err_t err;
+    if (handle->binary_file_len == 0) {
+        if (read_header(handle) != ESP_OK) {
+            return ESP_FAIL;
+        }
+    }
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+    if (handle->partition.final->type == ESP_PARTITION_TYPE_APP && esp_ota_delta_is_patch(handle->ota_upgrade_buf, handle->binary_file_len)) {
+        ESP_LOGI(TAG, "A delta patch is applied in order, downloading it sequentially");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
+    if (handle->partition.final->type == ESP_PARTITION_TYPE_APP || handle->partition.final->type == ESP_PARTITION_TYPE_BOOTLOADER) {
+        err = esp_ota_verify_chip_id(handle->ota_upgrade_buf);
+        if (err != ESP_OK) {
+            return err;
+        }
+        err = esp_ota_verify_chip_revision(handle->ota_upgrade_buf);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    // The workers fetch the whole image, including the header read from this connection
+    esp_http_client_close(handle->http_client);
+    handle->binary_file_len = 0;
+
+    const esp_partition_t *staging = handle->partition.staging;
+    if (handle->image_length <= 0 || handle->image_length > staging->size) {
+        ESP_LOGE(TAG, "Image of %d bytes does not fit in the <%s> partition", handle->image_length, staging->label);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // Chunks are sector aligned, so that they can be erased independently when they are fetched again
+    const int chunk_size = (handle->max_http_request_size + staging->erase_size - 1) / staging->erase_size * staging->erase_size;
+    handle->parallel.chunk_count = (handle->image_length + chunk_size - 1) / chunk_size;
+    handle->parallel.state_size = sizeof(esp_https_ota_parallel_state_t) + (handle->parallel.chunk_count + 7) / 8;
+    handle->parallel.state = calloc(1, handle->parallel.state_size);
+    if (handle->parallel.state == NULL) {
+        ESP_LOGE(TAG, "Couldn't allocate memory for the parallel download");
+        return ESP_ERR_NO_MEM;
+    }
+    handle->parallel.state->url_crc = handle->parallel.url_crc;
+    handle->parallel.state->staging_address = staging->address;
+    handle->parallel.state->image_length = handle->image_length;
+    handle->parallel.state->chunk_size = chunk_size;
+    esp_https_ota_parallel_load_state(handle);
+    if (handle->parallel.persist) {
+        handle->parallel.saved_state = malloc(handle->parallel.state_size);
+        if (handle->parallel.saved_state == NULL) {
+            ESP_LOGE(TAG, "Couldn't allocate memory for the parallel download");
+            return ESP_ERR_NO_MEM;
+        }
+        handle->parallel.save_tick = xTaskGetTickCount();
+    }
+
+    if (handle->parallel.done_bytes > 0) {
+        ESP_LOGI(TAG, "Resuming the download, %d of %d bytes already written", handle->parallel.done_bytes, handle->image_length);
+        // The chunks still to fetch are erased by the workers
+        err = esp_ota_resume(staging, OTA_SIZE_UNKNOWN, handle->parallel.done_bytes, &handle->update_handle);
+        handle->parallel.erase_chunks = true;
+    } else {
+        err = esp_ota_begin(staging, handle->image_length, &handle->update_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Starting the OTA update failed (%s)", esp_err_to_name(err));
+        return err;
+    }
+    esp_ota_set_final_partition(handle->update_handle, handle->partition.final, handle->partition.finalize_with_copy);
+    handle->binary_file_len = handle->parallel.done_bytes;
+    handle->parallel.active = true;
+    handle->state = ESP_HTTPS_OTA_IN_PROGRESS;
+
+    ESP_LOGI(TAG, "Downloading %d chunks of %d bytes over %d connections", handle->parallel.chunk_count, chunk_size, handle->parallel.connections);
+    for (int i = 0; i < handle->parallel.connections; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "https_ota_%d", i);
+        if (xTaskCreate(esp_https_ota_worker_task, name, CONFIG_ESP_HTTPS_OTA_PARALLEL_DOWNLOAD_TASK_STACK_SIZE,
+                        &handle->parallel.workers[i], uxTaskPriorityGet(NULL), NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create the download tasks");
+            esp_https_ota_parallel_fail(handle, ESP_ERR_NO_MEM);
+            return ESP_ERR_NO_MEM;
+        }
+        handle->parallel.started++;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t esp_https_ota_parallel_perform(esp_https_ota_t *handle)
+{
+    xEventGroupWaitBits(handle->parallel.events, PARALLEL_PROGRESS_BIT, pdTRUE, pdFALSE, pdMS_TO_TICKS(PARALLEL_PERFORM_WAIT_MS));
+    xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+    const int done_bytes = handle->parallel.done_bytes;
+    esp_err_t err = handle->parallel.err;
+    xSemaphoreGive(handle->parallel.lock);
+    esp_https_ota_parallel_save_state(handle, false);
+
+    if (done_bytes != handle->binary_file_len) {
+        handle->binary_file_len = done_bytes;
+        ESP_LOGD(TAG, "Written image length %d", handle->binary_file_len);
+        esp_https_ota_dispatch_event(ESP_HTTPS_OTA_WRITE_FLASH, (void *)(&handle->binary_file_len), sizeof(int));
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Parallel download failed (%s)", esp_err_to_name(err));
+        return err;
+    }
+    if (done_bytes < handle->image_length) {
+        return ESP_ERR_HTTPS_OTA_IN_PROGRESS;
+    }
+    handle->state = ESP_HTTPS_OTA_SUCCESS;
+    return ESP_OK;
+}
+
+/* Stops the workers, the chunks they are fetching are not marked as done */
+static void esp_https_ota_parallel_stop(esp_https_ota_t *handle)
+{
+    if (handle->parallel.started == 0) {
+        return;
+    }
+    xSemaphoreTake(handle->parallel.lock, portMAX_DELAY);
+    handle->parallel.stop = true;
+    xSemaphoreGive(handle->parallel.lock);
+    EventBits_t exit_bits = 0;
+    for (int i = 0; i < handle->parallel.started; i++) {
+        exit_bits |= PARALLEL_WORKER_EXIT_BIT(i);
+    }
+    xEventGroupWaitBits(handle->parallel.events, exit_bits, pdFALSE, pdTRUE, portMAX_DELAY);
+    handle->parallel.started = 0;
+}
+#endif // CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+
+/* Size to erase in esp_ota_begin() / esp_ota_resume() */
+static size_t esp_https_ota_erase_size(const esp_https_ota_t *handle, bool is_patch)
+{
+    if (!handle->bulk_flash_erase) {
+        return OTA_WITH_SEQUENTIAL_WRITES;
+    }
+    // The length of a delta patch is not the size of the image it produces
+    return (is_patch || handle->image_length <= 0) ? OTA_SIZE_UNKNOWN : handle->image_length;
+}
+
 esp_err_t esp_https_ota_perform(esp_https_ota_handle_t https_ota_handle)
 {
     esp_https_ota_t *handle = (esp_https_ota_t *)https_ota_handle;
@@ -701,16 +1279,21 @@ esp_err_t esp_https_ota_perform(esp_https_ota_handle_t https_ota_handle)
 
     esp_err_t err;
     int data_read;
-    const size_t erase_size = handle->bulk_flash_erase ? (handle->image_length > 0 ? handle->image_length : OTA_SIZE_UNKNOWN) : OTA_WITH_SEQUENTIAL_WRITES;
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+    if (handle->parallel.active) {
+        return esp_https_ota_parallel_perform(handle);
+    }
+#endif
     switch (handle->state) {
         case ESP_HTTPS_OTA_BEGIN:
-            err = esp_ota_begin(handle->partition.staging, erase_size, &handle->update_handle);
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "esp_ota_begin failed (%s)", esp_err_to_name(err));
-                return err;
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+            if (handle->parallel.connections > 1) {
+                err = esp_https_ota_parallel_begin(handle);
+                if (err != ESP_ERR_NOT_SUPPORTED) {
+                    return (err == ESP_OK) ? ESP_ERR_HTTPS_OTA_IN_PROGRESS : err;
+                }
             }
-            esp_ota_set_final_partition(handle->update_handle, handle->partition.final, handle->partition.finalize_with_copy);
-            handle->state = ESP_HTTPS_OTA_IN_PROGRESS;
+#endif
             /* In case `esp_https_ota_get_img_desc` was invoked first,
                then the image data read there should be written to OTA partition
                */
@@ -743,6 +1326,32 @@ esp_err_t esp_https_ota_perform(esp_https_ota_handle_t https_ota_handle)
                 return ESP_FAIL;
             }
 #endif // CONFIG_ESP_HTTPS_OTA_DECRYPT_CB
+            bool is_patch = false;
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+            is_patch = handle->partition.final->type == ESP_PARTITION_TYPE_APP && esp_ota_delta_is_patch(data_buf, binary_file_len);
+            if (is_patch && handle->ota_resumption) {
+                // The bytes written to the partition are the output of the patch, not the patch itself
+                ESP_LOGE(TAG, "The download of a delta patch cannot be resumed, disable ota_resumption");
+                return ESP_ERR_NOT_SUPPORTED;
+            }
+#endif
+            err = esp_ota_begin(handle->partition.staging, esp_https_ota_erase_size(handle, is_patch), &handle->update_handle);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "esp_ota_begin failed (%s)", esp_err_to_name(err));
+                return err;
+            }
+            esp_ota_set_final_partition(handle->update_handle, handle->partition.final, handle->partition.finalize_with_copy);
+            handle->state = ESP_HTTPS_OTA_IN_PROGRESS;
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+            if (is_patch) {
+                // The new image is checked in esp_https_ota_delta_write_cb()
+                err = esp_https_ota_delta_begin(handle);
+                if (err != ESP_OK) {
+                    return err;
+                }
+                return _ota_write(handle, data_buf, binary_file_len);
+            }
+#endif
             if (handle->partition.final->type == ESP_PARTITION_TYPE_APP || handle->partition.final->type == ESP_PARTITION_TYPE_BOOTLOADER) {
                 err = esp_ota_verify_chip_id(data_buf);
                 if (err != ESP_OK) {
@@ -757,7 +1366,8 @@ esp_err_t esp_https_ota_perform(esp_https_ota_handle_t https_ota_handle)
             return _ota_write(handle, data_buf, binary_file_len);
         case ESP_HTTPS_OTA_RESUME:
             ESP_LOGD(TAG, "OTA resumption case");
-            err = esp_ota_resume(handle->partition.staging, erase_size, handle->binary_file_len, &handle->update_handle);
+            // Delta patches are rejected with ota_resumption, so the data written so far is a complete image
+            err = esp_ota_resume(handle->partition.staging, esp_https_ota_erase_size(handle, false), handle->binary_file_len, &handle->update_handle);
             if (err != ESP_OK) {
                 ESP_LOGE(TAG, "esp_ota_resume failed (%s)", esp_err_to_name(err));
                 return err;
@@ -835,7 +1445,7 @@ esp_err_t esp_https_ota_perform(esp_https_ota_handle_t https_ota_handle)
             }
             esp_http_client_set_header(handle->http_client, "Range", header_val);
             free(header_val);
-            err = _http_connect(handle);
+            err = _http_connect(handle, handle->http_client);
             if (err != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to establish HTTP connection");
                 return ESP_FAIL;
@@ -877,7 +1487,22 @@ esp_err_t esp_https_ota_finish(esp_https_ota_handle_t https_ota_handle)
     switch (handle->state) {
         case ESP_HTTPS_OTA_SUCCESS:
         case ESP_HTTPS_OTA_IN_PROGRESS:
-            err = esp_ota_end(handle->update_handle);
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+            esp_https_ota_parallel_stop(handle);
+#endif
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+            if (handle->delta) {
+                err = esp_ota_delta_end(handle->delta);
+                handle->delta = NULL;
+            }
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Applying the delta patch failed (%s)", esp_err_to_name(err));
+                esp_ota_abort(handle->update_handle);
+            } else
+#endif
+            {
+                err = esp_ota_end(handle->update_handle);
+            }
             /* falls through */
         case ESP_HTTPS_OTA_BEGIN:
         case ESP_HTTPS_OTA_RESUME:
@@ -905,6 +1530,15 @@ esp_err_t esp_https_ota_finish(esp_https_ota_handle_t https_ota_handle)
             esp_https_ota_dispatch_event(ESP_HTTPS_OTA_UPDATE_BOOT_PARTITION, (void *)(&handle->partition.final->subtype), sizeof(esp_partition_subtype_t));
         }
     }
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+    if (handle->parallel.persist && err == ESP_OK && handle->state == ESP_HTTPS_OTA_SUCCESS) {
+        // The download is complete, it must not be resumed anymore
+        if (nvs_erase_key(handle->parallel.nvs, PARALLEL_NVS_KEY) == ESP_OK) {
+            nvs_commit(handle->parallel.nvs);
+        }
+    }
+    esp_https_ota_parallel_cleanup(handle);
+#endif
     free(handle);
     esp_https_ota_dispatch_event(ESP_HTTPS_OTA_FINISH, NULL, 0);
 
@@ -928,6 +1562,14 @@ esp_err_t esp_https_ota_abort(esp_https_ota_handle_t https_ota_handle)
     switch (handle->state) {
         case ESP_HTTPS_OTA_SUCCESS:
         case ESP_HTTPS_OTA_IN_PROGRESS:
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+            // The state saved to NVS is kept, so that the download can be resumed
+            esp_https_ota_parallel_stop(handle);
+            esp_https_ota_parallel_save_state(handle, true);
+#endif
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_DELTA_UPDATE
+            esp_ota_delta_abort(handle->delta);
+#endif
             err = esp_ota_abort(handle->update_handle);
             /* falls through */
         case ESP_HTTPS_OTA_BEGIN:
@@ -944,6 +1586,9 @@ esp_err_t esp_https_ota_abort(esp_https_ota_handle_t https_ota_handle)
             ESP_LOGE(TAG, "Invalid ESP HTTPS OTA State");
             break;
     }
+#if CONFIG_ESP_HTTPS_OTA_ENABLE_PARALLEL_DOWNLOAD
+    esp_https_ota_parallel_cleanup(handle);
+#endif
     free(handle);
     return err;
 }
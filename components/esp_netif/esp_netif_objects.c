@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -8,6 +8,7 @@
 #include "sys/queue.h"
 #include "esp_log.h"
 #include "esp_netif_private.h"
+#include "freertos/FreeRTOS.h"
 #include <string.h>
 
 //
@@ -20,15 +21,96 @@ static const char *TAG = "esp_netif_objects";
 typedef struct slist_netifs_s slist_netifs_t;
 struct slist_netifs_s {
     esp_netif_t *netif;
-    SLIST_ENTRY(slist_netifs_s) next;
+    LIST_ENTRY(slist_netifs_s) next;
+    slist_netifs_t *netif_bucket_next;  // next item in the same bucket of s_netif_index
+    slist_netifs_t *ifkey_bucket_next;  // next item in the same bucket of s_ifkey_index
+    uint32_t ifkey_hash;
 };
 
-SLIST_HEAD(slisthead, slist_netifs_s) s_head = { .slh_first = NULL, };
+LIST_HEAD(slisthead, slist_netifs_s) s_head = { .lh_first = NULL, };
 
 static size_t s_esp_netif_counter = 0;
 
+//
+// Hash tables to find list items by netif handle and by if_key, both with s_index_size buckets (a power of 2).
+// The if_key of a netif is configured after it is added to the list, so the if_key index is rebuilt
+// on the first lookup after the list changed.
+//
+#define NETIF_INDEX_MIN_SIZE 8
+
+static slist_netifs_t **s_netif_index = NULL;
+static slist_netifs_t **s_ifkey_index = NULL;
+static size_t s_index_size = 0;
+static bool s_ifkey_index_valid = false;
+
+// Protects the list and the indexes. Functions which modify the list must still be serialized by the caller
+// (typically by running in the TCPIP context), as they allocate and free the items outside of the lock.
+// The readers which run in the same context (esp_netif_next_unsafe(), esp_netif_is_netif_listed()) do not take it.
+static portMUX_TYPE s_list_lock = portMUX_INITIALIZER_UNLOCKED;
+
 ESP_EVENT_DEFINE_BASE(IP_EVENT);
 
+//
+// Index helpers, called with s_list_lock held
+//
+static inline uint32_t netif_hash(const esp_netif_t *netif)
+{
+    uint32_t hash = (uint32_t)(uintptr_t)netif;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bU;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// FNV-1a
+static inline uint32_t ifkey_hash(const char *if_key)
+{
+    uint32_t hash = 2166136261U;
+    while (*if_key) {
+        hash = (hash ^ (uint8_t)*if_key++) * 16777619U;
+    }
+    return hash;
+}
+
+static void netif_index_insert(slist_netifs_t *item)
+{
+    slist_netifs_t **bucket = &s_netif_index[netif_hash(item->netif) & (s_index_size - 1)];
+    item->netif_bucket_next = *bucket;
+    *bucket = item;
+}
+
+static slist_netifs_t *netif_index_find(const esp_netif_t *netif)
+{
+    if (s_netif_index == NULL) {
+        return NULL;
+    }
+    slist_netifs_t *item = s_netif_index[netif_hash(netif) & (s_index_size - 1)];
+    while (item && item->netif != netif) {
+        item = item->netif_bucket_next;
+    }
+    return item;
+}
+
+static void ifkey_index_rebuild(void)
+{
+    struct slist_netifs_s *item;
+    bool complete = true;
+    memset(s_ifkey_index, 0, s_index_size * sizeof(slist_netifs_t *));
+    LIST_FOREACH(item, &s_head, next) {
+        const char *if_key = esp_netif_get_ifkey(item->netif);
+        if (if_key == NULL) {
+            // netif just being created, index it on the next lookup
+            complete = false;
+            continue;
+        }
+        item->ifkey_hash = ifkey_hash(if_key);
+        slist_netifs_t **bucket = &s_ifkey_index[item->ifkey_hash & (s_index_size - 1)];
+        item->ifkey_bucket_next = *bucket;
+        *bucket = item;
+    }
+    s_ifkey_index_valid = complete;
+}
+
 //
 // List manipulation functions
 //
@@ -41,29 +123,76 @@ esp_err_t esp_netif_add_to_list_unsafe(esp_netif_t *netif)
     }
     item->netif = netif;
 
-    SLIST_INSERT_HEAD(&s_head, item, next);
-    ++s_esp_netif_counter;
-    ESP_LOGD(TAG, "%s netif added successfully (total netifs: %" PRIu32 ")", __func__, (uint32_t)s_esp_netif_counter);
+    // Grow the indexes if needed, allocating outside of the critical section
+    slist_netifs_t **new_index = NULL;
+    size_t new_size = 0;
+    if (s_esp_netif_counter >= s_index_size) {
+        new_size = s_index_size ? 2 * s_index_size : NETIF_INDEX_MIN_SIZE;
+        new_index = calloc(2 * new_size, sizeof(slist_netifs_t *));
+        if (new_index == NULL && s_netif_index == NULL) {
+            free(item);
+            return ESP_ERR_NO_MEM;
+        }
+        // if growing failed, the current indexes still work with longer chains
+    }
+
+    slist_netifs_t **old_index = NULL;
+    portENTER_CRITICAL(&s_list_lock);
+    if (new_index) {
+        old_index = s_netif_index;
+        s_netif_index = new_index;
+        s_ifkey_index = new_index + new_size;
+        s_index_size = new_size;
+        struct slist_netifs_s *it;
+        LIST_FOREACH(it, &s_head, next) {
+            netif_index_insert(it);
+        }
+    }
+    LIST_INSERT_HEAD(&s_head, item, next);
+    netif_index_insert(item);
+    s_ifkey_index_valid = false;
+    size_t counter = ++s_esp_netif_counter;
+    portEXIT_CRITICAL(&s_list_lock);
+
+    free(old_index);
+    ESP_LOGD(TAG, "%s netif added successfully (total netifs: %" PRIu32 ")", __func__, (uint32_t)counter);
     return ESP_OK;
 }
 
 
 esp_err_t esp_netif_remove_from_list_unsafe(esp_netif_t *netif)
 {
-    struct slist_netifs_s *item;
+    slist_netifs_t **old_index = NULL;
     ESP_LOGV(TAG, "%s %p", __func__, netif);
 
-    SLIST_FOREACH(item, &s_head, next) {
-        if (item->netif == netif) {
-            SLIST_REMOVE(&s_head, item, slist_netifs_s, next);
-            assert(s_esp_netif_counter > 0);
-            --s_esp_netif_counter;
-            ESP_LOGD(TAG, "%s netif successfully removed (total netifs: %" PRIu32 ")", __func__, (uint32_t)s_esp_netif_counter);
-            free(item);
-            return ESP_OK;
-        }
+    portENTER_CRITICAL(&s_list_lock);
+    struct slist_netifs_s *item = netif_index_find(netif);
+    if (item == NULL) {
+        portEXIT_CRITICAL(&s_list_lock);
+        return ESP_ERR_NOT_FOUND;
+    }
+    slist_netifs_t **bucket = &s_netif_index[netif_hash(netif) & (s_index_size - 1)];
+    while (*bucket != item) {
+        bucket = &(*bucket)->netif_bucket_next;
     }
-    return ESP_ERR_NOT_FOUND;
+    *bucket = item->netif_bucket_next;
+    LIST_REMOVE(item, next);
+    s_ifkey_index_valid = false;
+    assert(s_esp_netif_counter > 0);
+    size_t counter = --s_esp_netif_counter;
+    if (counter == 0) {
+        // release the indexes with the last netif
+        old_index = s_netif_index;
+        s_netif_index = NULL;
+        s_ifkey_index = NULL;
+        s_index_size = 0;
+    }
+    portEXIT_CRITICAL(&s_list_lock);
+
+    free(item);
+    free(old_index);
+    ESP_LOGD(TAG, "%s netif successfully removed (total netifs: %" PRIu32 ")", __func__, (uint32_t)counter);
+    return ESP_OK;
 }
 
 size_t esp_netif_get_nr_of_ifs(void)
@@ -84,39 +213,59 @@ esp_netif_t* esp_netif_next_unsafe(esp_netif_t* netif)
     struct slist_netifs_s *item;
     // Getting the first netif if argument is NULL
     if (netif == NULL) {
-        item = SLIST_FIRST(&s_head);
+        item = LIST_FIRST(&s_head);
         return (item == NULL) ? NULL : item->netif;
     }
     // otherwise the next one (after the supplied netif)
-    SLIST_FOREACH(item, &s_head, next) {
+    LIST_FOREACH(item, &s_head, next) {
         if (item->netif == netif) {
-            item = SLIST_NEXT(item, next);
+            item = LIST_NEXT(item, next);
             return (item == NULL) ? NULL : item->netif;
         }
     }
     return NULL;
 }
 
-bool esp_netif_is_netif_listed(esp_netif_t *esp_netif)
+size_t esp_netif_list_snapshot(esp_netif_t *netifs[], size_t max_netifs)
 {
     struct slist_netifs_s *item;
-    SLIST_FOREACH(item, &s_head, next) {
-        if (item->netif == esp_netif) {
-            return true;
+    size_t i = 0;
+    portENTER_CRITICAL(&s_list_lock);
+    LIST_FOREACH(item, &s_head, next) {
+        if (i == max_netifs) {
+            break;
         }
+        netifs[i++] = item->netif;
     }
-    return false;
+    size_t counter = s_esp_netif_counter;
+    portEXIT_CRITICAL(&s_list_lock);
+    return counter;
+}
+
+// Called in the TCPIP context, like the functions modifying the list, so the index is read without the lock
+bool esp_netif_is_netif_listed(esp_netif_t *esp_netif)
+{
+    return netif_index_find(esp_netif) != NULL;
 }
 
 esp_netif_t *esp_netif_get_handle_from_ifkey_unsafe(const char *if_key)
 {
-    struct slist_netifs_s *item;
+    esp_netif_t *esp_netif = NULL;
+    uint32_t hash = ifkey_hash(if_key);
 
-    SLIST_FOREACH(item, &s_head, next) {
-        esp_netif_t *esp_netif = item->netif;
-        if (strcmp(if_key, esp_netif_get_ifkey(esp_netif)) == 0) {
-            return esp_netif;
+    portENTER_CRITICAL(&s_list_lock);
+    if (s_ifkey_index != NULL) {
+        if (!s_ifkey_index_valid) {
+            ifkey_index_rebuild();
+        }
+        struct slist_netifs_s *item = s_ifkey_index[hash & (s_index_size - 1)];
+        for (; item != NULL; item = item->ifkey_bucket_next) {
+            if (item->ifkey_hash == hash && strcmp(if_key, esp_netif_get_ifkey(item->netif)) == 0) {
+                esp_netif = item->netif;
+                break;
+            }
         }
     }
-    return NULL;
+    portEXIT_CRITICAL(&s_list_lock);
+    return esp_netif;
 }
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2019-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2019-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -1141,6 +1141,23 @@ typedef bool (*esp_netif_find_predicate_t)(esp_netif_t *netif, void *ctx);
  */
 esp_netif_t *esp_netif_find_if(esp_netif_find_predicate_t fn, void *ctx);
 
+/**
+ * @brief Copies handles of the registered interfaces to the supplied array
+ *
+ * The list is copied within a short internal lock, so that the caller can then go through the interfaces
+ * without holding any lock and outside of the TCPIP context, unlike esp_netif_next_unsafe() loops
+ * or esp_netif_find_if() predicates.
+ *
+ * @note The copy does not reflect interfaces created or destroyed after this call. As with the handles returned
+ * by esp_netif_find_if(), the caller must not use the handle of an interface which might have been destroyed.
+ *
+ * @param[out] netifs Array to be filled with interface handles, in the same order as esp_netif_next_unsafe() returns them
+ * @param[in] max_netifs Number of elements of the array
+ *
+ * @return Number of registered interfaces. If it is greater than max_netifs, only the first max_netifs handles were copied.
+ */
+size_t esp_netif_list_snapshot(esp_netif_t *netifs[], size_t max_netifs);
+
 /**
  * @brief Returns number of registered esp_netif objects
  *
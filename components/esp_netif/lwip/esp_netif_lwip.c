@@ -869,17 +869,10 @@ esp_netif_t *esp_netif_new(const esp_netif_config_t *config)
     return netif;
 }
 
-static esp_err_t get_handle_from_ifkey_api(esp_netif_api_msg_t *msg)
-{
-    *msg->p_esp_netif = esp_netif_get_handle_from_ifkey_unsafe(msg->data);
-    return ESP_OK;
-}
-
 esp_netif_t *esp_netif_get_handle_from_ifkey(const char *if_key)
 {
-    esp_netif_t *netif = NULL;
-    esp_netif_lwip_ipc_call_get_netif(get_handle_from_ifkey_api, &netif, (void*)if_key);
-    return netif;
+    // the list of netifs has its own lock, no need to switch to the TCPIP context
+    return esp_netif_get_handle_from_ifkey_unsafe(if_key);
 }
 
 typedef struct find_if_api {
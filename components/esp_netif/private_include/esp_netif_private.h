@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -83,8 +83,8 @@ bool esp_netif_is_valid_static_ip(esp_netif_ip_info_t *ip_info);
 
 /**
  * @brief Adds created interface to the list of netifs.
- * This function doesn't lock the list, so you need to call esp_netif_list_lock/unlock
- * manually before and after the call.
+ * The list is updated under its internal lock, but calls which add or remove interfaces
+ * must be serialized by the caller (e.g. run in the TCPIP context).
  *
  * @param[in]  esp_netif Handle to esp-netif instance
  *
@@ -96,8 +96,8 @@ esp_err_t esp_netif_add_to_list_unsafe(esp_netif_t* netif);
 
 /**
  * @brief Removes interface to be destroyed from the list of netifs
- * This function doesn't lock the list, so you need to call esp_netif_list_lock/unlock
- * manually before and after the call.
+ * The list is updated under its internal lock, but calls which add or remove interfaces
+ * must be serialized by the caller (e.g. run in the TCPIP context).
  *
  * @param[in]  esp_netif Handle to esp-netif instance
  *
@@ -118,7 +118,7 @@ bool esp_netif_is_netif_listed(esp_netif_t *esp_netif);
 
 /**
  * @brief Get esp_netif handle based on the if_key
- * This doesn't lock the list nor TCPIP context
+ * This locks the list (briefly, the interfaces are indexed by if_key), but not the TCPIP context
  *
  * @param if_key
  * @return esp_netif handle if found, NULL otherwise
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
@@ -53,6 +53,44 @@ void create_delete_multiple_netifs(void)
 }
 
 
+void list_snapshot(void)
+{
+    const char* if_keys[] = { "if1", "if2", "if3", "if4", "if5", "if6", "if7", "if8", "if9" };
+    const int nr_of_netifs = sizeof(if_keys)/sizeof(char*);
+    esp_netif_t *netifs[nr_of_netifs];
+    esp_netif_t *snapshot[nr_of_netifs];
+
+    for (int i=0; i<nr_of_netifs; ++i) {
+        esp_netif_inherent_config_t base_netif_config = { .if_key = if_keys[i]};
+        esp_netif_config_t cfg = { .base = &base_netif_config, .stack = ESP_NETIF_NETSTACK_DEFAULT_WIFI_STA };
+        netifs[i] = esp_netif_new(&cfg);
+        TEST_ASSERT_NOT_NULL(netifs[i]);
+    }
+
+    // the snapshot lists the netifs in the same order as esp_netif_next_unsafe()
+    TEST_ASSERT_EQUAL(nr_of_netifs, esp_netif_list_snapshot(snapshot, nr_of_netifs));
+    esp_netif_t *netif = NULL;
+    for (int i=0; i<nr_of_netifs; ++i) {
+        netif = esp_netif_next_unsafe(netif);
+        TEST_ASSERT_EQUAL(netif, snapshot[i]);
+    }
+
+    // a smaller array gets the first netifs only, but the total number is returned
+    memset(snapshot, 0, sizeof(snapshot));
+    TEST_ASSERT_EQUAL(nr_of_netifs, esp_netif_list_snapshot(snapshot, 2));
+    TEST_ASSERT_EQUAL(esp_netif_next_unsafe(NULL), snapshot[0]);
+    TEST_ASSERT_EQUAL(NULL, snapshot[2]);
+
+    // the snapshot is not updated when netifs are destroyed
+    esp_netif_list_snapshot(snapshot, nr_of_netifs);
+    for (int i=0; i<nr_of_netifs; ++i) {
+        esp_netif_destroy(netifs[i]);
+        TEST_ASSERT_EQUAL(nr_of_netifs - i - 1, esp_netif_list_snapshot(NULL, 0));
+        TEST_ASSERT_EQUAL(NULL, esp_netif_get_handle_from_ifkey(if_keys[i]));
+    }
+}
+
+
 void get_from_if_key(void)
 {
     // init default netif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
@@ -12,3 +12,4 @@
 // List of tests that are common for both configurations
 void create_delete_multiple_netifs(void);
 void get_from_if_key(void);
+void list_snapshot(void);
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
@@ -35,10 +35,16 @@ TEST(esp_netif, get_from_if_key)
     get_from_if_key();
 }
 
+TEST(esp_netif, list_snapshot)
+{
+    list_snapshot();
+}
+
 TEST_GROUP_RUNNER(esp_netif)
 {
     RUN_TEST_CASE(esp_netif, create_delete_multiple_netifs)
     RUN_TEST_CASE(esp_netif, get_from_if_key)
+    RUN_TEST_CASE(esp_netif, list_snapshot)
 }
 
 void app_main(void)
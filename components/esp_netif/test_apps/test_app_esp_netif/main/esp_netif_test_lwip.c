@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
@@ -95,6 +95,11 @@ TEST(esp_netif, get_from_if_key)
     get_from_if_key();
 }
 
+TEST(esp_netif, list_snapshot)
+{
+    list_snapshot();
+}
+
 // This is a private esp-netif API, but include here to test it
 bool esp_netif_is_netif_listed(esp_netif_t *esp_netif);
 
@@ -591,6 +596,7 @@ TEST_GROUP_RUNNER(esp_netif)
     RUN_TEST_CASE(esp_netif, convert_ip_addresses)
     RUN_TEST_CASE(esp_netif, get_from_if_key)
     RUN_TEST_CASE(esp_netif, create_delete_multiple_netifs)
+    RUN_TEST_CASE(esp_netif, list_snapshot)
     RUN_TEST_CASE(esp_netif, find_netifs)
 #ifdef CONFIG_ESP_WIFI_ENABLED
     RUN_TEST_CASE(esp_netif, wifi_netif_api_null_deref)
@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Host benchmark of lookups in the list of netifs (esp_netif_objects.c) with an increasing number
+ * of loopback netifs. The lookups should not get slower with more netifs. Going through all the netifs
+ * takes time proportional to their number with a snapshot, and to its square with esp_netif_next_unsafe(),
+ * which walks the list from its head to find the current netif. Run with "make benchmark". */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "esp_netif.h"
+#include "esp_netif_private.h"
+
+#define ITERATIONS  2000000
+#define MAX_NETIFS  64
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile uintptr_t s_sink;
+
+#define BENCH(name, iterations, expr) do {                                  \
+        double t0 = now_ns();                                               \
+        for (int i = 0; i < (iterations); i++) {                            \
+            s_sink += (uintptr_t)(expr);                                    \
+        }                                                                   \
+        printf("  %-44s %9.1f ns\n", name, (now_ns() - t0) / (iterations)); \
+    } while (0)
+
+static esp_netif_t *iterate_all(void)
+{
+    esp_netif_t *netif = NULL;
+    esp_netif_t *last = NULL;
+    while ((netif = esp_netif_next_unsafe(netif)) != NULL) {
+        last = netif;
+    }
+    return last;
+}
+
+static esp_netif_t *iterate_snapshot(void)
+{
+    esp_netif_t *netifs[MAX_NETIFS];
+    size_t nr_of_netifs = esp_netif_list_snapshot(netifs, MAX_NETIFS);
+    return netifs[nr_of_netifs - 1];
+}
+
+int main(void)
+{
+    static const int counts[] = { 1, 4, 16, 64 };
+    static char if_keys[MAX_NETIFS][16];
+    esp_netif_t *netifs[MAX_NETIFS];
+
+    esp_netif_init();
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int n = counts[c];
+        for (int i = 0; i < n; i++) {
+            /* Keys with a common prefix, as the default ones ("WIFI_STA_DEF", "ETH_DEF", ...) */
+            snprintf(if_keys[i], sizeof(if_keys[i]), "ETH_DEF_%d", i);
+            esp_netif_inherent_config_t base = { .if_key = if_keys[i], .if_desc = "eth" };
+            esp_netif_config_t cfg = { .base = &base, .stack = (const esp_netif_netstack_config_t *)1 };
+            netifs[i] = esp_netif_new(&cfg);
+        }
+        printf("%d netifs\n", n);
+        /* Lookups of each interface in turn: the first created is the last in the list */
+        BENCH("esp_netif_get_handle_from_ifkey", ITERATIONS, esp_netif_get_handle_from_ifkey(if_keys[i % n]));
+        BENCH("esp_netif_get_handle_from_ifkey, missing", ITERATIONS, esp_netif_get_handle_from_ifkey("WIFI_AP_DEF"));
+        BENCH("esp_netif_is_netif_listed", ITERATIONS, esp_netif_is_netif_listed(netifs[i % n]));
+        BENCH("esp_netif_next_unsafe over all netifs", ITERATIONS / n, iterate_all());
+        BENCH("esp_netif_list_snapshot of all netifs", ITERATIONS / n, iterate_snapshot());
+        for (int i = 0; i < n; i++) {
+            esp_netif_destroy(netifs[i]);
+        }
+    }
+    return 0;
+}
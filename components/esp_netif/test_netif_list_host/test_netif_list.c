@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Randomized test of the list of netifs (esp_netif_objects.c) with loopback netifs,
+ * checked against a plain array of the expected interfaces after each step */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_netif.h"
+#include "esp_netif_private.h"
+
+#define MAX_NETIFS  80
+#define STEPS       20000
+
+static int s_failures;
+
+#define CHECK(cond, ...) do {                                   \
+        if (!(cond)) {                                          \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);         \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            if (++s_failures > 20) {                            \
+                exit(1);                                        \
+            }                                                   \
+        }                                                       \
+    } while (0)
+
+/* Expected list, newest interface first, as esp_netif_next_unsafe() returns them */
+static esp_netif_t *s_netifs[MAX_NETIFS];
+static int s_key_ids[MAX_NETIFS];
+static size_t s_nr_of_netifs;
+static bool s_key_used[2 * MAX_NETIFS];
+
+static esp_netif_t *create_netif(int key_id)
+{
+    char if_key[16];
+    snprintf(if_key, sizeof(if_key), "IF_%d", key_id);
+    esp_netif_inherent_config_t base = { .if_key = if_key, .if_desc = "test" };
+    esp_netif_config_t cfg = { .base = &base, .stack = (const esp_netif_netstack_config_t *)1 };
+    return esp_netif_new(&cfg);
+}
+
+static void check_list(void)
+{
+    char if_key[16];
+    esp_netif_t *snapshot[MAX_NETIFS];
+
+    CHECK(esp_netif_get_nr_of_ifs() == s_nr_of_netifs, "%zu netifs, expected %zu", esp_netif_get_nr_of_ifs(), s_nr_of_netifs);
+
+    esp_netif_t *netif = NULL;
+    for (size_t i = 0; i < s_nr_of_netifs; i++) {
+        netif = esp_netif_next_unsafe(netif);
+        CHECK(netif == s_netifs[i], "esp_netif_next_unsafe() at %zu", i);
+        CHECK(esp_netif_is_netif_listed(s_netifs[i]), "esp_netif_is_netif_listed() at %zu", i);
+        snprintf(if_key, sizeof(if_key), "IF_%d", s_key_ids[i]);
+        CHECK(esp_netif_get_handle_from_ifkey(if_key) == s_netifs[i], "lookup of %s", if_key);
+    }
+    CHECK(esp_netif_next_unsafe(netif) == NULL, "esp_netif_next_unsafe() after the last netif");
+
+    for (int key_id = 0; key_id < 2 * MAX_NETIFS; key_id++) {
+        if (!s_key_used[key_id]) {
+            snprintf(if_key, sizeof(if_key), "IF_%d", key_id);
+            CHECK(esp_netif_get_handle_from_ifkey(if_key) == NULL, "lookup of missing %s", if_key);
+        }
+    }
+    CHECK(esp_netif_get_handle_from_ifkey("IF_") == NULL, "lookup of a key prefix");
+
+    size_t max = rand() % (MAX_NETIFS + 1);
+    CHECK(esp_netif_list_snapshot(snapshot, max) == s_nr_of_netifs, "esp_netif_list_snapshot() count");
+    for (size_t i = 0; i < s_nr_of_netifs && i < max; i++) {
+        CHECK(snapshot[i] == s_netifs[i], "esp_netif_list_snapshot() at %zu", i);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+    srand(seed);
+    printf("Testing the list of netifs, seed %u\n", seed);
+
+    esp_netif_init();
+    check_list();
+    for (int step = 0; step < STEPS; step++) {
+        /* Grow and shrink the list in phases, so that the indexes are resized and released */
+        bool grow = ((step / 500) % 2 == 0) ? (rand() % 4 != 0) : (rand() % 4 == 0);
+        if ((grow && s_nr_of_netifs < MAX_NETIFS) || s_nr_of_netifs == 0) {
+            int key_id;
+            do {
+                key_id = rand() % (2 * MAX_NETIFS);
+            } while (s_key_used[key_id]);
+            esp_netif_t *netif = create_netif(key_id);
+            CHECK(netif != NULL, "esp_netif_new()");
+            memmove(&s_netifs[1], &s_netifs[0], s_nr_of_netifs * sizeof(s_netifs[0]));
+            memmove(&s_key_ids[1], &s_key_ids[0], s_nr_of_netifs * sizeof(s_key_ids[0]));
+            s_netifs[0] = netif;
+            s_key_ids[0] = key_id;
+            s_key_used[key_id] = true;
+            s_nr_of_netifs++;
+        } else {
+            size_t i = rand() % s_nr_of_netifs;
+            esp_netif_destroy(s_netifs[i]);
+            s_key_used[s_key_ids[i]] = false;
+            s_nr_of_netifs--;
+            memmove(&s_netifs[i], &s_netifs[i + 1], (s_nr_of_netifs - i) * sizeof(s_netifs[0]));
+            memmove(&s_key_ids[i], &s_key_ids[i + 1], (s_nr_of_netifs - i) * sizeof(s_key_ids[0]));
+        }
+        check_list();
+    }
+    while (s_nr_of_netifs > 0) {
+        esp_netif_destroy(s_netifs[--s_nr_of_netifs]);
+    }
+    CHECK(esp_netif_next_unsafe(NULL) == NULL, "list not empty");
+    CHECK(esp_netif_remove_from_list_unsafe(s_netifs[0]) == ESP_ERR_NOT_FOUND, "removing a netif twice");
+
+    if (s_failures) {
+        printf("%d failures\n", s_failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
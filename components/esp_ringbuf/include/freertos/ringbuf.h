@@ -61,6 +61,7 @@ typedef struct xSTATIC_RINGBUFFER {
     BaseType_t xDummy4;
     StaticList_t xDummy5[2];
     void * pvDummy6;
+    UBaseType_t uxDummy7;
     portMUX_TYPE muxDummy;
     /** @endcond */
 } StaticRingbuffer_t;
@@ -110,6 +111,50 @@ RingbufHandle_t xRingbufferCreateStatic(size_t xBufferSize,
                                         uint8_t *pucRingbufferStorage,
                                         StaticRingbuffer_t *pxStaticRingbuffer);
 
+/**
+ * @brief       Create a single-producer/single-consumer ring buffer
+ *
+ * Single-producer/single-consumer (SPSC) ring buffers do not take the ring buffer's
+ * spinlock when sending, receiving or returning items. The sender and the receiver
+ * only synchronize through the buffer's write and free positions, the spinlock is
+ * only used when one side has to block because the buffer is full or empty.
+ *
+ * @param[in]   xBufferSize Size of the buffer in bytes. Note that items require
+ *              space for a header in no-split buffers
+ * @param[in]   xBufferType Type of ring buffer, must be RINGBUF_TYPE_NOSPLIT or RINGBUF_TYPE_BYTEBUF
+ *
+ * @note    At any time, at most one task (or ISR) may send to the ring buffer and at most one task
+ *          (or ISR) may receive from it. The sending and the receiving side may be different tasks.
+ * @note    Items of no-split SPSC buffers must be returned in the order they were received.
+ * @note    At most one item of a no-split SPSC buffer can be acquired with xRingbufferSendAcquire() at a time.
+ *          Until it is completed with xRingbufferSendComplete(), sending or acquiring another item fails.
+ * @note    xBufferSize of no-split buffers will be rounded up to the nearest 32-bit aligned size.
+ * @note    SPSC ring buffers cannot be added to a queue set.
+ *
+ * @return  A handle to the created ring buffer, or NULL in case of error.
+ */
+RingbufHandle_t xRingbufferCreateSPSC(size_t xBufferSize, RingbufferType_t xBufferType);
+
+/**
+ * @brief       Create a single-producer/single-consumer ring buffer but manually provide the required memory
+ *
+ * @param[in]   xBufferSize Size of the buffer in bytes.
+ * @param[in]   xBufferType Type of ring buffer, must be RINGBUF_TYPE_NOSPLIT or RINGBUF_TYPE_BYTEBUF
+ * @param[in]   pucRingbufferStorage Pointer to the ring buffer's storage area.
+ *              Storage area must have the same size as specified by xBufferSize
+ * @param[in]   pxStaticRingbuffer Pointed to a struct of type StaticRingbuffer_t
+ *              which will be used to hold the ring buffer's data structure
+ *
+ * @note    See xRingbufferCreateSPSC() for the restrictions of SPSC ring buffers.
+ * @note    xBufferSize of no-split buffers MUST be 32-bit aligned.
+ *
+ * @return  A handle to the created ring buffer, or NULL in case of error.
+ */
+RingbufHandle_t xRingbufferCreateStaticSPSC(size_t xBufferSize,
+                                            RingbufferType_t xBufferType,
+                                            uint8_t *pucRingbufferStorage,
+                                            StaticRingbuffer_t *pxStaticRingbuffer);
+
 /**
  * @brief       Insert an item into the ring buffer
  *
@@ -191,10 +236,12 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
  *       aligned fashion.
  * @note An xItemSize of 0 will result in a buffer being acquired, but the buffer
  *       will have a size of 0.
+ * @note On SPSC ring buffers, only one item can be acquired at a time, see xRingbufferCreateSPSC().
  *
  * @return
  *      - pdTRUE if succeeded
  *      - pdFALSE on time-out or when the data is larger than the maximum permissible size of the buffer
+ *      - pdFALSE on SPSC ring buffers if an acquired item is not completed yet
  */
 BaseType_t xRingbufferSendAcquire(RingbufHandle_t xRingbuffer, void **ppvItem, size_t xItemSize, TickType_t xTicksToWait);
 
@@ -364,6 +411,32 @@ void *xRingbufferReceiveUpTo(RingbufHandle_t xRingbuffer,
  */
 void *xRingbufferReceiveUpToFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemSize, size_t xMaxSize);
 
+/**
+ * @brief   Retrieve several items from a no-split ring buffer, or all contiguous data from a byte buffer
+ *
+ * Attempt to retrieve up to uxMaxItems items in a single call. This function will block
+ * until at least one item is available or until it times out, then retrieves every
+ * item that is available without blocking again. On byte buffers, a single contiguous
+ * span of data (the same as returned by xRingbufferReceive()) is retrieved.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to retrieve the items from
+ * @param[out]  ppvItems        Array of at least uxMaxItems entries, filled with pointers to the retrieved items
+ * @param[out]  pxItemSizes     Array of at least uxMaxItems entries, filled with the sizes of the retrieved items
+ * @param[in]   uxMaxItems      Maximum number of items to retrieve, must be larger than 0
+ * @param[in]   xTicksToWait    Ticks to wait for the first item in the ring buffer.
+ *
+ * @note    Each retrieved item must be returned with vRingbufferReturnItem(), in the order
+ *          they were retrieved for single-producer/single-consumer buffers.
+ * @note    This function must not be called on allow-split buffers.
+ *
+ * @return  Number of items retrieved, 0 on timeout.
+ */
+UBaseType_t xRingbufferReceiveMany(RingbufHandle_t xRingbuffer,
+                                   void **ppvItems,
+                                   size_t *pxItemSizes,
+                                   UBaseType_t uxMaxItems,
+                                   TickType_t xTicksToWait);
+
 /**
  * @brief   Return a previously-retrieved item to the ring buffer
  *
@@ -27,6 +27,11 @@
 #define rbBUFFER_FULL_FLAG          ( ( UBaseType_t ) 4 )   //The ring buffer is currently full (write pointer == free pointer)
 #define rbBUFFER_STATIC_FLAG        ( ( UBaseType_t ) 8 )   //The ring buffer is statically allocated
 #define rbUSING_QUEUE_SET           ( ( UBaseType_t ) 16 )  //The ring buffer has been added to a queue set
+#define rbSPSC_FLAG                 ( ( UBaseType_t ) 32 )  //The ring buffer is a lock-free single-producer/single-consumer buffer
+
+//Waiting flags of single-producer/single-consumer ring buffers
+#define rbSPSC_TX_WAITING           ( ( UBaseType_t ) 1 )   //The sender is blocked (or about to block) waiting for free space
+#define rbSPSC_RX_WAITING           ( ( UBaseType_t ) 2 )   //The receiver is blocked (or about to block) waiting for data
 
 //Item flags
 #define rbITEM_FREE_FLAG            ( ( UBaseType_t ) 1 )   //Item has been retrieved and returned by application, free to overwrite
@@ -67,10 +72,11 @@ typedef struct RingbufferDefinition {
     uint8_t *pucHead;                           //Pointer to the start of the ring buffer storage area
     uint8_t *pucTail;                           //Pointer to the end of the ring buffer storage area
 
-    BaseType_t xItemsWaiting;                   //Number of items/bytes(for byte buffers) currently in ring buffer that have not yet been read
+    BaseType_t xItemsWaiting;                   //Number of items/bytes(for byte buffers) currently in ring buffer that have not yet been read. Atomic in SPSC buffers
     List_t xTasksWaitingToSend;                 //List of tasks that are blocked waiting to send/acquire onto this ring buffer. Stored in priority order.
     List_t xTasksWaitingToReceive;              //List of tasks that are blocked waiting to receive from this ring buffer. Stored in priority order.
     QueueSetHandle_t xQueueSet;                 //Ring buffer's read queue set handle.
+    UBaseType_t uxSPSCWaiting;                  //SPSC buffers only. Which side is blocked, only modified with the spinlock held
 
     portMUX_TYPE mux;                           //Spinlock required for SMP
 } Ringbuffer_t;
@@ -202,6 +208,74 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
                                            size_t *xItemSize2,
                                            size_t xMaxSize);
 
+/*
+Single-producer/single-consumer (SPSC) ring buffers
+
+The sender owns pucAcquire and publishes pucWrite, the receiver owns pucRead and publishes pucFree.
+Each side only loads the position published by the other side (acquire) and publishes its own
+(release), therefore none of the following functions take the spinlock on the fast path.
+pucWrite == pucFree means the buffer is empty. The sender never lets pucAcquire catch up with
+pucFree, so that no full flag (which would be written by both sides) is needed.
+The spinlock is only taken by a side which has to block, and by the other side to wake it up
+if it has announced itself in uxSPSCWaiting.
+xItemsWaiting is updated by both sides with atomic operations, so that any task can read it.
+*/
+
+//Checks if an item will currently fit in a SPSC ring buffer. Must only be called by the sender
+static BaseType_t prvSPSCCheckItemFits(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
+
+//Get the maximum size an item that can currently have if sent to a SPSC ring buffer
+static size_t prvSPSCGetCurMaxSize(Ringbuffer_t *pxRingbuffer);
+
+//Count the items (or bytes for byte buffers) that have been sent to a SPSC ring buffer but not received yet. Can be called by any task
+static UBaseType_t prvSPSCGetItemsWaiting(Ringbuffer_t *pxRingbuffer);
+
+//Checks if an item/data is currently available in a SPSC ring buffer. Must only be called by the receiver
+static BaseType_t prvSPSCCheckItemAvail(Ringbuffer_t *pxRingbuffer);
+
+//Copy an item into a SPSC ring buffer, or acquire space for it if ppvItem is not NULL. Only call after prvSPSCCheckItemFits()
+static void prvSPSCCopyItem(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, void **ppvItem, size_t xItemSize);
+
+//Make all items copied/acquired so far visible to the receiver, xCount items (or bytes for byte buffers). Returns pdTRUE if the receiver has to be woken up
+static BaseType_t prvSPSCPublish(Ringbuffer_t *pxRingbuffer, size_t xCount);
+
+//Retrieve an item (or contiguous data from a byte buffer) from a SPSC ring buffer. Only call after prvSPSCCheckItemAvail()
+static void *prvSPSCGetItem(Ringbuffer_t *pxRingbuffer, uint8_t *pucWrite, size_t xMaxSize, size_t *pxItemSize);
+
+//Return an item to a SPSC ring buffer. Returns pdTRUE if the sender has to be woken up
+static BaseType_t prvSPSCReturnItem(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
+
+//Wake up the side of a SPSC ring buffer which is waiting on uxWaitingFlag
+static void prvSPSCWake(Ringbuffer_t *pxRingbuffer, UBaseType_t uxWaitingFlag);
+
+//From ISR version of prvSPSCWake()
+static void prvSPSCWakeFromISR(Ringbuffer_t *pxRingbuffer, UBaseType_t uxWaitingFlag, BaseType_t *pxHigherPriorityTaskWoken);
+
+//Block the sender (uxWaitingFlag == rbSPSC_TX_WAITING) or the receiver of a SPSC ring buffer. Returns pdFALSE on timeout
+static BaseType_t prvSPSCWait(Ringbuffer_t *pxRingbuffer,
+                              UBaseType_t uxWaitingFlag,
+                              size_t xItemSize,
+                              TimeOut_t *pxTimeOut,
+                              TickType_t *pxTicksToWait);
+
+//SPSC version of prvSendAcquireGeneric()
+static BaseType_t prvSPSCSendAcquire(Ringbuffer_t *pxRingbuffer,
+                                     const void *pvItem,
+                                     void **ppvItem,
+                                     size_t xItemSize,
+                                     TickType_t xTicksToWait);
+
+//SPSC version of prvReceiveGeneric(). Retrieves up to uxMaxItems items and returns the number of items retrieved
+static UBaseType_t prvSPSCReceive(Ringbuffer_t *pxRingbuffer,
+                                  void **ppvItems,
+                                  size_t *pxItemSizes,
+                                  UBaseType_t uxMaxItems,
+                                  size_t xMaxSize,
+                                  TickType_t xTicksToWait);
+
+//Initialize the SPSC specific values after prvInitializeNewRingbuffer()
+static void prvInitializeSPSC(Ringbuffer_t *pxRingbuffer);
+
 // ------------------------------------------------ Static Functions ---------------------------------------------------
 
 static void prvInitializeNewRingbuffer(size_t xBufferSize,
@@ -255,6 +329,7 @@ static void prvInitializeNewRingbuffer(size_t xBufferSize,
     vListInitialise(&pxNewRingbuffer->xTasksWaitingToSend);
     vListInitialise(&pxNewRingbuffer->xTasksWaitingToReceive);
     pxNewRingbuffer->xQueueSet = NULL;
+    pxNewRingbuffer->uxSPSCWaiting = 0;
 
     portMUX_INITIALIZE(&pxNewRingbuffer->mux);
 }
@@ -767,6 +842,10 @@ static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
     BaseType_t xNotifyQueueSet = pdFALSE;
     TimeOut_t xTimeOut;
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSPSCSendAcquire(pxRingbuffer, pvItem, ppvItem, xItemSize, xTicksToWait);
+    }
+
     while (xExitLoop == pdFALSE) {
         portENTER_CRITICAL(&pxRingbuffer->mux);
         if (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdTRUE) {
@@ -837,6 +916,10 @@ static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return (prvSPSCReceive(pxRingbuffer, pvItem1, xItemSize1, 1, xMaxSize, xTicksToWait) > 0) ? pdTRUE : pdFALSE;
+    }
+
     while (xExitLoop == pdFALSE) {
         portENTER_CRITICAL(&pxRingbuffer->mux);
         if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
@@ -899,6 +982,10 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return (prvSPSCReceive(pxRingbuffer, pvItem1, xItemSize1, 1, xMaxSize, 0) > 0) ? pdTRUE : pdFALSE;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         BaseType_t xIsSplit = pdFALSE;
@@ -929,6 +1016,345 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
     return xReturn;
 }
 
+static void prvInitializeSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    pxRingbuffer->uxRingbufferFlags |= rbSPSC_FLAG;
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        //One byte is always kept free so that pucWrite == pucFree means the buffer is empty
+        pxRingbuffer->xMaxItemSize = pxRingbuffer->xSize - 1;
+    } else {
+        /*
+         * Worst case scenario is when the buffer is empty and the write/free pointers are
+         * pointing to the halfway point. As pucAcquire must not catch up with pucFree,
+         * an item can only use all of the free space up to the tail of the buffer.
+         */
+        pxRingbuffer->xMaxItemSize = ((pxRingbuffer->xSize / 2) & ~rbALIGN_MASK) - rbHEADER_SIZE;
+    }
+}
+
+static BaseType_t prvSPSCCheckItemFits(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    uint8_t *pucFree = __atomic_load_n(&pxRingbuffer->pucFree, __ATOMIC_ACQUIRE);
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    configASSERT(pucAcquire == pxRingbuffer->pucWrite);     //Only one item can be acquired at a time
+
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        size_t xFreeSize = (pucFree > pucAcquire) ? (size_t)(pucFree - pucAcquire) : pxRingbuffer->xSize - (pucAcquire - pucFree);
+        return (xItemSize < xFreeSize) ? pdTRUE : pdFALSE;
+    }
+
+    size_t xTotalItemSize = rbALIGN_SIZE(xItemSize) + rbHEADER_SIZE;    //Rounded up aligned item size with header
+    if (pucFree > pucAcquire) {
+        //Free space does not wrap around
+        return (xTotalItemSize < pucFree - pucAcquire) ? pdTRUE : pdFALSE;
+    }
+    size_t xRemLen = pxRingbuffer->pucTail - pucAcquire;
+    if (xTotalItemSize <= xRemLen) {
+        //Item fits without wrapping around. pucAcquire wraps around after it if there is no room for another header
+        return (xRemLen - xTotalItemSize >= rbHEADER_SIZE || pucFree != pxRingbuffer->pucHead) ? pdTRUE : pdFALSE;
+    }
+    //Check if item fits by wrapping
+    return (xTotalItemSize < pucFree - pxRingbuffer->pucHead) ? pdTRUE : pdFALSE;
+}
+
+static size_t prvSPSCGetCurMaxSize(Ringbuffer_t *pxRingbuffer)
+{
+    uint8_t *pucFree = __atomic_load_n(&pxRingbuffer->pucFree, __ATOMIC_ACQUIRE);
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    BaseType_t xFreeSize;
+
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        xFreeSize = (pucFree > pucAcquire) ? pucFree - pucAcquire : pxRingbuffer->xSize - (pucAcquire - pucFree);
+        return xFreeSize - 1;
+    }
+    if (pucAcquire < pucFree) {
+        //Free space is contiguous between pucAcquire and pucFree, pucAcquire must stay behind pucFree
+        xFreeSize = pucFree - pucAcquire - (rbALIGN_MASK + 1);
+    } else {
+        //Select largest contiguous free space. If pucFree is at the head, an item at the tail must leave room for a dummy header
+        BaseType_t xSize1 = pxRingbuffer->pucTail - pucAcquire - ((pucFree == pxRingbuffer->pucHead) ? rbHEADER_SIZE : 0);
+        BaseType_t xSize2 = pucFree - pxRingbuffer->pucHead - (rbALIGN_MASK + 1);
+        xFreeSize = (xSize1 > xSize2) ? xSize1 : xSize2;
+    }
+    //No-split ring buffer items need space for a header
+    xFreeSize -= rbHEADER_SIZE;
+    if (xFreeSize < 0) {
+        xFreeSize = 0;
+    } else if (xFreeSize > pxRingbuffer->xMaxItemSize) {
+        xFreeSize = pxRingbuffer->xMaxItemSize;
+    }
+    return xFreeSize;
+}
+
+static UBaseType_t prvSPSCGetItemsWaiting(Ringbuffer_t *pxRingbuffer)
+{
+    //The sender adds to the count before publishing and the receiver subtracts after retrieving, so it never goes below zero
+    return (UBaseType_t)__atomic_load_n(&pxRingbuffer->xItemsWaiting, __ATOMIC_RELAXED);
+}
+
+static BaseType_t prvSPSCCheckItemAvail(Ringbuffer_t *pxRingbuffer)
+{
+    uint8_t *pucWrite = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_ACQUIRE);
+    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && pxRingbuffer->pucRead != pxRingbuffer->pucFree) {
+        return pdFALSE;     //Byte buffers do not allow multiple retrievals before return
+    }
+    return (pxRingbuffer->pucRead != pucWrite) ? pdTRUE : pdFALSE;
+}
+
+static void prvSPSCCopyItem(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, void **ppvItem, size_t xItemSize)
+{
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    size_t xRemLen = pxRingbuffer->pucTail - pucAcquire;    //Length from pucAcquire until end of buffer
+
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        if (xRemLen <= xItemSize) {
+            //Copy as much as possible into remaining length, then wrap around
+            memcpy(pucAcquire, pucItem, xRemLen);
+            memcpy(pxRingbuffer->pucHead, pucItem + xRemLen, xItemSize - xRemLen);
+            pucAcquire = pxRingbuffer->pucHead + (xItemSize - xRemLen);
+        } else {
+            memcpy(pucAcquire, pucItem, xItemSize);
+            pucAcquire += xItemSize;
+        }
+        pxRingbuffer->pucAcquire = pucAcquire;
+        return;
+    }
+
+    size_t xAlignedItemSize = rbALIGN_SIZE(xItemSize);
+    configASSERT(rbCHECK_ALIGNED(pucAcquire) && xRemLen >= rbHEADER_SIZE);
+    //If remaining length can't fit item, set as dummy data and wrap around
+    if (xRemLen < xAlignedItemSize + rbHEADER_SIZE) {
+        ItemHeader_t *pxDummy = (ItemHeader_t *)pucAcquire;
+        pxDummy->uxItemFlags = rbITEM_DUMMY_DATA_FLAG;
+        pxDummy->xItemLen = 0;
+        pucAcquire = pxRingbuffer->pucHead;
+    }
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pucAcquire;
+    pxHeader->xItemLen = xItemSize;
+    pxHeader->uxItemFlags = rbITEM_WRITTEN_FLAG;
+    if (ppvItem) {
+        *ppvItem = pucAcquire + rbHEADER_SIZE;
+    } else if (xItemSize > 0) {
+        memcpy(pucAcquire + rbHEADER_SIZE, pucItem, xItemSize);
+    }
+    pucAcquire += rbHEADER_SIZE + xAlignedItemSize;
+    //Wrap around pucAcquire if there is no room for another header
+    if ((size_t)(pxRingbuffer->pucTail - pucAcquire) < rbHEADER_SIZE) {
+        pucAcquire = pxRingbuffer->pucHead;
+    }
+    pxRingbuffer->pucAcquire = pucAcquire;
+}
+
+static BaseType_t prvSPSCPublish(Ringbuffer_t *pxRingbuffer, size_t xCount)
+{
+    __atomic_fetch_add(&pxRingbuffer->xItemsWaiting, (BaseType_t)xCount, __ATOMIC_RELAXED);
+    __atomic_store_n(&pxRingbuffer->pucWrite, pxRingbuffer->pucAcquire, __ATOMIC_RELEASE);
+    //Pairs with the fence in prvSPSCWait(). Either the receiver sees the new pucWrite or we see its waiting flag
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return (__atomic_load_n(&pxRingbuffer->uxSPSCWaiting, __ATOMIC_RELAXED) & rbSPSC_RX_WAITING) ? pdTRUE : pdFALSE;
+}
+
+static void *prvSPSCGetItem(Ringbuffer_t *pxRingbuffer, uint8_t *pucWrite, size_t xMaxSize, size_t *pxItemSize)
+{
+    uint8_t *pucRead = pxRingbuffer->pucRead;
+    uint8_t *pcReturn;
+
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        //Return contiguous data up to the write pointer or the buffer tail, or xMaxSize
+        size_t xLen = (pucWrite > pucRead) ? (size_t)(pucWrite - pucRead) : (size_t)(pxRingbuffer->pucTail - pucRead);
+        if (xMaxSize != 0 && xLen > xMaxSize) {
+            xLen = xMaxSize;
+        }
+        *pxItemSize = xLen;
+        pxRingbuffer->pucRead = (pucRead + xLen == pxRingbuffer->pucTail) ? pxRingbuffer->pucHead : pucRead + xLen;
+        __atomic_fetch_sub(&pxRingbuffer->xItemsWaiting, (BaseType_t)xLen, __ATOMIC_RELAXED);
+        return (void *)pucRead;
+    }
+
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pucRead;
+    //Wrap around if dummy data (dummy data indicates wrap around in no-split buffers)
+    if (pxHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+        pucRead = pxRingbuffer->pucHead;
+        pxHeader = (ItemHeader_t *)pucRead;
+    }
+    configASSERT(pxHeader->xItemLen <= pxRingbuffer->xMaxItemSize);
+    pcReturn = pucRead + rbHEADER_SIZE;
+    *pxItemSize = pxHeader->xItemLen;
+    pucRead += rbHEADER_SIZE + rbALIGN_SIZE(pxHeader->xItemLen);
+    //Check if pucRead requires wrap around
+    if ((size_t)(pxRingbuffer->pucTail - pucRead) < rbHEADER_SIZE) {
+        pucRead = pxRingbuffer->pucHead;
+    }
+    pxRingbuffer->pucRead = pucRead;
+    __atomic_fetch_sub(&pxRingbuffer->xItemsWaiting, 1, __ATOMIC_RELAXED);
+    return (void *)pcReturn;
+}
+
+static BaseType_t prvSPSCReturnItem(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    uint8_t *pucFree = pxRingbuffer->pucFree;
+
+    if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
+        configASSERT(pucItem == pucFree);
+        //Byte buffers do not allow multiple outstanding reads
+        pucFree = pxRingbuffer->pucRead;
+    } else {
+        if (((ItemHeader_t *)pucFree)->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+            pucFree = pxRingbuffer->pucHead;
+        }
+        configASSERT(pucItem == pucFree + rbHEADER_SIZE);    //Items must be returned in the order they were received
+        pucFree += rbHEADER_SIZE + rbALIGN_SIZE(((ItemHeader_t *)pucFree)->xItemLen);
+        if ((size_t)(pxRingbuffer->pucTail - pucFree) < rbHEADER_SIZE) {
+            pucFree = pxRingbuffer->pucHead;
+        }
+    }
+    __atomic_store_n(&pxRingbuffer->pucFree, pucFree, __ATOMIC_RELEASE);
+    //Pairs with the fence in prvSPSCWait(). Either the sender sees the new pucFree or we see its waiting flag
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return (__atomic_load_n(&pxRingbuffer->uxSPSCWaiting, __ATOMIC_RELAXED) & rbSPSC_TX_WAITING) ? pdTRUE : pdFALSE;
+}
+
+static void prvSPSCWake(Ringbuffer_t *pxRingbuffer, UBaseType_t uxWaitingFlag)
+{
+    List_t *pxList = (uxWaitingFlag == rbSPSC_TX_WAITING) ? &pxRingbuffer->xTasksWaitingToSend : &pxRingbuffer->xTasksWaitingToReceive;
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    __atomic_store_n(&pxRingbuffer->uxSPSCWaiting, pxRingbuffer->uxSPSCWaiting & ~uxWaitingFlag, __ATOMIC_RELAXED);
+    if (listLIST_IS_EMPTY(pxList) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxList) == pdTRUE) {
+            //The unblocked task will preempt us. Trigger a yield here.
+            portYIELD_WITHIN_API();
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
+static void prvSPSCWakeFromISR(Ringbuffer_t *pxRingbuffer, UBaseType_t uxWaitingFlag, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    List_t *pxList = (uxWaitingFlag == rbSPSC_TX_WAITING) ? &pxRingbuffer->xTasksWaitingToSend : &pxRingbuffer->xTasksWaitingToReceive;
+
+    portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
+    __atomic_store_n(&pxRingbuffer->uxSPSCWaiting, pxRingbuffer->uxSPSCWaiting & ~uxWaitingFlag, __ATOMIC_RELAXED);
+    if (listLIST_IS_EMPTY(pxList) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxList) == pdTRUE) {
+            //The unblocked task will preempt us. Record that a context switch is required.
+            if (pxHigherPriorityTaskWoken != NULL) {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+        }
+    }
+    portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
+}
+
+static BaseType_t prvSPSCWait(Ringbuffer_t *pxRingbuffer,
+                              UBaseType_t uxWaitingFlag,
+                              size_t xItemSize,
+                              TimeOut_t *pxTimeOut,
+                              TickType_t *pxTicksToWait)
+{
+    BaseType_t xReturn = pdTRUE;
+    BaseType_t xReady;
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    __atomic_store_n(&pxRingbuffer->uxSPSCWaiting, pxRingbuffer->uxSPSCWaiting | uxWaitingFlag, __ATOMIC_RELAXED);
+    //Pairs with the fences in prvSPSCPublish() and prvSPSCReturnItem()
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    //Check again, the other side could have made progress before it could see our waiting flag
+    if (uxWaitingFlag == rbSPSC_TX_WAITING) {
+        xReady = prvSPSCCheckItemFits(pxRingbuffer, xItemSize);
+    } else {
+        xReady = prvSPSCCheckItemAvail(pxRingbuffer);
+    }
+    if (xReady == pdFALSE) {
+        if (xTaskCheckForTimeOut(pxTimeOut, pxTicksToWait) == pdFALSE) {
+            //Not timed out yet. Block the current task, the waiting flag is cleared by the task waking us up
+            vTaskPlaceOnEventList((uxWaitingFlag == rbSPSC_TX_WAITING) ? &pxRingbuffer->xTasksWaitingToSend : &pxRingbuffer->xTasksWaitingToReceive,
+                                  *pxTicksToWait);
+            portYIELD_WITHIN_API();
+        } else {
+            //We have timed out
+            xReturn = pdFALSE;
+        }
+    }
+    if (xReady == pdTRUE || xReturn == pdFALSE) {
+        __atomic_store_n(&pxRingbuffer->uxSPSCWaiting, pxRingbuffer->uxSPSCWaiting & ~uxWaitingFlag, __ATOMIC_RELAXED);
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+
+    return xReturn;
+}
+
+static BaseType_t prvSPSCSendAcquire(Ringbuffer_t *pxRingbuffer,
+                                     const void *pvItem,
+                                     void **ppvItem,
+                                     size_t xItemSize,
+                                     TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    //Items are published by moving pucWrite up to pucAcquire. Nothing can be sent while an acquired item is not completed,
+    //as it would be published along with it
+    if (pxRingbuffer->pucAcquire != pxRingbuffer->pucWrite) {
+        return pdFALSE;
+    }
+    while (prvSPSCCheckItemFits(pxRingbuffer, xItemSize) == pdFALSE) {
+        if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            return pdFALSE;
+        }
+        if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskInternalSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+        if (prvSPSCWait(pxRingbuffer, rbSPSC_TX_WAITING, xItemSize, &xTimeOut, &xTicksToWait) == pdFALSE) {
+            return pdFALSE;
+        }
+    }
+    prvSPSCCopyItem(pxRingbuffer, pvItem, ppvItem, xItemSize);
+    //Acquired items are only published by xRingbufferSendComplete()
+    if (ppvItem == NULL && prvSPSCPublish(pxRingbuffer, (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) ? xItemSize : 1) == pdTRUE) {
+        prvSPSCWake(pxRingbuffer, rbSPSC_RX_WAITING);
+    }
+    return pdTRUE;
+}
+
+static UBaseType_t prvSPSCReceive(Ringbuffer_t *pxRingbuffer,
+                                  void **ppvItems,
+                                  size_t *pxItemSizes,
+                                  UBaseType_t uxMaxItems,
+                                  size_t xMaxSize,
+                                  TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    UBaseType_t uxCount = 0;
+
+    while (prvSPSCCheckItemAvail(pxRingbuffer) == pdFALSE) {
+        if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            return 0;
+        }
+        if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskInternalSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+        if (prvSPSCWait(pxRingbuffer, rbSPSC_RX_WAITING, 0, &xTimeOut, &xTicksToWait) == pdFALSE) {
+            return 0;
+        }
+    }
+    //Everything up to this write pointer has been published, retrieve as many items as requested
+    uint8_t *pucWrite = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_ACQUIRE);
+    do {
+        ppvItems[uxCount] = prvSPSCGetItem(pxRingbuffer, pucWrite, xMaxSize, &pxItemSizes[uxCount]);
+        uxCount++;
+    } while (uxCount < uxMaxItems && (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) == 0 && pxRingbuffer->pucRead != pucWrite);
+
+    return uxCount;
+}
+
 // ------------------------------------------------ Public Functions ---------------------------------------------------
 
 RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferType)
@@ -981,6 +1407,35 @@ RingbufHandle_t xRingbufferCreateStatic(size_t xBufferSize,
     return (RingbufHandle_t)pxNewRingbuffer;
 }
 
+RingbufHandle_t xRingbufferCreateSPSC(size_t xBufferSize, RingbufferType_t xBufferType)
+{
+    configASSERT(xBufferType == RINGBUF_TYPE_NOSPLIT || xBufferType == RINGBUF_TYPE_BYTEBUF);
+    if (xBufferType == RINGBUF_TYPE_ALLOWSPLIT) {
+        return NULL;
+    }
+
+    Ringbuffer_t *pxNewRingbuffer = (Ringbuffer_t *)xRingbufferCreate(xBufferSize, xBufferType);
+    if (pxNewRingbuffer != NULL) {
+        prvInitializeSPSC(pxNewRingbuffer);
+    }
+    return (RingbufHandle_t)pxNewRingbuffer;
+}
+
+RingbufHandle_t xRingbufferCreateStaticSPSC(size_t xBufferSize,
+                                            RingbufferType_t xBufferType,
+                                            uint8_t *pucRingbufferStorage,
+                                            StaticRingbuffer_t *pxStaticRingbuffer)
+{
+    configASSERT(xBufferType == RINGBUF_TYPE_NOSPLIT || xBufferType == RINGBUF_TYPE_BYTEBUF);
+    if (xBufferType == RINGBUF_TYPE_ALLOWSPLIT) {
+        return NULL;
+    }
+
+    Ringbuffer_t *pxNewRingbuffer = (Ringbuffer_t *)xRingbufferCreateStatic(xBufferSize, xBufferType, pucRingbufferStorage, pxStaticRingbuffer);
+    prvInitializeSPSC(pxNewRingbuffer);
+    return (RingbufHandle_t)pxNewRingbuffer;
+}
+
 BaseType_t xRingbufferSendAcquire(RingbufHandle_t xRingbuffer, void **ppvItem, size_t xItemSize, TickType_t xTicksToWait)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
@@ -1008,6 +1463,14 @@ BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem)
     configASSERT(pvItem != NULL);
     configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        configASSERT(pxRingbuffer->pucAcquire != pxRingbuffer->pucWrite);   //An item must have been acquired
+        if (prvSPSCPublish(pxRingbuffer, 1) == pdTRUE) {
+            prvSPSCWake(pxRingbuffer, rbSPSC_RX_WAITING);
+        }
+        return pdTRUE;
+    }
+
     portENTER_CRITICAL(&pxRingbuffer->mux);
     prvSendItemDoneNoSplit(pxRingbuffer, pvItem);
     if (pxRingbuffer->xQueueSet) {
@@ -1069,6 +1532,18 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        //As in prvSPSCSendAcquire(), the item would be published along with an acquired item which is not completed
+        if (pxRingbuffer->pucAcquire != pxRingbuffer->pucWrite || prvSPSCCheckItemFits(pxRingbuffer, xItemSize) == pdFALSE) {
+            return pdFALSE;
+        }
+        prvSPSCCopyItem(pxRingbuffer, pvItem, NULL, xItemSize);
+        if (prvSPSCPublish(pxRingbuffer, (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) ? xItemSize : 1) == pdTRUE) {
+            prvSPSCWakeFromISR(pxRingbuffer, rbSPSC_RX_WAITING, pxHigherPriorityTaskWoken);
+        }
+        return pdTRUE;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (pxRingbuffer->xCheckItemFits(xRingbuffer, xItemSize) == pdTRUE) {
         pxRingbuffer->vCopyItem(xRingbuffer, pvItem, xItemSize);
@@ -1206,12 +1681,52 @@ void *xRingbufferReceiveUpToFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemS
     }
 }
 
+UBaseType_t xRingbufferReceiveMany(RingbufHandle_t xRingbuffer,
+                                   void **ppvItems,
+                                   size_t *pxItemSizes,
+                                   UBaseType_t uxMaxItems,
+                                   TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer && ppvItems && pxItemSizes && uxMaxItems > 0);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & rbALLOW_SPLIT_FLAG) == 0);    // This function must not be called for allow-split buffers
+
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSPSCReceive(pxRingbuffer, ppvItems, pxItemSizes, uxMaxItems, 0, xTicksToWait);
+    }
+
+    //Block for the first item, then take every item which is already available
+    if (prvReceiveGeneric(pxRingbuffer, &ppvItems[0], NULL, &pxItemSizes[0], NULL, 0, xTicksToWait) == pdFALSE) {
+        return 0;
+    }
+    UBaseType_t uxCount = 1;
+    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) == 0 && uxMaxItems > 1) {
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        while (uxCount < uxMaxItems && prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
+            BaseType_t xIsSplit;
+            ppvItems[uxCount] = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, &pxItemSizes[uxCount]);
+            uxCount++;
+        }
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+    }
+    return uxCount;
+}
+
 void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        if (prvSPSCReturnItem(pxRingbuffer, (uint8_t *)pvItem) == pdTRUE) {
+            prvSPSCWake(pxRingbuffer, rbSPSC_TX_WAITING);
+        }
+        return;
+    }
+
     portENTER_CRITICAL(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1230,6 +1745,13 @@ void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, Bas
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        if (prvSPSCReturnItem(pxRingbuffer, (uint8_t *)pvItem) == pdTRUE) {
+            prvSPSCWakeFromISR(pxRingbuffer, rbSPSC_TX_WAITING, pxHigherPriorityTaskWoken);
+        }
+        return;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1269,6 +1791,9 @@ size_t xRingbufferGetCurFreeSize(RingbufHandle_t xRingbuffer)
     configASSERT(pxRingbuffer);
 
     size_t xFreeSize;
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSPSCGetCurMaxSize(pxRingbuffer);
+    }
     portENTER_CRITICAL(&pxRingbuffer->mux);
     xFreeSize = pxRingbuffer->xGetCurMaxSize(pxRingbuffer);
     portEXIT_CRITICAL(&pxRingbuffer->mux);
@@ -1282,6 +1807,10 @@ BaseType_t xRingbufferAddToQueueSetRead(RingbufHandle_t xRingbuffer, QueueSetHan
 
     configASSERT(pxRingbuffer && xQueueSet);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return pdFALSE;     //Sending to SPSC buffers does not take the spinlock, the queue set could not be notified reliably
+    }
+
     portENTER_CRITICAL(&pxRingbuffer->mux);
     if (pxRingbuffer->xQueueSet != NULL || prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         /*
@@ -1347,7 +1876,11 @@ void vRingbufferGetInfo(RingbufHandle_t xRingbuffer,
         *uxAcquire = (UBaseType_t)(pxRingbuffer->pucAcquire - pxRingbuffer->pucHead);
     }
     if (uxItemsWaiting != NULL) {
-        *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+            *uxItemsWaiting = prvSPSCGetItemsWaiting(pxRingbuffer);
+        } else {
+            *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        }
     }
     portEXIT_CRITICAL(&pxRingbuffer->mux);
 }
@@ -11,7 +11,9 @@
 
 #include "sdkconfig.h"
 #include <stdio.h>
+#include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -869,6 +871,35 @@ TEST_CASE("Test ring buffer SMP", "[esp_ringbuf][linux]")
     cleanup();
 }
 
+TEST_CASE("Test SPSC ring buffer SMP", "[esp_ringbuf][linux]")
+{
+    setup();
+    //SPSC buffers can only be no-split or byte buffers
+    RingbufferType_t buf_types[] = {RINGBUF_TYPE_NOSPLIT, RINGBUF_TYPE_BYTEBUF};
+    for (int i = 0; i < sizeof(buf_types) / sizeof(buf_types[0]); i++) {
+        task_args_t task_args;
+        task_args.buffer = xRingbufferCreateSPSC(CONT_DATA_TEST_BUFF_LEN, buf_types[i]);
+        task_args.type = buf_types[i];
+        TEST_ASSERT_MESSAGE(task_args.buffer != NULL, "Failed to create ring buffer");
+
+        for (int prior_mod = -1; prior_mod < 2; prior_mod++) {  //Test different relative priorities
+            for (int send_core = 0; send_core < CONFIG_FREERTOS_NUMBER_OF_CORES; send_core++) {
+                for (int rec_core = 0; rec_core < CONFIG_FREERTOS_NUMBER_OF_CORES; rec_core ++) {
+                    esp_rom_printf("Type: %d, PM: %d, SC: %d, RC: %d\n", buf_types[i], prior_mod, send_core, rec_core);
+                    xTaskCreatePinnedToCore(send_task, "send tsk", 2048, (void *)&task_args, 10 + prior_mod, NULL, send_core);
+                    xTaskCreatePinnedToCore(rec_task, "rec tsk", 2048, (void *)&task_args, 10, NULL, rec_core);
+                    xSemaphoreTake(tasks_done, portMAX_DELAY);
+                    vTaskDelay(5);  //Allow idle to clean up
+                }
+            }
+        }
+
+        vRingbufferDelete(task_args.buffer);
+        vTaskDelay(10);
+    }
+    cleanup();
+}
+
 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
 TEST_CASE("Test static ring buffer SMP", "[esp_ringbuf][linux]")
 {
@@ -1124,3 +1155,158 @@ TEST_CASE("Test no-split buffers can receive items if the acquire pointer wraps
     // Cleanup
     vRingbufferDelete(buffer_handle);
 }
+
+/* ------------------------- Test SPSC ring buffers ---------------------------
+ * The following test case tests single-producer/single-consumer ring buffers.
+ *
+ * The test case will do the following...
+ * 1) Create a SPSC no-split buffer and fill it with small items until it is full.
+ * 2) Receive all items with a single call to xRingbufferReceiveMany() and check their order.
+ * 3) Check that items can be sent again after returning the first items, causing a wrap around.
+ * 4) Check that nothing can be sent while an acquired item is not completed.
+ * 5) Check that SPSC buffers are rejected by queue sets.
+ * 6) Repeat sending and receiving on a SPSC byte buffer.
+ */
+TEST_CASE("Test SPSC ring buffers", "[esp_ringbuf][linux]")
+{
+    RingbufHandle_t buffer_handle = xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    TEST_ASSERT_MESSAGE(buffer_handle != NULL, "Failed to create ring buffer");
+    TEST_ASSERT_NULL(xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_ALLOWSPLIT));
+
+    //Fill the buffer with small items
+    uint32_t value = 0;
+    while (xRingbufferSend(buffer_handle, &value, sizeof(value), 0) == pdTRUE) {
+        value++;
+    }
+    //The write position never wraps around onto the first item, which has not been returned yet
+    TEST_ASSERT_EQUAL((BUFFER_SIZE - ITEM_HDR_SIZE) / (ITEM_HDR_SIZE + sizeof(value)), value);
+    TEST_ASSERT_EQUAL(0, xRingbufferGetCurFreeSize(buffer_handle));
+    UBaseType_t items_waiting;
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, NULL, NULL, &items_waiting);
+    TEST_ASSERT_EQUAL(value, items_waiting);
+
+    //Receive all of them at once
+    void *items[BUFFER_SIZE / ITEM_HDR_SIZE];
+    size_t item_sizes[BUFFER_SIZE / ITEM_HDR_SIZE];
+    UBaseType_t received = xRingbufferReceiveMany(buffer_handle, items, item_sizes, BUFFER_SIZE / ITEM_HDR_SIZE, TIMEOUT_TICKS);
+    TEST_ASSERT_EQUAL(value, received);
+    for (int i = 0; i < received; i++) {
+        TEST_ASSERT_EQUAL(sizeof(value), item_sizes[i]);
+        TEST_ASSERT_EQUAL(i, *(uint32_t *)items[i]);
+    }
+    TEST_ASSERT_EQUAL(0, xRingbufferReceiveMany(buffer_handle, items, item_sizes, 1, 0));
+
+    //Return the first two items, a large item now fits by wrapping around
+    vRingbufferReturnItem(buffer_handle, items[0]);
+    vRingbufferReturnItem(buffer_handle, items[1]);
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(buffer_handle, small_item, SMALL_ITEM_SIZE, 0));
+    for (int i = 2; i < received; i++) {
+        vRingbufferReturnItem(buffer_handle, items[i]);
+    }
+    receive_check_and_return_item_no_split(buffer_handle, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, NULL, NULL, &items_waiting);
+    TEST_ASSERT_EQUAL(0, items_waiting);
+
+    //Only one item can be acquired at a time
+    void *acquired;
+    void *other;
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendAcquire(buffer_handle, &acquired, SMALL_ITEM_SIZE, 0));
+    TEST_ASSERT_EQUAL(pdFALSE, xRingbufferSendAcquire(buffer_handle, &other, SMALL_ITEM_SIZE, 0));
+    TEST_ASSERT_NULL(other);
+    TEST_ASSERT_EQUAL(pdFALSE, xRingbufferSend(buffer_handle, small_item, SMALL_ITEM_SIZE, 0));
+    //An acquired item is only counted once it is completed
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, NULL, NULL, &items_waiting);
+    TEST_ASSERT_EQUAL(0, items_waiting);
+    memcpy(acquired, small_item, SMALL_ITEM_SIZE);
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendComplete(buffer_handle, acquired));
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, NULL, NULL, &items_waiting);
+    TEST_ASSERT_EQUAL(1, items_waiting);
+    receive_check_and_return_item_no_split(buffer_handle, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+
+    //Sending to SPSC buffers does not notify queue sets
+    QueueSetHandle_t queue_set = xQueueCreateSet(1);
+    TEST_ASSERT_EQUAL(pdFALSE, xRingbufferAddToQueueSetRead(buffer_handle, queue_set));
+    vQueueDelete(queue_set);
+    vRingbufferDelete(buffer_handle);
+
+    //Byte buffer
+    buffer_handle = xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF);
+    TEST_ASSERT_MESSAGE(buffer_handle != NULL, "Failed to create ring buffer");
+    TEST_ASSERT_EQUAL(BUFFER_SIZE - 1, xRingbufferGetMaxItemSize(buffer_handle));
+    for (int i = 0; i < 2 * BUFFER_SIZE / MEDIUM_ITEM_SIZE; i++) {
+        send_item_and_check(buffer_handle, large_item, MEDIUM_ITEM_SIZE, TIMEOUT_TICKS, false);
+        //Data wrapping around the end of the buffer is received in two parts
+        size_t total = 0;
+        while (total < MEDIUM_ITEM_SIZE) {
+            TEST_ASSERT_EQUAL(1, xRingbufferReceiveMany(buffer_handle, items, item_sizes, 2, TIMEOUT_TICKS));
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(&large_item[total], items[0], item_sizes[0]);
+            total += item_sizes[0];
+            vRingbufferGetInfo(buffer_handle, NULL, NULL, NULL, NULL, &items_waiting);
+            TEST_ASSERT_EQUAL(MEDIUM_ITEM_SIZE - total, items_waiting);
+            vRingbufferReturnItem(buffer_handle, items[0]);
+        }
+        TEST_ASSERT_EQUAL(MEDIUM_ITEM_SIZE, total);
+    }
+    vRingbufferDelete(buffer_handle);
+}
+
+/* --------------------------- Ring buffer throughput -------------------------
+ * The following test case measures the number of items per second that can be
+ * passed from a sending task to a receiving task through each kind of no-split
+ * ring buffer, receiving items one by one or with xRingbufferReceiveMany().
+ */
+
+#define THROUGHPUT_ITEMS            20000
+#define THROUGHPUT_BATCH            16
+
+static void throughput_send_task(void *args)
+{
+    RingbufHandle_t buffer = (RingbufHandle_t)args;
+    for (uint32_t i = 0; i < THROUGHPUT_ITEMS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(buffer, &i, sizeof(i), portMAX_DELAY));
+    }
+    xSemaphoreGive(tx_done);
+    vTaskDelete(NULL);
+}
+
+static uint32_t measure_throughput(RingbufHandle_t buffer, bool receive_many)
+{
+    void *items[THROUGHPUT_BATCH];
+    size_t item_sizes[THROUGHPUT_BATCH];
+    uint32_t expected = 0;
+
+    TickType_t start = xTaskGetTickCount();
+    xTaskCreatePinnedToCore(throughput_send_task, "send tsk", 2048, (void *)buffer, 10, NULL, 0);
+    while (expected < THROUGHPUT_ITEMS) {
+        UBaseType_t received;
+        if (receive_many) {
+            received = xRingbufferReceiveMany(buffer, items, item_sizes, THROUGHPUT_BATCH, portMAX_DELAY);
+        } else {
+            items[0] = xRingbufferReceive(buffer, &item_sizes[0], portMAX_DELAY);
+            received = (items[0] != NULL) ? 1 : 0;
+        }
+        for (int i = 0; i < received; i++) {
+            TEST_ASSERT_EQUAL(expected++, *(uint32_t *)items[i]);
+            vRingbufferReturnItem(buffer, items[i]);
+        }
+    }
+    xSemaphoreTake(tx_done, portMAX_DELAY);
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    vRingbufferDelete(buffer);
+    return (uint32_t)((uint64_t)THROUGHPUT_ITEMS * configTICK_RATE_HZ / (elapsed ? elapsed : 1));
+}
+
+TEST_CASE("Test ring buffer throughput", "[esp_ringbuf][linux]")
+{
+    tx_done = xSemaphoreCreateBinary();
+    printf("No-split, receive: %" PRIu32 " items/s\n",
+           measure_throughput(xRingbufferCreate(BUFFER_SIZE * 4, RINGBUF_TYPE_NOSPLIT), false));
+    printf("No-split, receive many: %" PRIu32 " items/s\n",
+           measure_throughput(xRingbufferCreate(BUFFER_SIZE * 4, RINGBUF_TYPE_NOSPLIT), true));
+    printf("SPSC no-split, receive: %" PRIu32 " items/s\n",
+           measure_throughput(xRingbufferCreateSPSC(BUFFER_SIZE * 4, RINGBUF_TYPE_NOSPLIT), false));
+    printf("SPSC no-split, receive many: %" PRIu32 " items/s\n",
+           measure_throughput(xRingbufferCreateSPSC(BUFFER_SIZE * 4, RINGBUF_TYPE_NOSPLIT), true));
+    vSemaphoreDelete(tx_done);
+    vTaskDelay(5);  //Allow idle to clean up
+}
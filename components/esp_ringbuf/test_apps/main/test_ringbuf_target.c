@@ -12,6 +12,7 @@
 #include "sdkconfig.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -124,6 +125,88 @@ TEST_CASE("Test ring buffer ISR", "[esp_ringbuf][qemu-ignore]")
     }
 }
 
+/* ------------------------ Test SPSC ring buffer ISR --------------------------
+ * The following test case sends to a SPSC ring buffer from an ISR while the
+ * sending task has acquired an item. A timer is used to trigger the ISR.
+ * 1) The task acquires an item, the ISR must fail to send.
+ * 2) The task completes the item, the ISR can now send.
+ * 3) Both items are received in order.
+ */
+
+static const uint8_t spsc_isr_item[SMALL_ITEM_SIZE] = { 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7 };
+static RingbufHandle_t spsc_isr_buffer;
+static volatile bool spsc_isr_send_requested;
+static volatile BaseType_t spsc_isr_send_result;
+
+static bool on_timer_alarm_spsc(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t task_woken = pdFALSE;
+    if (spsc_isr_send_requested) {
+        spsc_isr_send_requested = false;
+        spsc_isr_send_result = xRingbufferSendFromISR(spsc_isr_buffer, spsc_isr_item, SMALL_ITEM_SIZE, &task_woken);
+        xSemaphoreGiveFromISR(done_sem, &task_woken);
+    }
+    return task_woken == pdTRUE;
+}
+
+static BaseType_t spsc_send_from_isr(void)
+{
+    spsc_isr_send_requested = true;
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done_sem, pdMS_TO_TICKS(1000)));
+    return spsc_isr_send_result;
+}
+
+TEST_CASE("Test SPSC ring buffer send from ISR while an item is acquired", "[esp_ringbuf][qemu-ignore]")
+{
+    gptimer_handle_t gptimer;
+    spsc_isr_buffer = xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    TEST_ASSERT_NOT_NULL(spsc_isr_buffer);
+    done_sem = xSemaphoreCreateBinary();
+    spsc_isr_send_requested = false;
+
+    gptimer_config_t config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,
+    };
+    TEST_ESP_OK(gptimer_new_timer(&config, &gptimer));
+    gptimer_alarm_config_t alarm_config = {
+        .reload_count = 0,
+        .alarm_count = 1000,
+        .flags.auto_reload_on_alarm = true,
+    };
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = on_timer_alarm_spsc,
+    };
+    TEST_ESP_OK(gptimer_register_event_callbacks(gptimer, &cbs, NULL));
+    TEST_ESP_OK(gptimer_set_alarm_action(gptimer, &alarm_config));
+    TEST_ESP_OK(gptimer_enable(gptimer));
+    TEST_ESP_OK(gptimer_start(gptimer));
+
+    //The item sent from the ISR would be published along with the acquired one
+    void *acquired;
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendAcquire(spsc_isr_buffer, &acquired, SMALL_ITEM_SIZE, 0));
+    TEST_ASSERT_EQUAL(pdFALSE, spsc_send_from_isr());
+    UBaseType_t items_waiting;
+    vRingbufferGetInfo(spsc_isr_buffer, NULL, NULL, NULL, NULL, &items_waiting);
+    TEST_ASSERT_EQUAL(0, items_waiting);
+
+    memcpy(acquired, small_item, SMALL_ITEM_SIZE);
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendComplete(spsc_isr_buffer, acquired));
+    TEST_ASSERT_EQUAL(pdTRUE, spsc_send_from_isr());
+    vRingbufferGetInfo(spsc_isr_buffer, NULL, NULL, NULL, NULL, &items_waiting);
+    TEST_ASSERT_EQUAL(2, items_waiting);
+
+    receive_check_and_return_item_no_split(spsc_isr_buffer, small_item, SMALL_ITEM_SIZE, 0, false);
+    receive_check_and_return_item_no_split(spsc_isr_buffer, spsc_isr_item, SMALL_ITEM_SIZE, 0, false);
+
+    TEST_ESP_OK(gptimer_stop(gptimer));
+    TEST_ESP_OK(gptimer_disable(gptimer));
+    TEST_ESP_OK(gptimer_del_timer(gptimer));
+    vSemaphoreDelete(done_sem);
+    vRingbufferDelete(spsc_isr_buffer);
+}
+
 /* ---------------------------- Test ring buffer SMP ---------------------------
  * The following test case tests each type of ring buffer in an SMP fashion. A
  * sending task and a receiving task is created. The sending task will split
@@ -136,6 +136,9 @@ typedef struct {
     uint32_t regs_offset[ESP_EH_FRAME_STACK_SIZE][EXECUTION_FRAME_MAX_REGS];
     /* reg_offset represents the state of registers when PC reaches the following location. */
     uint32_t location;
+    /* Value of location before the last DW_CFA_advance_loc* instruction. The registers state is
+     * the same for all the PCs between prev_location (excluded) and location (included). */
+    uint32_t prev_location;
     /* Index of the registers offset to use (1 for saved offset, 0 else). */
     uint8_t offset_idx;
 } dwarf_regs;
@@ -405,11 +408,11 @@ static const table_entry* esp_eh_frame_find_entry(const table_entry* sorted_tabl
     uint32_t is_signed = (encoding & 0xf) >= 0x9;
     uint32_t pc_relative = true;
 
-    /* The following local variables are used for dichotomic search. */
-    uint32_t found = false;
+    /* The following local variables are used for dichotomic search. Look for the
+     * first entry which address is above return_address, the entry we are looking
+     * for is the one before. */
     uint32_t begin = 0;
     uint32_t end = length;
-    uint32_t middle = (end + begin) / 2;
 
     /* If the addresses in the table are offsets relative to the eh_frame section,
     * instead of decoding each of them, we can simply encode the return_address
@@ -422,45 +425,34 @@ static const table_entry* esp_eh_frame_find_entry(const table_entry* sorted_tabl
     }
 
     /* Perform dichotomic search. */
-    while (end != 0 && middle != (length - 1) && !found) {
+    while (begin < end) {
+        const uint32_t middle = (end + begin) / 2;
         const uint32_t fun_addr = sorted_table[middle].fun_addr;
-        const uint32_t nxt_addr = sorted_table[middle + 1].fun_addr;
+        bool below = false;
 
         if (pc_relative) {
             ra = return_address - (uint32_t)(sorted_table + middle);
         }
 
         if (is_signed) {
-            /* Signed comparisons. */
-            const int32_t sfun_addr = (int32_t) fun_addr;
-            const int32_t snxt_addr = (int32_t) nxt_addr;
-            if (sfun_addr <= ra && snxt_addr > ra) {
-                found = true;
-            } else if (snxt_addr <= ra) {
-                begin = middle + 1;
-            } else {
-                end = middle;
-            }
-
+            /* Signed comparison. */
+            below = (int32_t) fun_addr <= ra;
         } else {
-            /* Unsigned comparisons. */
-            const uint32_t ura = (uint32_t) ra;
-            if (fun_addr <= ura && nxt_addr > ura) {
-                found = true;
-            } else if (nxt_addr <= ura) {
-                begin = middle + 1;
-            } else {
-                end = middle;
-            }
+            /* Unsigned comparison. */
+            below = fun_addr <= (uint32_t) ra;
         }
 
-        middle = (end + begin) / 2;
+        if (below) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
     }
 
-    /* If 'end' reached the beginning of the array, it means the return_address
+    /* If 'begin' is still at the beginning of the array, it means the return_address
      * passed was below the first address of the array, thus, it was wrong.
      * Else, return the address found. */
-    return (end == 0) ? 0 : sorted_table + middle;
+    return (begin == 0) ? NULL : sorted_table + begin - 1;
 }
 
 /**
@@ -511,16 +503,19 @@ static inline uint32_t esp_eh_frame_execute_opcode_0(const uint32_t opcode, cons
     case DW_CFA_ADVANCE_LOC1:
         /* Advance location with a 1-byte delta. */
         used_operands = 1;
+        state->prev_location = state->location;
         state->location += *operands;
         break;
     case DW_CFA_ADVANCE_LOC2:
         /* Advance location with a 2-byte delta. */
         used_operands = 2;
+        state->prev_location = state->location;
         state->location += *((const uint16_t*) operands);
         break;
     case DW_CFA_ADVANCE_LOC4:
         /* Advance location with a 4-byte delta. */
         used_operands = 4;
+        state->prev_location = state->location;
         state->location += *((const uint32_t*) operands);
         break;
     case DW_CFA_REMEMBER_STATE:
@@ -617,6 +612,7 @@ static bool esp_eh_frame_execute(const uint8_t* instructions, const uint32_t ins
              * once we reach the instruction where the PC left, we can break out of the loop
              * The delta is part of the lowest 6 bits.
              */
+            state->prev_location = state->location;
             state->location += param;
             break;
         case DW_CFA_OFFSET:
@@ -719,6 +715,163 @@ static uint32_t esp_eh_frame_initialize_state(const uint8_t* cie, ExecutionFrame
     return ra_reg;
 }
 
+#if CONFIG_ESP_SYSTEM_EH_FRAME_CACHE_ENTRIES > 0
+
+/**
+ * @brief Maximum number of registers restored by a cached unwinding rule.
+ * On RISC-V, a function saves at most ra and s0-s11 on the stack. Frames restoring more
+ * registers than this are always unwound by executing the DWARF instructions.
+ */
+#define ESP_EH_FRAME_CACHE_MAX_REGS     (13)
+
+/**
+ * @brief Pre-decoded unwinding rule.
+ * This is a compact snapshot of the DWARF VM state obtained after executing the CIE and FDE
+ * instructions, which is valid for all the PCs between pc_low (excluded) and pc_high (included).
+ * Applying it to a frame gives the same result as executing the instructions again.
+ */
+typedef struct {
+    uint32_t pc_low;    /*!< Lower bound of the PC range, excluded. */
+    uint32_t pc_high;   /*!< Upper bound of the PC range, included. */
+    uint32_t cfa;       /*!< CFA register and offset, as encoded by ESP_EH_FRAME_NEW_CFA(). */
+    uint8_t ra_reg;     /*!< Index of the register containing the return address. */
+    uint8_t reg_count;  /*!< Number of registers to restore. */
+    uint8_t regs[ESP_EH_FRAME_CACHE_MAX_REGS];      /*!< Index of the registers to restore. */
+    uint8_t offsets[ESP_EH_FRAME_CACHE_MAX_REGS];   /*!< Address of their former value, in words below the CFA. */
+} eh_frame_rule;
+
+/**
+ * @brief Cache of unwinding rules, filled as frames get unwound. When full, the oldest rule is replaced.
+ */
+static eh_frame_rule s_cache[CONFIG_ESP_SYSTEM_EH_FRAME_CACHE_ENTRIES];
+static uint32_t s_cache_next;
+
+/**
+ * @brief Lock protecting the cache.
+ * A backtrace never waits for it: the cache is simply bypassed when it is taken. This way, the panic
+ * handler cannot be blocked by a CPU which was stopped while holding the lock.
+ */
+static bool s_cache_busy;
+
+static inline bool esp_eh_frame_cache_take(void)
+{
+    return !__atomic_test_and_set(&s_cache_busy, __ATOMIC_ACQUIRE);
+}
+
+static inline void esp_eh_frame_cache_give(void)
+{
+    __atomic_clear(&s_cache_busy, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Look for the unwinding rule of the given PC in the cache.
+ *
+ * @param pc PC of the frame to unwind.
+ * @param rule Filled with the rule found.
+ *
+ * @return true if a rule was found, false else.
+ */
+static bool esp_eh_frame_cache_lookup(const uint32_t pc, eh_frame_rule* rule)
+{
+    bool found = false;
+
+    if (!esp_eh_frame_cache_take()) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < DIM(s_cache); i++) {
+        if (s_cache[i].pc_low < pc && pc <= s_cache[i].pc_high) {
+            *rule = s_cache[i];
+            found = true;
+            break;
+        }
+    }
+
+    esp_eh_frame_cache_give();
+    return found;
+}
+
+/**
+ * @brief Snapshot the DWARF VM state after the instructions were executed for the given PC and
+ * store it in the cache.
+ *
+ * Instructions execution stops right after the DW_CFA_advance_loc* instruction which makes the location
+ * reach the PC. As such, the same state would be obtained for any PC between the location before
+ * this instruction (excluded) and the location after it (included). If the instructions were all executed,
+ * the state is the same until the end of the function.
+ *
+ * @param state DWARF VM state.
+ * @param ra_reg Index of the DWARF register containing the return address.
+ * @param pc PC the instructions were executed for.
+ * @param fun_end Address of the end of the function described by the FDE.
+ */
+static void esp_eh_frame_cache_insert(const dwarf_regs* state, const uint32_t ra_reg,
+                                      const uint32_t pc, const uint32_t fun_end)
+{
+    eh_frame_rule rule = { 0 };
+
+    if (state->location >= pc) {
+        rule.pc_low = state->prev_location;
+        rule.pc_high = state->location;
+    } else {
+        rule.pc_low = state->location;
+        rule.pc_high = fun_end - 1;
+    }
+
+    /* The range is empty when the PC is the first address of the function. */
+    if (rule.pc_low >= pc || pc > rule.pc_high || ra_reg >= EXECUTION_FRAME_MAX_REGS) {
+        return;
+    }
+
+    rule.cfa = ESP_EH_FRAME_CFA(state);
+    rule.ra_reg = ra_reg;
+    for (uint32_t i = 0; i < DIM(state->regs_offset[0]); i++) {
+        const uint32_t value_addr = state->regs_offset[state->offset_idx][i];
+        if (i != ESP_ESH_FRAME_CFA_IDX && value_addr != ESP_EH_FRAME_REG_SAME) {
+            const uint32_t offset = ESP_EH_FRAME_GET_REG_OFFSET(value_addr);
+            /* Rules that don't fit in the compact format are not cached. */
+            if (rule.reg_count == ESP_EH_FRAME_CACHE_MAX_REGS || offset > UINT8_MAX) {
+                return;
+            }
+            rule.regs[rule.reg_count] = i;
+            rule.offsets[rule.reg_count] = offset;
+            rule.reg_count++;
+        }
+    }
+
+    if (esp_eh_frame_cache_take()) {
+        s_cache[s_cache_next] = rule;
+        s_cache_next = (s_cache_next + 1) % DIM(s_cache);
+        esp_eh_frame_cache_give();
+    }
+}
+
+/**
+ * @brief Modify the execution frame for restoring caller's context, using a cached rule.
+ *
+ * @param rule Unwinding rule for the frame's PC.
+ * @param frame Snapshot of the CPU registers.
+ *
+ * @return Return Address of the current context, as returned by esp_eh_frame_restore_caller_state().
+ */
+static uint32_t esp_eh_frame_cache_apply(const eh_frame_rule* rule, ExecutionFrame* frame)
+{
+    const uint32_t cfa_reg = ESP_EH_FRAME_GET_CFA_REG(rule->cfa);
+    const uint32_t cfa_off = ESP_EH_FRAME_GET_CFA_OFF(rule->cfa);
+    const uint32_t cfa_addr = EXECUTION_FRAME_REG(frame, cfa_reg) + cfa_off;
+
+    for (uint32_t i = 0; i < rule->reg_count; i++) {
+        const uint32_t value_addr = cfa_addr - rule->offsets[i] * sizeof(uint32_t);
+        EXECUTION_FRAME_REG(frame, rule->regs[i]) = *((uint32_t*) value_addr);
+    }
+
+    EXECUTION_FRAME_SP(*frame) = cfa_addr;
+
+    return EXECUTION_FRAME_REG(frame, rule->ra_reg) - 2;
+}
+
+#endif // CONFIG_ESP_SYSTEM_EH_FRAME_CACHE_ENTRIES > 0
+
 /**
  * @brief Modify the execution frame and DWARF VM state for restoring caller's context.
  *
@@ -761,6 +914,7 @@ static uint32_t esp_eh_frame_restore_caller_state(const uint32_t* fde,
     /* Initialize the DWARF state by executing the CIE's instructions. */
     const uint32_t ra_reg = esp_eh_frame_initialize_state(cie, frame, state);
     state->location = initial_location;
+    state->prev_location = initial_location;
 
     /**
      * Execute the DWARf instructions is order to create rules that will be executed later to retrieve
@@ -773,6 +927,10 @@ static uint32_t esp_eh_frame_restore_caller_state(const uint32_t* fde,
         return EXECUTION_FRAME_PC(*frame);
     }
 
+#if CONFIG_ESP_SYSTEM_EH_FRAME_CACHE_ENTRIES > 0
+    esp_eh_frame_cache_insert(state, ra_reg, EXECUTION_FRAME_PC(*frame), initial_location + range_length);
+#endif
+
     /* Execute the rules calculated previously. Start with the CFA. */
     const uint32_t cfa_val = ESP_EH_FRAME_CFA(state);
     const uint32_t cfa_reg = ESP_EH_FRAME_GET_CFA_REG(cfa_val);
@@ -838,6 +996,100 @@ static bool esp_eh_frame_missing_info(const uint32_t* fde, uint32_t pc)
     return (initial_location + range_length) <= pc;
 }
 
+/**
+ * @brief Parse the .eh_frame_hdr section header to retrieve the sorted table of FDEs.
+ *
+ * @param sorted_table Filled with the address of the sorted table.
+ * @param fde_count Filled with the number of entries in the sorted table.
+ * @param table_enc Filled with the encoding of the table entries.
+ *
+ * @return true if the section header is supported, false else.
+ */
+static bool esp_eh_frame_parse_header(const table_entry** sorted_table, uint32_t* fde_count, uint32_t* table_enc)
+{
+    uint32_t size = 0;
+    uint8_t* enc_values = NULL;
+
+    /* Start parsing the .eh_frame_hdr section. */
+    fde_header* header = (fde_header*) EH_FRAME_HDR_ADDR;
+    if (header->version != 1) {
+        return false;
+    }
+
+    /* Make enc_values point to the end of the structure, where the encoded
+     * values start. */
+    enc_values = (uint8_t*)(header + 1);
+
+    /* Retrieve the encoded value eh_frame_ptr. Get the size of the data also. */
+    const uint32_t eh_frame_ptr = esp_eh_frame_get_encoded(enc_values, header->eh_frame_ptr_enc, &size);
+    assert(eh_frame_ptr == (uint32_t) EH_FRAME_ADDR);
+    (void) eh_frame_ptr;
+    enc_values += size;
+
+    /* Same for the number of entries in the sorted table. */
+    *fde_count = esp_eh_frame_get_encoded(enc_values, header->fde_count_enc, &size);
+    enc_values += size;
+
+    /* enc_values points now at the beginning of the sorted table. */
+    /* Only support 4-byte entries. */
+    *table_enc = header->table_enc;
+    if (((*table_enc >> 4) != 0x3) && ((*table_enc >> 4) != 0xB)) {
+        return false;
+    }
+
+    *sorted_table = (const table_entry*) enc_values;
+    return true;
+}
+
+/**
+ * @brief Restore the caller's context of the given execution frame.
+ *
+ * The unwinding rule for the frame's PC is taken from the cache if possible. Else, it is found in the
+ * sorted table and the DWARF instructions are executed.
+ *
+ * @param sorted_table Sorted table of the .eh_frame_hdr section.
+ * @param fde_count Number of entries in the sorted table.
+ * @param table_enc Encoding of the table entries.
+ * @param frame Snapshot of the CPU registers, restored to the caller's context.
+ * @param state DWARF VM registers, used as a scratch area.
+ * @param ra Filled with the return address of the current context.
+ *
+ * @return true on success, false if the DWARF information for the frame's PC are missing.
+ */
+static bool esp_eh_frame_unwind_frame(const table_entry* sorted_table, const uint32_t fde_count,
+                                      const uint32_t table_enc, ExecutionFrame* frame,
+                                      dwarf_regs* state, uint32_t* ra)
+{
+#if CONFIG_ESP_SYSTEM_EH_FRAME_CACHE_ENTRIES > 0
+    eh_frame_rule rule;
+    if (esp_eh_frame_cache_lookup(EXECUTION_FRAME_PC(*frame), &rule)) {
+        *ra = esp_eh_frame_cache_apply(&rule, frame);
+        return true;
+    }
+#endif
+
+    const table_entry* from_fun = esp_eh_frame_find_entry(sorted_table, fde_count,
+                                                          table_enc, EXECUTION_FRAME_PC(*frame));
+
+    /* Get absolute address of FDE entry describing the function where PC left of. */
+    uint32_t* fde = NULL;
+    if (from_fun != NULL) {
+        fde = esp_eh_frame_decode_address(&from_fun->fde_addr, table_enc);
+    }
+
+    if (esp_eh_frame_missing_info(fde, EXECUTION_FRAME_PC(*frame))) {
+        return false;
+    }
+
+    /* Clean and set the DWARF register structure. */
+    memset(state, 0, sizeof(dwarf_regs));
+
+    /* Retrieve the return address of the frame. The frame's registers will be modified.
+     * The frame we get then is the caller's one. */
+    *ra = esp_eh_frame_restore_caller_state(fde, frame, state);
+    return true;
+}
+
 /**
  * @brief When one step of the backtrace is generated, output it to the serial.
  * This function can be overriden as it is defined as weak.
@@ -864,33 +1116,14 @@ void esp_eh_frame_print_backtrace(const void *frame_or)
 
     static dwarf_regs state = { 0 };
     ExecutionFrame frame = *((ExecutionFrame*) frame_or);
-    uint32_t size = 0;
-    uint8_t* enc_values = NULL;
+    const table_entry* sorted_table = NULL;
+    uint32_t fde_count = 0;
+    uint32_t table_enc = 0;
     bool end_of_backtrace = false;
 
-    /* Start parsing the .eh_frame_hdr section. */
-    fde_header* header = (fde_header*) EH_FRAME_HDR_ADDR;
-    assert(header->version == 1);
-
-    /* Make enc_values point to the end of the structure, where the encoded
-     * values start. */
-    enc_values = (uint8_t*)(header + 1);
-
-    /* Retrieve the encoded value eh_frame_ptr. Get the size of the data also. */
-    const uint32_t eh_frame_ptr = esp_eh_frame_get_encoded(enc_values, header->eh_frame_ptr_enc, &size);
-    assert(eh_frame_ptr == (uint32_t) EH_FRAME_ADDR);
-    enc_values += size;
-
-    /* Same for the number of entries in the sorted table. */
-    const uint32_t fde_count = esp_eh_frame_get_encoded(enc_values, header->fde_count_enc, &size);
-    enc_values += size;
-
-    /* enc_values points now at the beginning of the sorted table. */
-    /* Only support 4-byte entries. */
-    const uint32_t table_enc = header->table_enc;
-    assert(((table_enc >> 4) == 0x3) || ((table_enc >> 4) == 0xB));
-
-    const table_entry* sorted_table = (const table_entry*) enc_values;
+    const bool supported = esp_eh_frame_parse_header(&sorted_table, &fde_count, &table_enc);
+    assert(supported);
+    (void) supported;
 
     panic_print_str("Backtrace:");
     while (!end_of_backtrace) {
@@ -898,17 +1131,10 @@ void esp_eh_frame_print_backtrace(const void *frame_or)
         /* Output one step of the backtrace. */
         esp_eh_frame_generated_step(EXECUTION_FRAME_PC(frame), EXECUTION_FRAME_SP(frame));
 
-        const table_entry* from_fun = esp_eh_frame_find_entry(sorted_table, fde_count,
-                                                              table_enc, EXECUTION_FRAME_PC(frame));
-
-        /* Get absolute address of FDE entry describing the function where PC left of. */
-        uint32_t* fde = NULL;
-
-        if (from_fun != NULL) {
-            fde = esp_eh_frame_decode_address(&from_fun->fde_addr, table_enc);
-        }
+        const uint32_t prev_sp = EXECUTION_FRAME_SP(frame);
+        uint32_t ra = 0;
 
-        if (esp_eh_frame_missing_info(fde, EXECUTION_FRAME_PC(frame))) {
+        if (!esp_eh_frame_unwind_frame(sorted_table, fde_count, table_enc, &frame, &state, &ra)) {
             /* Address was not found in the list. */
             panic_print_str("\r\nBacktrace ended abruptly: cannot find DWARF information for"
                             " instruction at address 0x");
@@ -917,23 +1143,69 @@ void esp_eh_frame_print_backtrace(const void *frame_or)
             break;
         }
 
-        /* Clean and set the DWARF register structure. */
-        memset(&state, 0, sizeof(dwarf_regs));
+        /* End of backtrace is reached if the stack and the PC don't change anymore. */
+        end_of_backtrace = (EXECUTION_FRAME_SP(frame) == prev_sp) && (EXECUTION_FRAME_PC(frame) == ra);
+
+        /* Go back to the caller: update stack pointer and program counter. */
+        EXECUTION_FRAME_PC(frame) = ra;
+    }
+
+    panic_print_str("\r\n");
+}
+
+/**
+ * @brief Capture the backtrace of the given execution frame, without printing it.
+ *
+ * @param frame_or Snapshot of the CPU registers.
+ * @param skip Number of frames to unwind before starting to store PCs.
+ * @param pcs Array filled with the PC of each frame.
+ * @param depth Size of the pcs array.
+ *
+ * @return Number of PCs stored in the array.
+ */
+int esp_eh_frame_backtrace_capture(const void *frame_or, int skip, uint32_t *pcs, int depth)
+{
+    /* Unlike esp_eh_frame_print_backtrace(), which is called from the panic handler,
+     * this function can be called by several tasks at the same time. */
+    dwarf_regs state;
+    ExecutionFrame frame;
+    const table_entry* sorted_table = NULL;
+    uint32_t fde_count = 0;
+    uint32_t table_enc = 0;
+    int count = 0;
+
+    if (frame_or == NULL || pcs == NULL || depth <= 0 ||
+            !esp_eh_frame_parse_header(&sorted_table, &fde_count, &table_enc)) {
+        return 0;
+    }
+
+    frame = *((const ExecutionFrame*) frame_or);
+    while (count < depth) {
+        if (skip > 0) {
+            skip--;
+        } else {
+            pcs[count++] = EXECUTION_FRAME_PC(frame);
+            if (count == depth) {
+                break;
+            }
+        }
 
         const uint32_t prev_sp = EXECUTION_FRAME_SP(frame);
+        uint32_t ra = 0;
 
-        /* Retrieve the return address of the frame. The frame's registers will be modified.
-         * The frame we get then is the caller's one. */
-        uint32_t ra = esp_eh_frame_restore_caller_state(fde, &frame, &state);
+        if (!esp_eh_frame_unwind_frame(sorted_table, fde_count, table_enc, &frame, &state, &ra)) {
+            break;
+        }
 
         /* End of backtrace is reached if the stack and the PC don't change anymore. */
-        end_of_backtrace = (EXECUTION_FRAME_SP(frame) == prev_sp) && (EXECUTION_FRAME_PC(frame) == ra);
+        if ((EXECUTION_FRAME_SP(frame) == prev_sp) && (EXECUTION_FRAME_PC(frame) == ra)) {
+            break;
+        }
 
-        /* Go back to the caller: update stack pointer and program counter. */
         EXECUTION_FRAME_PC(frame) = ra;
     }
 
-    panic_print_str("\r\n");
+    return count;
 }
 
 /**
@@ -958,56 +1230,21 @@ int unw_step(unw_cursor_t* cp)
 {
     static dwarf_regs state = { 0 };
     ExecutionFrame* frame = (ExecutionFrame*) cp;
-    uint32_t size = 0;
-    uint8_t* enc_values = NULL;
-
-    /* Start parsing the .eh_frame_hdr section. */
-    fde_header* header = (fde_header*) EH_FRAME_HDR_ADDR;
-    if (header->version != 1) {
-        goto badversion;
-    }
-
-    /* Make enc_values point to the end of the structure, where the encoded
-     * values start. */
-    enc_values = (uint8_t*)(header + 1);
-
-    /* Retrieve the encoded value eh_frame_ptr. Get the size of the data also. */
-    const uint32_t eh_frame_ptr = esp_eh_frame_get_encoded(enc_values, header->eh_frame_ptr_enc, &size);
-    assert(eh_frame_ptr == (uint32_t) EH_FRAME_ADDR);
-    enc_values += size;
+    const table_entry* sorted_table = NULL;
+    uint32_t fde_count = 0;
+    uint32_t table_enc = 0;
+    uint32_t ra = 0;
 
-    /* Same for the number of entries in the sorted table. */
-    const uint32_t fde_count = esp_eh_frame_get_encoded(enc_values, header->fde_count_enc, &size);
-    enc_values += size;
-
-    /* enc_values points now at the beginning of the sorted table. */
-    /* Only support 4-byte entries. */
-    const uint32_t table_enc = header->table_enc;
-    if (((table_enc >> 4) != 0x3) && ((table_enc >> 4) != 0xB)) {
+    if (!esp_eh_frame_parse_header(&sorted_table, &fde_count, &table_enc)) {
         goto badversion;
     }
 
-    const table_entry* sorted_table = (const table_entry*) enc_values;
-
-    const table_entry* from_fun = esp_eh_frame_find_entry(sorted_table, fde_count,
-                                                          table_enc, EXECUTION_FRAME_PC(*frame));
-
-    /* Get absolute address of FDE entry describing the function where PC left of. */
-    uint32_t* fde = NULL;
-    if (from_fun != NULL) {
-        fde = esp_eh_frame_decode_address(&from_fun->fde_addr, table_enc);
-    }
+    const uint32_t prev_sp = EXECUTION_FRAME_SP(*frame);
 
-    if (esp_eh_frame_missing_info(fde, EXECUTION_FRAME_PC(*frame))) {
+    if (!esp_eh_frame_unwind_frame(sorted_table, fde_count, table_enc, frame, &state, &ra)) {
         goto missinginfo;
     }
 
-    const uint32_t prev_sp = EXECUTION_FRAME_SP(*frame);
-
-    /* Retrieve the return address of the frame. The frame's registers will be modified.
-     * The frame we get then is the caller's one. */
-    uint32_t ra = esp_eh_frame_restore_caller_state(fde, frame, &state);
-
     /* End of backtrace is reached if the stack and the PC don't change anymore. */
     if ((EXECUTION_FRAME_SP(*frame) == prev_sp) && (EXECUTION_FRAME_PC(*frame) == ra)) {
         goto stopunwind;
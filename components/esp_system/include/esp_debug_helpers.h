@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -115,6 +115,22 @@ esp_err_t esp_backtrace_print_from_frame(int depth, const esp_backtrace_frame_t*
  */
 esp_err_t esp_backtrace_print(int depth);
 
+/**
+ * @brief Capture the backtrace of the current stack, without printing it
+ *
+ * This is meant for recording backtraces at run-time, for example for profiling or tracing
+ * purposes, where printing each of them is too slow.
+ *
+ * @param[out] pcs   Array filled with the PC of each stack frame, starting with the caller of this function
+ * @param depth      Number of entries in the pcs array (should be > 0)
+ *
+ * @note On RISC-V targets this is only available if CONFIG_ESP_SYSTEM_USE_EH_FRAME is selected. The unwinding
+ *       rules of the frames are cached, see CONFIG_ESP_SYSTEM_EH_FRAME_CACHE_ENTRIES.
+ *
+ * @return Number of PCs stored in pcs, 0 if the arguments are invalid or if capturing backtraces is not supported.
+ */
+int esp_backtrace_capture(uint32_t *pcs, int depth);
+
 /**
  * @brief Print the backtrace of all tasks
  *
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2020-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2020-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -7,6 +7,8 @@
 #ifndef EH_FRAME_PARSER_H
 #define EH_FRAME_PARSER_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,6 +22,21 @@ extern "C" {
  */
 void esp_eh_frame_print_backtrace(const void *frame_or);
 
+/**
+ * @brief Capture the backtrace of the given execution frame, without printing it.
+ *
+ * Unlike esp_eh_frame_print_backtrace(), this function can be called from several
+ * tasks at the same time.
+ *
+ * @param frame_or Snapshot of the CPU registers. The stack it refers to must still be valid.
+ * @param skip Number of frames to unwind before starting to store PCs.
+ * @param[out] pcs Array filled with the PC of each frame, starting with the innermost one.
+ * @param depth Number of entries in the pcs array.
+ *
+ * @return Number of PCs stored in pcs.
+ */
+int esp_eh_frame_backtrace_capture(const void *frame_or, int skip, uint32_t *pcs, int depth);
+
 #ifdef __cplusplus
 }
 #endif
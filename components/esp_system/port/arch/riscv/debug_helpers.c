@@ -17,6 +17,7 @@
 
 #if CONFIG_ESP_SYSTEM_USE_EH_FRAME
 #include "esp_private/eh_frame_parser.h"
+#include "libunwind.h"
 
 #elif CONFIG_ESP_SYSTEM_USE_FRAME_POINTER
 extern void esp_fp_print_backtrace(const void*);
@@ -68,3 +69,17 @@ esp_err_t ESP_SYSTEM_IRAM_ATTR esp_backtrace_print(int depth)
 
     return ESP_OK;
 }
+
+int esp_backtrace_capture(uint32_t *pcs, int depth)
+{
+#if CONFIG_ESP_SYSTEM_USE_EH_FRAME
+    unw_context_t context = { 0 };
+    unw_getcontext(&context);
+    /* Skip the frame of this function, start with its caller */
+    return esp_eh_frame_backtrace_capture(&context, 1, pcs, depth);
+#else // CONFIG_ESP_SYSTEM_USE_EH_FRAME
+    (void)pcs;
+    (void)depth;
+    return 0;
+#endif // CONFIG_ESP_SYSTEM_USE_EH_FRAME
+}
@@ -105,6 +105,24 @@ esp_err_t ESP_SYSTEM_IRAM_ATTR esp_backtrace_print(int depth)
     return esp_backtrace_print_from_frame(depth, &start, false);
 }
 
+int esp_backtrace_capture(uint32_t *pcs, int depth)
+{
+    if (pcs == NULL || depth <= 0) {
+        return 0;
+    }
+
+    //The first frame returned by esp_backtrace_get_start() is the one of our caller
+    esp_backtrace_frame_t stk_frame = { 0 };
+    esp_backtrace_get_start(&(stk_frame.pc), &(stk_frame.sp), &(stk_frame.next_pc));
+
+    int count = 0;
+    pcs[count++] = esp_cpu_process_stack_pc(stk_frame.pc);
+    while (count < depth && stk_frame.next_pc != 0 && esp_backtrace_get_next_frame(&stk_frame)) {
+        pcs[count++] = esp_cpu_process_stack_pc(stk_frame.pc);
+    }
+    return count;
+}
+
 typedef struct {
 #if !CONFIG_FREERTOS_UNICORE
     volatile bool start_tracing;
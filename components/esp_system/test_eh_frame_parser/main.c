@@ -1,6 +1,6 @@
 
 /*
- * SPDX-FileCopyrightText: 2020-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2020-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -15,6 +15,7 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <ucontext.h>
+#include <time.h>
 #include "esp_private/eh_frame_parser.h"
 #include "libunwind.h"
 
@@ -47,6 +48,11 @@
  */
 #define NUMBER_OF_ITERATION     (2 * NUMBER_TO_TEST + 2 + 1)
 
+/**
+ * @brief Number of backtraces captured by the capture benchmark.
+ */
+#define BENCHMARK_CAPTURES      (100000)
+
 /**
  * @brief Macro for testing calls to libunwind when UNW_ESUCCESS must be returned.
  */
@@ -94,6 +100,7 @@ bool is_odd(uint32_t n);
 bool is_even(uint32_t n);
 void browse_list(struct list_t* l);
 int analyse_callstack();
+void benchmark_capture(const unw_context_t* ucp);
 int inner_function1(void);
 int inner_function2(void);
 void test1(void);
@@ -369,6 +376,44 @@ void test2(void)
     is_even(NUMBER_TO_TEST);
 }
 
+/**
+ * Benchmark the backtrace capture, which doesn't print anything.
+ * All the captures go through the same frames, so after the first one, the unwinding
+ * rules are taken from the cache instead of being decoded from the DWARF information.
+ *
+ * @param ucp Context of the caller, analyse_callstack().
+ */
+void benchmark_capture(const unw_context_t* ucp)
+{
+    uint32_t pcs[8] = { 0 };
+    uint32_t frames = 0;
+    struct timespec start = { 0 };
+    struct timespec end = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < BENCHMARK_CAPTURES; i++) {
+        const int count = esp_eh_frame_backtrace_capture(ucp, 0, pcs, sizeof(pcs) / sizeof(*pcs));
+        UNW_CHECK_TRUE(count >= 4);
+        frames += count;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /* Check that the last capture, made with the cached rules, is still correct. */
+    UNW_CHECK_PC((unw_word_t) pcs[0], "analyse_callstack");
+    UNW_CHECK_PC((unw_word_t) pcs[1], "inner_function2");
+    UNW_CHECK_PC((unw_word_t) pcs[2], "inner_function1");
+    UNW_CHECK_PC((unw_word_t) pcs[3], "test1");
+
+    /* Skipping frames gives the same PCs. */
+    uint32_t skipped_pcs[2] = { 0 };
+    UNW_CHECK_TRUE(esp_eh_frame_backtrace_capture(ucp, 2, skipped_pcs, 2) == 2);
+    UNW_CHECK_TRUE(skipped_pcs[0] == pcs[2] && skipped_pcs[1] == pcs[3]);
+
+    const double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Captured %u frames in %.3f s: %.0f frames per second\r\n",
+           frames, elapsed, frames / elapsed);
+}
+
 /**
  * Test the libunwind implementation in ESP-IDF
  * Let's create some nested function calls to make unwinding more interesting.
@@ -399,6 +444,9 @@ int analyse_callstack()
     UNW_CHECK(unw_get_reg(&cur, UNW_X86_EIP, &pc));
     UNW_CHECK_PC(pc, "test1");
 
+    /* The benchmark needs the stack of this function to be alive, call it from here. */
+    benchmark_capture(&ucp);
+
     return UNW_ESUCCESS;
 }
 
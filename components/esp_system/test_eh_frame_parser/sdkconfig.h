@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -8,5 +8,6 @@
 
 #define CONFIG_ESP_SYSTEM_USE_EH_FRAME 1
 #define CONFIG_IDF_TARGET_X86 1
+#define CONFIG_ESP_SYSTEM_EH_FRAME_CACHE_ENTRIES 32
 
 #endif // SDKCONFIG_H
@@ -6,7 +6,7 @@
  *
  * SPDX-License-Identifier: MIT
  *
- * SPDX-FileContributor: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileContributor: 2023-2025 Espressif Systems (Shanghai) CO LTD
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of
  * this software and associated documentation files (the "Software"), to deal in
@@ -125,6 +125,9 @@ void vPortReleaseLock( portMUX_TYPE *lock );
 
 void vPortYield( void );
 extern void vPortYieldFromISR( void );
+#if ( configNUMBER_OF_CORES > 1 )
+void vPortYieldCore( BaseType_t xCoreID );
+#endif /* configNUMBER_OF_CORES > 1 */
 
 #define portYIELD_FROM_ISR_CHECK(x)     ({ \
     if ( (x) == pdTRUE ) { \
@@ -169,6 +172,20 @@ void vPortCleanUpTCB ( void *pxTCB );
 extern BaseType_t xPortSetInterruptMask( void );
 extern void vPortClearInterruptMask( BaseType_t xMask );
 
+#if ( configNUMBER_OF_CORES > 1 )
+#define portSET_INTERRUPT_MASK()                    xPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK(x)                 vPortClearInterruptMask(x)
+#define portSET_INTERRUPT_MASK_FROM_ISR()           xPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)        vPortClearInterruptMask(x)
+
+#define portGET_TASK_LOCK()                         vPortTakeLock(&port_xTaskLock)
+#define portRELEASE_TASK_LOCK()                     vPortReleaseLock(&port_xTaskLock)
+#define portGET_ISR_LOCK()                          vPortTakeLock(&port_xISRLock)
+#define portRELEASE_ISR_LOCK()                      vPortReleaseLock(&port_xISRLock)
+
+#define portENTER_CRITICAL_FROM_ISR()               vTaskEnterCriticalFromISR()
+#define portEXIT_CRITICAL_FROM_ISR(x)               vTaskExitCriticalFromISR(x)
+#else
 #define portSET_INTERRUPT_MASK_FROM_ISR() ({ \
     BaseType_t cur_level; \
     cur_level = xPortSetInterruptMask(); \
@@ -179,6 +196,7 @@ extern void vPortClearInterruptMask( BaseType_t xMask );
     vTaskExitCritical(); \
     vPortClearInterruptMask(x); \
 })
+#endif /* configNUMBER_OF_CORES > 1 */
 
 // ---------------------- Yielding -------------------------
 
@@ -188,7 +206,9 @@ extern void vPortClearInterruptMask( BaseType_t xMask );
 #else
 #define portYIELD_FROM_ISR(...)                     CHOOSE_MACRO_VA_ARG(portYIELD_FROM_ISR_CHECK, portYIELD_FROM_ISR_NO_CHECK, ##__VA_ARGS__)(__VA_ARGS__)
 #endif
-// Note that the Linux port does not provide portYIELD_CORE(x) because purely single core for now.
+#if ( configNUMBER_OF_CORES > 1 )
+#define portYIELD_CORE(x)                           vPortYieldCore(x)
+#endif /* configNUMBER_OF_CORES > 1 */
 
 // ----------------------- System --------------------------
 
@@ -218,18 +238,21 @@ extern unsigned long ulPortGetRunTime( void );
 
 // ---------------------- Yielding -------------------------
 
-// NOTE: vPortYieldCore( BaseType_t xCoreID ) is currently not implemented as the simulator is single core
-
 // ----------------------- System --------------------------
 /**
  * @brief Get the current core's ID
  *
- * @note dummy function for freertos simulator, always returns 0.
- @ return BaseType_t 0
+ * @note On the POSIX simulator, this is the simulated core which the calling task's thread is currently running on.
+ *       Threads which are not FreeRTOS tasks always get 0.
+ * @return BaseType_t Core ID
  */
 static inline BaseType_t xPortGetCoreID(void)
 {
-    return (BaseType_t) 0; // POSIX simulator is only single-core at the moment
+#if ( configNUMBER_OF_CORES > 1 )
+    return (BaseType_t) port_uxCoreID;
+#else
+    return (BaseType_t) 0;
+#endif
 }
 
 /* ------------------------------------------------ IDF Compatibility --------------------------------------------------
@@ -265,22 +288,39 @@ static inline void vPortAssertIfInISR(void)
 
 // ------------------ Critical Sections --------------------
 
-void vPortEnterCriticalIDF(void);
-void vPortExitCriticalIDF(void);
+/**
+ * @brief Enter an IDF style critical section, i.e., disable interrupts and take the spinlock
+ *
+ * @note The spinlock is only taken when there are several simulated cores
+ * @param lock Spinlock
+ * @param timeout Timeout to wait for the spinlock, in number of attempts
+ * @return pdPASS if the critical section was entered, pdFAIL if the spinlock could not be taken in time
+ */
+BaseType_t xPortEnterCriticalTimeout(portMUX_TYPE *lock, BaseType_t timeout);
 
-// We ignore the lock and timeout argument on POSIX simulator since it is single core
+/**
+ * @brief Exit an IDF style critical section
+ *
+ * @param lock Spinlock
+ */
+void vPortExitCriticalIDF(portMUX_TYPE *lock);
+
+static inline void vPortEnterCriticalIDF(portMUX_TYPE *lock)
+{
+    xPortEnterCriticalTimeout(lock, portMUX_NO_TIMEOUT);
+}
 
 //IDF task critical sections
-#define portTRY_ENTER_CRITICAL(lock, timeout)       ({(void) lock; (void) timeout; vPortEnterCriticalIDF(); pdPASS;})
-#define portENTER_CRITICAL_IDF(lock)                ({(void) lock; vPortEnterCriticalIDF();})
-#define portEXIT_CRITICAL_IDF(lock)                 ({(void) lock; vPortExitCriticalIDF();})
+#define portTRY_ENTER_CRITICAL(lock, timeout)       xPortEnterCriticalTimeout(lock, timeout)
+#define portENTER_CRITICAL_IDF(lock)                vPortEnterCriticalIDF(lock)
+#define portEXIT_CRITICAL_IDF(lock)                 vPortExitCriticalIDF(lock)
 //IDF ISR critical sections
-#define portTRY_ENTER_CRITICAL_ISR(lock, timeout)   ({(void) lock; (void) timeout; vPortEnterCriticalIDF(); pdPASS;})
-#define portENTER_CRITICAL_ISR(lock)                ({(void) lock; vPortEnterCriticalIDF();})
-#define portEXIT_CRITICAL_ISR(lock)                 ({(void) lock; vPortExitCriticalIDF();})
+#define portTRY_ENTER_CRITICAL_ISR(lock, timeout)   xPortEnterCriticalTimeout(lock, timeout)
+#define portENTER_CRITICAL_ISR(lock)                vPortEnterCriticalIDF(lock)
+#define portEXIT_CRITICAL_ISR(lock)                 vPortExitCriticalIDF(lock)
 //IDF safe critical sections (they're the same)
-#define portENTER_CRITICAL_SAFE(lock)               ({(void) lock; vPortEnterCriticalIDF();})
-#define portEXIT_CRITICAL_SAFE(lock)                ({(void) lock; vPortExitCriticalIDF();})
+#define portENTER_CRITICAL_SAFE(lock)               vPortEnterCriticalIDF(lock)
+#define portEXIT_CRITICAL_SAFE(lock)                vPortExitCriticalIDF(lock)
 
 // ---------------------- Yielding -------------------------
 
@@ -307,10 +347,15 @@ extern void vPortCancelThread( void *pxTaskToDelete );
  * are always a full memory barrier. ISRs are emulated as signals
  * which also imply a full memory barrier.
  *
- * Thus, only a compiler barrier is needed to prevent the compiler
- * reordering.
+ * Thus, with a single simulated core, only a compiler barrier is needed
+ * to prevent the compiler reordering. With several simulated cores, tasks
+ * run concurrently on the host CPUs and a hardware barrier is needed.
  */
+#if ( configNUMBER_OF_CORES > 1 )
+#define portMEMORY_BARRIER() __atomic_thread_fence( __ATOMIC_SEQ_CST )
+#else
 #define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
+#endif
 
 #ifdef __cplusplus
 }
@@ -1,16 +1,23 @@
 /*
- * SPDX-FileCopyrightText: 2015-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 /*
- * This file provides only very simple stubs to build IDF-based FreeRTOSes which use spinlocks on Linux.
+ * This file provides the spinlocks used by IDF-based FreeRTOSes on Linux.
+ *
+ * With a single simulated core (CONFIG_ESP_SYSTEM_SINGLE_CORE_MODE), the functions are only stubs. With several
+ * simulated cores, a spinlock is owned by the simulated core whose task thread acquired it, in the same way as on the
+ * multi-core targets.
  */
 #pragma once
 
+#include "sdkconfig.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <assert.h>
+#include <sched.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,20 +27,23 @@ extern "C" {
 #define SPINLOCK_WAIT_FOREVER  (-1)
 #define SPINLOCK_NO_WAIT        0
 #define SPINLOCK_INITIALIZER   {.owner = SPINLOCK_FREE,.count = 0}
+
+#define SPINLOCK_OWNER_ID_0 0xCDCD  /* Same as CORE_ID_REGVAL_PRO on Xtensa */
+#define SPINLOCK_OWNER_ID_1 0xABAB  /* Same as CORE_ID_REGVAL_APP on Xtensa */
 #define CORE_ID_REGVAL_XOR_SWAP (0xCDCD ^ 0xABAB)
+#define SPINLOCK_OWNER_ID_XOR_SWAP CORE_ID_REGVAL_XOR_SWAP
 
 /**
  * @brief Spinlock object
  * Owner:
  *  - Set to 0 if uninitialized
  *  - Set to portMUX_FREE_VAL when free
- *  - Set to CORE_ID_REGVAL_PRO or CORE_ID_REGVAL_AP when locked
+ *  - Set to SPINLOCK_OWNER_ID_0 or SPINLOCK_OWNER_ID_1 when locked
  *  - Any other value indicates corruption
  * Count:
  *  - 0 if unlocked
  *  - Recursive count if locked
  *
- * @note The simulator is single-core, hence, it doesn't have a proper spinlock implementation.
  * @note Keep portMUX_INITIALIZER_UNLOCKED in sync with this struct
  */
 typedef struct {
@@ -41,17 +51,89 @@ typedef struct {
     uint32_t count;
 }spinlock_t;
 
+#if !CONFIG_ESP_SYSTEM_SINGLE_CORE_MODE
+/* Simulated core which the calling thread currently runs on. Maintained by the port (see port.c) */
+extern __thread uint32_t port_uxCoreID;
+
+static inline uint32_t __attribute__((always_inline)) spinlock_owner_id(void)
+{
+    return (port_uxCoreID == 0) ? SPINLOCK_OWNER_ID_0 : SPINLOCK_OWNER_ID_1;
+}
+#endif
+
 static inline void __attribute__((always_inline)) spinlock_initialize(spinlock_t *lock)
 {
+#if !CONFIG_ESP_SYSTEM_SINGLE_CORE_MODE
+    assert(lock);
+    lock->owner = SPINLOCK_FREE;
+    lock->count = 0;
+#endif
 }
 
+/**
+ * @brief Top level spinlock acquire function, spins until get the lock
+ *
+ * @note As on the targets, the spinlock only excludes the other simulated cores. Callers must also disable
+ *       interrupts (i.e., block signals), which the FreeRTOS critical sections do.
+ * @param lock - target spinlock object
+ * @param timeout - number of attempts, passing SPINLOCK_WAIT_FOREVER blocks indefinitely
+ */
 static inline bool __attribute__((always_inline)) spinlock_acquire(spinlock_t *lock, int32_t timeout)
 {
+#if !CONFIG_ESP_SYSTEM_SINGLE_CORE_MODE
+    uint32_t core_owner_id;
+    uint32_t expected;
+    bool lock_set;
+
+    assert(lock);
+    core_owner_id = spinlock_owner_id();
+
+    // The caller is already the owner of the lock. Simply increment the nesting count
+    if (__atomic_load_n(&lock->owner, __ATOMIC_RELAXED) == core_owner_id) {
+        assert(lock->count > 0 && lock->count < 0xFF);    // Bad count value implies memory corruption
+        lock->count++;
+        return true;
+    }
+
+    do {
+        expected = SPINLOCK_FREE;
+        lock_set = __atomic_compare_exchange_n(&lock->owner, &expected, core_owner_id, false,
+                                               __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        if (lock_set) {
+            break;
+        }
+        assert(expected == (CORE_ID_REGVAL_XOR_SWAP ^ core_owner_id));   // Any other owner implies memory corruption
+        // The owner is a host thread which may have been preempted, give it a chance to run
+        sched_yield();
+    } while (timeout == SPINLOCK_WAIT_FOREVER || timeout-- > 0);
+
+    if (lock_set) {
+        assert(lock->count == 0);   // This is the first time the lock is set, so count should still be 0
+        lock->count++;
+    }
+    return lock_set;
+#else
     return true;
+#endif
 }
 
+/**
+ * @brief Top level spinlock unlock function, unlocks a previously locked spinlock
+ *
+ * @param lock - target, locked before, spinlock object
+ */
 static inline void __attribute__((always_inline)) spinlock_release(spinlock_t *lock)
 {
+#if !CONFIG_ESP_SYSTEM_SINGLE_CORE_MODE
+    assert(lock);
+    assert(lock->owner == spinlock_owner_id()); // This is a lock that we didn't acquire, or the lock is corrupt
+    lock->count--;
+    if (!lock->count) { // If this is the last recursive release of the lock, mark the lock as free
+        __atomic_store_n(&lock->owner, SPINLOCK_FREE, __ATOMIC_RELEASE);
+    } else {
+        assert(lock->count < 0x100); // Indicates memory corruption
+    }
+#endif
 }
 
 #ifdef __cplusplus
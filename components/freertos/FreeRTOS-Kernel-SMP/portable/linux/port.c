@@ -43,6 +43,12 @@
  * The timer interrupt uses SIGALRM and care is taken to ensure that
  * the signal handler runs only on the thread for the current task.
  *
+ * With several simulated cores, the threads of the tasks selected for
+ * each core run at the same time. Each thread knows which core it runs
+ * on, and a core is asked to yield by sending SIGUSR2 to the thread of
+ * the task running on it. The tick is handled by the core whose thread
+ * receives SIGALRM.
+ *
  * Use of part of the standard C library requires care as some
  * functions can take pthread mutexes internally which can result in
  * deadlocks as the FreeRTOS kernel can switch tasks while they're
@@ -73,9 +79,11 @@
 #include "timers.h"
 #include "utils/wait_for_event.h"
 #include "esp_log.h"
+#include "esp_private/freertos_idf_additions_priv.h"
 /*-----------------------------------------------------------*/
 
 #define SIG_RESUME SIGUSR1
+#define SIG_YIELD  SIGUSR2
 
 typedef struct THREAD
 {
@@ -83,6 +91,7 @@ typedef struct THREAD
     TaskFunction_t pxCode;
     void *pvParams;
     BaseType_t xDying;
+    BaseType_t xCoreID;     /* Simulated core the thread runs on once resumed */
     struct event *ev;
 } Thread_t;
 
@@ -104,10 +113,14 @@ static sigset_t xAllSignals;
 static sigset_t xSchedulerOriginalSignalMask;
 static pthread_t hMainThread = ( pthread_t )NULL;
 
-// These are saved as part of a thread's state in prvSwitchThread()
-static volatile BaseType_t uxCriticalNestingIDF = 0;    /* Track nesting calls for IDF style critical sections. FreeRTOS critical section nesting is maintained in the TCB. */
-static volatile UBaseType_t uxInterruptNesting = 0;     /* Tracks if we are currently in an interrupt. */
-static volatile BaseType_t uxInterruptLevel = 0;        /* Tracks the current level (i.e., interrupt mask) */
+// These are part of a thread's state, hence thread local. A thread keeps them when it is switched out.
+static __thread volatile BaseType_t uxCriticalNestingIDF = 0;   /* Track nesting calls for IDF style critical sections. FreeRTOS critical section nesting is maintained in the TCB. */
+static __thread volatile UBaseType_t uxInterruptNesting = 0;    /* Tracks if we are currently in an interrupt. */
+static __thread volatile BaseType_t uxInterruptLevel = 0;       /* Tracks the current level (i.e., interrupt mask) */
+
+#if ( configNUMBER_OF_CORES > 1 )
+__thread uint32_t port_uxCoreID = 0;    /* Simulated core the thread runs on, set each time the thread is resumed */
+#endif /* configNUMBER_OF_CORES > 1 */
 /*-----------------------------------------------------------*/
 
 static BaseType_t xSchedulerEnd = pdFALSE;
@@ -119,8 +132,11 @@ static void *prvWaitForStart( void * pvParams );
 static void prvSwitchThread( Thread_t * xThreadToResume,
                              Thread_t *xThreadToSuspend );
 static void prvSuspendSelf( Thread_t * thread);
-static void prvResumeThread( Thread_t * xThreadId );
+static void prvResumeThread( Thread_t * xThreadId, BaseType_t xCoreID );
 static void vPortSystemTickHandler( int sig );
+#if ( configNUMBER_OF_CORES > 1 )
+static void vPortYieldCoreHandler( int sig );
+#endif /* configNUMBER_OF_CORES > 1 */
 static void vPortStartFirstTask( void );
 /*-----------------------------------------------------------*/
 
@@ -155,6 +171,7 @@ StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
     thread->pxCode = pxCode;
     thread->pvParams = pvParameters;
     thread->xDying = pdFALSE;
+    thread->xCoreID = 0;
 
     pthread_attr_init( &xThreadAttributes );
     pthread_attr_setstack( &xThreadAttributes, pxEndOfStack, ulStackSize );
@@ -178,10 +195,27 @@ StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
 
 void vPortStartFirstTask( void )
 {
+#if ( configNUMBER_OF_CORES > 1 )
+    /* The scheduler is started from the main thread, which acts as core 0. Mark it
+     * as running on the other cores on their behalf (see IDF-4524). */
+    for ( BaseType_t xCoreID = 1; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+    {
+        port_uxCoreID = xCoreID;
+        prvStartSchedulerOtherCores();
+    }
+    port_uxCoreID = 0;
+
+    /* Start the first task of each core. */
+    for ( BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+    {
+        prvResumeThread( prvGetThreadFromTask( xTaskGetCurrentTaskHandleForCore( xCoreID ) ), xCoreID );
+    }
+#else
     Thread_t *pxFirstThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
     /* Start the first task. */
-    prvResumeThread( pxFirstThread );
+    prvResumeThread( pxFirstThread, 0 );
+#endif /* configNUMBER_OF_CORES > 1 */
 }
 /*-----------------------------------------------------------*/
 
@@ -213,7 +247,14 @@ BaseType_t xPortStartScheduler( void )
 
     /* Cancel the Idle task and free its resources */
 #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+#if ( configNUMBER_OF_CORES > 1 )
+    for ( BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+    {
+        vPortCancelThread( xTaskGetIdleTaskHandleForCore( xCoreID ) );
+    }
+#else
     vPortCancelThread( xTaskGetIdleTaskHandle() );
+#endif /* configNUMBER_OF_CORES > 1 */
 #endif
 
 #if ( configUSE_TIMERS == 1 )
@@ -265,22 +306,40 @@ static void vPortDisableInterrupts( void )
 
 static void vPortEnableInterrupts( void )
 {
-    pthread_sigmask( SIG_UNBLOCK, &xAllSignals, NULL );
+    /* Signal handlers run with all signals blocked, the mask of the interrupted
+     * thread is restored when they return. */
+    if ( uxInterruptNesting == 0 )
+    {
+        pthread_sigmask( SIG_UNBLOCK, &xAllSignals, NULL );
+    }
 }
 /*-----------------------------------------------------------*/
 
-void vPortEnterCriticalIDF( void )
+BaseType_t xPortEnterCriticalTimeout( portMUX_TYPE *lock, BaseType_t timeout )
 {
     if ( uxCriticalNestingIDF == 0 && uxInterruptLevel == 0)
     {
         vPortDisableInterrupts();
     }
+
+    /* The spinlock is only a stub when there is a single simulated core */
+    if ( !spinlock_acquire( lock, timeout ) )
+    {
+        if ( uxCriticalNestingIDF == 0 && uxInterruptLevel == 0)
+        {
+            vPortEnableInterrupts();
+        }
+        return pdFAIL;
+    }
     uxCriticalNestingIDF++;
+    return pdPASS;
 }
 /*-----------------------------------------------------------*/
 
-void vPortExitCriticalIDF( void )
+void vPortExitCriticalIDF( portMUX_TYPE *lock )
 {
+    spinlock_release( lock );
+    configASSERT( uxCriticalNestingIDF > 0 );
     uxCriticalNestingIDF--;
 
     /* If we have reached 0 then re-enable the interrupts. */
@@ -298,7 +357,11 @@ void vPortYieldFromISR( void )
 
     xThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
+#if ( configNUMBER_OF_CORES > 1 )
+    vTaskSwitchContext( xPortGetCoreID() );
+#else
     vTaskSwitchContext();
+#endif /* configNUMBER_OF_CORES > 1 */
 
     xThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
@@ -316,6 +379,31 @@ void vPortYield( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configNUMBER_OF_CORES > 1 )
+void vPortYieldCore( BaseType_t xCoreID )
+{
+    /* The kernel calls this with its locks held, so the task selected for the other
+     * core cannot change. If that task's thread is being switched out or has not been
+     * resumed yet, the signal stays pending on it until it unblocks interrupts again.
+     * It then yields on whichever core it runs, which is at worst a spurious yield. */
+    Thread_t *pxThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandleForCore( xCoreID ) );
+
+    (void)pthread_kill( pxThread->pthread, SIG_YIELD );
+}
+/*-----------------------------------------------------------*/
+
+static void vPortYieldCoreHandler( int sig )
+{
+    // Handling a yield request from another core, so we are currently in an interrupt.
+    uxInterruptNesting++;
+
+    vPortYieldFromISR();
+
+    uxInterruptNesting--;
+}
+#endif /* configNUMBER_OF_CORES > 1 */
+/*-----------------------------------------------------------*/
+
 /* In SMP code, the disable/enable interrupt macros are calling the set/get interrupt mask functions below.
    Hence, we need to call vPortDisableInterrupts() and vPortEnableInterrupts(), otherwise interrupts
    are never disabled/enabled. */
@@ -411,7 +499,16 @@ static void vPortSystemTickHandler( int sig )
  *      xExpectedTicks = (prvGetTimeNs() - prvStartTimeNs)
  *        / (portTICK_RATE_MICROSECONDS * 1000);
  * do { */
+#if ( configNUMBER_OF_CORES > 1 )
+    /* There is a single tick signal for all the simulated cores, so the core
+     * receiving it increments the tick. Time slicing of the other cores is
+     * handled by the kernel through portYIELD_CORE(). */
+    UBaseType_t uxSavedStatus = taskENTER_CRITICAL_FROM_ISR();
+    xSwitchRequired = xTaskIncrementTick();
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedStatus );
+#else
     xSwitchRequired = xTaskIncrementTick();
+#endif /* configNUMBER_OF_CORES > 1 */
 /*        prvTickCount++;
  *    } while (prvTickCount < xExpectedTicks);
 */
@@ -419,7 +516,11 @@ static void vPortSystemTickHandler( int sig )
 #if ( configUSE_PREEMPTION == 1 )
     if (xSwitchRequired == pdTRUE) {
         /* Select Next Task. */
+#if ( configNUMBER_OF_CORES > 1 )
+        vTaskSwitchContext( xPortGetCoreID() );
+#else
         vTaskSwitchContext();
+#endif /* configNUMBER_OF_CORES > 1 */
 
         pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
@@ -485,32 +586,20 @@ static void *prvWaitForStart( void * pvParams )
 static void prvSwitchThread( Thread_t *pxThreadToResume,
                              Thread_t *pxThreadToSuspend )
 {
-    BaseType_t uxSavedCriticalNestingIDF;
-    BaseType_t uxSavedInterruptNesting;
-    BaseType_t uxSavedInterruptLevel;
-
     if ( pxThreadToSuspend != pxThreadToResume )
     {
         /* It is possible for prvSwitchThread() to be called...
          * - while inside an ISR (i.e., via vPortSystemTickHandler() or vPortYieldFromISR())
          * - while interrupts are disabled or in a critical section (i.e., via vPortYield())
          *
-         * So we need to save the various count variables as part of the thread's context.
-         * They are restored when the pthread switches back. */
-        uxSavedCriticalNestingIDF = uxCriticalNestingIDF;
-        uxSavedInterruptNesting = uxInterruptNesting;
-        uxSavedInterruptLevel = uxInterruptLevel;
-
-        prvResumeThread( pxThreadToResume );
+         * The various count variables are thread local, so they are kept as part of the
+         * thread's context until the pthread is switched back, possibly on another core. */
+        prvResumeThread( pxThreadToResume, xPortGetCoreID() );
         if ( pxThreadToSuspend->xDying )
         {
             pthread_exit( NULL );
         }
         prvSuspendSelf( pxThreadToSuspend );
-
-        uxCriticalNestingIDF = uxSavedCriticalNestingIDF;
-        uxInterruptNesting = uxSavedInterruptNesting;
-        uxInterruptLevel = uxSavedInterruptLevel;
     }
 }
 /*-----------------------------------------------------------*/
@@ -531,14 +620,20 @@ static void prvSuspendSelf( Thread_t *thread )
      * - A thread with all signals blocked with pthread_sigmask().
         */
     event_wait(thread->ev);
+
+#if ( configNUMBER_OF_CORES > 1 )
+    /* Set by the thread which resumed us before signaling the event */
+    port_uxCoreID = thread->xCoreID;
+#endif /* configNUMBER_OF_CORES > 1 */
 }
 
 /*-----------------------------------------------------------*/
 
-static void prvResumeThread( Thread_t *xThreadId )
+static void prvResumeThread( Thread_t *xThreadId, BaseType_t xCoreID )
 {
     if ( pthread_self() != xThreadId->pthread )
     {
+        xThreadId->xCoreID = xCoreID;
         event_signal(xThreadId->ev);
     }
 }
@@ -547,6 +642,9 @@ static void prvResumeThread( Thread_t *xThreadId )
 static void prvSetupSignalsAndSchedulerPolicy( void )
 {
     struct sigaction sigresume, sigtick;
+#if ( configNUMBER_OF_CORES > 1 )
+    struct sigaction sigyield;
+#endif /* configNUMBER_OF_CORES > 1 */
     int iRet;
 
     hMainThread = pthread_self();
@@ -588,6 +686,18 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
     {
         prvFatalError( "sigaction", errno );
     }
+
+#if ( configNUMBER_OF_CORES > 1 )
+    sigyield.sa_flags = 0;
+    sigyield.sa_handler = vPortYieldCoreHandler;
+    sigfillset( &sigyield.sa_mask );
+
+    iRet = sigaction( SIG_YIELD, &sigyield, NULL );
+    if ( iRet )
+    {
+        prvFatalError( "sigaction", errno );
+    }
+#endif /* configNUMBER_OF_CORES > 1 */
 }
 /*-----------------------------------------------------------*/
 
@@ -645,9 +755,9 @@ int main(int argc, const char **argv)
     BaseType_t res;
 
 #if ( configNUM_CORES > 1 )
-    res = xTaskCreateAffinitySet(&main_task, "main",
-                                 ESP_TASK_MAIN_STACK, NULL,
-                                 ESP_TASK_MAIN_PRIO, ESP_TASK_MAIN_CORE, NULL);
+    res = xTaskCreatePinnedToCore(&main_task, "main",
+                                  ESP_TASK_MAIN_STACK, NULL,
+                                  ESP_TASK_MAIN_PRIO, NULL, ESP_TASK_MAIN_CORE);
 #else
     res = xTaskCreate(&main_task, "main",
                       ESP_TASK_MAIN_STACK, NULL,
@@ -715,6 +825,22 @@ void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
      * configMINIMAL_STACK_SIZE is specified in bytes. */
     *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
 }
+
+#if ( configNUMBER_OF_CORES > 1 )
+/* Same as vApplicationGetIdleTaskMemory(), for the idle tasks of the other cores. */
+void vApplicationGetPassiveIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                           StackType_t ** ppxIdleTaskStackBuffer,
+                                           uint32_t * pulIdleTaskStackSize,
+                                           BaseType_t xPassiveIdleTaskIndex )
+{
+    static StaticTask_t xPassiveIdleTaskTCBs[ configNUMBER_OF_CORES - 1 ];
+    static StackType_t uxPassiveIdleTaskStacks[ configNUMBER_OF_CORES - 1 ][ configMINIMAL_STACK_SIZE ];
+
+    *ppxIdleTaskTCBBuffer = &xPassiveIdleTaskTCBs[ xPassiveIdleTaskIndex ];
+    *ppxIdleTaskStackBuffer = uxPassiveIdleTaskStacks[ xPassiveIdleTaskIndex ];
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+#endif /* configNUMBER_OF_CORES > 1 */
 #endif // configSUPPORT_STATIC_ALLOCATION == 1
 /*-----------------------------------------------------------*/
 
@@ -274,6 +274,21 @@ size_t heap_caps_get_total_size(uint32_t caps)
     return total_size;
 }
 
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+/* Blocks kept by the small block cache are allocated from their heap, but are reported as free */
+static void add_cached_blocks_to_info(const heap_t *heap, multi_heap_info_t *info)
+{
+    if (heap->cache != NULL) {
+        multi_heap_cache_stats_t stats;
+        multi_heap_cache_get_stats(heap->cache, &stats);
+        info->total_free_bytes += stats.free_bytes;
+        info->total_allocated_bytes -= stats.allocated_bytes;
+        info->allocated_blocks -= stats.blocks;
+        info->free_blocks += stats.blocks;
+    }
+}
+#endif
+
 size_t heap_caps_get_free_size( uint32_t caps )
 {
     size_t ret = 0;
@@ -281,6 +296,13 @@ size_t heap_caps_get_free_size( uint32_t caps )
     SLIST_FOREACH(heap, &registered_heaps, next) {
         if (heap_caps_match(heap, caps)) {
             ret += multi_heap_free_size(heap->heap);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+            if (heap->cache != NULL) {
+                multi_heap_cache_stats_t stats;
+                multi_heap_cache_get_stats(heap->cache, &stats);
+                ret += stats.free_bytes;
+            }
+#endif
         }
     }
     return ret;
@@ -373,6 +395,9 @@ void heap_caps_get_info( multi_heap_info_t *info, uint32_t caps )
         if (heap_caps_match(heap, caps)) {
             multi_heap_info_t hinfo;
             multi_heap_get_info(heap->heap, &hinfo);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+            add_cached_blocks_to_info(heap, &hinfo);
+#endif
 
             info->total_free_bytes += hinfo.total_free_bytes - MULTI_HEAP_BLOCK_OWNER_SIZE();
             info->total_allocated_bytes += (hinfo.total_allocated_bytes -
@@ -396,6 +421,9 @@ void heap_caps_print_heap_info( uint32_t caps )
     SLIST_FOREACH(heap, &registered_heaps, next) {
         if (heap_caps_match(heap, caps)) {
             multi_heap_get_info(heap->heap, &info);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+            add_cached_blocks_to_info(heap, &info);
+#endif
 
             printf("  At 0x%08x len %d free %d allocated %d min_free %d\n",
                    heap->start, heap->end - heap->start, info.total_free_bytes, info.total_allocated_bytes, info.minimum_free_bytes);
@@ -420,6 +448,11 @@ bool heap_caps_check_integrity(uint32_t caps, bool print_errors)
         if (heap->heap != NULL
             && (all_heaps || (get_all_caps(heap) & caps) == caps)) {
             valid = multi_heap_check(heap->heap, print_errors) && valid;
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+            if (heap->cache != NULL) {
+                valid = multi_heap_cache_check(heap->cache, print_errors) && valid;
+            }
+#endif
         }
     }
 
@@ -437,6 +470,11 @@ bool heap_caps_check_integrity_addr(intptr_t addr, bool print_errors)
     if (heap == NULL) {
         return false;
     }
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+    if (heap->cache != NULL && !multi_heap_cache_check(heap->cache, print_errors)) {
+        return false;
+    }
+#endif
     return multi_heap_check(heap->heap, print_errors);
 }
 
@@ -83,56 +83,51 @@ HEAP_IRAM_ATTR void heap_caps_free( void *ptr)
     heap_caps_update_per_task_info_free(heap, ptr);
 #endif
 
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+    if (heap->cache != NULL && multi_heap_cache_free(heap->cache, block_owner_ptr)) {
+        CALL_HOOK(esp_heap_trace_free_hook, ptr);
+        return;
+    }
+#endif
+
     multi_heap_free(heap->heap, block_owner_ptr);
 
     CALL_HOOK(esp_heap_trace_free_hook, ptr);
 }
 
-HEAP_IRAM_ATTR static inline void *aligned_or_unaligned_alloc(multi_heap_handle_t heap, size_t size, size_t alignment, size_t offset) {
+HEAP_IRAM_ATTR static inline void *aligned_or_unaligned_alloc(heap_t *heap, size_t size, size_t alignment, size_t offset) {
     if (alignment<=UNALIGNED_MEM_ALIGNMENT_BYTES) { //alloc and friends align to 32-bit by default
-        return multi_heap_malloc(heap, size);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+        if (heap->cache != NULL && size <= MULTI_HEAP_CACHE_MAX_SIZE) {
+            return multi_heap_cache_malloc(heap->cache, size);
+        }
+#endif
+        return multi_heap_malloc(heap->heap, size);
     } else {
-        return multi_heap_aligned_alloc_offs(heap, size, alignment, offset);
+        return multi_heap_aligned_alloc_offs(heap->heap, size, alignment, offset);
     }
 }
 
-/*
-This function should not be called directly as it does not check for failure / call heap_caps_alloc_failed()
-Note that this function does 'unaligned' alloc calls if alignment <= UNALIGNED_MEM_ALIGNMENT_BYTES (=4) as the
-allocator will align to that value by default.
-*/
-HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment, size_t size, uint32_t caps)
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+/* Return the blocks kept by the small block caches to their heaps, returns true if any was freed */
+HEAP_IRAM_ATTR static bool flush_small_block_caches(void)
 {
-    void *ret = NULL;
-
-    // Alignment, size and caps may need to be modified because of hardware requirements.
-    esp_heap_adjust_alignment_to_hw(&alignment, &size, &caps);
-
-    // remove block owner size to HEAP_SIZE_MAX rather than adding the block owner size
-    // to size to prevent overflows.
-    if (size == 0 || size > MULTI_HEAP_REMOVE_BLOCK_OWNER_SIZE(HEAP_SIZE_MAX) ) {
-        // Avoids int overflow when adding small numbers to size, or
-        // calculating 'end' from start+size, by limiting 'size' to the possible range
-        return NULL;
-    }
-
-    if (caps & MALLOC_CAP_EXEC) {
-        //MALLOC_CAP_EXEC forces an alloc from IRAM. There is a region which has both this as well as the following
-        //caps, but the following caps are not possible for IRAM.  Thus, the combination is impossible and we return
-        //NULL directly, even although our heap capabilities (based on soc_memory_tags & soc_memory_regions) would
-        //indicate there is a tag for this.
-        if ((caps & MALLOC_CAP_8BIT) || (caps & MALLOC_CAP_DMA)) {
-            return NULL;
+    bool flushed = false;
+    heap_t *heap;
+    SLIST_FOREACH(heap, &registered_heaps, next) {
+        if (heap->cache != NULL) {
+            flushed = multi_heap_cache_flush(heap->cache) || flushed;
         }
-        caps |= MALLOC_CAP_32BIT; // IRAM is 32-bit accessible RAM
     }
+    return flushed;
+}
+#endif
 
-    if (caps & MALLOC_CAP_32BIT) {
-        /* 32-bit accessible RAM should allocated in 4 byte aligned sizes
-         * (Future versions of ESP-IDF should possibly fail if an invalid size is requested)
-         */
-        size = (size + 3) & (~3); // int overflow checked above
-    }
+/* Try the registered heaps by order of priority, the arguments are already adjusted and checked
+   by heap_caps_aligned_alloc_base() */
+HEAP_IRAM_ATTR static void *aligned_alloc_from_heaps(size_t alignment, size_t size, uint32_t caps)
+{
+    void *ret = NULL;
 
     for (int prio = 0; prio < SOC_MEMORY_TYPE_NO_PRIOS; prio++) {
         //Iterate over heaps and check capabilities at this priority
@@ -154,7 +149,7 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
                         //This is special, insofar that what we're going to get back is a DRAM address. If so,
                         //we need to 'invert' it (lowest address in DRAM == highest address in IRAM and vice-versa) and
                         //add a pointer to the DRAM equivalent before the address we're going to return.
-                        ret = aligned_or_unaligned_alloc(heap->heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(size) + 4,
+                        ret = aligned_or_unaligned_alloc(heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(size) + 4,
                                                         alignment, MULTI_HEAP_BLOCK_OWNER_SIZE());  // int overflow checked above
                         if (ret != NULL) {
 #if CONFIG_HEAP_TASK_TRACKING
@@ -172,7 +167,7 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
                         }
                     } else {
                         //Just try to alloc, nothing special.
-                        ret = aligned_or_unaligned_alloc(heap->heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(size),
+                        ret = aligned_or_unaligned_alloc(heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(size),
                                                         alignment, MULTI_HEAP_BLOCK_OWNER_SIZE());
                         if (ret != NULL) {
 #if CONFIG_HEAP_TASK_TRACKING
@@ -197,6 +192,52 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
     return NULL;
 }
 
+/*
+This function should not be called directly as it does not check for failure / call heap_caps_alloc_failed()
+Note that this function does 'unaligned' alloc calls if alignment <= UNALIGNED_MEM_ALIGNMENT_BYTES (=4) as the
+allocator will align to that value by default.
+*/
+HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment, size_t size, uint32_t caps)
+{
+    // Alignment, size and caps may need to be modified because of hardware requirements.
+    esp_heap_adjust_alignment_to_hw(&alignment, &size, &caps);
+
+    // remove block owner size to HEAP_SIZE_MAX rather than adding the block owner size
+    // to size to prevent overflows.
+    if (size == 0 || size > MULTI_HEAP_REMOVE_BLOCK_OWNER_SIZE(HEAP_SIZE_MAX) ) {
+        // Avoids int overflow when adding small numbers to size, or
+        // calculating 'end' from start+size, by limiting 'size' to the possible range
+        return NULL;
+    }
+
+    if (caps & MALLOC_CAP_EXEC) {
+        //MALLOC_CAP_EXEC forces an alloc from IRAM. There is a region which has both this as well as the following
+        //caps, but the following caps are not possible for IRAM.  Thus, the combination is impossible and we return
+        //NULL directly, even although our heap capabilities (based on soc_memory_tags & soc_memory_regions) would
+        //indicate there is a tag for this.
+        if ((caps & MALLOC_CAP_8BIT) || (caps & MALLOC_CAP_DMA)) {
+            return NULL;
+        }
+        caps |= MALLOC_CAP_32BIT; // IRAM is 32-bit accessible RAM
+    }
+
+    if (caps & MALLOC_CAP_32BIT) {
+        /* 32-bit accessible RAM should allocated in 4 byte aligned sizes
+         * (Future versions of ESP-IDF should possibly fail if an invalid size is requested)
+         */
+        size = (size + 3) & (~3); // int overflow checked above
+    }
+
+    void *ret = aligned_alloc_from_heaps(alignment, size, caps);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+    if (ret == NULL && flush_small_block_caches()) {
+        //Cached small blocks may keep free blocks from merging, try again once they are back in their heaps
+        ret = aligned_alloc_from_heaps(alignment, size, caps);
+    }
+#endif
+    return ret;
+}
+
 //Wrapper for heap_caps_aligned_alloc_base as that can also do unaligned allocs.
 HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_malloc_base( size_t size, uint32_t caps) {
     return heap_caps_aligned_alloc_base(UNALIGNED_MEM_ALIGNMENT_BYTES, size, caps);
@@ -75,6 +75,16 @@ static void register_heap(heap_t *region)
     }
 }
 
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+/* Put a small block cache in front of the heaps serving default (internal, byte accessible) allocations */
+static void init_small_block_cache(heap_t *heap)
+{
+    if (heap_caps_match(heap, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL)) {
+        heap->cache = multi_heap_cache_create(heap->heap);
+    }
+}
+#endif
+
 void heap_caps_enable_nonos_stack_heaps(void)
 {
     heap_t *heap;
@@ -85,6 +95,9 @@ void heap_caps_enable_nonos_stack_heaps(void)
             register_heap(heap);
             if (heap->heap != NULL) {
                 multi_heap_set_lock(heap->heap, &heap->heap_mux);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+                init_small_block_cache(heap);
+#endif
             }
         }
     }
@@ -153,6 +166,9 @@ void heap_caps_init(void)
         heap->start = region->start;
         heap->end = region->start + region->size;
         MULTI_HEAP_LOCK_INIT(&heap->heap_mux);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+        heap->cache = NULL;
+#endif
         if (region->startup_stack) {
             /* Will be registered when OS scheduler starts */
             heap->heap = NULL;
@@ -207,6 +223,12 @@ void heap_caps_init(void)
         sorted_add_to_registered_heaps(&heaps_array[i]);
     }
 
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+    for (size_t i = 0; i < num_heaps; i++) {
+        init_small_block_cache(&heaps_array[i]);
+    }
+#endif
+
 #if CONFIG_HEAP_TASK_TRACKING
     heap_caps_update_per_task_info_alloc(used_heap,
                                          MULTI_HEAP_REMOVE_BLOCK_OWNER_OFFSET(heaps_array),
@@ -307,6 +329,9 @@ esp_err_t heap_caps_add_region_with_caps(const uint32_t caps[], intptr_t start,
     p_new->end = end;
     MULTI_HEAP_LOCK_INIT(&p_new->heap_mux);
     p_new->heap = multi_heap_register((void *)start, end - start);
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+    p_new->cache = NULL;
+#endif
     SLIST_NEXT(p_new, next) = NULL;
     if (p_new->heap == NULL) {
         err = ESP_ERR_INVALID_SIZE;
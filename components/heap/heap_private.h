@@ -12,6 +12,9 @@
 #include "multi_heap_platform.h"
 #include "sys/queue.h"
 #include "esp_attr.h"
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+#include "multi_heap_cache.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +36,9 @@ typedef struct heap_t_ {
     intptr_t end;
     multi_heap_lock_t heap_mux;
     multi_heap_handle_t heap;
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+    multi_heap_cache_handle_t cache; ///< Small block cache in front of 'heap', NULL if the heap is not cached
+#endif
     SLIST_ENTRY(heap_t_) next;
 } heap_t;
 
@@ -155,6 +155,253 @@ static HEAP_IRAM_ATTR heap_trace_record_t* map_find_and_remove(void *p)
 }
 #endif // CONFIG_HEAP_TRACE_HASH_MAP
 
+#if CONFIG_HEAP_TRACE_CALLSITES
+
+// In HEAP_TRACE_CALLSITES mode, allocations are aggregated per call stack.
+// Call sites are appended to the user buffer and located through an open addressing
+// index keyed by a hash of the call stack. Live allocations are kept in a second open
+// addressing table keyed by address, so that a free can be accounted to its call site.
+// Both tables are at most half full, keeping the number of probes low.
+
+typedef struct {
+    void *address;   // NULL if the slot is empty
+    uint32_t size;
+    uint32_t site;   // index of the call site in callsites.buffer
+} callsite_alloc_t;
+
+typedef struct {
+    heap_trace_callsite_t *buffer; // call sites, in order of appearance
+    size_t capacity;               // capacity of 'buffer'
+    size_t count;                  // number of call sites in 'buffer'
+    uint16_t *index;               // call site index + 1, 0 if the slot is empty
+    size_t index_mask;
+    callsite_alloc_t *live;        // live allocations
+    uint32_t live_shift;           // 32 - log2(number of slots in 'live')
+    size_t live_capacity;          // maximum number of entries in 'live'
+    size_t live_count;
+    size_t live_high_water_mark;
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    size_t untracked_allocs;       // allocations not in 'live' because it was full
+    size_t untracked_frees;        // frees of addresses not in 'live'
+    size_t dropped_allocs;         // allocations lost because 'buffer' was full
+} callsites_t;
+
+static callsites_t callsites;
+
+static HEAP_IRAM_ATTR uint32_t callsite_hash(void * const *callers)
+{
+    uint32_t hash = 2166136261UL;
+    for (int i = 0; i < STACK_DEPTH; i++) {
+        hash ^= (uint32_t)callers[i];
+        hash *= 16777619UL;
+    }
+    return hash ^ (hash >> 16);
+}
+
+static HEAP_IRAM_ATTR size_t live_slot(void *p)
+{
+    // Fibonacci hashing: the upper bits of the product are the well mixed ones
+    const uint32_t hash = (uint32_t)p * 2654435761U;
+    return hash >> callsites.live_shift;
+}
+
+static HEAP_IRAM_ATTR size_t histogram_bucket(size_t size)
+{
+    size_t bucket = 0;
+    while ((size >>= 1) != 0 && bucket < HEAP_TRACE_CALLSITE_HIST_BUCKETS - 1) {
+        bucket++;
+    }
+    return bucket;
+}
+
+static HEAP_IRAM_ATTR heap_trace_callsite_t *callsite_find_or_add(void * const *callers, uint32_t *site_idx)
+{
+    size_t slot = callsite_hash(callers) & callsites.index_mask;
+    while (callsites.index[slot] != 0) {
+        heap_trace_callsite_t *site = &callsites.buffer[callsites.index[slot] - 1];
+        if (memcmp(site->callers, callers, sizeof(void *) * STACK_DEPTH) == 0) {
+            *site_idx = callsites.index[slot] - 1;
+            return site;
+        }
+        slot = (slot + 1) & callsites.index_mask;
+    }
+    if (callsites.count == callsites.capacity) {
+        return NULL;
+    }
+    *site_idx = callsites.count;
+    heap_trace_callsite_t *site = &callsites.buffer[callsites.count++];
+    memcpy(site->callers, callers, sizeof(void *) * STACK_DEPTH);
+    callsites.index[slot] = callsites.count;
+    return site;
+}
+
+static HEAP_IRAM_ATTR void callsite_account_free(const callsite_alloc_t *a)
+{
+    heap_trace_callsite_t *site = &callsites.buffer[a->site];
+    site->frees++;
+    site->live_bytes -= a->size;
+    callsites.live_bytes -= a->size;
+    callsites.live_count--;
+}
+
+// Remove the live allocation in slot 'i', moving back the following entries
+// of the probe sequence so that no tombstone is needed.
+static HEAP_IRAM_ATTR void live_remove_at(size_t i)
+{
+    const size_t mask = (1UL << (32 - callsites.live_shift)) - 1;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (callsites.live[j].address == NULL) {
+            break;
+        }
+        size_t k = live_slot(callsites.live[j].address);
+        // entry 'j' can move to 'i' unless its home slot 'k' lies cyclically in ]i, j]
+        bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+        if (!stays) {
+            callsites.live[i] = callsites.live[j];
+            i = j;
+        }
+    }
+    callsites.live[i].address = NULL;
+}
+
+static HEAP_IRAM_ATTR bool live_add(void *p, uint32_t size, uint32_t site_idx)
+{
+    const size_t mask = (1UL << (32 - callsites.live_shift)) - 1;
+    size_t slot = live_slot(p);
+    while (callsites.live[slot].address != NULL) {
+        if (callsites.live[slot].address == p) {
+            // The free of the previous allocation at this address was missed while
+            // tracing was stopped, account it now.
+            callsite_account_free(&callsites.live[slot]);
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    if (callsites.live[slot].address == NULL && callsites.live_count == callsites.live_capacity) {
+        return false;
+    }
+    callsites.live[slot].address = p;
+    callsites.live[slot].size = size;
+    callsites.live[slot].site = site_idx;
+    callsites.live_count++;
+    if (callsites.live_count > callsites.live_high_water_mark) {
+        callsites.live_high_water_mark = callsites.live_count;
+    }
+    return true;
+}
+
+static HEAP_IRAM_ATTR void callsite_record_allocation(const heap_trace_record_t *r_allocation)
+{
+    uint32_t site_idx;
+    heap_trace_callsite_t *site = callsite_find_or_add(r_allocation->alloced_by, &site_idx);
+    if (site == NULL) {
+        callsites.dropped_allocs++;
+        return;
+    }
+
+    const uint32_t size = r_allocation->size;
+    site->allocs++;
+    site->total_bytes += size;
+    site->size_histogram[histogram_bucket(size)]++;
+
+    if (!live_add(r_allocation->address, size, site_idx)) {
+        callsites.untracked_allocs++;
+        return;
+    }
+    site->live_bytes += size;
+    if (site->live_bytes > site->peak_live_bytes) {
+        site->peak_live_bytes = site->live_bytes;
+    }
+    callsites.live_bytes += size;
+    if (callsites.live_bytes > callsites.peak_live_bytes) {
+        callsites.peak_live_bytes = callsites.live_bytes;
+    }
+}
+
+static HEAP_IRAM_ATTR void callsite_record_free(void *p)
+{
+    const size_t mask = (1UL << (32 - callsites.live_shift)) - 1;
+    size_t slot = live_slot(p);
+    while (callsites.live[slot].address != NULL) {
+        if (callsites.live[slot].address == p) {
+            callsite_account_free(&callsites.live[slot]);
+            live_remove_at(slot);
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    callsites.untracked_frees++;
+}
+
+static void callsites_reset(void)
+{
+    memset(callsites.buffer, 0, sizeof(heap_trace_callsite_t) * callsites.capacity);
+    memset(callsites.index, 0, sizeof(uint16_t) * (callsites.index_mask + 1));
+    memset(callsites.live, 0, sizeof(callsite_alloc_t) << (32 - callsites.live_shift));
+    callsites.count = 0;
+    callsites.live_count = 0;
+    callsites.live_high_water_mark = 0;
+    callsites.live_bytes = 0;
+    callsites.peak_live_bytes = 0;
+    callsites.untracked_allocs = 0;
+    callsites.untracked_frees = 0;
+    callsites.dropped_allocs = 0;
+}
+
+static void callsites_dump(void)
+{
+    esp_rom_printf("====== Heap Trace: %"PRIu32" call sites (%"PRIu32" capacity) ======\n",
+        callsites.count, callsites.capacity);
+
+    for (size_t i = 0; i < callsites.count; i++) {
+        const heap_trace_callsite_t *site = &callsites.buffer[i];
+
+        esp_rom_printf("%6"PRIu32" bytes alive (peak %"PRIu32") %"PRIu32" allocs %"PRIu32" frees",
+            site->live_bytes, site->peak_live_bytes, site->allocs, site->frees);
+
+        if (STACK_DEPTH != 0 && site->callers[0] != NULL) {
+            esp_rom_printf(" caller ");
+            for (int j = 0; j < STACK_DEPTH && site->callers[j] != 0; j++) {
+                esp_rom_printf("%p%s", site->callers[j],
+                       (j < STACK_DEPTH - 1) ? ":" : "");
+            }
+        }
+
+        esp_rom_printf("\n    sizes");
+        for (int j = 0; j < HEAP_TRACE_CALLSITE_HIST_BUCKETS; j++) {
+            if (site->size_histogram[j] != 0) {
+                esp_rom_printf(" %"PRIu32"+:%"PRIu32, (j == 0) ? 0 : (uint32_t)(1UL << j), site->size_histogram[j]);
+            }
+        }
+        esp_rom_printf("\n");
+    }
+
+    esp_rom_printf("====== Heap Trace Summary ======\n");
+    esp_rom_printf("Mode: Heap Trace Call Sites\n");
+    esp_rom_printf("%"PRIu32" bytes alive in trace (peak %"PRIu32" bytes, %"PRIu32" allocations)\n",
+        callsites.live_bytes, callsites.peak_live_bytes, callsites.live_count);
+    esp_rom_printf("call sites: %"PRIu32" (%"PRIu32" capacity)\n", callsites.count, callsites.capacity);
+    esp_rom_printf("live allocations: %"PRIu32" capacity, %"PRIu32" high water mark\n",
+        callsites.live_capacity, callsites.live_high_water_mark);
+    esp_rom_printf("total allocations: %"PRIu32"\n", total_allocations);
+    esp_rom_printf("total frees: %"PRIu32" (%"PRIu32" of memory allocated before tracing)\n",
+        total_frees, callsites.untracked_frees);
+
+    if (callsites.dropped_allocs != 0) {
+        esp_rom_printf("(NB: Call site buffer is full, %"PRIu32" allocations are missing from the trace.)\n",
+            callsites.dropped_allocs);
+    }
+    if (callsites.untracked_allocs != 0) {
+        esp_rom_printf("(NB: Live allocation table is full, %"PRIu32" allocations are missing from the alive bytes.)\n",
+            callsites.untracked_allocs);
+    }
+    esp_rom_printf("================================\n");
+}
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+
 esp_err_t heap_trace_init_standalone(heap_trace_record_t *record_buffer, size_t num_records)
 {
     if ((tracing == TRACING_STARTED) || (tracing == TRACING_ALLOC_PAUSED)) {
@@ -184,6 +431,57 @@ esp_err_t heap_trace_init_standalone(heap_trace_record_t *record_buffer, size_t
     return ESP_OK;
 }
 
+esp_err_t heap_trace_init_callsites(heap_trace_callsite_t *sites, size_t num_sites, size_t max_live_allocs)
+{
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if ((tracing == TRACING_STARTED) || (tracing == TRACING_ALLOC_PAUSED)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (sites == NULL || num_sites == 0 || num_sites > UINT16_MAX || max_live_allocs == 0 || max_live_allocs > (1UL << 30)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // size both tables to twice the number of entries they hold, rounded up to a power of two
+    size_t index_size = 1;
+    while (index_size < 2 * num_sites) {
+        index_size <<= 1;
+    }
+    uint32_t live_bits = 1;
+    while ((1UL << live_bits) < 2 * max_live_allocs) {
+        live_bits++;
+    }
+
+    uint16_t *index = heap_caps_calloc(index_size, sizeof(uint16_t), MALLOC_CAP_INTERNAL);
+    callsite_alloc_t *live = heap_caps_calloc(1UL << live_bits, sizeof(callsite_alloc_t), MALLOC_CAP_INTERNAL);
+    if (index == NULL || live == NULL) {
+        heap_caps_free(index);
+        heap_caps_free(live);
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "call sites: allocated %" PRIu32 " bytes (Internal RAM)",
+             (uint32_t)(index_size * sizeof(uint16_t) + (sizeof(callsite_alloc_t) << live_bits)));
+
+    heap_caps_free(callsites.index);
+    heap_caps_free(callsites.live);
+
+    callsites.buffer = sites;
+    callsites.capacity = num_sites;
+    callsites.index = index;
+    callsites.index_mask = index_size - 1;
+    callsites.live = live;
+    callsites.live_shift = 32 - live_bits;
+    callsites.live_capacity = max_live_allocs;
+    callsites_reset();
+    return ESP_OK;
+#else
+    (void)sites;
+    (void)num_sites;
+    (void)max_live_allocs;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+}
+
 static esp_err_t set_tracing(tracing_state_t state)
 {
     if (tracing == state) {
@@ -195,7 +493,15 @@ static esp_err_t set_tracing(tracing_state_t state)
 
 esp_err_t heap_trace_start(heap_trace_mode_t mode_param)
 {
-    if (records.buffer == NULL || records.capacity == 0) {
+    if (mode_param == HEAP_TRACE_CALLSITES) {
+#if CONFIG_HEAP_TRACE_CALLSITES
+        if (callsites.buffer == NULL) {
+            return ESP_ERR_INVALID_STATE;
+        }
+#else
+        return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+    } else if (records.buffer == NULL || records.capacity == 0) {
         return ESP_ERR_INVALID_STATE;
     }
 
@@ -204,6 +510,19 @@ esp_err_t heap_trace_start(heap_trace_mode_t mode_param)
     set_tracing(TRACING_STOPPED);
     mode = mode_param;
 
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if (mode == HEAP_TRACE_CALLSITES) {
+        callsites_reset();
+        total_allocations = 0;
+        total_frees = 0;
+
+        const esp_err_t ret_val = set_tracing(TRACING_STARTED);
+
+        portEXIT_CRITICAL(&trace_mux);
+        return ret_val;
+    }
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+
     // clear buffers
     memset(records.buffer, 0, sizeof(heap_trace_record_t) * records.capacity);
 
@@ -255,6 +574,11 @@ esp_err_t heap_trace_resume(void)
 
 size_t heap_trace_get_count(void)
 {
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if (mode == HEAP_TRACE_CALLSITES) {
+        return callsites.count;
+    }
+#endif // CONFIG_HEAP_TRACE_CALLSITES
     return records.count;
 }
 
@@ -307,6 +631,91 @@ esp_err_t heap_trace_get(size_t index, heap_trace_record_t *r_out)
     return result;
 }
 
+esp_err_t heap_trace_get_callsite(size_t index, heap_trace_callsite_t *site)
+{
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if (site == NULL || callsites.buffer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t result = ESP_OK;
+
+    portENTER_CRITICAL(&trace_mux);
+    if (index >= callsites.count) {
+        result = ESP_ERR_INVALID_ARG;
+    } else {
+        memcpy(site, &callsites.buffer[index], sizeof(heap_trace_callsite_t));
+    }
+    portEXIT_CRITICAL(&trace_mux);
+    return result;
+#else
+    (void)index;
+    (void)site;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+}
+
+esp_err_t heap_trace_dump_callsites_binary(heap_trace_write_cb_t write_cb, void *arg)
+{
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if (write_cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (callsites.buffer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    heap_trace_callsites_dump_header_t header = {
+        .magic = HEAP_TRACE_CALLSITES_DUMP_MAGIC,
+        .version = HEAP_TRACE_CALLSITES_DUMP_VERSION,
+        .stack_depth = STACK_DEPTH,
+        .hist_buckets = HEAP_TRACE_CALLSITE_HIST_BUCKETS,
+    };
+
+    portENTER_CRITICAL(&trace_mux);
+    const size_t num_sites = callsites.count;
+    header.num_sites = num_sites;
+    header.total_allocations = total_allocations;
+    header.total_frees = total_frees;
+    header.untracked_allocations = callsites.untracked_allocs;
+    header.untracked_frees = callsites.untracked_frees;
+    header.dropped_allocations = callsites.dropped_allocs;
+    header.live_bytes = callsites.live_bytes;
+    header.peak_live_bytes = callsites.peak_live_bytes;
+    portEXIT_CRITICAL(&trace_mux);
+
+    write_cb(&header, sizeof(header), arg);
+
+    // Call sites are only ever appended, so the first 'num_sites' entries stay valid.
+    // Each one is copied under the lock, the callback is called outside of it.
+    uint32_t words[STACK_DEPTH + 6 + HEAP_TRACE_CALLSITE_HIST_BUCKETS];
+    for (size_t i = 0; i < num_sites; i++) {
+        uint32_t *w = words;
+
+        portENTER_CRITICAL(&trace_mux);
+        const heap_trace_callsite_t *site = &callsites.buffer[i];
+        for (int j = 0; j < STACK_DEPTH; j++) {
+            *w++ = (uint32_t)site->callers[j];
+        }
+        *w++ = site->allocs;
+        *w++ = site->frees;
+        *w++ = site->live_bytes;
+        *w++ = site->peak_live_bytes;
+        *w++ = (uint32_t)site->total_bytes;
+        *w++ = (uint32_t)(site->total_bytes >> 32);
+        memcpy(w, site->size_histogram, sizeof(site->size_histogram));
+        portEXIT_CRITICAL(&trace_mux);
+
+        write_cb(words, sizeof(words), arg);
+    }
+    return ESP_OK;
+#else
+    (void)write_cb;
+    (void)arg;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+}
+
 esp_err_t heap_trace_summary(heap_trace_summary_t *summary)
 {
     if (summary == NULL) {
@@ -325,6 +734,17 @@ esp_err_t heap_trace_summary(heap_trace_summary_t *summary)
     summary->total_hashmap_hits = total_hashmap_hits;
     summary->total_hashmap_miss = total_hashmap_miss;
 #endif // CONFIG_HEAP_TRACE_HASH_MAP
+#if CONFIG_HEAP_TRACE_CALLSITES
+    summary->live_bytes = callsites.live_bytes;
+    summary->peak_live_bytes = callsites.peak_live_bytes;
+    summary->untracked_frees = callsites.untracked_frees;
+    if (mode == HEAP_TRACE_CALLSITES) {
+        summary->count = callsites.count;
+        summary->capacity = callsites.capacity;
+        summary->high_water_mark = callsites.live_high_water_mark;
+        summary->has_overflowed = (callsites.dropped_allocs != 0) || (callsites.untracked_allocs != 0);
+    }
+#endif // CONFIG_HEAP_TRACE_CALLSITES
     portEXIT_CRITICAL(&trace_mux);
 
     return ESP_OK;
@@ -342,6 +762,15 @@ static void heap_trace_dump_base(bool internal_ram, bool psram)
 {
     portENTER_CRITICAL(&trace_mux);
 
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if (mode == HEAP_TRACE_CALLSITES) {
+        // call sites are not split by memory type
+        callsites_dump();
+        portEXIT_CRITICAL(&trace_mux);
+        return;
+    }
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+
     size_t delta_size = 0;
     size_t delta_allocs = 0;
     size_t start_count = records.count;
@@ -448,6 +877,15 @@ static HEAP_IRAM_ATTR void record_allocation(const heap_trace_record_t *r_alloca
     }
     portENTER_CRITICAL(&trace_mux);
 
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if (tracing == TRACING_STARTED && mode == HEAP_TRACE_CALLSITES) {
+        callsite_record_allocation(r_allocation);
+        total_allocations++;
+        portEXIT_CRITICAL(&trace_mux);
+        return;
+    }
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+
     if (tracing == TRACING_STARTED) {
         // If buffer is full, pop off the oldest
         // record to make more space
@@ -487,6 +925,18 @@ static HEAP_IRAM_ATTR void record_free(void *p, void **callers)
     }
 
     portENTER_CRITICAL(&trace_mux);
+
+#if CONFIG_HEAP_TRACE_CALLSITES
+    if (mode == HEAP_TRACE_CALLSITES) {
+        if (tracing != TRACING_STOPPED) {
+            total_frees++;
+            callsite_record_free(p);
+        }
+        portEXIT_CRITICAL(&trace_mux);
+        return;
+    }
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+
     // return directly if records.count == 0. In case of hashmap being used
     // this prevents the hashmap to return an item that is no longer in the
     // records list.
@@ -22,8 +22,17 @@ extern "C" {
 typedef enum {
     HEAP_TRACE_ALL,
     HEAP_TRACE_LEAKS,
+    HEAP_TRACE_CALLSITES,
 } heap_trace_mode_t;
 
+/**
+ * @brief Number of buckets of the allocation size histogram of a call site.
+ *
+ * Bucket N counts the allocations of 2^N to 2^(N+1)-1 bytes. Bucket 0 also counts
+ * zero sized allocations and the last bucket counts all allocations of 2^15 bytes or more.
+ */
+#define HEAP_TRACE_CALLSITE_HIST_BUCKETS 16
+
 /**
  * @brief Trace record data type. Stores information about an allocated region of memory.
  */
@@ -42,8 +51,64 @@ typedef struct heap_trace_record_t {
 #endif // CONFIG_HEAP_TRACING_STANDALONE
 } heap_trace_record_t;
 
+/**
+ * @brief Call site data type. Stores the allocation statistics of one call stack in HEAP_TRACE_CALLSITES mode.
+ */
+typedef struct {
+    uint64_t total_bytes;     ///< Total number of bytes allocated from this call stack
+    uint32_t allocs;          ///< Number of allocations made from this call stack
+    uint32_t frees;           ///< Number of these allocations which have been freed
+    uint32_t live_bytes;      ///< Number of bytes allocated from this call stack and not freed yet
+    uint32_t peak_live_bytes; ///< The maximum value that 'live_bytes' got to
+    uint32_t size_histogram[HEAP_TRACE_CALLSITE_HIST_BUCKETS]; ///< Number of allocations per size class, see HEAP_TRACE_CALLSITE_HIST_BUCKETS
+    void *callers[CONFIG_HEAP_TRACING_STACK_DEPTH]; ///< Call stack of the callers which made the allocations.
+} heap_trace_callsite_t;
+
+/**
+ * @brief Magic number of the binary call site dump ("HTCS" in little endian)
+ */
+#define HEAP_TRACE_CALLSITES_DUMP_MAGIC     0x53435448
+#define HEAP_TRACE_CALLSITES_DUMP_VERSION   1
+
+/**
+ * @brief Header of the binary call site dump written by heap_trace_dump_callsites_binary().
+ *
+ * All fields are little endian. The header is followed by 'num_sites' records of
+ * (stack_depth + 22) 32-bit words each:
+ * - stack_depth words: the call stack (PC addresses, which can be symbolized with the application ELF file)
+ * - allocs, frees, live_bytes, peak_live_bytes
+ * - total_bytes (low word first)
+ * - hist_buckets words: the allocation size histogram
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                 ///< HEAP_TRACE_CALLSITES_DUMP_MAGIC
+    uint16_t version;               ///< HEAP_TRACE_CALLSITES_DUMP_VERSION
+    uint8_t stack_depth;            ///< Number of PC addresses per call stack
+    uint8_t hist_buckets;           ///< Number of histogram buckets per record
+    uint32_t num_sites;             ///< Number of call site records following the header
+    uint32_t total_allocations;     ///< The total number of allocations made during tracing
+    uint32_t total_frees;           ///< The total number of frees made during tracing
+    uint32_t untracked_allocations; ///< Allocations whose free could not be attributed (live allocation table was full)
+    uint32_t untracked_frees;       ///< Frees of memory not allocated while tracing
+    uint32_t dropped_allocations;   ///< Allocations not accounted to any call site (call site table was full)
+    uint32_t live_bytes;            ///< Number of bytes allocated and not freed yet
+    uint32_t peak_live_bytes;       ///< The maximum value that 'live_bytes' got to
+} heap_trace_callsites_dump_header_t;
+
+/**
+ * @brief Callback receiving the binary call site dump
+ *
+ * @param data Chunk of the dump
+ * @param len Length of the chunk in bytes
+ * @param arg User argument passed to heap_trace_dump_callsites_binary()
+ */
+typedef void (*heap_trace_write_cb_t)(const void *data, size_t len, void *arg);
+
 /**
  * @brief Stores information about the result of a heap trace.
+ *
+ * In HEAP_TRACE_CALLSITES mode, 'count' and 'capacity' refer to the call site table and
+ * 'high_water_mark' to the number of live allocations tracked.
  */
 typedef struct {
     heap_trace_mode_t mode;          ///< The heap trace mode we just completed / are running
@@ -57,6 +122,11 @@ typedef struct {
     size_t total_hashmap_hits;       ///< If hashmap is used, the total number of hits
     size_t total_hashmap_miss;       ///< If hashmap is used, the total number of misses (possibly due to overflow)
 #endif
+#if CONFIG_HEAP_TRACE_CALLSITES
+    size_t live_bytes;               ///< In HEAP_TRACE_CALLSITES mode, the number of bytes allocated and not freed yet
+    size_t peak_live_bytes;          ///< In HEAP_TRACE_CALLSITES mode, the maximum value that 'live_bytes' got to
+    size_t untracked_frees;          ///< In HEAP_TRACE_CALLSITES mode, the number of frees of memory not allocated while tracing
+#endif
 } heap_trace_summary_t;
 
 /**
@@ -76,6 +146,30 @@ typedef struct {
  */
 esp_err_t heap_trace_init_standalone(heap_trace_record_t *record_buffer, size_t num_records);
 
+/**
+ * @brief Initialise the call site table used by the HEAP_TRACE_CALLSITES mode.
+ *
+ * This function must be called before heap_trace_start(HEAP_TRACE_CALLSITES). It can be used
+ * together with heap_trace_init_standalone(), the mode passed to heap_trace_start() selects which
+ * buffer is filled.
+ *
+ * Besides the call site buffer, a table able to hold 'max_live_allocs' allocations is allocated
+ * from internal memory to find the call site of an allocation when it is freed. Allocations made while
+ * this table is full are accounted to their call site, but not to its live bytes.
+ *
+ * @param sites Provide a buffer for the call site data. Each distinct call stack uses one entry.
+ * Note: External RAM is allowed, but it prevents recording allocations made from ISR's.
+ * @param num_sites Size of the call site buffer, as number of entries (at most 65535).
+ * @param max_live_allocs Maximum number of allocations which are tracked until freed.
+ * @return
+ *  - ESP_ERR_NOT_SUPPORTED Project was compiled without CONFIG_HEAP_TRACE_CALLSITES enabled in menuconfig.
+ *  - ESP_ERR_INVALID_STATE Heap tracing is currently in progress.
+ *  - ESP_ERR_INVALID_ARG Invalid buffer or size.
+ *  - ESP_ERR_NO_MEM Could not allocate the tracking tables.
+ *  - ESP_OK Call site tracing initialised successfully.
+ */
+esp_err_t heap_trace_init_callsites(heap_trace_callsite_t *sites, size_t num_sites, size_t max_live_allocs);
+
 /**
  * @brief Initialise heap tracing in host-based mode.
  *
@@ -97,9 +191,10 @@ esp_err_t heap_trace_init_tohost(void);
  * @param mode Mode for tracing.
  * - HEAP_TRACE_ALL means all heap allocations and frees are traced.
  * - HEAP_TRACE_LEAKS means only suspected memory leaks are traced. (When memory is freed, the record is removed from the trace buffer.)
+ * - HEAP_TRACE_CALLSITES means allocations & frees are aggregated per call stack, in the buffer set via heap_trace_init_callsites().
  * @return
  * - ESP_ERR_NOT_SUPPORTED Project was compiled without heap tracing enabled in menuconfig.
- * - ESP_ERR_INVALID_STATE A non-zero-length buffer has not been set via heap_trace_init_standalone().
+ * - ESP_ERR_INVALID_STATE A non-zero-length buffer has not been set via heap_trace_init_standalone() (or heap_trace_init_callsites()).
  * - ESP_OK Tracing is started.
  */
 esp_err_t heap_trace_start(heap_trace_mode_t mode);
@@ -148,6 +243,8 @@ esp_err_t heap_trace_resume(void);
 /**
  * @brief Return number of records in the heap trace buffer
  *
+ * In HEAP_TRACE_CALLSITES mode, return the number of call sites recorded.
+ *
  * It is safe to call this function while heap tracing is running.
  */
 size_t heap_trace_get_count(void);
@@ -169,15 +266,54 @@ size_t heap_trace_get_count(void);
  */
 esp_err_t heap_trace_get(size_t index, heap_trace_record_t *record);
 
+/**
+ * @brief Return a call site from the call site buffer
+ *
+ * Call sites are stored in the order their first allocation was traced.
+ *
+ * @note It is safe to call this function while heap tracing is running.
+ *
+ * @param index Index (zero-based) of the call site to return.
+ * @param[out] site Call site where the data will be copied.
+ * @return
+ * - ESP_ERR_NOT_SUPPORTED Project was compiled without CONFIG_HEAP_TRACE_CALLSITES enabled in menuconfig.
+ * - ESP_ERR_INVALID_STATE Call site tracing was not initialised or 'site' is NULL.
+ * - ESP_ERR_INVALID_ARG Index is out of bounds for current call site count.
+ * - ESP_OK Call site returned successfully.
+ */
+esp_err_t heap_trace_get_callsite(size_t index, heap_trace_callsite_t *site);
+
 /**
  * @brief Dump heap trace record data to stdout
  *
+ * In HEAP_TRACE_CALLSITES mode, the call sites are dumped.
+ *
  * @note It is safe to call this function while heap tracing is
  * running, however in HEAP_TRACE_LEAK mode the dump may skip
  * entries unless heap tracing is stopped first.
  */
 void heap_trace_dump(void);
 
+/**
+ * @brief Write the call site data in a compact binary format
+ *
+ * The format is described by heap_trace_callsites_dump_header_t. It is meant to be
+ * transferred to the host (e.g. over UART or stored to a file), where the call stacks
+ * can be symbolized using the application ELF file.
+ *
+ * @note The callback is called outside of any critical section. If tracing is running,
+ * allocations made by the callback are traced, so it is recommended to stop tracing first.
+ *
+ * @param write_cb Callback receiving the dump, chunk by chunk
+ * @param arg User argument passed to write_cb
+ * @return
+ * - ESP_ERR_NOT_SUPPORTED Project was compiled without CONFIG_HEAP_TRACE_CALLSITES enabled in menuconfig.
+ * - ESP_ERR_INVALID_ARG write_cb is NULL.
+ * - ESP_ERR_INVALID_STATE Call site tracing was not initialised.
+ * - ESP_OK Dump written.
+ */
+esp_err_t heap_trace_dump_callsites_binary(heap_trace_write_cb_t write_cb, void *arg);
+
 /**
  * @brief Dump heap trace from the memory of the capabilities passed as parameter.
  *
@@ -37,6 +37,20 @@ size_t multi_heap_get_full_block_size(multi_heap_handle_t heap, void *p)
     return multi_heap_get_allocated_size_impl(heap, p);
 }
 
+size_t multi_heap_internal_cache_put(multi_heap_handle_t heap, void *p)
+{
+    return multi_heap_get_allocated_size_impl(heap, p);
+}
+
+void multi_heap_internal_cache_get(multi_heap_handle_t heap, void *p, size_t size, bool from_cache)
+{
+}
+
+bool multi_heap_internal_cache_check(void *p, bool print_errors)
+{
+    return true;
+}
+
 #if(!defined CONFIG_HEAP_TLSF_USE_ROM_IMPL)
 /* if no heap poisoning, public API aliases directly to these implementations */
 void *multi_heap_malloc(multi_heap_handle_t heap, size_t size)
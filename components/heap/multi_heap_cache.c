@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stddef.h>
+#include "multi_heap.h"
+#include "multi_heap_internal.h"
+#include "multi_heap_cache.h"
+
+#include "tlsf.h"
+
+/* Note: Keep platform-specific parts in this header, this source
+   file should depend on libc only */
+#include "multi_heap_platform.h"
+
+/* Defines compile-time configuration macros */
+#include "multi_heap_config.h"
+
+#define NUM_CLASSES 6
+
+/* Allocations are rounded up to the size of their class. When a block is freed, it goes to
+   the largest class it can hold, blocks wasting MAX_SLACK bytes or more are not cached. */
+static const uint16_t s_class_size[NUM_CLASSES] = { 16, 32, 48, 64, 96, 128 };
+#define MAX_SLACK 32
+
+/* Class of an allocation, indexed by (size - 1) / 16 */
+static const uint8_t s_alloc_class[MULTI_HEAP_CACHE_MAX_SIZE / 16] = { 0, 1, 2, 3, 4, 4, 5, 5 };
+
+/* Class of a freed block, indexed by usable size / 16 */
+static const uint8_t s_free_class[MULTI_HEAP_CACHE_MAX_SIZE / 16] = { 0, 0, 1, 2, 3, 3, 4, 4 };
+
+typedef struct {
+    uint32_t count;
+    void *blocks[MULTI_HEAP_CACHE_DEPTH];
+} magazine_t;
+
+typedef struct {
+    multi_heap_lock_t lock;
+    magazine_t magazines[NUM_CLASSES];
+} cache_slot_t;
+
+struct multi_heap_cache {
+    multi_heap_handle_t heap;
+    cache_slot_t slots[MULTI_HEAP_CACHE_NUM_SLOTS];
+};
+
+multi_heap_cache_handle_t multi_heap_cache_create(multi_heap_handle_t heap)
+{
+    multi_heap_cache_handle_t cache = multi_heap_malloc(heap, sizeof(struct multi_heap_cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    memset(cache, 0, sizeof(struct multi_heap_cache));
+    cache->heap = heap;
+    for (int i = 0; i < MULTI_HEAP_CACHE_NUM_SLOTS; i++) {
+        MULTI_HEAP_LOCK_INIT(&cache->slots[i].lock);
+    }
+    return cache;
+}
+
+void *multi_heap_cache_malloc(multi_heap_cache_handle_t cache, size_t size)
+{
+    if (size == 0) {
+        return NULL;
+    }
+    const int cls = s_alloc_class[(size - 1) / 16];
+    cache_slot_t *slot = &cache->slots[MULTI_HEAP_CACHE_SLOT()];
+    magazine_t *mag = &slot->magazines[cls];
+    void *p = NULL;
+
+    MULTI_HEAP_LOCK(&slot->lock);
+    if (mag->count > 0) {
+        p = mag->blocks[--mag->count];
+    }
+    MULTI_HEAP_UNLOCK(&slot->lock);
+
+    if (p != NULL) {
+        multi_heap_internal_cache_get(cache->heap, p, size, true);
+        return p;
+    }
+
+    /* Allocate the whole class, so that the block can serve any allocation of the class once freed */
+    p = multi_heap_malloc(cache->heap, s_class_size[cls]);
+    if (p == NULL && multi_heap_cache_flush(cache)) {
+        p = multi_heap_malloc(cache->heap, s_class_size[cls]);
+    }
+    if (p != NULL) {
+        multi_heap_internal_cache_get(cache->heap, p, size, false);
+    }
+    return p;
+}
+
+bool multi_heap_cache_free(multi_heap_cache_handle_t cache, void *p)
+{
+    size_t usable = multi_heap_internal_cache_put(cache->heap, p);
+    if (usable < s_class_size[0] || usable >= MULTI_HEAP_CACHE_MAX_SIZE + MAX_SLACK) {
+        return false;
+    }
+    const int cls = (usable >= MULTI_HEAP_CACHE_MAX_SIZE) ? NUM_CLASSES - 1 : s_free_class[usable / 16];
+    if (usable - s_class_size[cls] >= MAX_SLACK) {
+        return false;
+    }
+
+    cache_slot_t *slot = &cache->slots[MULTI_HEAP_CACHE_SLOT()];
+    magazine_t *mag = &slot->magazines[cls];
+    bool cached = false;
+
+    MULTI_HEAP_LOCK(&slot->lock);
+    if (mag->count < MULTI_HEAP_CACHE_DEPTH) {
+        mag->blocks[mag->count++] = p;
+        cached = true;
+    }
+    MULTI_HEAP_UNLOCK(&slot->lock);
+
+    return cached;
+}
+
+bool multi_heap_cache_flush(multi_heap_cache_handle_t cache)
+{
+    bool flushed = false;
+
+    for (int i = 0; i < MULTI_HEAP_CACHE_NUM_SLOTS; i++) {
+        cache_slot_t *slot = &cache->slots[i];
+        /* Lock order is always slot then heap, the slot lock is never taken with the heap lock held */
+        MULTI_HEAP_LOCK(&slot->lock);
+        for (int cls = 0; cls < NUM_CLASSES; cls++) {
+            magazine_t *mag = &slot->magazines[cls];
+            while (mag->count > 0) {
+                multi_heap_free(cache->heap, mag->blocks[--mag->count]);
+                flushed = true;
+            }
+        }
+        MULTI_HEAP_UNLOCK(&slot->lock);
+    }
+    return flushed;
+}
+
+bool multi_heap_cache_check(multi_heap_cache_handle_t cache, bool print_errors)
+{
+    bool valid = true;
+
+    for (int i = 0; i < MULTI_HEAP_CACHE_NUM_SLOTS; i++) {
+        cache_slot_t *slot = &cache->slots[i];
+        MULTI_HEAP_LOCK(&slot->lock);
+        for (int cls = 0; cls < NUM_CLASSES; cls++) {
+            const magazine_t *mag = &slot->magazines[cls];
+            for (uint32_t j = 0; j < mag->count; j++) {
+                valid = multi_heap_internal_cache_check(mag->blocks[j], print_errors) && valid;
+            }
+        }
+        MULTI_HEAP_UNLOCK(&slot->lock);
+    }
+    return valid;
+}
+
+void multi_heap_cache_get_stats(multi_heap_cache_handle_t cache, multi_heap_cache_stats_t *stats)
+{
+    memset(stats, 0, sizeof(multi_heap_cache_stats_t));
+
+    /* Sizes are not kept up to date by the allocation paths, the cache is small enough to be walked */
+    for (int i = 0; i < MULTI_HEAP_CACHE_NUM_SLOTS; i++) {
+        cache_slot_t *slot = &cache->slots[i];
+        MULTI_HEAP_LOCK(&slot->lock);
+        for (int cls = 0; cls < NUM_CLASSES; cls++) {
+            const magazine_t *mag = &slot->magazines[cls];
+            for (uint32_t j = 0; j < mag->count; j++) {
+                stats->free_bytes += multi_heap_get_full_block_size(cache->heap, mag->blocks[j]) + tlsf_alloc_overhead();
+                stats->allocated_bytes += multi_heap_get_allocated_size(cache->heap, mag->blocks[j]);
+            }
+            stats->blocks += mag->count;
+        }
+        MULTI_HEAP_UNLOCK(&slot->lock);
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "multi_heap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Small block cache, an optional front-end of a multi_heap.
+
+   Freed blocks of up to MULTI_HEAP_CACHE_MAX_SIZE bytes are kept in small per-slot stacks ("magazines"), one per
+   size class, and handed out again by the next allocation of the same class without searching the TLSF free lists
+   and without taking the heap lock (unless heap poisoning is enabled). On target there is one slot per core, each
+   with its own lock, so the lock of a slot is normally only taken by one core and is never contended.
+
+   Cached blocks stay allocated from the point of view of the heap, multi_heap_cache_get_stats() tells how much
+   memory they hold so that the callers can report it as free.
+*/
+
+/* Largest allocation size served by the cache */
+#define MULTI_HEAP_CACHE_MAX_SIZE 128
+
+typedef struct multi_heap_cache *multi_heap_cache_handle_t;
+
+typedef struct {
+    size_t free_bytes;          ///< Bytes the free size of the heap grows by once the cached blocks are freed
+    size_t allocated_bytes;     ///< Usable bytes of the cached blocks (as counted in total_allocated_bytes)
+    size_t blocks;              ///< Number of cached blocks
+} multi_heap_cache_stats_t;
+
+/** @brief Create the small block cache of a heap
+
+   The cache itself is allocated from the heap. The heap lock must be set
+   (multi_heap_set_lock()) before the cache is used from more than one task.
+
+   @param heap Handle of the heap to cache
+   @return Cache handle, or NULL if there was not enough memory
+*/
+multi_heap_cache_handle_t multi_heap_cache_create(multi_heap_handle_t heap);
+
+/** @brief Allocate a block through the cache
+
+   @param cache Cache handle
+   @param size Size of the allocation, at most MULTI_HEAP_CACHE_MAX_SIZE bytes
+
+   @return Pointer to the allocated memory, or NULL if the heap is exhausted
+*/
+void *multi_heap_cache_malloc(multi_heap_cache_handle_t cache, size_t size);
+
+/** @brief Try to keep a block in the cache instead of freeing it
+
+   @param cache Cache handle
+   @param p Block allocated from the cached heap
+
+   @return true if the block was taken over by the cache, false if it must be freed with multi_heap_free()
+*/
+bool multi_heap_cache_free(multi_heap_cache_handle_t cache, void *p);
+
+/** @brief Return all the cached blocks to the heap
+
+   @param cache Cache handle
+   @return true if any block was freed
+*/
+bool multi_heap_cache_flush(multi_heap_cache_handle_t cache);
+
+/** @brief Check the integrity of the cached blocks
+
+   With heap poisoning enabled, the poison bytes of the cached blocks are verified the same way
+   multi_heap_check() verifies free blocks.
+
+   @param cache Cache handle
+   @param print_errors If true, errors will be printed to stderr
+   @return true if the cached blocks are valid
+*/
+bool multi_heap_cache_check(multi_heap_cache_handle_t cache, bool print_errors);
+
+/** @brief Get the amount of memory held by the cache
+
+   @param cache Cache handle
+   @param stats Filled with the current statistics
+*/
+void multi_heap_cache_get_stats(multi_heap_cache_handle_t cache, multi_heap_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
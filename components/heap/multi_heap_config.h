@@ -21,3 +21,10 @@
 #define MULTI_HEAP_POISONING
 #define MULTI_HEAP_POISONING_SLOW
 #endif
+
+/* Number of blocks kept per size class and per core by the small block cache */
+#ifdef CONFIG_HEAP_SMALL_OBJECT_CACHE_DEPTH
+#define MULTI_HEAP_CACHE_DEPTH CONFIG_HEAP_SMALL_OBJECT_CACHE_DEPTH
+#else
+#define MULTI_HEAP_CACHE_DEPTH 8
+#endif
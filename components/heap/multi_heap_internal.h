@@ -75,6 +75,21 @@ void multi_heap_internal_lock(multi_heap_handle_t heap);
 
 void multi_heap_internal_unlock(multi_heap_handle_t heap);
 
+/* Internal hooks used by the small block cache (multi_heap_cache.c) */
+
+/* Prepare an allocated block to be kept in the cache instead of being freed: check its poison bytes
+   and fill it with the free pattern. Returns the usable size of the block.
+*/
+size_t multi_heap_internal_cache_put(multi_heap_handle_t heap, void *p);
+
+/* Prepare a block to be handed out for an allocation of 'size' bytes. 'from_cache' is true if the block
+   was kept in the cache, false if it was just allocated from the heap for a (bigger) size class.
+*/
+void multi_heap_internal_cache_get(multi_heap_handle_t heap, void *p, size_t size, bool from_cache);
+
+/* Check the poison bytes of a block kept in the cache */
+bool multi_heap_internal_cache_check(void *p, bool print_errors);
+
 /* Some internal functions for heap debugging code to use */
 
 /* Get the handle to the first (fixed free) block in a heap */
@@ -36,6 +36,10 @@ typedef portMUX_TYPE multi_heap_lock_t;
 
 #define MULTI_HEAP_LOCK_STATIC_INITIALIZER     portMUX_INITIALIZER_UNLOCKED
 
+/* The small block cache keeps one set of magazines per core */
+#define MULTI_HEAP_CACHE_NUM_SLOTS portNUM_PROCESSORS
+#define MULTI_HEAP_CACHE_SLOT() xPortGetCoreID()
+
 /* Not safe to use std i/o while in a portmux critical section,
    can deadlock, so we use the ROM equivalent functions. */
 
@@ -89,10 +93,21 @@ inline static void multi_heap_assert(bool condition, const char *format, int lin
 
 #define MULTI_HEAP_PRINTF printf
 #define MULTI_HEAP_STDERR_PRINTF(MSG, ...) fprintf(stderr, MSG, __VA_ARGS__)
+
+/* Host tests which need locking can provide their own lock type and macros
+   (for example with the compiler's -include option) */
+#ifndef MULTI_HEAP_LOCK
+typedef int multi_heap_lock_t;
 #define MULTI_HEAP_LOCK(PLOCK)  (void) (PLOCK)
 #define MULTI_HEAP_UNLOCK(PLOCK)  (void) (PLOCK)
 #define MULTI_HEAP_LOCK_INIT(PLOCK)  (void) (PLOCK)
 #define MULTI_HEAP_LOCK_STATIC_INITIALIZER  0
+#endif
+
+#ifndef MULTI_HEAP_CACHE_SLOT
+#define MULTI_HEAP_CACHE_NUM_SLOTS 1
+#define MULTI_HEAP_CACHE_SLOT() 0
+#endif
 
 #define MULTI_HEAP_ASSERT(CONDITION, ADDRESS) assert((CONDITION) && "Heap corrupt")
 
@@ -450,6 +450,56 @@ void multi_heap_internal_poison_fill_region(void *start, size_t size, bool is_fr
     memset(start, is_free ? FREE_FILL_PATTERN : MALLOC_FILL_PATTERN, size);
 }
 
+size_t multi_heap_internal_cache_put(multi_heap_handle_t heap, void *p)
+{
+    multi_heap_internal_lock(heap);
+    poison_head_t *head = verify_allocated_region(p, true);
+    assert(head != NULL);
+    size_t result = multi_heap_get_allocated_size_impl(heap, head);
+#ifdef SLOW
+    /* while cached, the data is checked like the content of a free block */
+    memset(p, FREE_FILL_PATTERN, head->alloc_size);
+#endif
+    multi_heap_internal_unlock(heap);
+    subtract_poison_overhead(&result);
+    return result;
+}
+
+void multi_heap_internal_cache_get(multi_heap_handle_t heap, void *p, size_t size, bool from_cache)
+{
+    poison_head_t *head = (poison_head_t *)((intptr_t)p - sizeof(poison_head_t));
+
+    multi_heap_internal_lock(heap);
+#ifdef SLOW
+    size_t old_size = head->alloc_size;
+    if (from_cache) {
+        bool ret = verify_fill_pattern(p, old_size, true, true, false);
+        assert( ret );
+    }
+    if (size < old_size) {
+        /* multi_heap_free() only fills up to the tail canary, what lies behind the new tail
+           must already have the free pattern */
+        memset((uint8_t *)p + size, FREE_FILL_PATTERN, old_size - size + sizeof(poison_tail_t));
+    }
+    memset(p, MALLOC_FILL_PATTERN, size);
+#endif
+    poison_allocated_region(head, size);
+    multi_heap_internal_unlock(heap);
+}
+
+bool multi_heap_internal_cache_check(void *p, bool print_errors)
+{
+    poison_head_t *head = verify_allocated_region(p, print_errors);
+    if (head == NULL) {
+        return false;
+    }
+#ifdef SLOW
+    return verify_fill_pattern(p, head->alloc_size, print_errors, true, false);
+#else
+    return true;
+#endif
+}
+
 void *multi_heap_find_containing_block(multi_heap_handle_t heap, void *ptr)
 {
     void * block_ptr = multi_heap_find_containing_block_impl(heap, ptr);
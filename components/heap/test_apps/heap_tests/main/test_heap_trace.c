@@ -20,6 +20,8 @@
 #include "freertos/task.h"
 
 #include "esp_heap_caps.h"
+#include "esp_cpu.h"
+#include <inttypes.h>
 
 #ifdef CONFIG_HEAP_TRACING
 // only compile in heap tracing tests if tracing is enabled
@@ -264,6 +266,144 @@ TEST_CASE("check for summary value validity", "[heap-trace]") {
     heap_trace_stop();
 }
 
+#ifdef CONFIG_HEAP_TRACE_CALLSITES
+#define NUM_CALLSITES 32
+
+static __attribute__((noinline)) void *callsite_alloc_a(size_t size)
+{
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL);
+}
+
+static __attribute__((noinline)) void *callsite_alloc_b(size_t size)
+{
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL);
+}
+
+static const heap_trace_callsite_t *find_callsite(const heap_trace_callsite_t *sites, size_t count, uint32_t allocs, size_t bucket)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (sites[i].allocs == allocs && sites[i].size_histogram[bucket] == allocs) {
+            return &sites[i];
+        }
+    }
+    return NULL;
+}
+
+#if CONFIG_HEAP_TRACING_STACK_DEPTH >= 2
+TEST_CASE("heap trace call sites aggregate allocations per call stack", "[heap-trace]")
+{
+    static heap_trace_callsite_t sites[NUM_CALLSITES];
+    TEST_ESP_OK(heap_trace_init_callsites(sites, NUM_CALLSITES, 16));
+    TEST_ESP_OK(heap_trace_start(HEAP_TRACE_CALLSITES));
+
+    void *a[3];
+    for (int i = 0; i < 3; i++) {
+        a[i] = callsite_alloc_a(100);
+        TEST_ASSERT_NOT_NULL(a[i]);
+    }
+    void *b = callsite_alloc_b(20);
+    TEST_ASSERT_NOT_NULL(b);
+    heap_caps_free(a[0]);
+    heap_caps_free(a[1]);
+
+    heap_trace_stop();
+    heap_trace_dump();
+
+    const heap_trace_callsite_t *site_a = find_callsite(sites, heap_trace_get_count(), 3, 6);
+    const heap_trace_callsite_t *site_b = find_callsite(sites, heap_trace_get_count(), 1, 4);
+    TEST_ASSERT_NOT_NULL(site_a);
+    TEST_ASSERT_NOT_NULL(site_b);
+    TEST_ASSERT_EQUAL(2, site_a->frees);
+    TEST_ASSERT_EQUAL(300, site_a->total_bytes);
+    TEST_ASSERT_EQUAL(100, site_a->live_bytes);
+    TEST_ASSERT_EQUAL(300, site_a->peak_live_bytes);
+    TEST_ASSERT_EQUAL(0, site_b->frees);
+    TEST_ASSERT_EQUAL(20, site_b->live_bytes);
+
+    heap_trace_callsite_t copy;
+    TEST_ESP_OK(heap_trace_get_callsite(site_a - sites, &copy));
+    TEST_ASSERT_EQUAL_MEMORY(site_a, &copy, sizeof(copy));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, heap_trace_get_callsite(NUM_CALLSITES, &copy));
+
+    heap_caps_free(a[2]);
+    heap_caps_free(b);
+}
+#endif // CONFIG_HEAP_TRACING_STACK_DEPTH >= 2
+
+typedef struct {
+    uint8_t buf[512];
+    size_t len;
+} dump_buffer_t;
+
+static void write_dump(const void *data, size_t len, void *arg)
+{
+    dump_buffer_t *dump = arg;
+    if (dump->len + len <= sizeof(dump->buf)) {
+        memcpy(dump->buf + dump->len, data, len);
+    }
+    dump->len += len;
+}
+
+TEST_CASE("heap trace call sites binary dump", "[heap-trace]")
+{
+    static heap_trace_callsite_t sites[2];
+    static dump_buffer_t dump;
+    TEST_ESP_OK(heap_trace_init_callsites(sites, 2, 8));
+    TEST_ESP_OK(heap_trace_start(HEAP_TRACE_CALLSITES));
+    void *p = callsite_alloc_a(40);
+    heap_caps_free(p);
+    heap_trace_stop();
+
+    TEST_ESP_OK(heap_trace_dump_callsites_binary(write_dump, &dump));
+    heap_trace_callsites_dump_header_t header;
+    memcpy(&header, dump.buf, sizeof(header));
+    TEST_ASSERT_EQUAL_HEX32(HEAP_TRACE_CALLSITES_DUMP_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL(CONFIG_HEAP_TRACING_STACK_DEPTH, header.stack_depth);
+    TEST_ASSERT_EQUAL(HEAP_TRACE_CALLSITE_HIST_BUCKETS, header.hist_buckets);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, header.num_sites);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, header.total_frees);
+    TEST_ASSERT_EQUAL(sizeof(header) + header.num_sites * 4 * (CONFIG_HEAP_TRACING_STACK_DEPTH + 22), dump.len);
+}
+
+static uint32_t measure_alloc_free_cycles(void)
+{
+    const int iterations = 1000;
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < iterations; i++) {
+        void *p = callsite_alloc_a(32 + (i & 63));
+        heap_caps_free(p);
+    }
+    return (esp_cpu_get_cycle_count() - start) / iterations;
+}
+
+TEST_CASE("heap trace per allocation overhead", "[heap-trace]")
+{
+    static heap_trace_record_t recs[64];
+    static heap_trace_callsite_t sites[NUM_CALLSITES];
+    TEST_ESP_OK(heap_trace_init_standalone(recs, 64));
+    TEST_ESP_OK(heap_trace_init_callsites(sites, NUM_CALLSITES, 64));
+
+    uint32_t untraced = measure_alloc_free_cycles();
+
+    TEST_ESP_OK(heap_trace_start(HEAP_TRACE_LEAKS));
+    uint32_t leaks = measure_alloc_free_cycles();
+    heap_trace_stop();
+
+    TEST_ESP_OK(heap_trace_start(HEAP_TRACE_CALLSITES));
+    uint32_t callsites = measure_alloc_free_cycles();
+    heap_trace_stop();
+
+    printf("cycles per malloc/free pair: untraced %"PRIu32", leaks %"PRIu32", call sites %"PRIu32"\n",
+           untraced, leaks, callsites);
+
+    bool found = false;
+    for (size_t i = 0; i < heap_trace_get_count(); i++) {
+        found |= (sites[i].allocs == 1000 && sites[i].frees == 1000 && sites[i].live_bytes == 0);
+    }
+    TEST_ASSERT_TRUE(found);
+}
+#endif // CONFIG_HEAP_TRACE_CALLSITES
+
 #ifdef CONFIG_SPIRAM
 void* allocate_pointer(uint32_t caps)
 {
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+
+#include "sdkconfig.h"
+
+#if CONFIG_HEAP_SMALL_OBJECT_CACHE
+
+#define SMALL_CAPS (MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL)
+#define NUM_BLOCKS 32
+
+typedef struct {
+    void (*func)(void);
+    SemaphoreHandle_t done;
+} pinned_test_t;
+
+static void pinned_test_task(void *arg)
+{
+    pinned_test_t *test = (pinned_test_t *)arg;
+    test->func();
+    xSemaphoreGive(test->done);
+    vTaskDelete(NULL);
+}
+
+/* The blocks are cached per core, run the test without migrating between cores */
+static void run_pinned(void (*func)(void))
+{
+    pinned_test_t test = {
+        .func = func,
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_ASSERT_NOT_NULL(test.done);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(pinned_test_task, "cache_test", 4096, &test,
+                                                      uxTaskPriorityGet(NULL) + 1, NULL, 0));
+    xSemaphoreTake(test.done, portMAX_DELAY);
+    vSemaphoreDelete(test.done);
+}
+
+static void reuse_test(void)
+{
+    uint8_t *p = heap_caps_malloc(40, SMALL_CAPS);
+    TEST_ASSERT_NOT_NULL(p);
+    /* the allocation is rounded up to its size class */
+    TEST_ASSERT_GREATER_OR_EQUAL(48, heap_caps_get_allocated_size(p));
+    memset(p, 0xA5, 40);
+    heap_caps_free(p);
+
+    uint8_t *q = heap_caps_malloc(48, SMALL_CAPS);
+    TEST_ASSERT_EQUAL_PTR(p, q);
+    memset(q, 0x5A, 48);
+    heap_caps_free(q);
+
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+}
+
+TEST_CASE("small object cache reuses freed blocks", "[heap][small_object_cache]")
+{
+    run_pinned(reuse_test);
+}
+
+static void accounting_test(void)
+{
+    void *blocks[NUM_BLOCKS];
+    multi_heap_info_t before, after;
+
+    heap_caps_get_info(&before, SMALL_CAPS);
+    size_t free_before = heap_caps_get_free_size(SMALL_CAPS);
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        blocks[i] = heap_caps_malloc(1 + (i * 7) % 128, SMALL_CAPS);
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+    }
+    TEST_ASSERT_LESS_THAN(free_before, heap_caps_get_free_size(SMALL_CAPS));
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        heap_caps_free(blocks[i]);
+    }
+
+    /* cached blocks are reported as free */
+    heap_caps_get_info(&after, SMALL_CAPS);
+    TEST_ASSERT_EQUAL(free_before, heap_caps_get_free_size(SMALL_CAPS));
+    TEST_ASSERT_EQUAL(before.total_free_bytes, after.total_free_bytes);
+    TEST_ASSERT_EQUAL(before.total_allocated_bytes, after.total_allocated_bytes);
+    TEST_ASSERT_EQUAL(before.allocated_blocks, after.allocated_blocks);
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+}
+
+TEST_CASE("small object cache keeps the heap accounting", "[heap][small_object_cache]")
+{
+    run_pinned(accounting_test);
+}
+
+TEST_CASE("small object cache is flushed when the heap is exhausted", "[heap][small_object_cache]")
+{
+    /* put about 2 KB in the caches, with blocks of every class */
+    void *blocks[NUM_BLOCKS];
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        blocks[i] = heap_caps_malloc(16 + (i % 8) * 16, SMALL_CAPS);
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+    }
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        heap_caps_free(blocks[i]);
+    }
+
+    /* exhaust the heaps, the last small allocations have to take the cached blocks back */
+    void *list = NULL;
+    size_t size;
+    while ((size = heap_caps_get_largest_free_block(SMALL_CAPS)) > 256) {
+        void *p = heap_caps_malloc(size, SMALL_CAPS);
+        TEST_ASSERT_NOT_NULL(p);
+        *(void **)p = list;
+        list = p;
+    }
+    void *p;
+    while ((p = heap_caps_malloc(sizeof(void *), SMALL_CAPS)) != NULL) {
+        *(void **)p = list;
+        list = p;
+    }
+    TEST_ASSERT_LESS_THAN(1024, heap_caps_get_free_size(SMALL_CAPS));
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+
+    while (list != NULL) {
+        void *next = *(void **)list;
+        heap_caps_free(list);
+        list = next;
+    }
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+}
+
+static void timing_test(void)
+{
+    void *blocks[NUM_BLOCKS];
+    const int iterations = 1000;
+
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < iterations; i++) {
+        for (int j = 0; j < NUM_BLOCKS; j++) {
+            blocks[j] = heap_caps_malloc(8 + (j % 8) * 16, SMALL_CAPS);
+        }
+        for (int j = 0; j < NUM_BLOCKS; j++) {
+            heap_caps_free(blocks[j]);
+        }
+    }
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    printf("small object cache: %"PRIu32" cycles per malloc/free pair\n", cycles / (iterations * NUM_BLOCKS));
+}
+
+TEST_CASE("small object cache malloc/free timing", "[heap][small_object_cache]")
+{
+    run_pinned(timing_test);
+}
+
+#endif // CONFIG_HEAP_SMALL_OBJECT_CACHE
@@ -41,6 +41,14 @@ def test_heap_in_flash(dut: Dut) -> None:
     dut.run_all_single_board_cases()
 
 
+@pytest.mark.generic
+@pytest.mark.parametrize('config', ['small_object_cache'])
+@idf_parametrize('target', ['esp32', 'esp32c3'], indirect=['target'])
+def test_heap_small_object_cache(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='small_object_cache')
+    dut.run_all_single_board_cases(name=['multi_heap poisoning detection', 'canary corruption in light or comprehensive poisoning mode'])
+
+
 @pytest.mark.generic
 @pytest.mark.parametrize(
     'target',
@@ -0,0 +1,35 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* Thread-safe host platform for benchmark_cache.c, force-included in every
+   source file of the benchmark so that multi_heap_platform.h picks it up */
+
+#include <pthread.h>
+
+typedef pthread_mutex_t multi_heap_lock_t;
+
+#define MULTI_HEAP_LOCK(PLOCK) do {                                 \
+        if ((PLOCK) != NULL) {                                      \
+            pthread_mutex_lock((pthread_mutex_t *)(PLOCK));         \
+        }                                                           \
+    } while(0)
+
+#define MULTI_HEAP_UNLOCK(PLOCK) do {                               \
+        if ((PLOCK) != NULL) {                                      \
+            pthread_mutex_unlock((pthread_mutex_t *)(PLOCK));       \
+        }                                                           \
+    } while(0)
+
+#define MULTI_HEAP_LOCK_INIT(PLOCK)  pthread_mutex_init((PLOCK), NULL)
+#define MULTI_HEAP_LOCK_STATIC_INITIALIZER  PTHREAD_MUTEX_INITIALIZER
+
+/* Each benchmark thread plays the role of a core */
+#define BENCHMARK_MAX_THREADS 8
+extern __thread int benchmark_thread_index;
+
+#define MULTI_HEAP_CACHE_NUM_SLOTS BENCHMARK_MAX_THREADS
+#define MULTI_HEAP_CACHE_SLOT() benchmark_thread_index
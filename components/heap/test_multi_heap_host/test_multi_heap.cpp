@@ -8,6 +8,7 @@
 #include "multi_heap.h"
 
 #include "../multi_heap_config.h"
+#include "../multi_heap_cache.h"
 #include "../tlsf/include/tlsf.h"
 #include "../tlsf/tlsf_block_functions.h"
 #include "../tlsf/tlsf_control_functions.h"
@@ -621,3 +622,85 @@ TEST_CASE("multi_heap poisoning detection", "[multi_heap]")
         REQUIRE(is_heap_ok == true);
     }
 }
+
+TEST_CASE("multi_heap small block cache", "[multi_heap]")
+{
+    uint8_t heapdata[8 * 1024];
+    multi_heap_handle_t heap = multi_heap_register(heapdata, sizeof(heapdata));
+    multi_heap_cache_handle_t cache = multi_heap_cache_create(heap);
+    REQUIRE( cache != NULL );
+
+    multi_heap_cache_stats_t stats;
+    const size_t free_size = multi_heap_free_size(heap);
+
+    /* an allocation of 20 bytes gets a block of the 32 bytes class */
+    uint8_t *a = (uint8_t *)multi_heap_cache_malloc(cache, 20);
+    REQUIRE( a != NULL );
+    REQUIRE( multi_heap_get_allocated_size(heap, a) >= 32 );
+    memset(a, 0xAA, 20);
+    REQUIRE( multi_heap_check(heap, true) );
+    REQUIRE( multi_heap_cache_free(cache, a) );
+
+    /* the cached block is still allocated in the heap but is accounted as free */
+    multi_heap_cache_get_stats(cache, &stats);
+    REQUIRE( stats.blocks == 1 );
+    REQUIRE( stats.allocated_bytes >= 32 );
+    REQUIRE( multi_heap_free_size(heap) + stats.free_bytes == free_size );
+    REQUIRE( multi_heap_check(heap, true) );
+    REQUIRE( multi_heap_cache_check(cache, true) );
+
+    /* the next allocation of the same class reuses it */
+    uint8_t *b = (uint8_t *)multi_heap_cache_malloc(cache, 32);
+    REQUIRE( b == a );
+    memset(b, 0xBB, 32);
+    multi_heap_cache_get_stats(cache, &stats);
+    REQUIRE( stats.blocks == 0 );
+    REQUIRE( multi_heap_check(heap, true) );
+
+    /* large blocks are not cached */
+    void *c = multi_heap_malloc(heap, 512);
+    REQUIRE( c != NULL );
+    REQUIRE( multi_heap_cache_free(cache, c) == false );
+    multi_heap_free(heap, c);
+
+    REQUIRE( multi_heap_cache_free(cache, b) );
+
+#ifdef CONFIG_HEAP_POISONING_COMPREHENSIVE
+    /* writing to a cached block is detected like writing to a free block */
+    b[4] ^= 0x01;
+    REQUIRE( multi_heap_cache_check(cache, true) == false );
+    b[4] ^= 0x01;
+    REQUIRE( multi_heap_cache_check(cache, true) );
+#endif
+
+    /* flushing gives the blocks back to the heap */
+    REQUIRE( multi_heap_cache_flush(cache) );
+    REQUIRE( multi_heap_cache_flush(cache) == false );
+    REQUIRE( multi_heap_free_size(heap) == free_size );
+    REQUIRE( multi_heap_check(heap, true) );
+
+    /* when the heap is exhausted, the cached blocks are freed to serve the allocation */
+    void *blocks[256];
+    size_t count = 0;
+    while (count < 256 && (blocks[count] = multi_heap_cache_malloc(cache, 128)) != NULL) {
+        count++;
+    }
+    REQUIRE( count > 16 );
+    /* cache blocks spread over the heap, so that no large free block remains */
+    for (size_t i = 0; i < count; i += count / 4) {
+        REQUIRE( multi_heap_cache_free(cache, blocks[i]) );
+        blocks[i] = NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        multi_heap_free(heap, blocks[i]);
+    }
+    multi_heap_cache_get_stats(cache, &stats);
+    REQUIRE( stats.blocks > 0 );
+    void *big = multi_heap_malloc(heap, free_size / 2);
+    REQUIRE( big == NULL );
+    REQUIRE( multi_heap_cache_flush(cache) );
+    big = multi_heap_malloc(heap, free_size / 2);
+    REQUIRE( big != NULL );
+    multi_heap_free(heap, big);
+    REQUIRE( multi_heap_check(heap, true) );
+}
@@ -5,7 +5,6 @@
  */
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
 #include "lwip/dhcp.h"
 #include "lwip/err.h"
 #include "lwip/pbuf.h"
@@ -18,6 +17,9 @@
 
 #include "dhcpserver/dhcpserver.h"
 #include "dhcpserver/dhcpserver_options.h"
+#if CONFIG_LWIP_DHCPS_RESTORE_LEASES
+#include "netif/dhcps_state.h"
+#endif
 
 #if ESP_DHCPS
 
@@ -108,10 +110,33 @@ typedef enum {
     DHCPS_HANDLE_DELETE_PENDING,
 } dhcps_handle_state;
 
-typedef struct list_node {
-	void *pnode;
-	struct list_node *pnext;
-} list_node;
+/* Leases are kept in a fixed table of MAX_STATION_NUM entries, chained in two hash indexes
+ * (by MAC and by IP address) and ordered by expiry time in a binary min-heap */
+typedef u16_t lease_idx_t;
+#define LEASE_NONE 0xFFFF
+#if MAX_STATION_NUM <= 8
+#define LEASE_HASH_SIZE 16
+#elif MAX_STATION_NUM <= 32
+#define LEASE_HASH_SIZE 64
+#elif MAX_STATION_NUM <= 64
+#define LEASE_HASH_SIZE 128
+#elif MAX_STATION_NUM <= 256
+#define LEASE_HASH_SIZE 512
+#else
+#define LEASE_HASH_SIZE 1024
+#endif
+
+#if CONFIG_LWIP_DHCPS_RESTORE_LEASES
+/* Changes of the lease table are written to NVS in one batch, this many timer ticks after the first of them */
+#define LEASES_SAVE_DELAY_TICKS LWIP_MAX(1, 30 / DHCP_COARSE_TIMER_SECS)
+#endif
+
+typedef struct lease_entry {
+    struct dhcps_pool pool;     /* pool.lease_timer holds the timer tick the lease expires at */
+    lease_idx_t mac_next;       /* next lease in the MAC hash bucket, or next free entry */
+    lease_idx_t ip_next;        /* next lease in the IP hash bucket */
+    lease_idx_t heap_pos;       /* position in the expiry heap */
+} lease_entry;
 
 typedef struct {
     ip4_addr_t ip;
@@ -130,7 +155,15 @@ struct dhcps_t {
     ip4_addr_t client_address;
     ip4_addr_t client_address_plus;
     ip4_addr_t dhcps_mask;
-    list_node *plist;
+    lease_entry leases[MAX_STATION_NUM];
+    lease_idx_t mac_hash[LEASE_HASH_SIZE];
+    lease_idx_t ip_hash[LEASE_HASH_SIZE];
+    lease_idx_t expiry_heap[MAX_STATION_NUM];
+    lease_idx_t num_leases;
+    lease_idx_t free_lease;
+    bool leases_changed;
+    u32_t leases_save_tick;
+    u32_t ticks;
     bool renew;
     dhcps_lease_t dhcps_poll;
     dhcps_time_t dhcps_lease_time;
@@ -146,7 +179,7 @@ struct dhcps_t {
 
 
 static void dhcps_tmr(void* arg);
-
+static void lease_table_reset(dhcps_t *dhcps);
 
 dhcps_t *dhcps_new(void)
 {
@@ -165,7 +198,7 @@ dhcps_t *dhcps_new(void)
 #else
     dhcps->dhcps_mask.addr = PP_HTONL(LWIP_MAKEU32(255, 255, 255, 0));
 #endif
-    dhcps->plist = NULL;
+    lease_table_reset(dhcps);
     dhcps->renew = false;
     dhcps->dhcps_lease_time = DHCPS_LEASE_TIME_DEF;
     dhcps->dhcps_offer = 0xFF;
@@ -328,84 +361,276 @@ err_t dhcps_set_option_info(dhcps_t *dhcps, u8_t op_id, void *opt_info, u32_t op
     return ERR_OK;
 }
 
+static inline u32_t lease_mac_hash(const u8_t *mac)
+{
+    u32_t hash = 2166136261U;
+
+    for (int i = 0; i < 6; i++) {
+        hash = (hash ^ mac[i]) * 16777619U;
+    }
+    return hash & (LEASE_HASH_SIZE - 1);
+}
+
+static inline u32_t lease_ip_hash(u32_t addr)
+{
+    /* pool addresses differ in the host bits, which are the low bits in host order */
+    return lwip_ntohl(addr) & (LEASE_HASH_SIZE - 1);
+}
+
+static inline bool lease_expires_before(dhcps_t *dhcps, lease_idx_t a, lease_idx_t b)
+{
+    return (s32_t)(dhcps->leases[a].pool.lease_timer - dhcps->leases[b].pool.lease_timer) < 0;
+}
+
+static void lease_heap_set(dhcps_t *dhcps, lease_idx_t pos, lease_idx_t idx)
+{
+    dhcps->expiry_heap[pos] = idx;
+    dhcps->leases[idx].heap_pos = pos;
+}
+
+static void lease_heap_sift(dhcps_t *dhcps, lease_idx_t pos)
+{
+    lease_idx_t idx = dhcps->expiry_heap[pos];
+
+    while (pos > 0 && lease_expires_before(dhcps, idx, dhcps->expiry_heap[(pos - 1) / 2])) {
+        lease_heap_set(dhcps, pos, dhcps->expiry_heap[(pos - 1) / 2]);
+        pos = (pos - 1) / 2;
+    }
+
+    while (2 * pos + 1 < dhcps->num_leases) {
+        lease_idx_t child = 2 * pos + 1;
+
+        if (child + 1 < dhcps->num_leases && lease_expires_before(dhcps, dhcps->expiry_heap[child + 1], dhcps->expiry_heap[child])) {
+            child++;
+        }
+
+        if (!lease_expires_before(dhcps, dhcps->expiry_heap[child], idx)) {
+            break;
+        }
+
+        lease_heap_set(dhcps, pos, dhcps->expiry_heap[child]);
+        pos = child;
+    }
+
+    lease_heap_set(dhcps, pos, idx);
+}
+
 /******************************************************************************
- * FunctionName : node_insert_to_list
- * Description  : insert the node to the list
- * Parameters   : phead -- the head node of the list
- *                pinsert -- the insert node of the list
+ * FunctionName : lease_table_reset
+ * Description  : drop all the leases
+ * Parameters   : none
  * Returns      : none
 *******************************************************************************/
-static void node_insert_to_list(list_node **phead, list_node *pinsert)
+static void lease_table_reset(dhcps_t *dhcps)
 {
-    list_node *plist = NULL;
-    struct dhcps_pool *pdhcps_pool = NULL;
-    struct dhcps_pool *pdhcps_node = NULL;
+    for (int i = 0; i < LEASE_HASH_SIZE; i++) {
+        dhcps->mac_hash[i] = LEASE_NONE;
+        dhcps->ip_hash[i] = LEASE_NONE;
+    }
 
-    if (*phead == NULL) {
-        *phead = pinsert;
-    } else {
-        plist = *phead;
-        pdhcps_node = pinsert->pnode;
-        pdhcps_pool = plist->pnode;
+    for (int i = 0; i < MAX_STATION_NUM; i++) {
+        dhcps->leases[i].mac_next = (i + 1 < MAX_STATION_NUM) ? i + 1 : LEASE_NONE;
+    }
 
-        if (pdhcps_node->ip.addr < pdhcps_pool->ip.addr) {
-            pinsert->pnext = plist;
-            *phead = pinsert;
-        } else {
-            while (plist->pnext != NULL) {
-                pdhcps_pool = plist->pnext->pnode;
+    dhcps->free_lease = 0;
+    dhcps->num_leases = 0;
+}
 
-                if (pdhcps_node->ip.addr < pdhcps_pool->ip.addr) {
-                    pinsert->pnext = plist->pnext;
-                    plist->pnext = pinsert;
-                    break;
-                }
+/******************************************************************************
+ * FunctionName : lease_find_by_mac
+ * Description  : look up the lease of a client
+ * Parameters   : mac -- The MAC addr of the client
+ * Returns      : the lease, or NULL if the client has none
+*******************************************************************************/
+static lease_entry *lease_find_by_mac(dhcps_t *dhcps, const u8_t *mac)
+{
+    for (lease_idx_t i = dhcps->mac_hash[lease_mac_hash(mac)]; i != LEASE_NONE; i = dhcps->leases[i].mac_next) {
+        if (memcmp(dhcps->leases[i].pool.mac, mac, sizeof(dhcps->leases[i].pool.mac)) == 0) {
+            return &dhcps->leases[i];
+        }
+    }
 
-                plist = plist->pnext;
-            }
+    return NULL;
+}
 
-            if (plist->pnext == NULL) {
-                plist->pnext = pinsert;
-            }
+/******************************************************************************
+ * FunctionName : lease_find_by_ip
+ * Description  : look up the lease of an IP address
+ * Parameters   : addr -- The IP addr, in network order
+ * Returns      : the lease, or NULL if the address is free
+*******************************************************************************/
+static lease_entry *lease_find_by_ip(dhcps_t *dhcps, u32_t addr)
+{
+    for (lease_idx_t i = dhcps->ip_hash[lease_ip_hash(addr)]; i != LEASE_NONE; i = dhcps->leases[i].ip_next) {
+        if (dhcps->leases[i].pool.ip.addr == addr) {
+            return &dhcps->leases[i];
         }
     }
 
-//	pinsert->pnext = NULL;
+    return NULL;
+}
+
+/******************************************************************************
+ * FunctionName : lease_table_changed
+ * Description  : record that the leases differ from the ones stored in NVS
+ * Parameters   : none
+ * Returns      : none
+*******************************************************************************/
+static inline void lease_table_changed(dhcps_t *dhcps)
+{
+#if CONFIG_LWIP_DHCPS_RESTORE_LEASES
+    if (!dhcps->leases_changed) {
+        dhcps->leases_save_tick = dhcps->ticks + LEASES_SAVE_DELAY_TICKS;
+    }
+#endif
+    dhcps->leases_changed = true;
+}
+
+/******************************************************************************
+ * FunctionName : lease_remove
+ * Description  : remove a lease from the indexes and return its entry to the table
+ * Parameters   : lease -- the lease to remove
+ * Returns      : none
+*******************************************************************************/
+static void lease_remove(dhcps_t *dhcps, lease_entry *lease)
+{
+    lease_idx_t idx = lease - dhcps->leases;
+    lease_idx_t *link;
+
+    for (link = &dhcps->mac_hash[lease_mac_hash(lease->pool.mac)]; *link != idx; link = &dhcps->leases[*link].mac_next) {
+    }
+    *link = lease->mac_next;
+
+    for (link = &dhcps->ip_hash[lease_ip_hash(lease->pool.ip.addr)]; *link != idx; link = &dhcps->leases[*link].ip_next) {
+    }
+    *link = lease->ip_next;
+
+    lease_idx_t pos = lease->heap_pos;
+    dhcps->num_leases--;
+
+    if (pos < dhcps->num_leases) {
+        lease_heap_set(dhcps, pos, dhcps->expiry_heap[dhcps->num_leases]);
+        lease_heap_sift(dhcps, pos);
+    }
+
+    lease->mac_next = dhcps->free_lease;
+    dhcps->free_lease = idx;
+    lease_table_changed(dhcps);
 }
 
 /******************************************************************************
- * FunctionName : node_delete_from_list
- * Description  : remove the node from list
- * Parameters   : phead -- the head node of the list
- *                pdelete -- the remove node of the list
+ * FunctionName : lease_add
+ * Description  : add a lease, the lease expiring first is dropped
+ *                if MAX_STATION_NUM leases are already given
+ * Parameters   : ip -- the IP addr of the client
+ *                mac -- the MAC addr of the client
+ *                expiry -- the timer tick the lease expires at
+ * Returns      : the new lease
+*******************************************************************************/
+static lease_entry *lease_add(dhcps_t *dhcps, const ip4_addr_t *ip, const u8_t *mac, u32_t expiry)
+{
+    if (dhcps->free_lease == LEASE_NONE) {
+        lease_remove(dhcps, &dhcps->leases[dhcps->expiry_heap[0]]);
+    }
+
+    lease_idx_t idx = dhcps->free_lease;
+    lease_entry *lease = &dhcps->leases[idx];
+    dhcps->free_lease = lease->mac_next;
+
+    lease->pool.ip.addr = ip->addr;
+    memcpy(lease->pool.mac, mac, sizeof(lease->pool.mac));
+    lease->pool.lease_timer = expiry;
+
+    u32_t hash = lease_mac_hash(mac);
+    lease->mac_next = dhcps->mac_hash[hash];
+    dhcps->mac_hash[hash] = idx;
+
+    hash = lease_ip_hash(ip->addr);
+    lease->ip_next = dhcps->ip_hash[hash];
+    dhcps->ip_hash[hash] = idx;
+
+    lease_heap_set(dhcps, dhcps->num_leases, idx);
+    dhcps->num_leases++;
+    lease_heap_sift(dhcps, lease->heap_pos);
+    lease_table_changed(dhcps);
+    return lease;
+}
+
+/******************************************************************************
+ * FunctionName : lease_set_expiry
+ * Description  : extend or shorten a lease
+ * Parameters   : lease -- the lease to update
+ *                expiry -- the timer tick the lease expires at
  * Returns      : none
 *******************************************************************************/
-void node_remove_from_list(list_node **phead, list_node *pdelete)
+static void lease_set_expiry(dhcps_t *dhcps, lease_entry *lease, u32_t expiry)
 {
-    list_node *plist = NULL;
+    lease->pool.lease_timer = expiry;
+    lease_heap_sift(dhcps, lease->heap_pos);
+}
+
+#if CONFIG_LWIP_DHCPS_RESTORE_LEASES
+/******************************************************************************
+ * FunctionName : dhcps_leases_save
+ * Description  : hand a snapshot of the leases to the NVS writer task if
+ *                they changed since the last call
+ * Parameters   : none
+ * Returns      : none
+*******************************************************************************/
+static void dhcps_leases_save(dhcps_t *dhcps)
+{
+    if (!dhcps->leases_changed) {
+        return;
+    }
 
-    plist = *phead;
+    struct dhcps_pool *pools = mem_malloc(MAX_STATION_NUM * sizeof(struct dhcps_pool));
+    if (pools == NULL) {
+        return;
+    }
+
+    /* the remaining lease time is stored, the time spent while the server is not running is not accounted */
+    for (lease_idx_t i = 0; i < dhcps->num_leases; i++) {
+        pools[i] = dhcps->leases[dhcps->expiry_heap[i]].pool;
+        pools[i].lease_timer -= dhcps->ticks;
+    }
 
-    if (plist == NULL) {
-        *phead = NULL;
+    /* the write is done by a worker task, which frees the snapshot. If it cannot be queued, the leases stay changed and the timer retries */
+    if (dhcps_leases_store(dhcps->dhcps_netif, pools, dhcps->num_leases)) {
+        dhcps->leases_changed = false;
     } else {
-        if (plist == pdelete) {
-            // Note: Ignoring the "use after free" warnings, as it could only happen
-            // if the linked list contains loops
-            *phead = plist->pnext; // NOLINT(clang-analyzer-unix.Malloc)
-            pdelete->pnext = NULL;
-        } else {
-            while (plist != NULL) {
-                if (plist->pnext == pdelete) { // NOLINT(clang-analyzer-unix.Malloc)
-                    plist->pnext = pdelete->pnext;
-                    pdelete->pnext = NULL;
-                }
+        mem_free(pools);
+    }
+}
 
-                plist = plist->pnext;
-            }
+/******************************************************************************
+ * FunctionName : dhcps_leases_load
+ * Description  : restore the leases stored in NVS, the leases not in the
+ *                address pool are dropped
+ * Parameters   : none
+ * Returns      : none
+*******************************************************************************/
+static void dhcps_leases_load(dhcps_t *dhcps)
+{
+    struct dhcps_pool *pools = mem_malloc(MAX_STATION_NUM * sizeof(struct dhcps_pool));
+    if (pools == NULL) {
+        return;
+    }
+
+    u16_t num = dhcps_leases_restore(dhcps->dhcps_netif, pools, MAX_STATION_NUM);
+
+    for (u16_t i = 0; i < num; i++) {
+        if (pools[i].lease_timer == 0
+            || pools[i].ip.addr < dhcps->dhcps_poll.start_ip.addr || pools[i].ip.addr > dhcps->dhcps_poll.end_ip.addr
+            || lease_find_by_mac(dhcps, pools[i].mac) != NULL || lease_find_by_ip(dhcps, pools[i].ip.addr) != NULL) {
+            continue;
         }
+        lease_add(dhcps, &pools[i].ip, pools[i].mac, dhcps->ticks + pools[i].lease_timer);
     }
+
+    mem_free(pools);
+    dhcps->leases_changed = false;
 }
+#endif /* CONFIG_LWIP_DHCPS_RESTORE_LEASES */
 
 /******************************************************************************
  * FunctionName : add_msg_type
@@ -1013,49 +1238,36 @@ static s16_t parse_msg(dhcps_t *dhcps, struct dhcps_msg *m, u16_t len)
 #endif
         ip4_addr_t addr_tmp;
 
-        struct dhcps_pool *pdhcps_pool = NULL;
-        list_node *pnode = NULL;
-        list_node *pback_node = NULL;
+        lease_entry *lease = NULL;
         ip4_addr_t first_address;
-        bool flag = false;
 
         first_address.addr = dhcps->dhcps_poll.start_ip.addr;
         dhcps->client_address.addr = dhcps->client_address_plus.addr;
         dhcps->renew = false;
 
-        if (dhcps->plist != NULL) {
+        if (dhcps->num_leases != 0) {
             if (dhcps->has_declined_ip) {
                 dhcps->has_declined_ip = false;
             }
 
-            for (pback_node = dhcps->plist; pback_node != NULL; pback_node = pback_node->pnext) {
-                pdhcps_pool = pback_node->pnode;
-
-                if (memcmp(pdhcps_pool->mac, m->chaddr, sizeof(pdhcps_pool->mac)) == 0) {
-                    if (memcmp(&pdhcps_pool->ip.addr, m->ciaddr, sizeof(pdhcps_pool->ip.addr)) == 0) {
-                        dhcps->renew = true;
-                    }
-
-                    dhcps->client_address.addr = pdhcps_pool->ip.addr;
-                    pdhcps_pool->lease_timer = lease_timer;
-                    pnode = pback_node;
-                    goto POOL_CHECK;
-                } else if (pdhcps_pool->ip.addr == dhcps->client_address_plus.addr) {
-                    addr_tmp.addr = htonl(dhcps->client_address_plus.addr);
-                    addr_tmp.addr++;
-                    dhcps->client_address_plus.addr = htonl(addr_tmp.addr);
-                    dhcps->client_address.addr = dhcps->client_address_plus.addr;
-                }
+            lease = lease_find_by_mac(dhcps, m->chaddr);
 
-                if (flag == false) { // search the first unused ip
-                    if (first_address.addr < pdhcps_pool->ip.addr) {
-                        flag = true;
-                    } else {
-                        addr_tmp.addr = htonl(first_address.addr);
-                        addr_tmp.addr++;
-                        first_address.addr = htonl(addr_tmp.addr);
-                    }
+            if (lease != NULL) {
+                if (memcmp(&lease->pool.ip.addr, m->ciaddr, sizeof(lease->pool.ip.addr)) == 0) {
+                    dhcps->renew = true;
                 }
+
+                dhcps->client_address.addr = lease->pool.ip.addr;
+                lease_set_expiry(dhcps, lease, dhcps->ticks + lease_timer);
+                goto POOL_CHECK;
+            }
+
+            // skip the addresses already leased from client_address_plus on
+            for (lease_idx_t i = 0; i < dhcps->num_leases && lease_find_by_ip(dhcps, dhcps->client_address_plus.addr) != NULL; i++) {
+                addr_tmp.addr = htonl(dhcps->client_address_plus.addr);
+                addr_tmp.addr++;
+                dhcps->client_address_plus.addr = htonl(addr_tmp.addr);
+                dhcps->client_address.addr = dhcps->client_address_plus.addr;
             }
         } else {
             if (dhcps->has_declined_ip) {
@@ -1066,24 +1278,20 @@ static s16_t parse_msg(dhcps_t *dhcps, struct dhcps_msg *m, u16_t len)
         }
 
         if (dhcps->client_address_plus.addr > dhcps->dhcps_poll.end_ip.addr) {
+            // search the first unused ip
+            for (lease_idx_t i = 0; i < dhcps->num_leases && lease_find_by_ip(dhcps, first_address.addr) != NULL; i++) {
+                addr_tmp.addr = htonl(first_address.addr);
+                addr_tmp.addr++;
+                first_address.addr = htonl(addr_tmp.addr);
+            }
             dhcps->client_address.addr = first_address.addr;
         }
 
         if (dhcps->client_address.addr > dhcps->dhcps_poll.end_ip.addr) {
             dhcps->client_address_plus.addr = dhcps->dhcps_poll.start_ip.addr;
-            pdhcps_pool = NULL;
-            pnode = NULL;
+            lease = NULL;
         } else {
-            pdhcps_pool = (struct dhcps_pool *)mem_calloc(1, sizeof(struct dhcps_pool));
-
-            pdhcps_pool->ip.addr = dhcps->client_address.addr;
-            memcpy(pdhcps_pool->mac, m->chaddr, sizeof(pdhcps_pool->mac));
-            pdhcps_pool->lease_timer = lease_timer;
-            pnode = (list_node *)mem_calloc(1, sizeof(list_node));
-
-            pnode->pnode = pdhcps_pool;
-            pnode->pnext = NULL;
-            node_insert_to_list(&dhcps->plist, pnode);
+            lease = lease_add(dhcps, &dhcps->client_address, m->chaddr, dhcps->ticks + lease_timer);
 
             if (dhcps->client_address.addr == dhcps->dhcps_poll.end_ip.addr) {
                 dhcps->client_address_plus.addr = dhcps->dhcps_poll.start_ip.addr;
@@ -1097,15 +1305,9 @@ static s16_t parse_msg(dhcps_t *dhcps, struct dhcps_msg *m, u16_t len)
 POOL_CHECK:
 
         if ((dhcps->client_address.addr > dhcps->dhcps_poll.end_ip.addr) || (ip4_addr_isany(&dhcps->client_address))) {
-            if (pnode != NULL) {
-                node_remove_from_list(&dhcps->plist, pnode);
-                free(pnode);
-                pnode = NULL;
-            }
-
-            if (pdhcps_pool != NULL) {
-                free(pdhcps_pool);
-                pdhcps_pool = NULL;
+            if (lease != NULL) {
+                lease_remove(dhcps, lease);
+                lease = NULL;
             }
 
             return 4;
@@ -1114,15 +1316,9 @@ POOL_CHECK:
         s16_t ret = parse_options(dhcps, &m->options[4], len);;
 
         if (ret == DHCPS_STATE_RELEASE || ret == DHCPS_STATE_NAK || ret ==  DHCPS_STATE_DECLINE) {
-            if (pnode != NULL) {
-                node_remove_from_list(&dhcps->plist, pnode);
-                free(pnode);
-                pnode = NULL;
-            }
-
-            if (pdhcps_pool != NULL) {
-                free(pdhcps_pool);
-                pdhcps_pool = NULL;
+            if (lease != NULL) {
+                lease_remove(dhcps, lease);
+                lease = NULL;
             }
 
             if (ret ==  DHCPS_STATE_DECLINE) {
@@ -1382,6 +1578,9 @@ err_t dhcps_start(dhcps_t *dhcps, struct netif *netif, ip4_addr_t ip)
     dhcps_poll_set(dhcps, dhcps->server_address.addr);
 
     dhcps->client_address_plus.addr = dhcps->dhcps_poll.start_ip.addr;
+#if CONFIG_LWIP_DHCPS_RESTORE_LEASES
+    dhcps_leases_load(dhcps);
+#endif
 
     udp_bind_netif(dhcps->dhcps_pcb, dhcps->dhcps_netif);
     udp_bind(dhcps->dhcps_pcb, &netif->ip_addr, DHCPS_SERVER_PORT);
@@ -1415,67 +1614,18 @@ err_t dhcps_stop(dhcps_t *dhcps, struct netif *netif)
         dhcps->dhcps_pcb = NULL;
     }
 
-    list_node *pnode = NULL;
-    list_node *pback_node = NULL;
-    pnode = dhcps->plist;
-
-    while (pnode != NULL) {
-        pback_node = pnode;
-        pnode = pback_node->pnext;
-        node_remove_from_list(&dhcps->plist, pback_node);
-        free(pback_node->pnode);
-        pback_node->pnode = NULL;
-        free(pback_node);
-        pback_node = NULL;
-    }
+#if CONFIG_LWIP_DHCPS_RESTORE_LEASES
+    dhcps_leases_save(dhcps);
+#endif
+    lease_table_reset(dhcps);
     sys_untimeout(dhcps_tmr, dhcps);
     dhcps->state = DHCPS_HANDLE_STOPPED;
     return ERR_OK;
 }
 
-/******************************************************************************
- * FunctionName : kill_oldest_dhcps_pool
- * Description  : remove the oldest node from list
- * Parameters   : none
- * Returns      : none
-*******************************************************************************/
-static void kill_oldest_dhcps_pool(dhcps_t *dhcps)
-{
-    list_node *pre = NULL, *p = NULL;
-    list_node *minpre = NULL, *minp = NULL;
-    struct dhcps_pool *pdhcps_pool = NULL, *pmin_pool = NULL;
-    pre = dhcps->plist;
-    assert(pre != NULL && pre->pnext != NULL); // Expect the list to have at least 2 nodes
-    p = pre->pnext;
-    minpre = pre;
-    minp = pre;
-
-    while (p != NULL) {
-        pdhcps_pool = p->pnode;
-        pmin_pool = minp->pnode;
-
-        if (pdhcps_pool->lease_timer < pmin_pool->lease_timer) {
-            minp = p;
-            minpre = pre;
-        }
-
-        pre = p;
-        p = p->pnext;
-    }
-    if (minp == dhcps->plist) {
-        dhcps->plist = minp->pnext;
-    } else {
-        minpre->pnext = minp->pnext;
-    }
-    free(minp->pnode);
-    minp->pnode = NULL;
-    free(minp);
-    minp = NULL;
-}
-
 /******************************************************************************
  * FunctionName : dhcps_coarse_tmr
- * Description  : the lease time count
+ * Description  : the lease time count, drops the expired leases
  * Parameters   : none
  * Returns      : none
 *******************************************************************************/
@@ -1492,33 +1642,17 @@ static void dhcps_tmr(void *arg)
         return;
     }
     sys_timeout(DHCP_COARSE_TIMER_MSECS, dhcps_tmr, dhcps);
-    u8_t num_dhcps_pool = 0;
-    list_node *pback_node = NULL;
-    list_node *pnode = NULL;
-    struct dhcps_pool *pdhcps_pool = NULL;
-    pnode = dhcps->plist;
-
-    while (pnode != NULL) {
-        pdhcps_pool = pnode->pnode;
-        pdhcps_pool->lease_timer --;
-
-        if (pdhcps_pool->lease_timer == 0) {
-            pback_node = pnode;
-            pnode = pback_node->pnext;
-            node_remove_from_list(&dhcps->plist, pback_node);
-            free(pback_node->pnode);
-            pback_node->pnode = NULL;
-            free(pback_node);
-            pback_node = NULL;
-        } else {
-            pnode = pnode ->pnext;
-            num_dhcps_pool ++;
-        }
+    dhcps->ticks++;
+
+    while (dhcps->num_leases != 0 && (s32_t)(dhcps->ticks - dhcps->leases[dhcps->expiry_heap[0]].pool.lease_timer) >= 0) {
+        lease_remove(dhcps, &dhcps->leases[dhcps->expiry_heap[0]]);
     }
 
-    if (num_dhcps_pool > MAX_STATION_NUM) {
-        kill_oldest_dhcps_pool(dhcps);
+#if CONFIG_LWIP_DHCPS_RESTORE_LEASES
+    if (dhcps->leases_changed && (s32_t)(dhcps->ticks - dhcps->leases_save_tick) >= 0) {
+        dhcps_leases_save(dhcps);
     }
+#endif
 }
 
 /******************************************************************************
@@ -1530,25 +1664,20 @@ static void dhcps_tmr(void *arg)
 *******************************************************************************/
 bool dhcp_search_ip_on_mac(dhcps_t *dhcps, u8_t *mac, ip4_addr_t *ip)
 {
-    struct dhcps_pool *pdhcps_pool = NULL;
-    list_node *pback_node = NULL;
-    bool ret = false;
+    lease_entry *lease = NULL;
 
     if (dhcps == NULL) {
         return false;
     }
 
-    for (pback_node = dhcps->plist; pback_node != NULL; pback_node = pback_node->pnext) {
-        pdhcps_pool = pback_node->pnode;
+    lease = lease_find_by_mac(dhcps, mac);
 
-        if (memcmp(pdhcps_pool->mac, mac, sizeof(pdhcps_pool->mac)) == 0) {
-            memcpy(&ip->addr, &pdhcps_pool->ip.addr, sizeof(pdhcps_pool->ip.addr));
-            ret = true;
-            break;
-        }
+    if (lease == NULL) {
+        return false;
     }
 
-    return ret;
+    memcpy(&ip->addr, &lease->pool.ip.addr, sizeof(lease->pool.ip.addr));
+    return true;
 }
 
 /******************************************************************************
@@ -70,7 +70,12 @@ typedef enum
  * @brief Definitions related to lease time, units and limits
  */
 #define DHCPS_COARSE_TIMER_SECS  1
+/* the address pool holds at least one address per station */
+#if CONFIG_LWIP_DHCPS_MAX_STATION_NUM > 0x64
+#define DHCPS_MAX_LEASE CONFIG_LWIP_DHCPS_MAX_STATION_NUM
+#else
 #define DHCPS_MAX_LEASE 0x64
+#endif
 #define DHCPS_LEASE_TIME_DEF (120)
 #define DHCPS_LEASE_UNIT CONFIG_LWIP_DHCPS_LEASE_UNIT
 
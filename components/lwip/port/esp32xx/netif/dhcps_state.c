@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "nvs.h"
+#include "lwip/netif.h"
+#include "lwip/mem.h"
+#include "netif/dhcps_state.h"
+
+#define DHCPS_NAMESPACE "dhcps_state"
+#define IF_KEY_SIZE 3
+
+/* Leases are written by a worker task, so that NVS writes and flash erases do not stall the tcpip thread */
+#define DHCPS_STORE_TASK_STACK_SIZE 3072
+#define DHCPS_STORE_TASK_PRIO       (tskIDLE_PRIORITY + 1)
+#define DHCPS_STORE_QUEUE_LEN       4
+
+typedef struct {
+    u8_t netif_num;
+    u16_t num_leases;
+    struct dhcps_pool *leases;
+} dhcps_store_job_t;
+
+static QueueHandle_t s_store_queue;
+/* jobs posted and not yet written, restore waits for them so that it reads the latest leases */
+static atomic_uint s_store_pending;
+
+/*
+ * As a NVS key, use string representation of the interface index number
+ */
+static inline char *gen_if_key(u8_t netif_num, char *name)
+{
+    lwip_itoa(name, IF_KEY_SIZE, netif_num);
+    return name;
+}
+
+static void dhcps_store_task(void *arg)
+{
+    dhcps_store_job_t job;
+    nvs_handle_t nvs;
+    char if_key[IF_KEY_SIZE];
+
+    while (xQueueReceive(s_store_queue, &job, portMAX_DELAY) == pdTRUE) {
+        if (nvs_open(DHCPS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+            if (job.num_leases != 0) {
+                nvs_set_blob(nvs, gen_if_key(job.netif_num, if_key), job.leases, job.num_leases * sizeof(struct dhcps_pool));
+            } else {
+                nvs_erase_key(nvs, gen_if_key(job.netif_num, if_key));
+            }
+            nvs_commit(nvs);
+            nvs_close(nvs);
+        }
+        mem_free(job.leases);
+        atomic_fetch_sub(&s_store_pending, 1);
+    }
+}
+
+u16_t dhcps_leases_restore(struct netif *netif, struct dhcps_pool *leases, u16_t max_leases)
+{
+    nvs_handle_t nvs;
+    char if_key[IF_KEY_SIZE];
+    size_t size = max_leases * sizeof(struct dhcps_pool);
+    u16_t num_leases = 0;
+    if (netif == NULL) {
+        return 0;
+    }
+
+    while (atomic_load(&s_store_pending) != 0) {
+        vTaskDelay(1);
+    }
+
+    if (nvs_open(DHCPS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+        /* the blob is not read if it holds more leases than the table does */
+        if (nvs_get_blob(nvs, gen_if_key(netif->num, if_key), leases, &size) == ESP_OK) {
+            num_leases = size / sizeof(struct dhcps_pool);
+        }
+        nvs_close(nvs);
+    }
+    return num_leases;
+}
+
+bool dhcps_leases_store(struct netif *netif, struct dhcps_pool *leases, u16_t num_leases)
+{
+    if (netif == NULL) {
+        return false;
+    }
+
+    /* the store is only called from the tcpip thread, so the worker is created once */
+    if (s_store_queue == NULL) {
+        s_store_queue = xQueueCreate(DHCPS_STORE_QUEUE_LEN, sizeof(dhcps_store_job_t));
+        if (s_store_queue == NULL) {
+            return false;
+        }
+        if (xTaskCreate(dhcps_store_task, "dhcps_store", DHCPS_STORE_TASK_STACK_SIZE, NULL,
+                        DHCPS_STORE_TASK_PRIO, NULL) != pdPASS) {
+            vQueueDelete(s_store_queue);
+            s_store_queue = NULL;
+            return false;
+        }
+    }
+
+    dhcps_store_job_t job = {
+        .netif_num = netif->num,
+        .num_leases = num_leases,
+        .leases = leases,
+    };
+    atomic_fetch_add(&s_store_pending, 1);
+    if (xQueueSend(s_store_queue, &job, 0) != pdTRUE) {
+        atomic_fetch_sub(&s_store_pending, 1);
+        return false;
+    }
+    return true;
+}
@@ -3,7 +3,7 @@
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
- * SPDX-FileContributor: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileContributor: 2018-2025 Espressif Systems (Shanghai) CO LTD
  */
 #ifndef __SYS_ARCH_H__
 #define __SYS_ARCH_H__
@@ -22,9 +22,43 @@ typedef SemaphoreHandle_t sys_sem_t;
 typedef SemaphoreHandle_t sys_mutex_t;
 typedef TaskHandle_t sys_thread_t;
 
+#if CONFIG_LWIP_MBOX_STATS
+/** Statistics of a mailbox, see sys_mbox_get_stats() */
+typedef struct {
+  uint32_t posted;            /**< Messages posted */
+  uint32_t fetched;           /**< Messages fetched */
+  uint32_t dropped;           /**< Messages not posted because the mailbox was full */
+  uint32_t post_waits;        /**< Times a sender waited for room in the mailbox */
+  uint32_t fetch_waits;       /**< Times a receiver waited for a message (wake-ups of the receiving task) */
+  uint32_t max_depth;         /**< Largest number of messages queued at once */
+  uint32_t max_latency_us;    /**< Longest time a message stayed in the mailbox, in microseconds */
+  uint64_t total_latency_us;  /**< Sum of the times the fetched messages stayed in the mailbox, in microseconds */
+} sys_mbox_stats_t;
+#endif /* CONFIG_LWIP_MBOX_STATS */
+
+#if CONFIG_LWIP_MBOX_RING_BUFFER
+/* Messages are kept in a ring protected by a spinlock, the semaphores are only used
+ * to wake up the tasks waiting for a message or for room in the mailbox */
+typedef struct sys_mbox_s {
+  portMUX_TYPE lock;
+  uint16_t size;
+  uint16_t head;
+  uint16_t count;
+  uint16_t rx_waiters;
+  uint16_t tx_waiters;
+  SemaphoreHandle_t not_empty;
+  SemaphoreHandle_t not_full;
+#if CONFIG_LWIP_MBOX_STATS
+  sys_mbox_stats_t stats;
+  uint32_t *post_time;
+#endif
+  void **msgs;
+}* sys_mbox_t;
+#else
 typedef struct sys_mbox_s {
   QueueHandle_t os_mbox;
 }* sys_mbox_t;
+#endif /* CONFIG_LWIP_MBOX_RING_BUFFER */
 
 /** This is returned by _fromisr() sys functions to tell the outermost function
  * that a higher priority task was woken and the scheduler needs to be invoked.
@@ -49,6 +83,24 @@ void sys_delay_ms(uint32_t ms);
 #define sys_sem_valid(sema)       (((sema) != NULL) && sys_sem_valid_val(*(sema)))
 #define sys_sem_set_invalid(sema) ((*(sema)) = NULL)
 
+#if CONFIG_LWIP_MBOX_STATS
+/**
+ * @brief Get the statistics of a mailbox
+ *
+ * @param mbox pointer of the mailbox
+ * @param stats filled with the statistics of the mailbox
+ */
+void sys_mbox_get_stats(sys_mbox_t *mbox, sys_mbox_stats_t *stats);
+
+/**
+ * @brief Get the statistics of the mailbox of the TCPIP task
+ *
+ * @param stats filled with the statistics of the mailbox
+ * @return false if the TCPIP task has not fetched any message yet
+ */
+bool sys_tcpip_mbox_get_stats(sys_mbox_stats_t *stats);
+#endif /* CONFIG_LWIP_MBOX_STATS */
+
 void sys_delay_ms(uint32_t ms);
 sys_sem_t* sys_thread_sem_init(void);
 void sys_thread_sem_deinit(void);
@@ -60,6 +112,7 @@ typedef enum {
     LWIP_CORE_LOCK_UNMARK_HOLDER,
     LWIP_CORE_MARK_TCPIP_TASK,
     LWIP_CORE_IS_TCPIP_INITIALIZED,
+    LWIP_CORE_IS_TCPIP_TASK,
 } sys_thread_core_lock_t;
 
 bool
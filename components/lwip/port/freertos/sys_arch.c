@@ -3,7 +3,7 @@
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
- * SPDX-FileContributor: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileContributor: 2018-2025 Espressif Systems (Shanghai) CO LTD
  */
 
 /* lwIP includes. */
@@ -22,6 +22,13 @@
 #include "arch/vfs_lwip.h"
 #include "esp_log.h"
 #include "esp_compiler.h"
+#if CONFIG_LWIP_MBOX_STATS
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#endif
+#endif
 
 static const char* TAG = "lwip_arch";
 
@@ -195,6 +202,447 @@ sys_sem_free(sys_sem_t *sem)
   *sem = NULL;
 }
 
+#if CONFIG_LWIP_MBOX_RING_BUFFER
+
+#if CONFIG_LWIP_MBOX_STATS
+static sys_mbox_t s_tcpip_mbox;
+
+static inline u32_t
+mbox_time_us(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u32_t)(ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+#else
+  return (u32_t)esp_timer_get_time();
+#endif
+}
+#endif /* CONFIG_LWIP_MBOX_STATS */
+
+/*
+ * Appends a message to the ring, the lock of the mailbox must be held.
+ * Returns false if the mailbox is full.
+ */
+static inline bool
+mbox_push_locked(sys_mbox_t mb, void *msg, u32_t now)
+{
+  if (mb->count == mb->size) {
+    return false;
+  }
+
+  u32_t tail = mb->head + mb->count;
+  if (tail >= mb->size) {
+    tail -= mb->size;
+  }
+  mb->msgs[tail] = msg;
+  mb->count++;
+
+#if CONFIG_LWIP_MBOX_STATS
+  mb->post_time[tail] = now;
+  mb->stats.posted++;
+  if (mb->count > mb->stats.max_depth) {
+    mb->stats.max_depth = mb->count;
+  }
+#endif
+  return true;
+}
+
+/*
+ * Takes the oldest message from the ring, the lock of the mailbox must be held.
+ * Returns false if the ring is empty.
+ */
+static inline bool
+mbox_pop_locked(sys_mbox_t mb, void **msg, u32_t now)
+{
+  if (mb->count == 0) {
+    return false;
+  }
+
+  *msg = mb->msgs[mb->head];
+#if CONFIG_LWIP_MBOX_STATS
+  u32_t latency = now - mb->post_time[mb->head];
+  if ((int32_t)latency < 0) {
+    /* posted after the consumer read the time but before it took the lock */
+    latency = 0;
+  }
+  mb->stats.total_latency_us += latency;
+  if (latency > mb->stats.max_latency_us) {
+    mb->stats.max_latency_us = latency;
+  }
+  mb->stats.fetched++;
+#endif
+  mb->head = (mb->head + 1 == mb->size) ? 0 : mb->head + 1;
+  mb->count--;
+  return true;
+}
+
+/**
+ * @brief Create an empty mailbox.
+ *
+ * @param mbox pointer of the mailbox
+ * @param size size of the mailbox
+ * @return ERR_OK on success, ERR_MEM when out of memory
+ */
+err_t
+sys_mbox_new(sys_mbox_t *mbox, int size)
+{
+  size_t alloc_size = sizeof(struct sys_mbox_s) + size * sizeof(void *);
+#if CONFIG_LWIP_MBOX_STATS
+  alloc_size += size * sizeof(u32_t);
+#endif
+
+  LWIP_ASSERT("mbox size out of range", size > 0 && size <= UINT16_MAX);
+  *mbox = mem_calloc(1, alloc_size);
+  if (*mbox == NULL){
+    LWIP_DEBUGF(ESP_THREAD_SAFE_DEBUG, ("fail to new *mbox\n"));
+    return ERR_MEM;
+  }
+
+  sys_mbox_t mb = *mbox;
+  portMUX_INITIALIZE(&mb->lock);
+  mb->size = size;
+  mb->msgs = (void **)(mb + 1);
+#if CONFIG_LWIP_MBOX_STATS
+  mb->post_time = (u32_t *)(mb->msgs + size);
+#endif
+  mb->not_empty = xSemaphoreCreateBinary();
+  mb->not_full = xSemaphoreCreateBinary();
+
+  if (mb->not_empty == NULL || mb->not_full == NULL) {
+    LWIP_DEBUGF(ESP_THREAD_SAFE_DEBUG, ("fail to new (*mbox) semaphores\n"));
+    if (mb->not_empty) {
+      vSemaphoreDelete(mb->not_empty);
+    }
+    if (mb->not_full) {
+      vSemaphoreDelete(mb->not_full);
+    }
+    free(mb);
+    *mbox = NULL;
+    return ERR_MEM;
+  }
+
+  LWIP_DEBUGF(ESP_THREAD_SAFE_DEBUG, ("new *mbox ok mbox=%p size=%d\n", *mbox, size));
+  return ERR_OK;
+}
+
+/**
+ * @brief Send message to mailbox
+ *
+ * @param mbox pointer of the mailbox
+ * @param msg pointer of the message to send
+ */
+void
+sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+  sys_mbox_t mb = *mbox;
+  u32_t now = 0;
+  bool posted;
+  bool wake_rx = false;
+  bool wake_tx = false;
+
+#if CONFIG_LWIP_MBOX_STATS
+  now = mbox_time_us();
+#endif
+
+  for (;;) {
+    portENTER_CRITICAL(&mb->lock);
+    posted = mbox_push_locked(mb, msg, now);
+    if (posted) {
+      wake_rx = mb->rx_waiters > 0;
+      /* pass the wake-up on to the next waiting sender if there is still room */
+      wake_tx = mb->tx_waiters > 0 && mb->count < mb->size;
+    } else {
+      mb->tx_waiters++;
+#if CONFIG_LWIP_MBOX_STATS
+      mb->stats.post_waits++;
+#endif
+    }
+    portEXIT_CRITICAL(&mb->lock);
+
+    if (posted) {
+      break;
+    }
+
+    BaseType_t ret = xSemaphoreTake(mb->not_full, portMAX_DELAY);
+    LWIP_ASSERT("mbox post failed", ret == pdTRUE);
+    (void)ret;
+
+    portENTER_CRITICAL(&mb->lock);
+    mb->tx_waiters--;
+    portEXIT_CRITICAL(&mb->lock);
+  }
+
+  if (wake_rx) {
+    xSemaphoreGive(mb->not_empty);
+  }
+  if (wake_tx) {
+    xSemaphoreGive(mb->not_full);
+  }
+}
+
+/**
+ * @brief Try to post a message to mailbox
+ *
+ * @param mbox pointer of the mailbox
+ * @param msg pointer of the message to send
+ * @return ERR_OK on success, ERR_MEM when mailbox is full
+ */
+err_t
+sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+  sys_mbox_t mb = *mbox;
+  u32_t now = 0;
+  bool posted;
+  bool wake_rx;
+
+#if CONFIG_LWIP_MBOX_STATS
+  now = mbox_time_us();
+#endif
+
+  portENTER_CRITICAL(&mb->lock);
+  posted = mbox_push_locked(mb, msg, now);
+  wake_rx = posted && mb->rx_waiters > 0;
+#if CONFIG_LWIP_MBOX_STATS
+  if (!posted) {
+    mb->stats.dropped++;
+  }
+#endif
+  portEXIT_CRITICAL(&mb->lock);
+
+  if (!posted) {
+    LWIP_DEBUGF(ESP_THREAD_SAFE_DEBUG, ("trypost mbox=%p fail\n", mb));
+    return ERR_MEM;
+  }
+
+  if (wake_rx) {
+    xSemaphoreGive(mb->not_empty);
+  }
+  return ERR_OK;
+}
+
+/**
+ * @brief Try to post a message to mailbox from ISR
+ *
+ * @param mbox pointer of the mailbox
+ * @param msg pointer of the message to send
+ * @return  ERR_OK on success
+ *          ERR_MEM when mailbox is full
+ *          ERR_NEED_SCHED when high priority task wakes up
+ */
+err_t
+sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg)
+{
+  sys_mbox_t mb = *mbox;
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  u32_t now = 0;
+  bool posted;
+  bool wake_rx;
+
+#if CONFIG_LWIP_MBOX_STATS
+  now = mbox_time_us();
+#endif
+
+  portENTER_CRITICAL_ISR(&mb->lock);
+  posted = mbox_push_locked(mb, msg, now);
+  wake_rx = posted && mb->rx_waiters > 0;
+#if CONFIG_LWIP_MBOX_STATS
+  if (!posted) {
+    mb->stats.dropped++;
+  }
+#endif
+  portEXIT_CRITICAL_ISR(&mb->lock);
+
+  if (!posted) {
+    return ERR_MEM;
+  }
+
+  if (wake_rx) {
+    xSemaphoreGiveFromISR(mb->not_empty, &xHigherPriorityTaskWoken);
+  }
+  if (xHigherPriorityTaskWoken == pdTRUE) {
+    return ERR_NEED_SCHED;
+  }
+  return ERR_OK;
+}
+
+/*
+ * Takes a message, waiting at most timeout_ticks for it.
+ * Returns false on timeout.
+ */
+static bool
+mbox_fetch(sys_mbox_t mb, void **msg, TickType_t timeout_ticks)
+{
+  TimeOut_t timeout_state;
+  u32_t now = 0;
+  bool fetched;
+  bool wake_rx = false;
+  bool wake_tx = false;
+
+  vTaskSetTimeOutState(&timeout_state);
+
+  for (;;) {
+#if CONFIG_LWIP_MBOX_STATS
+    now = mbox_time_us();
+#endif
+    portENTER_CRITICAL(&mb->lock);
+    fetched = mbox_pop_locked(mb, msg, now);
+    if (fetched) {
+      wake_tx = mb->tx_waiters > 0;
+      /* pass the wake-up on to the next waiting receiver if messages are left */
+      wake_rx = mb->rx_waiters > 0 && mb->count > 0;
+    } else if (timeout_ticks != 0) {
+      mb->rx_waiters++;
+#if CONFIG_LWIP_MBOX_STATS
+      mb->stats.fetch_waits++;
+#endif
+    }
+    portEXIT_CRITICAL(&mb->lock);
+
+    if (fetched) {
+      if (wake_tx) {
+        xSemaphoreGive(mb->not_full);
+      }
+      if (wake_rx) {
+        xSemaphoreGive(mb->not_empty);
+      }
+      return true;
+    }
+
+    if (timeout_ticks == 0) {
+      return false;
+    }
+
+    /* the semaphore may have been given for a message taken by another receiver, so check the ring again
+     * on wake-up, xTaskCheckForTimeOut() updates timeout_ticks to the remaining time */
+    BaseType_t ret = xSemaphoreTake(mb->not_empty, timeout_ticks);
+
+    portENTER_CRITICAL(&mb->lock);
+    mb->rx_waiters--;
+    portEXIT_CRITICAL(&mb->lock);
+
+    if (ret != pdTRUE || (timeout_ticks != portMAX_DELAY && xTaskCheckForTimeOut(&timeout_state, &timeout_ticks) == pdTRUE)) {
+      /* last look at the ring, without waiting */
+      timeout_ticks = 0;
+    }
+  }
+}
+
+/**
+ * @brief Fetch message from mailbox
+ *
+ * @param mbox pointer of mailbox
+ * @param msg pointer of the received message, could be NULL to indicate the message should be dropped
+ * @param timeout if zero, will wait infinitely; or will wait milliseconds specify by this argument
+ * @return SYS_ARCH_TIMEOUT when timeout, 0 otherwise
+ */
+u32_t
+sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+  void *msg_dummy;
+
+  if (msg == NULL) {
+    msg = &msg_dummy;
+  }
+
+#if CONFIG_LWIP_MBOX_STATS
+  if (unlikely(s_tcpip_mbox != *mbox) && sys_thread_tcpip(LWIP_CORE_IS_TCPIP_TASK)) {
+    /* the TCPIP task only waits on its own mailbox */
+    s_tcpip_mbox = *mbox;
+  }
+#endif
+
+  if (!mbox_fetch(*mbox, msg, timeout == 0 ? portMAX_DELAY : timeout / portTICK_PERIOD_MS)) {
+    /* timed out */
+    *msg = NULL;
+    return SYS_ARCH_TIMEOUT;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief try to fetch message from mailbox
+ *
+ * @param mbox pointer of mailbox
+ * @param msg pointer of the received message
+ * @return SYS_MBOX_EMPTY if mailbox is empty, 1 otherwise
+ */
+u32_t
+sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+  void *msg_dummy;
+
+  if (msg == NULL) {
+    msg = &msg_dummy;
+  }
+
+  if (!mbox_fetch(*mbox, msg, 0)) {
+    *msg = NULL;
+    return SYS_MBOX_EMPTY;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Delete a mailbox
+ *
+ * @param mbox pointer of the mailbox to delete
+ */
+void
+sys_mbox_free(sys_mbox_t *mbox)
+{
+  if ((NULL == mbox) || (NULL == *mbox)) {
+    return;
+  }
+  LWIP_ASSERT("mbox quence not empty", (*mbox)->count == 0);
+
+#if CONFIG_LWIP_MBOX_STATS
+  if (s_tcpip_mbox == *mbox) {
+    s_tcpip_mbox = NULL;
+  }
+#endif
+  vSemaphoreDelete((*mbox)->not_empty);
+  vSemaphoreDelete((*mbox)->not_full);
+  free(*mbox);
+  *mbox = NULL;
+}
+
+#if CONFIG_LWIP_MBOX_STATS
+/**
+ * @brief Get the statistics of a mailbox
+ *
+ * @param mbox pointer of the mailbox
+ * @param stats filled with the statistics of the mailbox
+ */
+void
+sys_mbox_get_stats(sys_mbox_t *mbox, sys_mbox_stats_t *stats)
+{
+  portENTER_CRITICAL(&(*mbox)->lock);
+  *stats = (*mbox)->stats;
+  portEXIT_CRITICAL(&(*mbox)->lock);
+}
+
+/**
+ * @brief Get the statistics of the mailbox of the TCPIP task
+ *
+ * @param stats filled with the statistics of the mailbox
+ * @return false if the TCPIP task has not fetched any message yet
+ */
+bool
+sys_tcpip_mbox_get_stats(sys_mbox_stats_t *stats)
+{
+  if (s_tcpip_mbox == NULL) {
+    return false;
+  }
+  sys_mbox_get_stats(&s_tcpip_mbox, stats);
+  return true;
+}
+#endif /* CONFIG_LWIP_MBOX_STATS */
+
+#else
+
 /**
  * @brief Create an empty mailbox.
  *
@@ -369,6 +817,8 @@ sys_mbox_free(sys_mbox_t *mbox)
   (void)msgs_waiting;
 }
 
+#endif /* CONFIG_LWIP_MBOX_RING_BUFFER */
+
 /**
  * @brief Create a new thread
  *
@@ -550,6 +1000,8 @@ sys_thread_tcpip(sys_thread_core_lock_t type)
             return false;
         case LWIP_CORE_IS_TCPIP_INITIALIZED:
             return lwip_task != NULL;
+        case LWIP_CORE_IS_TCPIP_TASK:
+            return lwip_task != NULL && lwip_task == (sys_thread_t) xTaskGetCurrentTaskHandle();
         case LWIP_CORE_MARK_TCPIP_TASK:
             LWIP_ASSERT("LWIP_CORE_MARK_TCPIP_TASK: lwip_task == NULL", (lwip_task == NULL));
             lwip_task = (sys_thread_t) xTaskGetCurrentTaskHandle();
@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LWIP_ESP_DHCPS_STATE_H
+#define LWIP_ESP_DHCPS_STATE_H
+
+#include "lwip/netif.h"
+#include "dhcpserver/dhcpserver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Read the leases of the DHCP server of a netif from NVS, after the pending writes are done
+ *
+ * @return Number of leases read into the leases array
+ */
+u16_t dhcps_leases_restore(struct netif *netif, struct dhcps_pool *leases, u16_t max_leases);
+
+/**
+ * @brief Store the leases of the DHCP server of a netif in NVS, in a worker task
+ *
+ * On success the worker takes ownership of the leases buffer, which must be allocated with mem_malloc().
+ * Must be called from the tcpip thread.
+ *
+ * @return true if the leases were queued for writing, false if the caller keeps the buffer
+ */
+bool dhcps_leases_store(struct netif *netif, struct dhcps_pool *leases, u16_t num_leases);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*  LWIP_ESP_DHCPS_STATE_H */
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -24,6 +24,7 @@
 #include "dhcpserver/dhcpserver.h"
 #include "dhcpserver/dhcpserver_options.h"
 #include "esp_sntp.h"
+#include "esp_timer.h"
 
 #define ETH_PING_END_BIT BIT(1)
 #define ETH_PING_DURATION_MS (5000)
@@ -304,6 +305,209 @@ TEST(lwip, dhcp_server_dns_options)
     dhcps_delete(dhcps);
 }
 
+#define DHCPS_TEST_REPLAY_CLIENTS   (CONFIG_LWIP_DHCPS_MAX_STATION_NUM + 4)
+#define DHCPS_TEST_REPLAY_ROUNDS    20
+
+struct dhcps_replay_api {
+    EventGroupHandle_t event;
+    struct netif *netif;
+    dhcps_t *dhcps;
+    err_t ret;
+    int leases;
+    bool unique;
+};
+
+static void dhcps_test_replay_macs(uint8_t mac[6], int client)
+{
+    static const uint8_t oui[3] = { 0x02, 0x12, 0x34 };
+    memcpy(mac, oui, sizeof(oui));
+    mac[3] = 0;
+    mac[4] = client >> 8;
+    mac[5] = client;
+}
+
+static void dhcps_test_replay_start_api(void *ctx)
+{
+    struct dhcps_replay_api *api = ctx;
+    ip4_addr_t netmask = { .addr = PP_HTONL(0xFFFFFF00) };
+    ip4_addr_t ip = { .addr = PP_HTONL(IPADDR_LOOPBACK) };
+
+    NETIF_FOREACH(api->netif) {
+        if (api->netif->name[0] == 'l' && api->netif->name[1] == 'o') {
+            break;
+        }
+    }
+    TEST_ASSERT_NOT_NULL(api->netif);
+
+    api->dhcps = dhcps_new();
+    dhcps_set_option_info(api->dhcps, SUBNET_MASK, &netmask, sizeof(netmask));
+    api->ret = dhcps_start(api->dhcps, api->netif, ip);
+    xEventGroupSetBits(api->event, 1);
+}
+
+static void dhcps_test_replay_check_api(void *ctx)
+{
+    struct dhcps_replay_api *api = ctx;
+    uint32_t leased[DHCPS_TEST_REPLAY_CLIENTS];
+    uint8_t mac[6];
+
+    api->leases = 0;
+    api->unique = true;
+    for (int i = 0; i < DHCPS_TEST_REPLAY_CLIENTS; i++) {
+        ip4_addr_t ip;
+        dhcps_test_replay_macs(mac, i);
+        if (dhcp_search_ip_on_mac(api->dhcps, mac, &ip)) {
+            for (int j = 0; j < api->leases; j++) {
+                api->unique = api->unique && leased[j] != ip.addr;
+            }
+            leased[api->leases++] = ip.addr;
+        }
+    }
+    xEventGroupSetBits(api->event, 1);
+}
+
+static void dhcps_test_replay_stop_api(void *ctx)
+{
+    struct dhcps_replay_api *api = ctx;
+
+    api->ret = dhcps_stop(api->dhcps, api->netif);
+    dhcps_delete(api->dhcps);
+    xEventGroupSetBits(api->event, 1);
+}
+
+static void dhcps_test_replay_call(tcpip_callback_fn fn, struct dhcps_replay_api *api)
+{
+    tcpip_callback(fn, api);
+    TEST_ASSERT_EQUAL(1, xEventGroupWaitBits(api->event, 1, true, true, pdMS_TO_TICKS(5000)) & 1);
+}
+
+TEST(lwip, dhcp_server_lease_replay)
+{
+    test_case_uses_tcpip();
+
+    struct dhcps_replay_api api = { .event = xEventGroupCreate() };
+    dhcps_test_replay_call(dhcps_test_replay_start_api, &api);
+    TEST_ASSERT_EQUAL(ERR_OK, api.ret);
+
+    struct sockaddr_in server = {
+        .sin_family = AF_INET,
+        .sin_port = htons(67),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, sock);
+
+    // DHCPDISCOVER, the clients get a lease when the server sends an offer
+    struct dhcps_msg msg = {
+        .op = 1,
+        .htype = 1,
+        .hlen = 6,
+        .options = { 0x63, 0x82, 0x53, 0x63, 53, 1, 1, 255 },
+    };
+
+    // More clients than MAX_STATION_NUM, the oldest leases are dropped as the new ones are given
+    int64_t start = esp_timer_get_time();
+    for (int round = 0; round < DHCPS_TEST_REPLAY_ROUNDS; round++) {
+        for (int i = 0; i < DHCPS_TEST_REPLAY_CLIENTS; i++) {
+            dhcps_test_replay_macs(msg.chaddr, i);
+            TEST_ASSERT_EQUAL(sizeof(msg), sendto(sock, &msg, sizeof(msg), 0, (struct sockaddr *)&server, sizeof(server)));
+        }
+    }
+    dhcps_test_replay_call(dhcps_test_replay_check_api, &api);
+    int64_t elapsed = esp_timer_get_time() - start;
+    printf("Replayed %d DHCP messages in %" PRId64 " us\n", DHCPS_TEST_REPLAY_ROUNDS * DHCPS_TEST_REPLAY_CLIENTS, elapsed);
+
+    TEST_ASSERT_EQUAL(CONFIG_LWIP_DHCPS_MAX_STATION_NUM, api.leases);
+    TEST_ASSERT_TRUE(api.unique);
+
+    close(sock);
+    dhcps_test_replay_call(dhcps_test_replay_stop_api, &api);
+    TEST_ASSERT_EQUAL(ERR_OK, api.ret);
+    vEventGroupDelete(api.event);
+}
+
+#define MBOX_TEST_PRODUCERS     2
+#define MBOX_TEST_MESSAGES      2000
+#define MBOX_TEST_SIZE          16
+
+struct mbox_test_producer {
+    sys_mbox_t *mbox;
+    int id;
+    EventGroupHandle_t done;
+};
+
+static void mbox_test_producer_task(void *arg)
+{
+    struct mbox_test_producer *producer = arg;
+    for (uintptr_t seq = 1; seq <= MBOX_TEST_MESSAGES; seq++) {
+        void *msg = (void *)((producer->id << 16) | seq);
+        if (seq % 2) {
+            sys_mbox_post(producer->mbox, msg);
+        } else {
+            while (sys_mbox_trypost(producer->mbox, msg) != ERR_OK) {
+                vTaskDelay(1);
+            }
+        }
+    }
+    xEventGroupSetBits(producer->done, BIT(producer->id));
+    vTaskDelete(NULL);
+}
+
+TEST(lwip, sys_mbox_producers_order)
+{
+    test_case_uses_tcpip();
+
+    sys_mbox_t mbox;
+    TEST_ASSERT_EQUAL(ERR_OK, sys_mbox_new(&mbox, MBOX_TEST_SIZE));
+
+    void *msg;
+    TEST_ASSERT_EQUAL(SYS_ARCH_TIMEOUT, sys_arch_mbox_fetch(&mbox, &msg, 10));
+
+    EventGroupHandle_t done = xEventGroupCreate();
+    struct mbox_test_producer producers[MBOX_TEST_PRODUCERS];
+    for (int i = 0; i < MBOX_TEST_PRODUCERS; i++) {
+        producers[i] = (struct mbox_test_producer) { .mbox = &mbox, .id = i, .done = done };
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(mbox_test_producer_task, "mbox_producer", 2048, &producers[i],
+                                              uxTaskPriorityGet(NULL), NULL));
+    }
+
+    // Messages of each producer arrive in order
+    uintptr_t last_seq[MBOX_TEST_PRODUCERS] = { 0 };
+    int received = 0;
+    int64_t start = esp_timer_get_time();
+    while (received < MBOX_TEST_PRODUCERS * MBOX_TEST_MESSAGES) {
+        TEST_ASSERT_NOT_EQUAL(SYS_ARCH_TIMEOUT, sys_arch_mbox_fetch(&mbox, &msg, 1000));
+        uintptr_t id = (uintptr_t)msg >> 16;
+        uintptr_t seq = (uintptr_t)msg & 0xffff;
+        TEST_ASSERT_LESS_THAN(MBOX_TEST_PRODUCERS, id);
+        TEST_ASSERT_EQUAL(last_seq[id] + 1, seq);
+        last_seq[id] = seq;
+        received++;
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    printf("Fetched %d messages in %" PRId64 " us\n", received, elapsed);
+
+    TEST_ASSERT_EQUAL(BIT(MBOX_TEST_PRODUCERS) - 1, xEventGroupWaitBits(done, BIT(MBOX_TEST_PRODUCERS) - 1, pdFALSE, pdTRUE, pdMS_TO_TICKS(1000)));
+    TEST_ASSERT_EQUAL(SYS_MBOX_EMPTY, sys_arch_mbox_tryfetch(&mbox, &msg));
+
+#if CONFIG_LWIP_MBOX_STATS
+    sys_mbox_stats_t stats;
+    sys_mbox_get_stats(&mbox, &stats);
+    printf("Mailbox max depth %" PRIu32 ", max latency %" PRIu32 " us, %" PRIu32 " post waits, %" PRIu32 " fetch waits\n",
+           stats.max_depth, stats.max_latency_us, stats.post_waits, stats.fetch_waits);
+    TEST_ASSERT_EQUAL(MBOX_TEST_PRODUCERS * MBOX_TEST_MESSAGES, stats.posted);
+    TEST_ASSERT_EQUAL(MBOX_TEST_PRODUCERS * MBOX_TEST_MESSAGES, stats.fetched);
+    TEST_ASSERT_LESS_OR_EQUAL(MBOX_TEST_SIZE, stats.max_depth);
+    TEST_ASSERT_GREATER_OR_EQUAL(stats.max_latency_us, stats.total_latency_us);
+
+    // The tcpip task is blocked in its mailbox since test_case_uses_tcpip()
+    TEST_ASSERT_TRUE(sys_tcpip_mbox_get_stats(&stats));
+#endif
+
+    vEventGroupDelete(done);
+    sys_mbox_free(&mbox);
+}
+
 int test_sntp_server_create(void)
 {
     struct sockaddr_in dest_addr_ip4;
@@ -408,6 +612,8 @@ TEST_GROUP_RUNNER(lwip)
     RUN_TEST_CASE(lwip, dhcp_server_init_deinit)
     RUN_TEST_CASE(lwip, dhcp_server_start_stop_localhost)
     RUN_TEST_CASE(lwip, dhcp_server_dns_options)
+    RUN_TEST_CASE(lwip, dhcp_server_lease_replay)
+    RUN_TEST_CASE(lwip, sys_mbox_producers_order)
     RUN_TEST_CASE(lwip, sntp_client_time_2015)
     RUN_TEST_CASE(lwip, sntp_client_time_2048)
 }
@@ -17,6 +17,10 @@
 
 #include "sdkconfig.h"
 
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+#include "freertos/FreeRTOS.h"
+#endif
+
 /*
     Format of certificate bundle:
     First, n uint32 "offset" entries, each describing the start of one certificate's data in terms of
@@ -68,6 +72,42 @@ typedef const uint8_t* cert_t;
 
 static bundle_t s_crt_bundle;
 
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+/*
+    Verification caches, both dropped whenever a bundle is set or detached:
+    - parsed public keys of recently used roots, so that a key is not parsed again on every handshake.
+      mbedtls_pk_verify() builds state inside the key on first use (RSA blinding values, ECP comb tables)
+      and MBEDTLS_THREADING_C is disabled, so an entry is used by one verification at a time and is not
+      evicted meanwhile. Concurrent verifications with the same root get another entry or a key of their own.
+    - (root, TBS hash, signature) of certificates which have already been verified, so that the
+      signature is not verified again when the same server certificate chain is seen again.
+*/
+#define CRT_VERIFIED_HASH_LEN   32  /*!< stored prefix of the TBS hash */
+
+typedef struct {
+    cert_t root;
+    mbedtls_pk_context pk;
+    uint32_t last_use;
+    bool in_use;
+    bool stale;                     /*!< bundle changed while in use, free on release */
+} crt_pk_cache_entry_t;
+
+typedef struct {
+    cert_t root;
+    mbedtls_md_type_t md;
+    uint8_t tbs_hash[CRT_VERIFIED_HASH_LEN];
+    uint64_t sig_id;                /*!< fingerprint of the signature value */
+    uint32_t last_use;
+} crt_verified_cache_entry_t;
+
+static crt_pk_cache_entry_t s_pk_cache[CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_PK_CACHE_SIZE];
+static crt_verified_cache_entry_t s_verified_cache[CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFIED_CACHE_SIZE];
+static uint32_t s_cache_use_counter;
+static uint32_t s_cache_generation;    /*!< incremented on every flush */
+static esp_crt_bundle_cache_stats_t s_cache_stats;
+static portMUX_TYPE s_cache_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif /* CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE */
+
 // Read a 16-bit value stored in little-endian format from the given address
 static uint16_t get16_le(const uint8_t* ptr)
 {
@@ -126,21 +166,210 @@ static cert_t esp_crt_get_cert(const bundle_t bundle, const uint32_t index)
     return bundle + esp_crt_get_cert_offset(bundle, index);
 }
 
-static int esp_crt_check_signature(const mbedtls_x509_crt* child, const uint8_t* pub_key_buf, const size_t pub_key_len)
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+/* Drop all cached entries; parsed keys still in use are freed when released */
+static void esp_crt_cache_flush(void)
+{
+    mbedtls_pk_context to_free[CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_PK_CACHE_SIZE];
+    int n_free = 0;
+
+    portENTER_CRITICAL(&s_cache_lock);
+    for (int i = 0; i < CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_PK_CACHE_SIZE; i++) {
+        crt_pk_cache_entry_t *entry = &s_pk_cache[i];
+        if (entry->root == NULL) {
+            continue;
+        }
+        if (entry->in_use) {
+            entry->stale = true;
+        } else {
+            to_free[n_free++] = entry->pk;
+            memset(entry, 0, sizeof(*entry));
+        }
+    }
+    memset(s_verified_cache, 0, sizeof(s_verified_cache));
+    s_cache_generation++;
+    portEXIT_CRITICAL(&s_cache_lock);
+
+    // The heap must not be used inside the critical section
+    for (int i = 0; i < n_free; i++) {
+        mbedtls_pk_free(&to_free[i]);
+    }
+}
+
+/* Returns a cache entry holding the parsed key of root, reserved for the caller until released,
+ * or NULL if it could not be cached */
+static crt_pk_cache_entry_t *esp_crt_pk_cache_get(const cert_t root)
+{
+    crt_pk_cache_entry_t *entry = NULL;
+
+    portENTER_CRITICAL(&s_cache_lock);
+    for (int i = 0; i < CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_PK_CACHE_SIZE; i++) {
+        if (s_pk_cache[i].root == root && !s_pk_cache[i].stale && !s_pk_cache[i].in_use) {
+            entry = &s_pk_cache[i];
+            entry->in_use = true;
+            entry->last_use = ++s_cache_use_counter;
+            s_cache_stats.pk_hits++;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_cache_lock);
+    if (entry) {
+        return entry;
+    }
+
+    mbedtls_pk_context pk;
+    mbedtls_pk_init(&pk);
+    int ret = mbedtls_pk_parse_public_key(&pk, esp_crt_get_key(root), esp_crt_get_key_len(root));
+    if (unlikely(ret != 0)) {
+        ESP_LOGE(TAG, "PK parse failed with error 0x%x", -ret);
+        mbedtls_pk_free(&pk);
+        return NULL;
+    }
+
+    mbedtls_pk_context evicted;
+    mbedtls_pk_init(&evicted);
+    portENTER_CRITICAL(&s_cache_lock);
+    s_cache_stats.pk_misses++;
+    // Least recently used entry which is not in use, free entries first
+    for (int i = 0; i < CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_PK_CACHE_SIZE; i++) {
+        crt_pk_cache_entry_t *candidate = &s_pk_cache[i];
+        if (candidate->in_use) {
+            continue;
+        }
+        if (candidate->root == NULL) {
+            entry = candidate;
+            break;
+        }
+        if (entry == NULL || (int32_t)(candidate->last_use - entry->last_use) < 0) {
+            entry = candidate;
+        }
+    }
+    if (entry) {
+        if (entry->root) {
+            evicted = entry->pk;
+        }
+        entry->root = root;
+        entry->pk = pk;
+        entry->in_use = true;
+        entry->stale = false;
+        entry->last_use = ++s_cache_use_counter;
+    }
+    portEXIT_CRITICAL(&s_cache_lock);
+
+    mbedtls_pk_free(&evicted);
+    if (entry == NULL) {
+        // All entries are in use by concurrent verifications
+        mbedtls_pk_free(&pk);
+    }
+    return entry;
+}
+
+static void esp_crt_pk_cache_release(crt_pk_cache_entry_t *entry)
+{
+    mbedtls_pk_context to_free;
+    mbedtls_pk_init(&to_free);
+
+    portENTER_CRITICAL(&s_cache_lock);
+    entry->in_use = false;
+    if (entry->stale) {
+        to_free = entry->pk;
+        memset(entry, 0, sizeof(*entry));
+    }
+    portEXIT_CRITICAL(&s_cache_lock);
+
+    mbedtls_pk_free(&to_free);
+}
+
+static uint64_t esp_crt_sig_id(const mbedtls_x509_crt *child)
+{
+    uint64_t id = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < child->MBEDTLS_PRIVATE(sig).len; i++) {
+        id ^= child->MBEDTLS_PRIVATE(sig).p[i];
+        id *= 0x100000001b3ULL;
+    }
+    return id;
+}
+
+static bool esp_crt_verified_cache_find(const cert_t root, const mbedtls_x509_crt *child, const uint8_t *hash, uint64_t sig_id)
+{
+    bool found = false;
+    portENTER_CRITICAL(&s_cache_lock);
+    for (int i = 0; i < CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFIED_CACHE_SIZE; i++) {
+        crt_verified_cache_entry_t *entry = &s_verified_cache[i];
+        if (entry->root == root && entry->md == child->MBEDTLS_PRIVATE(sig_md) && entry->sig_id == sig_id &&
+                memcmp(entry->tbs_hash, hash, CRT_VERIFIED_HASH_LEN) == 0) {
+            entry->last_use = ++s_cache_use_counter;
+            found = true;
+            break;
+        }
+    }
+    if (found) {
+        s_cache_stats.verify_hits++;
+    } else {
+        s_cache_stats.verify_misses++;
+    }
+    portEXIT_CRITICAL(&s_cache_lock);
+    return found;
+}
+
+static void esp_crt_verified_cache_add(const cert_t root, const mbedtls_x509_crt *child, const uint8_t *hash, uint64_t sig_id,
+                                       uint32_t generation)
+{
+    portENTER_CRITICAL(&s_cache_lock);
+    crt_verified_cache_entry_t *entry = &s_verified_cache[0];
+    for (int i = 0; i < CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFIED_CACHE_SIZE; i++) {
+        if (s_verified_cache[i].root == NULL) {
+            entry = &s_verified_cache[i];
+            break;
+        }
+        if ((int32_t)(s_verified_cache[i].last_use - entry->last_use) < 0) {
+            entry = &s_verified_cache[i];
+        }
+    }
+    // Do not resurrect a root of a bundle replaced while this verification was running
+    if (generation == s_cache_generation) {
+        entry->root = root;
+        entry->md = child->MBEDTLS_PRIVATE(sig_md);
+        memcpy(entry->tbs_hash, hash, CRT_VERIFIED_HASH_LEN);
+        entry->sig_id = sig_id;
+        entry->last_use = ++s_cache_use_counter;
+    }
+    portEXIT_CRITICAL(&s_cache_lock);
+}
+
+esp_err_t esp_crt_bundle_get_cache_stats(esp_crt_bundle_cache_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats != NULL, ESP_ERR_INVALID_ARG, TAG, "stats must not be NULL");
+    portENTER_CRITICAL(&s_cache_lock);
+    *stats = s_cache_stats;
+    portEXIT_CRITICAL(&s_cache_lock);
+    return ESP_OK;
+}
+#endif /* CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE */
+
+static int esp_crt_check_signature(const mbedtls_x509_crt* child, const cert_t root)
 {
     int ret = 0;
-    mbedtls_pk_context pubkey;
+    mbedtls_pk_context local_pk;
+    mbedtls_pk_context *pubkey = &local_pk;
     const mbedtls_md_info_t *md_info;
 
-    mbedtls_pk_init(&pubkey);
+    mbedtls_pk_init(&local_pk);
 
-    if (unlikely((ret = mbedtls_pk_parse_public_key(&pubkey, pub_key_buf, pub_key_len)) != 0)) {
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+    const uint32_t generation = s_cache_generation;
+    crt_pk_cache_entry_t *cached = esp_crt_pk_cache_get(root);
+    if (likely(cached != NULL)) {
+        pubkey = &cached->pk;
+    } else
+#endif
+    if (unlikely((ret = mbedtls_pk_parse_public_key(&local_pk, esp_crt_get_key(root), esp_crt_get_key_len(root))) != 0)) {
         ESP_LOGE(TAG, "PK parse failed with error 0x%x", -ret);
         goto cleanup;
     }
 
     // Fast check to avoid expensive computations when not necessary
-    if (unlikely(!mbedtls_pk_can_do(&pubkey, child->MBEDTLS_PRIVATE(sig_pk)))) {
+    if (unlikely(!mbedtls_pk_can_do(pubkey, child->MBEDTLS_PRIVATE(sig_pk)))) {
         ESP_LOGE(TAG, "Unsuitable public key");
         ret = MBEDTLS_ERR_PK_TYPE_MISMATCH;
         goto cleanup;
@@ -154,7 +383,7 @@ static int esp_crt_check_signature(const mbedtls_x509_crt* child, const uint8_t*
         goto cleanup;
     }
 
-    unsigned char hash[MBEDTLS_MD_MAX_SIZE];
+    unsigned char hash[MBEDTLS_MD_MAX_SIZE] = { 0 };
     const unsigned char md_size = mbedtls_md_get_size(md_info);
 
     if ((ret = mbedtls_md(md_info, child->tbs.p, child->tbs.len, hash)) != 0) {
@@ -162,15 +391,32 @@ static int esp_crt_check_signature(const mbedtls_x509_crt* child, const uint8_t*
         goto cleanup;
     }
 
-    if (unlikely((ret = mbedtls_pk_verify_ext(child->MBEDTLS_PRIVATE(sig_pk), child->MBEDTLS_PRIVATE(sig_opts), &pubkey,
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+    const uint64_t sig_id = esp_crt_sig_id(child);
+    if (esp_crt_verified_cache_find(root, child, hash, sig_id)) {
+        ESP_LOGD(TAG, "Signature already verified");
+        goto cleanup;
+    }
+#endif
+
+    if (unlikely((ret = mbedtls_pk_verify_ext(child->MBEDTLS_PRIVATE(sig_pk), child->MBEDTLS_PRIVATE(sig_opts), pubkey,
                                               child->MBEDTLS_PRIVATE(sig_md), hash, md_size,
                                               child->MBEDTLS_PRIVATE(sig).p, child->MBEDTLS_PRIVATE(sig).len)) != 0)) {
         ESP_LOGE(TAG, "PK verify failed with error 0x%x", -ret);
         goto cleanup;
     }
 
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+    esp_crt_verified_cache_add(root, child, hash, sig_id, generation);
+#endif
+
 cleanup:
-    mbedtls_pk_free(&pubkey);
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+    if (cached) {
+        esp_crt_pk_cache_release(cached);
+    }
+#endif
+    mbedtls_pk_free(&local_pk);
     return ret;
 }
 
@@ -241,7 +487,7 @@ int esp_crt_verify_callback(void *buf, mbedtls_x509_crt* const crt, const int de
 
     if (likely(cert != NULL)) {
 
-        const int ret = esp_crt_check_signature(child, esp_crt_get_key(cert), esp_crt_get_key_len(cert));
+        const int ret = esp_crt_check_signature(child, cert);
 
         if (likely(ret == 0)) {
             ESP_LOGI(TAG, "Certificate validated");
@@ -327,6 +573,10 @@ static bool esp_crt_check_bundle(const uint8_t* const x509_bundle, const size_t
 static esp_err_t esp_crt_bundle_init(const uint8_t* const x509_bundle, const size_t bundle_size)
 {
     if (likely(esp_crt_check_bundle(x509_bundle, bundle_size))) {
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+        /* Also when the pointer is unchanged: the application may have rewritten the buffer in place */
+        esp_crt_cache_flush();
+#endif
         s_crt_bundle = x509_bundle;
         return ESP_OK;
     } else {
@@ -479,6 +729,9 @@ esp_err_t esp_crt_bundle_attach(void *conf)
 void esp_crt_bundle_detach(mbedtls_ssl_config *conf)
 {
     s_crt_bundle = NULL;
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+    esp_crt_cache_flush();
+#endif
     if (conf) {
         mbedtls_ssl_conf_verify(conf, NULL, NULL);
     }
@@ -8,6 +8,7 @@
 #ifndef _ESP_CRT_BUNDLE_H_
 #define _ESP_CRT_BUNDLE_H_
 
+#include "sdkconfig.h"
 #include "esp_err.h"
 #include "mbedtls/ssl.h"
 
@@ -69,6 +70,32 @@ esp_err_t esp_crt_bundle_set(const uint8_t *x509_bundle, size_t bundle_size);
  */
 bool esp_crt_bundle_in_use(const mbedtls_x509_crt* ca_chain);
 
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+/**
+ * @brief Counters of the certificate bundle verification caches
+ */
+typedef struct {
+    uint32_t pk_hits;           /*!< Verifications which used an already parsed public key */
+    uint32_t pk_misses;         /*!< Verifications which had to parse the public key */
+    uint32_t verify_hits;       /*!< Signatures found already verified */
+    uint32_t verify_misses;     /*!< Signatures which had to be verified */
+} esp_crt_bundle_cache_stats_t;
+
+/**
+ * @brief      Get the counters of the verification caches
+ *
+ * The caches are dropped, but the counters are kept, on every call to esp_crt_bundle_set()
+ * (also with the buffer of the current bundle) and when the bundle is detached.
+ *
+ * @param[out] stats     Counters
+ *
+ * @return
+ *             - ESP_OK
+ *             - ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t esp_crt_bundle_get_cache_stats(esp_crt_bundle_cache_stats_t *stats);
+#endif /* CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE */
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,7 @@
 
 #include "esp_crt_bundle.h"
 #include "esp_random.h"
+#include "esp_timer.h"
 
 #include "unity.h"
 #include "test_utils.h"
@@ -441,6 +442,76 @@ TEST_CASE("custom certificate bundle - wrong signature", "[mbedtls]")
     esp_crt_bundle_detach(NULL);
 }
 
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE
+static int64_t verify_crt_time_us(const uint8_t *pem_start, const uint8_t *pem_end, int expected_ret)
+{
+    mbedtls_x509_crt crt;
+    uint32_t flags = 0;
+
+    mbedtls_x509_crt_init(&crt);
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse(&crt, pem_start, pem_end - pem_start));
+    int64_t start = esp_timer_get_time();
+    int ret = mbedtls_x509_crt_verify(&crt, NULL, NULL, NULL, &flags, esp_crt_verify_callback, NULL);
+    int64_t elapsed = esp_timer_get_time() - start;
+    mbedtls_x509_crt_free(&crt);
+
+    if (expected_ret == 0) {
+        TEST_ASSERT_EQUAL(0, ret);
+    } else {
+        TEST_ASSERT_NOT_EQUAL(0, ret);
+    }
+    return elapsed;
+}
+
+TEST_CASE("custom certificate bundle - verification cache", "[mbedtls]")
+{
+    esp_crt_bundle_cache_stats_t before, after;
+
+    esp_crt_bundle_attach(NULL);
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&before));
+
+    int64_t first_us = verify_crt_time_us(correct_sig_crt_pem_start, correct_sig_crt_pem_end, 0);
+    int64_t cached_us = 0;
+    for (int i = 0; i < 10; i++) {
+        cached_us += verify_crt_time_us(correct_sig_crt_pem_start, correct_sig_crt_pem_end, 0);
+    }
+    printf("Bundle verify: first %lld us, cached %lld us on average\n", first_us, cached_us / 10);
+
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(1, after.verify_misses - before.verify_misses);
+    TEST_ASSERT_EQUAL_UINT32(10, after.verify_hits - before.verify_hits);
+    TEST_ASSERT_EQUAL_UINT32(10, after.pk_hits - before.pk_hits);
+
+    /* Same TBS as the cached certificate, but a different signature: must still be verified and rejected */
+    verify_crt_time_us(wrong_sig_crt_pem_start, wrong_sig_crt_pem_end, -1);
+
+    /* Replacing the bundle drops both caches */
+    esp_crt_bundle_detach(NULL);
+    esp_crt_bundle_attach(NULL);
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&before));
+    verify_crt_time_us(correct_sig_crt_pem_start, correct_sig_crt_pem_end, 0);
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(1, after.verify_misses - before.verify_misses);
+    TEST_ASSERT_EQUAL_UINT32(1, after.pk_misses - before.pk_misses);
+
+    /* Setting a bundle drops both caches even if it is at the same address, its contents may have changed */
+    TEST_ESP_OK(esp_crt_bundle_set(server_cert_bundle_start, server_cert_bundle_end - server_cert_bundle_start));
+    verify_crt_time_us(server_cert_chain_pem_start, server_cert_chain_pem_end, 0);
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&before));
+    verify_crt_time_us(server_cert_chain_pem_start, server_cert_chain_pem_end, 0);
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(1, after.verify_hits - before.verify_hits);
+    TEST_ESP_OK(esp_crt_bundle_set(server_cert_bundle_start, server_cert_bundle_end - server_cert_bundle_start));
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&before));
+    verify_crt_time_us(server_cert_chain_pem_start, server_cert_chain_pem_end, 0);
+    TEST_ESP_OK(esp_crt_bundle_get_cache_stats(&after));
+    TEST_ASSERT_EQUAL_UINT32(0, after.verify_hits - before.verify_hits);
+    TEST_ASSERT_EQUAL_UINT32(1, after.verify_misses - before.verify_misses);
+
+    esp_crt_bundle_detach(NULL);
+}
+#endif /* CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE */
+
 TEST_CASE("custom certificate bundle init API - bound checking - NULL certificate bundle", "[mbedtls]")
 {
     esp_err_t esp_ret;
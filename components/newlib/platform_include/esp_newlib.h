@@ -1,11 +1,12 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 /* TODO IDF-11226 rename this file to esp_libc.h */
 #pragma once
 
+#include <stdint.h>
 #include <sys/reent.h>
 
 #ifdef __cplusplus
@@ -74,6 +75,27 @@ void esp_sync_timekeeping_timers(void);
  */
 void esp_libc_locks_init(void);
 
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+/**
+ * Contention statistics of libc locks, see esp_libc_locks_get_stats()
+ */
+typedef struct {
+    uint32_t contended;     /*!< Number of lock acquisitions which had to block because the lock was held */
+    uint32_t try_failed;    /*!< Number of try-acquire calls which failed because the lock was held */
+    uint32_t wait_objects;  /*!< Number of wait semaphores created, i.e. locks which have seen contention */
+} esp_libc_locks_stats_t;
+
+/**
+ * @brief Get contention statistics of libc locks
+ *
+ * Counters are global for all libc locks (stdio streams, environment, time zone, etc.)
+ * and count since startup. Only available with CONFIG_LIBC_LOCKS_FAST_PATH enabled.
+ *
+ * @param[out] stats  Statistics structure to fill
+ */
+void esp_libc_locks_get_stats(esp_libc_locks_stats_t *stats);
+#endif
+
 /* TODO IDF-11226 */
 void esp_newlib_time_init(void) __attribute__((deprecated("Please use esp_libc_time_init instead")));
 void esp_newlib_init(void) __attribute__((deprecated("Please use esp_libc_init instead")));
@@ -62,3 +62,13 @@
 
 /* Returns nonzero if (long)X contains the byte used to fill (long)MASK.  */
 #define DETECT_CHAR(X, MASK) (DETECT_NULL(X ^ MASK))
+
+/* A long with all bytes set to 0x01.  */
+#define BYTES_0x01 (~0UL / 0xff)
+
+/* Returns (long)X with the ASCII upper case letters converted to lower case.
+   Other bytes, including the ones with the high bit set, are kept as is.  */
+#define TO_LOWER_ASCII(X) \
+  ((X) | (((((X) & (BYTES_0x01 * 0x7f)) + BYTES_0x01 * (0x80 - 'A')) \
+         & ~(((X) & (BYTES_0x01 * 0x7f)) + BYTES_0x01 * (0x7f - 'Z')) \
+         & ~(X) & (BYTES_0x01 * 0x80)) >> 2))
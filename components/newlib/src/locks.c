@@ -6,8 +6,11 @@
 
 #include <sys/lock.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include <sys/reent.h>
 #include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_newlib.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
@@ -44,6 +47,71 @@ struct __lock __lock___libc_recursive_mutex;
 
 static portMUX_TYPE lock_init_spinlock = portMUX_INITIALIZER_UNLOCKED;
 
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+
+/* Notes on the fast path lock implementation (CONFIG_LIBC_LOCKS_FAST_PATH):
+ *
+ * - A lock is an owner word (handle of the holding task, or LOCK_OWNER_ISR,
+ *   with LOCK_HAS_WAITERS set once another task waits for it) and a recursion
+ *   count, stored in struct __lock for static locks or allocated by
+ *   lock_init_generic for dynamic ones.
+ * - All-zero memory is an unlocked lock, so static locks need no initialisation.
+ * - Uncontended acquire is a single compare-and-swap, uncontended release a
+ *   single exchange.
+ * - A binary semaphore to block on is created the first time a task has to
+ *   wait for the lock, and deleted by lock_close. Releasing a lock with
+ *   LOCK_HAS_WAITERS set gives the semaphore; the woken task takes the lock
+ *   with the flag set, as it can't know whether other tasks are still waiting.
+ * - Unlike FreeRTOS mutexes, these locks don't implement priority inheritance.
+ */
+
+#define LOCK_OWNER_NONE     ((uintptr_t) 0)
+#define LOCK_HAS_WAITERS    ((uintptr_t) 1)  /* task handles are word aligned, so bit 0 is free */
+#define LOCK_OWNER_ISR      ((uintptr_t) 2)  /* never a valid task handle */
+
+#define LOCK_FLAG_ALLOCATED (1 << 0)         /* allocated by lock_init_generic, freed by lock_close */
+
+typedef struct {
+    atomic_uintptr_t owner;                 ///< Holding task handle or LOCK_OWNER_ISR, ORed with LOCK_HAS_WAITERS
+    uint32_t count;                         ///< Recursion depth, only accessed by the owner
+    _Atomic(SemaphoreHandle_t) wait_sem;    ///< Created on first contention
+    uint32_t flags;
+} fast_lock_t;
+
+_Static_assert(sizeof(fast_lock_t) <= sizeof(struct __lock),
+               "fast_lock_t should fit in struct __lock");
+
+static atomic_uint s_stats_contended;
+static atomic_uint s_stats_try_failed;
+static atomic_uint s_stats_wait_objects;
+
+/* Allocate a new unlocked lock as the _lock_t value.
+
+   Called by _lock_init*, also called by _lock_acquire* to lazily initialize locks that might have
+   been initialised (to zero only) before the RTOS scheduler started.
+*/
+static void NEWLIB_LOCKS_IRAM_ATTR lock_init_generic(_lock_t *lock, uint8_t mutex_type)
+{
+    (void) mutex_type; /* recursion is decided by the acquire/release call */
+    fast_lock_t *new_lock = heap_caps_calloc(1, sizeof(fast_lock_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!new_lock) {
+        abort(); /* OOM */
+    }
+    new_lock->flags = LOCK_FLAG_ALLOCATED;
+
+    portENTER_CRITICAL(&lock_init_spinlock);
+    if (!*lock) {
+        *lock = (_lock_t)new_lock;
+        new_lock = NULL;
+    }
+    portEXIT_CRITICAL(&lock_init_spinlock);
+
+    /* Lock got initialised while we were allocating */
+    heap_caps_free(new_lock);
+}
+
+#else // CONFIG_LIBC_LOCKS_FAST_PATH
+
 /* Initialize the given lock by allocating a new mutex semaphore
    as the _lock_t value.
 
@@ -81,6 +149,8 @@ static void NEWLIB_LOCKS_IRAM_ATTR lock_init_generic(_lock_t *lock, uint8_t mute
     portEXIT_CRITICAL(&lock_init_spinlock);
 }
 
+#endif // CONFIG_LIBC_LOCKS_FAST_PATH
+
 void NEWLIB_LOCKS_IRAM_ATTR _lock_init(_lock_t *lock)
 {
     *lock = 0; // In case lock's memory is uninitialized
@@ -93,6 +163,32 @@ void NEWLIB_LOCKS_IRAM_ATTR _lock_init_recursive(_lock_t *lock)
     lock_init_generic(lock, queueQUEUE_TYPE_RECURSIVE_MUTEX);
 }
 
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+/* Free the wait semaphore of *lock and, if it was allocated by
+   lock_init_generic, the lock itself. *lock is zeroed out.
+
+   As with FreeRTOS mutexes, take care not to delete newlib locks
+   while they may be held or waited for by other tasks!
+*/
+void NEWLIB_LOCKS_IRAM_ATTR _lock_close(_lock_t *lock)
+{
+    portENTER_CRITICAL(&lock_init_spinlock);
+    fast_lock_t *l = (fast_lock_t *)(*lock);
+    *lock = 0;
+    portEXIT_CRITICAL(&lock_init_spinlock);
+
+    if (l) {
+        configASSERT(atomic_load(&l->owner) == LOCK_OWNER_NONE); /* lock should not be held */
+        SemaphoreHandle_t sem = atomic_exchange(&l->wait_sem, NULL);
+        if (sem) {
+            vSemaphoreDelete(sem);
+        }
+        if (l->flags & LOCK_FLAG_ALLOCATED) {
+            heap_caps_free(l);
+        }
+    }
+}
+#else // CONFIG_LIBC_LOCKS_FAST_PATH
 /* Free the mutex semaphore pointed to by *lock, and zero it out.
 
    Note that FreeRTOS doesn't account for deleting mutexes while they
@@ -116,9 +212,94 @@ void NEWLIB_LOCKS_IRAM_ATTR _lock_close(_lock_t *lock)
     }
     portEXIT_CRITICAL(&lock_init_spinlock);
 }
+#endif // CONFIG_LIBC_LOCKS_FAST_PATH
 
 void _lock_close_recursive(_lock_t *lock) __attribute__((alias("_lock_close")));
 
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+static inline uintptr_t NEWLIB_LOCKS_IRAM_ATTR lock_owner_self(void)
+{
+    return xPortCanYield() ? (uintptr_t)xTaskGetCurrentTaskHandle() : LOCK_OWNER_ISR;
+}
+
+/* Slow path of lock_acquire_generic: block until the lock is released. */
+static void __attribute__((noinline)) NEWLIB_LOCKS_IRAM_ATTR lock_wait(fast_lock_t *l, uintptr_t self)
+{
+    SemaphoreHandle_t sem = atomic_load(&l->wait_sem);
+    if (!sem) {
+        SemaphoreHandle_t new_sem = xSemaphoreCreateBinary();
+        if (!new_sem) {
+            abort(); /* No more semaphores available or OOM */
+        }
+        if (atomic_compare_exchange_strong(&l->wait_sem, &sem, new_sem)) {
+            sem = new_sem;
+            atomic_fetch_add_explicit(&s_stats_wait_objects, 1, memory_order_relaxed);
+        } else {
+            vSemaphoreDelete(new_sem); /* another task created it first */
+        }
+    }
+    atomic_fetch_add_explicit(&s_stats_contended, 1, memory_order_relaxed);
+
+    uintptr_t owner = atomic_load(&l->owner);
+    while (true) {
+        if (owner == LOCK_OWNER_NONE) {
+            if (atomic_compare_exchange_weak(&l->owner, &owner, self | LOCK_HAS_WAITERS)) {
+                break;
+            }
+            continue;
+        }
+        /* Set the flag before blocking, so that the releasing task gives the semaphore */
+        if (!(owner & LOCK_HAS_WAITERS) &&
+                !atomic_compare_exchange_weak(&l->owner, &owner, owner | LOCK_HAS_WAITERS)) {
+            continue;
+        }
+        xSemaphoreTake(sem, portMAX_DELAY);
+        owner = atomic_load(&l->owner);
+    }
+    l->count = 1;
+}
+
+/* Acquire the lock. If delay is 0, fail instead of blocking.
+   mutex_type is queueQUEUE_TYPE_RECURSIVE_MUTEX or queueQUEUE_TYPE_MUTEX
+*/
+static int NEWLIB_LOCKS_IRAM_ATTR lock_acquire_generic(_lock_t *lock, uint32_t delay, uint8_t mutex_type)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return 0; /* locking is a no-op before scheduler is up, so this "succeeds" */
+    }
+    fast_lock_t *l = (fast_lock_t *)(*lock);
+    if (!l) {
+        /* lazy initialise lock - might have had a static initializer (that we don't use) */
+        lock_init_generic(lock, mutex_type);
+        l = (fast_lock_t *)(*lock);
+        configASSERT(l != NULL);
+    }
+
+    uintptr_t self = lock_owner_self();
+    if (self == LOCK_OWNER_ISR && mutex_type == queueQUEUE_TYPE_RECURSIVE_MUTEX) {
+        abort(); /* recursive mutexes make no sense in ISR context */
+    }
+
+    uintptr_t expected = LOCK_OWNER_NONE;
+    if (atomic_compare_exchange_strong(&l->owner, &expected, self)) {
+        l->count = 1;
+        return 0;
+    }
+    if ((expected & ~LOCK_HAS_WAITERS) == self && mutex_type == queueQUEUE_TYPE_RECURSIVE_MUTEX) {
+        l->count++;
+        return 0;
+    }
+    if (delay == 0) {
+        atomic_fetch_add_explicit(&s_stats_try_failed, 1, memory_order_relaxed);
+        return -1;
+    }
+    if (self == LOCK_OWNER_ISR) {
+        abort(); /* Tried to block on mutex from ISR, couldn't... rewrite your program to avoid libc interactions in ISRs! */
+    }
+    lock_wait(l, self);
+    return 0;
+}
+#else // CONFIG_LIBC_LOCKS_FAST_PATH
 /* Acquire the mutex semaphore for lock. wait up to delay ticks.
    mutex_type is queueQUEUE_TYPE_RECURSIVE_MUTEX or queueQUEUE_TYPE_MUTEX
 */
@@ -163,6 +344,7 @@ static int NEWLIB_LOCKS_IRAM_ATTR lock_acquire_generic(_lock_t *lock, uint32_t d
 
     return (success == pdTRUE) ? 0 : -1;
 }
+#endif // CONFIG_LIBC_LOCKS_FAST_PATH
 
 void NEWLIB_LOCKS_IRAM_ATTR _lock_acquire(_lock_t *lock)
 {
@@ -184,6 +366,52 @@ int NEWLIB_LOCKS_IRAM_ATTR _lock_try_acquire_recursive(_lock_t *lock)
     return lock_acquire_generic(lock, 0, queueQUEUE_TYPE_RECURSIVE_MUTEX);
 }
 
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+/* Release the lock.
+   mutex_type is queueQUEUE_TYPE_RECURSIVE_MUTEX or queueQUEUE_TYPE_MUTEX
+*/
+static void NEWLIB_LOCKS_IRAM_ATTR lock_release_generic(_lock_t *lock, uint8_t mutex_type)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return; /* locking is a no-op before scheduler is up */
+    }
+    fast_lock_t *l = (fast_lock_t *)(*lock);
+    assert(l);
+
+    uintptr_t self = lock_owner_self();
+    if (self == LOCK_OWNER_ISR && mutex_type == queueQUEUE_TYPE_RECURSIVE_MUTEX) {
+        abort(); /* indicates logic bug, it shouldn't be possible to lock recursively in ISR */
+    }
+    if ((atomic_load_explicit(&l->owner, memory_order_relaxed) & ~LOCK_HAS_WAITERS) != self) {
+        return; /* not held by the caller, e.g. it was "acquired" before the scheduler started */
+    }
+    if (--l->count > 0) {
+        return;
+    }
+
+    if (!(atomic_exchange(&l->owner, LOCK_OWNER_NONE) & LOCK_HAS_WAITERS)) {
+        return;
+    }
+    SemaphoreHandle_t sem = atomic_load(&l->wait_sem);
+    if (self == LOCK_OWNER_ISR) {
+        BaseType_t higher_task_woken = false;
+        xSemaphoreGiveFromISR(sem, &higher_task_woken);
+        if (higher_task_woken) {
+            portYIELD_FROM_ISR();
+        }
+    } else {
+        xSemaphoreGive(sem);
+    }
+}
+
+void esp_libc_locks_get_stats(esp_libc_locks_stats_t *stats)
+{
+    assert(stats);
+    stats->contended = atomic_load_explicit(&s_stats_contended, memory_order_relaxed);
+    stats->try_failed = atomic_load_explicit(&s_stats_try_failed, memory_order_relaxed);
+    stats->wait_objects = atomic_load_explicit(&s_stats_wait_objects, memory_order_relaxed);
+}
+#else // CONFIG_LIBC_LOCKS_FAST_PATH
 /* Release the mutex semaphore for lock.
    mutex_type is queueQUEUE_TYPE_RECURSIVE_MUTEX or queueQUEUE_TYPE_MUTEX
 */
@@ -212,6 +440,7 @@ static void NEWLIB_LOCKS_IRAM_ATTR lock_release_generic(_lock_t *lock, uint8_t m
         }
     }
 }
+#endif // CONFIG_LIBC_LOCKS_FAST_PATH
 
 void NEWLIB_LOCKS_IRAM_ATTR _lock_release(_lock_t *lock)
 {
@@ -413,6 +642,11 @@ static void esp_libc_newlib_locks_init(void)
 void esp_newlib_locks_init(void) __attribute__((alias("esp_libc_locks_init")));
 void esp_libc_locks_init(void)
 {
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+    /* The two mutexes used for the locks above are zero-initialized,
+     * which is the unlocked state of a fast path lock.
+     */
+#else
     /* Initialize the two mutexes used for the locks above.
      * Asserts below check our assumption that SemaphoreHandle_t will always
      * point to the corresponding StaticSemaphore_t structure.
@@ -427,6 +661,7 @@ void esp_libc_locks_init(void)
     assert(handle == (SemaphoreHandle_t) &__lock___libc_recursive_mutex);
 #endif
     (void) handle;
+#endif // CONFIG_LIBC_LOCKS_FAST_PATH
 
 #if CONFIG_LIBC_NEWLIB
     esp_libc_newlib_locks_init();
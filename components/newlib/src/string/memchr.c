@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: 1994-2009 Red Hat, Inc.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD AND Apache-2.0
+ *
+ * SPDX-FileContributor: 2025 Espressif Systems (Shanghai) CO LTD
+ */
+#include <string.h>
+#include <limits.h>
+#include "string/local.h"
+
+void *
+memchr(const void *src_void,
+       int c,
+       size_t length)
+{
+    const unsigned char *src = (const unsigned char *)src_void;
+    unsigned char d = c;
+    unsigned long *asrc;
+    unsigned long mask;
+
+    while (UNALIGNED_X(src)) {
+        if (!length--) {
+            return NULL;
+        }
+        if (*src == d) {
+            return (void *)src;
+        }
+        src++;
+    }
+
+    if (!TOO_SMALL_LITTLE_BLOCK(length)) {
+        /* If we get this far, we know that length is large and src is
+           word-aligned. */
+        /* The fast code reads the source one word at a time and only
+           performs the bytewise search on word-sized segments if they
+           contain the search character, which is detected by XORing
+           the word-sized segment with a word-sized block of the search
+           character and then detecting for the presence of NUL in the
+           result.  */
+        asrc = (unsigned long *)src;
+        mask = BYTES_0x01 * d;
+
+        while (!TOO_SMALL_LITTLE_BLOCK(length)) {
+            if (DETECT_CHAR(*asrc, mask)) {
+                break;
+            }
+            length -= LITTLE_BLOCK_SIZE;
+            asrc++;
+        }
+
+        /* If there are fewer than LITTLE_BLOCK_SIZE characters left,
+           then we resort to the bytewise loop.  */
+        src = (unsigned char *)asrc;
+    }
+
+    while (length--) {
+        if (*src == d) {
+            return (void *)src;
+        }
+        src++;
+    }
+
+    return NULL;
+}
+
+// Hook to force the linker to include this file
+void esp_libc_include_memchr_impl(void)
+{
+}
@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <limits.h>
+#include "string/local.h"
+
+int
+strcasecmp(const char *s1,
+           const char *s2)
+{
+    unsigned long *a1;
+    unsigned long *a2;
+
+    if (!UNALIGNED_X_Y(s1, s2)) {
+        /* Compare a word at a time. Words which differ only in the case of
+           ASCII letters are equal for tolower() in any locale.  */
+        a1 = (unsigned long*)s1;
+        a2 = (unsigned long*)s2;
+        for (;;) {
+            unsigned long w1 = *a1;
+            unsigned long w2 = *a2;
+            if (w1 != w2) {
+                w1 = TO_LOWER_ASCII(w1);
+                if (w1 != TO_LOWER_ASCII(w2)) {
+                    break;
+                }
+            }
+
+            /* If we've hit a null, return zero since we already know
+               the words are equal.  */
+            if (DETECT_NULL(w1)) {
+                return 0;
+            }
+
+            a1++;
+            a2++;
+        }
+
+        /* A difference was detected in this word, so search bytewise */
+        s1 = (char*)a1;
+        s2 = (char*)a2;
+    }
+
+    for (;;) {
+        int d = tolower(*(unsigned char *)s1) - tolower(*(unsigned char *)s2);
+        if (d != 0 || *s1 == '\0') {
+            return d;
+        }
+        s1++;
+        s2++;
+    }
+}
+
+// Hook to force the linker to include this file
+void esp_libc_include_strcasecmp_impl(void)
+{
+}
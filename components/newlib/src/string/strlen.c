@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: 1994-2009 Red Hat, Inc.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD AND Apache-2.0
+ *
+ * SPDX-FileContributor: 2025 Espressif Systems (Shanghai) CO LTD
+ */
+#include <string.h>
+#include <limits.h>
+#include "string/local.h"
+
+size_t
+strlen(const char *str)
+{
+    const char *start = str;
+    unsigned long *aligned_addr;
+
+    /* Align the pointer, so we can search a word at a time.  */
+    while (UNALIGNED_X(str)) {
+        if (!*str) {
+            return str - start;
+        }
+        str++;
+    }
+
+    /* If the string is word-aligned, we can check for the presence of
+       a null in each word-sized block.  */
+    aligned_addr = (unsigned long *)str;
+    while (!DETECT_NULL(*aligned_addr)) {
+        aligned_addr++;
+    }
+
+    /* Once a null is detected, we check each byte in that block for a
+       precise position of the null.  */
+    str = (char *)aligned_addr;
+    while (*str) {
+        str++;
+    }
+    return str - start;
+}
+
+// Hook to force the linker to include this file
+void esp_libc_include_strlen_impl(void)
+{
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
@@ -11,6 +11,8 @@
 #include "unity.h"
 #include "test_utils.h"
 #include "sdkconfig.h"
+#include "esp_newlib.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 
@@ -81,6 +83,26 @@ static void test_inner_recursive(_LOCK_T lock)
     __lock_release_recursive(lock);
 }
 
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+/* Zero-initialized memory is an unlocked fast path lock. Closing it frees the
+ * semaphore created when the test task blocked on it.
+ */
+TEST_CASE("Retargetable static locks", "[newlib_locks]")
+{
+    struct __lock lock_storage = {};
+    _LOCK_T lock = &lock_storage;
+    test_inner_normal(lock);
+    __lock_close(lock);
+}
+
+TEST_CASE("Retargetable static recursive locks", "[newlib_locks]")
+{
+    struct __lock lock_storage = {};
+    _LOCK_T lock = &lock_storage;
+    test_inner_recursive(lock);
+    __lock_close_recursive(lock);
+}
+#else
 TEST_CASE("Retargetable static locks", "[newlib_locks]")
 {
     StaticSemaphore_t semaphore;
@@ -94,6 +116,7 @@ TEST_CASE("Retargetable static recursive locks", "[newlib_locks]")
     _LOCK_T lock = (_LOCK_T) xSemaphoreCreateRecursiveMutexStatic(&semaphore);
     test_inner_recursive(lock);
 }
+#endif // CONFIG_LIBC_LOCKS_FAST_PATH
 
 TEST_CASE("Retargetable dynamic locks", "[newlib_locks]")
 {
@@ -111,4 +134,50 @@ TEST_CASE("Retargetable dynamic recursive locks", "[newlib_locks]")
     __lock_close_recursive(lock);
 }
 
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+TEST_CASE("Retargetable lock contention statistics", "[newlib_locks]")
+{
+    esp_libc_locks_stats_t before, after;
+    esp_libc_locks_get_stats(&before);
+
+    _LOCK_T lock;
+    __lock_init(lock);
+    /* Blocks another task on the lock once, and fails one try-acquire */
+    test_inner_normal(lock);
+    __lock_close(lock);
+
+    esp_libc_locks_get_stats(&after);
+    TEST_ASSERT_GREATER_OR_EQUAL(before.contended + 1, after.contended);
+    TEST_ASSERT_GREATER_OR_EQUAL(before.try_failed + 1, after.try_failed);
+    TEST_ASSERT_GREATER_OR_EQUAL(before.wait_objects + 1, after.wait_objects);
+}
+#endif // CONFIG_LIBC_LOCKS_FAST_PATH
+
 #endif // _RETARGETABLE_LOCKING
+
+TEST_CASE("stdio lock/unlock time per call", "[newlib_locks]")
+{
+    const int iterations = 10000;
+    char buf[64];
+    FILE *f = fmemopen(buf, sizeof(buf), "w");
+    TEST_ASSERT_NOT_NULL(f);
+    setvbuf(f, NULL, _IONBF, 0);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        fputc('a', f);
+        rewind(f);
+    }
+    int64_t fputc_time = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        flockfile(f);
+        funlockfile(f);
+    }
+    int64_t flockfile_time = esp_timer_get_time() - start;
+    fclose(f);
+
+    printf("fputc + rewind: %d ns, flockfile + funlockfile: %d ns\n",
+           (int)(fputc_time * 1000 / iterations), (int)(flockfile_time * 1000 / iterations));
+}
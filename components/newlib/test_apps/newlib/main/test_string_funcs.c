@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include "esp_heap_caps.h"
+#include "esp_random.h"
+#include "soc/soc.h"
+#include "esp_cpu.h"
+#include "unity.h"
+#include "sdkconfig.h"
+
+#define TEST_STR_SIZE 1024
+
+/* Byte loops, as the ROM versions of these functions work. Keep the compiler from turning them into libc calls. */
+#define BYTE_LOOP __attribute__((noinline, optimize("-fno-tree-loop-distribute-patterns")))
+
+BYTE_LOOP static size_t bytewise_strlen(const char *str)
+{
+    const char *start = str;
+    while (*str) {
+        str++;
+    }
+    return str - start;
+}
+
+BYTE_LOOP static void *bytewise_memchr(const void *src_void, int c, size_t length)
+{
+    const unsigned char *src = src_void;
+    while (length--) {
+        if (*src == (unsigned char)c) {
+            return (void *)src;
+        }
+        src++;
+    }
+    return NULL;
+}
+
+BYTE_LOOP static int bytewise_strcasecmp(const char *s1, const char *s2)
+{
+    int d;
+    do {
+        d = tolower(*(unsigned char *)s1) - tolower(*(unsigned char *)s2);
+    } while (d == 0 && *s1++ && s2++);
+    return d;
+}
+
+static int sign(int v)
+{
+    return (v > 0) - (v < 0);
+}
+
+static void fill_random_string(char *s, size_t len)
+{
+    static const char chars[] = "aAzZbB@[`{09 \x80\xc1\xe1\xff";
+    for (size_t i = 0; i < len; i++) {
+        s[i] = chars[esp_random() % (sizeof(chars) - 1)];
+    }
+    s[len] = 0;
+}
+
+TEST_CASE("string functions return the same results as byte loops", "[string_funcs]")
+{
+    char *buf1 = heap_caps_malloc(TEST_STR_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    char *buf2 = heap_caps_malloc(TEST_STR_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(buf1);
+    TEST_ASSERT_NOT_NULL(buf2);
+
+    for (int i = 0; i < 5000; i++) {
+        char *s1 = buf1 + esp_random() % 8;
+        char *s2 = buf2 + esp_random() % 8;
+        size_t len = esp_random() % 100;
+        fill_random_string(s1, len);
+
+        TEST_ASSERT_EQUAL(bytewise_strlen(s1), strlen(s1));
+
+        char c = s1[esp_random() % (len + 1)];
+        TEST_ASSERT_EQUAL_PTR(bytewise_memchr(s1, c, len + 1), strchr(s1, c));
+        TEST_ASSERT_EQUAL_PTR(NULL, strchr(s1, 'x'));
+        size_t n = esp_random() % (len + 1);
+        TEST_ASSERT_EQUAL_PTR(bytewise_memchr(s1, c, n), memchr(s1, c, n));
+
+        /* s2: s1 with the case of some letters changed, and maybe one byte changed */
+        memcpy(s2, s1, len + 1);
+        for (size_t j = 0; j < len; j++) {
+            if (isalpha((unsigned char)s2[j]) && esp_random() % 2) {
+                s2[j] ^= 0x20;
+            }
+        }
+        if (len && esp_random() % 2) {
+            s2[esp_random() % len] = 'x';
+        }
+        TEST_ASSERT_EQUAL(sign(bytewise_strcasecmp(s1, s2)), sign(strcasecmp(s1, s2)));
+        TEST_ASSERT_EQUAL(sign(bytewise_strcasecmp(s2, s1)), sign(strcasecmp(s2, s1)));
+        TEST_ASSERT_EQUAL(sign(bytewise_strcasecmp(s1, s2)), sign(strncasecmp(s1, s2, len + 1)));
+    }
+
+    heap_caps_free(buf1);
+    heap_caps_free(buf2);
+}
+
+#if CONFIG_LIBC_OPTIMIZED_STRING_FUNCS
+/* The ROM versions, used without CONFIG_LIBC_OPTIMIZED_STRING_FUNCS, are byte loops themselves */
+TEST_CASE("string functions are faster than byte loops", "[string_funcs]")
+{
+    char *buf1 = heap_caps_malloc(TEST_STR_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    char *buf2 = heap_caps_malloc(TEST_STR_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(buf1);
+    TEST_ASSERT_NOT_NULL(buf2);
+    for (int i = 0; i < TEST_STR_SIZE - 1; i++) {
+        buf1[i] = "Content-Type: application/json; "[i % 32];
+        buf2[i] = tolower((unsigned char)buf1[i]);
+    }
+    buf1[TEST_STR_SIZE - 1] = buf2[TEST_STR_SIZE - 1] = 0;
+
+    uint32_t ccount1 = esp_cpu_get_cycle_count();
+    size_t len = bytewise_strlen(buf1);
+    uint32_t ccount2 = esp_cpu_get_cycle_count();
+    TEST_ASSERT_EQUAL(len, strlen(buf1));
+    uint32_t ccount3 = esp_cpu_get_cycle_count();
+    printf("strlen: %"PRIu32" cycles, byte loop %"PRIu32" cycles\n", ccount3 - ccount2, ccount2 - ccount1);
+    TEST_ASSERT_LESS_THAN(ccount2 - ccount1, ccount3 - ccount2);
+
+    ccount1 = esp_cpu_get_cycle_count();
+    void *found = bytewise_memchr(buf1, 0, TEST_STR_SIZE);
+    ccount2 = esp_cpu_get_cycle_count();
+    TEST_ASSERT_EQUAL_PTR(found, memchr(buf1, 0, TEST_STR_SIZE));
+    ccount3 = esp_cpu_get_cycle_count();
+    printf("memchr: %"PRIu32" cycles, byte loop %"PRIu32" cycles\n", ccount3 - ccount2, ccount2 - ccount1);
+    TEST_ASSERT_LESS_THAN(ccount2 - ccount1, ccount3 - ccount2);
+
+    ccount1 = esp_cpu_get_cycle_count();
+    int d = bytewise_strcasecmp(buf1, buf2);
+    ccount2 = esp_cpu_get_cycle_count();
+    TEST_ASSERT_EQUAL(d, strcasecmp(buf1, buf2));
+    ccount3 = esp_cpu_get_cycle_count();
+    printf("strcasecmp: %"PRIu32" cycles, byte loop %"PRIu32" cycles\n", ccount3 - ccount2, ccount2 - ccount1);
+    TEST_ASSERT_LESS_THAN(ccount2 - ccount1, ccount3 - ccount2);
+
+    heap_caps_free(buf1);
+    heap_caps_free(buf2);
+}
+
+static bool fn_in_ram(void *fn)
+{
+    const int fnaddr = (int)fn;
+    return (fnaddr >= SOC_IRAM_LOW && fnaddr < SOC_IRAM_HIGH);
+}
+
+TEST_CASE("string functions in IRAM", "[string_funcs]")
+{
+    TEST_ASSERT_TRUE(fn_in_ram(strlen));
+    TEST_ASSERT_TRUE(fn_in_ram(strchr));
+    TEST_ASSERT_TRUE(fn_in_ram(memchr));
+    TEST_ASSERT_TRUE(fn_in_ram(strcasecmp));
+    TEST_ASSERT_TRUE(fn_in_ram(strncasecmp));
+}
+#endif // CONFIG_LIBC_OPTIMIZED_STRING_FUNCS
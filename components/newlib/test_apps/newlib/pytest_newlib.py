@@ -17,6 +17,7 @@ from pytest_embedded_idf.utils import idf_parametrize
         ('release_esp32', 'esp32'),
         ('release_esp32c2', 'esp32c2'),
         ('misaligned_mem', 'esp32c3'),
+        ('string_funcs', 'esp32c6'),
     ],
     indirect=['config', 'target'],
 )
@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Benchmark of the libc locks as used by stdio. Newlib stdio takes the recursive lock of the FILE for every
+   call (fputc, fprintf, ...) and creates a lock for every fopen. As newlib stdio is not available on the host,
+   the benchmark calls the locks the same way around a minimal FILE buffer. The Makefile builds it with and
+   without CONFIG_LIBC_LOCKS_FAST_PATH. Run with "make benchmark". */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/lock.h>
+#include "sdkconfig.h"
+#include "esp_newlib.h"
+
+#define ITERATIONS      1000000
+#define MAX_THREADS     4
+
+typedef struct {
+    _LOCK_T lock;
+    char buf[128];
+    size_t pos;
+} bench_file_t;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench_fopen(bench_file_t *f)
+{
+    __retarget_lock_init_recursive(&f->lock);
+    f->pos = 0;
+}
+
+static void bench_fclose(bench_file_t *f)
+{
+    __retarget_lock_close_recursive(f->lock);
+}
+
+static void bench_fputc(int c, bench_file_t *f)
+{
+    __retarget_lock_acquire_recursive(f->lock);
+    f->buf[f->pos] = (char) c;
+    f->pos = (f->pos + 1) % sizeof(f->buf);
+    __retarget_lock_release_recursive(f->lock);
+}
+
+static void __attribute__((format(printf, 2, 3))) bench_fprintf(bench_file_t *f, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    __retarget_lock_acquire_recursive(f->lock);
+    vsnprintf(f->buf, sizeof(f->buf), fmt, args);
+    __retarget_lock_release_recursive(f->lock);
+    va_end(args);
+}
+
+static double run_fputc(void)
+{
+    bench_file_t f;
+    bench_fopen(&f);
+    const double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        bench_fputc('a' + i % 26, &f);
+    }
+    const double elapsed = now_ns() - start;
+    bench_fclose(&f);
+    return elapsed / ITERATIONS;
+}
+
+static double run_fprintf(void)
+{
+    bench_file_t f;
+    bench_fopen(&f);
+    const double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        bench_fprintf(&f, "%d %s\n", i, "x");
+    }
+    const double elapsed = now_ns() - start;
+    bench_fclose(&f);
+    return elapsed / ITERATIONS;
+}
+
+static double run_fopen_fclose(void)
+{
+    bench_file_t f;
+    const double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        bench_fopen(&f);
+        bench_fputc('a', &f);
+        bench_fclose(&f);
+    }
+    return (now_ns() - start) / ITERATIONS;
+}
+
+static bench_file_t s_shared_file;
+
+static void *shared_fputc_thread(void *arg)
+{
+    const int iterations = (int)(uintptr_t) arg;
+    for (int i = 0; i < iterations; i++) {
+        bench_fputc('a' + i % 26, &s_shared_file);
+    }
+    return NULL;
+}
+
+static double run_shared_fputc(int num_threads)
+{
+    pthread_t threads[MAX_THREADS];
+    const int iterations = ITERATIONS / num_threads;
+    bench_fopen(&s_shared_file);
+    const double start = now_ns();
+    for (int i = 0; i < num_threads; i++) {
+        pthread_create(&threads[i], NULL, shared_fputc_thread, (void *)(uintptr_t) iterations);
+    }
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    const double elapsed = now_ns() - start;
+    bench_fclose(&s_shared_file);
+    return elapsed / (iterations * num_threads);
+}
+
+int main(void)
+{
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+    printf("libc locks with CONFIG_LIBC_LOCKS_FAST_PATH\n");
+#else
+    printf("libc locks with FreeRTOS mutexes\n");
+#endif
+    printf("%-40s %8.1f ns/call\n", "fputc", run_fputc());
+    printf("%-40s %8.1f ns/call\n", "fprintf", run_fprintf());
+    printf("%-40s %8.1f ns/call\n", "fopen, fputc, fclose", run_fopen_fclose());
+    for (int num_threads = 2; num_threads <= MAX_THREADS; num_threads *= 2) {
+        char name[64];
+        snprintf(name, sizeof(name), "fputc to one FILE from %d threads", num_threads);
+        printf("%-40s %8.1f ns/call\n", name, run_shared_fputc(num_threads));
+    }
+#if CONFIG_LIBC_LOCKS_FAST_PATH
+    esp_libc_locks_stats_t stats;
+    esp_libc_locks_get_stats(&stats);
+    printf("contended: %" PRIu32 ", try failed: %" PRIu32 ", wait objects: %" PRIu32 "\n",
+           stats.contended, stats.try_failed, stats.wait_objects);
+#endif
+    return 0;
+}
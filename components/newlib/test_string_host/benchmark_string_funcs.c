@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Host benchmark of the word-at-a-time string functions from ../src/string against byte loops,
+ * which is how the libc versions built for size (ROM, newlib with PREFER_SIZE_OVER_SPEED) work.
+ *
+ * The host has 64-bit longs, so the gain is larger than on 32-bit targets.
+ * Use the test app in test_apps/newlib to measure on a chip. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "esp_string_funcs.h"
+
+#define ITERATIONS 2000000
+
+__attribute__((noinline)) static size_t bytewise_strlen(const char *str)
+{
+    const char *start = str;
+    while (*str) {
+        str++;
+    }
+    return str - start;
+}
+
+__attribute__((noinline)) static char *bytewise_strchr(const char *s, int i)
+{
+    while (*s && *s != (char)i) {
+        s++;
+    }
+    return (*s == (char)i) ? (char *)s : NULL;
+}
+
+__attribute__((noinline)) static void *bytewise_memchr(const void *src_void, int c, size_t length)
+{
+    const unsigned char *src = src_void;
+    while (length--) {
+        if (*src == (unsigned char)c) {
+            return (void *)src;
+        }
+        src++;
+    }
+    return NULL;
+}
+
+__attribute__((noinline)) static int bytewise_strcasecmp(const char *s1, const char *s2)
+{
+    int d;
+    do {
+        d = tolower(*(unsigned char *)s1) - tolower(*(unsigned char *)s2);
+    } while (d == 0 && *s1++ && s2++);
+    return d;
+}
+
+__attribute__((noinline)) static int bytewise_strncasecmp(const char *s1, const char *s2, size_t n)
+{
+    while (n-- > 0) {
+        int d = tolower(*(unsigned char *)s1) - tolower(*(unsigned char *)s2);
+        if (d != 0 || *s1 == '\0') {
+            return d;
+        }
+        s1++;
+        s2++;
+    }
+    return 0;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile size_t s_sink;
+
+#define BENCH(name, expr_bytewise, expr_word) do {                          \
+        double t0 = now_ns();                                               \
+        for (int i = 0; i < ITERATIONS; i++) {                              \
+            s_sink += (size_t)(expr_bytewise);                              \
+            __asm__ volatile("" ::: "memory");                              \
+        }                                                                   \
+        double t1 = now_ns();                                               \
+        for (int i = 0; i < ITERATIONS; i++) {                              \
+            s_sink += (size_t)(expr_word);                                  \
+            __asm__ volatile("" ::: "memory");                              \
+        }                                                                   \
+        double t2 = now_ns();                                               \
+        double bytewise = (t1 - t0) / ITERATIONS;                           \
+        double word = (t2 - t1) / ITERATIONS;                               \
+        printf("%-36s %8.2f ns %8.2f ns %6.2fx\n", name, bytewise, word,    \
+               bytewise / word);                                            \
+    } while (0)
+
+int main(void)
+{
+    static const size_t lengths[] = { 8, 32, 256 };
+    char name[64];
+    /* HTTP/JSON-like data: header names compared case-insensitively, keys and delimiters searched */
+    char *buf1 = malloc(512);
+    char *buf2 = malloc(512);
+
+    printf("%-36s %11s %11s %7s\n", "function", "bytewise", "word", "speedup");
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t len = lengths[l];
+        for (size_t i = 0; i < len; i++) {
+            buf1[i] = "Content-Type: application/json; "[i % 32];
+        }
+        buf1[len] = 0;
+        buf1[len - 1] = '\n';
+        for (size_t i = 0; i <= len; i++) {
+            buf2[i] = tolower((unsigned char)buf1[i]);
+        }
+
+        snprintf(name, sizeof(name), "strlen (%zu)", len);
+        BENCH(name, bytewise_strlen(buf1), esp_strlen(buf1));
+        snprintf(name, sizeof(name), "strchr, last char (%zu)", len);
+        BENCH(name, bytewise_strchr(buf1, '\n'), esp_strchr(buf1, '\n'));
+        snprintf(name, sizeof(name), "memchr, last byte (%zu)", len);
+        BENCH(name, bytewise_memchr(buf1, '\n', len), esp_memchr(buf1, '\n', len));
+        snprintf(name, sizeof(name), "strcasecmp, same case (%zu)", len);
+        BENCH(name, bytewise_strcasecmp(buf2, buf2 + 0), esp_strcasecmp(buf2, buf2 + 0));
+        snprintf(name, sizeof(name), "strcasecmp, mixed case (%zu)", len);
+        BENCH(name, bytewise_strcasecmp(buf1, buf2), esp_strcasecmp(buf1, buf2));
+        snprintf(name, sizeof(name), "strncasecmp, mixed case (%zu)", len);
+        BENCH(name, bytewise_strncasecmp(buf1, buf2, len), esp_strncasecmp(buf1, buf2, len));
+    }
+
+    free(buf1);
+    free(buf2);
+    return 0;
+}
@@ -0,0 +1,15 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+
+/* Functions from ../src/string, renamed by the Makefile so that they do not clash with the host libc */
+size_t esp_strlen(const char *str);
+char *esp_strchr(const char *s, int c);
+void *esp_memchr(const void *src, int c, size_t length);
+int esp_strcasecmp(const char *s1, const char *s2);
+int esp_strncasecmp(const char *s1, const char *s2, size_t n);
@@ -0,0 +1,184 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Correctness and fuzz test of the word-at-a-time string functions from ../src/string against the host libc */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "string/local.h"
+#include "esp_string_funcs.h"
+
+#define BUF_SIZE        512
+#define MAX_STR_LEN     300
+#define FUZZ_ITERATIONS 500000
+
+static int s_failures;
+
+#define CHECK(cond, ...) do {                                   \
+        if (!(cond)) {                                          \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);         \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            if (++s_failures > 20) {                            \
+                exit(1);                                        \
+            }                                                   \
+        }                                                       \
+    } while (0)
+
+static int sign(int v)
+{
+    return (v > 0) - (v < 0);
+}
+
+/* Bytes which make the interesting cases likely: letters of both cases, the bytes around them,
+ * bytes with the high bit set and the terminating null */
+static unsigned char random_char(void)
+{
+    static const unsigned char chars[] = "aAzZbBmM@[`{09 \x80\xc1\xda\xe1\xfa\xff\x01";
+    return (rand() % 8) ? chars[rand() % (sizeof(chars) - 1)] : (unsigned char)rand();
+}
+
+/* Random string without 'x', which the tests use as the character to search for */
+static void fill_random_string(char *s, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        do {
+            s[i] = random_char();
+        } while (s[i] == 0 || s[i] == 'x');
+    }
+    s[len] = 0;
+}
+
+static void test_to_lower_ascii(void)
+{
+    for (unsigned lane = 0; lane < sizeof(long); lane++) {
+        for (unsigned c = 0; c < 256; c++) {
+            for (unsigned other = 0; other < 256; other += 17) {
+                unsigned long w = BYTES_0x01 * other;
+                w &= ~(0xffUL << (lane * 8));
+                w |= (unsigned long)c << (lane * 8);
+                unsigned long lower = TO_LOWER_ASCII(w);
+                for (unsigned i = 0; i < sizeof(long); i++) {
+                    unsigned char in = w >> (i * 8);
+                    unsigned char out = lower >> (i * 8);
+                    unsigned char expected = (in >= 'A' && in <= 'Z') ? in + ('a' - 'A') : in;
+                    CHECK(out == expected, "TO_LOWER_ASCII(0x%02x) = 0x%02x", in, out);
+                }
+            }
+        }
+    }
+}
+
+static void test_all_alignments_and_lengths(void)
+{
+    char *buf = malloc(BUF_SIZE);
+    for (size_t align = 0; align < 2 * sizeof(long); align++) {
+        for (size_t len = 0; len < 4 * sizeof(long) + 3; len++) {
+            char *s = buf + align;
+            memset(buf, 'x', BUF_SIZE);
+            fill_random_string(s, len);
+            CHECK(esp_strlen(s) == len, "strlen align %zu len %zu", align, len);
+            CHECK(esp_strchr(s, 0) == s + len, "strchr(0) align %zu len %zu", align, len);
+            CHECK(esp_strchr(s, 'x') == NULL, "strchr not found align %zu len %zu", align, len);
+            for (size_t pos = 0; pos < len; pos++) {
+                char saved = s[pos];
+                s[pos] = 'x';
+                CHECK(esp_strchr(s, 'x') == s + pos, "strchr align %zu len %zu pos %zu", align, len, pos);
+                CHECK(esp_strchr(s, 'x' + 256) == s + pos, "strchr (int) align %zu len %zu pos %zu", align, len, pos);
+                CHECK(esp_memchr(s, 'x', len) == s + pos, "memchr align %zu len %zu pos %zu", align, len, pos);
+                CHECK(esp_memchr(s, 'x', pos) == NULL, "memchr limit align %zu len %zu pos %zu", align, len, pos);
+                s[pos] = saved;
+            }
+        }
+    }
+    free(buf);
+}
+
+/* Strings which end right before an inaccessible page: the functions must not read past the word with the null */
+static void test_page_boundary(void)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    char *map = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(map != MAP_FAILED, "mmap");
+    CHECK(mprotect(map + page, page, PROT_NONE) == 0, "mprotect");
+    char *end = map + page;
+    for (size_t len = 0; len < 4 * sizeof(long); len++) {
+        char *s = end - len - 1;
+        fill_random_string(s, len);
+        CHECK(esp_strlen(s) == len, "strlen at page end, len %zu", len);
+        CHECK(esp_strchr(s, 'x') == NULL, "strchr at page end, len %zu", len);
+        CHECK(esp_memchr(s, 'x', len + 1) == NULL, "memchr at page end, len %zu", len);
+        for (size_t len2 = 0; len2 < 4 * sizeof(long); len2++) {
+            char *s2 = map + page / 2 + len2 % sizeof(long);
+            memcpy(s2, s, len + 1);
+            CHECK(esp_strcasecmp(s, s2) == 0, "strcasecmp at page end, len %zu", len);
+            CHECK(esp_strcasecmp(s2, s) == 0, "strcasecmp at page end, len %zu", len);
+            CHECK(esp_strncasecmp(s, s2, len + len2) == 0, "strncasecmp at page end, len %zu", len);
+        }
+    }
+    munmap(map, 2 * page);
+}
+
+static void fuzz(void)
+{
+    char *buf1 = malloc(BUF_SIZE);
+    char *buf2 = malloc(BUF_SIZE);
+    for (int iter = 0; iter < FUZZ_ITERATIONS; iter++) {
+        char *s1 = buf1 + rand() % (2 * sizeof(long));
+        char *s2 = buf2 + rand() % (2 * sizeof(long));
+        size_t len = rand() % MAX_STR_LEN;
+        fill_random_string(s1, len);
+
+        CHECK(esp_strlen(s1) == strlen(s1), "strlen len %zu", len);
+
+        int c = (rand() % 2) ? (unsigned char)s1[rand() % (len + 1)] : random_char();
+        CHECK(esp_strchr(s1, c) == strchr(s1, c), "strchr len %zu c 0x%02x", len, c);
+
+        size_t n = rand() % (len + 1);
+        CHECK(esp_memchr(s1, c, n) == memchr(s1, c, n), "memchr n %zu c 0x%02x", n, c);
+
+        /* s2: s1 with the case of some letters changed, then maybe one byte changed or the string cut */
+        memcpy(s2, s1, len + 1);
+        for (size_t i = 0; i < len; i++) {
+            if (isalpha((unsigned char)s2[i]) && rand() % 2) {
+                s2[i] ^= 0x20;
+            }
+        }
+        if (len && rand() % 2) {
+            size_t pos = rand() % len;
+            s2[pos] = (rand() % 4) ? random_char() : 0;
+        }
+        n = rand() % (len + 2 * sizeof(long));
+        CHECK(sign(esp_strcasecmp(s1, s2)) == sign(strcasecmp(s1, s2)), "strcasecmp len %zu", len);
+        CHECK(sign(esp_strcasecmp(s2, s1)) == sign(strcasecmp(s2, s1)), "strcasecmp len %zu", len);
+        CHECK(sign(esp_strncasecmp(s1, s2, n)) == sign(strncasecmp(s1, s2, n)), "strncasecmp len %zu n %zu", len, n);
+        CHECK(sign(esp_strncasecmp(s2, s1, n)) == sign(strncasecmp(s2, s1, n)), "strncasecmp len %zu n %zu", len, n);
+    }
+    free(buf1);
+    free(buf2);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+    srand(seed);
+    printf("Testing string functions, seed %u\n", seed);
+
+    test_to_lower_ascii();
+    test_all_alignments_and_lengths();
+    test_page_boundary();
+    fuzz();
+
+    if (s_failures) {
+        printf("%d failures\n", s_failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
@@ -170,6 +170,47 @@ esp_err_t protocomm_req_handle(protocomm_t *pc, const char *ep_name, uint32_t se
                                const uint8_t *inbuf, ssize_t inlen,
                                uint8_t **outbuf, ssize_t *outlen);
 
+/**
+ * @brief   Calls the registered handler of an endpoint session and
+ *          stores the response in a buffer provided by the caller
+ *
+ * Same as `protocomm_req_handle()`, except that the response is written
+ * to outbuf. With security versions 1 and 2, the response is encrypted
+ * directly into outbuf and the request is decrypted into a buffer owned
+ * by the protocomm instance, which is reused by the following requests
+ * and released by `protocomm_close_session()` or `protocomm_delete()`.
+ * Only the response of the endpoint handler is then allocated per request.
+ *
+ * @note
+ *  - An endpoint must be bound to a valid protocomm instance,
+ *    created using `protocomm_new()`.
+ *  - If the response does not fit in outbuf, the request has been processed
+ *    nonetheless and its response is lost. With security version 2, the
+ *    session must then be established again.
+ *
+ * @param[in]  pc          Pointer to the protocomm instance
+ * @param[in]  ep_name     Endpoint identifier(name) string
+ * @param[in]  session_id  Unique ID for a communication session
+ * @param[in]  inbuf       Input buffer contains input request data which is to be
+ *                         processed by the registered handler
+ * @param[in]  inlen       Length of the input buffer
+ * @param[out] outbuf      Buffer for the response
+ * @param[in]  outbuf_size Size of the response buffer
+ * @param[out] outlen      Length of the response, or size required for the
+ *                         response if ESP_ERR_INVALID_SIZE is returned
+ *
+ * @return
+ *  - ESP_OK : Request handled successfully
+ *  - ESP_FAIL : Internal error in execution of registered handler
+ *  - ESP_ERR_INVALID_SIZE : Response does not fit in the output buffer
+ *  - ESP_ERR_NO_MEM : Error allocating internal resource
+ *  - ESP_ERR_NOT_FOUND : Endpoint with specified name doesn't exist
+ *  - ESP_ERR_INVALID_ARG : Null instance/name arguments
+ */
+esp_err_t protocomm_req_handle_to_buf(protocomm_t *pc, const char *ep_name, uint32_t session_id,
+                                      const uint8_t *inbuf, ssize_t inlen,
+                                      uint8_t *outbuf, ssize_t outbuf_size, ssize_t *outlen);
+
 /**
  * @brief   Add endpoint security for a protocomm instance
  *
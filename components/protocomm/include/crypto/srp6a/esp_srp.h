@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -187,6 +187,21 @@ esp_err_t esp_srp_gen_salt_verifier(const char *username, int username_len,
 esp_err_t esp_srp_set_salt_verifier(esp_srp_handle_t *hd, const char *salt, int salt_len,
                                     const char *verifier, int verifier_len);
 
+/**
+ * @brief   Generate the server's private ephemeral value b and g^b in advance [Step2.b]
+ *
+ * These do not depend on the salt and verifier, and make up the most expensive part of computing
+ * the public key. Calling this function before the client connects, e.g. from a low priority task,
+ * leaves a single modular multiplication to esp_srp_srv_pubkey() and
+ * esp_srp_srv_pubkey_from_salt_verifier(), which otherwise generate b themselves.
+ *
+ * @param hd        esp_srp handle
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if b has already been generated,
+ *                   appropriate error otherwise
+ * @note    b must only be used for a single session. Use a new handle for every session.
+ */
+esp_err_t esp_srp_srv_gen_ephemeral_key(esp_srp_handle_t *hd);
+
 /**
  * @brief   Returns B (pub key)[Step2.b] when the salt and verifier are set using esp_srp_set_salt_verifier()
  *
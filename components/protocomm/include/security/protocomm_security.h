@@ -139,6 +139,26 @@ typedef struct protocomm_security {
                          uint32_t session_id,
                          const uint8_t *inbuf, ssize_t inlen,
                          uint8_t **outbuf, ssize_t *outlen);
+
+    /**
+     * Optional function which encrypts into a buffer provided by the caller,
+     * inbuf and outbuf may be the same buffer. Returns ESP_ERR_INVALID_SIZE
+     * with the required size in outlen if outbuf_size is too small.
+     */
+    esp_err_t (*encrypt_to_buf)(protocomm_security_handle_t handle,
+                                uint32_t session_id,
+                                const uint8_t *inbuf, ssize_t inlen,
+                                uint8_t *outbuf, ssize_t outbuf_size, ssize_t *outlen);
+
+    /**
+     * Optional function which decrypts into a buffer provided by the caller,
+     * inbuf and outbuf may be the same buffer. Returns ESP_ERR_INVALID_SIZE
+     * with the required size in outlen if outbuf_size is too small.
+     */
+    esp_err_t (*decrypt_to_buf)(protocomm_security_handle_t handle,
+                                uint32_t session_id,
+                                const uint8_t *inbuf, ssize_t inlen,
+                                uint8_t *outbuf, ssize_t outbuf_size, ssize_t *outlen);
 } protocomm_security_t;
 
 #ifdef __cplusplus
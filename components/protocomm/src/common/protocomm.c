@@ -11,6 +11,7 @@
 #include <esp_err.h>
 #include <esp_log.h>
 #include <sys/queue.h>
+#include <mbedtls/platform_util.h>
 
 #include <protocomm.h>
 #include <protocomm_security.h>
@@ -57,6 +58,7 @@ void protocomm_delete(protocomm_t *pc)
     if (pc->sec_params) {
         free(pc->sec_params);
     }
+    free(pc->req_buf);
     free(pc);
 }
 
@@ -71,6 +73,65 @@ static protocomm_ep_t *search_endpoint(protocomm_t *pc, const char *ep_name)
     return NULL;
 }
 
+/* Returns a buffer of at least len bytes, and at least one, for decrypting a request of the session.
+ * The buffer owned by the instance grows to the largest request and is kept until the session which
+ * used it last is closed, or the instance is deleted. While it is in use by a request of another
+ * transport task, a temporary buffer is allocated instead. Release with protocomm_put_req_buf() */
+static uint8_t *protocomm_get_req_buf(protocomm_t *pc, uint32_t session_id, ssize_t len)
+{
+    bool busy = false;
+
+    /* An empty request is still passed to the security layer, which decides if it is valid */
+    len = len > 0 ? len : 1;
+
+    if (!atomic_compare_exchange_strong(&pc->req_buf_busy, &busy, true)) {
+        uint8_t *buf = malloc(len);
+        if (!buf) {
+            ESP_LOGE(TAG, "Failed to allocate request buffer of %d bytes", len);
+        }
+        return buf;
+    }
+
+    if (len > pc->req_buf_size) {
+        uint8_t *buf = realloc(pc->req_buf, len);
+        if (!buf) {
+            ESP_LOGE(TAG, "Failed to allocate request buffer of %d bytes", len);
+            atomic_store(&pc->req_buf_busy, false);
+            return NULL;
+        }
+        pc->req_buf = buf;
+        pc->req_buf_size = len;
+    }
+    pc->req_buf_session_id = session_id;
+    return pc->req_buf;
+}
+
+/* Clears the len bytes of decrypted data in a buffer from protocomm_get_req_buf() and releases it */
+static void protocomm_put_req_buf(protocomm_t *pc, uint8_t *buf, ssize_t len)
+{
+    mbedtls_platform_zeroize(buf, len);
+    if (buf == pc->req_buf) {
+        atomic_store(&pc->req_buf_busy, false);
+    } else {
+        free(buf);
+    }
+}
+
+static void protocomm_free_req_buf(protocomm_t *pc, uint32_t session_id)
+{
+    bool busy = false;
+
+    /* A buffer in use is kept, it was cleared after the last request anyway */
+    if (atomic_compare_exchange_strong(&pc->req_buf_busy, &busy, true)) {
+        if (pc->req_buf_session_id == session_id) {
+            free(pc->req_buf);
+            pc->req_buf = NULL;
+            pc->req_buf_size = 0;
+        }
+        atomic_store(&pc->req_buf_busy, false);
+    }
+}
+
 static esp_err_t protocomm_add_endpoint_internal(protocomm_t *pc, const char *ep_name,
                                                  protocomm_req_handler_t h, void *priv_data,
                                                  uint32_t flag)
@@ -163,6 +224,8 @@ esp_err_t protocomm_close_session(protocomm_t *pc, uint32_t session_id)
         return ESP_ERR_INVALID_ARG;
     }
 
+    protocomm_free_req_buf(pc, session_id);
+
     if (pc->sec && pc->sec->close_transport_session) {
         esp_err_t ret = pc->sec->close_transport_session(pc->sec_inst, session_id);
         if (ret != ESP_OK) {
@@ -173,6 +236,64 @@ esp_err_t protocomm_close_session(protocomm_t *pc, uint32_t session_id)
     return ESP_OK;
 }
 
+/* Decrypts the request and invokes the handler of the endpoint,
+ * the plaintext response is allocated by the handler */
+static esp_err_t protocomm_handle_secure_req(protocomm_t *pc, protocomm_ep_t *ep, uint32_t session_id,
+                                             const uint8_t *inbuf, ssize_t inlen,
+                                             uint8_t **resp, ssize_t *resp_len)
+{
+    esp_err_t ret;
+    uint8_t *dec_inbuf = NULL;
+    ssize_t dec_inbuf_len = 0;
+
+    if (inlen < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (pc->sec->decrypt_to_buf) {
+        /* The decrypted data is never longer than the encrypted data */
+        dec_inbuf = protocomm_get_req_buf(pc, session_id, inlen);
+        if (!dec_inbuf) {
+            return ESP_ERR_NO_MEM;
+        }
+        ret = pc->sec->decrypt_to_buf(pc->sec_inst, session_id, inbuf, inlen,
+                                      dec_inbuf, inlen > 0 ? inlen : 1, &dec_inbuf_len);
+        if (ret != ESP_OK) {
+            /* clear whatever was decrypted before the failure */
+            protocomm_put_req_buf(pc, dec_inbuf, inlen);
+        }
+    } else {
+        ret = pc->sec->decrypt(pc->sec_inst, session_id, inbuf, inlen, &dec_inbuf, &dec_inbuf_len);
+        if (ret != ESP_OK) {
+            free(dec_inbuf);
+        }
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Decryption of response failed for endpoint %s", ep->ep_name);
+        return ret;
+    }
+
+    /* Invoke the request handler */
+    ret = ep->req_handler(session_id,
+                          dec_inbuf, dec_inbuf_len,
+                          resp, resp_len,
+                          ep->priv_data);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Request handler for %s failed", ep->ep_name);
+        free(*resp);
+        *resp = NULL;
+    }
+
+    /* We don't need decrypted data anymore */
+    if (pc->sec->decrypt_to_buf) {
+        protocomm_put_req_buf(pc, dec_inbuf, inlen);
+    } else {
+        mbedtls_platform_zeroize(dec_inbuf, dec_inbuf_len);
+        free(dec_inbuf);
+    }
+    return ret;
+}
+
 esp_err_t protocomm_req_handle(protocomm_t *pc, const char *ep_name, uint32_t session_id,
                                const uint8_t *inbuf, ssize_t inlen,
                                uint8_t **outbuf, ssize_t *outlen)
@@ -198,31 +319,14 @@ esp_err_t protocomm_req_handle(protocomm_t *pc, const char *ep_name, uint32_t se
         ESP_LOGD(TAG, "SEC_EP Req handler returned %d", ret);
     } else if (ep->flag & REQ_EP) {
         if (pc->sec && pc->sec->decrypt) {
-            /* Decrypt the data first */
-            ssize_t dec_inbuf_len = 0;
-            uint8_t *dec_inbuf = NULL;
-            ret = pc->sec->decrypt(pc->sec_inst, session_id, inbuf, inlen, &dec_inbuf, &dec_inbuf_len);
-            if (ret != ESP_OK) {
-                ESP_LOGE(TAG, "Decryption of response failed for endpoint %s", ep_name);
-                free(dec_inbuf);
-                return ret;
-            }
-
-            /* Invoke the request handler */
+            /* Decrypt the data and invoke the request handler */
             uint8_t *plaintext_resp = NULL;
             ssize_t plaintext_resp_len = 0;
-            ret = ep->req_handler(session_id,
-                                  dec_inbuf, dec_inbuf_len,
-                                  &plaintext_resp, &plaintext_resp_len,
-                                  ep->priv_data);
+            ret = protocomm_handle_secure_req(pc, ep, session_id, inbuf, inlen,
+                                              &plaintext_resp, &plaintext_resp_len);
             if (ret != ESP_OK) {
-                ESP_LOGE(TAG, "Request handler for %s failed", ep_name);
-                free(plaintext_resp);
-                free(dec_inbuf);
                 return ret;
             }
-            /* We don't need decrypted data anymore */
-            free(dec_inbuf);
 
             uint8_t *enc_resp = NULL;
             ssize_t enc_resp_len = 0;
@@ -257,6 +361,62 @@ esp_err_t protocomm_req_handle(protocomm_t *pc, const char *ep_name, uint32_t se
     return ret;
 }
 
+esp_err_t protocomm_req_handle_to_buf(protocomm_t *pc, const char *ep_name, uint32_t session_id,
+                                      const uint8_t *inbuf, ssize_t inlen,
+                                      uint8_t *outbuf, ssize_t outbuf_size, ssize_t *outlen)
+{
+    if (!pc || !ep_name || !outbuf || !outlen) {
+        ESP_LOGE(TAG, "Invalid params %p %p", pc, ep_name);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *outlen = 0;
+
+    protocomm_ep_t *ep = search_endpoint(pc, ep_name);
+    if (!ep) {
+        ESP_LOGE(TAG, "No registered endpoint for %s", ep_name);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (!(ep->flag & REQ_EP) || !pc->sec || !pc->sec->encrypt_to_buf || !pc->sec->decrypt) {
+        /* No encryption into the buffer, copy the response */
+        uint8_t *resp = NULL;
+        ssize_t resp_len = 0;
+        esp_err_t ret = protocomm_req_handle(pc, ep_name, session_id, inbuf, inlen, &resp, &resp_len);
+        if (ret == ESP_OK) {
+            if (resp_len > outbuf_size) {
+                ESP_LOGE(TAG, "Response of %d bytes does not fit in %d bytes", resp_len, outbuf_size);
+                ret = ESP_ERR_INVALID_SIZE;
+            } else if (resp_len > 0) {
+                memcpy(outbuf, resp, resp_len);
+            }
+            *outlen = resp_len;
+        }
+        free(resp);
+        return ret;
+    }
+
+    uint8_t *plaintext_resp = NULL;
+    ssize_t plaintext_resp_len = 0;
+    esp_err_t ret = protocomm_handle_secure_req(pc, ep, session_id, inbuf, inlen,
+                                                &plaintext_resp, &plaintext_resp_len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = pc->sec->encrypt_to_buf(pc->sec_inst, session_id, plaintext_resp, plaintext_resp_len,
+                                  outbuf, outbuf_size, outlen);
+    if (ret == ESP_ERR_INVALID_SIZE) {
+        ESP_LOGE(TAG, "Response of %d bytes does not fit in %d bytes", *outlen, outbuf_size);
+    } else if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Encryption of response failed for endpoint %s", ep_name);
+    }
+
+    /* We no more need plaintext response */
+    free(plaintext_resp);
+    return ret;
+}
+
 static int protocomm_common_security_handler(uint32_t session_id,
                                              const uint8_t *inbuf, ssize_t inlen,
                                              uint8_t **outbuf, ssize_t *outlen,
@@ -1,11 +1,12 @@
 /*
- * SPDX-FileCopyrightText: 2018-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 #pragma once
 
+#include <stdatomic.h>
 #include <sys/queue.h>
 #include <protocomm_security.h>
 #include <esp_err.h>
@@ -71,4 +72,14 @@ struct protocomm {
 
     /* Application specific version string */
     const char* ver;
+
+    /* Buffer for the decrypted requests, see protocomm_get_req_buf() */
+    uint8_t *req_buf;
+    ssize_t req_buf_size;
+
+    /* Session of the last request decrypted into req_buf, closing it frees the buffer */
+    uint32_t req_buf_session_id;
+
+    /* Set while req_buf is in use, a concurrent request decrypts into a buffer of its own */
+    atomic_bool req_buf_busy;
 };
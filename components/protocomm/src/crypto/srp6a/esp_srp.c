@@ -1,10 +1,11 @@
 /*
- * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 // This file contains SRP6a implementation based on RFC 5054
 #include <string.h>
+#include <sys/lock.h>
 
 #include "esp_log.h"
 #include "esp_err.h"
@@ -14,6 +15,8 @@
 #include "esp_srp.h"
 
 #define SHA512_HASH_SZ      64
+/* Size of the server's private ephemeral value b */
+#define SRP_PRIVKEY_BITS    256
 
 static const char *TAG = "srp6a";
 
@@ -47,12 +50,18 @@ typedef struct esp_srp_handle {
     int      len_B;
     /* b */
     esp_mpi_t *b;
+    /* g^b, only kept until B is computed */
+    esp_mpi_t *gb;
     /* A */
     esp_mpi_t *A;
     char    *bytes_A;
     int      len_A;
     /* K - session key*/
     char *session_key;
+#if CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES
+    /* Precomputed table for v, shared with the other handles using the same verifier */
+    struct srp_verifier_table *v_table;
+#endif
 } esp_srp_handle;
 
 static void hexdump_mpi(const char *name, esp_mpi_t *bn)
@@ -96,6 +105,106 @@ static const char N_3072[] = {
 
 static const char g_3072[] = { 5 };
 
+#if CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES
+typedef struct srp_verifier_table {
+    esp_mpi_fixed_base_t *fb;
+    char *verifier;
+    int verifier_len;
+    int refs;
+} srp_verifier_table_t;
+
+static _lock_t s_table_lock;
+/* Table for g. The group is fixed, so it is built once and kept. */
+static esp_mpi_fixed_base_t *s_g_table;
+/* Table for the verifier set last, so that the next sessions with that verifier can reuse it */
+static srp_verifier_table_t *s_v_table;
+
+/* Must be called with s_table_lock held */
+static void srp_v_table_release(srp_verifier_table_t *vt)
+{
+    if (--vt->refs == 0) {
+        esp_mpi_fixed_base_free(vt->fb);
+        free(vt->verifier);
+        free(vt);
+    }
+}
+
+static esp_mpi_fixed_base_t *srp_g_table(esp_srp_handle_t *hd)
+{
+    _lock_acquire(&s_table_lock);
+    if (!s_g_table) {
+        ESP_LOGD(TAG, "Building table for g");
+        s_g_table = esp_mpi_fixed_base_new(hd->g, hd->n, SRP_PRIVKEY_BITS);
+    }
+    esp_mpi_fixed_base_t *fb = s_g_table;
+    _lock_release(&s_table_lock);
+    return fb;
+}
+
+static srp_verifier_table_t *srp_v_table_get(esp_srp_handle_t *hd, const char *verifier, int verifier_len)
+{
+    srp_verifier_table_t *vt = NULL;
+
+    _lock_acquire(&s_table_lock);
+    if (s_v_table && s_v_table->verifier_len == verifier_len &&
+            memcmp(s_v_table->verifier, verifier, verifier_len) == 0) {
+        vt = s_v_table;
+        vt->refs++;
+        goto exit;
+    }
+
+    ESP_LOGD(TAG, "Building table for v");
+    vt = calloc(1, sizeof(srp_verifier_table_t));
+    if (!vt) {
+        goto exit;
+    }
+    vt->verifier = malloc(verifier_len);
+    /* u = H(A, B) is used as the exponent of v */
+    vt->fb = esp_mpi_fixed_base_new(hd->v, hd->n, SHA512_HASH_SZ * 8);
+    if (!vt->verifier || !vt->fb) {
+        esp_mpi_fixed_base_free(vt->fb);
+        free(vt->verifier);
+        free(vt);
+        vt = NULL;
+        goto exit;
+    }
+    memcpy(vt->verifier, verifier, verifier_len);
+    vt->verifier_len = verifier_len;
+    /* One reference for the cache and one for the caller */
+    vt->refs = 2;
+    if (s_v_table) {
+        srp_v_table_release(s_v_table);
+    }
+    s_v_table = vt;
+exit:
+    _lock_release(&s_table_lock);
+    return vt;
+}
+#endif /* CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES */
+
+/* result = g^b, b being the private ephemeral value */
+static int srp_g_exp(esp_srp_handle_t *hd, esp_mpi_t *result, esp_mpi_t *b)
+{
+#if CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES
+    esp_mpi_fixed_base_t *fb = srp_g_table(hd);
+    if (fb && esp_mpi_fixed_base_exp(result, fb, b) == 0) {
+        return 0;
+    }
+#endif
+    return esp_mpi_a_exp_b_mod_c(result, hd->g, b, hd->n, hd->ctx);
+}
+
+/* result = v^u */
+static int srp_v_exp(esp_srp_handle_t *hd, esp_mpi_t *result, esp_mpi_t *u)
+{
+#if CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES
+    if (hd->v_table && esp_mpi_fixed_base_exp(result, hd->v_table->fb, u) == 0) {
+        return 0;
+    }
+#endif
+    return esp_mpi_a_exp_b_mod_c(result, hd->v, u, hd->n, hd->ctx);
+}
+
 
 esp_srp_handle_t *esp_srp_init(esp_ng_type_t ng)
 {
@@ -164,6 +273,16 @@ void esp_srp_free(esp_srp_handle_t *hd)
     if (hd->b) {
         esp_mpi_free(hd->b);
     }
+    if (hd->gb) {
+        esp_mpi_free(hd->gb);
+    }
+#if CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES
+    if (hd->v_table) {
+        _lock_acquire(&s_table_lock);
+        srp_v_table_release(hd->v_table);
+        _lock_release(&s_table_lock);
+    }
+#endif
     if (hd->A) {
         esp_mpi_free(hd->A);
     }
@@ -258,40 +377,63 @@ static esp_mpi_t *calculate_u(esp_srp_handle_t *hd, char *A, int len_A)
     return calculate_padded_hash(hd, A, len_A, hd->bytes_B, hd->len_B);
 }
 
+/* Generate b and g^b, which do not depend on the salt and verifier */
+static esp_err_t _esp_srp_srv_gen_ephemeral_key(esp_srp_handle_t *hd)
+{
+    hd->b = esp_mpi_new();
+    hd->gb = esp_mpi_new();
+    if (!hd->b || !hd->gb) {
+        goto error;
+    }
+    esp_mpi_get_rand(hd->b, SRP_PRIVKEY_BITS, -1, 0);
+    hexdump_mpi("b", hd->b);
+
+    if (srp_g_exp(hd, hd->gb, hd->b) != 0) {
+        goto error;
+    }
+    return ESP_OK;
+error:
+    if (hd->b) {
+        esp_mpi_free(hd->b);
+        hd->b = NULL;
+    }
+    if (hd->gb) {
+        esp_mpi_free(hd->gb);
+        hd->gb = NULL;
+    }
+    return ESP_FAIL;
+}
+
 static esp_err_t __esp_srp_srv_pubkey(esp_srp_handle_t *hd, char **bytes_B, int *len_B)
 {
     esp_mpi_t *k = calculate_k(hd);
     esp_mpi_t *kv = NULL;
-    esp_mpi_t *gb = NULL;
     if (!k) {
         goto error;
     }
     hexdump_mpi("k", k);
 
-    hd->b = esp_mpi_new();
-    if (!hd->b) {
+    /* b and g^b may have been generated in advance by esp_srp_srv_gen_ephemeral_key() */
+    if (!hd->b && _esp_srp_srv_gen_ephemeral_key(hd) != ESP_OK) {
         goto error;
     }
-    esp_mpi_get_rand(hd->b, 256, -1, 0);
-    hexdump_mpi("b", hd->b);
 
     /* B = kv + g^b */
     kv = esp_mpi_new();
-    gb = esp_mpi_new();
     hd->B = esp_mpi_new();
-    if (!kv || !gb || ! hd->B) {
+    if (!kv || ! hd->B) {
         goto error;
     }
     esp_mpi_a_mul_b_mod_c(kv, k, hd->v, hd->n, hd->ctx);
-    esp_mpi_a_exp_b_mod_c(gb, hd->g, hd->b, hd->n, hd->ctx);
-    esp_mpi_a_add_b_mod_c(hd->B, kv, gb, hd->n, hd->ctx);
+    esp_mpi_a_add_b_mod_c(hd->B, kv, hd->gb, hd->n, hd->ctx);
     hd->bytes_B = esp_mpi_to_bin(hd->B, len_B);
     hd->len_B = *len_B;
     *bytes_B = hd->bytes_B;
 
     esp_mpi_free(k);
     esp_mpi_free(kv);
-    esp_mpi_free(gb);
+    esp_mpi_free(hd->gb);
+    hd->gb = NULL;
     return ESP_OK;
 error:
     if (k) {
@@ -300,9 +442,6 @@ error:
     if (kv) {
         esp_mpi_free(kv);
     }
-    if (gb) {
-        esp_mpi_free(gb);
-    }
     if (hd->B) {
         esp_mpi_free(hd->B);
         hd->B = NULL;
@@ -311,34 +450,48 @@ error:
         esp_mpi_free(hd->b);
         hd->b = NULL;
     }
+    if (hd->gb) {
+        esp_mpi_free(hd->gb);
+        hd->gb = NULL;
+    }
     return ESP_FAIL;
 }
 
+esp_err_t esp_srp_srv_gen_ephemeral_key(esp_srp_handle_t *hd)
+{
+    if (!hd) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (hd->b) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return _esp_srp_srv_gen_ephemeral_key(hd);
+}
+
 static esp_err_t _esp_srp_gen_salt_verifier(esp_srp_handle_t *hd, const char *username, int username_len,
                                             const char *pass, int pass_len, int salt_len)
 {
     /* Get Salt */
-    int str_salt_len;
     esp_mpi_t *x = NULL;
-    hd->s = esp_mpi_new();
-    if (!hd->s) {
-        ESP_LOGE(TAG, "Failed to allocate bignum s");
-        goto error;
-    }
-
-    esp_mpi_get_rand(hd->s, 8 * salt_len, -1, 0);
-    hd->bytes_s = esp_mpi_to_bin(hd->s, &str_salt_len);
+    /* Generate the bytes directly, so that the salt keeps salt_len bytes when it starts with zeros */
+    hd->bytes_s = malloc(salt_len);
     if (!hd->bytes_s) {
         ESP_LOGE(TAG, "Failed to generate salt of len %d", salt_len);
         goto error;
     }
-
+    esp_fill_random(hd->bytes_s, salt_len);
     hd->len_s = salt_len;
+
+    hd->s = esp_mpi_new_from_bin(hd->bytes_s, salt_len);
+    if (!hd->s) {
+        ESP_LOGE(TAG, "Failed to allocate bignum s");
+        goto error;
+    }
     ESP_LOGD(TAG, "Salt ->");
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, hd->bytes_s, str_salt_len, ESP_LOG_DEBUG);
+    ESP_LOG_BUFFER_HEX_LEVEL(TAG, hd->bytes_s, salt_len, ESP_LOG_DEBUG);
 
     /* Calculate X which is simply a hash for all these things */
-    x = calculate_x(hd->bytes_s, str_salt_len, username, username_len, pass, pass_len);
+    x = calculate_x(hd->bytes_s, salt_len, username, username_len, pass, pass_len);
     if (!x) {
         ESP_LOGE(TAG, "Failed to calculate x");
         goto error;
@@ -477,6 +630,10 @@ esp_err_t esp_srp_set_salt_verifier(esp_srp_handle_t *hd, const char *salt, int
     if (!hd->v) {
         goto error;
     }
+#if CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES
+    /* Not fatal, v^u falls back to the generic exponentiation without the table */
+    hd->v_table = srp_v_table_get(hd, verifier, verifier_len);
+#endif
     return ESP_OK;
 
 error:
@@ -534,7 +691,7 @@ esp_err_t esp_srp_get_session_key(esp_srp_handle_t *hd, char *bytes_A, int len_A
         goto error;
     }
 
-    esp_mpi_a_exp_b_mod_c(vu, hd->v, u, hd->n, hd->ctx);
+    srp_v_exp(hd, vu, u);
     esp_mpi_a_mul_b_mod_c(avu, hd->A, vu, hd->n, hd->ctx);
     esp_mpi_a_exp_b_mod_c(S, avu, hd->b, hd->n, hd->ctx);
     hexdump_mpi("S", S);
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -149,3 +149,168 @@ int esp_mpi_a_add_b_mod_c(esp_mpi_t *result, esp_mpi_t *a, esp_mpi_t *b, esp_mpi
 
     return res;
 }
+
+/* Fixed base exponentiation (Lim-Lee comb)
+ *
+ * The exponent is split into ESP_MPI_COMB_TEETH rows of `cols` bits each. table[i] holds
+ * base^(sum of 2^(j * cols) for every bit j set in i), so that one column of the exponent is
+ * processed with a single squaring and a single multiplication. A 256 bit exponent then needs
+ * 64 squarings and 64 multiplications, instead of 256 squarings plus the window multiplications
+ * of a generic exponentiation.
+ *
+ * The modular reductions use Barrett's method, which only relies on multiplications and shifts.
+ *
+ * The sequence of multiplications and the table entries read do not depend on the exponent, but the
+ * computation is not constant time: the final correction of the Barrett reduction and the mbedtls_mpi
+ * arithmetic, which works on the used limbs only, take a time which depends on the values.
+ */
+#define ESP_MPI_COMB_TEETH      4
+#define ESP_MPI_COMB_SIZE       (1 << ESP_MPI_COMB_TEETH)
+
+struct esp_mpi_fixed_base {
+    mbedtls_mpi n;
+    /* Barrett constant: mu = floor(2^(2 * n_bits) / n) */
+    mbedtls_mpi mu;
+    size_t n_bits;
+    size_t cols;
+    mbedtls_mpi table[ESP_MPI_COMB_SIZE];
+};
+
+/* r = x mod n, for 0 <= x < 2^(2 * n_bits). `t` is a scratch value, `r` must not alias `x` */
+static int esp_mpi_barrett_reduce(mbedtls_mpi *r, const mbedtls_mpi *x, const esp_mpi_fixed_base_t *fb, mbedtls_mpi *t)
+{
+    int ret;
+    MBEDTLS_MPI_CHK(mbedtls_mpi_copy(t, x));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_shift_r(t, fb->n_bits - 1));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(t, t, &fb->mu));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_shift_r(t, fb->n_bits + 1));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(t, t, &fb->n));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_sub_mpi(r, x, t));
+    /* The estimate of the quotient is off by at most 2 */
+    while (mbedtls_mpi_cmp_mpi(r, &fb->n) >= 0) {
+        MBEDTLS_MPI_CHK(mbedtls_mpi_sub_mpi(r, r, &fb->n));
+    }
+cleanup:
+    return ret;
+}
+
+/* r = a * b mod n, `x` and `t` are scratch values */
+static int esp_mpi_barrett_mul(mbedtls_mpi *r, const mbedtls_mpi *a, const mbedtls_mpi *b,
+                               const esp_mpi_fixed_base_t *fb, mbedtls_mpi *x, mbedtls_mpi *t)
+{
+    int ret;
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(x, a, b));
+    MBEDTLS_MPI_CHK(esp_mpi_barrett_reduce(r, x, fb, t));
+cleanup:
+    return ret;
+}
+
+void esp_mpi_fixed_base_free(esp_mpi_fixed_base_t *fb)
+{
+    if (!fb) {
+        return;
+    }
+    mbedtls_mpi_free(&fb->n);
+    mbedtls_mpi_free(&fb->mu);
+    for (int i = 0; i < ESP_MPI_COMB_SIZE; i++) {
+        mbedtls_mpi_free(&fb->table[i]);
+    }
+    free(fb);
+}
+
+esp_mpi_fixed_base_t *esp_mpi_fixed_base_new(esp_mpi_t *base, esp_mpi_t *c, int exp_bits)
+{
+    int ret;
+    mbedtls_mpi x, t;
+
+    if (exp_bits <= 0 || mbedtls_mpi_cmp_int(c, 1) <= 0) {
+        return NULL;
+    }
+
+    esp_mpi_fixed_base_t *fb = calloc(1, sizeof(esp_mpi_fixed_base_t));
+    if (!fb) {
+        return NULL;
+    }
+    mbedtls_mpi_init(&fb->n);
+    mbedtls_mpi_init(&fb->mu);
+    for (int i = 0; i < ESP_MPI_COMB_SIZE; i++) {
+        mbedtls_mpi_init(&fb->table[i]);
+    }
+    mbedtls_mpi_init(&x);
+    mbedtls_mpi_init(&t);
+
+    MBEDTLS_MPI_CHK(mbedtls_mpi_copy(&fb->n, c));
+    fb->n_bits = mbedtls_mpi_bitlen(c);
+    fb->cols = (exp_bits + ESP_MPI_COMB_TEETH - 1) / ESP_MPI_COMB_TEETH;
+
+    MBEDTLS_MPI_CHK(mbedtls_mpi_lset(&fb->mu, 1));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_shift_l(&fb->mu, 2 * fb->n_bits));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_div_mpi(&fb->mu, NULL, &fb->mu, c));
+
+    /* table[0] is the identity. It is stored as n + 1 rather than 1, so that it has about the size
+     * of the other entries. */
+    MBEDTLS_MPI_CHK(mbedtls_mpi_add_int(&fb->table[0], c, 1));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&fb->table[1], base, c));
+
+    for (int j = 1; j < ESP_MPI_COMB_TEETH; j++) {
+        mbedtls_mpi *row = &fb->table[1 << j];
+        /* row j = row (j - 1) ^ (2 ^ cols) */
+        MBEDTLS_MPI_CHK(mbedtls_mpi_copy(row, &fb->table[1 << (j - 1)]));
+        for (size_t i = 0; i < fb->cols; i++) {
+            MBEDTLS_MPI_CHK(esp_mpi_barrett_mul(row, row, row, fb, &x, &t));
+        }
+        for (int i = 1; i < (1 << j); i++) {
+            MBEDTLS_MPI_CHK(esp_mpi_barrett_mul(&fb->table[(1 << j) + i], row, &fb->table[i], fb, &x, &t));
+        }
+    }
+
+cleanup:
+    mbedtls_mpi_free(&x);
+    mbedtls_mpi_free(&t);
+    if (ret != 0) {
+        printf("esp_mpi_fixed_base_new() failed, returned %x\n", ret);
+        esp_mpi_fixed_base_free(fb);
+        return NULL;
+    }
+    return fb;
+}
+
+int esp_mpi_fixed_base_exp(esp_mpi_t *result, const esp_mpi_fixed_base_t *fb, esp_mpi_t *b)
+{
+    int ret;
+    mbedtls_mpi r, e, x, t;
+
+    if (mbedtls_mpi_cmp_int(b, 0) < 0 || mbedtls_mpi_bitlen(b) > fb->cols * ESP_MPI_COMB_TEETH) {
+        return MBEDTLS_ERR_MPI_BAD_INPUT_DATA;
+    }
+
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&e);
+    mbedtls_mpi_init(&x);
+    mbedtls_mpi_init(&t);
+
+    MBEDTLS_MPI_CHK(mbedtls_mpi_lset(&r, 1));
+    for (size_t col = fb->cols; col-- > 0;) {
+        if (col != fb->cols - 1) {
+            MBEDTLS_MPI_CHK(esp_mpi_barrett_mul(&r, &r, &r, fb, &x, &t));
+        }
+        unsigned int idx = 0;
+        for (int j = 0; j < ESP_MPI_COMB_TEETH; j++) {
+            idx |= (unsigned int) mbedtls_mpi_get_bit(b, j * fb->cols + col) << j;
+        }
+        /* The exponent may be secret: read every entry and always multiply, so that the entries read
+           and the operations done do not depend on it */
+        for (unsigned int i = 0; i < ESP_MPI_COMB_SIZE; i++) {
+            MBEDTLS_MPI_CHK(mbedtls_mpi_safe_cond_assign(&e, &fb->table[i], (unsigned char) (i == idx)));
+        }
+        MBEDTLS_MPI_CHK(esp_mpi_barrett_mul(&r, &r, &e, fb, &x, &t));
+    }
+    MBEDTLS_MPI_CHK(mbedtls_mpi_copy(result, &r));
+
+cleanup:
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&e);
+    mbedtls_mpi_free(&x);
+    mbedtls_mpi_free(&t);
+    return ret;
+}
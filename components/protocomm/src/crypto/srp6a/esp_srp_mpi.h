@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -21,6 +21,9 @@ extern "C" {
 typedef mbedtls_mpi esp_mpi_t;
 typedef esp_mpi_t esp_mpi_ctx_t;
 
+/* Precomputed comb table for exponentiations of a fixed base modulo a fixed modulus */
+typedef struct esp_mpi_fixed_base esp_mpi_fixed_base_t;
+
 esp_mpi_t *esp_mpi_new(void);
 
 esp_mpi_t *esp_mpi_new_from_hex(const char *hex);
@@ -47,6 +50,14 @@ int esp_mpi_a_mul_b_mod_c(esp_mpi_t *result, esp_mpi_t *a, esp_mpi_t *b, esp_mpi
 
 int esp_mpi_a_add_b_mod_c(esp_mpi_t *result, esp_mpi_t *a, esp_mpi_t *b, esp_mpi_t *c, esp_mpi_ctx_t *ctx);
 
+/* Precompute the comb table of `base` modulo `c` for exponents of up to `exp_bits` bits */
+esp_mpi_fixed_base_t *esp_mpi_fixed_base_new(esp_mpi_t *base, esp_mpi_t *c, int exp_bits);
+
+void esp_mpi_fixed_base_free(esp_mpi_fixed_base_t *fb);
+
+/* result = base^b mod c, using the table precomputed by esp_mpi_fixed_base_new() */
+int esp_mpi_fixed_base_exp(esp_mpi_t *result, const esp_mpi_fixed_base_t *fb, esp_mpi_t *b);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -510,10 +510,10 @@ static esp_err_t sec1_cleanup(protocomm_security_handle_t handle)
     return ESP_OK;
 }
 
-static esp_err_t sec1_decrypt(protocomm_security_handle_t handle,
-                              uint32_t session_id,
-                              const uint8_t *inbuf, ssize_t inlen,
-                              uint8_t **outbuf, ssize_t *outlen)
+static esp_err_t sec1_decrypt_to_buf(protocomm_security_handle_t handle,
+                                     uint32_t session_id,
+                                     const uint8_t *inbuf, ssize_t inlen,
+                                     uint8_t *outbuf, ssize_t outbuf_size, ssize_t *outlen)
 {
     session_t *cur_session = (session_t *) handle;
     if (!cur_session) {
@@ -531,14 +531,13 @@ static esp_err_t sec1_decrypt(protocomm_security_handle_t handle,
     }
 
     *outlen = inlen;
-    *outbuf = (uint8_t *) malloc(*outlen);
-    if (!*outbuf) {
-        ESP_LOGE(TAG, "Failed to allocate encrypt/decrypt buf len %d", *outlen);
-        return ESP_ERR_NO_MEM;
+    if (outbuf_size < inlen) {
+        return ESP_ERR_INVALID_SIZE;
     }
 
+    /* AES-CTR may be done in place */
     int ret = mbedtls_aes_crypt_ctr(&cur_session->ctx_aes, inlen, &cur_session->nc_off,
-                                    cur_session->rand, cur_session->stb, inbuf, *outbuf);
+                                    cur_session->rand, cur_session->stb, inbuf, outbuf);
     if (ret != 0) {
         ESP_LOGE(TAG, "Failed at mbedtls_aes_crypt_ctr with error code : %d", ret);
         return ESP_FAIL;
@@ -546,6 +545,21 @@ static esp_err_t sec1_decrypt(protocomm_security_handle_t handle,
     return ESP_OK;
 }
 
+static esp_err_t sec1_decrypt(protocomm_security_handle_t handle,
+                              uint32_t session_id,
+                              const uint8_t *inbuf, ssize_t inlen,
+                              uint8_t **outbuf, ssize_t *outlen)
+{
+    *outlen = inlen;
+    *outbuf = (uint8_t *) malloc(*outlen);
+    if (!*outbuf) {
+        ESP_LOGE(TAG, "Failed to allocate encrypt/decrypt buf len %d", *outlen);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return sec1_decrypt_to_buf(handle, session_id, inbuf, inlen, *outbuf, *outlen, outlen);
+}
+
 static esp_err_t sec1_req_handler(protocomm_security_handle_t handle,
                                   const void *sec_params,
                                   uint32_t session_id,
@@ -611,4 +625,6 @@ const protocomm_security_t protocomm_security1 = {
     .security_req_handler = sec1_req_handler,
     .encrypt = sec1_decrypt, /* Encrypt == decrypt for AES-CTR */
     .decrypt = sec1_decrypt,
+    .encrypt_to_buf = sec1_decrypt_to_buf,
+    .decrypt_to_buf = sec1_decrypt_to_buf,
 };
@@ -20,6 +20,11 @@
 #include <protocomm_security.h>
 #include <protocomm_security2.h>
 
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
 #include "session.pb-c.h"
 #include "sec2.pb-c.h"
 #include "constants.pb-c.h"
@@ -50,6 +55,24 @@ typedef struct aes_gcm_iv {
 
 static_assert(sizeof(aes_gcm_iv_t) == AES_GCM_IV_SIZE, "Invalid size of AES GCM IV");
 
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+#define PREGEN_TASK_STACK_SIZE      (4096)
+#define PREGEN_TASK_PRIORITY        (tskIDLE_PRIORITY + 1)
+
+/* SRP context holding the ephemeral key of the next session, generated in the background.
+ * The session never waits for the generation task, which runs at a low priority: if the key is not ready
+ * yet, the session generates its own. */
+typedef struct sec2_pregen {
+    esp_srp_handle_t *srp_hd;
+    /* Set while the generation task runs */
+    bool running;
+    /* Set when security is cleaned up while the task runs, the task then frees this structure */
+    bool abandoned;
+} sec2_pregen_t;
+
+static portMUX_TYPE s_pregen_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
 typedef struct session {
     /* Session data */
     uint32_t id;
@@ -67,6 +90,10 @@ typedef struct session {
     /* mbedtls context data for AES-GCM */
     mbedtls_gcm_context ctx_gcm;
     esp_srp_handle_t *srp_hd;
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+    /* Not session data, kept when the session is closed */
+    sec2_pregen_t *pregen;
+#endif
 } session_t;
 
 static void hexdump(const char *msg, char *buf, int len)
@@ -83,6 +110,89 @@ static inline void sec2_gcm_iv_counter_increment(uint8_t *iv_buf)
 
 static esp_err_t sec2_new_session(protocomm_security_handle_t handle, uint32_t session_id);
 
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+static void sec2_pregen_task(void *arg)
+{
+    sec2_pregen_t *pregen = (sec2_pregen_t *) arg;
+
+    esp_srp_handle_t *srp_hd = esp_srp_init(ESP_NG_3072);
+    if (srp_hd && esp_srp_srv_gen_ephemeral_key(srp_hd) != ESP_OK) {
+        esp_srp_free(srp_hd);
+        srp_hd = NULL;
+    }
+    if (!srp_hd) {
+        ESP_LOGW(TAG, "Failed to generate the ephemeral key in advance");
+    }
+
+    portENTER_CRITICAL(&s_pregen_lock);
+    bool abandoned = pregen->abandoned;
+    if (!abandoned) {
+        pregen->srp_hd = srp_hd;
+        pregen->running = false;
+    }
+    portEXIT_CRITICAL(&s_pregen_lock);
+
+    if (abandoned) {
+        esp_srp_free(srp_hd);
+        free(pregen);
+    }
+    vTaskDelete(NULL);
+}
+
+static void sec2_pregen_start(sec2_pregen_t *pregen)
+{
+    portENTER_CRITICAL(&s_pregen_lock);
+    bool start = !pregen->running && !pregen->srp_hd;
+    pregen->running = start;
+    portEXIT_CRITICAL(&s_pregen_lock);
+
+    if (start && xTaskCreate(sec2_pregen_task, "sec2_pregen", PREGEN_TASK_STACK_SIZE, pregen,
+                             PREGEN_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to create the ephemeral key generation task");
+        portENTER_CRITICAL(&s_pregen_lock);
+        pregen->running = false;
+        portEXIT_CRITICAL(&s_pregen_lock);
+    }
+}
+
+/* Returns the pre-generated SRP context, or NULL if there is none or it is still being generated */
+static esp_srp_handle_t *sec2_pregen_take(sec2_pregen_t *pregen)
+{
+    portENTER_CRITICAL(&s_pregen_lock);
+    esp_srp_handle_t *srp_hd = pregen->srp_hd;
+    pregen->srp_hd = NULL;
+    portEXIT_CRITICAL(&s_pregen_lock);
+    return srp_hd;
+}
+
+/* Frees the context, or leaves it to the generation task if it is running */
+static void sec2_pregen_free(sec2_pregen_t *pregen)
+{
+    portENTER_CRITICAL(&s_pregen_lock);
+    bool running = pregen->running;
+    pregen->abandoned = running;
+    portEXIT_CRITICAL(&s_pregen_lock);
+
+    if (!running) {
+        esp_srp_free(pregen->srp_hd);
+        free(pregen);
+    }
+}
+#endif
+
+static esp_srp_handle_t *sec2_srp_init(session_t *cur_session)
+{
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+    esp_srp_handle_t *srp_hd = sec2_pregen_take(cur_session->pregen);
+    /* Prepare the ephemeral key of the next session, unless it is still being generated */
+    sec2_pregen_start(cur_session->pregen);
+    if (srp_hd) {
+        return srp_hd;
+    }
+#endif
+    return esp_srp_init(ESP_NG_3072);
+}
+
 static esp_err_t handle_session_command0(session_t *cur_session,
         uint32_t session_id,
         SessionData *req, SessionData *resp,
@@ -125,7 +235,7 @@ static esp_err_t handle_session_command0(session_t *cur_session,
     hexdump("Client Public Key", (char *) in->sc0->client_pubkey.data, PUBLIC_KEY_LEN);
 
     /* Initialize mu srp context */
-    cur_session->srp_hd = esp_srp_init(ESP_NG_3072);
+    cur_session->srp_hd = sec2_srp_init(cur_session);
     if (cur_session->srp_hd == NULL) {
         ESP_LOGE(TAG, "Failed to initialise security context!");
         return ESP_FAIL;
@@ -400,7 +510,13 @@ static esp_err_t sec2_close_session(protocomm_security_handle_t handle, uint32_t
         esp_srp_free(cur_session->srp_hd);
     }
 
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+    sec2_pregen_t *pregen = cur_session->pregen;
+    memset(cur_session, 0, sizeof(session_t));
+    cur_session->pregen = pregen;
+#else
     memset(cur_session, 0, sizeof(session_t));
+#endif
     cur_session->id = -1;
     return ESP_OK;
 }
@@ -433,6 +549,15 @@ static esp_err_t sec2_init(protocomm_security_handle_t *handle)
         return ESP_ERR_NO_MEM;
     }
     cur_session->id = -1;
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+    cur_session->pregen = (sec2_pregen_t *) calloc(1, sizeof(sec2_pregen_t));
+    if (!cur_session->pregen) {
+        ESP_LOGE(TAG, "Error allocating ephemeral key generation context");
+        free(cur_session);
+        return ESP_ERR_NO_MEM;
+    }
+    sec2_pregen_start(cur_session->pregen);
+#endif
     *handle = (protocomm_security_handle_t) cur_session;
     return ESP_OK;
 }
@@ -442,22 +567,21 @@ static esp_err_t sec2_cleanup(protocomm_security_handle_t handle)
     session_t *cur_session = (session_t *) handle;
     if (cur_session) {
         sec2_close_session(handle, cur_session->id);
+#if CONFIG_ESP_PROTOCOMM_SEC2_PREGEN_EPHEMERAL_KEY
+        sec2_pregen_free(cur_session->pregen);
+#endif
     }
     free(handle);
     return ESP_OK;
 }
 
-static esp_err_t sec2_encrypt(protocomm_security_handle_t handle,
-                              uint32_t session_id,
-                              const uint8_t *inbuf, ssize_t inlen,
-                              uint8_t **outbuf, ssize_t *outlen)
+static esp_err_t sec2_check_session(session_t *cur_session, uint32_t session_id)
 {
-    session_t *cur_session = (session_t *) handle;
     if (!cur_session) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (!cur_session || cur_session->id != session_id) {
+    if (cur_session->id != session_id) {
         ESP_LOGE(TAG, "Session with ID %" PRId32 "not found", session_id);
         return ESP_ERR_INVALID_STATE;
     }
@@ -472,24 +596,37 @@ static esp_err_t sec2_encrypt(protocomm_security_handle_t handle,
         ESP_LOGE(TAG, "Invalid counter value, restart session");
         return ESP_ERR_INVALID_STATE;
     }
-    hexdump("Encrypt IV", (char *)cur_session->iv, AES_GCM_IV_SIZE);
+    return ESP_OK;
+}
+
+static esp_err_t sec2_encrypt_to_buf(protocomm_security_handle_t handle,
+                                     uint32_t session_id,
+                                     const uint8_t *inbuf, ssize_t inlen,
+                                     uint8_t *outbuf, ssize_t outbuf_size, ssize_t *outlen)
+{
+    session_t *cur_session = (session_t *) handle;
+    esp_err_t err = sec2_check_session(cur_session, session_id);
+    if (err != ESP_OK) {
+        return err;
+    }
 
+    if (inlen < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
     *outlen = inlen + AES_GCM_TAG_LEN;
-    *outbuf = (uint8_t *) malloc(*outlen);
-    if (!*outbuf) {
-        ESP_LOGE(TAG, "Failed to allocate encrypt buf len %d", *outlen);
-        return ESP_ERR_NO_MEM;
+    if (outbuf_size < *outlen) {
+        return ESP_ERR_INVALID_SIZE;
     }
-    uint8_t gcm_tag[AES_GCM_TAG_LEN];
+    hexdump("Encrypt IV", (char *)cur_session->iv, AES_GCM_IV_SIZE);
 
+    /* Encryption may be done in place, the tag is appended to the ciphertext */
     int ret = mbedtls_gcm_crypt_and_tag(&cur_session->ctx_gcm, MBEDTLS_GCM_ENCRYPT, inlen, cur_session->iv,
                                         AES_GCM_IV_SIZE, NULL, 0, inbuf,
-                                        *outbuf, AES_GCM_TAG_LEN, gcm_tag);
+                                        outbuf, AES_GCM_TAG_LEN, outbuf + inlen);
     if (ret != 0) {
         ESP_LOGE(TAG, "Failed at mbedtls_gcm_crypt_and_tag with error code : %d", ret);
         return ESP_FAIL;
     }
-    memcpy(*outbuf + inlen, gcm_tag, AES_GCM_TAG_LEN);
 
     /* Increment counter value for next operation */
     sec2_gcm_iv_counter_increment(cur_session->iv);
@@ -497,51 +634,83 @@ static esp_err_t sec2_encrypt(protocomm_security_handle_t handle,
     return ESP_OK;
 }
 
-static esp_err_t sec2_decrypt(protocomm_security_handle_t handle,
-                              uint32_t session_id,
-                              const uint8_t *inbuf, ssize_t inlen,
-                              uint8_t **outbuf, ssize_t *outlen)
+static esp_err_t sec2_decrypt_to_buf(protocomm_security_handle_t handle,
+                                     uint32_t session_id,
+                                     const uint8_t *inbuf, ssize_t inlen,
+                                     uint8_t *outbuf, ssize_t outbuf_size, ssize_t *outlen)
 {
     session_t *cur_session = (session_t *) handle;
-    if (!cur_session) {
-        return ESP_ERR_INVALID_ARG;
+    esp_err_t err = sec2_check_session(cur_session, session_id);
+    if (err != ESP_OK) {
+        return err;
     }
 
-    if (!cur_session || cur_session->id != session_id) {
-        ESP_LOGE(TAG, "Session with ID %" PRId32 "not found", session_id);
-        return ESP_ERR_INVALID_STATE;
+    if (inlen < AES_GCM_TAG_LEN) {
+        ESP_LOGE(TAG, "Encrypted data too short");
+        return ESP_ERR_INVALID_ARG;
+    }
+    *outlen = inlen - AES_GCM_TAG_LEN;
+    if (outbuf_size < *outlen) {
+        return ESP_ERR_INVALID_SIZE;
     }
+    hexdump("Decrypt IV", (char *)cur_session->iv, AES_GCM_IV_SIZE);
 
-    if (cur_session->state != SESSION_STATE_DONE) {
-        ESP_LOGE(TAG, "Secure session not established");
-        return ESP_ERR_INVALID_STATE;
+    /* The tag follows the ciphertext, it is left untouched when decrypting in place */
+    int ret = mbedtls_gcm_auth_decrypt(&cur_session->ctx_gcm, *outlen, cur_session->iv,
+                                       AES_GCM_IV_SIZE, NULL, 0, inbuf + *outlen, AES_GCM_TAG_LEN, inbuf, outbuf);
+    if (ret != 0) {
+        ESP_LOGE(TAG, "Failed at mbedtls_gcm_auth_decrypt : %d", ret);
+        return ESP_FAIL;
     }
 
-    aes_gcm_iv_t *iv = (aes_gcm_iv_t *) cur_session->iv;
-    if (be32toh(iv->counter) == 0) {
-        ESP_LOGE(TAG, "Invalid counter value, restart session");
-        return ESP_ERR_INVALID_STATE;
+    /* Increment counter value for next operation */
+    sec2_gcm_iv_counter_increment(cur_session->iv);
+
+    return ESP_OK;
+}
+
+static esp_err_t sec2_encrypt(protocomm_security_handle_t handle,
+                              uint32_t session_id,
+                              const uint8_t *inbuf, ssize_t inlen,
+                              uint8_t **outbuf, ssize_t *outlen)
+{
+    esp_err_t err = sec2_check_session((session_t *) handle, session_id);
+    if (err != ESP_OK) {
+        return err;
     }
-    hexdump("Decrypt IV", (char *)cur_session->iv, AES_GCM_IV_SIZE);
 
-    *outlen = inlen - AES_GCM_TAG_LEN;
+    *outlen = inlen + AES_GCM_TAG_LEN;
     *outbuf = (uint8_t *) malloc(*outlen);
     if (!*outbuf) {
-        ESP_LOGE(TAG, "Failed to allocate decrypt buf len %d", *outlen);
+        ESP_LOGE(TAG, "Failed to allocate encrypt buf len %d", *outlen);
         return ESP_ERR_NO_MEM;
     }
 
-    int ret = mbedtls_gcm_auth_decrypt(&cur_session->ctx_gcm, inlen - AES_GCM_TAG_LEN, cur_session->iv,
-                                       AES_GCM_IV_SIZE, NULL, 0, inbuf + (inlen - AES_GCM_TAG_LEN), AES_GCM_TAG_LEN, inbuf, *outbuf);
-    if (ret != 0) {
-        ESP_LOGE(TAG, "Failed at mbedtls_gcm_auth_decrypt : %d", ret);
-        return ESP_FAIL;
+    return sec2_encrypt_to_buf(handle, session_id, inbuf, inlen, *outbuf, *outlen, outlen);
+}
+
+static esp_err_t sec2_decrypt(protocomm_security_handle_t handle,
+                              uint32_t session_id,
+                              const uint8_t *inbuf, ssize_t inlen,
+                              uint8_t **outbuf, ssize_t *outlen)
+{
+    esp_err_t err = sec2_check_session((session_t *) handle, session_id);
+    if (err != ESP_OK) {
+        return err;
     }
 
-    /* Increment counter value for next operation */
-    sec2_gcm_iv_counter_increment(cur_session->iv);
+    if (inlen < AES_GCM_TAG_LEN) {
+        ESP_LOGE(TAG, "Encrypted data too short");
+        return ESP_ERR_INVALID_ARG;
+    }
+    *outlen = inlen - AES_GCM_TAG_LEN;
+    *outbuf = (uint8_t *) malloc(*outlen);
+    if (!*outbuf) {
+        ESP_LOGE(TAG, "Failed to allocate decrypt buf len %d", *outlen);
+        return ESP_ERR_NO_MEM;
+    }
 
-    return ESP_OK;
+    return sec2_decrypt_to_buf(handle, session_id, inbuf, inlen, *outbuf, *outlen, outlen);
 }
 
 static esp_err_t sec2_req_handler(protocomm_security_handle_t handle,
@@ -610,4 +779,6 @@ const protocomm_security_t protocomm_security2 = {
     .security_req_handler = sec2_req_handler,
     .encrypt = sec2_encrypt,
     .decrypt = sec2_decrypt,
+    .encrypt_to_buf = sec2_encrypt_to_buf,
+    .decrypt_to_buf = sec2_decrypt_to_buf,
 };
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2022 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -63,7 +63,7 @@ static bool stopped(void)
 static void protocomm_console_task(void *arg)
 {
     int uart_num = (int) arg;
-    uint8_t linebuf[LINE_BUF_SIZE];
+    uint8_t linebuf[LINE_BUF_SIZE + 1]; /* at most LINE_BUF_SIZE bytes are read, the last one stays '\0' */
     int i, cmd_ret;
     esp_err_t ret;
     QueueHandle_t uart_queue;
@@ -94,7 +94,7 @@ static void protocomm_console_task(void *arg)
                 }
             }
             if (event.type == UART_DATA) {
-                while (uart_read_bytes(uart_num, (uint8_t *) &linebuf[i], 1, 0) && (i < LINE_BUF_SIZE)) {
+                while ((i < LINE_BUF_SIZE) && uart_read_bytes(uart_num, (uint8_t *) &linebuf[i], 1, 0)) {
                     if (linebuf[i] == '\r') {
                         uart_write_bytes(uart_num, "\r\n", 2);
                     } else {
@@ -110,7 +110,7 @@ static void protocomm_console_task(void *arg)
         if (stopped()) {
             break;
         }
-        ret = esp_console_run((char *) linebuf, &cmd_ret);
+        ret = esp_console_run_in_place((char *) linebuf, &cmd_ret);
         if (ret < 0) {
             ESP_LOGE(TAG, "Console dispatcher error");
             break;
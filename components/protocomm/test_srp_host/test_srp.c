@@ -0,0 +1,426 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Host test of the SRP6a server (esp_srp.c) against a client written with mbedTLS, following
+ * tools/esp_prov/security/srp6a.py, and of the fixed base exponentiation of esp_srp_mpi.c against
+ * mbedtls_mpi_exp_mod(). Prints the server side time of the session setup. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <time.h>
+#include <sys/random.h>
+#include <mbedtls/bignum.h>
+#include <mbedtls/sha512.h>
+#include "esp_err.h"
+#include "esp_srp.h"
+#include "esp_srp_mpi.h"
+
+#define SESSION_ROUNDS      5
+#define FIXED_BASE_ROUNDS   20
+
+#define FAIL(format, ...)   printf("FAIL %s: " format "\n", __func__, ##__VA_ARGS__)
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+#define SRP_PUBLIC_KEY_LEN  384
+#define SRP_HASH_LEN        64
+
+static const char srp_username[] = "wifiprov";
+static const char srp_password[] = "abcd1234";
+
+/* Salt and verifier of srp_username and srp_password,
+ * generated by tools/esp_prov/security/srp6a.py */
+static const uint8_t srp_salt[] = {
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+
+static const uint8_t srp_verifier[] = {
+    0xc9, 0x39, 0x55, 0x52, 0xd4, 0x7c, 0x23, 0x4a, 0xa5, 0x1f, 0xb7, 0xe1, 0x26, 0xaf, 0x98, 0xdf,
+    0x40, 0x2c, 0xe4, 0xdb, 0x96, 0xfa, 0x56, 0x45, 0x2f, 0x87, 0x1f, 0xc6, 0x2d, 0xe4, 0x45, 0xdf,
+    0xe2, 0x35, 0x7e, 0xd0, 0x71, 0x9a, 0xba, 0x51, 0x8e, 0x00, 0x86, 0x54, 0x76, 0x70, 0xe0, 0xb9,
+    0xff, 0x61, 0xa2, 0xb5, 0x83, 0x5b, 0x7d, 0xda, 0x24, 0x9c, 0xd2, 0x72, 0x82, 0x2d, 0x1a, 0x60,
+    0x9f, 0x9f, 0xad, 0x56, 0xca, 0x6e, 0x20, 0x9b, 0x49, 0x68, 0x68, 0x69, 0x4a, 0xf8, 0x60, 0x22,
+    0x48, 0x8f, 0x90, 0x39, 0x95, 0xbf, 0xe8, 0x59, 0xf7, 0x18, 0x02, 0x27, 0xd9, 0xe3, 0xbc, 0x0d,
+    0xa1, 0x56, 0x3f, 0xbd, 0x36, 0x48, 0x9c, 0xd8, 0xb2, 0x95, 0x01, 0x1d, 0x58, 0xd1, 0xab, 0xe0,
+    0x16, 0x44, 0x92, 0x3d, 0xc4, 0x8b, 0xe1, 0xcc, 0xa3, 0x7a, 0x17, 0x86, 0x5a, 0xd9, 0xf2, 0x4b,
+    0xde, 0x3b, 0xef, 0xba, 0x02, 0x11, 0x64, 0xb1, 0xae, 0x4b, 0x6f, 0xd3, 0x5c, 0x6f, 0xa7, 0xde,
+    0x7a, 0x7d, 0x78, 0xae, 0x3b, 0x84, 0x00, 0xf1, 0x71, 0x7f, 0xee, 0x2b, 0x40, 0x3f, 0xe0, 0x32,
+    0xc5, 0x56, 0xb1, 0x43, 0x9c, 0x6b, 0x9b, 0xf0, 0x71, 0x7d, 0xcf, 0x3a, 0x10, 0xa7, 0x6d, 0x3e,
+    0x76, 0x3f, 0x0c, 0xb0, 0xe5, 0x37, 0x5b, 0xb8, 0x54, 0x13, 0xdb, 0x41, 0x1a, 0x7b, 0x5f, 0x03,
+    0xc1, 0xef, 0x22, 0x61, 0xb2, 0x45, 0xe9, 0xca, 0x4f, 0x6a, 0x27, 0xfc, 0xc2, 0x95, 0xd8, 0x24,
+    0xa3, 0x9e, 0x20, 0xbb, 0x46, 0x01, 0xb8, 0xd2, 0xb7, 0xa2, 0x77, 0x71, 0x31, 0x61, 0x2d, 0xdf,
+    0xc1, 0x3f, 0xec, 0xbe, 0xbb, 0x49, 0x8c, 0xf3, 0xa3, 0xfd, 0x83, 0x18, 0xa6, 0x5e, 0x00, 0xad,
+    0xc1, 0xb0, 0xc6, 0xb5, 0xd4, 0x2a, 0x1d, 0x06, 0x8c, 0x49, 0xbb, 0x88, 0x4c, 0x21, 0xaa, 0xba,
+    0xaf, 0x32, 0x68, 0xee, 0xf8, 0x67, 0x58, 0xa1, 0xf9, 0x8c, 0xe3, 0x3d, 0x28, 0xf8, 0x8d, 0xbf,
+    0xf8, 0x43, 0x9b, 0x21, 0x26, 0xd2, 0x96, 0x35, 0x75, 0xff, 0x90, 0xb2, 0x19, 0x88, 0x1d, 0xf4,
+    0xe8, 0xb0, 0x8b, 0xb3, 0x66, 0x80, 0xe6, 0x1a, 0x0d, 0xc7, 0x0d, 0x4c, 0x47, 0xcf, 0x16, 0xbb,
+    0xea, 0x2c, 0xd5, 0x98, 0x24, 0x33, 0x84, 0x79, 0x93, 0x76, 0xe8, 0xff, 0xe2, 0xc6, 0xad, 0x3c,
+    0xb1, 0xcc, 0x1a, 0xb5, 0x47, 0x06, 0xc4, 0x32, 0xb3, 0xae, 0x65, 0xa2, 0x77, 0xe2, 0xad, 0xe0,
+    0x2b, 0x16, 0x30, 0x99, 0x2a, 0xd7, 0xa9, 0x42, 0xf1, 0x7b, 0xc0, 0xda, 0xbd, 0x98, 0xce, 0xdc,
+    0x5d, 0xb9, 0x3d, 0x68, 0x11, 0xff, 0xc0, 0xff, 0x0f, 0x92, 0x37, 0x5a, 0x73, 0x2c, 0xeb, 0xee,
+    0x06, 0x7a, 0x9a, 0x36, 0x5d, 0xf1, 0x60, 0x70, 0x2e, 0x5d, 0x65, 0x2b, 0xd8, 0x6a, 0x6d, 0xa1,
+};
+
+/* 3072 bit group of RFC 5054 */
+static const char srp_N_hex[] =
+    "FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129024E088A67CC74"
+    "020BBEA63B139B22514A08798E3404DDEF9519B3CD3A431B302B0A6DF25F1437"
+    "4FE1356D6D51C245E485B576625E7EC6F44C42E9A637ED6B0BFF5CB6F406B7ED"
+    "EE386BFB5A899FA5AE9F24117C4B1FE649286651ECE45B3DC2007CB8A163BF05"
+    "98DA48361C55D39A69163FA8FD24CF5F83655D23DCA3AD961C62F356208552BB"
+    "9ED529077096966D670C354E4ABC9804F1746C08CA18217C32905E462E36CE3B"
+    "E39E772C180E86039B2783A2EC07A28FB5C55DF06F4C52C9DE2BCBF695581718"
+    "3995497CEA956AE515D2261898FA051015728E5A8AAAC42DAD33170D04507A33"
+    "A85521ABDF1CBA64ECFB850458DBEF0A8AEA71575D060C7DB3970F85A6E1E4C7"
+    "ABF5AE8CDB0933D71E8C94E04A25619DCEE3D2261AD2EE6BF12FFA06D98A0864"
+    "D87602733EC86A64521F2B18177B200CBBE117577A615D6C770988C0BAD946E2"
+    "08E24FA074E5AB3143DB5BFCE0FD108E4B82D120A93AD2CAFFFFFFFFFFFFFFFF";
+static const int srp_g = 5;
+
+/* Client side of SRP6a, following tools/esp_prov/security/srp6a.py */
+typedef struct {
+    mbedtls_mpi N;
+    mbedtls_mpi g;
+    mbedtls_mpi a;
+    mbedtls_mpi A;
+    uint8_t bytes_A[SRP_PUBLIC_KEY_LEN];
+    uint8_t K[SRP_HASH_LEN];
+    uint8_t M[SRP_HASH_LEN];
+    uint8_t H_AMK[SRP_HASH_LEN];
+} srp_client_t;
+
+static int srp_rand(void *ctx, unsigned char *buf, size_t len)
+{
+    getrandom(buf, len, 0);
+    return 0;
+}
+
+/* digest = H(PAD(a) | PAD(b)) */
+static int srp_hash_padded(const mbedtls_mpi *a, const mbedtls_mpi *b, uint8_t *digest)
+{
+    int ret;
+    uint8_t *buf = malloc(2 * SRP_PUBLIC_KEY_LEN);
+    if (!buf) {
+        return MBEDTLS_ERR_MPI_ALLOC_FAILED;
+    }
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(a, buf, SRP_PUBLIC_KEY_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(b, buf + SRP_PUBLIC_KEY_LEN, SRP_PUBLIC_KEY_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512(buf, 2 * SRP_PUBLIC_KEY_LEN, digest, 0));
+cleanup:
+    free(buf);
+    return ret;
+}
+
+static void srp_client_free(srp_client_t *client)
+{
+    mbedtls_mpi_free(&client->N);
+    mbedtls_mpi_free(&client->g);
+    mbedtls_mpi_free(&client->a);
+    mbedtls_mpi_free(&client->A);
+}
+
+/* Generate a and A = g^a */
+static int srp_client_start(srp_client_t *client)
+{
+    int ret;
+    mbedtls_mpi_init(&client->N);
+    mbedtls_mpi_init(&client->g);
+    mbedtls_mpi_init(&client->a);
+    mbedtls_mpi_init(&client->A);
+
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_string(&client->N, 16, srp_N_hex));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_lset(&client->g, srp_g));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_fill_random(&client->a, 32, srp_rand, NULL));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_exp_mod(&client->A, &client->g, &client->a, &client->N, NULL));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&client->A, client->bytes_A, SRP_PUBLIC_KEY_LEN));
+cleanup:
+    return ret;
+}
+
+/* Compute the session key K, the client proof M and the expected server proof H(A, M, K) */
+static int srp_client_process(srp_client_t *client, const uint8_t *salt, int salt_len,
+                              const uint8_t *bytes_B, int len_B)
+{
+    int ret;
+    uint8_t digest[SRP_HASH_LEN];
+    uint8_t hash_g[SRP_HASH_LEN];
+    uint8_t buf[SRP_PUBLIC_KEY_LEN];
+    size_t len_S;
+    mbedtls_mpi B, u, k, x, t, e, S;
+    mbedtls_sha512_context ctx;
+
+    mbedtls_mpi_init(&B);
+    mbedtls_mpi_init(&u);
+    mbedtls_mpi_init(&k);
+    mbedtls_mpi_init(&x);
+    mbedtls_mpi_init(&t);
+    mbedtls_mpi_init(&e);
+    mbedtls_mpi_init(&S);
+    mbedtls_sha512_init(&ctx);
+
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&B, bytes_B, len_B));
+
+    /* u = H(PAD(A) | PAD(B)), k = H(N | PAD(g)) */
+    MBEDTLS_MPI_CHK(srp_hash_padded(&client->A, &B, digest));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&u, digest, sizeof(digest)));
+    MBEDTLS_MPI_CHK(srp_hash_padded(&client->N, &client->g, digest));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&k, digest, sizeof(digest)));
+
+    /* x = H(s | H(I | ":" | P)) */
+    MBEDTLS_MPI_CHK(mbedtls_sha512_starts(&ctx, 0));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, (const uint8_t *) srp_username, strlen(srp_username)));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, (const uint8_t *) ":", 1));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, (const uint8_t *) srp_password, strlen(srp_password)));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_finish(&ctx, digest));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_starts(&ctx, 0));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, salt, salt_len));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, digest, sizeof(digest)));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_finish(&ctx, digest));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&x, digest, sizeof(digest)));
+
+    /* S = (B - k * g^x) ^ (a + u * x) */
+    MBEDTLS_MPI_CHK(mbedtls_mpi_exp_mod(&t, &client->g, &x, &client->N, NULL));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&t, &t, &k));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_sub_mpi(&t, &B, &t));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&t, &t, &client->N));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&e, &u, &x));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_add_mpi(&e, &e, &client->a));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_exp_mod(&S, &t, &e, &client->N, NULL));
+
+    /* K = H(S) */
+    len_S = mbedtls_mpi_size(&S);
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&S, buf, len_S));
+    MBEDTLS_MPI_CHK(mbedtls_sha512(buf, len_S, client->K, 0));
+
+    /* M = H(H(N) xor H(PAD(g)) | H(I) | s | A | B | K) */
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&client->N, buf, SRP_PUBLIC_KEY_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512(buf, SRP_PUBLIC_KEY_LEN, digest, 0));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&client->g, buf, SRP_PUBLIC_KEY_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512(buf, SRP_PUBLIC_KEY_LEN, hash_g, 0));
+    for (int i = 0; i < SRP_HASH_LEN; i++) {
+        digest[i] ^= hash_g[i];
+    }
+    MBEDTLS_MPI_CHK(mbedtls_sha512_starts(&ctx, 0));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, digest, sizeof(digest)));
+    MBEDTLS_MPI_CHK(mbedtls_sha512((const uint8_t *) srp_username, strlen(srp_username), digest, 0));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, digest, sizeof(digest)));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, salt, salt_len));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, client->bytes_A, SRP_PUBLIC_KEY_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, bytes_B, len_B));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, client->K, SRP_HASH_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_finish(&ctx, client->M));
+
+    /* H(A | M | K) */
+    MBEDTLS_MPI_CHK(mbedtls_sha512_starts(&ctx, 0));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, client->bytes_A, SRP_PUBLIC_KEY_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, client->M, SRP_HASH_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_update(&ctx, client->K, SRP_HASH_LEN));
+    MBEDTLS_MPI_CHK(mbedtls_sha512_finish(&ctx, client->H_AMK));
+
+cleanup:
+    mbedtls_sha512_free(&ctx);
+    mbedtls_mpi_free(&B);
+    mbedtls_mpi_free(&u);
+    mbedtls_mpi_free(&k);
+    mbedtls_mpi_free(&x);
+    mbedtls_mpi_free(&t);
+    mbedtls_mpi_free(&e);
+    mbedtls_mpi_free(&S);
+    return ret;
+}
+
+/* Run the server side of the session setup against srp_client_t.
+ * elapsed_us is the time spent on the device side up to the session key */
+static esp_err_t test_srp6a_session(const char *salt, int salt_len, const char *verifier, int verifier_len,
+                                    bool pregen, int64_t *elapsed_us)
+{
+    esp_err_t ret = ESP_FAIL;
+    char *bytes_B = NULL;
+    int len_B = 0;
+    char *key = NULL;
+    uint16_t key_len = 0;
+    char host_proof[SRP_HASH_LEN];
+
+    srp_client_t *client = calloc(1, sizeof(srp_client_t));
+    if (!client) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (srp_client_start(client) != 0) {
+        FAIL("Error generating client key");
+        goto out;
+    }
+
+    esp_srp_handle_t *hd = esp_srp_init(ESP_NG_3072);
+    if (!hd) {
+        FAIL("Error initializing SRP context");
+        goto out;
+    }
+    if (pregen) {
+        if (esp_srp_srv_gen_ephemeral_key(hd) != ESP_OK) {
+            FAIL("Error generating ephemeral key");
+            goto out_srp;
+        }
+        if (esp_srp_srv_gen_ephemeral_key(hd) != ESP_ERR_INVALID_STATE) {
+            FAIL("Ephemeral key generated twice");
+            goto out_srp;
+        }
+    }
+
+    int64_t start = now_us();
+    if (esp_srp_set_salt_verifier(hd, salt, salt_len, verifier, verifier_len) != ESP_OK ||
+            esp_srp_srv_pubkey_from_salt_verifier(hd, &bytes_B, &len_B) != ESP_OK ||
+            esp_srp_get_session_key(hd, (char *) client->bytes_A, SRP_PUBLIC_KEY_LEN, &key, &key_len) != ESP_OK) {
+        FAIL("Error generating session key");
+        goto out_srp;
+    }
+    *elapsed_us = now_us() - start;
+
+    if (srp_client_process(client, (const uint8_t *) salt, salt_len, (const uint8_t *) bytes_B, len_B) != 0) {
+        FAIL("Error computing client session key");
+        goto out_srp;
+    }
+    if (key_len != SRP_HASH_LEN || memcmp(key, client->K, SRP_HASH_LEN) != 0) {
+        FAIL("Session key mismatch");
+        goto out_srp;
+    }
+
+    client->M[0] ^= 1;
+    if (esp_srp_exchange_proofs(hd, (char *) srp_username, strlen(srp_username),
+                                (char *) client->M, host_proof) == ESP_OK) {
+        FAIL("Wrong client proof accepted");
+        goto out_srp;
+    }
+    client->M[0] ^= 1;
+    if (esp_srp_exchange_proofs(hd, (char *) srp_username, strlen(srp_username),
+                                (char *) client->M, host_proof) != ESP_OK) {
+        FAIL("Client proof rejected");
+        goto out_srp;
+    }
+    if (memcmp(host_proof, client->H_AMK, SRP_HASH_LEN) != 0) {
+        FAIL("Server proof mismatch");
+        goto out_srp;
+    }
+    ret = ESP_OK;
+
+out_srp:
+    esp_srp_free(hd);
+out:
+    srp_client_free(client);
+    free(client);
+    return ret;
+}
+
+/* base^e mod N with the comb table, compared with mbedtls_mpi_exp_mod() for exponents of every length up to
+ * the size of the table, and rejection of longer exponents */
+static esp_err_t test_fixed_base(void)
+{
+    const int exp_bits = 8 * SRP_PUBLIC_KEY_LEN;
+    esp_err_t ret = ESP_FAIL;
+    mbedtls_mpi N, base, e, expected, result;
+    mbedtls_mpi_init(&N);
+    mbedtls_mpi_init(&base);
+    mbedtls_mpi_init(&e);
+    mbedtls_mpi_init(&expected);
+    mbedtls_mpi_init(&result);
+
+    esp_mpi_fixed_base_t *fb = NULL;
+    if (mbedtls_mpi_read_string(&N, 16, srp_N_hex) != 0 ||
+            mbedtls_mpi_fill_random(&base, SRP_PUBLIC_KEY_LEN - 1, srp_rand, NULL) != 0 ||
+            (fb = esp_mpi_fixed_base_new(&base, &N, exp_bits)) == NULL) {
+        FAIL("Error building the table");
+        goto out;
+    }
+
+    for (int i = 0; i <= FIXED_BASE_ROUNDS; i++) {
+        /* 0, then random exponents of growing length, the last one of exp_bits bits */
+        size_t len = (size_t) i * SRP_PUBLIC_KEY_LEN / FIXED_BASE_ROUNDS;
+        if (mbedtls_mpi_lset(&e, 0) != 0 || (len > 0 && mbedtls_mpi_fill_random(&e, len, srp_rand, NULL) != 0) ||
+                mbedtls_mpi_exp_mod(&expected, &base, &e, &N, NULL) != 0) {
+            FAIL("Error computing the expected value");
+            goto out;
+        }
+        if (esp_mpi_fixed_base_exp(&result, fb, &e) != 0 || mbedtls_mpi_cmp_mpi(&result, &expected) != 0) {
+            FAIL("Wrong result for an exponent of %zu bits", mbedtls_mpi_bitlen(&e));
+            goto out;
+        }
+    }
+
+    if (mbedtls_mpi_lset(&e, 1) != 0 || mbedtls_mpi_shift_l(&e, exp_bits) != 0 ||
+            esp_mpi_fixed_base_exp(&result, fb, &e) == 0) {
+        FAIL("Exponent longer than the table accepted");
+        goto out;
+    }
+    ret = ESP_OK;
+
+out:
+    esp_mpi_fixed_base_free(fb);
+    mbedtls_mpi_free(&N);
+    mbedtls_mpi_free(&base);
+    mbedtls_mpi_free(&e);
+    mbedtls_mpi_free(&expected);
+    mbedtls_mpi_free(&result);
+    return ret;
+}
+
+static esp_err_t test_srp6a(void)
+{
+    int64_t elapsed_us, total_us = 0;
+    char *salt = NULL;
+    char *verifier = NULL;
+    int verifier_len = 0;
+
+    /* The first session also builds the precomputed tables, if enabled */
+    for (int i = 0; i < SESSION_ROUNDS; i++) {
+        if (test_srp6a_session((const char *) srp_salt, sizeof(srp_salt), (const char *) srp_verifier,
+                               sizeof(srp_verifier), false, &elapsed_us) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        if (i == 0) {
+            printf("First session setup: %" PRId64 " us\n", elapsed_us);
+        } else {
+            total_us += elapsed_us;
+        }
+    }
+    printf("Session setup: %" PRId64 " us\n", total_us / (SESSION_ROUNDS - 1));
+
+    total_us = 0;
+    for (int i = 0; i < SESSION_ROUNDS; i++) {
+        if (test_srp6a_session((const char *) srp_salt, sizeof(srp_salt), (const char *) srp_verifier,
+                               sizeof(srp_verifier), true, &elapsed_us) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        total_us += elapsed_us;
+    }
+    printf("Session setup with pre-generated ephemeral key: %" PRId64 " us\n", total_us / SESSION_ROUNDS);
+
+    /* Salt and verifier generated by the server */
+    if (esp_srp_gen_salt_verifier(srp_username, strlen(srp_username), srp_password, strlen(srp_password),
+                                  &salt, 16, &verifier, &verifier_len) != ESP_OK) {
+        FAIL("Error generating salt and verifier");
+        return ESP_FAIL;
+    }
+    esp_err_t ret = test_srp6a_session(salt, 16, verifier, verifier_len, false, &elapsed_us);
+    free(salt);
+    free(verifier);
+    return ret;
+}
+
+int main(void)
+{
+    printf("Testing SRP6a, fixed base tables %s\n", CONFIG_ESP_PROTOCOMM_SRP_FIXED_BASE_TABLES ? "enabled" : "disabled");
+
+    if (test_fixed_base() != ESP_OK || test_srp6a() != ESP_OK) {
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
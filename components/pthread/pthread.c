@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -40,7 +40,8 @@ enum esp_pthread_task_state {
 
 /** pthread thread FreeRTOS wrapper */
 typedef struct esp_pthread_entry {
-    SLIST_ENTRY(esp_pthread_entry)  list_node;  ///< Tasks list node struct.
+    SLIST_ENTRY(esp_pthread_entry)  desc_node;  ///< Node in a bucket of s_threads_by_desc
+    SLIST_ENTRY(esp_pthread_entry)  handle_node;///< Node in a bucket of s_threads_by_handle
     TaskHandle_t                handle;         ///< FreeRTOS task handle
     TaskHandle_t                join_task;      ///< Handle of the task waiting to join
     enum esp_pthread_task_state state;          ///< pthread task state
@@ -56,19 +57,17 @@ typedef struct {
     esp_pthread_cfg_t cfg;  ///< pthread configuration
 } esp_pthread_task_arg_t;
 
-/** pthread mutex FreeRTOS wrapper */
-typedef struct {
-    SemaphoreHandle_t   sem;        ///< Handle of the task waiting to join
-    int                 type;       ///< Mutex type. Currently supported PTHREAD_MUTEX_NORMAL and PTHREAD_MUTEX_RECURSIVE
-} esp_pthread_mutex_t;
-
 static _lock_t s_threads_lock;
 portMUX_TYPE pthread_lazy_init_lock  = portMUX_INITIALIZER_UNLOCKED; // Used for mutexes and cond vars and rwlocks
-static SLIST_HEAD(esp_thread_list_head, esp_pthread_entry) s_threads_list
-    = SLIST_HEAD_INITIALIZER(s_threads_list);
-static pthread_key_t s_pthread_cfg_key;
 
-static int pthread_mutex_lock_internal(esp_pthread_mutex_t *mux, TickType_t tmo);
+/* Threads are indexed both by descriptor (the pthread_t, which has to be checked before being used)
+ * and by FreeRTOS task handle, in hash tables protected by s_threads_lock */
+#define PTHREAD_INDEX_BUCKETS_BITS  4
+#define PTHREAD_INDEX_BUCKETS       (1 << PTHREAD_INDEX_BUCKETS_BITS)
+SLIST_HEAD(esp_thread_list_head, esp_pthread_entry);
+static struct esp_thread_list_head s_threads_by_desc[PTHREAD_INDEX_BUCKETS];
+static struct esp_thread_list_head s_threads_by_handle[PTHREAD_INDEX_BUCKETS];
+static pthread_key_t s_pthread_cfg_key;
 
 static void esp_pthread_cfg_key_destructor(void *value)
 {
@@ -95,47 +94,44 @@ esp_err_t esp_pthread_init(void)
     return ESP_OK;
 }
 
-static void *pthread_list_find_item(void *(*item_check)(esp_pthread_t *, void *arg), void *check_arg)
+static inline size_t pthread_index_bucket(const void *ptr)
 {
-    esp_pthread_t *it;
-    SLIST_FOREACH(it, &s_threads_list, list_node) {
-        void *val = item_check(it, check_arg);
-        if (val) {
-            return val;
-        }
-    }
-    return NULL;
+    // Fibonacci hashing, which uses the high bits of the product as the low bits of pointers are zero
+    return ((uint32_t)(uintptr_t)ptr * 2654435769U) >> (32 - PTHREAD_INDEX_BUCKETS_BITS);
 }
 
-static void *pthread_get_handle_by_desc(esp_pthread_t *item, void *desc)
+static inline TaskHandle_t pthread_find_handle(pthread_t thread)
 {
-    if (item == desc) {
-        return item->handle;
+    esp_pthread_t *it;
+    SLIST_FOREACH(it, &s_threads_by_desc[pthread_index_bucket((void *)thread)], desc_node) {
+        if (it == (esp_pthread_t *)thread) {
+            return it->handle;
+        }
     }
     return NULL;
 }
 
-static void *pthread_get_desc_by_handle(esp_pthread_t *item, void *hnd)
+static esp_pthread_t *pthread_find(TaskHandle_t task_handle)
 {
-    if (hnd == item->handle) {
-        return item;
+    esp_pthread_t *it;
+    SLIST_FOREACH(it, &s_threads_by_handle[pthread_index_bucket(task_handle)], handle_node) {
+        if (it->handle == task_handle) {
+            return it;
+        }
     }
     return NULL;
 }
 
-static inline TaskHandle_t pthread_find_handle(pthread_t thread)
-{
-    return pthread_list_find_item(pthread_get_handle_by_desc, (void *)thread);
-}
-
-static esp_pthread_t *pthread_find(TaskHandle_t task_handle)
+static void pthread_insert(esp_pthread_t *pthread)
 {
-    return pthread_list_find_item(pthread_get_desc_by_handle, task_handle);
+    SLIST_INSERT_HEAD(&s_threads_by_desc[pthread_index_bucket(pthread)], pthread, desc_node);
+    SLIST_INSERT_HEAD(&s_threads_by_handle[pthread_index_bucket(pthread->handle)], pthread, handle_node);
 }
 
 static void pthread_delete(esp_pthread_t *pthread)
 {
-    SLIST_REMOVE(&s_threads_list, pthread, esp_pthread_entry, list_node);
+    SLIST_REMOVE(&s_threads_by_desc[pthread_index_bucket(pthread)], pthread, esp_pthread_entry, desc_node);
+    SLIST_REMOVE(&s_threads_by_handle[pthread_index_bucket(pthread->handle)], pthread, esp_pthread_entry, handle_node);
     free(pthread);
 }
 
@@ -407,7 +403,7 @@ int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
 
     _lock_acquire(&s_threads_lock);
 
-    SLIST_INSERT_HEAD(&s_threads_list, pthread, list_node);
+    pthread_insert(pthread);
     _lock_release(&s_threads_lock);
 
     // start task
@@ -608,250 +604,6 @@ int pthread_once(pthread_once_t *once_control, void (*init_routine)(void))
     return 0;
 }
 
-/***************** MUTEX ******************/
-static int mutexattr_check(const pthread_mutexattr_t *attr)
-{
-    if (attr->type != PTHREAD_MUTEX_NORMAL &&
-            attr->type != PTHREAD_MUTEX_RECURSIVE &&
-            attr->type != PTHREAD_MUTEX_ERRORCHECK) {
-        return EINVAL;
-    }
-    return 0;
-}
-
-int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
-{
-    int type = PTHREAD_MUTEX_NORMAL;
-
-    if (!mutex) {
-        return EINVAL;
-    }
-
-    if (attr) {
-        if (!attr->is_initialized) {
-            return EINVAL;
-        }
-        int res = mutexattr_check(attr);
-        if (res) {
-            return res;
-        }
-        type = attr->type;
-    }
-
-    esp_pthread_mutex_t *mux = (esp_pthread_mutex_t *)malloc(sizeof(esp_pthread_mutex_t));
-    if (!mux) {
-        return ENOMEM;
-    }
-    mux->type = type;
-
-    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
-        mux->sem = xSemaphoreCreateRecursiveMutex();
-    } else {
-        mux->sem = xSemaphoreCreateMutex();
-    }
-    if (!mux->sem) {
-        free(mux);
-        return EAGAIN;
-    }
-
-    *mutex = (pthread_mutex_t)mux; // pointer value fit into pthread_mutex_t (uint32_t)
-
-    return 0;
-}
-
-int pthread_mutex_destroy(pthread_mutex_t *mutex)
-{
-    esp_pthread_mutex_t *mux;
-
-    ESP_LOGV(TAG, "%s %p", __FUNCTION__, mutex);
-
-    if (!mutex) {
-        return EINVAL;
-    }
-    if ((intptr_t) *mutex == PTHREAD_MUTEX_INITIALIZER) {
-        return 0; // Static mutex was never initialized
-    }
-
-    mux = (esp_pthread_mutex_t *)*mutex;
-    if (!mux) {
-        return EINVAL;
-    }
-
-    // check if mux is busy
-    int res = pthread_mutex_lock_internal(mux, 0);
-    if (res == EBUSY) {
-        return EBUSY;
-    }
-
-    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
-        res = xSemaphoreGiveRecursive(mux->sem);
-    } else {
-        res = xSemaphoreGive(mux->sem);
-    }
-    if (res != pdTRUE) {
-        assert(false && "Failed to release mutex!");
-    }
-    vSemaphoreDelete(mux->sem);
-    free(mux);
-
-    return 0;
-}
-
-static int pthread_mutex_lock_internal(esp_pthread_mutex_t *mux, TickType_t tmo)
-{
-    if (!mux) {
-        return EINVAL;
-    }
-
-    if ((mux->type == PTHREAD_MUTEX_ERRORCHECK) &&
-            (xSemaphoreGetMutexHolder(mux->sem) == xTaskGetCurrentTaskHandle())) {
-        return EDEADLK;
-    }
-
-    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
-        if (xSemaphoreTakeRecursive(mux->sem, tmo) != pdTRUE) {
-            return EBUSY;
-        }
-    } else {
-        if (xSemaphoreTake(mux->sem, tmo) != pdTRUE) {
-            return EBUSY;
-        }
-    }
-
-    return 0;
-}
-
-static int pthread_mutex_init_if_static(pthread_mutex_t *mutex)
-{
-    int res = 0;
-    if ((intptr_t) *mutex == PTHREAD_MUTEX_INITIALIZER) {
-        portENTER_CRITICAL(&pthread_lazy_init_lock);
-        if ((intptr_t) *mutex == PTHREAD_MUTEX_INITIALIZER) {
-            res = pthread_mutex_init(mutex, NULL);
-        }
-        portEXIT_CRITICAL(&pthread_lazy_init_lock);
-    }
-    return res;
-}
-
-int pthread_mutex_lock(pthread_mutex_t *mutex)
-{
-    if (!mutex) {
-        return EINVAL;
-    }
-    int res = pthread_mutex_init_if_static(mutex);
-    if (res != 0) {
-        return res;
-    }
-    return pthread_mutex_lock_internal((esp_pthread_mutex_t *)*mutex, portMAX_DELAY);
-}
-
-int pthread_mutex_timedlock(pthread_mutex_t *mutex, const struct timespec *timeout)
-{
-    if (!mutex) {
-        return EINVAL;
-    }
-    int res = pthread_mutex_init_if_static(mutex);
-    if (res != 0) {
-        return res;
-    }
-
-    struct timespec currtime;
-    clock_gettime(CLOCK_REALTIME, &currtime);
-    TickType_t tmo = ((timeout->tv_sec - currtime.tv_sec) * 1000 +
-                      (timeout->tv_nsec - currtime.tv_nsec) / 1000000) / portTICK_PERIOD_MS;
-
-    res = pthread_mutex_lock_internal((esp_pthread_mutex_t *)*mutex, tmo);
-    if (res == EBUSY) {
-        return ETIMEDOUT;
-    }
-    return res;
-}
-
-int pthread_mutex_trylock(pthread_mutex_t *mutex)
-{
-    if (!mutex) {
-        return EINVAL;
-    }
-    int res = pthread_mutex_init_if_static(mutex);
-    if (res != 0) {
-        return res;
-    }
-    return pthread_mutex_lock_internal((esp_pthread_mutex_t *)*mutex, 0);
-}
-
-int pthread_mutex_unlock(pthread_mutex_t *mutex)
-{
-    esp_pthread_mutex_t *mux;
-
-    if (!mutex) {
-        return EINVAL;
-    }
-    mux = (esp_pthread_mutex_t *)*mutex;
-    if (!mux) {
-        return EINVAL;
-    }
-
-    if (((mux->type == PTHREAD_MUTEX_RECURSIVE) ||
-            (mux->type == PTHREAD_MUTEX_ERRORCHECK)) &&
-            (xSemaphoreGetMutexHolder(mux->sem) != xTaskGetCurrentTaskHandle())) {
-        return EPERM;
-    }
-
-    int ret;
-    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
-        ret = xSemaphoreGiveRecursive(mux->sem);
-    } else {
-        ret = xSemaphoreGive(mux->sem);
-    }
-    if (ret != pdTRUE) {
-        assert(false && "Failed to unlock mutex!");
-    }
-    return 0;
-}
-
-int pthread_mutexattr_init(pthread_mutexattr_t *attr)
-{
-    if (!attr) {
-        return EINVAL;
-    }
-    memset(attr, 0, sizeof(*attr));
-    attr->type = PTHREAD_MUTEX_NORMAL;
-    attr->is_initialized = 1;
-    return 0;
-}
-
-int pthread_mutexattr_destroy(pthread_mutexattr_t *attr)
-{
-    if (!attr) {
-        return EINVAL;
-    }
-    attr->is_initialized = 0;
-    return 0;
-}
-
-int pthread_mutexattr_gettype(const pthread_mutexattr_t *attr, int *type)
-{
-    if (!attr) {
-        return EINVAL;
-    }
-    *type = attr->type;
-    return 0;
-}
-
-int pthread_mutexattr_settype(pthread_mutexattr_t *attr, int type)
-{
-    if (!attr) {
-        return EINVAL;
-    }
-    pthread_mutexattr_t tmp_attr = {.type = type};
-    int res = mutexattr_check(&tmp_attr);
-    if (!res) {
-        attr->type = type;
-    }
-    return res;
-}
-
 /***************** ATTRIBUTES ******************/
 int pthread_attr_init(pthread_attr_t *attr)
 {
@@ -1,17 +1,16 @@
 /*
- * SPDX-FileCopyrightText: 2017-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2017-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <errno.h>
 #include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
-#include "esp_err.h"
-#include "esp_log.h"
+#include <sys/param.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "sys/lock.h"
-#include "sys/queue.h"
 
 #include "pthread_internal.h"
 
@@ -24,80 +23,128 @@
 
 typedef void (*pthread_destructor_t)(void*);
 
-/* This is a very naive implementation of key-indexed thread local storage, using two linked lists
-   (one is a global list of registered keys, one per thread for thread local storage values).
+/* Key-indexed thread local storage, where pthread_getspecific() and pthread_setspecific() take constant time.
 
-   It won't work well if lots of keys & thread-local values are stored (O(n) lookup for both),
-   but it should work for small amounts of data.
+   A key is made of the index of a slot in the global table of keys (plus 1, as 0 is not a valid key) and of the
+   generation of this slot, which is incremented each time its key is deleted. Each thread has an array of values
+   indexed like the table of keys, and a value is only returned for the key it was set with. So the values set
+   with a deleted key are not returned for a key created later in the same slot.
 */
-typedef struct key_entry_t_ {
-    pthread_key_t key;
+#define KEY_INDEX_BITS      12
+#define KEY_INDEX_MASK      ((1U << KEY_INDEX_BITS) - 1)
+#define KEY_MAX_COUNT       KEY_INDEX_MASK
+#define KEY_GENERATION_MASK (UINT32_MAX >> KEY_INDEX_BITS)
+#define SLOTS_GROWTH        8   // The arrays of keys and values grow by this number of slots
+
+typedef struct {
+    uint32_t generation;
+    bool used;
     pthread_destructor_t destructor;
-    SLIST_ENTRY(key_entry_t_) next;
-} key_entry_t;
+} key_slot_t;
 
-// List of all keys created with pthread_key_create()
-SLIST_HEAD(key_list_t, key_entry_t_) s_keys = SLIST_HEAD_INITIALIZER(s_keys);
+// Table of the keys created with pthread_key_create(), only accessed with s_keys_lock held
+static key_slot_t *s_keys;
+static size_t s_keys_count;
 
 static portMUX_TYPE s_keys_lock = portMUX_INITIALIZER_UNLOCKED;
 
-// List of all value entries associated with a thread via pthread_setspecific()
-typedef struct value_entry_t_ {
-    pthread_key_t key;
+// Value associated with a thread via pthread_setspecific()
+typedef struct {
+    pthread_key_t key;      // Key the value was set with, 0 if there is no value
     void *value;
-    SLIST_ENTRY(value_entry_t_) next;
-} value_entry_t;
+} value_slot_t;
 
-// Type for the head of the list, as saved as a FreeRTOS thread local storage pointer
-SLIST_HEAD(values_list_t_, value_entry_t_);
-typedef struct values_list_t_ values_list_t;
+// Values of a thread, as saved as a FreeRTOS thread local storage pointer
+typedef struct {
+    size_t count;
+    value_slot_t *slots;    // Indexed like s_keys, reallocated when a key of a higher index is set
+} values_t;
 
-int pthread_key_create(pthread_key_t *key, pthread_destructor_t destructor)
+static inline size_t key_to_index(pthread_key_t key)
+{
+    return (size_t)(key & KEY_INDEX_MASK) - 1;  // SIZE_MAX for the invalid key 0
+}
+
+static inline pthread_key_t make_key(size_t index, uint32_t generation)
+{
+    return ((generation & KEY_GENERATION_MASK) << KEY_INDEX_BITS) | (pthread_key_t)(index + 1);
+}
+
+// Must be called with s_keys_lock held
+static key_slot_t *find_key(pthread_key_t key)
 {
-    key_entry_t *new_key = malloc(sizeof(key_entry_t));
-    if (new_key == NULL) {
-        return ENOMEM;
+    const size_t index = key_to_index(key);
+    if (index >= s_keys_count || !s_keys[index].used || make_key(index, s_keys[index].generation) != key) {
+        return NULL;
     }
+    return &s_keys[index];
+}
 
-    portENTER_CRITICAL(&s_keys_lock);
+int pthread_key_create(pthread_key_t *key, pthread_destructor_t destructor)
+{
+    key_slot_t *new_keys = NULL;
+    size_t new_count = 0;
+
+    while (true) {
+        portENTER_CRITICAL(&s_keys_lock);
+
+        // Creating keys is rare, so free slots are simply searched for
+        size_t index;
+        for (index = 0; index < s_keys_count; index++) {
+            if (!s_keys[index].used) {
+                break;
+            }
+        }
 
-    const key_entry_t *head = SLIST_FIRST(&s_keys);
-    new_key->key = (head == NULL) ? 1 : (head->key + 1);
-    new_key->destructor = destructor;
-    *key = new_key->key;
+        key_slot_t *old_keys = NULL;
+        if (index == s_keys_count && new_keys != NULL && new_count > s_keys_count) {
+            // The table is full, replace it with the larger one allocated below
+            memcpy(new_keys, s_keys, s_keys_count * sizeof(key_slot_t));
+            memset(&new_keys[s_keys_count], 0, (new_count - s_keys_count) * sizeof(key_slot_t));
+            old_keys = s_keys;
+            s_keys = new_keys;
+            s_keys_count = new_count;
+            new_keys = NULL;
+        }
 
-    SLIST_INSERT_HEAD(&s_keys, new_key, next);
+        if (index < s_keys_count) {
+            s_keys[index].used = true;
+            s_keys[index].destructor = destructor;
+            *key = make_key(index, s_keys[index].generation);
+            portEXIT_CRITICAL(&s_keys_lock);
+            free(old_keys);
+            free(new_keys);
+            return 0;
+        }
 
-    portEXIT_CRITICAL(&s_keys_lock);
-    return 0;
-}
+        const size_t count = s_keys_count;
+        portEXIT_CRITICAL(&s_keys_lock);
 
-static key_entry_t *find_key(pthread_key_t key)
-{
-    portENTER_CRITICAL(&s_keys_lock);
-    key_entry_t *result = NULL;;
-    SLIST_FOREACH(result, &s_keys, next) {
-        if (result->key == key) {
-            break;
+        // Allocate a larger table outside of the critical section, then try again
+        free(new_keys);
+        if (count >= KEY_MAX_COUNT) {
+            return EAGAIN;
+        }
+        new_count = MIN(count + SLOTS_GROWTH, KEY_MAX_COUNT);
+        new_keys = malloc(new_count * sizeof(key_slot_t));
+        if (new_keys == NULL) {
+            return ENOMEM;
         }
     }
-    portEXIT_CRITICAL(&s_keys_lock);
-    return result;
 }
 
 int pthread_key_delete(pthread_key_t key)
 {
-
     portENTER_CRITICAL(&s_keys_lock);
 
-    /* Ideally, we would also walk all tasks' thread local storage value_list here
-       and delete any values associated with this key. We do not do this...
+    /* The values associated with this key by the threads are left in place, they are not returned anymore
+       as the generation of the slot changes, and are overwritten when the slot is used again.
     */
-
-    key_entry_t *entry = find_key(key);
+    key_slot_t *entry = find_key(key);
     if (entry != NULL) {
-        SLIST_REMOVE(&s_keys, entry, key_entry_t_, next);
-        free(entry);
+        entry->used = false;
+        entry->destructor = NULL;
+        entry->generation++;
     }
 
     portEXIT_CRITICAL(&s_keys_lock);
@@ -105,6 +152,15 @@ int pthread_key_delete(pthread_key_t key)
     return 0;
 }
 
+static pthread_destructor_t find_destructor(pthread_key_t key)
+{
+    portENTER_CRITICAL(&s_keys_lock);
+    key_slot_t *entry = find_key(key);
+    pthread_destructor_t destructor = (entry != NULL) ? entry->destructor : NULL;
+    portEXIT_CRITICAL(&s_keys_lock);
+    return destructor;
+}
+
 /* Clean up callback for deleted tasks.
 
    This is called from one of two places:
@@ -124,26 +180,34 @@ int pthread_key_delete(pthread_key_t key)
 */
 static void pthread_cleanup_thread_specific_data_callback(int index, void *v_tls)
 {
-    values_list_t *tls = (values_list_t *)v_tls;
+    values_t *tls = (values_t *)v_tls;
     assert(tls != NULL);
 
-    /* Walk the list, freeing all entries and calling destructors if they are registered */
-    while (1) {
-        value_entry_t *entry = SLIST_FIRST(tls);
-        if (entry == NULL) {
-            break;
-        }
-        SLIST_REMOVE_HEAD(tls, next);
-
-        // This is a little slow, walking the linked list of keys once per value,
-        // but assumes that the thread's value list will have less entries
-        // than the keys list
-        key_entry_t *key = find_key(entry->key);
-        if (key != NULL && key->destructor != NULL) {
-            key->destructor(entry->value);
+    /* Call the destructors of all non-NULL values, in the order of the keys. As a destructor may set new values,
+       possibly reallocating the slots, the array is walked again until a pass calls no destructor. Values set by
+       destructors are so destroyed after all the values which were already set.
+    */
+    bool destructor_called;
+    do {
+        destructor_called = false;
+        for (size_t i = 0; i < tls->count; i++) {
+            const pthread_key_t key = tls->slots[i].key;
+            void *value = tls->slots[i].value;
+            if (value == NULL) {
+                continue;
+            }
+            tls->slots[i].key = 0;
+            tls->slots[i].value = NULL;
+
+            pthread_destructor_t destructor = find_destructor(key);
+            if (destructor != NULL) {
+                destructor(value);
+                destructor_called = true;
+            }
         }
-        free(entry);
-    }
+    } while (destructor_called);
+
+    free(tls->slots);
     free(tls);
 }
 
@@ -169,41 +233,28 @@ void pthread_internal_local_storage_destructor_callback(TaskHandle_t handle)
     }
 }
 
-static value_entry_t *find_value(const values_list_t *list, pthread_key_t key)
-{
-    value_entry_t *result = NULL;;
-    SLIST_FOREACH(result, list, next) {
-        if (result->key == key) {
-            break;
-        }
-    }
-    return result;
-}
-
 void *pthread_getspecific(pthread_key_t key)
 {
-    values_list_t *tls = (values_list_t *) pvTaskGetThreadLocalStoragePointer(NULL, PTHREAD_TLS_INDEX);
-    if (tls == NULL) {
+    const values_t *tls = (const values_t *) pvTaskGetThreadLocalStoragePointer(NULL, PTHREAD_TLS_INDEX);
+    const size_t index = key_to_index(key);
+    if (tls == NULL || index >= tls->count || tls->slots[index].key != key) {
         return NULL;
     }
-
-    value_entry_t *entry = find_value(tls, key);
-    if (entry != NULL) {
-        return entry->value;
-    }
-    return NULL;
+    return tls->slots[index].value;
 }
 
 int pthread_setspecific(pthread_key_t key, const void *value)
 {
-    key_entry_t *key_entry = find_key(key);
-    if (key_entry == NULL) {
+    portENTER_CRITICAL(&s_keys_lock);
+    const bool key_exists = (find_key(key) != NULL);
+    portEXIT_CRITICAL(&s_keys_lock);
+    if (!key_exists) {
         return ENOENT; // this situation is undefined by pthreads standard
     }
 
-    values_list_t *tls = pvTaskGetThreadLocalStoragePointer(NULL, PTHREAD_TLS_INDEX);
+    values_t *tls = pvTaskGetThreadLocalStoragePointer(NULL, PTHREAD_TLS_INDEX);
     if (tls == NULL) {
-        tls = calloc(1, sizeof(values_list_t));
+        tls = calloc(1, sizeof(values_t));
         if (tls == NULL) {
             return ENOMEM;
         }
@@ -217,41 +268,26 @@ int pthread_setspecific(pthread_key_t key, const void *value)
 #endif /* CONFIG_FREERTOS_TLSP_DELETION_CALLBACKS */
     }
 
-    value_entry_t *entry = find_value(tls, key);
-    if (entry != NULL) {
-        if (value != NULL) {
-            // cast on next line is necessary as pthreads API uses
-            // 'const void *' here but elsewhere uses 'void *'
-            entry->value = (void *) value;
-        } else { // value == NULL, remove the entry
-            SLIST_REMOVE(tls, entry, value_entry_t_, next);
-            free(entry);
+    const size_t index = key_to_index(key);
+    if (index >= tls->count) {
+        if (value == NULL) {
+            return 0;
         }
-    } else if (value != NULL) {
-        entry = malloc(sizeof(value_entry_t));
-        if (entry == NULL) {
+        const size_t new_count = (index / SLOTS_GROWTH + 1) * SLOTS_GROWTH;
+        value_slot_t *slots = realloc(tls->slots, new_count * sizeof(value_slot_t));
+        if (slots == NULL) {
             return ENOMEM;
         }
-        entry->key = key;
-        entry->value = (void *) value; // see note above about cast
-
-        // insert the new entry at the end of the list. this is important because
-        // a destructor may call pthread_setspecific() to add a new non-NULL value
-        // to the list, and this should be processed after all other entries.
-        //
-        // See pthread_cleanup_thread_specific_data_callback()
-        value_entry_t *last_entry = NULL;
-        value_entry_t *it;
-        SLIST_FOREACH(it, tls, next) {
-            last_entry = it;
-        }
-        if (last_entry == NULL) {
-            SLIST_INSERT_HEAD(tls, entry, next);
-        } else {
-            SLIST_INSERT_AFTER(last_entry, entry, next);
-        }
+        memset(&slots[tls->count], 0, (new_count - tls->count) * sizeof(value_slot_t));
+        tls->slots = slots;
+        tls->count = new_count;
     }
 
+    // cast on next line is necessary as pthreads API uses
+    // 'const void *' here but elsewhere uses 'void *'
+    tls->slots[index].key = (value != NULL) ? key : 0;
+    tls->slots[index].value = (void *) value;
+
     return 0;
 }
 
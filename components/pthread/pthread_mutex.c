@@ -0,0 +1,373 @@
+/*
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "pthread_internal.h"
+
+#include "esp_log.h"
+const static char *TAG = "pthread_mutex";
+
+#if CONFIG_PTHREAD_MUTEX_FAST_PATH
+/* Values of esp_pthread_mutex_t::state, as for a futex based mutex */
+#define MUTEX_UNLOCKED  0   // Not held by any task
+#define MUTEX_LOCKED    1   // Held by a task, no task waits for it
+#define MUTEX_CONTENDED 2   // Held by a task, other tasks may wait for it on the semaphore
+#endif
+
+/** pthread mutex FreeRTOS wrapper */
+typedef struct {
+    SemaphoreHandle_t   sem;        ///< FreeRTOS mutex, or the semaphore given to wake up waiters with CONFIG_PTHREAD_MUTEX_FAST_PATH
+    int                 type;       ///< Mutex type. Currently supported PTHREAD_MUTEX_NORMAL, PTHREAD_MUTEX_RECURSIVE and PTHREAD_MUTEX_ERRORCHECK
+#if CONFIG_PTHREAD_MUTEX_FAST_PATH
+    atomic_uint         state;      ///< MUTEX_UNLOCKED, MUTEX_LOCKED or MUTEX_CONTENDED
+    _Atomic(TaskHandle_t) owner;    ///< Task holding the mutex, NULL if not held
+    unsigned            count;      ///< Number of times the owner locked a recursive mutex
+#endif
+} esp_pthread_mutex_t;
+
+static int mutexattr_check(const pthread_mutexattr_t *attr)
+{
+    if (attr->type != PTHREAD_MUTEX_NORMAL &&
+            attr->type != PTHREAD_MUTEX_RECURSIVE &&
+            attr->type != PTHREAD_MUTEX_ERRORCHECK) {
+        return EINVAL;
+    }
+    return 0;
+}
+
+static int pthread_mutex_lock_internal(esp_pthread_mutex_t *mux, TickType_t tmo);
+
+int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
+{
+    int type = PTHREAD_MUTEX_NORMAL;
+
+    if (!mutex) {
+        return EINVAL;
+    }
+
+    if (attr) {
+        if (!attr->is_initialized) {
+            return EINVAL;
+        }
+        int res = mutexattr_check(attr);
+        if (res) {
+            return res;
+        }
+        type = attr->type;
+    }
+
+    esp_pthread_mutex_t *mux = (esp_pthread_mutex_t *)malloc(sizeof(esp_pthread_mutex_t));
+    if (!mux) {
+        return ENOMEM;
+    }
+    mux->type = type;
+
+#if CONFIG_PTHREAD_MUTEX_FAST_PATH
+    atomic_init(&mux->state, MUTEX_UNLOCKED);
+    atomic_init(&mux->owner, NULL);
+    mux->count = 0;
+    mux->sem = xSemaphoreCreateBinary();
+#else
+    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
+        mux->sem = xSemaphoreCreateRecursiveMutex();
+    } else {
+        mux->sem = xSemaphoreCreateMutex();
+    }
+#endif
+    if (!mux->sem) {
+        free(mux);
+        return EAGAIN;
+    }
+
+    *mutex = (pthread_mutex_t)mux; // pointer value fit into pthread_mutex_t (uint32_t)
+
+    return 0;
+}
+
+int pthread_mutex_destroy(pthread_mutex_t *mutex)
+{
+    esp_pthread_mutex_t *mux;
+
+    ESP_LOGV(TAG, "%s %p", __FUNCTION__, mutex);
+
+    if (!mutex) {
+        return EINVAL;
+    }
+    if ((intptr_t) *mutex == PTHREAD_MUTEX_INITIALIZER) {
+        return 0; // Static mutex was never initialized
+    }
+
+    mux = (esp_pthread_mutex_t *)*mutex;
+    if (!mux) {
+        return EINVAL;
+    }
+
+    // check if mux is busy
+    int res = pthread_mutex_lock_internal(mux, 0);
+    if (res == EBUSY) {
+        return EBUSY;
+    }
+
+#if !CONFIG_PTHREAD_MUTEX_FAST_PATH
+    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
+        res = xSemaphoreGiveRecursive(mux->sem);
+    } else {
+        res = xSemaphoreGive(mux->sem);
+    }
+    if (res != pdTRUE) {
+        assert(false && "Failed to release mutex!");
+    }
+#endif
+    vSemaphoreDelete(mux->sem);
+    free(mux);
+
+    return 0;
+}
+
+#if CONFIG_PTHREAD_MUTEX_FAST_PATH
+/* Slow path of pthread_mutex_lock_internal(), when the mutex is held by another task.
+
+   The mutex is marked as contended before waiting, so that the task unlocking it gives the semaphore. As the state
+   does not tell how many tasks wait, it stays contended when taken here, and the next unlock may give the semaphore
+   while no task waits for it. The task taking it then finds the mutex locked again, and simply waits again.
+*/
+static int pthread_mutex_lock_contended(esp_pthread_mutex_t *mux, TickType_t tmo)
+{
+    TimeOut_t timeout;
+    vTaskSetTimeOutState(&timeout);
+
+    while (atomic_exchange(&mux->state, MUTEX_CONTENDED) != MUTEX_UNLOCKED) {
+        if (xTaskCheckForTimeOut(&timeout, &tmo) != pdFALSE ||
+                xSemaphoreTake(mux->sem, tmo) != pdTRUE) {
+            return EBUSY;
+        }
+    }
+    return 0;
+}
+
+static int pthread_mutex_lock_internal(esp_pthread_mutex_t *mux, TickType_t tmo)
+{
+    if (!mux) {
+        return EINVAL;
+    }
+
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (mux->type != PTHREAD_MUTEX_NORMAL &&
+            atomic_load_explicit(&mux->owner, memory_order_relaxed) == self) {
+        if (mux->type == PTHREAD_MUTEX_ERRORCHECK) {
+            return EDEADLK;
+        }
+        mux->count++;
+        return 0;
+    }
+
+    // Fast path: the mutex is not held by any task
+    unsigned int expected = MUTEX_UNLOCKED;
+    if (!atomic_compare_exchange_strong(&mux->state, &expected, MUTEX_LOCKED)) {
+        if (tmo == 0) {
+            return EBUSY;
+        }
+        int res = pthread_mutex_lock_contended(mux, tmo);
+        if (res != 0) {
+            return res;
+        }
+    }
+
+    atomic_store_explicit(&mux->owner, self, memory_order_relaxed);
+    mux->count = 1;
+    return 0;
+}
+#else
+static int pthread_mutex_lock_internal(esp_pthread_mutex_t *mux, TickType_t tmo)
+{
+    if (!mux) {
+        return EINVAL;
+    }
+
+    if ((mux->type == PTHREAD_MUTEX_ERRORCHECK) &&
+            (xSemaphoreGetMutexHolder(mux->sem) == xTaskGetCurrentTaskHandle())) {
+        return EDEADLK;
+    }
+
+    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
+        if (xSemaphoreTakeRecursive(mux->sem, tmo) != pdTRUE) {
+            return EBUSY;
+        }
+    } else {
+        if (xSemaphoreTake(mux->sem, tmo) != pdTRUE) {
+            return EBUSY;
+        }
+    }
+
+    return 0;
+}
+#endif /* CONFIG_PTHREAD_MUTEX_FAST_PATH */
+
+static int pthread_mutex_init_if_static(pthread_mutex_t *mutex)
+{
+    int res = 0;
+    if ((intptr_t) *mutex == PTHREAD_MUTEX_INITIALIZER) {
+        portENTER_CRITICAL(&pthread_lazy_init_lock);
+        if ((intptr_t) *mutex == PTHREAD_MUTEX_INITIALIZER) {
+            res = pthread_mutex_init(mutex, NULL);
+        }
+        portEXIT_CRITICAL(&pthread_lazy_init_lock);
+    }
+    return res;
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    if (!mutex) {
+        return EINVAL;
+    }
+    int res = pthread_mutex_init_if_static(mutex);
+    if (res != 0) {
+        return res;
+    }
+    return pthread_mutex_lock_internal((esp_pthread_mutex_t *)*mutex, portMAX_DELAY);
+}
+
+int pthread_mutex_timedlock(pthread_mutex_t *mutex, const struct timespec *timeout)
+{
+    if (!mutex) {
+        return EINVAL;
+    }
+    int res = pthread_mutex_init_if_static(mutex);
+    if (res != 0) {
+        return res;
+    }
+
+    struct timespec currtime;
+    clock_gettime(CLOCK_REALTIME, &currtime);
+    TickType_t tmo = ((timeout->tv_sec - currtime.tv_sec) * 1000 +
+                      (timeout->tv_nsec - currtime.tv_nsec) / 1000000) / portTICK_PERIOD_MS;
+
+    res = pthread_mutex_lock_internal((esp_pthread_mutex_t *)*mutex, tmo);
+    if (res == EBUSY) {
+        return ETIMEDOUT;
+    }
+    return res;
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex)
+{
+    if (!mutex) {
+        return EINVAL;
+    }
+    int res = pthread_mutex_init_if_static(mutex);
+    if (res != 0) {
+        return res;
+    }
+    return pthread_mutex_lock_internal((esp_pthread_mutex_t *)*mutex, 0);
+}
+
+int pthread_mutex_unlock(pthread_mutex_t *mutex)
+{
+    esp_pthread_mutex_t *mux;
+
+    if (!mutex) {
+        return EINVAL;
+    }
+    mux = (esp_pthread_mutex_t *)*mutex;
+    if (!mux) {
+        return EINVAL;
+    }
+
+#if CONFIG_PTHREAD_MUTEX_FAST_PATH
+    if (mux->type != PTHREAD_MUTEX_NORMAL &&
+            atomic_load_explicit(&mux->owner, memory_order_relaxed) != xTaskGetCurrentTaskHandle()) {
+        return EPERM;
+    }
+    if (mux->type == PTHREAD_MUTEX_RECURSIVE && --mux->count > 0) {
+        return 0;
+    }
+
+    atomic_store_explicit(&mux->owner, NULL, memory_order_relaxed);
+    unsigned int state = atomic_exchange(&mux->state, MUTEX_UNLOCKED);
+    if (state == MUTEX_UNLOCKED) {
+        assert(false && "Failed to unlock mutex!");
+    } else if (state == MUTEX_CONTENDED) {
+        xSemaphoreGive(mux->sem);
+    }
+#else
+    if (((mux->type == PTHREAD_MUTEX_RECURSIVE) ||
+            (mux->type == PTHREAD_MUTEX_ERRORCHECK)) &&
+            (xSemaphoreGetMutexHolder(mux->sem) != xTaskGetCurrentTaskHandle())) {
+        return EPERM;
+    }
+
+    int ret;
+    if (mux->type == PTHREAD_MUTEX_RECURSIVE) {
+        ret = xSemaphoreGiveRecursive(mux->sem);
+    } else {
+        ret = xSemaphoreGive(mux->sem);
+    }
+    if (ret != pdTRUE) {
+        assert(false && "Failed to unlock mutex!");
+    }
+#endif /* CONFIG_PTHREAD_MUTEX_FAST_PATH */
+    return 0;
+}
+
+int pthread_mutexattr_init(pthread_mutexattr_t *attr)
+{
+    if (!attr) {
+        return EINVAL;
+    }
+    memset(attr, 0, sizeof(*attr));
+    attr->type = PTHREAD_MUTEX_NORMAL;
+    attr->is_initialized = 1;
+    return 0;
+}
+
+int pthread_mutexattr_destroy(pthread_mutexattr_t *attr)
+{
+    if (!attr) {
+        return EINVAL;
+    }
+    attr->is_initialized = 0;
+    return 0;
+}
+
+int pthread_mutexattr_gettype(const pthread_mutexattr_t *attr, int *type)
+{
+    if (!attr) {
+        return EINVAL;
+    }
+    *type = attr->type;
+    return 0;
+}
+
+int pthread_mutexattr_settype(pthread_mutexattr_t *attr, int type)
+{
+    if (!attr) {
+        return EINVAL;
+    }
+    pthread_mutexattr_t tmp_attr = {.type = type};
+    int res = mutexattr_check(&tmp_attr);
+    if (!res) {
+        attr->type = type;
+    }
+    return res;
+}
+
+/* Hook function to force linking this file */
+void pthread_include_pthread_mutex_impl(void)
+{
+}
@@ -7,6 +7,8 @@
 #include <time.h>
 #include <errno.h>
 #include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdatomic.h>
 #include <time.h>
@@ -24,28 +26,39 @@
 #include "esp_log.h"
 const static char *TAG = "pthread_rw_lock";
 
-/** pthread rw_mutex FreeRTOS wrapper */
+/** pthread rw_mutex FreeRTOS wrapper
+
+    Readers only update a counter of the core they run on while no writer holds or waits for the lock, without taking
+    resource_mutex. A writer first announces itself in writers, which sends new readers to the slow path, and then
+    waits for the sum of the reader counters to drop to 0. A reader increments its counter before checking writers,
+    and a writer increments writers before summing the counters, so at least one of them sees the other.
+ */
 typedef struct {
     /**
-     *
+     * Number of readers holding the lock, per core. A reader may release the lock on another core than it took it,
+     * so a counter can be negative, only the sum of all the counters is meaningful.
      */
-    pthread_cond_t cv;
+    atomic_int readers[portNUM_PROCESSORS];
 
-    pthread_mutex_t resource_mutex;
+    /**
+     * Number of writers holding or waiting for the lock, only modified with resource_mutex held
+     */
+    atomic_uint writers;
 
     /**
-     * Number of current readers holding this lock, negative number means waiting readers
+     * Set while a writer holds the lock, only modified with resource_mutex held
      */
-    int8_t active_readers;
+    atomic_bool active_writer;
 
-    uint8_t active_writers;
-    uint8_t waiting_writers;
+    /**
+     * Signaled when a writer releases the lock or gives up waiting, and when a reader releases the lock while
+     * writers wait
+     */
+    pthread_cond_t cv;
 
+    pthread_mutex_t resource_mutex;
 } esp_pthread_rwlock_t;
 
-#define WRITER_QUEUE_SIZE 4
-#define READER_QUEUE_SIZE 4
-
 int pthread_rwlock_init(pthread_rwlock_t *rwlock,
                         const pthread_rwlockattr_t *attr)
 {
@@ -77,9 +90,11 @@ int pthread_rwlock_init(pthread_rwlock_t *rwlock,
         return ENOMEM;
     }
 
-    esp_rwlock->active_readers = 0;
-    esp_rwlock->active_writers = 0;
-    esp_rwlock->waiting_writers = 0;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        atomic_init(&esp_rwlock->readers[i], 0);
+    }
+    atomic_init(&esp_rwlock->writers, 0);
+    atomic_init(&esp_rwlock->active_writer, false);
 
     *rwlock = (pthread_rwlock_t) esp_rwlock;
 
@@ -99,6 +114,52 @@ static int pthread_rwlock_init_if_static(pthread_rwlock_t *rwlock)
     return res;
 }
 
+static int readers_count(esp_pthread_rwlock_t *esp_rwlock)
+{
+    int count = 0;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        count += atomic_load(&esp_rwlock->readers[i]);
+    }
+    return count;
+}
+
+static inline void reader_add(esp_pthread_rwlock_t *esp_rwlock, int value)
+{
+    atomic_fetch_add(&esp_rwlock->readers[xPortGetCoreID()], value);
+}
+
+// Wakes up the writers waiting for the readers to release the lock
+static void wake_writers(esp_pthread_rwlock_t *esp_rwlock)
+{
+    pthread_mutex_lock(&esp_rwlock->resource_mutex);
+    pthread_cond_broadcast(&esp_rwlock->cv);
+    pthread_mutex_unlock(&esp_rwlock->resource_mutex);
+}
+
+// Takes the lock for reading without resource_mutex, fails if a writer holds or waits for it
+static bool try_read_fast(esp_pthread_rwlock_t *esp_rwlock)
+{
+    if (atomic_load(&esp_rwlock->writers) != 0) {
+        return false;
+    }
+    reader_add(esp_rwlock, 1);
+    if (atomic_load(&esp_rwlock->writers) == 0) {
+        return true;
+    }
+    // A writer came meanwhile, it may already wait for this reader
+    reader_add(esp_rwlock, -1);
+    wake_writers(esp_rwlock);
+    return false;
+}
+
+// Gives up waiting for the lock as a writer, must be called with resource_mutex held
+static void writer_cancel(esp_pthread_rwlock_t *esp_rwlock)
+{
+    atomic_fetch_sub(&esp_rwlock->writers, 1);
+    // Readers waiting for this writer can now take the lock
+    pthread_cond_broadcast(&esp_rwlock->cv);
+}
+
 int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
 {
     esp_pthread_rwlock_t *esp_rwlock;
@@ -121,7 +182,7 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
     // TODO: necessary?
     pthread_mutex_lock(&esp_rwlock->resource_mutex);
 
-    if (esp_rwlock->active_readers != 0 || esp_rwlock->active_writers > 0 || esp_rwlock->waiting_writers > 0) {
+    if (readers_count(esp_rwlock) != 0 || atomic_load(&esp_rwlock->writers) != 0) {
         pthread_mutex_unlock(&esp_rwlock->resource_mutex);
         return EBUSY;
     }
@@ -169,22 +230,20 @@ int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
     }
 
     esp_rwlock = (esp_pthread_rwlock_t *)*rwlock;
+    if (try_read_fast(esp_rwlock)) {
+        return 0;
+    }
+
     res = pthread_mutex_lock(&esp_rwlock->resource_mutex);
     if (res != 0) {
         return res;
     }
 
-    if (esp_rwlock->active_writers == 0) {
-        esp_rwlock->active_readers++;
-    } else {
-        while (true) {
-            pthread_cond_wait(&esp_rwlock->cv, &esp_rwlock->resource_mutex);
-            if (esp_rwlock->active_writers == 0 && esp_rwlock->waiting_writers == 0) {
-                esp_rwlock->active_readers++;
-                break;
-            }
-        }
+    // Writers only announce themselves with resource_mutex held, so none can miss this reader
+    while (atomic_load(&esp_rwlock->writers) != 0) {
+        pthread_cond_wait(&esp_rwlock->cv, &esp_rwlock->resource_mutex);
     }
+    reader_add(esp_rwlock, 1);
 
     pthread_mutex_unlock(&esp_rwlock->resource_mutex);
 
@@ -202,13 +261,17 @@ int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
     }
 
     esp_rwlock = (esp_pthread_rwlock_t *)*rwlock;
+    if (try_read_fast(esp_rwlock)) {
+        return 0;
+    }
+
     res = pthread_mutex_trylock(&esp_rwlock->resource_mutex);
     if (res != 0) {
         return res;
     }
 
-    if (esp_rwlock->active_writers == 0) {
-        esp_rwlock->active_readers++;
+    if (!atomic_load(&esp_rwlock->active_writer)) {
+        reader_add(esp_rwlock, 1);
         res = 0;
     } else {
         res = EBUSY;
@@ -235,12 +298,11 @@ int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
         return res;
     }
 
-    esp_rwlock->waiting_writers++;
-    while (esp_rwlock->active_readers > 0 || esp_rwlock->active_writers > 0) {
+    atomic_fetch_add(&esp_rwlock->writers, 1);
+    while (atomic_load(&esp_rwlock->active_writer) || readers_count(esp_rwlock) != 0) {
         pthread_cond_wait(&esp_rwlock->cv, &esp_rwlock->resource_mutex);
     }
-    esp_rwlock->waiting_writers--;
-    esp_rwlock->active_writers++;
+    atomic_store(&esp_rwlock->active_writer, true);
 
     pthread_mutex_unlock(&esp_rwlock->resource_mutex);
 
@@ -263,13 +325,17 @@ int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
         return res;
     }
 
-    if (esp_rwlock->active_readers > 0 ||
-            esp_rwlock->active_writers > 0 ||
-            esp_rwlock->waiting_writers > 0) { // the last check for waiting_writers is to avoid skipping the queue
+    if (atomic_load(&esp_rwlock->writers) != 0) { // checking waiting writers too, to avoid skipping the queue
         res = EBUSY;
     } else {
-        esp_rwlock->active_writers++;
-        res = 0;
+        atomic_fetch_add(&esp_rwlock->writers, 1);
+        if (readers_count(esp_rwlock) != 0) {
+            writer_cancel(esp_rwlock);
+            res = EBUSY;
+        } else {
+            atomic_store(&esp_rwlock->active_writer, true);
+            res = 0;
+        }
     }
 
     pthread_mutex_unlock(&esp_rwlock->resource_mutex);
@@ -288,24 +354,27 @@ int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
     }
 
     esp_rwlock = (esp_pthread_rwlock_t *)*rwlock;
+
+    // No writer can hold the lock while a reader does, so the caller is the writer if there is one
+    if (!atomic_load(&esp_rwlock->active_writer)) {
+        // we are a reader
+        reader_add(esp_rwlock, -1);
+        if (atomic_load(&esp_rwlock->writers) != 0) {
+            wake_writers(esp_rwlock);
+        }
+        return 0;
+    }
+
+    // we are a writer
     res = pthread_mutex_lock(&esp_rwlock->resource_mutex);
     if (res != 0) {
         return res;
     }
 
-    assert(!(esp_rwlock->active_readers > 0 && esp_rwlock->active_writers > 0));
+    assert(readers_count(esp_rwlock) == 0);
 
-    if (esp_rwlock->active_readers > 0) {
-        // we are a reader
-        esp_rwlock->active_readers--;
-        if (esp_rwlock->active_readers == 0) {
-            pthread_cond_broadcast(&esp_rwlock->cv);
-        }
-    } else {
-        // we are a writer
-        esp_rwlock->active_writers = 0;
-        pthread_cond_broadcast(&esp_rwlock->cv);
-    }
+    atomic_store(&esp_rwlock->active_writer, false);
+    writer_cancel(esp_rwlock);
 
     pthread_mutex_unlock(&esp_rwlock->resource_mutex);
 
@@ -328,31 +397,32 @@ int pthread_rwlock_timedwrlock(pthread_rwlock_t *rwlock, const struct timespec *
         return res;
     }
 
+    atomic_fetch_add(&esp_rwlock->writers, 1);
+
     // If there are active readers or active writers, we go into the timed wait path
     // otherwise, we go into the immediate success path.
-    if (esp_rwlock->active_readers || esp_rwlock->active_writers) {
+    if (atomic_load(&esp_rwlock->active_writer) || readers_count(esp_rwlock) != 0) {
         // The timed wait path
         if (!abstime || abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000) {
             // The validity of the abstime parameter need be checked
             // if the lock can not be immediately acquired (see Immediate success path).
+            writer_cancel(esp_rwlock);
             pthread_mutex_unlock(&esp_rwlock->resource_mutex);
             return EINVAL;
         }
 
-        esp_rwlock->waiting_writers++;
-        while (esp_rwlock->active_readers > 0 || esp_rwlock->active_writers > 0) {
+        while (atomic_load(&esp_rwlock->active_writer) || readers_count(esp_rwlock) != 0) {
             res = pthread_cond_timedwait(&esp_rwlock->cv, &esp_rwlock->resource_mutex, abstime);
             if (res == ETIMEDOUT) {
-                esp_rwlock->waiting_writers--;
+                writer_cancel(esp_rwlock);
                 pthread_mutex_unlock(&esp_rwlock->resource_mutex);
                 return ETIMEDOUT;
             }
         }
-        esp_rwlock->waiting_writers--;
     }
 
     // Immediate success path.
-    esp_rwlock->active_writers++;
+    atomic_store(&esp_rwlock->active_writer, true);
     pthread_mutex_unlock(&esp_rwlock->resource_mutex);
     return 0;
 }
@@ -368,6 +438,10 @@ int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock, const struct timespec *
     }
 
     esp_rwlock = (esp_pthread_rwlock_t *)*rwlock;
+    if (try_read_fast(esp_rwlock)) {
+        return 0;
+    }
+
     res = pthread_mutex_lock(&esp_rwlock->resource_mutex);
     if (res != 0) {
         return res;
@@ -375,7 +449,7 @@ int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock, const struct timespec *
 
     // If there are active writers or waiting writers, we go into the timed wait path
     // otherwise, we go into the immediate success path.
-    if (esp_rwlock->active_writers || esp_rwlock->waiting_writers) {
+    if (atomic_load(&esp_rwlock->writers) != 0) {
         // The timed wait path
         if (!abstime || abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000) {
             // The validity of the abstime parameter need be checked
@@ -384,7 +458,7 @@ int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock, const struct timespec *
             return EINVAL;
         }
 
-        while (esp_rwlock->active_writers > 0 || esp_rwlock->waiting_writers > 0) {
+        while (atomic_load(&esp_rwlock->writers) != 0) {
             res = pthread_cond_timedwait(&esp_rwlock->cv, &esp_rwlock->resource_mutex, abstime);
             if (res == ETIMEDOUT) {
                 pthread_mutex_unlock(&esp_rwlock->resource_mutex);
@@ -394,7 +468,7 @@ int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock, const struct timespec *
     }
 
     // Immediate success path.
-    esp_rwlock->active_readers++;
+    reader_add(esp_rwlock, 1);
     pthread_mutex_unlock(&esp_rwlock->resource_mutex);
     return 0;
 }
@@ -1,9 +1,10 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
 #include <errno.h>
+#include <inttypes.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -12,6 +13,7 @@
 #include <pthread.h>
 
 #include "unity.h"
+#include "esp_timer.h"
 
 static void *compute_square(void *arg)
 {
@@ -66,6 +68,76 @@ TEST_CASE("pthread create join", "[pthread]")
     }
 }
 
+static pthread_mutex_t s_blocking_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void *blocked_thread(void *arg)
+{
+    pthread_mutex_lock(&s_blocking_mutex);
+    pthread_mutex_unlock(&s_blocking_mutex);
+    return NULL;
+}
+
+static void *self_thread(void *arg)
+{
+    pthread_t *self = (pthread_t *) arg;
+    *self = pthread_self();
+    return NULL;
+}
+
+static void *self_time_thread(void *arg)
+{
+    int64_t *time_us = (int64_t *) arg;
+    const pthread_t self = pthread_self();
+    const int64_t start = esp_timer_get_time();
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQUAL(self, pthread_self());
+    }
+    *time_us = esp_timer_get_time() - start;
+    return NULL;
+}
+
+#define NUM_BLOCKED_THREADS 8
+#define NUM_CREATE_JOIN 50
+
+TEST_CASE("pthread create join with other threads running", "[pthread]")
+{
+    pthread_t blocked[NUM_BLOCKED_THREADS];
+    esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+    cfg.stack_size = 2048;
+    TEST_ASSERT_EQUAL_INT(0, esp_pthread_set_cfg(&cfg));
+
+    // The other threads are all looked up from the descriptors, and the handles, of the threads below
+    pthread_mutex_lock(&s_blocking_mutex);
+    for (int i = 0; i < NUM_BLOCKED_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&blocked[i], NULL, blocked_thread, NULL));
+    }
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < NUM_CREATE_JOIN; i++) {
+        pthread_t thread;
+        pthread_t self = 0;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, self_thread, &self));
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+        TEST_ASSERT_EQUAL(thread, self);
+    }
+    const int64_t create_join_us = esp_timer_get_time() - start;
+
+    pthread_t thread;
+    int64_t self_us = 0;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, self_time_thread, &self_us));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+
+    printf("pthread create and join: %"PRId64" us, 1000 pthread_self: %"PRId64" us (%d threads running)\n",
+           create_join_us / NUM_CREATE_JOIN, self_us, NUM_BLOCKED_THREADS);
+
+    pthread_mutex_unlock(&s_blocking_mutex);
+    for (int i = 0; i < NUM_BLOCKED_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(blocked[i], NULL));
+    }
+    cfg = esp_pthread_get_default_config();
+    TEST_ASSERT_EQUAL_INT(0, esp_pthread_set_cfg(&cfg));
+}
+
 static void *waiting_thread(void *arg)
 {
     TaskHandle_t *task_handle = (TaskHandle_t *)arg;
@@ -266,6 +338,54 @@ static void timespec_add_nano(struct timespec * out, struct timespec * in, long
     }
 }
 
+#define MUTEX_CONTENTION_THREADS 4
+#define MUTEX_CONTENTION_ITERATIONS 10000
+
+typedef struct {
+    pthread_mutex_t mutex;
+    volatile uint32_t counter;
+} mutex_contention_args_t;
+
+static void *increment_counter(void *arg)
+{
+    mutex_contention_args_t *args = (mutex_contention_args_t *) arg;
+    for (int i = 0; i < MUTEX_CONTENTION_ITERATIONS; i++) {
+        pthread_mutex_lock(&args->mutex);
+        args->counter++;
+        pthread_mutex_unlock(&args->mutex);
+    }
+    return NULL;
+}
+
+TEST_CASE("pthread mutex uncontended and contended lock time", "[pthread]")
+{
+    mutex_contention_args_t args = { .counter = 0 };
+    pthread_t threads[MUTEX_CONTENTION_THREADS];
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_mutex_init(&args.mutex, NULL));
+
+    int64_t start = esp_timer_get_time();
+    increment_counter(&args);
+    const int64_t uncontended_us = esp_timer_get_time() - start;
+
+    // The threads are not pinned, so they run on all the cores and take the mutex concurrently
+    start = esp_timer_get_time();
+    for (int i = 0; i < MUTEX_CONTENTION_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL, increment_counter, &args));
+    }
+    for (int i = 0; i < MUTEX_CONTENTION_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(threads[i], NULL));
+    }
+    const int64_t contended_us = esp_timer_get_time() - start;
+
+    TEST_ASSERT_EQUAL_UINT32((MUTEX_CONTENTION_THREADS + 1) * MUTEX_CONTENTION_ITERATIONS, args.counter);
+    printf("%d lock and unlock: %"PRId64" us uncontended, %"PRId64" us with %d threads\n",
+           MUTEX_CONTENTION_ITERATIONS, uncontended_us,
+           contended_us / MUTEX_CONTENTION_THREADS, MUTEX_CONTENTION_THREADS);
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_mutex_destroy(&args.mutex));
+}
+
 TEST_CASE("pthread mutex trylock timedlock", "[pthread]")
 {
     int res = 0;
@@ -1,9 +1,10 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
 // Test pthread_create_key, pthread_delete_key, pthread_setspecific, pthread_getspecific
+#include <errno.h>
 #include <pthread.h>
 #include <inttypes.h>
 #include "unity.h"
@@ -11,6 +12,7 @@
 #include "freertos/task.h"
 #include "test_utils.h"
 #include "esp_random.h"
+#include "esp_timer.h"
 
 TEST_CASE("pthread local storage basics", "[thread-specific]")
 {
@@ -168,6 +170,61 @@ TEST_CASE("pthread local storage stress test", "[thread-specific]")
     }
 }
 
+TEST_CASE("pthread local storage deleted key value not returned for new key", "[thread-specific]")
+{
+    pthread_key_t key;
+    pthread_key_t new_key;
+    int val = 3;
+
+    TEST_ASSERT_EQUAL(0, pthread_key_create(&key, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_setspecific(key, &val));
+    TEST_ASSERT_EQUAL(0, pthread_key_delete(key));
+
+    // The new key may reuse the storage of the deleted one, the value set with the deleted key must not be returned
+    TEST_ASSERT_EQUAL(0, pthread_key_create(&new_key, NULL));
+    TEST_ASSERT_NOT_EQUAL(key, new_key);
+    TEST_ASSERT_NULL(pthread_getspecific(new_key));
+    TEST_ASSERT_EQUAL(ENOENT, pthread_setspecific(key, &val));
+
+    TEST_ASSERT_EQUAL(0, pthread_key_delete(new_key));
+}
+
+#define PERF_NUM_KEYS 64
+#define PERF_ITERATIONS 10000
+
+TEST_CASE("pthread local storage get and set time does not depend on number of keys", "[thread-specific]")
+{
+    static pthread_key_t keys[PERF_NUM_KEYS];
+
+    for (int i = 0; i < PERF_NUM_KEYS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_key_create(&keys[i], NULL));
+        TEST_ASSERT_EQUAL(0, pthread_setspecific(keys[i], &keys[i]));
+    }
+    for (int i = 0; i < PERF_NUM_KEYS; i++) {
+        TEST_ASSERT_EQUAL_PTR(&keys[i], pthread_getspecific(keys[i]));
+    }
+
+    int64_t time_us[2];
+    const pthread_key_t measured_keys[2] = { keys[0], keys[PERF_NUM_KEYS - 1] };
+    for (int k = 0; k < 2; k++) {
+        const int64_t start = esp_timer_get_time();
+        for (int i = 0; i < PERF_ITERATIONS; i++) {
+            pthread_setspecific(measured_keys[k], &keys[i % PERF_NUM_KEYS]);
+            TEST_ASSERT_EQUAL_PTR(&keys[i % PERF_NUM_KEYS], pthread_getspecific(measured_keys[k]));
+        }
+        time_us[k] = esp_timer_get_time() - start;
+    }
+    printf("%d set and get, first key: %"PRId64" us, key %d: %"PRId64" us\n",
+           PERF_ITERATIONS, time_us[0], PERF_NUM_KEYS, time_us[1]);
+    // The time for the last key used to grow with the number of keys, allow some margin for interrupts
+    TEST_ASSERT_LESS_THAN(time_us[0] * 3 / 2, time_us[1]);
+
+    for (int i = 0; i < PERF_NUM_KEYS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_setspecific(keys[i], NULL));
+        TEST_ASSERT_EQUAL(0, pthread_key_delete(keys[i]));
+    }
+}
+
 #define NUM_KEYS 4 // number of keys used in repeat destructor test
 #define NUM_REPEATS 17 // number of times we re-set a key to a non-NULL value to re-trigger destructor
 
@@ -7,6 +7,7 @@
 #include "sdkconfig.h"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdatomic.h>
 #include <time.h>
 
@@ -475,3 +476,58 @@ TEST_CASE("pthread_rwlock_timedwrlock times out if reader holds lock", "[pthread
     TEST_ASSERT_EQUAL_INT(0, pthread_rwlock_unlock(&rwlock));
     TEST_ASSERT_EQUAL_INT(0, pthread_rwlock_destroy(&rwlock));
 }
+
+#define RWLOCK_STRESS_THREADS 4
+#define RWLOCK_STRESS_ITERATIONS 10000
+#define RWLOCK_STRESS_WRITE_PERIOD 100
+
+typedef struct {
+    pthread_rwlock_t rwlock;
+    volatile uint32_t value;
+    volatile uint32_t value_copy;   // Always equal to value with the lock held
+    atomic_bool inconsistent;
+} rwlock_stress_args_t;
+
+static void *read_mostly(void *arg)
+{
+    rwlock_stress_args_t *args = (rwlock_stress_args_t *) arg;
+    for (int i = 0; i < RWLOCK_STRESS_ITERATIONS; i++) {
+        if (i % RWLOCK_STRESS_WRITE_PERIOD == 0) {
+            pthread_rwlock_wrlock(&args->rwlock);
+            args->value++;
+            args->value_copy++;
+        } else {
+            pthread_rwlock_rdlock(&args->rwlock);
+        }
+        if (args->value != args->value_copy) {
+            atomic_store(&args->inconsistent, true);
+        }
+        pthread_rwlock_unlock(&args->rwlock);
+    }
+    return NULL;
+}
+
+TEST_CASE("rwlock read-mostly data shared by threads", "[pthread][rwlock]")
+{
+    rwlock_stress_args_t args = { .value = 0, .value_copy = 0 };
+    pthread_t threads[RWLOCK_STRESS_THREADS];
+    atomic_init(&args.inconsistent, false);
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_rwlock_init(&args.rwlock, NULL));
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < RWLOCK_STRESS_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, read_mostly, &args));
+    }
+    for (int i = 0; i < RWLOCK_STRESS_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_join(threads[i], NULL));
+    }
+    const int64_t time_us = esp_timer_get_time() - start;
+
+    TEST_ASSERT_FALSE(atomic_load(&args.inconsistent));
+    TEST_ASSERT_EQUAL_UINT32(RWLOCK_STRESS_THREADS * RWLOCK_STRESS_ITERATIONS / RWLOCK_STRESS_WRITE_PERIOD, args.value);
+    printf("%d threads, %d accesses each with 1 write every %d: %"PRId64" us\n",
+           RWLOCK_STRESS_THREADS, RWLOCK_STRESS_ITERATIONS, RWLOCK_STRESS_WRITE_PERIOD, time_us);
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_rwlock_destroy(&args.rwlock));
+}
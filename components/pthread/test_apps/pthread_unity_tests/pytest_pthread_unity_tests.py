@@ -10,6 +10,7 @@ from pytest_embedded_idf.utils import idf_parametrize
     'config',
     [
         'default',
+        'mutex_fast_path',
     ],
     indirect=True,
 )
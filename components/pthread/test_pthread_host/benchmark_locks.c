@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Benchmark of pthread mutexes and rwlocks, uncontended and shared by several threads. The Makefile builds it
+   with and without CONFIG_PTHREAD_MUTEX_FAST_PATH. Run with "make benchmark". */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+
+#define ITERATIONS      1000000
+#define MAX_THREADS     4
+#define WRITE_PERIOD    100     // One write every WRITE_PERIOD accesses in the read-mostly benchmarks
+
+// Defined in pthread.c, which is not part of the benchmark
+portMUX_TYPE pthread_lazy_init_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void check(int res, const char *what)
+{
+    if (res != 0) {
+        printf("%s failed: %d\n", what, res);
+        abort();
+    }
+}
+
+static double bench_uncontended_mutex(int type)
+{
+    pthread_mutex_t mutex;
+    pthread_mutexattr_t attr;
+    check(pthread_mutexattr_init(&attr), "pthread_mutexattr_init");
+    check(pthread_mutexattr_settype(&attr, type), "pthread_mutexattr_settype");
+    check(pthread_mutex_init(&mutex, &attr), "pthread_mutex_init");
+
+    const double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        pthread_mutex_lock(&mutex);
+        pthread_mutex_unlock(&mutex);
+    }
+    const double elapsed = now_ns() - start;
+
+    check(pthread_mutex_destroy(&mutex), "pthread_mutex_destroy");
+    return elapsed / ITERATIONS;
+}
+
+static double bench_uncontended_rwlock(bool write)
+{
+    pthread_rwlock_t rwlock;
+    check(pthread_rwlock_init(&rwlock, NULL), "pthread_rwlock_init");
+
+    const double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        if (write) {
+            pthread_rwlock_wrlock(&rwlock);
+        } else {
+            pthread_rwlock_rdlock(&rwlock);
+        }
+        pthread_rwlock_unlock(&rwlock);
+    }
+    const double elapsed = now_ns() - start;
+
+    check(pthread_rwlock_destroy(&rwlock), "pthread_rwlock_destroy");
+    return elapsed / ITERATIONS;
+}
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_rwlock_t rwlock;
+    bool use_rwlock;
+    int iterations;
+    volatile uint32_t value;
+    volatile uint32_t value_copy;   // Always equal to value when read with the lock held
+} shared_t;
+
+static void *contended_thread(void *arg)
+{
+    shared_t *shared = (shared_t *) arg;
+    for (int i = 0; i < shared->iterations; i++) {
+        const bool write = (i % WRITE_PERIOD) == 0;
+        if (shared->use_rwlock) {
+            if (write) {
+                pthread_rwlock_wrlock(&shared->rwlock);
+            } else {
+                pthread_rwlock_rdlock(&shared->rwlock);
+            }
+        } else {
+            pthread_mutex_lock(&shared->mutex);
+        }
+        if (shared->value != shared->value_copy) {
+            printf("Inconsistent values read with the lock held\n");
+            abort();
+        }
+        if (write) {
+            shared->value++;
+            shared->value_copy++;
+        }
+        if (shared->use_rwlock) {
+            pthread_rwlock_unlock(&shared->rwlock);
+        } else {
+            pthread_mutex_unlock(&shared->mutex);
+        }
+    }
+    return NULL;
+}
+
+/* Time per access of threads sharing data they mostly read, protected by a mutex or an rwlock */
+static double bench_contended(int num_threads, bool use_rwlock)
+{
+    shared_t shared = {
+        .use_rwlock = use_rwlock,
+        .iterations = ITERATIONS / num_threads,
+    };
+    check(pthread_mutex_init(&shared.mutex, NULL), "pthread_mutex_init");
+    check(pthread_rwlock_init(&shared.rwlock, NULL), "pthread_rwlock_init");
+
+    pthread_t threads[MAX_THREADS];
+    const double start = now_ns();
+    for (int i = 0; i < num_threads; i++) {
+        pthread_create(&threads[i], NULL, contended_thread, &shared);
+    }
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    const double elapsed = now_ns() - start;
+
+    const uint32_t expected = num_threads * ((shared.iterations + WRITE_PERIOD - 1) / WRITE_PERIOD);
+    if (shared.value != expected) {
+        printf("%"PRIu32" writes instead of %"PRIu32"\n", shared.value, expected);
+        abort();
+    }
+    check(pthread_rwlock_destroy(&shared.rwlock), "pthread_rwlock_destroy");
+    check(pthread_mutex_destroy(&shared.mutex), "pthread_mutex_destroy");
+    return elapsed / (shared.iterations * num_threads);
+}
+
+int main(void)
+{
+#if CONFIG_PTHREAD_MUTEX_FAST_PATH
+    printf("Mutex fast path enabled\n");
+#else
+    printf("Mutex fast path disabled\n");
+#endif
+    printf("Uncontended, ns per lock and unlock:\n");
+    printf("  normal mutex     %8.2f\n", bench_uncontended_mutex(PTHREAD_MUTEX_NORMAL));
+    printf("  recursive mutex  %8.2f\n", bench_uncontended_mutex(PTHREAD_MUTEX_RECURSIVE));
+    printf("  errorcheck mutex %8.2f\n", bench_uncontended_mutex(PTHREAD_MUTEX_ERRORCHECK));
+    printf("  rwlock read      %8.2f\n", bench_uncontended_rwlock(false));
+    printf("  rwlock write     %8.2f\n", bench_uncontended_rwlock(true));
+    printf("Shared, 1 write every %d accesses, ns per access:\n", WRITE_PERIOD);
+    printf("  %-8s %10s %10s\n", "threads", "mutex", "rwlock");
+    for (int num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+        const double mutex_ns = bench_contended(num_threads, false);
+        const double rwlock_ns = bench_contended(num_threads, true);
+        printf("  %-8d %10.2f %10.2f\n", num_threads, mutex_ns, rwlock_ns);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* Host build of the pthread component sources for the benchmarks, force-included in every one of them.
+   The pthread types and functions they implement are renamed so that they do not clash with the ones of the
+   host C library, which is still used to create the benchmark threads. The types are the ones of newlib, with
+   handles wide enough to hold a host pointer. */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define pthread_key_create          idf_pthread_key_create
+#define pthread_key_delete          idf_pthread_key_delete
+#define pthread_getspecific         idf_pthread_getspecific
+#define pthread_setspecific         idf_pthread_setspecific
+
+#define pthread_mutex_t             idf_pthread_mutex_t
+#define pthread_mutexattr_t         idf_pthread_mutexattr_t
+#define pthread_mutex_init          idf_pthread_mutex_init
+#define pthread_mutex_destroy       idf_pthread_mutex_destroy
+#define pthread_mutex_lock          idf_pthread_mutex_lock
+#define pthread_mutex_timedlock     idf_pthread_mutex_timedlock
+#define pthread_mutex_trylock       idf_pthread_mutex_trylock
+#define pthread_mutex_unlock        idf_pthread_mutex_unlock
+#define pthread_mutexattr_init      idf_pthread_mutexattr_init
+#define pthread_mutexattr_destroy   idf_pthread_mutexattr_destroy
+#define pthread_mutexattr_gettype   idf_pthread_mutexattr_gettype
+#define pthread_mutexattr_settype   idf_pthread_mutexattr_settype
+
+#define pthread_cond_t              idf_pthread_cond_t
+#define pthread_condattr_t          idf_pthread_condattr_t
+#define pthread_cond_init           idf_pthread_cond_init
+#define pthread_cond_destroy        idf_pthread_cond_destroy
+#define pthread_cond_signal         idf_pthread_cond_signal
+#define pthread_cond_broadcast      idf_pthread_cond_broadcast
+#define pthread_cond_wait           idf_pthread_cond_wait
+#define pthread_cond_timedwait      idf_pthread_cond_timedwait
+#define pthread_condattr_init       idf_pthread_condattr_init
+#define pthread_condattr_destroy    idf_pthread_condattr_destroy
+#define pthread_condattr_getpshared idf_pthread_condattr_getpshared
+#define pthread_condattr_setpshared idf_pthread_condattr_setpshared
+#define pthread_condattr_getclock   idf_pthread_condattr_getclock
+#define pthread_condattr_setclock   idf_pthread_condattr_setclock
+
+#define pthread_rwlock_t            idf_pthread_rwlock_t
+#define pthread_rwlockattr_t        idf_pthread_rwlockattr_t
+#define pthread_rwlock_init         idf_pthread_rwlock_init
+#define pthread_rwlock_destroy      idf_pthread_rwlock_destroy
+#define pthread_rwlock_rdlock       idf_pthread_rwlock_rdlock
+#define pthread_rwlock_tryrdlock    idf_pthread_rwlock_tryrdlock
+#define pthread_rwlock_timedrdlock  idf_pthread_rwlock_timedrdlock
+#define pthread_rwlock_wrlock       idf_pthread_rwlock_wrlock
+#define pthread_rwlock_trywrlock    idf_pthread_rwlock_trywrlock
+#define pthread_rwlock_timedwrlock  idf_pthread_rwlock_timedwrlock
+#define pthread_rwlock_unlock       idf_pthread_rwlock_unlock
+
+typedef uintptr_t pthread_mutex_t;
+typedef uintptr_t pthread_cond_t;
+typedef uintptr_t pthread_rwlock_t;
+
+typedef struct {
+    int is_initialized;
+    int type;
+} pthread_mutexattr_t;
+
+typedef struct {
+    int is_initialized;
+    clockid_t clock;
+} pthread_condattr_t;
+
+typedef struct {
+    int is_initialized;
+} pthread_rwlockattr_t;
+
+#undef PTHREAD_MUTEX_INITIALIZER
+#undef PTHREAD_COND_INITIALIZER
+#undef PTHREAD_RWLOCK_INITIALIZER
+#define PTHREAD_MUTEX_INITIALIZER   ((pthread_mutex_t) 0xFFFFFFFF)
+#define PTHREAD_COND_INITIALIZER    ((pthread_cond_t) 0xFFFFFFFF)
+#define PTHREAD_RWLOCK_INITIALIZER  ((pthread_rwlock_t) 0xFFFFFFFF)
+
+int pthread_key_create(pthread_key_t *key, void (*destructor)(void *));
+int pthread_key_delete(pthread_key_t key);
+void *pthread_getspecific(pthread_key_t key);
+int pthread_setspecific(pthread_key_t key, const void *value);
+
+int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr);
+int pthread_mutex_destroy(pthread_mutex_t *mutex);
+int pthread_mutex_lock(pthread_mutex_t *mutex);
+int pthread_mutex_timedlock(pthread_mutex_t *mutex, const struct timespec *timeout);
+int pthread_mutex_trylock(pthread_mutex_t *mutex);
+int pthread_mutex_unlock(pthread_mutex_t *mutex);
+int pthread_mutexattr_init(pthread_mutexattr_t *attr);
+int pthread_mutexattr_destroy(pthread_mutexattr_t *attr);
+int pthread_mutexattr_gettype(const pthread_mutexattr_t *attr, int *type);
+int pthread_mutexattr_settype(pthread_mutexattr_t *attr, int type);
+
+int pthread_cond_init(pthread_cond_t *cv, const pthread_condattr_t *attr);
+int pthread_cond_destroy(pthread_cond_t *cv);
+int pthread_cond_signal(pthread_cond_t *cv);
+int pthread_cond_broadcast(pthread_cond_t *cv);
+int pthread_cond_wait(pthread_cond_t *cv, pthread_mutex_t *mut);
+int pthread_cond_timedwait(pthread_cond_t *cv, pthread_mutex_t *mut, const struct timespec *to);
+int pthread_condattr_init(pthread_condattr_t *attr);
+int pthread_condattr_destroy(pthread_condattr_t *attr);
+int pthread_condattr_getpshared(const pthread_condattr_t *restrict attr, int *restrict pshared);
+int pthread_condattr_setpshared(pthread_condattr_t *attr, int pshared);
+int pthread_condattr_getclock(const pthread_condattr_t *attr, clockid_t *clock_id);
+int pthread_condattr_setclock(pthread_condattr_t *attr, clockid_t clock_id);
+
+int pthread_rwlock_init(pthread_rwlock_t *rwlock, const pthread_rwlockattr_t *attr);
+int pthread_rwlock_destroy(pthread_rwlock_t *rwlock);
+int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock);
+int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock);
+int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock, const struct timespec *abstime);
+int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock);
+int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock);
+int pthread_rwlock_timedwrlock(pthread_rwlock_t *rwlock, const struct timespec *abstime);
+int pthread_rwlock_unlock(pthread_rwlock_t *rwlock);
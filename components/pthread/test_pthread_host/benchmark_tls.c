@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Benchmark of pthread_getspecific() and pthread_setspecific() with an increasing number of keys,
+   which should not change the time per call, and of the destructors run when threads exit.
+   The host C library functions are measured too, for reference. Run with "make benchmark". */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "../pthread_internal.h"
+
+// The functions of pthread_local_storage.c are called with their idf_ names, the host ones for reference
+#undef pthread_key_create
+#undef pthread_key_delete
+#undef pthread_getspecific
+#undef pthread_setspecific
+
+#define ITERATIONS      2000000
+#define MAX_KEYS        256
+#define THREADS         4
+#define THREAD_KEYS     16
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef struct {
+    int (*key_create)(pthread_key_t *, void (*)(void *));
+    int (*key_delete)(pthread_key_t);
+    void *(*getspecific)(pthread_key_t);
+    int (*setspecific)(pthread_key_t, const void *);
+} tls_api_t;
+
+static const tls_api_t s_idf_api = { idf_pthread_key_create, idf_pthread_key_delete, idf_pthread_getspecific, idf_pthread_setspecific };
+static const tls_api_t s_host_api = { pthread_key_create, pthread_key_delete, pthread_getspecific, pthread_setspecific };
+
+/* Time of a set and a get of the key created last, with num_keys keys set in the thread */
+static double bench_get_set(const tls_api_t *api, int num_keys)
+{
+    static pthread_key_t keys[MAX_KEYS];
+    for (int i = 0; i < num_keys; i++) {
+        if (api->key_create(&keys[i], NULL) != 0) {
+            abort();
+        }
+        api->setspecific(keys[i], &keys[i]);
+    }
+    const pthread_key_t key = keys[num_keys - 1];
+    uintptr_t sum = 0;
+    const double start = now_ns();
+    for (uintptr_t i = 1; i <= ITERATIONS; i++) {
+        api->setspecific(key, (void *)i);
+        sum += (uintptr_t)api->getspecific(key);
+    }
+    const double elapsed = now_ns() - start;
+    if (sum != (uintptr_t)ITERATIONS * (ITERATIONS + 1) / 2) {
+        printf("Wrong values read back\n");
+        abort();
+    }
+    for (int i = 0; i < num_keys; i++) {
+        api->setspecific(keys[i], NULL);
+        api->key_delete(keys[i]);
+    }
+    return elapsed / ITERATIONS;
+}
+
+static pthread_key_t s_thread_keys[THREAD_KEYS];
+static volatile int s_destructor_calls;
+
+static void count_destructor(void *value)
+{
+    __atomic_fetch_add(&s_destructor_calls, 1, __ATOMIC_RELAXED);
+}
+
+static void *thread_func(void *arg)
+{
+    for (int round = 0; round < ITERATIONS / 1000; round++) {
+        for (int i = 0; i < THREAD_KEYS; i++) {
+            idf_pthread_setspecific(s_thread_keys[i], arg);
+            if (idf_pthread_getspecific(s_thread_keys[i]) != arg) {
+                abort();
+            }
+        }
+    }
+    // As done by pthread_exit(), the destructors of the values set above are called once
+    pthread_internal_local_storage_destructor_callback(NULL);
+    return NULL;
+}
+
+/* Threads setting the same keys concurrently, each running the destructors when it exits */
+static double bench_threads(void)
+{
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREAD_KEYS; i++) {
+        idf_pthread_key_create(&s_thread_keys[i], count_destructor);
+    }
+    s_destructor_calls = 0;
+    const double start = now_ns();
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, thread_func, (void *)(uintptr_t)(i + 1));
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    const double elapsed = now_ns() - start;
+    if (s_destructor_calls != THREADS * THREAD_KEYS) {
+        printf("%d destructor calls instead of %d\n", s_destructor_calls, THREADS * THREAD_KEYS);
+        abort();
+    }
+    for (int i = 0; i < THREAD_KEYS; i++) {
+        idf_pthread_key_delete(s_thread_keys[i]);
+    }
+    return elapsed / ((double)THREADS * (ITERATIONS / 1000) * THREAD_KEYS);
+}
+
+/* Time to create and delete a key, with MAX_KEYS / 2 other keys */
+static double bench_key_churn(void)
+{
+    pthread_key_t keys[MAX_KEYS / 2];
+    for (int i = 0; i < MAX_KEYS / 2; i++) {
+        idf_pthread_key_create(&keys[i], NULL);
+    }
+    const double start = now_ns();
+    for (int i = 0; i < ITERATIONS / 10; i++) {
+        pthread_key_t key;
+        if (idf_pthread_key_create(&key, NULL) != 0) {
+            abort();
+        }
+        // The key reuses the slot of the one deleted in the previous iteration, whose value must not be seen
+        if (idf_pthread_getspecific(key) != NULL) {
+            printf("Value of a deleted key returned\n");
+            abort();
+        }
+        idf_pthread_setspecific(key, &key);
+        idf_pthread_key_delete(key);
+    }
+    const double elapsed = now_ns() - start;
+    for (int i = 0; i < MAX_KEYS / 2; i++) {
+        idf_pthread_key_delete(keys[i]);
+    }
+    return elapsed / (ITERATIONS / 10);
+}
+
+int main(void)
+{
+    printf("%-10s %14s %14s\n", "keys", "idf ns/op", "host ns/op");
+    for (int num_keys = 1; num_keys <= MAX_KEYS; num_keys *= 4) {
+        printf("%-10d %14.2f %14.2f\n", num_keys, bench_get_set(&s_idf_api, num_keys), bench_get_set(&s_host_api, num_keys));
+    }
+    printf("%d threads x %d keys: %.2f ns per set and get\n", THREADS, THREAD_KEYS, bench_threads());
+    printf("Key create, set and delete: %.2f ns\n", bench_key_churn());
+    return 0;
+}
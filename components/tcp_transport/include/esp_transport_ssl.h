@@ -262,6 +262,58 @@ void esp_transport_ssl_set_interface_name(esp_transport_handle_t t, struct ifreq
  */
 void esp_transport_ssl_set_addr_family(esp_transport_handle_t t, esp_tls_addr_family_t addr_family);
 
+/**
+ * @brief   Established connection state which can be moved between transports
+ *
+ * Used to park an idle keep-alive connection outside of the transport that created it,
+ * so that it can later be attached to another transport of the same type and configuration.
+ */
+typedef struct {
+    esp_tls_t   *tls;       /*!< esp-tls connection object, NULL for a plain TCP connection */
+    int         sockfd;     /*!< Connected socket, -1 if there is no connection */
+} esp_transport_ssl_conn_t;
+
+/**
+ * @brief      Detach the established connection from the transport without closing it
+ *
+ *             After this call the transport is in the closed state and the ownership of
+ *             the connection is passed to the caller.
+ *
+ * @note       Works for both SSL and TCP transports created with esp_transport_ssl_init()
+ *             and esp_transport_tcp_init()
+ *
+ * @param[in]  t     The transport handle
+ * @param[out] conn  Connection state
+ *
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if any argument is NULL
+ *     - ESP_ERR_INVALID_STATE if the transport is not connected
+ */
+esp_err_t esp_transport_ssl_detach_connection(esp_transport_handle_t t, esp_transport_ssl_conn_t *conn);
+
+/**
+ * @brief      Attach a connection previously obtained with esp_transport_ssl_detach_connection()
+ *
+ *             The transport takes the ownership of the connection, it is released by esp_transport_close().
+ *
+ * @param[in]  t     The transport handle, must not be connected
+ * @param[in]  conn  Connection state
+ *
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if any argument is NULL or the connection is not valid
+ *     - ESP_ERR_INVALID_STATE if the transport is already connected
+ */
+esp_err_t esp_transport_ssl_attach_connection(esp_transport_handle_t t, const esp_transport_ssl_conn_t *conn);
+
+/**
+ * @brief      Close a detached connection and release its resources
+ *
+ * @param[in]  conn  Connection state, reset to the empty state on return
+ */
+void esp_transport_ssl_conn_close(esp_transport_ssl_conn_t *conn);
+
 #ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
 /**
  * @brief   Session ticket operation
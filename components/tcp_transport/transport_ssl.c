@@ -612,6 +612,54 @@ void esp_transport_tcp_set_interface_name(esp_transport_handle_t t, struct ifreq
     return esp_transport_ssl_set_interface_name(t, if_name);
 }
 
+esp_err_t esp_transport_ssl_detach_connection(esp_transport_handle_t t, esp_transport_ssl_conn_t *conn)
+{
+    transport_esp_tls_t *ssl = ssl_get_context_data(t);
+    if (!ssl || !conn) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ssl->sockfd < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    conn->tls = ssl->ssl_initialized ? ssl->tls : NULL;
+    conn->sockfd = ssl->sockfd;
+    ssl->tls = NULL;
+    ssl->conn_state = TRANS_SSL_INIT;
+    ssl->ssl_initialized = false;
+    ssl->sockfd = INVALID_SOCKET;
+    return ESP_OK;
+}
+
+esp_err_t esp_transport_ssl_attach_connection(esp_transport_handle_t t, const esp_transport_ssl_conn_t *conn)
+{
+    transport_esp_tls_t *ssl = ssl_get_context_data(t);
+    if (!ssl || !conn || conn->sockfd < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ssl->ssl_initialized || ssl->sockfd >= 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ssl->tls = conn->tls;
+    ssl->ssl_initialized = (conn->tls != NULL);
+    ssl->conn_state = TRANS_SSL_INIT;
+    ssl->sockfd = conn->sockfd;
+    return ESP_OK;
+}
+
+void esp_transport_ssl_conn_close(esp_transport_ssl_conn_t *conn)
+{
+    if (!conn) {
+        return;
+    }
+    if (conn->tls) {
+        esp_tls_conn_destroy(conn->tls);
+    } else if (conn->sockfd >= 0) {
+        close(conn->sockfd);
+    }
+    conn->tls = NULL;
+    conn->sockfd = INVALID_SOCKET;
+}
+
 #ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
 esp_err_t esp_transport_ssl_session_ticket_operation(esp_transport_handle_t t, esp_transport_session_ticket_operation_t operation)
 {
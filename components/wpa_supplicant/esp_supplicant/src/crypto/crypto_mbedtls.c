@@ -41,6 +41,9 @@
 #ifdef CONFIG_FAST_PBKDF2
 #include "fastpbkdf2.h"
 #include "fastpsk.h"
+#ifdef CONFIG_ESP_WIFI_PSK_CACHE
+#include "psk_cache.h"
+#endif
 #endif
 
 static int digest_vector(mbedtls_md_type_t md_type, size_t num_elem,
@@ -781,8 +784,8 @@ cleanup:
 }
 
 #if defined(CONFIG_MBEDTLS_SHA1_C) || defined(CONFIG_MBEDTLS_HARDWARE_SHA)
-int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
-                int iterations, u8 *buf, size_t buflen)
+static int pbkdf2_sha1_derive(const char *passphrase, const u8 *ssid, size_t ssid_len,
+                              int iterations, u8 *buf, size_t buflen)
 {
 #ifdef CONFIG_FAST_PBKDF2
     /* For ESP32: Using pbkdf2_hmac_sha1() because esp_fast_psk() utilizes hardware,
@@ -802,6 +805,26 @@ int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
     return ret == 0 ? 0 : -1;
 #endif
 }
+
+int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
+                int iterations, u8 *buf, size_t buflen)
+{
+#ifdef CONFIG_ESP_WIFI_PSK_CACHE
+    /* Only WPA PSK derivations (4096 iterations, 32 byte PMK) are cached */
+    bool is_psk = iterations == 4096 && buflen == 32;
+
+    if (is_psk && psk_cache_get(passphrase, ssid, ssid_len, buf) == 0) {
+        return 0;
+    }
+    int ret = pbkdf2_sha1_derive(passphrase, ssid, ssid_len, iterations, buf, buflen);
+    if (is_psk && ret == 0) {
+        psk_cache_add(passphrase, ssid, ssid_len, buf);
+    }
+    return ret;
+#else
+    return pbkdf2_sha1_derive(passphrase, ssid, ssid_len, iterations, buf, buflen);
+#endif
+}
 #endif /* defined(CONFIG_MBEDTLS_SHA1_C) || defined(CONFIG_MBEDTLS_HARDWARE_SHA) */
 
 #ifdef MBEDTLS_DES_C
@@ -27,6 +27,7 @@
 #endif
 
 #include <mbedtls/sha1.h>
+#include <mbedtls/platform_util.h>
 #include "mbedtls/esp_config.h"
 #include "utils/wpa_debug.h"
 
@@ -379,10 +380,243 @@ DECL_PBKDF2(sha1,                           // _name
             sha1_extract,                   // _xtract
             sha1_xor)                       // _xxor
 
+/* --- Multi-lane PBKDF2-HMAC-SHA1 ---
+ *
+ * Every output block of PBKDF2 is an independent chain of 2 * iterations SHA-1
+ * compressions, and so are the blocks of different passwords or salts. The
+ * engine below runs up to FASTPBKDF2_SHA1_LANES such chains interleaved: each
+ * step of the compression is applied to all lanes before the next one, which
+ * hides the latency of the dependent rounds and lets the compiler vectorize
+ * the lane loops on hosts with SIMD units.
+ *
+ * The loop only ever hashes blocks made of a 20 byte U value followed by the
+ * padding of a 84 byte message (the key block plus U), so the message schedule
+ * is built from U and constants. HMAC setup and U_1 still go through the
+ * mbedtls based code above, which handles any password and salt length. */
+
+#define SHA1_LANE_MSG_BITS ((64 + 20) * 8)
+
+static inline uint32_t read32_be(const uint8_t in[4])
+{
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+static inline uint32_t rol32(uint32_t x, unsigned n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+/* Rounds _t0.._t1-1; _expand must be 0 for rounds 0..15, which use the block
+ * as is, and 1 for the others, which extend the message schedule in place. */
+#define SHA1_LANE_ROUNDS(_t0, _t1, _f, _k, _expand)                           \
+  for (int t = (_t0); t < (_t1); t++)                                         \
+  {                                                                           \
+    for (size_t l = 0; l < nlanes; l++)                                       \
+    {                                                                         \
+      uint32_t wt = w[t & 15][l];                                             \
+      if (_expand)                                                            \
+      {                                                                       \
+        wt = rol32(w[(t - 3) & 15][l] ^ w[(t - 8) & 15][l] ^                  \
+                   w[(t - 14) & 15][l] ^ wt, 1);                              \
+        w[t & 15][l] = wt;                                                    \
+      }                                                                       \
+      const uint32_t tmp = rol32(a[l], 5) + (_f) + e[l] + (_k) + wt;          \
+      e[l] = d[l];                                                            \
+      d[l] = c[l];                                                            \
+      c[l] = rol32(b[l], 30);                                                 \
+      b[l] = a[l];                                                            \
+      a[l] = tmp;                                                             \
+    }                                                                         \
+  }
+
+/* out = SHA-1 compression of start over the block (u || padding), for nlanes lanes.
+ * out may be the same array as u. Always inlined so that the lane loops are
+ * unrolled for the constant lane counts used by sha1_lanes_run(). */
+static inline __attribute__((always_inline)) void sha1_lanes_xform(uint32_t out[5][FASTPBKDF2_SHA1_LANES],
+                             const uint32_t start[5][FASTPBKDF2_SHA1_LANES],
+                             const uint32_t u[5][FASTPBKDF2_SHA1_LANES],
+                             size_t nlanes)
+{
+    uint32_t w[16][FASTPBKDF2_SHA1_LANES];
+    uint32_t a[FASTPBKDF2_SHA1_LANES], b[FASTPBKDF2_SHA1_LANES], c[FASTPBKDF2_SHA1_LANES];
+    uint32_t d[FASTPBKDF2_SHA1_LANES], e[FASTPBKDF2_SHA1_LANES];
+
+    for (size_t l = 0; l < nlanes; l++) {
+        for (int i = 0; i < 5; i++) {
+            w[i][l] = u[i][l];
+        }
+        w[5][l] = 0x80000000;
+        for (int i = 6; i < 15; i++) {
+            w[i][l] = 0;
+        }
+        w[15][l] = SHA1_LANE_MSG_BITS;
+        a[l] = start[0][l];
+        b[l] = start[1][l];
+        c[l] = start[2][l];
+        d[l] = start[3][l];
+        e[l] = start[4][l];
+    }
+
+    SHA1_LANE_ROUNDS(0, 16, (b[l] & c[l]) | (~b[l] & d[l]), 0x5A827999, 0)
+    SHA1_LANE_ROUNDS(16, 20, (b[l] & c[l]) | (~b[l] & d[l]), 0x5A827999, 1)
+    SHA1_LANE_ROUNDS(20, 40, b[l] ^ c[l] ^ d[l], 0x6ED9EBA1, 1)
+    SHA1_LANE_ROUNDS(40, 60, (b[l] & c[l]) | (b[l] & d[l]) | (c[l] & d[l]), 0x8F1BBCDC, 1)
+    SHA1_LANE_ROUNDS(60, 80, b[l] ^ c[l] ^ d[l], 0xCA62C1D6, 1)
+
+    for (size_t l = 0; l < nlanes; l++) {
+        out[0][l] = start[0][l] + a[l];
+        out[1][l] = start[1][l] + b[l];
+        out[2][l] = start[2][l] + c[l];
+        out[3][l] = start[3][l] + d[l];
+        out[4][l] = start[4][l] + e[l];
+    }
+}
+
+typedef struct {
+    uint32_t inner[5][FASTPBKDF2_SHA1_LANES];   /* state after the ipad block */
+    uint32_t outer[5][FASTPBKDF2_SHA1_LANES];   /* state after the opad block */
+    uint32_t u[5][FASTPBKDF2_SHA1_LANES];       /* U_c */
+    uint32_t acc[5][FASTPBKDF2_SHA1_LANES];     /* U_1 ^ ... ^ U_c */
+    uint8_t *dst[FASTPBKDF2_SHA1_LANES];
+    size_t dst_len[FASTPBKDF2_SHA1_LANES];
+} sha1_lanes_t;
+
+/* Load lane l with output block `counter` of a job: key states and U_1 */
+static void sha1_lanes_load(sha1_lanes_t *lanes, size_t l, const fastpbkdf2_sha1_job_t *job, uint32_t counter)
+{
+    HMAC_CTX(sha1) start, ctx;
+    uint8_t buf[20];
+
+    HMAC_INIT(sha1)(&start, job->pw, job->npw);
+    sha1_extract(&start.inner, buf);
+    for (int i = 0; i < 5; i++) {
+        lanes->inner[i][l] = read32_be(buf + 4 * i);
+    }
+    sha1_extract(&start.outer, buf);
+    for (int i = 0; i < 5; i++) {
+        lanes->outer[i][l] = read32_be(buf + 4 * i);
+    }
+
+    /* U_1 = PRF(P, S || INT_32_BE(i)) */
+    uint8_t countbuf[4];
+    write32_be(counter, countbuf);
+    ctx = start;
+    HMAC_UPDATE(sha1)(&ctx, job->salt, job->nsalt);
+    HMAC_UPDATE(sha1)(&ctx, countbuf, sizeof countbuf);
+    HMAC_FINAL(sha1)(&ctx, buf);
+    for (int i = 0; i < 5; i++) {
+        lanes->u[i][l] = lanes->acc[i][l] = read32_be(buf + 4 * i);
+    }
+
+    size_t offset = (counter - 1) * 20;
+    lanes->dst[l] = job->out + offset;
+    lanes->dst_len[l] = MIN(job->nout - offset, 20);
+
+    mbedtls_sha1_free(&start.inner);
+    mbedtls_sha1_free(&start.outer);
+    mbedtls_sha1_free(&ctx.inner);
+    mbedtls_sha1_free(&ctx.outer);
+    mbedtls_platform_zeroize(buf, sizeof(buf));
+}
+
+/* Out-of-line instances of sha1_lanes_xform(): all lanes in use, the two lanes
+ * of a single WPA PMK, and any other partial group */
+static void sha1_lanes_xform_full(uint32_t out[5][FASTPBKDF2_SHA1_LANES],
+                                  const uint32_t start[5][FASTPBKDF2_SHA1_LANES],
+                                  const uint32_t u[5][FASTPBKDF2_SHA1_LANES])
+{
+    sha1_lanes_xform(out, start, u, FASTPBKDF2_SHA1_LANES);
+}
+
+#if FASTPBKDF2_SHA1_LANES > 2
+static void sha1_lanes_xform_pair(uint32_t out[5][FASTPBKDF2_SHA1_LANES],
+                                  const uint32_t start[5][FASTPBKDF2_SHA1_LANES],
+                                  const uint32_t u[5][FASTPBKDF2_SHA1_LANES])
+{
+    sha1_lanes_xform(out, start, u, 2);
+}
+#endif
+
+static void sha1_lanes_xform_partial(uint32_t out[5][FASTPBKDF2_SHA1_LANES],
+                                     const uint32_t start[5][FASTPBKDF2_SHA1_LANES],
+                                     const uint32_t u[5][FASTPBKDF2_SHA1_LANES],
+                                     size_t nlanes)
+{
+    sha1_lanes_xform(out, start, u, nlanes);
+}
+
+static void sha1_lanes_run(sha1_lanes_t *lanes, size_t nlanes, uint32_t iterations)
+{
+    /* U_c = PRF(P, U_{c-1}) */
+    for (uint32_t i = 1; i < iterations; i++) {
+        /* A partial group happens for the last group of a batch, and for a single
+         * WPA PMK (2 blocks) with more lanes; only the lanes in use are computed. */
+        if (nlanes == FASTPBKDF2_SHA1_LANES) {
+            sha1_lanes_xform_full(lanes->u, lanes->inner, lanes->u);
+            sha1_lanes_xform_full(lanes->u, lanes->outer, lanes->u);
+#if FASTPBKDF2_SHA1_LANES > 2
+        } else if (nlanes == 2) {
+            sha1_lanes_xform_pair(lanes->u, lanes->inner, lanes->u);
+            sha1_lanes_xform_pair(lanes->u, lanes->outer, lanes->u);
+#endif
+        } else {
+            sha1_lanes_xform_partial(lanes->u, lanes->inner, lanes->u, nlanes);
+            sha1_lanes_xform_partial(lanes->u, lanes->outer, lanes->u, nlanes);
+        }
+        for (int j = 0; j < 5; j++) {
+            for (size_t l = 0; l < nlanes; l++) {
+                lanes->acc[j][l] ^= lanes->u[j][l];
+            }
+        }
+    }
+
+    for (size_t l = 0; l < nlanes; l++) {
+        uint8_t block[20];
+        for (int j = 0; j < 5; j++) {
+            write32_be(lanes->acc[j][l], block + 4 * j);
+        }
+        memcpy(lanes->dst[l], block, lanes->dst_len[l]);
+        mbedtls_platform_zeroize(block, sizeof(block));
+    }
+}
+
+void fastpbkdf2_hmac_sha1_multi(const fastpbkdf2_sha1_job_t *jobs, size_t njobs, uint32_t iterations)
+{
+    assert(iterations);
+
+    sha1_lanes_t lanes;
+    size_t nlanes = 0;
+
+    for (size_t j = 0; j < njobs; j++) {
+        assert(jobs[j].out && jobs[j].nout);
+        uint32_t blocks_needed = (uint32_t)(jobs[j].nout + 20 - 1) / 20;
+
+        for (uint32_t counter = 1; counter <= blocks_needed; counter++) {
+            sha1_lanes_load(&lanes, nlanes++, &jobs[j], counter);
+            if (nlanes == FASTPBKDF2_SHA1_LANES) {
+                sha1_lanes_run(&lanes, nlanes, iterations);
+                nlanes = 0;
+            }
+        }
+    }
+    if (nlanes) {
+        sha1_lanes_run(&lanes, nlanes, iterations);
+    }
+
+    mbedtls_platform_zeroize(&lanes, sizeof(lanes));
+}
+
 void fastpbkdf2_hmac_sha1(const uint8_t *pw, size_t npw,
                           const uint8_t *salt, size_t nsalt,
                           uint32_t iterations,
                           uint8_t *out, size_t nout)
 {
+#if FASTPBKDF2_SHA1_LANES > 1
+    const fastpbkdf2_sha1_job_t job = {
+        .pw = pw, .npw = npw, .salt = salt, .nsalt = nsalt, .out = out, .nout = nout,
+    };
+    fastpbkdf2_hmac_sha1_multi(&job, 1, iterations);
+#else
     PBKDF2(sha1)(pw, npw, salt, nsalt, iterations, out, nout);
+#endif
 }
@@ -23,11 +23,29 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include "sdkconfig.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Number of PBKDF2 output blocks computed together by fastpbkdf2_hmac_sha1_multi(). */
+#ifdef CONFIG_ESP_WIFI_FAST_PBKDF2_LANES
+#define FASTPBKDF2_SHA1_LANES CONFIG_ESP_WIFI_FAST_PBKDF2_LANES
+#else
+#define FASTPBKDF2_SHA1_LANES 1
+#endif
+
+/** One PBKDF2-HMAC-SHA1 derivation for fastpbkdf2_hmac_sha1_multi(). */
+typedef struct {
+    const uint8_t *pw;      /**< password */
+    size_t npw;             /**< password length */
+    const uint8_t *salt;    /**< salt */
+    size_t nsalt;           /**< salt length */
+    uint8_t *out;           /**< output buffer */
+    size_t nout;            /**< output length, must be non-zero */
+} fastpbkdf2_sha1_job_t;
+
 /** Calculates PBKDF2-HMAC-SHA1.
  *
  *  @p npw bytes at @p pw are the password input.
@@ -41,6 +59,18 @@ void fastpbkdf2_hmac_sha1(const uint8_t *pw, size_t npw,
                           const uint8_t *salt, size_t nsalt,
                           uint32_t iterations,
                           uint8_t *out, size_t nout);
+
+/** Calculates PBKDF2-HMAC-SHA1 for several password/salt pairs at once.
+ *
+ *  All output blocks of all @p njobs jobs are spread over FASTPBKDF2_SHA1_LANES
+ *  interleaved SHA-1 lanes, e.g. both blocks of a WPA PMK, or the PMKs of
+ *  several networks.  @p iterations is shared by all jobs and must be non-zero.
+ *
+ *  This function cannot fail; it does not report errors.
+ */
+void fastpbkdf2_hmac_sha1_multi(const fastpbkdf2_sha1_job_t *jobs, size_t njobs,
+                                uint32_t iterations);
+
 #ifdef __cplusplus
 }
 #endif
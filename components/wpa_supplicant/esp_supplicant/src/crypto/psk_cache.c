@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "utils/includes.h"
+#include "utils/common.h"
+#include "crypto/crypto.h"
+#include "crypto/sha256.h"
+#include "freertos/FreeRTOS.h"
+#include "psk_cache.h"
+
+#define PSK_CACHE_SSID_MAX_LEN  32
+#define PSK_CACHE_PMK_LEN       32
+
+struct psk_cache_entry {
+    u8 ssid[PSK_CACHE_SSID_MAX_LEN];
+    u8 ssid_len;
+    bool used;
+    u8 passphrase_hash[SHA256_MAC_LEN];
+    u8 pmk[PSK_CACHE_PMK_LEN];
+    u32 last_use;
+};
+
+static struct psk_cache_entry s_psk_cache[CONFIG_ESP_WIFI_PSK_CACHE_SIZE];
+static u32 s_psk_cache_counter;
+static portMUX_TYPE s_psk_cache_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int psk_cache_hash_passphrase(const char *passphrase, u8 *hash)
+{
+    const u8 *addr[1] = { (const u8 *) passphrase };
+    const size_t len[1] = { os_strlen(passphrase) };
+
+    return sha256_vector(1, addr, len, hash);
+}
+
+static struct psk_cache_entry *psk_cache_find(const u8 *hash, const u8 *ssid, size_t ssid_len)
+{
+    for (int i = 0; i < CONFIG_ESP_WIFI_PSK_CACHE_SIZE; i++) {
+        struct psk_cache_entry *entry = &s_psk_cache[i];
+
+        if (entry->used && entry->ssid_len == ssid_len &&
+                os_memcmp(entry->ssid, ssid, ssid_len) == 0 &&
+                os_memcmp_const(entry->passphrase_hash, hash, SHA256_MAC_LEN) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+int psk_cache_get(const char *passphrase, const u8 *ssid, size_t ssid_len, u8 *pmk)
+{
+    u8 hash[SHA256_MAC_LEN];
+    int ret = -1;
+
+    if (ssid_len > PSK_CACHE_SSID_MAX_LEN || psk_cache_hash_passphrase(passphrase, hash) != 0) {
+        return -1;
+    }
+
+    portENTER_CRITICAL(&s_psk_cache_lock);
+    struct psk_cache_entry *entry = psk_cache_find(hash, ssid, ssid_len);
+    if (entry) {
+        os_memcpy(pmk, entry->pmk, PSK_CACHE_PMK_LEN);
+        entry->last_use = ++s_psk_cache_counter;
+        ret = 0;
+    }
+    portEXIT_CRITICAL(&s_psk_cache_lock);
+
+    forced_memzero(hash, sizeof(hash));
+    return ret;
+}
+
+void psk_cache_add(const char *passphrase, const u8 *ssid, size_t ssid_len, const u8 *pmk)
+{
+    u8 hash[SHA256_MAC_LEN];
+
+    if (ssid_len > PSK_CACHE_SSID_MAX_LEN || psk_cache_hash_passphrase(passphrase, hash) != 0) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_psk_cache_lock);
+    struct psk_cache_entry *entry = psk_cache_find(hash, ssid, ssid_len);
+    if (!entry) {
+        /* Free entry first, least recently used otherwise */
+        entry = &s_psk_cache[0];
+        for (int i = 0; i < CONFIG_ESP_WIFI_PSK_CACHE_SIZE; i++) {
+            if (!s_psk_cache[i].used) {
+                entry = &s_psk_cache[i];
+                break;
+            }
+            if ((s32)(s_psk_cache[i].last_use - entry->last_use) < 0) {
+                entry = &s_psk_cache[i];
+            }
+        }
+        os_memcpy(entry->ssid, ssid, ssid_len);
+        entry->ssid_len = ssid_len;
+        os_memcpy(entry->passphrase_hash, hash, SHA256_MAC_LEN);
+        entry->used = true;
+    }
+    os_memcpy(entry->pmk, pmk, PSK_CACHE_PMK_LEN);
+    entry->last_use = ++s_psk_cache_counter;
+    portEXIT_CRITICAL(&s_psk_cache_lock);
+
+    forced_memzero(hash, sizeof(hash));
+}
+
+void psk_cache_flush(void)
+{
+    portENTER_CRITICAL(&s_psk_cache_lock);
+    forced_memzero(s_psk_cache, sizeof(s_psk_cache));
+    portEXIT_CRITICAL(&s_psk_cache_lock);
+}
@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cache of PMKs derived from a passphrase with PBKDF2-SHA1 (4096 iterations, 32 bytes).
+ *
+ * Entries are keyed by the SSID and a SHA-256 hash of the passphrase, so that reconnecting
+ * to a network seen before, or roaming back to it, skips the derivation.
+ */
+
+/**
+ * @brief Look up the PMK of a passphrase and SSID
+ *
+ * @param passphrase  NUL terminated passphrase
+ * @param ssid        SSID
+ * @param ssid_len    Length of SSID
+ * @param pmk         Buffer of 32 bytes for the PMK
+ * @return 0 if found, -1 otherwise
+ */
+int psk_cache_get(const char *passphrase, const uint8_t *ssid, size_t ssid_len, uint8_t *pmk);
+
+/**
+ * @brief Store the PMK of a passphrase and SSID, replacing the least recently used entry if full
+ *
+ * @param passphrase  NUL terminated passphrase
+ * @param ssid        SSID
+ * @param ssid_len    Length of SSID
+ * @param pmk         PMK, 32 bytes
+ */
+void psk_cache_add(const char *passphrase, const uint8_t *ssid, size_t ssid_len, const uint8_t *pmk);
+
+/**
+ * @brief Remove and clear all entries
+ */
+void psk_cache_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -47,6 +47,10 @@
 #include "esp_dpp_i.h"
 #endif
 
+#ifdef CONFIG_ESP_WIFI_PSK_CACHE
+#include "crypto/psk_cache.h"
+#endif
+
 bool g_wpa_pmk_caching_disabled = 0;
 const wifi_osi_funcs_t *wifi_funcs;
 struct wpa_funcs *wpa_cb;
@@ -534,6 +538,9 @@ int esp_supplicant_deinit(void)
     wpa_cb = NULL;
 #if CONFIG_ESP_WIFI_WAPI_PSK
     esp_wifi_internal_wapi_deinit();
+#endif
+#ifdef CONFIG_ESP_WIFI_PSK_CACHE
+    psk_cache_flush();
 #endif
     return esp_wifi_unregister_wpa_cb_internal();
 }
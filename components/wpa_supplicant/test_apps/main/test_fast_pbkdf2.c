@@ -10,16 +10,15 @@
 #include "mbedtls/pkcs5.h"
 #include "crypto/sha1.h"
 #include "test_wpa_supplicant_common.h"
+#include "crypto/fastpbkdf2.h"
+#ifdef CONFIG_ESP_WIFI_PSK_CACHE
+#include "crypto/psk_cache.h"
+#endif
 
 #define PMK_LEN 32
 #define NUM_ITERATIONS 5
 #define MIN_PASSPHARSE_LEN 8
 
-void fastpbkdf2_hmac_sha1(const uint8_t *pw, size_t npw,
-                          const uint8_t *salt, size_t nsalt,
-                          uint32_t iterations,
-                          uint8_t *out, size_t nout);
-
 int64_t esp_timer_get_time(void);
 
 #if defined(CONFIG_MBEDTLS_SHA1_C) || defined(CONFIG_MBEDTLS_HARDWARE_SHA)
@@ -106,4 +105,161 @@ TEST_CASE("Test pbkdf2", "[crypto-pbkdf2]")
     ESP_LOGI("Timing", "Average time for fast_pbkdf2_sha1: %lld microseconds", avg_time_fast);
     ESP_LOGI("Timing", "Average time for mbedtls_pkcs5_pbkdf2_hmac_ext: %lld microseconds", avg_time_mbedtls);
 }
+
+typedef struct {
+    const char *pw;
+    const char *salt;
+    uint32_t iterations;
+    size_t len;
+    uint8_t expected[PMK_LEN];
+} pbkdf2_kat_t;
+
+/* RFC 6070 and IEEE 802.11-2016 Annex J.4 test vectors */
+static const pbkdf2_kat_t s_pbkdf2_kats[] = {
+    {
+        "password", "salt", 1, 20,
+        {
+            0x0c, 0x60, 0xc8, 0x0f, 0x96, 0x1f, 0x0e, 0x71, 0xf3, 0xa9, 0xb5, 0x24, 0xaf, 0x60, 0x12, 0x06,
+            0x2f, 0xe0, 0x37, 0xa6
+        }
+    },
+    {
+        "password", "salt", 4096, 20,
+        {
+            0x4b, 0x00, 0x79, 0x01, 0xb7, 0x65, 0x48, 0x9a, 0xbe, 0xad, 0x49, 0xd9, 0x26, 0xf7, 0x21, 0xd0,
+            0x65, 0xa4, 0x29, 0xc1
+        }
+    },
+    {
+        "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 25,
+        {
+            0x3d, 0x2e, 0xec, 0x4f, 0xe4, 0x1c, 0x84, 0x9b, 0x80, 0xc8, 0xd8, 0x36, 0x62, 0xc0, 0xe4, 0x4a,
+            0x8b, 0x29, 0x1a, 0x96, 0x4c, 0xf2, 0xf0, 0x70, 0x38
+        }
+    },
+    {
+        "password", "IEEE", 4096, 32,
+        {
+            0xf4, 0x2c, 0x6f, 0xc5, 0x2d, 0xf0, 0xeb, 0xef, 0x9e, 0xbb, 0x4b, 0x90, 0xb3, 0x8a, 0x5f, 0x90,
+            0x2e, 0x83, 0xfe, 0x1b, 0x13, 0x5a, 0x70, 0xe2, 0x3a, 0xed, 0x76, 0x2e, 0x97, 0x10, 0xa1, 0x2e
+        }
+    },
+    {
+        "ThisIsAPassword", "ThisIsASSID", 4096, 32,
+        {
+            0x0d, 0xc0, 0xd6, 0xeb, 0x90, 0x55, 0x5e, 0xd6, 0x41, 0x97, 0x56, 0xb9, 0xa1, 0x5e, 0xc3, 0xe3,
+            0x20, 0x9b, 0x63, 0xdf, 0x70, 0x7d, 0xd5, 0x08, 0xd1, 0x45, 0x81, 0xf8, 0x98, 0x27, 0x21, 0xaf
+        }
+    },
+    {
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "ZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZ", 4096, 32,
+        {
+            0xbe, 0xcb, 0x93, 0x86, 0x6b, 0xb8, 0xc3, 0x83, 0x2c, 0xb7, 0x77, 0xc2, 0xf5, 0x59, 0x80, 0x7c,
+            0x8c, 0x59, 0xaf, 0xcb, 0x6e, 0xae, 0x73, 0x48, 0x85, 0x00, 0x13, 0x00, 0xa9, 0x81, 0xcc, 0x62
+        }
+    },
+};
+
+#define NUM_KATS ((int)(sizeof(s_pbkdf2_kats) / sizeof(s_pbkdf2_kats[0])))
+
+TEST_CASE("Test fast pbkdf2 known answers", "[crypto-pbkdf2]")
+{
+    uint8_t out[PMK_LEN];
+
+    for (int i = 0; i < NUM_KATS; i++) {
+        const pbkdf2_kat_t *kat = &s_pbkdf2_kats[i];
+
+        fastpbkdf2_hmac_sha1((const u8 *)kat->pw, strlen(kat->pw), (const u8 *)kat->salt, strlen(kat->salt),
+                             kat->iterations, out, kat->len);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(kat->expected, out, kat->len);
+    }
+
+    /* All 4096 iteration vectors in one batch: blocks of different jobs share lane groups */
+    uint8_t outs[NUM_KATS][PMK_LEN];
+    fastpbkdf2_sha1_job_t jobs[NUM_KATS];
+    int njobs = 0;
+    for (int i = 0; i < NUM_KATS; i++) {
+        const pbkdf2_kat_t *kat = &s_pbkdf2_kats[i];
+        if (kat->iterations != 4096) {
+            continue;
+        }
+        jobs[njobs++] = (fastpbkdf2_sha1_job_t) {
+            .pw = (const u8 *)kat->pw, .npw = strlen(kat->pw),
+            .salt = (const u8 *)kat->salt, .nsalt = strlen(kat->salt),
+            .out = outs[i], .nout = kat->len,
+        };
+    }
+    fastpbkdf2_hmac_sha1_multi(jobs, njobs, 4096);
+    for (int i = 0; i < NUM_KATS; i++) {
+        if (s_pbkdf2_kats[i].iterations == 4096) {
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(s_pbkdf2_kats[i].expected, outs[i], s_pbkdf2_kats[i].len);
+        }
+    }
+}
+
+TEST_CASE("Test fast pbkdf2 batch throughput", "[crypto-pbkdf2]")
+{
+#define BATCH_PMKS 4
+    static const char *ssids[BATCH_PMKS] = { "espressif", "espressif-guest", "esp-roam-1", "esp-roam-2" };
+    uint8_t pmks[BATCH_PMKS][PMK_LEN];
+    uint8_t expected[PMK_LEN];
+    fastpbkdf2_sha1_job_t jobs[BATCH_PMKS];
+
+    int64_t start_time = esp_timer_get_time();
+    for (int i = 0; i < BATCH_PMKS; i++) {
+        fastpbkdf2_hmac_sha1((const u8 *)"espressif", strlen("espressif"), (const u8 *)ssids[i], strlen(ssids[i]),
+                             4096, pmks[i], PMK_LEN);
+    }
+    int64_t time_single = esp_timer_get_time() - start_time;
+
+    for (int i = 0; i < BATCH_PMKS; i++) {
+        jobs[i] = (fastpbkdf2_sha1_job_t) {
+            .pw = (const u8 *)"espressif", .npw = strlen("espressif"),
+            .salt = (const u8 *)ssids[i], .nsalt = strlen(ssids[i]),
+            .out = pmks[i], .nout = PMK_LEN,
+        };
+    }
+    start_time = esp_timer_get_time();
+    fastpbkdf2_hmac_sha1_multi(jobs, BATCH_PMKS, 4096);
+    int64_t time_batch = esp_timer_get_time() - start_time;
+
+    for (int i = 0; i < BATCH_PMKS; i++) {
+        mbedtls_pkcs5_pbkdf2_hmac_ext(MBEDTLS_MD_SHA1, (const unsigned char *)"espressif", strlen("espressif"),
+                                      (const unsigned char *)ssids[i], strlen(ssids[i]), 4096, PMK_LEN, expected);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, pmks[i], PMK_LEN);
+    }
+
+    ESP_LOGI("Timing", "%d PMKs with %d lanes: one by one %lld us, batched %lld us", BATCH_PMKS,
+             FASTPBKDF2_SHA1_LANES, time_single, time_batch);
+}
+
+#ifdef CONFIG_ESP_WIFI_PSK_CACHE
+TEST_CASE("Test PSK cache", "[crypto-pbkdf2]")
+{
+    uint8_t pmk[PMK_LEN];
+    uint8_t cached_pmk[PMK_LEN];
+
+    psk_cache_flush();
+
+    int64_t start_time = esp_timer_get_time();
+    TEST_ASSERT_EQUAL(0, pbkdf2_sha1("ThisIsAPassword", (const u8 *)"ThisIsASSID", strlen("ThisIsASSID"), 4096, pmk, PMK_LEN));
+    int64_t time_derive = esp_timer_get_time() - start_time;
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(s_pbkdf2_kats[4].expected, pmk, PMK_LEN);
+
+    start_time = esp_timer_get_time();
+    TEST_ASSERT_EQUAL(0, pbkdf2_sha1("ThisIsAPassword", (const u8 *)"ThisIsASSID", strlen("ThisIsASSID"), 4096, cached_pmk, PMK_LEN));
+    int64_t time_cached = esp_timer_get_time() - start_time;
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pmk, cached_pmk, PMK_LEN);
+    TEST_ASSERT_EQUAL(0, psk_cache_get("ThisIsAPassword", (const u8 *)"ThisIsASSID", strlen("ThisIsASSID"), cached_pmk));
+    ESP_LOGI("Timing", "PMK derivation %lld us, cached %lld us", time_derive, time_cached);
+
+    /* Another passphrase for the same SSID is not served from the cache */
+    TEST_ASSERT_EQUAL(-1, psk_cache_get("ThisIsAnotherPassword", (const u8 *)"ThisIsASSID", strlen("ThisIsASSID"), cached_pmk));
+    TEST_ASSERT_EQUAL(0, pbkdf2_sha1("password", (const u8 *)"IEEE", strlen("IEEE"), 4096, pmk, PMK_LEN));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(s_pbkdf2_kats[3].expected, pmk, PMK_LEN);
+
+    psk_cache_flush();
+    TEST_ASSERT_EQUAL(-1, psk_cache_get("ThisIsAPassword", (const u8 *)"ThisIsASSID", strlen("ThisIsASSID"), cached_pmk));
+}
+#endif /* CONFIG_ESP_WIFI_PSK_CACHE */
 #endif
@@ -16,6 +16,14 @@ def test_wpa_supplicant_ut(dut: Dut) -> None:
     dut.run_all_single_board_cases()
 
 
+# test the PBKDF2 engine with several interleaved lanes
+@pytest.mark.generic
+@pytest.mark.parametrize('config', ['pbkdf2_lanes'], indirect=True)
+@idf_parametrize('target', ['esp32', 'esp32c3'], indirect=['target'])
+def test_wpa_supplicant_ut_pbkdf2_lanes(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='crypto-pbkdf2')
+
+
 @pytest.mark.wifi_two_dut
 @pytest.mark.parametrize(
     'count',
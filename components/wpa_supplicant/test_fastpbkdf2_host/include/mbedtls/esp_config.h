@@ -0,0 +1,7 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* The harness uses the default mbedTLS configuration, with the software SHA-1 */
+#pragma once
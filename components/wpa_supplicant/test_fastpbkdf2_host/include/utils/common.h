@@ -0,0 +1,7 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Nothing of wpa_supplicant is used by fastpbkdf2.c */
+#pragma once
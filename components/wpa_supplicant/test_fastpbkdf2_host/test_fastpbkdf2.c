@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* Known-answer test of fastpbkdf2.c, for single derivations and batches of every size up to twice the lane count */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fastpbkdf2.h"
+
+#define MAX_OUT_LEN     40
+#define MAX_BATCH       (2 * FASTPBKDF2_SHA1_LANES + 1)
+
+typedef struct {
+    const char *pw;
+    size_t npw;
+    const char *salt;
+    size_t nsalt;
+    uint32_t iterations;
+    size_t nout;
+    const char *expected;   /* hex */
+} kat_t;
+
+static const kat_t s_kats[] = {
+    /* RFC 6070 */
+    { "password", 8, "salt", 4, 1, 20, "0c60c80f961f0e71f3a9b524af6012062fe037a6" },
+    { "password", 8, "salt", 4, 4096, 20, "4b007901b765489abead49d926f721d065a429c1" },
+    {
+        "passwordPASSWORDpassword", 24, "saltSALTsaltSALTsaltSALTsaltSALTsalt", 36, 4096, 25,
+        "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038"
+    },
+    { "pass\0word", 9, "sa\0lt", 5, 4096, 16, "56fa6aa75548099dcc37d7f03425e0c3" },
+    /* IEEE 802.11 Annex J.4, the PMK of a WPA passphrase and SSID */
+    { "password", 8, "IEEE", 4, 4096, 32, "f42c6fc52df0ebef9ebb4b90b38a5f902e83fe1b135a70e23aed762e9710a12e" },
+    { "ThisIsAPassword", 15, "ThisIsASSID", 11, 4096, 32, "0dc0d6eb90555ed6419756b9a15ec3e3209b63df707dd508d14581f8982721af" },
+    {
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", 32, "ZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZ", 32, 4096, 32,
+        "becb93866bb8c3832cb777c2f559807c8c59afcb6eae734885001300a981cc62"
+    },
+    /* Password longer than a SHA-1 block, output of three blocks (checked with Python hashlib) */
+    {
+        "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx",
+        100, "salt", 4, 3, 40, "bf94cb1b26465c7332844a102eaf01faba310edb216986c95f48cd8649da9295ac437db4e1db9c43"
+    },
+};
+
+#define KAT_COUNT   (sizeof(s_kats) / sizeof(s_kats[0]))
+
+static int s_failures;
+
+static void check(const kat_t *kat, const uint8_t *out, const char *what)
+{
+    char hex[2 * MAX_OUT_LEN + 1];
+    for (size_t i = 0; i < kat->nout; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", out[i]);
+    }
+    if (strcmp(hex, kat->expected) != 0) {
+        printf("FAIL %s: pw \"%.*s\" salt \"%.*s\" c %u: %s, expected %s\n", what, (int)kat->npw, kat->pw,
+               (int)kat->nsalt, kat->salt, (unsigned)kat->iterations, hex, kat->expected);
+        s_failures++;
+    }
+}
+
+static void test_single(void)
+{
+    for (size_t i = 0; i < KAT_COUNT; i++) {
+        const kat_t *kat = &s_kats[i];
+        uint8_t out[MAX_OUT_LEN];
+        fastpbkdf2_hmac_sha1((const uint8_t *)kat->pw, kat->npw, (const uint8_t *)kat->salt, kat->nsalt,
+                             kat->iterations, out, kat->nout);
+        check(kat, out, "single");
+    }
+}
+
+/* Batches share the iteration count, so each one is made of the vectors with the same count, repeated as
+ * needed and rotated so that jobs of different output lengths end up in every lane */
+static void test_batches(void)
+{
+    static const uint32_t iteration_counts[] = { 1, 3, 4096 };
+    for (size_t c = 0; c < sizeof(iteration_counts) / sizeof(iteration_counts[0]); c++) {
+        const kat_t *same[KAT_COUNT];
+        size_t nsame = 0;
+        for (size_t i = 0; i < KAT_COUNT; i++) {
+            if (s_kats[i].iterations == iteration_counts[c]) {
+                same[nsame++] = &s_kats[i];
+            }
+        }
+        for (size_t rot = 0; rot < nsame; rot++) {
+            for (size_t njobs = 1; njobs <= MAX_BATCH; njobs++) {
+                fastpbkdf2_sha1_job_t jobs[MAX_BATCH];
+                uint8_t out[MAX_BATCH][MAX_OUT_LEN];
+                for (size_t j = 0; j < njobs; j++) {
+                    const kat_t *kat = same[(rot + j) % nsame];
+                    jobs[j] = (fastpbkdf2_sha1_job_t) {
+                        .pw = (const uint8_t *)kat->pw, .npw = kat->npw,
+                        .salt = (const uint8_t *)kat->salt, .nsalt = kat->nsalt,
+                        .out = out[j], .nout = kat->nout,
+                    };
+                }
+                fastpbkdf2_hmac_sha1_multi(jobs, njobs, iteration_counts[c]);
+                for (size_t j = 0; j < njobs; j++) {
+                    check(same[(rot + j) % nsame], out[j], "batch");
+                }
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    printf("Testing fastpbkdf2 with %d lanes\n", FASTPBKDF2_SHA1_LANES);
+
+    test_single();
+    test_batches();
+
+    if (s_failures) {
+        printf("%d failures\n", s_failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
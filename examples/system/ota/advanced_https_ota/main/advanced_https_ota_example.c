@@ -280,6 +280,9 @@ void advanced_ota_example_task(void *pvParameter)
         .partial_http_download = true,
         .max_http_request_size = CONFIG_EXAMPLE_HTTP_REQUEST_SIZE,
 #endif
+#ifdef CONFIG_EXAMPLE_ENABLE_PARALLEL_HTTP_DOWNLOAD
+        .parallel_connections = CONFIG_EXAMPLE_PARALLEL_HTTP_CONNECTIONS,
+#endif
 #ifdef CONFIG_EXAMPLE_ENABLE_OTA_RESUMPTION
         .ota_resumption = true,
         .ota_image_bytes_written = ota_wr_len,
@@ -76,6 +76,39 @@ def start_https_server(ota_image_dir: str, server_ip: str, server_port: int) ->
     httpd.serve_forever()
 
 
+def lossy_request_handler(max_latency: float, drop_rate: float) -> Callable[..., http.server.BaseHTTPRequestHandler]:
+    """
+    Returns a request handler class that delays its responses by up to `max_latency` seconds,
+    and drops the connection in the middle of a response with a probability of `drop_rate`
+    """
+
+    class LossyRequestHandler(https_request_handler()):  # type: ignore
+        def copyfile(self, source, outputfile) -> None:  # type: ignore
+            time.sleep(random.uniform(0, max_latency))
+            if random.random() < drop_rate:
+                if self.range:
+                    source.seek(self.range[0])
+                outputfile.write(source.read(random.randint(1, 4096)))
+                self.close_connection = True
+                return
+            super().copyfile(source, outputfile)
+
+    return LossyRequestHandler
+
+
+def start_lossy_https_server(ota_image_dir: str, server_ip: str, server_port: int) -> None:
+    os.chdir(ota_image_dir)
+    requestHandler = lossy_request_handler(max_latency=0.5, drop_rate=0.2)
+    # The parallel download uses several connections at once
+    httpd = http.server.ThreadingHTTPServer((server_ip, server_port), requestHandler)
+
+    ssl_context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    ssl_context.load_cert_chain(certfile=server_file, keyfile=key_file)
+
+    httpd.socket = ssl_context.wrap_socket(httpd.socket, server_side=True)
+    httpd.serve_forever()
+
+
 def start_chunked_server(ota_image_dir: str, server_port: int) -> subprocess.Popen:
     os.chdir(ota_image_dir)
     chunked_server = subprocess.Popen(
@@ -778,6 +811,83 @@ def test_examples_protocol_advanced_https_ota_example_ota_resumption_partial_dow
         thread1.terminate()
 
 
+@pytest.mark.ethernet_ota
+@pytest.mark.parametrize(
+    'config',
+    [
+        'parallel_download',
+    ],
+    indirect=True,
+)
+@idf_parametrize('target', ['esp32'], indirect=['target'])
+def test_examples_protocol_advanced_https_ota_example_parallel_download_request(dut: Dut) -> None:
+    """
+    This is a positive test case, to test OTA workflow with the image downloaded over several connections,
+    from a server with latency which drops connections, and with a reboot during the download.
+    steps: |
+      1. join AP/Ethernet
+      2. Fetch OTA image over HTTPS, in parallel
+      3. Reboot during the download
+      4. Fetch the rest of the OTA image over HTTPS
+      5. Reboot with the new OTA image
+    """
+    server_port = 8001
+    # File to be downloaded. This file is generated after compilation
+    bin_name = 'advanced_https_ota.bin'
+
+    # Erase NVS partition
+    dut.serial.erase_partition(NVS_PARTITION)
+
+    # Start server
+    thread1 = multiprocessing.Process(
+        target=start_lossy_https_server, args=(dut.app.binary_path, '0.0.0.0', server_port)
+    )
+    thread1.daemon = True
+    thread1.start()
+    try:
+        # start test
+        dut.expect('Loaded app from partition at offset', timeout=30)
+
+        try:
+            ip_address = dut.expect(r'IPv4 address: (\d+\.\d+\.\d+\.\d+)[^\d]', timeout=30)[1].decode()
+            print(f'Connected to AP/Ethernet with IP: {ip_address}')
+        except pexpect.exceptions.TIMEOUT:
+            raise ValueError('ENV_TEST_FAILURE: Cannot connect to AP')
+        host_ip = get_host_ip4_by_dest_ip(ip_address)
+
+        dut.expect('Starting Advanced OTA example', timeout=30)
+        print('writing to device: {}'.format('https://' + host_ip + ':' + str(server_port) + '/' + bin_name))
+        dut.write('https://' + host_ip + ':' + str(server_port) + '/' + bin_name)
+        chunks = int(dut.expect(r'Downloading (\d+) chunks', timeout=60)[1].decode())
+        assert chunks > 1
+        # Reboot once some chunks were written
+        dut.expect(r'Written image length \d+', timeout=60)
+        dut.serial.hard_reset()
+
+        # Validate that the device restarts correctly
+        dut.expect('Loaded app from partition at offset', timeout=180)
+
+        try:
+            ip_address = dut.expect(r'IPv4 address: (\d+\.\d+\.\d+\.\d+)[^\d]', timeout=30)[1].decode()
+            print(f'Connected to AP/Ethernet with IP: {ip_address}')
+        except pexpect.exceptions.TIMEOUT:
+            raise ValueError('ENV_TEST_FAILURE: Cannot connect to AP/Ethernet')
+
+        dut.expect('Starting Advanced OTA example', timeout=30)
+        host_ip = get_host_ip4_by_dest_ip(ip_address)
+
+        print('writing to device: {}'.format('https://' + host_ip + ':' + str(server_port) + '/' + bin_name))
+        dut.write('https://' + host_ip + ':' + str(server_port) + '/' + bin_name)
+        dut.expect('Resuming the download', timeout=60)
+
+        dut.expect('upgrade successful. Rebooting ...', timeout=150)
+        # after reboot
+        dut.expect('Loaded app from partition at offset', timeout=30)
+        dut.expect('OTA example app_main start', timeout=20)
+    finally:
+        thread1.terminate()
+
+
 @pytest.mark.wifi_high_traffic
 @pytest.mark.parametrize(
     'config',
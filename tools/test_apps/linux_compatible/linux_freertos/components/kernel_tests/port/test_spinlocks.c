@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+
+#if CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+
+#define REPEAT_OPS          10000
+#define TASKS_PER_CORE      4
+
+static portMUX_TYPE shared_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile int shared_value;
+static volatile bool in_critical;
+static volatile bool exclusion_failed;
+static SemaphoreHandle_t done_sem;
+
+static void task_shared_value_increment(void *ignore)
+{
+    for (int i = 0; i < REPEAT_OPS; i++) {
+        portENTER_CRITICAL(&shared_mux);
+        if (in_critical) {
+            exclusion_failed = true;
+        }
+        in_critical = true;
+        shared_value++;
+        in_critical = false;
+        portEXIT_CRITICAL(&shared_mux);
+    }
+    xSemaphoreGive(done_sem);
+    vTaskDelete(NULL);
+}
+
+/*
+Test portMUX spinlocks with tasks running at the same time on different simulated cores
+
+Procedure:
+    - Create several tasks pinned to each core, which all increment a shared value inside a critical section
+    - Each task checks that no other task is inside the critical section at the same time
+
+Expected:
+    - The shared value is incremented the expected number of times
+    - No task ever finds another task inside the critical section
+*/
+TEST_CASE("portMUX cross-core locking", "[freertos]")
+{
+    done_sem = xSemaphoreCreateCounting(TASKS_PER_CORE * configNUMBER_OF_CORES, 0);
+    TEST_ASSERT_NOT_NULL(done_sem);
+    shared_value = 0;
+    exclusion_failed = false;
+
+    for (int i = 0; i < TASKS_PER_CORE; i++) {
+        for (BaseType_t core = 0; core < configNUMBER_OF_CORES; core++) {
+            TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(task_shared_value_increment, "inc", configMINIMAL_STACK_SIZE * 2, NULL,
+                                                              CONFIG_UNITY_FREERTOS_PRIORITY + 1, NULL, core));
+        }
+    }
+
+    for (int i = 0; i < TASKS_PER_CORE * configNUMBER_OF_CORES; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done_sem, pdMS_TO_TICKS(10000)));
+    }
+    vSemaphoreDelete(done_sem);
+
+    TEST_ASSERT_FALSE(exclusion_failed);
+    TEST_ASSERT_EQUAL_INT(REPEAT_OPS * TASKS_PER_CORE * configNUMBER_OF_CORES, shared_value);
+}
+
+static volatile UBaseType_t running_mask;
+static volatile bool wrong_core;
+
+static void task_wait_for_all_cores(void *arg)
+{
+    const BaseType_t core = (BaseType_t) arg;
+    const TickType_t start = xTaskGetTickCount();
+
+    __atomic_or_fetch(&running_mask, 1 << core, __ATOMIC_SEQ_CST);
+    // Busy wait without blocking, so that the other tasks can only run if the cores run in parallel
+    while (__atomic_load_n(&running_mask, __ATOMIC_SEQ_CST) != (1 << configNUMBER_OF_CORES) - 1 &&
+            xTaskGetTickCount() - start < pdMS_TO_TICKS(1000)) {
+        if (xPortGetCoreID() != core) {
+            wrong_core = true;
+        }
+    }
+    xSemaphoreGive(done_sem);
+    vTaskDelete(NULL);
+}
+
+/*
+Test that the simulated cores run tasks in parallel and honor the core affinity
+
+Procedure:
+    - Create a busy waiting task pinned to each core, with a higher priority than the unity task
+    - Each task waits until the tasks of all the cores are running, or until it times out
+
+Expected:
+    - The tasks are all running at the same time
+    - xPortGetCoreID() always returns the core the task is pinned to
+*/
+TEST_CASE("Tasks pinned to different cores run in parallel", "[freertos]")
+{
+    done_sem = xSemaphoreCreateCounting(configNUMBER_OF_CORES, 0);
+    TEST_ASSERT_NOT_NULL(done_sem);
+    running_mask = 0;
+    wrong_core = false;
+
+    for (BaseType_t core = 0; core < configNUMBER_OF_CORES; core++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(task_wait_for_all_cores, "wait", configMINIMAL_STACK_SIZE * 2, (void *) core,
+                                                          CONFIG_UNITY_FREERTOS_PRIORITY + 1, NULL, core));
+    }
+
+    for (int i = 0; i < configNUMBER_OF_CORES; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done_sem, pdMS_TO_TICKS(10000)));
+    }
+    vSemaphoreDelete(done_sem);
+
+    TEST_ASSERT_EQUAL_HEX((1 << configNUMBER_OF_CORES) - 1, running_mask);
+    TEST_ASSERT_FALSE(wrong_core);
+}
+
+#endif // CONFIG_FREERTOS_NUMBER_OF_CORES > 1
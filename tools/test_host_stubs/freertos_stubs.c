@@ -0,0 +1,243 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* FreeRTOS tasks and semaphores of include/freertos, implemented with host threads. A harness renaming the
+   host pthread functions for the component sources it builds has to build this file without those renames. */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+struct host_semaphore {
+    pthread_cond_t cond;
+    UBaseType_t count;
+    UBaseType_t max_count;
+    TaskHandle_t holder;        // Task holding a mutex
+    UBaseType_t recursion;      // Number of times the holder took a recursive mutex
+    bool is_static;
+};
+
+_Static_assert(sizeof(struct host_semaphore) <= sizeof(StaticSemaphore_t), "StaticSemaphore_t is too small");
+
+/* Every semaphore operation takes this lock, as FreeRTOS enters a critical section for each of them */
+static pthread_mutex_t s_kernel_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread uint32_t s_task;        // Its address identifies the task, word aligned like a TCB
+static __thread int s_core_id = -1;
+static int s_next_core_id;
+
+__thread void *host_tls_pointers[CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS];
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return &s_task;
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    if (s_core_id < 0) {
+        s_core_id = __atomic_fetch_add(&s_next_core_id, 1, __ATOMIC_RELAXED) % portNUM_PROCESSORS;
+    }
+    return s_core_id;
+}
+
+static TickType_t get_tick_count(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (TickType_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000) / portTICK_PERIOD_MS;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec delay = {
+        .tv_sec = ticks * portTICK_PERIOD_MS / 1000,
+        .tv_nsec = (ticks * portTICK_PERIOD_MS % 1000) * 1000000,
+    };
+    nanosleep(&delay, NULL);
+}
+
+void vTaskSetTimeOutState(TimeOut_t *timeout)
+{
+    timeout->entry_tick = get_tick_count();
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *timeout, TickType_t *ticks_to_wait)
+{
+    if (*ticks_to_wait == portMAX_DELAY) {
+        return pdFALSE;
+    }
+    const TickType_t now = get_tick_count();
+    const TickType_t elapsed = now - timeout->entry_tick;
+    if (elapsed >= *ticks_to_wait) {
+        *ticks_to_wait = 0;
+        return pdTRUE;
+    }
+    *ticks_to_wait -= elapsed;
+    timeout->entry_tick = now;
+    return pdFALSE;
+}
+
+static SemaphoreHandle_t semaphore_init(struct host_semaphore *sem, UBaseType_t max_count, UBaseType_t initial_count)
+{
+    if (sem == NULL) {
+        return NULL;
+    }
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sem->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    sem->count = initial_count;
+    sem->max_count = max_count;
+    sem->holder = NULL;
+    sem->recursion = 0;
+    return sem;
+}
+
+static SemaphoreHandle_t semaphore_init_static(StaticSemaphore_t *buffer, UBaseType_t max_count, UBaseType_t initial_count)
+{
+    SemaphoreHandle_t sem = semaphore_init((struct host_semaphore *)buffer, max_count, initial_count);
+    sem->is_static = true;
+    return sem;
+}
+
+SemaphoreHandle_t xQueueCreateMutex(uint8_t type)
+{
+    return xSemaphoreCreateMutex();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return semaphore_init(calloc(1, sizeof(struct host_semaphore)), 1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return semaphore_init(calloc(1, sizeof(struct host_semaphore)), 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return xSemaphoreCreateMutex();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer)
+{
+    return semaphore_init_static(buffer, 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buffer)
+{
+    return xSemaphoreCreateMutexStatic(buffer);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max_count, UBaseType_t initial_count, StaticSemaphore_t *buffer)
+{
+    return semaphore_init_static(buffer, max_count, initial_count);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    pthread_cond_destroy(&sem->cond);
+    if (!sem->is_static) {
+        free(sem);
+    }
+}
+
+// Must be called with s_kernel_lock held
+static BaseType_t semaphore_take_locked(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    struct timespec deadline;
+    if (ticks != portMAX_DELAY) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += ticks * portTICK_PERIOD_MS / 1000;
+        deadline.tv_nsec += (ticks * portTICK_PERIOD_MS % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+    while (sem->count == 0) {
+        if (ticks == 0) {
+            return pdFALSE;
+        }
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&sem->cond, &s_kernel_lock);
+        } else if (pthread_cond_timedwait(&sem->cond, &s_kernel_lock, &deadline) == ETIMEDOUT) {
+            return pdFALSE;
+        }
+    }
+    sem->count--;
+    sem->holder = xTaskGetCurrentTaskHandle();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    pthread_mutex_lock(&s_kernel_lock);
+    BaseType_t ret = semaphore_take_locked(sem, ticks);
+    pthread_mutex_unlock(&s_kernel_lock);
+    return ret;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    BaseType_t ret = pdFALSE;
+    pthread_mutex_lock(&s_kernel_lock);
+    if (sem->count < sem->max_count) {
+        sem->count++;
+        sem->holder = NULL;
+        pthread_cond_signal(&sem->cond);
+        ret = pdTRUE;
+    }
+    pthread_mutex_unlock(&s_kernel_lock);
+    return ret;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    BaseType_t ret = pdTRUE;
+    pthread_mutex_lock(&s_kernel_lock);
+    if (sem->holder == xTaskGetCurrentTaskHandle()) {
+        sem->recursion++;
+    } else {
+        ret = semaphore_take_locked(sem, ticks);
+        if (ret == pdTRUE) {
+            sem->recursion = 1;
+        }
+    }
+    pthread_mutex_unlock(&s_kernel_lock);
+    return ret;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&s_kernel_lock);
+    if (sem->holder != xTaskGetCurrentTaskHandle()) {
+        pthread_mutex_unlock(&s_kernel_lock);
+        return pdFALSE;
+    }
+    if (--sem->recursion == 0) {
+        sem->count++;
+        sem->holder = NULL;
+        pthread_cond_signal(&sem->cond);
+    }
+    pthread_mutex_unlock(&s_kernel_lock);
+    return pdTRUE;
+}
+
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&s_kernel_lock);
+    TaskHandle_t holder = sem->holder;
+    pthread_mutex_unlock(&s_kernel_lock);
+    return holder;
+}
@@ -0,0 +1,12 @@
+# Stubs of the ESP-IDF headers, and a minimal FreeRTOS API backed by host threads, shared by the harnesses
+# building component sources natively with gcc, such as the test_*_host directories of the components.
+# A harness Makefile includes this file, adds HOST_STUBS_INCLUDE_FLAGS to its include flags and, if the
+# sources use tasks or semaphores, builds HOST_STUBS_SOURCE_FILES with them.
+HOST_STUBS_DIR := $(abspath $(dir $(lastword $(MAKEFILE_LIST))))
+HOST_STUBS_COMPONENTS_DIR := $(abspath $(HOST_STUBS_DIR)/../../components)
+
+HOST_STUBS_INCLUDE_FLAGS = -I$(HOST_STUBS_DIR)/include -I$(HOST_STUBS_COMPONENTS_DIR)/esp_common/include
+
+HOST_STUBS_HEADERS = $(wildcard $(HOST_STUBS_DIR)/include/*.h $(HOST_STUBS_DIR)/include/*/*.h)
+
+HOST_STUBS_SOURCE_FILES = $(HOST_STUBS_DIR)/freertos_stubs.c
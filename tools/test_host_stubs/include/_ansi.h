@@ -0,0 +1,7 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+/* newlib/priv_include/string/local.h includes this newlib header, nothing in it is used */
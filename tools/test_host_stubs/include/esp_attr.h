@@ -0,0 +1,10 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#define IRAM_ATTR
+#define WORD_ALIGNED_ATTR   __attribute__((aligned(4)))
+#define FORCE_INLINE_ATTR   static inline __attribute__((always_inline))
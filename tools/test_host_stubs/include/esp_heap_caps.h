@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_DEFAULT      (1 << 12)
+
+static inline void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    (void) caps;
+    return calloc(n, size);
+}
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void) caps;
+    return malloc(size);
+}
+
+static inline void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
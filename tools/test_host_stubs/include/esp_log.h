@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdio.h>
+#include <inttypes.h>
+
+/* Logs are not printed, but the arguments are used as with the real macros */
+#define ESP_LOG_DISABLED(tag, format, ...)  do { (void) (tag); if (0) { printf(format, ##__VA_ARGS__); } } while (0)
+
+#define ESP_LOGE(tag, format, ...)  ESP_LOG_DISABLED(tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  ESP_LOG_DISABLED(tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  ESP_LOG_DISABLED(tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  ESP_LOG_DISABLED(tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)  ESP_LOG_DISABLED(tag, format, ##__VA_ARGS__)
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+#define ESP_LOG_BUFFER_HEX_LEVEL(tag, buffer, buff_len, level) \
+    do { (void) (tag); (void) (buffer); (void) (buff_len); (void) (level); } while (0)
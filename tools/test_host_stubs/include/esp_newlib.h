@@ -0,0 +1,11 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* The other headers of newlib/platform_include cannot be used on the host, so its directory is not in the
+   include path */
+#include "sdkconfig.h"
+#include "../../../components/newlib/platform_include/esp_newlib.h"
@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/random.h>
+
+/* Random numbers from the host kernel */
+static inline void esp_fill_random(void *buf, size_t len)
+{
+    uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = getrandom(p, len, 0);
+        if (n > 0) {
+            p += n;
+            len -= n;
+        }
+    }
+}
+
+static inline uint32_t esp_random(void)
+{
+    uint32_t r;
+    esp_fill_random(&r, sizeof(r));
+    return r;
+}
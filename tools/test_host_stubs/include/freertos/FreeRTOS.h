@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* Minimal FreeRTOS API needed by the component sources built on the host, backed by host threads
+   (see freertos_stubs.c) */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+typedef void *TaskHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE                             0
+#define pdTRUE                              1
+#define portMAX_DELAY                       ((TickType_t) 0xFFFFFFFF)
+#define portTICK_PERIOD_MS                  1
+#define portNUM_PROCESSORS                  2
+
+#define configASSERT(x)                     assert(x)
+#define configSUPPORT_STATIC_ALLOCATION     1
+#define INCLUDE_xSemaphoreGetMutexHolder    1
+
+/* Core the calling thread is simulated to run on, threads are spread over the cores when they first call it */
+BaseType_t xPortGetCoreID(void);
+
+typedef struct {
+    int lock;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0 }
+
+static inline void portENTER_CRITICAL(portMUX_TYPE *mux)
+{
+    while (__atomic_exchange_n(&mux->lock, 1, __ATOMIC_ACQUIRE)) {
+    }
+}
+
+static inline void portEXIT_CRITICAL(portMUX_TYPE *mux)
+{
+    __atomic_store_n(&mux->lock, 0, __ATOMIC_RELEASE);
+}
+
+/* No code runs in interrupt context on the host */
+static inline BaseType_t xPortCanYield(void)
+{
+    return pdTRUE;
+}
+
+#define portYIELD_FROM_ISR()
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+/* Semaphores and mutexes, serialized by a single lock as the FreeRTOS kernel is by its critical sections */
+
+typedef struct host_semaphore *SemaphoreHandle_t;
+
+typedef struct {
+    uint64_t data[10];
+} StaticSemaphore_t;
+
+typedef StaticSemaphore_t StaticQueue_t;
+
+#define queueQUEUE_TYPE_MUTEX               ((uint8_t) 1U)
+#define queueQUEUE_TYPE_RECURSIVE_MUTEX     ((uint8_t) 4U)
+
+SemaphoreHandle_t xQueueCreateMutex(uint8_t type);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buffer);
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max_count, UBaseType_t initial_count, StaticSemaphore_t *buffer);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem);
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t sem);
+
+static inline BaseType_t xSemaphoreTakeFromISR(SemaphoreHandle_t sem, BaseType_t *higher_task_woken)
+{
+    return xSemaphoreTake(sem, 0);
+}
+
+static inline BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_task_woken)
+{
+    return xSemaphoreGive(sem);
+}
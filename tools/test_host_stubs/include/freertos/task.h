@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#define taskSCHEDULER_NOT_STARTED   1
+#define taskSCHEDULER_RUNNING       2
+
+typedef struct {
+    TickType_t entry_tick;
+} TimeOut_t;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void vTaskDelay(TickType_t ticks);
+void vTaskSetTimeOutState(TimeOut_t *timeout);
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *timeout, TickType_t *ticks_to_wait);
+
+static inline BaseType_t xTaskGetSchedulerState(void)
+{
+    return taskSCHEDULER_RUNNING;
+}
+
+/* Thread local storage pointers of the calling thread, which is the only task they can be used from */
+extern __thread void *host_tls_pointers[CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS];
+
+static inline void *pvTaskGetThreadLocalStoragePointer(TaskHandle_t task, int index)
+{
+    assert(task == NULL);
+    return host_tls_pointers[index];
+}
+
+static inline void vTaskSetThreadLocalStoragePointer(TaskHandle_t task, int index, void *value)
+{
+    assert(task == NULL);
+    host_tls_pointers[index] = value;
+}
@@ -0,0 +1,9 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* Options the stubs depend on. The options of the component sources are set by the Makefile of each harness. */
+#define CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS 1
@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* Lock types and retargetable locking API of newlib (built with _RETARGETABLE_LOCKING), followed by the
+   ESP-IDF definitions of platform_include/sys/lock.h, which cannot be used directly on the host. */
+
+#define _RETARGETABLE_LOCKING 1
+
+struct __lock {
+    int reserved[21];
+};
+
+typedef struct __lock *_LOCK_T;
+typedef _LOCK_T _lock_t;
+
+void __retarget_lock_init(_LOCK_T *lock);
+void __retarget_lock_init_recursive(_LOCK_T *lock);
+void __retarget_lock_close(_LOCK_T lock);
+void __retarget_lock_close_recursive(_LOCK_T lock);
+void __retarget_lock_acquire(_LOCK_T lock);
+void __retarget_lock_acquire_recursive(_LOCK_T lock);
+int __retarget_lock_try_acquire(_LOCK_T lock);
+int __retarget_lock_try_acquire_recursive(_LOCK_T lock);
+void __retarget_lock_release(_LOCK_T lock);
+void __retarget_lock_release_recursive(_LOCK_T lock);
+
+void _lock_init(_lock_t *plock);
+void _lock_init_recursive(_lock_t *plock);
+void _lock_close(_lock_t *plock);
+void _lock_close_recursive(_lock_t *plock);
+void _lock_acquire(_lock_t *plock);
+void _lock_acquire_recursive(_lock_t *plock);
+int _lock_try_acquire(_lock_t *plock);
+int _lock_try_acquire_recursive(_lock_t *plock);
+void _lock_release(_lock_t *plock);
+void _lock_release_recursive(_lock_t *plock);
@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/* The queue macros of the host, with the _SAFE variants of newlib that glibc does not have */
+#include_next <sys/queue.h>
+
+#ifndef SLIST_FOREACH_SAFE
+#define SLIST_FOREACH_SAFE(var, head, field, tvar)                  \
+    for ((var) = SLIST_FIRST((head));                               \
+        (var) && ((tvar) = SLIST_NEXT((var), field), 1);            \
+        (var) = (tvar))
+#endif
+
+#ifndef STAILQ_FOREACH_SAFE
+#define STAILQ_FOREACH_SAFE(var, head, field, tvar)                 \
+    for ((var) = STAILQ_FIRST((head));                              \
+        (var) && ((tvar) = STAILQ_NEXT((var), field), 1);           \
+        (var) = (tvar))
+#endif
+
+#ifndef TAILQ_FOREACH_SAFE
+#define TAILQ_FOREACH_SAFE(var, head, field, tvar)                  \
+    for ((var) = TAILQ_FIRST((head));                               \
+        (var) && ((tvar) = TAILQ_NEXT((var), field), 1);            \
+        (var) = (tvar))
+#endif